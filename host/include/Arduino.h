@@ -0,0 +1,217 @@
+/*
+ * SparkMiner - Host Arduino Shim
+ * Minimal subset of the Arduino-ESP32 core for native (Linux) builds
+ *
+ * Only what the shared firmware code uses is provided. Timing functions
+ * are real, hardware functions (GPIO, LEDC) are no-ops. millis(), micros()
+ * and delay() are weak so the scheduler simulation can run them on
+ * virtual time.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#define HOST_BUILD 1
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+#ifndef DRAM_ATTR
+#define DRAM_ATTR
+#endif
+
+typedef int esp_err_t;
+#define ESP_OK      0
+#define ESP_FAIL    -1
+
+using std::abs;
+using std::min;
+using std::max;
+
+#define HIGH    1
+#define LOW     0
+#define OUTPUT  0x03
+#define INPUT   0x01
+#define INPUT_PULLUP 0x05
+
+// ============================================================
+// Timing
+// ============================================================
+
+uint32_t millis();
+uint32_t micros();
+
+/**
+ * Delay is a no-op on host so boot splash waits don't stall benchmarks
+ * (the scheduler simulation replaces it with vTaskDelay)
+ */
+void delay(uint32_t ms);
+
+// ============================================================
+// Hardware stubs
+// ============================================================
+
+inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+inline void digitalWrite(uint8_t pin, uint8_t val) { (void)pin; (void)val; }
+inline int digitalRead(uint8_t pin) { (void)pin; return HIGH; }
+inline uint32_t ledcSetup(uint8_t ch, uint32_t freq, uint8_t res) { (void)ch; (void)res; return freq; }
+inline void ledcAttachPin(uint8_t pin, uint8_t ch) { (void)pin; (void)ch; }
+inline void ledcWrite(uint8_t ch, uint32_t duty) { (void)ch; (void)duty; }
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/**
+ * Fixed die temperature so rendered frames are reproducible
+ */
+inline float temperatureRead() { return 42.0f; }
+
+/**
+ * Local time from the host clock
+ */
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+
+/**
+ * Hardware RNG stand-in (thread safe, deterministic for a given seed)
+ */
+uint32_t esp_random();
+
+/**
+ * Reseed esp_random() (host only)
+ */
+void host_random_seed(uint64_t seed);
+
+/**
+ * Make a later esp_random() call return value, in push order (host only;
+ * replays use it to repeat a recorded draw)
+ */
+void host_random_push(uint32_t value);
+
+// ============================================================
+// ESP (chip info)
+// Heap use is not modelled; fixed figures stay above the monitor warnings
+// ============================================================
+
+class HostEsp {
+public:
+    uint32_t getFreeHeap() { return 180000; }
+    uint32_t getMinFreeHeap() { return 170000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+    [[noreturn]] void restart() {
+        fflush(stdout);
+        _Exit(0);
+    }
+};
+
+extern HostEsp ESP;
+
+// ============================================================
+// String (subset, backed by std::string)
+// ============================================================
+
+class String {
+public:
+    String() {}
+    String(const char *s) : m_str(s ? s : "") {}
+    String(const std::string &s) : m_str(s) {}
+    String(char c) : m_str(1, c) {}
+    String(int v) : m_str(std::to_string(v)) {}
+    String(unsigned int v) : m_str(std::to_string(v)) {}
+    String(long v) : m_str(std::to_string(v)) {}
+    String(unsigned long v) : m_str(std::to_string(v)) {}
+    String(long long v) : m_str(std::to_string(v)) {}
+    String(unsigned long long v) : m_str(std::to_string(v)) {}
+    String(float v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+    String(double v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+
+    const char *c_str() const { return m_str.c_str(); }
+    unsigned int length() const { return (unsigned int)m_str.length(); }
+    bool reserve(unsigned int size) { m_str.reserve(size); return true; }
+
+    void trim() {
+        size_t begin = m_str.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) {
+            m_str.clear();
+            return;
+        }
+        size_t end = m_str.find_last_not_of(" \t\r\n");
+        m_str = m_str.substr(begin, end - begin + 1);
+    }
+
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= m_str.length()) return String();
+        return String(m_str.substr(from, to - from));
+    }
+
+    String &operator+=(const String &rhs) { m_str += rhs.m_str; return *this; }
+    String &operator+=(const char *rhs) { m_str += rhs ? rhs : ""; return *this; }
+    String &operator+=(char c) { m_str += c; return *this; }
+
+    friend String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const String &a, const char *b) { String r(a); r += b; return r; }
+    friend String operator+(const char *a, const String &b) { String r(a); r += b; return r; }
+
+    bool operator==(const String &rhs) const { return m_str == rhs.m_str; }
+    bool operator!=(const String &rhs) const { return m_str != rhs.m_str; }
+
+private:
+    void fromDouble(double v, unsigned int decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        m_str = buf;
+    }
+
+    std::string m_str;
+};
+
+// ============================================================
+// IPAddress (IPv4, as the core's WiFi classes take it)
+// ============================================================
+
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : m_bytes{ a, b, c, d } {}
+    uint8_t operator[](int index) const { return m_bytes[index]; }
+
+private:
+    uint8_t m_bytes[4];
+};
+
+// ============================================================
+// Serial (stdout)
+// ============================================================
+
+class HostSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    void print(const char *s) { fputs(s, stdout); }
+    void print(const String &s) { fputs(s.c_str(), stdout); }
+    void println() { fputc('\n', stdout); }
+    void println(const char *s) { puts(s); }
+    void println(const String &s) { puts(s.c_str()); }
+    void flush() { fflush(stdout); }
+    operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,65 @@
+/*
+ * SparkMiner - Host FastLED Shim
+ * Records every show() instead of driving a strip, for checking the LED
+ * status driver (led_status.cpp) on the host
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct CRGB {
+    uint8_t r, g, b;
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+};
+
+// Chipset and colour order tags for addLeds<>()
+struct WS2812 {};
+struct WS2812B {};
+struct SK6812 {};
+struct NEOPIXEL {};
+enum EOrder { RGB, GRB };
+
+/**
+ * One show() as the strip would have latched it
+ */
+typedef struct {
+    uint32_t ms;            // millis() at the call
+    CRGB color;             // First LED, before global brightness
+} fastled_frame_t;
+
+class HostFastLED {
+public:
+    template <typename CHIPSET, int PIN, EOrder ORDER = RGB>
+    void addLeds(CRGB *leds, int count) { m_leds = leds; m_count = count; }
+
+    void setBrightness(uint8_t brightness) { m_brightness = brightness; }
+    uint8_t getBrightness() const { return m_brightness; }
+
+    void clear(bool write = false);
+    void show();
+
+    // Host only: recorded frames, oldest first
+    size_t frames(fastled_frame_t *out, size_t max) const;
+    size_t frameCount() const;
+    void resetFrames();
+
+    // Host only: make the next show() take this long (a slow bus write)
+    void holdNextShow(uint32_t ms) { m_holdMs = ms; }
+
+private:
+    CRGB *m_leds = NULL;
+    int m_count = 0;
+    uint8_t m_brightness = 255;
+    volatile uint32_t m_holdMs = 0;
+};
+
+extern HostFastLED FastLED;
+
+#endif // HOST_FASTLED_H
@@ -0,0 +1,11 @@
+/*
+ * SparkMiner - Host SPI Shim
+ * Placeholder so shared display code compiles natively
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#endif // HOST_SPI_H
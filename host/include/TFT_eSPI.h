@@ -0,0 +1,65 @@
+/*
+ * SparkMiner - Host TFT_eSPI Shim
+ * Maps the TFT_eSPI class used by display.cpp onto the host framebuffer
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+#include "display_fb.h"
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH  240
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 320
+#endif
+
+// ILI9341 / ST7789 display on/off commands
+#define TFT_DISPOFF 0x28
+#define TFT_DISPON  0x29
+
+class TFT_eSPI : public FbCanvas {
+public:
+    // Panels are native portrait (e.g. ILI9341 240x320), board_config.h
+    // may hand us landscape dimensions
+    TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT)
+        : FbCanvas(w < h ? w : h, w < h ? h : w) {}
+
+    void init() { begin(); }
+
+    // Panel commands only matter for transfer accounting
+    void writecommand(uint8_t c) { (void)c; }
+    void startWrite() {}
+    void endWrite() {}
+
+    // CYD panels are built with TFT_INVERSION_ON, so invertDisplay(true)
+    // restores normal colours
+    void invertDisplay(bool invert) { FbCanvas::invertDisplay(!invert); }
+};
+
+// Off-screen canvas; colour depth is ignored (always RGB565 on host)
+class TFT_eSprite : public FbCanvas {
+public:
+    explicit TFT_eSprite(TFT_eSPI *parent) : FbCanvas(0, 0) { (void)parent; }
+
+    void setColorDepth(int8_t bpp) { (void)bpp; }
+    bool createSprite(int16_t w, int16_t h) {
+        static_cast<FbCanvas &>(*this) = FbCanvas(w, h);
+        begin();
+        return true;
+    }
+    void deleteSprite() { static_cast<FbCanvas &>(*this) = FbCanvas(0, 0); }
+    void fillSprite(uint32_t color) { fillScreen(color); }
+    uint16_t readPixel(int32_t x, int32_t y) const { return getPixel(x, y); }
+};
+
+/**
+ * Access the framebuffer behind display.cpp's TFT instance
+ * Implemented in display.cpp when built with HOST_BUILD
+ */
+TFT_eSPI *display_fb_canvas();
+
+#endif // HOST_TFT_ESPI_H
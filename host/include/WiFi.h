@@ -0,0 +1,59 @@
+/*
+ * SparkMiner - Host WiFi Shim
+ * Station that is always associated unless the simulation drops it
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+class HostWiFi {
+public:
+    wl_status_t status() { return m_connected ? WL_CONNECTED : WL_DISCONNECTED; }
+    wifi_mode_t getMode() { return WIFI_STA; }
+    int8_t RSSI() { return m_connected ? m_rssi : 0; }
+    uint8_t *macAddress(uint8_t *mac) {
+        memcpy(mac, m_mac, sizeof(m_mac));
+        return mac;
+    }
+    bool disconnect(bool wifiOff = false, bool eraseAp = false) {
+        (void)wifiOff;
+        (void)eraseAp;
+        m_connected = false;
+        return true;
+    }
+
+    // Host controls
+    void setConnected(bool connected) { m_connected = connected; }
+    void setRssi(int8_t rssi) { m_rssi = rssi; }
+    void setMacAddress(const uint8_t *mac) { memcpy(m_mac, mac, sizeof(m_mac)); }
+
+private:
+    volatile bool m_connected = true;
+    int8_t m_rssi = -58;
+    uint8_t m_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };    // Locally administered
+};
+
+extern HostWiFi WiFi;
+
+#endif // HOST_WIFI_H
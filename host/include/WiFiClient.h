@@ -0,0 +1,53 @@
+/*
+ * SparkMiner - Host WiFiClient Shim
+ * TCP client over an in-process HostLink; every call is a scheduler
+ * preemption point, like the lwIP socket calls it stands in for.
+ * The Linux daemon links host/src/net_posix.cpp instead, which backs the
+ * same class with a BSD socket and a small receive buffer.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_WIFI_CLIENT_H
+#define HOST_WIFI_CLIENT_H
+
+#include <Arduino.h>
+#include "host_net.h"
+
+class WiFiClient {
+public:
+    int connect(const char *host, uint16_t port, int32_t timeoutMs = 3000);
+    uint8_t connected();
+    int available();
+
+    /**
+     * Next byte, -1 if none. Without a timeout this never waits, like
+     * lwIP's read(); after setTimeout() the socket backend waits up to
+     * that long, as Stream::readBytes() does for ArduinoJson on the board.
+     */
+    int read();
+
+    /**
+     * Copy up to len buffered bytes, without waiting
+     * @return bytes copied, -1 if none (socket backend only)
+     */
+    int read(uint8_t *buf, size_t len);
+    size_t write(const uint8_t *buf, size_t len);
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+    void setTimeout(uint32_t timeoutMs) { m_timeoutMs = timeoutMs; }
+    void stop();
+
+private:
+    HostLinkPtr m_link;
+    uint32_t m_timeoutMs = 0;
+
+    // BSD socket backend (net_posix.cpp)
+    bool fill();
+    int m_fd = -1;
+    uint8_t m_rx[1024];
+    size_t m_rxPos = 0;
+    size_t m_rxLen = 0;
+};
+
+#endif // HOST_WIFI_CLIENT_H
@@ -0,0 +1,19 @@
+/*
+ * SparkMiner - Host WiFiClientSecure Shim
+ * Type only: the host has no TLS client. The Linux daemon turns
+ * enable_https_stats off and reaches HTTPS APIs through stats_proxy_url.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_WIFI_CLIENT_SECURE_H
+#define HOST_WIFI_CLIENT_SECURE_H
+
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+};
+
+#endif // HOST_WIFI_CLIENT_SECURE_H
@@ -0,0 +1,65 @@
+/*
+ * SparkMiner - Host WiFiUDP Shim
+ * Datagram socket with the Arduino beginPacket/write/endPacket and
+ * beginMulticast/parsePacket/read shape, backed by BSD sockets in
+ * host/src/net_posix.cpp (Linux daemon). The simulation's station
+ * (host/src/wifi_host.cpp) has no LAN: nothing is sent or received.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_WIFI_UDP_H
+#define HOST_WIFI_UDP_H
+
+#include <Arduino.h>
+
+class WiFiUDP {
+public:
+    /**
+     * Resolve the destination and start a datagram
+     * @return 1 on success, 0 if the host does not resolve
+     */
+    int beginPacket(const char *host, uint16_t port);
+    size_t write(const uint8_t *buf, size_t len);
+
+    /**
+     * Send the datagram
+     * @return 1 on success, 0 on failure
+     */
+    int endPacket();
+
+    /**
+     * Listen on `port` as a member of an IPv4 multicast group. The port
+     * is shared (SO_REUSEADDR) and own datagrams loop back, so several
+     * processes on one machine see each other like boards on a LAN.
+     * @return 1 on success, 0 on failure
+     */
+    uint8_t beginMulticast(IPAddress group, uint16_t port);
+
+    /**
+     * Take the next received datagram, without waiting
+     * @return its size, 0 if none
+     */
+    int parsePacket();
+
+    /**
+     * Read from the current datagram
+     * @return bytes copied
+     */
+    int read(uint8_t *buf, size_t len);
+    void stop();
+
+private:
+    int m_fd = -1;
+    uint8_t m_addr[128];        // struct sockaddr_storage
+    uint32_t m_addrLen = 0;
+    uint8_t m_tx[1472];         // Largest unfragmented IPv4 payload
+    size_t m_txLen = 0;
+
+    int m_rxFd = -1;
+    uint8_t m_rx[1472];
+    size_t m_rxPos = 0;
+    size_t m_rxLen = 0;
+};
+
+#endif // HOST_WIFI_UDP_H
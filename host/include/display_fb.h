@@ -0,0 +1,146 @@
+/*
+ * SparkMiner - Host Framebuffer Display Backend
+ * In-memory RGB565 / monochrome canvas with transfer accounting
+ *
+ * Implements the subset of the TFT_eSPI drawing API used by display.cpp so
+ * the real screen code renders unchanged on Linux. Every primitive is
+ * counted as if it were pushed over SPI (address window + pixel data), which
+ * makes per-frame render cost comparable between builds.
+ *
+ * GPL v3 License
+ */
+
+#ifndef DISPLAY_FB_H
+#define DISPLAY_FB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <Arduino.h>
+
+/**
+ * Pixel format of the framebuffer
+ */
+typedef enum {
+    FB_FORMAT_RGB565 = 0,   // 16bpp colour TFT (ILI9341/ST7789)
+    FB_FORMAT_MONO   = 1,   // 1bpp (SSD1306-style), luminance thresholded
+} fb_format_t;
+
+// Bytes of command overhead per address window (CASET + RASET + RAMWR)
+#define FB_WINDOW_OVERHEAD  11
+
+/**
+ * Per-frame transfer statistics
+ */
+typedef struct {
+    uint32_t primitives;        // Address windows opened
+    uint32_t pixelsWritten;     // Pixels pushed (including overdraw)
+    uint32_t pixelsChanged;     // Pixels whose value actually changed
+    uint32_t bytesTransferred;  // Bytes that would cross the bus
+} fb_frame_stats_t;
+
+/**
+ * Bus transfer hook, called with the bytes each primitive would push
+ * Weak no-op; the scheduler sim overrides it to charge SPI time to the
+ * drawing task
+ */
+void display_fb_on_transfer(uint32_t bytes);
+
+class FbCanvas {
+public:
+    FbCanvas(int16_t w, int16_t h, fb_format_t format = FB_FORMAT_RGB565);
+
+    // --- Setup ---
+    void begin();
+    int16_t width() const { return m_width; }
+    int16_t height() const { return m_height; }
+    void setRotation(uint8_t r);
+    uint8_t getRotation() const { return m_rotation; }
+    void invertDisplay(bool invert) { m_inverted = invert; }
+    fb_format_t format() const { return m_format; }
+    void setFormat(fb_format_t format) { m_format = format; }
+
+    // --- Primitives ---
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void fillScreen(uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+
+    // --- Streamed window (setAddrWindow + pushColors) ---
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+    void pushColors(const uint16_t *data, uint32_t len, bool swap = true);
+
+    // --- Text (GLCD 5x7 font, TFT_eSPI semantics) ---
+    void setCursor(int16_t x, int16_t y) { m_cursorX = x; m_cursorY = y; }
+    int16_t getCursorX() const { return m_cursorX; }
+    int16_t getCursorY() const { return m_cursorY; }
+    void setTextColor(uint16_t fg) { m_textFg = fg; m_textBg = fg; }
+    void setTextColor(uint16_t fg, uint16_t bg) { m_textFg = fg; m_textBg = bg; }
+    void setTextSize(uint8_t s) { m_textSize = s > 0 ? s : 1; }
+    void setTextWrap(bool wrap) { m_textWrap = wrap; }
+    void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t fg, uint32_t bg, uint8_t size);
+
+    size_t print(const char *s);
+    size_t print(const String &s) { return print(s.c_str()); }
+    size_t print(char c);
+    size_t print(int v);
+    size_t print(unsigned int v);
+    size_t print(long v);
+    size_t print(unsigned long v);
+    size_t print(double v, int digits = 2);
+    size_t println(const char *s = "") { size_t n = print(s); return n + print('\n'); }
+
+    // --- Frame accounting ---
+    void beginFrame();
+    fb_frame_stats_t endFrame();
+    const fb_frame_stats_t &frameStats() const { return m_frame; }
+    const fb_frame_stats_t &totalStats() const { return m_total; }
+
+    // --- Inspection ---
+    uint16_t getPixel(int32_t x, int32_t y) const;
+
+    /**
+     * Write the current framebuffer as an 8-bit RGB PNG
+     * @return true on success
+     */
+    bool writePng(const char *path) const;
+
+private:
+    void countWindow(uint32_t pixels);
+    void putPixel(int32_t x, int32_t y, uint16_t color);
+    void hline(int32_t x, int32_t y, int32_t w, uint16_t color);
+    void fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint16_t color);
+    void drawCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, uint16_t color);
+
+    int16_t m_nativeWidth;
+    int16_t m_nativeHeight;
+    int16_t m_width;
+    int16_t m_height;
+    uint8_t m_rotation;
+    bool m_inverted;
+    fb_format_t m_format;
+    std::vector<uint16_t> m_pixels;
+
+    int32_t m_winX;
+    int32_t m_winY;
+    int32_t m_winW;
+    int32_t m_winH;
+    uint32_t m_winPos;
+
+    int16_t m_cursorX;
+    int16_t m_cursorY;
+    uint16_t m_textFg;
+    uint16_t m_textBg;
+    uint8_t m_textSize;
+    bool m_textWrap;
+
+    fb_frame_stats_t m_frame;
+    fb_frame_stats_t m_total;
+};
+
+#endif // DISPLAY_FB_H
@@ -0,0 +1,25 @@
+/*
+ * SparkMiner - Host Task Watchdog Shim
+ * The scheduler simulation records the timeout and reports cores whose
+ * idle task was starved for longer; nothing panics
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_ESP_TASK_WDT_H
+#define HOST_ESP_TASK_WDT_H
+
+#include <Arduino.h>
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic);
+
+static inline esp_err_t esp_task_wdt_add(TaskHandle_t task) {
+    (void)task;
+    return ESP_OK;
+}
+
+static inline esp_err_t esp_task_wdt_reset(void) {
+    return ESP_OK;
+}
+
+#endif // HOST_ESP_TASK_WDT_H
@@ -0,0 +1,44 @@
+/*
+ * SparkMiner - Host esp_timer Shim
+ * One dispatch thread runs every callback in deadline order, as the
+ * esp_timer task does on the chip (ESP_TIMER_TASK dispatch only)
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <Arduino.h>
+
+#ifndef ESP_ERR_INVALID_STATE
+#define ESP_ERR_INVALID_STATE   0x103
+#endif
+
+typedef void (*esp_timer_cb_t)(void *arg);
+typedef struct host_esp_timer *esp_timer_handle_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    int dispatch_method;
+    const char *name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+int64_t esp_timer_get_time(void);
+
+/**
+ * Callback statistics for the timer created with this name (host only)
+ * @param calls Callbacks run so far
+ * @param maxRunUs Longest single callback (microseconds)
+ * @return false if no timer has this name
+ */
+bool esp_timer_host_stats(const char *name, uint32_t *calls, uint32_t *maxRunUs);
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,90 @@
+/*
+ * SparkMiner - Fleet Tool Networking (host)
+ * Sockets and MQTT 3.1.1 framing shared by fleet_agg and fleet_load
+ *
+ * All sockets are non-blocking; callers drive them from a poll() loop.
+ * The MQTT side covers what telemetry needs: CONNECT/CONNACK, QoS 0 and 1
+ * PUBLISH, SUBSCRIBE, PINGREQ and DISCONNECT.
+ *
+ * GPL v3 License
+ */
+
+#ifndef FLEET_NET_H
+#define FLEET_NET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#define MQTT_CONNECT        1
+#define MQTT_CONNACK        2
+#define MQTT_PUBLISH        3
+#define MQTT_PUBACK         4
+#define MQTT_SUBSCRIBE      8
+#define MQTT_SUBACK         9
+#define MQTT_PINGREQ        12
+#define MQTT_PINGRESP       13
+#define MQTT_DISCONNECT     14
+
+#define MQTT_PACKET_MAX     65536   // Larger packets drop the connection
+
+typedef struct {
+    uint8_t type;               // MQTT_*
+    uint8_t flags;              // Low nibble of the fixed header
+    const uint8_t *body;        // Variable header and payload
+    size_t len;
+} mqtt_packet_t;
+
+/**
+ * Split "host[:port][/path]" (an optional "scheme://" is skipped)
+ * @return false if host is empty or the port is out of range
+ */
+bool fleet_parse_target(const char *text, std::string *host, uint16_t *port,
+                        std::string *path, uint16_t defaultPort);
+
+/**
+ * Listening TCP socket / bound UDP socket on all interfaces
+ * @return fd, -1 on failure (logged)
+ */
+int fleet_listen_tcp(uint16_t port);
+int fleet_bind_udp(uint16_t port);
+
+/**
+ * Start a non-blocking TCP connect; completion shows as POLLOUT
+ * @return fd, -1 if the host does not resolve or the socket fails
+ */
+int fleet_connect(const char *host, uint16_t port);
+
+/**
+ * Raise the open file limit to the hard limit (a thousand sockets)
+ */
+void fleet_raise_fd_limit();
+
+/**
+ * Write as much of `out` as the socket takes, erasing what was sent
+ * @return false on a socket error
+ */
+bool fleet_flush(int fd, std::string *out);
+
+/**
+ * Read everything available into `in`
+ * @return false on error or when the peer closed
+ */
+bool fleet_fill(int fd, std::string *in);
+
+/**
+ * Take the first complete packet from `in`
+ * @return bytes it occupies, 0 if incomplete, -1 if malformed or too large
+ */
+int mqtt_parse(const std::string &in, mqtt_packet_t *packet);
+
+/**
+ * Packet builders, appended to `out`
+ */
+void mqtt_connect(std::string *out, const char *clientId, const char *user, const char *pass,
+                  uint16_t keepAliveSec);
+void mqtt_publish(std::string *out, const std::string &topic, const uint8_t *payload, size_t len);
+void mqtt_subscribe(std::string *out, uint16_t packetId, const std::string &filter);
+void mqtt_simple(std::string *out, uint8_t type, const uint8_t *body, size_t len);
+
+#endif // FLEET_NET_H
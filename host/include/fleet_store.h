@@ -0,0 +1,159 @@
+/*
+ * SparkMiner - Fleet Telemetry Store (host)
+ * In-process time series of telemetry frames from many devices
+ *
+ * Every device keeps two rings: raw samples at the device's own 10 s
+ * cadence (FLEET_RAW_POINTS, one hour) and 5 minute rollups
+ * (FLEET_ROLLUP_POINTS, one day). The fleet keeps the same two tiers,
+ * built on a wall clock tick from each device's counter deltas, so
+ * devices that report late or in batches still land in the right totals.
+ *
+ * Sample times are the receive time minus the uptime difference to the
+ * newest sample of the frame. Counters are cumulative on the device; a
+ * counter going backwards is a reboot and the new value is the delta.
+ *
+ * Outliers: online devices whose 15 minute hashrate is more than the
+ * configured fraction below the median of their board (boards with fewer
+ * than FLEET_OUTLIER_MIN_PEERS online devices are not judged).
+ *
+ * GPL v3 License
+ */
+
+#ifndef FLEET_STORE_H
+#define FLEET_STORE_H
+
+#include <stdint.h>
+#include <vector>
+#include "stats/telemetry_frame.h"
+
+#define FLEET_TICK_S            10      // Fleet raw tier resolution
+#define FLEET_ROLLUP_S          300     // Rollup tier resolution
+#define FLEET_RAW_POINTS        360     // 1 h of 10 s points
+#define FLEET_ROLLUP_POINTS     288     // 24 h of 5 min points
+#define FLEET_OFFLINE_S         180     // No frame for this long = offline
+#define FLEET_OUTLIER_MIN_PEERS 3
+
+enum {
+    FLEET_SRC_UDP = 0,
+    FLEET_SRC_MQTT,
+    FLEET_SRC_HTTP,
+    FLEET_SRC_COUNT
+};
+
+/**
+ * One point of a series; share and latency fields are deltas over the
+ * point's interval, the rest are means (device) or sums (fleet)
+ */
+typedef struct {
+    uint32_t time;              // Unix seconds, start of the interval
+    float hashRate;             // H/s
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t stale;
+    uint32_t latencyHist[LATENCY_HIST_BUCKETS];
+    uint16_t devices;           // Fleet: devices online; device: samples merged
+    int8_t tempC;               // Device: last; fleet: max
+    uint8_t reserved;
+    uint32_t heapFree;          // Device: last; fleet: min
+} fleet_point_t;
+
+typedef struct {
+    uint8_t mac[6];
+    char board[17];
+    char worker[17];
+    uint8_t source;             // FLEET_SRC_*
+    bool online;
+    bool outlier;
+    uint32_t lastSeen;          // Unix seconds
+    uint32_t uptime;
+    uint32_t frames;
+    uint32_t samples;
+    uint32_t dropped;           // Device-side queue drops
+    uint32_t reboots;
+    float hashRate;             // Latest smoothed
+    float hashRate15m;
+    float boardMedian;          // 15 min median of the board (0 = not judged)
+    uint32_t accepted;          // Since boot
+    uint32_t rejected;
+    uint32_t stale;
+    uint16_t latencyAvg;
+    int8_t tempC;
+    uint8_t poolConnected;
+    uint32_t heapFree;
+    uint32_t heapLargest;
+} fleet_device_t;
+
+typedef struct {
+    uint32_t now;
+    uint32_t window;            // Seconds covered by the rates below
+    uint32_t devices;
+    uint32_t online;
+    uint32_t outliers;
+    float hashRate;             // Sum of online devices' latest
+    float hashRateMean;         // Mean over the window
+    uint32_t accepted;          // Over the window
+    uint32_t rejected;
+    uint32_t stale;
+    float rejectRate;           // rejected / (accepted + rejected)
+    float staleRate;            // stale / (accepted + rejected)
+    uint32_t latencyP50;        // ms, bucket-interpolated
+    uint32_t latencyP90;
+    uint32_t latencyP99;
+    uint32_t frames[FLEET_SRC_COUNT];
+    uint32_t badFrames;
+} fleet_summary_t;
+
+/**
+ * Reset the store and set the outlier threshold
+ * @param outlierFraction  0.2 flags devices 20% below their board median
+ */
+void fleet_store_init(float outlierFraction);
+
+/**
+ * Add a decoded frame from a device
+ * @param now  Receive time, unix seconds
+ */
+void fleet_store_ingest(const telemetry_header_t *header, const telemetry_sample_t *samples,
+                        int count, uint8_t source, uint32_t now);
+
+/**
+ * Count a frame that did not decode
+ */
+void fleet_store_bad_frame();
+
+/**
+ * Advance the fleet tiers and refresh online/outlier state (call >= every FLEET_TICK_S)
+ */
+void fleet_store_tick(uint32_t now);
+
+/**
+ * Fleet totals and rates over the last `window` seconds
+ */
+void fleet_store_summary(uint32_t now, uint32_t window, fleet_summary_t *out);
+
+/**
+ * All devices, sorted by board then worker
+ */
+void fleet_store_devices(std::vector<fleet_device_t> *out);
+
+/**
+ * Series of one device (mac = NULL: the fleet), oldest first
+ * @param rollup  false: raw tier, true: 5 minute tier
+ * @return false if the device is unknown
+ */
+bool fleet_store_series(const uint8_t *mac, bool rollup, uint32_t since,
+                        std::vector<fleet_point_t> *out);
+
+/**
+ * Latency percentile of a histogram, interpolated inside the bucket
+ * @param q  0..1
+ */
+uint32_t fleet_latency_percentile(const uint32_t *hist, float q);
+
+/**
+ * Persist / restore the whole store (written atomically)
+ */
+bool fleet_store_save(const char *path);
+bool fleet_store_load(const char *path);
+
+#endif // FLEET_STORE_H
@@ -0,0 +1,75 @@
+/*
+ * SparkMiner - Host FreeRTOS Shim
+ * Types and constants of the ESP-IDF FreeRTOS API used by the firmware
+ *
+ * Task, queue and semaphore functions are implemented by the scheduler
+ * simulation (host/src/freertos_sim.cpp) or, in the Linux daemon, on
+ * plain pthreads (host/src/freertos_posix.cpp); only builds that run
+ * tasks link one of them. Critical sections are real spinlocks so shared state stays
+ * consistent when simulated cores run in parallel.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+
+#define configTICK_RATE_HZ          1000
+#define configMAX_PRIORITIES        25
+#define configMAX_TASK_NAME_LEN     16
+
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+#define tskNO_AFFINITY      ((BaseType_t)0x7fffffff)
+#define tskIDLE_PRIORITY    ((UBaseType_t)0)
+
+/**
+ * Core the calling task is pinned to (1 outside a task, like setup())
+ */
+BaseType_t xPortGetCoreID(void);
+
+// ============================================================
+// Critical Sections
+// ============================================================
+
+typedef struct {
+    volatile int locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    {0}
+
+// Critical sections held by this thread; the scheduler sim does not
+// preempt inside one, as interrupts are masked on the chip
+inline thread_local int port_critical_nesting = 0;
+
+static inline void vPortEnterCritical(portMUX_TYPE *mux) {
+    port_critical_nesting++;
+    while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) {
+    }
+}
+
+static inline void vPortExitCritical(portMUX_TYPE *mux) {
+    __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE);
+    port_critical_nesting--;
+}
+
+#define portENTER_CRITICAL(mux)         vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)          vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)      vPortExitCritical(mux)
+
+#endif // HOST_FREERTOS_H
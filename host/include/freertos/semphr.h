@@ -0,0 +1,25 @@
+/*
+ * SparkMiner - Host FreeRTOS Semaphore API Shim
+ * Semaphores are queues of zero-size items, as in FreeRTOS; mutexes
+ * additionally record their holder for priority inheritance
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+#define vSemaphoreDelete(sem)   vQueueDelete(sem)
+
+#endif // HOST_FREERTOS_SEMPHR_H
@@ -0,0 +1,57 @@
+/*
+ * SparkMiner - Host SHA HAL Shim
+ * ESP-IDF's sha_hal block and digest helpers over the low-level shim, the
+ * sequence the IDF SHA driver (and mbedtls above it) runs on each chip:
+ * wait idle, fill SHA_TEXT, START/CONTINUE; LOAD, wait idle, read digest.
+ * SHA-256 only, as in the emulator.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SHA_HAL_H
+#define HOST_SHA_HAL_H
+
+#include "hal/sha_ll.h"
+
+#define SHA_HAL_SHA256_STATE_WORDS  8
+
+static inline void sha_hal_wait_idle(void) {
+    while (sha_ll_busy()) {
+    }
+}
+
+/**
+ * Hash one 64-byte block, fresh (first_block) or on the current state
+ */
+static inline void sha_hal_hash_block(esp_sha_type sha_type, const void *data_block,
+                                      size_t block_word_len, bool first_block) {
+    sha_hal_wait_idle();
+    sha_ll_fill_text_block(data_block, block_word_len);
+    if (first_block) {
+        sha_ll_start_block(sha_type);
+    } else {
+        sha_ll_continue_block(sha_type);
+    }
+}
+
+/**
+ * Read the state words, in the order sha_ll_read_digest() returns them
+ */
+static inline void sha_hal_read_digest(esp_sha_type sha_type, void *digest_state) {
+    sha_ll_load(sha_type);
+    sha_hal_wait_idle();
+    sha_ll_read_digest(sha_type, digest_state, SHA_HAL_SHA256_STATE_WORDS);
+}
+
+#if !defined(CONFIG_IDF_TARGET_ESP32)
+
+/**
+ * Restore a state read with sha_hal_read_digest() (ESP32-S3 only)
+ */
+static inline void sha_hal_write_digest(esp_sha_type sha_type, void *digest_state) {
+    sha_ll_write_digest(sha_type, digest_state, SHA_HAL_SHA256_STATE_WORDS);
+}
+
+#endif
+
+#endif // HOST_SHA_HAL_H
@@ -0,0 +1,112 @@
+/*
+ * SparkMiner - Host SHA Low-Level Shim
+ * The ESP-IDF register helpers the firmware calls, as plain register
+ * writes so they reach the emulated peripheral
+ *
+ * The data-path helpers (fill text, read/write digest) keep the word
+ * order of the chip's own hal/sha_ll.h: the ESP32 driver byte-swaps
+ * message words into SHA_TEXT, the ESP32-S3 driver copies them and the
+ * digest unchanged. sha_check's "IDF hal" checks go through these.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SHA_LL_H
+#define HOST_SHA_LL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "soc/hwcrypto_reg.h"
+#include "soc/dport_access.h"
+#include "hal/sha_types.h"
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+
+static inline uint32_t sha_ll_get_start_reg(esp_sha_type sha_type) {
+    return SHA_1_START_REG + sha_type * 0x10;
+}
+
+static inline void sha_ll_start_block(esp_sha_type sha_type) {
+    DPORT_REG_WRITE(sha_ll_get_start_reg(sha_type), 1);
+}
+
+static inline void sha_ll_continue_block(esp_sha_type sha_type) {
+    DPORT_REG_WRITE(sha_ll_get_start_reg(sha_type) + 0x04, 1);
+}
+
+// Copies the internal state into SHA_TEXT_BASE
+static inline void sha_ll_load(esp_sha_type sha_type) {
+    DPORT_REG_WRITE(sha_ll_get_start_reg(sha_type) + 0x08, 1);
+}
+
+static inline bool sha_ll_busy(void) {
+    return DPORT_REG_READ(SHA_1_BUSY_REG) || DPORT_REG_READ(SHA_256_BUSY_REG) ||
+           DPORT_REG_READ(SHA_384_BUSY_REG) || DPORT_REG_READ(SHA_512_BUSY_REG);
+}
+
+// Message words go in as big-endian values
+static inline void sha_ll_fill_text_block(const void *input_text, size_t block_word_len) {
+    const uint32_t *data_words = (const uint32_t *)input_text;
+    for (size_t i = 0; i < block_word_len; i++) {
+        DPORT_REG_WRITE(SHA_TEXT_BASE + i * 4, __builtin_bswap32(data_words[i]));
+    }
+}
+
+// State words after sha_ll_load(), as values (SHA-1/256 layout)
+static inline void sha_ll_read_digest(esp_sha_type sha_type, void *digest_state, size_t digest_word_len) {
+    (void)sha_type;
+    uint32_t *digest_state_words = (uint32_t *)digest_state;
+    for (size_t i = 0; i < digest_word_len; i++) {
+        digest_state_words[i] = DPORT_SEQUENCE_REG_READ(SHA_TEXT_BASE + i * 4);
+    }
+}
+
+#else
+
+static inline void sha_ll_start_block(esp_sha_type sha_type) {
+    REG_WRITE(SHA_MODE_REG, sha_type);
+    REG_WRITE(SHA_START_REG, 1);
+}
+
+static inline void sha_ll_continue_block(esp_sha_type sha_type) {
+    REG_WRITE(SHA_MODE_REG, sha_type);
+    REG_WRITE(SHA_CONTINUE_REG, 1);
+}
+
+// The digest is always readable from SHA_H_BASE
+static inline void sha_ll_load(esp_sha_type sha_type) {
+    (void)sha_type;
+}
+
+static inline bool sha_ll_busy(void) {
+    return REG_READ(SHA_BUSY_REG) != 0;
+}
+
+// Message words are copied as they lie in memory
+static inline void sha_ll_fill_text_block(const void *input_text, size_t block_word_len) {
+    const uint32_t *data_words = (const uint32_t *)input_text;
+    for (size_t i = 0; i < block_word_len; i++) {
+        REG_WRITE(SHA_TEXT_BASE + i * 4, data_words[i]);
+    }
+}
+
+static inline void sha_ll_read_digest(esp_sha_type sha_type, void *digest_state, size_t digest_word_len) {
+    (void)sha_type;
+    uint32_t *digest_state_words = (uint32_t *)digest_state;
+    for (size_t i = 0; i < digest_word_len; i++) {
+        digest_state_words[i] = REG_READ(SHA_H_BASE + i * 4);
+    }
+}
+
+static inline void sha_ll_write_digest(esp_sha_type sha_type, void *digest_state, size_t digest_word_len) {
+    (void)sha_type;
+    const uint32_t *digest_state_words = (const uint32_t *)digest_state;
+    for (size_t i = 0; i < digest_word_len; i++) {
+        REG_WRITE(SHA_H_BASE + i * 4, digest_state_words[i]);
+    }
+}
+
+#endif
+
+#endif // HOST_SHA_LL_H
@@ -0,0 +1,33 @@
+/*
+ * SparkMiner - Host SHA Types Shim
+ * Mode values match ESP-IDF, which numbers them differently per chip
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SHA_TYPES_H
+#define HOST_SHA_TYPES_H
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+typedef enum {
+    SHA1 = 0,
+    SHA2_256,
+    SHA2_384,
+    SHA2_512,
+    SHA_TYPE_MAX
+} esp_sha_type;
+#else
+typedef enum {
+    SHA1 = 0,
+    SHA2_224,
+    SHA2_256,
+    SHA2_384,
+    SHA2_512,
+    SHA2_512224,
+    SHA2_512256,
+    SHA2_512T,
+    SHA_TYPE_MAX
+} esp_sha_type;
+#endif
+
+#endif // HOST_SHA_TYPES_H
@@ -0,0 +1,80 @@
+/*
+ * SparkMiner - Host Network Link
+ * In-process byte stream between a WiFiClient and a host-side server
+ *
+ * Each direction is a queue of segments stamped with the virtual time
+ * (millis) at which they arrive, so a server can model round-trip latency
+ * without sockets. Both ends may be used from any thread.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_NET_H
+#define HOST_NET_H
+
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class HostLink {
+public:
+    explicit HostLink(uint32_t latencyMs = 0) : m_latencyMs(latencyMs) {}
+
+    /**
+     * Queue bytes for the other end, delivered latencyMs from now
+     * @param toServer Direction (client -> server when true)
+     */
+    void write(bool toServer, const char *data, size_t len, uint32_t nowMs);
+
+    /**
+     * Bytes that have arrived for this end by nowMs
+     */
+    size_t available(bool forServer, uint32_t nowMs);
+
+    /**
+     * Read one arrived byte
+     * @return -1 if nothing has arrived
+     */
+    int read(bool forServer, uint32_t nowMs);
+
+    void close();
+    bool closed();
+    uint32_t latencyMs() const { return m_latencyMs; }
+
+private:
+    struct Segment {
+        uint32_t arriveMs;
+        std::string data;
+        size_t pos;
+    };
+
+    std::mutex m_lock;
+    std::deque<Segment> m_toServer;
+    std::deque<Segment> m_toClient;
+    uint32_t m_latencyMs;
+    bool m_closed = false;
+};
+
+typedef std::shared_ptr<HostLink> HostLinkPtr;
+
+/**
+ * Server accept hook: return a link for host:port, or NULL to refuse
+ */
+typedef HostLinkPtr (*host_net_accept_fn)(const char *host, uint16_t port);
+
+/**
+ * Add a server that WiFiClient::connect() can reach
+ * Servers are asked in the order they were added; the first to return
+ * a link takes the connection.
+ */
+void host_net_add_server(host_net_accept_fn accept);
+
+/**
+ * Open a link to the first server that accepts host:port
+ * @return NULL if none does
+ */
+HostLinkPtr host_net_connect(const char *host, uint16_t port);
+
+#endif // HOST_NET_H
@@ -0,0 +1,40 @@
+/*
+ * SparkMiner - Host mbedTLS Public Key Shim
+ * PEM public key parsing and signature verification over a digest,
+ * backed by OpenSSL in host/src/mbedtls_host.cpp (link with -lcrypto)
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_MBEDTLS_PK_H
+#define HOST_MBEDTLS_PK_H
+
+#include <stddef.h>
+#include "md.h"
+
+#define MBEDTLS_ERR_PK_KEY_INVALID_FORMAT   -0x3D00
+#define MBEDTLS_ERR_PK_BAD_INPUT_DATA       -0x3E80
+#define MBEDTLS_ERR_ECP_VERIFY_FAILED       -0x4E00
+
+typedef struct {
+    void *key;      // EVP_PKEY
+} mbedtls_pk_context;
+
+void mbedtls_pk_init(mbedtls_pk_context *ctx);
+void mbedtls_pk_free(mbedtls_pk_context *ctx);
+
+/**
+ * Parse a PEM (keylen includes the terminating NUL) or DER public key
+ * @return 0 on success
+ */
+int mbedtls_pk_parse_public_key(mbedtls_pk_context *ctx, const unsigned char *key, size_t keylen);
+
+/**
+ * Verify a DER signature over an already computed digest
+ * @return 0 if the signature is valid
+ */
+int mbedtls_pk_verify(mbedtls_pk_context *ctx, mbedtls_md_type_t md_alg,
+                      const unsigned char *hash, size_t hash_len,
+                      const unsigned char *sig, size_t sig_len);
+
+#endif // HOST_MBEDTLS_PK_H
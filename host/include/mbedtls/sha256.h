@@ -0,0 +1,24 @@
+/*
+ * SparkMiner - Host mbedTLS SHA-256 Shim
+ * The streaming mbedtls_sha256_*_ret() calls the firmware uses, backed by
+ * OpenSSL in host/src/mbedtls_host.cpp (link with -lcrypto)
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_MBEDTLS_SHA256_H
+#define HOST_MBEDTLS_SHA256_H
+
+#include <stddef.h>
+
+typedef struct {
+    void *md;       // EVP_MD_CTX
+} mbedtls_sha256_context;
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx);
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx);
+int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224);
+int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen);
+int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[32]);
+
+#endif // HOST_MBEDTLS_SHA256_H
@@ -0,0 +1,55 @@
+/*
+ * SparkMiner - Mock Stats APIs (host)
+ * In-process HTTP/1.1 server standing in for the web APIs the live stats
+ * task polls (mempool.space, CoinGecko, public-pool.io) and for the
+ * SSL-bumping proxy it reaches the HTTPS ones through
+ *
+ * Takes connections to ports 80, 443 and 40557 (direct) and to the proxy
+ * port (full URL in the request line, Proxy-Authorization checked), and
+ * answers each GET with canned JSON whose values move with virtual time.
+ * The fees endpoint is sent chunked. Connections close once the response
+ * has arrived, as with "Connection: close". Anything else is refused, so
+ * the mock pool can take it. Each connection costs the connecting task
+ * cpuPerRequestUs of virtual CPU for the TLS and JSON work the host does
+ * not model.
+ *
+ * GPL v3 License
+ */
+
+#ifndef MOCK_HTTP_H
+#define MOCK_HTTP_H
+
+#include <stdint.h>
+
+/**
+ * Server behaviour
+ */
+typedef struct {
+    uint32_t latencyMs;         // One-way network latency
+    uint32_t cpuPerRequestUs;   // Charged to the connecting task
+    uint16_t proxyPort;         // 0 = no proxy
+    const char *proxyAuth;      // "user:pass" the proxy expects, NULL = none
+} mock_http_config_t;
+
+/**
+ * Server-side counters
+ */
+typedef struct {
+    uint32_t requests;
+    uint32_t viaProxy;
+    uint32_t notFound;          // 404 for an unknown path
+    uint32_t authFailed;        // 407 from the proxy
+} mock_http_stats_t;
+
+/**
+ * Start the server thread and add it as a host network server
+ * Start it before the mock pool, which takes any connection.
+ */
+void mock_http_start(const mock_http_config_t *config);
+
+/**
+ * Snapshot server counters
+ */
+void mock_http_get_stats(mock_http_stats_t *stats);
+
+#endif // MOCK_HTTP_H
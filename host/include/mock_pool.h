@@ -0,0 +1,51 @@
+/*
+ * SparkMiner - Mock Stratum Pool (host)
+ * In-process Stratum v1 server reached through WiFiClient
+ *
+ * Answers subscribe/authorize, pushes set_difficulty and a fresh
+ * mining.notify every job interval, and validates each mining.submit by
+ * rebuilding the header with the mining core, so accepted/rejected
+ * counts reflect real share correctness. Timing uses virtual millis().
+ *
+ * GPL v3 License
+ */
+
+#ifndef MOCK_POOL_H
+#define MOCK_POOL_H
+
+#include <stdint.h>
+
+/**
+ * Pool behaviour
+ */
+typedef struct {
+    double difficulty;          // Sent with mining.set_difficulty
+    uint32_t jobIntervalMs;     // New clean job every N ms (0 = only on connect)
+    uint32_t latencyMs;         // One-way network latency
+} mock_pool_config_t;
+
+/**
+ * Pool-side counters
+ */
+typedef struct {
+    uint32_t connections;
+    uint32_t jobs;              // mining.notify sent
+    uint32_t submits;
+    uint32_t accepted;
+    uint32_t rejected;          // Hash above the share target
+    uint32_t stale;             // Unknown or superseded job
+    double acceptedWork;        // Sum of pool difficulty over accepted shares
+} mock_pool_stats_t;
+
+/**
+ * Start the pool thread and install it as the host network server
+ * @return false if the job template could not be parsed
+ */
+bool mock_pool_start(const mock_pool_config_t *config);
+
+/**
+ * Snapshot pool counters
+ */
+void mock_pool_get_stats(mock_pool_stats_t *stats);
+
+#endif // MOCK_POOL_H
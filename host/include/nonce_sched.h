@@ -0,0 +1,92 @@
+/*
+ * SparkMiner - Work-Stealing Nonce Scheduler (host)
+ * One mining thread per hardware thread for the sparkminer-linux daemon
+ *
+ * Each job's search space is cut into generations, one per extranonce2
+ * value, and each generation into 2^(32 - chunkBits) nonce chunks. Every
+ * worker owns a deque holding a contiguous run of a generation's chunks,
+ * packed with the generation number into one 64-bit atomic: the owner
+ * takes chunks from the bottom, idle workers steal the top half of a
+ * victim's run. Finished chunks are counted per generation; the worker
+ * that finishes the generation's last chunk advances it with a single
+ * CAS, which rolls extranonce2 for everyone; deques still tagged with an older generation
+ * are refilled with their owner's share by whichever worker sees them
+ * first. No lock is taken on the nonce path; a mutex only guards the job
+ * copy, read once per generation to rebuild the header.
+ *
+ * Hashing is the sha256_ll_* API (sha256_host.cpp), so workers use the
+ * host's SHA extensions when present.
+ *
+ * GPL v3 License
+ */
+
+#ifndef NONCE_SCHED_H
+#define NONCE_SCHED_H
+
+#include <stdint.h>
+#include "mining/sha256_types.h"
+#include "stratum/stratum_types.h"
+
+#define NONCE_SCHED_MAX_WORKERS     256
+
+/**
+ * Called for every hash that passes the 16-bit early reject
+ */
+typedef void (*nonce_sched_share_fn)(const char *jobId, uint32_t extraNonce2, sha256_hash_t *hash,
+                                     uint32_t timestamp, uint32_t nonce);
+
+/**
+ * Whether workers should mine (e.g. miner_is_running); NULL = always
+ */
+typedef bool (*nonce_sched_active_fn)(void);
+
+typedef struct {
+    uint32_t threads;               // Workers (0 = one per online CPU)
+    bool pin;                       // Pin worker i to CPU i % CPUs
+    uint32_t chunkBits;             // log2 nonces per chunk (17-30)
+    nonce_sched_share_fn onShare;
+    nonce_sched_active_fn active;
+    volatile uint64_t *hashCounter; // Also add hashes here (miner stats), may be NULL
+} nonce_sched_config_t;
+
+/**
+ * Per-worker counters
+ */
+typedef struct {
+    int cpu;                        // Pinned CPU, -1 if not pinned
+    uint64_t hashes;
+    uint32_t chunks;                // Chunks hashed (own + stolen)
+    uint32_t stolen;                // Chunks taken from other workers
+    uint32_t rollovers;             // Generations (extranonce2 values) this worker started
+} nonce_worker_stats_t;
+
+/**
+ * Start the worker threads (idle until the first job)
+ * @return false if already running or no thread could be created
+ */
+bool nonce_sched_start(const nonce_sched_config_t *config);
+
+/**
+ * Stop and join all workers
+ */
+void nonce_sched_stop(void);
+
+/**
+ * Switch every worker to a new job; in-flight chunks of the old job are
+ * abandoned within one batch
+ * @param extraNonce2 Extranonce2 of the job's first generation
+ */
+void nonce_sched_set_job(const stratum_job_t *job, uint32_t extraNonce2, int extraNonce2Size);
+
+/**
+ * Snapshot per-worker counters
+ * @return Number of workers
+ */
+uint32_t nonce_sched_get_stats(nonce_worker_stats_t *workers, uint32_t maxWorkers);
+
+/**
+ * Print per-worker hashrate since the previous call
+ */
+void nonce_sched_report(void);
+
+#endif // NONCE_SCHED_H
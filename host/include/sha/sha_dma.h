@@ -0,0 +1,17 @@
+/*
+ * SparkMiner - Host SHA Peripheral Lock Shim
+ * Implemented by the emulated peripheral (sha_periph.cpp). Deliberately
+ * does not pull in the register map: sha256_s3.cpp defines its own.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SHA_DMA_H
+#define HOST_SHA_DMA_H
+
+#include "hal/sha_types.h"
+
+void esp_sha_acquire_hardware(void);
+void esp_sha_release_hardware(void);
+
+#endif // HOST_SHA_DMA_H
@@ -0,0 +1,18 @@
+/*
+ * SparkMiner - Host SHA Engine Lock Shim (ESP32)
+ * Implemented by the emulated peripheral (sha_periph.cpp)
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SHA_PARALLEL_ENGINE_H
+#define HOST_SHA_PARALLEL_ENGINE_H
+
+#include <stdbool.h>
+#include "hal/sha_types.h"
+
+void esp_sha_lock_engine(esp_sha_type sha_type);
+bool esp_sha_try_lock_engine(esp_sha_type sha_type);
+void esp_sha_unlock_engine(esp_sha_type sha_type);
+
+#endif // HOST_SHA_PARALLEL_ENGINE_H
@@ -0,0 +1,84 @@
+/*
+ * SparkMiner - Emulated SHA Peripheral (host)
+ * Register-level ESP32 / ESP32-S3 SHA accelerator for native builds
+ *
+ * The register page is mapped at the chip's real address with no access
+ * rights, so the firmware's plain volatile accesses (REG_WRITE, the
+ * DPORT reads, sha256_s3.cpp's own write_reg) fault into the emulator.
+ * Each access is single-stepped with the page opened, then the page is
+ * closed again: sha256_ll.cpp and sha256_s3.cpp run unmodified.
+ *
+ * Chip semantics follow CONFIG_IDF_TARGET_*:
+ * - ESP32: SHA_TEXT words are message words as values (big-endian
+ *   interpretation). START/CONTINUE hash into a hidden internal state
+ *   that software cannot write; LOAD copies it into SHA_TEXT[0..7].
+ * - ESP32-S3: SHA_TEXT and SHA_H hold bytes in message order, so a
+ *   register read on the little-endian CPU is the byte-swapped word.
+ *   SHA_H is writable and CONTINUE hashes from it; SHA_MODE selects the
+ *   algorithm (only SHA2_256 is emulated).
+ *
+ * Calibrated against ESP-IDF's sha_hal, the driver mbedtls uses on both
+ * chips (host copies in hal/sha_ll.h and hal/sha_hal.h):
+ * - ESP32 sha_ll_fill_text_block byte-swaps each message word into
+ *   SHA_TEXT, sha_ll_read_digest returns the words after LOAD as values
+ *   and mbedtls stores them big-endian: value order, as modelled.
+ * - ESP32-S3 sha_ll_fill_text_block and sha_ll_read/write_digest copy
+ *   words unswapped and mbedtls memcpy()s the state out as the digest:
+ *   both register files are in message byte order, as modelled. The
+ *   firmware's own S3 boot self-test (sha256_s3_init: 0x80 written as
+ *   0x00000080, SHA_H[0] byte-swapped to e3b0c442) assumes the same.
+ * sha_check's "IDF hal" / "IDF resume" checks run that sequence on the
+ * golden corpus and must pass before a firmware failure counts.
+ *
+ * An operation stays in flight for busyAccesses further register
+ * accesses: SHA_BUSY reads 1 and results appear only once it completes,
+ * so a missing wait shows up as stale data and in the hazard counters.
+ * Linux x86-64 only (page protection plus the trap flag).
+ *
+ * GPL v3 License
+ */
+
+#ifndef SHA_PERIPH_H
+#define SHA_PERIPH_H
+
+#include <stdint.h>
+
+/**
+ * Emulator behaviour
+ */
+typedef struct {
+    uint32_t busyAccesses;      // Register accesses an operation stays in flight
+} sha_periph_config_t;
+
+/**
+ * Register-level counters
+ */
+typedef struct {
+    uint32_t accesses;          // Trapped register accesses
+    uint32_t starts;            // START (fresh block)
+    uint32_t continues;         // CONTINUE (block on current state)
+    uint32_t loads;             // LOAD (ESP32 state -> SHA_TEXT)
+    uint32_t busyPolls;         // SHA_BUSY reads that returned 1
+    uint32_t textWritesBusy;    // SHA_TEXT/SHA_H written while in flight
+    uint32_t resultReadsBusy;   // SHA_TEXT/SHA_H read while in flight (stale data)
+    uint32_t triggersBusy;      // START/CONTINUE/LOAD written while in flight
+    uint32_t unsupported;       // Other algorithms, DMA starts, bad mode
+} sha_periph_stats_t;
+
+/**
+ * Map the register page and install the trap handlers
+ * @return false if the page could not be mapped or the host is unsupported
+ */
+bool sha_periph_init(const sha_periph_config_t *config);
+
+/**
+ * Snapshot counters
+ */
+void sha_periph_get_stats(sha_periph_stats_t *stats);
+
+/**
+ * Zero counters
+ */
+void sha_periph_reset_stats(void);
+
+#endif // SHA_PERIPH_H
@@ -0,0 +1,115 @@
+/*
+ * SparkMiner - Host Scheduler Simulation
+ * Runs FreeRTOS tasks as host threads on simulated ESP32 cores
+ *
+ * Each simulated core runs one task at a time: the highest-priority ready
+ * task pinned to it, round-robin between equal priorities on every tick.
+ * Cores run in parallel, so the two miners really compete for host CPU
+ * the way they compete for bus and memory on the chip.
+ *
+ * Preemption happens at kernel calls (delay, queue/semaphore operations,
+ * yields, network I/O) and, when the firmware is compiled with
+ * -finstrument-functions as env:native-sim does, at every function entry.
+ * A task that becomes ready at higher priority therefore takes the core
+ * within one function call, much as the tick interrupt would. A task that
+ * never blocks still starves every lower priority on its core, IDLE
+ * included, which is what the simulation is for.
+ *
+ * Virtual time runs `speed` times faster than the wall clock. Choose speed
+ * as host hashrate / device hashrate and every CPU-bound loop takes as long
+ * in virtual time as it does on the chip; millis(), ticks and delays all
+ * use virtual time.
+ *
+ * GPL v3 License
+ */
+
+#ifndef SIM_SCHED_H
+#define SIM_SCHED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <Arduino.h>
+
+// Simulated cores (ESP32 / ESP32-S3)
+#define SIM_CORES           2
+
+// Tasks created without affinity run on this core
+#define SIM_DEFAULT_CORE    0
+
+/**
+ * Per-task scheduling statistics
+ */
+typedef struct {
+    const char *name;
+    int core;
+    UBaseType_t priority;
+    uint64_t runUs;             // Virtual CPU time consumed
+    uint32_t dispatches;        // Times the task was given the core
+    uint32_t preemptions;       // Times it lost the core while still ready
+    uint64_t waitMaxUs;         // Longest ready -> running latency
+    uint64_t waitTotalUs;       // Sum of ready -> running latencies
+} sim_task_stats_t;
+
+/**
+ * Per-core statistics
+ */
+typedef struct {
+    uint64_t idleUs;            // Virtual time with no ready task (IDLE task ran)
+    uint64_t maxBusyUs;         // Longest stretch the idle task could not run
+} sim_core_stats_t;
+
+/**
+ * Set the virtual/wall clock ratio (call before anything reads the time)
+ */
+void sim_sched_set_speed(double speed);
+
+/**
+ * Virtual/wall clock ratio
+ */
+double sim_sched_speed();
+
+/**
+ * Virtual microseconds since start
+ */
+uint64_t sim_sched_now_us();
+
+/**
+ * Start the tick thread (delay expiry, time slicing, preemption)
+ */
+void sim_sched_start();
+
+/**
+ * Kernel-call preemption point
+ * Called by host shims that stand in for blocking drivers (network, SPI)
+ */
+void sim_sched_checkpoint();
+
+/**
+ * Consume virtual CPU time on the calling task
+ * Models work the host does not perform (SPI transfers, TLS handshakes);
+ * preemption points are taken while spinning
+ * @param us Virtual microseconds of CPU time
+ */
+void sim_sched_busy(uint32_t us);
+
+/**
+ * Find a task by name
+ * @return NULL if no task has that name
+ */
+TaskHandle_t sim_sched_find(const char *name);
+
+/**
+ * Snapshot statistics
+ * @param tasks Output array, may be NULL
+ * @param maxTasks Capacity of tasks
+ * @param cores Output array of SIM_CORES entries, may be NULL
+ * @return Number of tasks
+ */
+size_t sim_sched_get_stats(sim_task_stats_t *tasks, size_t maxTasks, sim_core_stats_t *cores);
+
+/**
+ * Task watchdog timeout set by esp_task_wdt_init (seconds, 0 = disabled)
+ */
+uint32_t sim_sched_wdt_timeout();
+
+#endif // SIM_SCHED_H
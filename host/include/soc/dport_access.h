@@ -0,0 +1,20 @@
+/*
+ * SparkMiner - Host DPORT Access Shim
+ * The ESP32 DPORT bus workaround is a no-op on the host
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_DPORT_ACCESS_H
+#define HOST_DPORT_ACCESS_H
+
+#include "soc/soc.h"
+
+#define DPORT_REG_READ(_r)              REG_READ(_r)
+#define DPORT_REG_WRITE(_r, _v)         REG_WRITE(_r, _v)
+#define DPORT_SEQUENCE_REG_READ(_r)     REG_READ(_r)
+
+#define DPORT_INTERRUPT_DISABLE()
+#define DPORT_INTERRUPT_RESTORE()
+
+#endif // HOST_DPORT_ACCESS_H
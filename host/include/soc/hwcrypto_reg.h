@@ -0,0 +1,61 @@
+/*
+ * SparkMiner - Host SHA Register Map Shim
+ * Same addresses as ESP-IDF; select the chip with CONFIG_IDF_TARGET_*
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_HWCRYPTO_REG_H
+#define HOST_HWCRYPTO_REG_H
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+
+#define DR_REG_SHA_BASE         0x3FF03000
+
+#define SHA_TEXT_BASE           ((DR_REG_SHA_BASE) + 0x00)
+
+#define SHA_1_START_REG         ((DR_REG_SHA_BASE) + 0x80)
+#define SHA_1_CONTINUE_REG      ((DR_REG_SHA_BASE) + 0x84)
+#define SHA_1_LOAD_REG          ((DR_REG_SHA_BASE) + 0x88)
+#define SHA_1_BUSY_REG          ((DR_REG_SHA_BASE) + 0x8C)
+
+#define SHA_256_START_REG       ((DR_REG_SHA_BASE) + 0x90)
+#define SHA_256_CONTINUE_REG    ((DR_REG_SHA_BASE) + 0x94)
+#define SHA_256_LOAD_REG        ((DR_REG_SHA_BASE) + 0x98)
+#define SHA_256_BUSY_REG        ((DR_REG_SHA_BASE) + 0x9C)
+
+#define SHA_384_START_REG       ((DR_REG_SHA_BASE) + 0xA0)
+#define SHA_384_CONTINUE_REG    ((DR_REG_SHA_BASE) + 0xA4)
+#define SHA_384_LOAD_REG        ((DR_REG_SHA_BASE) + 0xA8)
+#define SHA_384_BUSY_REG        ((DR_REG_SHA_BASE) + 0xAC)
+
+#define SHA_512_START_REG       ((DR_REG_SHA_BASE) + 0xB0)
+#define SHA_512_CONTINUE_REG    ((DR_REG_SHA_BASE) + 0xB4)
+#define SHA_512_LOAD_REG        ((DR_REG_SHA_BASE) + 0xB8)
+#define SHA_512_BUSY_REG        ((DR_REG_SHA_BASE) + 0xBC)
+
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
+
+#define DR_REG_SHA_BASE         0x6003B000
+
+#define SHA_MODE_REG            ((DR_REG_SHA_BASE) + 0x00)
+#define SHA_T_STRING_REG        ((DR_REG_SHA_BASE) + 0x04)
+#define SHA_T_LENGTH_REG        ((DR_REG_SHA_BASE) + 0x08)
+#define SHA_DMA_BLOCK_NUM_REG   ((DR_REG_SHA_BASE) + 0x0C)
+#define SHA_START_REG           ((DR_REG_SHA_BASE) + 0x10)
+#define SHA_CONTINUE_REG        ((DR_REG_SHA_BASE) + 0x14)
+#define SHA_BUSY_REG            ((DR_REG_SHA_BASE) + 0x18)
+#define SHA_DMA_START_REG       ((DR_REG_SHA_BASE) + 0x1C)
+#define SHA_DMA_CONTINUE_REG    ((DR_REG_SHA_BASE) + 0x20)
+#define SHA_CLEAR_IRQ_REG       ((DR_REG_SHA_BASE) + 0x24)
+#define SHA_INT_ENA_REG         ((DR_REG_SHA_BASE) + 0x28)
+#define SHA_DATE_REG            ((DR_REG_SHA_BASE) + 0x2C)
+
+#define SHA_H_BASE              ((DR_REG_SHA_BASE) + 0x40)
+#define SHA_TEXT_BASE           ((DR_REG_SHA_BASE) + 0x80)
+
+#else
+#error "Host SHA registers: define CONFIG_IDF_TARGET_ESP32 or CONFIG_IDF_TARGET_ESP32S3"
+#endif
+
+#endif // HOST_HWCRYPTO_REG_H
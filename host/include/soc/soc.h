@@ -0,0 +1,20 @@
+/*
+ * SparkMiner - Host SoC Register Access Shim
+ * Plain volatile accesses, exactly as on the chip; an emulated peripheral
+ * (sha_periph.h) traps the ones that land on its register page
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SOC_H
+#define HOST_SOC_H
+
+#include <stdint.h>
+
+#define REG_WRITE(_r, _v)   (*(volatile uint32_t *)(uintptr_t)(_r) = (_v))
+#define REG_READ(_r)        (*(volatile uint32_t *)(uintptr_t)(_r))
+
+#define REG_SET_BIT(_r, _b) REG_WRITE((_r), REG_READ(_r) | (_b))
+#define REG_CLR_BIT(_r, _b) REG_WRITE((_r), REG_READ(_r) & ~(_b))
+
+#endif // HOST_SOC_H
@@ -0,0 +1,15 @@
+/*
+ * SparkMiner - Host SoC Capabilities Shim
+ * Dual-core like the ESP32 and ESP32-S3 (override for single-core layouts)
+ *
+ * GPL v3 License
+ */
+
+#ifndef HOST_SOC_CAPS_H
+#define HOST_SOC_CAPS_H
+
+#ifndef SOC_CPU_CORES_NUM
+#define SOC_CPU_CORES_NUM   2
+#endif
+
+#endif // HOST_SOC_CAPS_H
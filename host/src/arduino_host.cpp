@@ -0,0 +1,93 @@
+/*
+ * SparkMiner - Host Arduino Shim Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+HostSerial Serial;
+HostEsp ESP;
+
+static const auto s_bootTime = std::chrono::steady_clock::now();
+
+__attribute__((weak)) uint32_t millis() {
+    auto d = std::chrono::steady_clock::now() - s_bootTime;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+}
+
+__attribute__((weak)) uint32_t micros() {
+    auto d = std::chrono::steady_clock::now() - s_bootTime;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+__attribute__((weak)) void delay(uint32_t ms) {
+    (void)ms;
+}
+
+bool getLocalTime(struct tm *info, uint32_t ms) {
+    (void)ms;
+    time_t now = time(NULL);
+    return localtime_r(&now, info) != NULL;
+}
+
+// splitmix64: one atomic add per call, safe from any thread
+static std::atomic<uint64_t> s_randomState(0x5350524b4d494e52ULL);
+
+// Draws scripted by host_random_push(), served first
+static std::mutex s_pushedLock;
+static std::deque<uint32_t> s_pushed;
+static std::atomic<bool> s_hasPushed(false);
+
+uint32_t esp_random() {
+    if (s_hasPushed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lg(s_pushedLock);
+        if (!s_pushed.empty()) {
+            uint32_t value = s_pushed.front();
+            s_pushed.pop_front();
+            s_hasPushed.store(!s_pushed.empty(), std::memory_order_release);
+            return value;
+        }
+    }
+    uint64_t z = s_randomState.fetch_add(0x9e3779b97f4a7c15ULL) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+void host_random_seed(uint64_t seed) {
+    s_randomState.store(seed);
+}
+
+void host_random_push(uint32_t value) {
+    std::lock_guard<std::mutex> lg(s_pushedLock);
+    s_pushed.push_back(value);
+    s_hasPushed.store(true, std::memory_order_release);
+}
+
+// Same buffering as the core's Print::printf: lines over 63 characters
+// are formatted into a heap block, which the allocation tripwire sees
+int HostSerial::printf(const char *fmt, ...) {
+    char local[64];
+    char *buf = local;
+    va_list args;
+    va_start(args, fmt);
+    va_list copy;
+    va_copy(copy, args);
+    int n = vsnprintf(local, sizeof(local), fmt, copy);
+    va_end(copy);
+    if (n >= (int)sizeof(local)) {
+        buf = (char *)malloc(n + 1);
+        if (buf) vsnprintf(buf, n + 1, fmt, args);
+    }
+    va_end(args);
+    if (n < 0 || !buf) return 0;
+    fwrite(buf, 1, n, stdout);
+    if (buf != local) free(buf);
+    return n;
+}
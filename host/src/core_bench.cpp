@@ -0,0 +1,414 @@
+/*
+ * SparkMiner - Mining Core Microbenchmarks (host)
+ * Times the mining and protocol hot paths through the same code the
+ * firmware runs: software SHA-256, header/merkle construction, target
+ * checks, stratum parsing and display value formatting.
+ *
+ * Each case runs for at least --min-time seconds per repetition and the
+ * median repetition is reported. --json writes the results in Google
+ * Benchmark's JSON layout so scripts/bench_compare.py can diff two runs.
+ *
+ * Usage: core_bench [--filter TEXT] [--min-time S] [--repetitions N] [--json FILE]
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <fixed_string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "mining/mining_core.h"
+#include "mining/miner_sha256.h"
+#include "mining/core_vectors.h"
+#include "stratum/stratum_msg.h"
+#include "display/display_format.h"
+
+#define BENCH_MAX_REPETITIONS   32
+
+// ============================================================
+// Harness
+// ============================================================
+
+typedef void (*bench_fn_t)(uint64_t iterations);
+
+typedef struct {
+    char name[48];
+    uint64_t iterations;        // Iterations in the median repetition
+    double nsPerOp;             // Median time per iteration
+} bench_result_t;
+
+static double s_minTime = 0.2;
+static int s_repetitions = 3;
+static const char *s_filter = NULL;
+static std::vector<bench_result_t> s_results;
+
+// Keep a value alive without letting the compiler see through it
+template <typename T>
+static inline void keep(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static double nowNs() {
+    using namespace std::chrono;
+    return (double)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Grow the iteration count until one run takes min-time, then repeat
+static void runBench(const char *name, bench_fn_t fn) {
+    if (s_filter && !strstr(name, s_filter)) return;
+
+    uint64_t iterations = 1;
+    double elapsed = 0;
+    while (true) {
+        double t0 = nowNs();
+        fn(iterations);
+        elapsed = nowNs() - t0;
+        if (elapsed >= s_minTime * 1e9 || iterations >= (1ULL << 40)) break;
+        double scale = elapsed > 0 ? (s_minTime * 1e9 * 1.2) / elapsed : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        iterations = (uint64_t)(iterations * scale) + 1;
+    }
+
+    double samples[BENCH_MAX_REPETITIONS];
+    samples[0] = elapsed / iterations;
+    for (int r = 1; r < s_repetitions; r++) {
+        double t0 = nowNs();
+        fn(iterations);
+        samples[r] = (nowNs() - t0) / iterations;
+    }
+    std::sort(samples, samples + s_repetitions);
+
+    bench_result_t res;
+    snprintf(res.name, sizeof(res.name), "%s", name);
+    res.iterations = iterations;
+    res.nsPerOp = samples[s_repetitions / 2];
+    s_results.push_back(res);
+
+    printf("%-32s %12.1f ns %14.0f ops/s %12llu iter\n", name, res.nsPerOp,
+           1e9 / res.nsPerOp, (unsigned long long)iterations);
+    fflush(stdout);
+}
+
+// ============================================================
+// Fixtures
+// ============================================================
+
+static block_header_t s_header;
+static sha256_hash_t s_midstate;
+static stratum_job_t s_job;
+static uint8_t s_coinbase[CORE_COINBASE_MAX];
+static size_t s_coinbaseLen = 0;
+static uint8_t s_poolTarget[32];
+static char s_merkleHex[STRATUM_MAX_MERKLE][68];
+static const char *s_notifyLine = NULL;
+
+static void setupFixtures() {
+    // mainnet-1 header and the synthetic 3-branch job from the golden corpus
+    size_t count;
+    const core_header_vector_t *headers = core_vectors_headers(&count);
+    core_hex_decode((uint8_t *)&s_header, headers[1].header, sizeof(s_header) * 2);
+    miner_sha256_midstate(&s_midstate, &s_header);
+
+    const core_job_vector_t *jobs = core_vectors_jobs(&count);
+    s_notifyLine = jobs[count - 1].notify;
+    DynamicJsonDocument doc(2048);
+    deserializeJson(doc, s_notifyLine);
+    stratum_msg_parse_notify(doc.as<JsonVariantConst>(), jobs[count - 1].extraNonce1,
+                             jobs[count - 1].extraNonce2Size, &s_job);
+
+    // Coinbase-sized SHA input: the decoded coinbase of that job
+    s_coinbaseLen = strlen(s_job.coinBase1) / 2;
+    core_hex_decode(s_coinbase, s_job.coinBase1, strlen(s_job.coinBase1));
+    core_hex_decode(s_coinbase + s_coinbaseLen, s_job.coinBase2, strlen(s_job.coinBase2));
+    s_coinbaseLen += strlen(s_job.coinBase2) / 2 + 12;
+
+    // Deterministic merkle branches for the 0-16 sweep
+    for (int i = 0; i < STRATUM_MAX_MERKLE; i++) {
+        for (int j = 0; j < 64; j++) {
+            s_merkleHex[i][j] = "0123456789abcdef"[(i * 7 + j * 13) & 15];
+        }
+        s_merkleHex[i][64] = '\0';
+    }
+
+    core_difficulty_to_target(s_poolTarget, 0.0014);
+}
+
+// ============================================================
+// Cases - SHA-256
+// ============================================================
+
+static void benchMidstate(uint64_t n) {
+    sha256_hash_t out;
+    for (uint64_t i = 0; i < n; i++) {
+        s_header.nonce = (uint32_t)i;
+        miner_sha256_midstate(&out, &s_header);
+        keep(out);
+    }
+}
+
+static void benchHeader(uint64_t n) {
+    sha256_hash_t out;
+    for (uint64_t i = 0; i < n; i++) {
+        s_header.nonce = (uint32_t)i;
+        keep(miner_sha256_header(&s_midstate, &out, &s_header));
+    }
+}
+
+static void benchSha256Coinbase(uint64_t n) {
+    sha256_hash_t out;
+    for (uint64_t i = 0; i < n; i++) {
+        s_coinbase[0] = (uint8_t)i;
+        miner_sha256(&out, s_coinbase, s_coinbaseLen);
+        keep(out);
+    }
+}
+
+static void benchSha256dCoinbase(uint64_t n) {
+    sha256_hash_t out;
+    for (uint64_t i = 0; i < n; i++) {
+        s_coinbase[0] = (uint8_t)i;
+        core_sha256d(&out, s_coinbase, s_coinbaseLen);
+        keep(out);
+    }
+}
+
+// ============================================================
+// Cases - Job Construction
+// ============================================================
+
+static void benchMerkle(uint64_t n, int branches) {
+    static stratum_job_t job;
+    memset(&job, 0, sizeof(job));
+    for (int b = 0; b < branches; b++) strcpy(job.merkleBranches[b], s_merkleHex[b]);
+    job.merkleBranchCount = branches;
+
+    uint8_t root[32] = {0};
+    for (uint64_t i = 0; i < n; i++) {
+        root[0] = (uint8_t)i;
+        core_merkle_root(root, root, &job);
+        keep(root);
+    }
+}
+
+static void benchMerkle0(uint64_t n)  { benchMerkle(n, 0); }
+static void benchMerkle1(uint64_t n)  { benchMerkle(n, 1); }
+static void benchMerkle4(uint64_t n)  { benchMerkle(n, 4); }
+static void benchMerkle8(uint64_t n)  { benchMerkle(n, 8); }
+static void benchMerkle12(uint64_t n) { benchMerkle(n, 12); }
+static void benchMerkle16(uint64_t n) { benchMerkle(n, 16); }
+
+static void benchHexDecode64(uint64_t n) {
+    uint8_t out[32];
+    for (uint64_t i = 0; i < n; i++) {
+        core_hex_decode(out, s_merkleHex[i & 15], 64);
+        keep(out);
+    }
+}
+
+static void benchHexDecodeCoinbase(uint64_t n) {
+    uint8_t out[CORE_COINBASE_MAX];
+    size_t len = strlen(s_job.coinBase2);
+    for (uint64_t i = 0; i < n; i++) {
+        core_hex_decode(out, s_job.coinBase2, len);
+        keep(out);
+    }
+}
+
+static void benchBuildHeader(uint64_t n) {
+    block_header_t hb;
+    for (uint64_t i = 0; i < n; i++) {
+        keep(core_build_header(&hb, &s_job, (uint32_t)i, s_job.extraNonce2Size));
+        keep(hb);
+    }
+}
+
+// ============================================================
+// Cases - Share Checks
+// ============================================================
+
+static void benchCheckTarget(uint64_t n) {
+    sha256_hash_t hash;
+    miner_sha256(&hash, (uint8_t *)&s_header, sizeof(s_header));
+    for (uint64_t i = 0; i < n; i++) {
+        hash.bytes[0] = (uint8_t)i;
+        keep(core_check_target(hash.bytes, s_poolTarget));
+    }
+}
+
+static void benchHashDifficulty(uint64_t n) {
+    sha256_hash_t hash;
+    miner_sha256(&hash, (uint8_t *)&s_header, sizeof(s_header));
+    for (uint64_t i = 0; i < n; i++) {
+        hash.bytes[0] = (uint8_t)i;
+        keep(core_hash_difficulty(&hash));
+    }
+}
+
+static void benchDifficultyToTarget(uint64_t n) {
+    uint8_t target[32];
+    for (uint64_t i = 0; i < n; i++) {
+        core_difficulty_to_target(target, 0.0014 + (double)(i & 7));
+        keep(target);
+    }
+}
+
+// ============================================================
+// Cases - Protocol & Display
+// ============================================================
+
+static void benchParseNotify(uint64_t n) {
+    static StaticJsonDocument<2048> doc;
+    static stratum_job_t job;
+    for (uint64_t i = 0; i < n; i++) {
+        deserializeJson(doc, s_notifyLine);
+        keep(stratum_msg_parse_notify(doc.as<JsonVariantConst>(), "f000000d", 8, &job));
+    }
+}
+
+static void benchFormatSubmit(uint64_t n) {
+    submit_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    strcpy(entry.jobId, "4a2f");
+    strcpy(entry.extraNonce2, "000000001234ABCD");
+    entry.timestamp = 0x6553f100;
+    char msg[512];
+    for (uint64_t i = 0; i < n; i++) {
+        entry.nonce = (uint32_t)i;
+        keep(stratum_msg_format_submit(msg, sizeof(msg), (uint32_t)i,
+                                       "bc1qexampleexampleexampleexampleexample", &entry));
+    }
+}
+
+static void benchFormatDisplay(uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        char a[DISPLAY_FORMAT_LEN], b[DISPLAY_FORMAT_LEN], c[DISPLAY_FORMAT_LEN], d[DISPLAY_FORMAT_LEN];
+        display_format_hashrate(a, sizeof(a), 715230.0 + (double)(i & 1023));
+        display_format_number(b, sizeof(b), 123456789012ULL + i);
+        display_format_uptime(c, sizeof(c), 93784 + (uint32_t)i);
+        display_format_difficulty(d, sizeof(d), 0.2736 * (double)(1 + (i & 7)));
+        keep(strlen(a) + strlen(b) + strlen(c) + strlen(d));
+    }
+}
+
+// The portal's timezone list: 27 formatted options appended to one buffer
+static void benchOptionsFixed(uint64_t n) {
+    static FixedString<2047> html;
+    for (uint64_t i = 0; i < n; i++) {
+        html = "<select name='tz'>";
+        for (int tz = -12; tz <= 14; tz++) {
+            html.appendf("<option value='%d'%s>UTC%s%d</option>",
+                         tz, tz == (int)(i % 27) - 12 ? " selected" : "", tz >= 0 ? "+" : "", tz);
+        }
+        html += "</select>";
+        keep(html.length());
+    }
+}
+
+// Same list the way String code builds it, for comparison (heap on every +=)
+static void benchOptionsString(uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        String html = "<select name='tz'>";
+        for (int tz = -12; tz <= 14; tz++) {
+            html += "<option value='";
+            html += String(tz);
+            html += "'";
+            if (tz == (int)(i % 27) - 12) html += " selected";
+            html += ">UTC";
+            html += tz >= 0 ? "+" : "";
+            html += String(tz);
+            html += "</option>";
+        }
+        html += "</select>";
+        keep(html.length());
+    }
+}
+
+static void benchParseView(uint64_t n) {
+    static const char *spec = "  proxy.example.net:3128:miner:secret\r\n";
+    for (uint64_t i = 0; i < n; i++) {
+        StringView line = StringView(spec).trim();
+        size_t port = line.find(':');
+        size_t user = line.find(':', port + 1);
+        FixedString<63> host(line.substr(0, port));
+        FixedString<95> auth(line.substr(user + 1));
+        keep(host.length() + auth.length() + (size_t)atoi(line.data() + port + 1));
+    }
+}
+
+// ============================================================
+// JSON Output
+// ============================================================
+
+static bool writeJson(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"context\": {\n");
+    fprintf(f, "    \"executable\": \"core_bench\",\n");
+    fprintf(f, "    \"min_time\": %.3f,\n", s_minTime);
+    fprintf(f, "    \"repetitions\": %d\n  },\n", s_repetitions);
+    fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < s_results.size(); i++) {
+        const bench_result_t &r = s_results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"run_type\": \"aggregate\", \"aggregate_name\": \"median\", "
+                   "\"iterations\": %llu, \"real_time\": %.3f, \"cpu_time\": %.3f, "
+                   "\"time_unit\": \"ns\", \"items_per_second\": %.1f}%s\n",
+                r.name, (unsigned long long)r.iterations, r.nsPerOp, r.nsPerOp,
+                1e9 / r.nsPerOp, i + 1 < s_results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *jsonPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) s_filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) s_minTime = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--repetitions") && i + 1 < argc) s_repetitions = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [--filter TEXT] [--min-time S] [--repetitions N] [--json FILE]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    s_repetitions = constrain(s_repetitions, 1, BENCH_MAX_REPETITIONS);
+    if (s_minTime <= 0) s_minTime = 0.01;
+
+    setupFixtures();
+    printf("[BENCH] min-time %.2fs, %d repetitions (median reported)\n", s_minTime, s_repetitions);
+
+    runBench("sha256/midstate", benchMidstate);
+    runBench("sha256/header", benchHeader);
+    runBench("sha256/coinbase", benchSha256Coinbase);
+    runBench("sha256d/coinbase", benchSha256dCoinbase);
+    runBench("merkle/0", benchMerkle0);
+    runBench("merkle/1", benchMerkle1);
+    runBench("merkle/4", benchMerkle4);
+    runBench("merkle/8", benchMerkle8);
+    runBench("merkle/12", benchMerkle12);
+    runBench("merkle/16", benchMerkle16);
+    runBench("hex/decode_64", benchHexDecode64);
+    runBench("hex/decode_coinbase2", benchHexDecodeCoinbase);
+    runBench("job/build_header", benchBuildHeader);
+    runBench("share/check_target", benchCheckTarget);
+    runBench("share/hash_difficulty", benchHashDifficulty);
+    runBench("share/difficulty_to_target", benchDifficultyToTarget);
+    runBench("stratum/parse_notify", benchParseNotify);
+    runBench("stratum/format_submit", benchFormatSubmit);
+    runBench("display/format_fields", benchFormatDisplay);
+    runBench("string/options_fixed", benchOptionsFixed);
+    runBench("string/options_arduino", benchOptionsString);
+    runBench("string/parse_view", benchParseView);
+
+    if (jsonPath && !writeJson(jsonPath)) return 1;
+    return 0;
+}
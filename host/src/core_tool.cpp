@@ -0,0 +1,177 @@
+/*
+ * SparkMiner - Mining Core Tool (host)
+ * Runs the portable mining core on the command line: header construction
+ * from a mining.notify line, target/difficulty math and header hashing,
+ * through the same code paths the firmware uses.
+ *
+ * Usage:
+ *   core_tool notify JSON EXTRANONCE1 EN2SIZE [EN2]   Build and hash a job header
+ *   core_tool hash HEADER_HEX                         Hash an 80-byte header
+ *   core_tool target DIFFICULTY                       Share target for a pool difficulty
+ *   core_tool bits NBITS_HEX                          Block target for compact nBits
+ *   core_tool selftest                                Run the golden vectors
+ *
+ * GPL v3 License
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mining/mining_core.h"
+#include "mining/core_vectors.h"
+#include "mining/miner_sha256.h"
+#include "stratum/stratum_msg.h"
+
+// pio test links the env's sources into each test/ program, which has its own main()
+#ifndef PIO_UNIT_TESTING
+
+// ============================================================
+// Output Helpers
+// ============================================================
+
+static void printBytes(const char *label, const uint8_t *buf, size_t len) {
+    printf("%-12s ", label);
+    for (size_t i = 0; i < len; i++) printf("%02x", buf[i]);
+    printf("\n");
+}
+
+// 256-bit little-endian values are conventionally shown most significant byte first
+static void printLe256(const char *label, const uint8_t *buf) {
+    printf("%-12s ", label);
+    for (int i = 31; i >= 0; i--) printf("%02x", buf[i]);
+    printf("\n");
+}
+
+// Hash a header both ways: plain double SHA-256 and the midstate path the miners use
+static int hashHeader(block_header_t *hb) {
+    sha256_hash_t full, midstate, fast;
+    core_sha256d(&full, (const uint8_t *)hb, sizeof(*hb));
+
+    miner_sha256_midstate(&midstate, hb);
+    bool passed16 = miner_sha256_header(&midstate, &fast, hb);
+
+    printLe256("hash", full.bytes);
+    printf("%-12s %.6g\n", "difficulty", core_hash_difficulty(&full));
+    if (passed16 && memcmp(full.bytes, fast.bytes, 32) != 0) {
+        printf("ERROR: midstate hash differs from full hash\n");
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================
+// Commands
+// ============================================================
+
+static int cmdNotify(const char *json, const char *extraNonce1, int en2Size, uint32_t en2) {
+    static StaticJsonDocument<4096> doc;
+    DeserializationError err = deserializeJson(doc, json);
+    if (err) {
+        fprintf(stderr, "JSON parse error: %s\n", err.c_str());
+        return 1;
+    }
+    if (stratum_msg_classify(doc.as<JsonVariantConst>()) != STRATUM_MSG_NOTIFY) {
+        fprintf(stderr, "Not a mining.notify message\n");
+        return 1;
+    }
+
+    static stratum_job_t job;
+    if (!stratum_msg_parse_notify(doc.as<JsonVariantConst>(), extraNonce1, en2Size, &job)) {
+        fprintf(stderr, "Malformed mining.notify\n");
+        return 1;
+    }
+
+    block_header_t hb;
+    if (!core_build_header(&hb, &job, en2, en2Size)) {
+        fprintf(stderr, "Job %s: malformed coinbase or prevhash\n", job.jobId);
+        return 1;
+    }
+
+    uint8_t target[32];
+    core_bits_to_target(hb.difficulty, target);
+
+    char en2Hex[CORE_EXTRANONCE2_MAX * 2 + 1];
+    core_encode_extranonce(en2Hex, en2Size, en2);
+
+    printf("%-12s %s (%d merkle branches%s)\n", "job", job.jobId, job.merkleBranchCount,
+           job.cleanJobs ? ", clean" : "");
+    printf("%-12s %s\n", "extranonce2", en2Hex);
+    printBytes("header", (const uint8_t *)&hb, sizeof(hb));
+    printBytes("merkle_root", hb.merkle_root, 32);
+    printLe256("block_target", target);
+    return hashHeader(&hb);
+}
+
+static int cmdHash(const char *hex) {
+    if (strlen(hex) != sizeof(block_header_t) * 2) {
+        fprintf(stderr, "Header must be %u hex characters\n", (unsigned)sizeof(block_header_t) * 2);
+        return 1;
+    }
+    block_header_t hb;
+    core_hex_decode((uint8_t *)&hb, hex, strlen(hex));
+    return hashHeader(&hb);
+}
+
+static int cmdTarget(double difficulty) {
+    if (!(difficulty > 0)) {
+        fprintf(stderr, "Difficulty must be > 0\n");
+        return 1;
+    }
+    uint8_t target[32];
+    core_difficulty_to_target(target, difficulty);
+    printLe256("share_target", target);
+    return 0;
+}
+
+static int cmdBits(uint32_t nBits) {
+    uint8_t target[32];
+    core_bits_to_target(nBits, target);
+    printLe256("block_target", target);
+    return 0;
+}
+
+static bool reportVectors(const char *what, core_vectors_result_t res) {
+    printf("%-22s %2u vectors, %u failed%s%s\n", what, res.run, res.failed,
+           res.firstFailure ? " - first: " : "", res.firstFailure ? res.firstFailure : "");
+    return res.failed == 0;
+}
+
+static int cmdSelfTest() {
+    bool ok = true;
+    ok &= reportVectors("engine sha256d", core_vectors_check_engine(core_engine_sha256d));
+    ok &= reportVectors("engine midstate", core_vectors_check_engine(core_engine_midstate));
+    ok &= reportVectors("pipeline sha256d", core_vectors_check_jobs(core_engine_sha256d));
+    ok &= reportVectors("pipeline midstate", core_vectors_check_jobs(core_engine_midstate));
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr,
+        "Usage:\n"
+        "  %s notify JSON EXTRANONCE1 EN2SIZE [EN2]\n"
+        "  %s hash HEADER_HEX\n"
+        "  %s target DIFFICULTY\n"
+        "  %s bits NBITS_HEX\n"
+        "  %s selftest\n",
+        argv0, argv0, argv0, argv0, argv0);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 2 && !strcmp(argv[1], "selftest")) return cmdSelfTest();
+    if (argc < 3) return usage(argv[0]);
+    const char *cmd = argv[1];
+
+    if (!strcmp(cmd, "notify") && (argc == 5 || argc == 6)) {
+        int en2Size = atoi(argv[4]);
+        uint32_t en2 = argc == 6 ? (uint32_t)strtoul(argv[5], NULL, 16) : 0;
+        return cmdNotify(argv[2], argv[3], en2Size, en2);
+    }
+    if (!strcmp(cmd, "hash") && argc == 3) return cmdHash(argv[2]);
+    if (!strcmp(cmd, "target") && argc == 3) return cmdTarget(atof(argv[2]));
+    if (!strcmp(cmd, "bits") && argc == 3) return cmdBits((uint32_t)strtoul(argv[2], NULL, 16));
+    return usage(argv[0]);
+}
+
+#endif // PIO_UNIT_TESTING
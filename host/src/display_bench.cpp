@@ -0,0 +1,268 @@
+/*
+ * SparkMiner - Display Render Benchmark (host)
+ * Renders every screen through the framebuffer DisplayDriver and reports
+ * per-frame pixel/byte transfer and CPU time, optionally dumping PNGs.
+ *
+ * A second table compares numeric text drawn with print() (one window per
+ * font pixel) against the glyph cache (one window per string).
+ *
+ * Usage: display_bench [--png DIR] [--iterations N] [--rotation R] [--mono]
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <board_config.h>
+#include "display_fb.h"
+#include "display/display.h"
+#include "display/display_interface.h"
+#include "display/glyph_cache.h"
+#include "stats/history.h"
+
+#include <TFT_eSPI.h>
+
+// SPI clock used to convert bytes into bus time (CYD runs ILI9341 at 40-55 MHz)
+#define BENCH_SPI_HZ    40000000.0
+
+static const char *s_screenNames[SCREEN_COUNT] = {"mining", "stats", "clock"};
+
+// ============================================================
+// Framebuffer DisplayDriver
+// display.cpp provides the implementation; this table routes the
+// abstract interface to it exactly like a board build would
+// ============================================================
+
+static DisplayDriver s_fbDriver = {
+    .init = display_init,
+    .update = display_update,
+    .set_brightness = display_set_brightness,
+    .next_screen = display_next_screen,
+    .show_ap_config = display_show_ap_config,
+    .show_boot = NULL,
+    .show_reset_countdown = display_show_reset_countdown,
+    .show_reset_complete = display_show_reset_complete,
+    .redraw = display_redraw,
+    .flip_rotation = display_flip_rotation,
+    .set_inverted = display_set_inverted,
+    .get_width = display_get_width,
+    .get_height = display_get_height,
+    .is_portrait = display_is_portrait,
+    .get_screen = display_get_screen,
+    .set_screen = display_set_screen,
+    .set_sleep = display_set_sleep,
+    .name = "Framebuffer (host)",
+};
+
+// ============================================================
+// Sample Data
+// ============================================================
+
+static void fillSampleData(display_data_t *data) {
+    memset(data, 0, sizeof(*data));
+    data->totalHashes = 123456789012ULL;
+    data->hashRate = 715230.0;
+    data->bestDifficulty = 0.2736;
+    data->sharesAccepted = 1234;
+    data->sharesRejected = 3;
+    data->templates = 4567;
+    data->blocks32 = 12;
+    data->blocksFound = 0;
+    data->uptimeSeconds = 93784;
+    data->avgLatency = 142;
+    data->poolConnected = true;
+    data->poolName = "public-pool.io";
+    data->poolDifficulty = 0.0014;
+    data->poolWorkersTotal = 9876;
+    data->poolWorkersAddress = 1;
+    strcpy(data->poolHashrate, "1.23 PH/s");
+    strcpy(data->addressBestDiff, "4.56M");
+    data->wifiConnected = true;
+    data->wifiRssi = -58;
+    data->ipAddress = "192.168.1.42";
+    data->btcPrice = 97123.0f;
+    data->blockHeight = 875432;
+    strcpy(data->networkHashrate, "812.4 EH/s");
+    strcpy(data->networkDifficulty, "110.45T");
+    data->halfHourFee = 7;
+}
+
+// History interval: steady hashrate with a stall every 12th sample
+// (the kind of dip a WiFi scan or live stats fetch causes)
+static void pushHistorySample(uint32_t n) {
+    float rate = 715000.0f + (float)((n * 7919) % 8000) - 4000.0f;
+    if (n % 12 == 0) rate *= 0.55f;
+    history_push(rate, 48.0f + (float)(n % 20) / 4.0f);
+}
+
+// Simulate one monitor tick: hashes advance, hashrate wobbles, one history sample
+static void advanceSampleData(display_data_t *data, uint32_t tick) {
+    data->totalHashes += 715000;
+    data->hashRate = 715230.0 + (double)((tick * 7919) % 4000) - 2000.0;
+    data->uptimeSeconds += 1;
+    pushHistorySample(history_seq());
+    data->historySeq = history_seq();
+}
+
+// ============================================================
+// Benchmark
+// ============================================================
+
+static double nowUs() {
+    using namespace std::chrono;
+    return duration_cast<duration<double, std::micro>>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void printRow(const char *screen, const char *kind, const fb_frame_stats_t &st, double us) {
+    double busMs = st.bytesTransferred * 8.0 / BENCH_SPI_HZ * 1000.0;
+    printf("%-8s %-12s %8u %9u %9u %10u %9.1f %9.2f\n",
+           screen, kind, st.primitives, st.pixelsWritten, st.pixelsChanged,
+           st.bytesTransferred, us, busMs);
+}
+
+// ============================================================
+// Text Benchmark
+// ============================================================
+
+static const struct {
+    const char *text;
+    uint8_t size;
+} s_textCases[] = {
+    {"715.23 KH/s", 1},
+    {"715.23 KH/s", 2},
+    {"12:34:56", 4},
+};
+
+static void benchText(TFT_eSPI *fb, int iterations) {
+    const uint16_t fg = 0xFD00;
+    const uint16_t bg = 0x10A2;
+
+    printf("%-8s %-12s %8s %9s %9s %10s %9s %9s\n",
+           "text", "path", "prims", "pixels", "changed", "bytes", "cpu_us", "spi_ms");
+
+    for (size_t c = 0; c < sizeof(s_textCases) / sizeof(s_textCases[0]); c++) {
+        const char *text = s_textCases[c].text;
+        uint8_t size = s_textCases[c].size;
+        char label[16];
+        snprintf(label, sizeof(label), "size %u", size);
+
+        // GLCD print path (transparent, as the screens used to draw it)
+        fb->fillRect(0, 40, fb->width(), 8 * size, bg);
+        fb->setTextSize(size);
+        fb->setTextColor(fg);
+        fb->beginFrame();
+        fb->setCursor(4, 40);
+        fb->print(text);
+        fb_frame_stats_t printed = fb->endFrame();
+
+        double t0 = nowUs();
+        for (int i = 0; i < iterations; i++) {
+            fb->setCursor(4, 40);
+            fb->print(text);
+        }
+        double printUs = (nowUs() - t0) / iterations;
+
+        // Glyph cache blit (opaque, single window)
+        fb->fillRect(0, 40, fb->width(), 8 * size, bg);
+        fb->beginFrame();
+        fb->setCursor(4, 40);
+        glyph_cache_draw(fb, text, size, fg, bg);
+        fb_frame_stats_t cached = fb->endFrame();
+
+        t0 = nowUs();
+        for (int i = 0; i < iterations; i++) {
+            fb->setCursor(4, 40);
+            glyph_cache_draw(fb, text, size, fg, bg);
+        }
+        double cachedUs = (nowUs() - t0) / iterations;
+
+        printRow(label, "print", printed, printUs);
+        printRow(label, "glyph-cache", cached, cachedUs);
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *pngDir = NULL;
+    int iterations = 200;
+    int rotation = 1;
+    bool mono = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--png") && i + 1 < argc) pngDir = argv[++i];
+        else if (!strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--rotation") && i + 1 < argc) rotation = atoi(argv[++i]) & 3;
+        else if (!strcmp(argv[i], "--mono")) mono = true;
+        else {
+            fprintf(stderr, "Usage: %s [--png DIR] [--iterations N] [--rotation R] [--mono]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations < 1) iterations = 1;
+
+    display_register_driver(&s_fbDriver);
+    DisplayDriver *drv = display_get_driver();
+
+    TFT_eSPI *fb = display_fb_canvas();
+    if (mono) {
+        fb->setFormat(FB_FORMAT_MONO);
+    }
+
+    drv->init(rotation, 100);
+    drv->set_inverted(false);
+    drv->set_screen(SCREEN_MINING);
+
+    printf("[BENCH] %s %dx%d %s, %d iterations\n", drv->name, drv->get_width(), drv->get_height(),
+           mono ? "mono" : "RGB565", iterations);
+    printf("%-8s %-12s %8s %9s %9s %10s %9s %9s\n",
+           "screen", "frame", "prims", "pixels", "changed", "bytes", "cpu_us", "spi_ms");
+
+    display_data_t data;
+    fillSampleData(&data);
+    while (history_seq() < HISTORY_SAMPLES) pushHistorySample(history_seq());
+    data.historySeq = history_seq();
+
+    for (uint8_t screen = 0; screen < SCREEN_COUNT; screen++) {
+        drv->set_screen(screen);
+        drv->redraw();
+
+        // Full frame (screen switch)
+        fb->beginFrame();
+        drv->update(&data);
+        fb_frame_stats_t full = fb->endFrame();
+
+        if (pngDir) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s.png", pngDir, s_screenNames[screen]);
+            if (fb->writePng(path)) printf("[BENCH] Wrote %s\n", path);
+        }
+
+        // Incremental frame (typical 1s tick)
+        advanceSampleData(&data, 1);
+        fb->beginFrame();
+        drv->update(&data);
+        fb_frame_stats_t inc = fb->endFrame();
+
+        // Timing loop: average CPU cost of each frame kind
+        double fullTotal = 0, incTotal = 0;
+        for (int i = 0; i < iterations; i++) {
+            drv->redraw();
+            double t0 = nowUs();
+            drv->update(&data);
+            fullTotal += nowUs() - t0;
+
+            advanceSampleData(&data, i + 2);
+            t0 = nowUs();
+            drv->update(&data);
+            incTotal += nowUs() - t0;
+        }
+
+        printRow(s_screenNames[screen], "full", full, fullTotal / iterations);
+        printRow(s_screenNames[screen], "incremental", inc, incTotal / iterations);
+    }
+
+    if (!mono) {
+        benchText(fb, iterations);
+    }
+
+    return 0;
+}
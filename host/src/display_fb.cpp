@@ -0,0 +1,471 @@
+/*
+ * SparkMiner - Host Framebuffer Display Backend Implementation
+ *
+ * Drawing algorithms follow Adafruit_GFX / TFT_eSPI so pixel output and
+ * primitive counts match what the ESP32 pushes over SPI.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include "display_fb.h"
+
+// ============================================================
+// GLCD 5x7 Font (printable ASCII 0x20-0x7E)
+// Column-major, LSB = top row - same glyphs as TFT_eSPI LOAD_GLCD
+// ============================================================
+
+static const uint8_t s_glcdFont[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},
+    {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},
+    {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},
+    {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+    {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02},
+};
+
+// ============================================================
+// Construction / Setup
+// ============================================================
+
+FbCanvas::FbCanvas(int16_t w, int16_t h, fb_format_t format)
+    : m_nativeWidth(w), m_nativeHeight(h), m_width(w), m_height(h),
+      m_rotation(0), m_inverted(false), m_format(format),
+      m_winX(0), m_winY(0), m_winW(0), m_winH(0), m_winPos(0),
+      m_cursorX(0), m_cursorY(0), m_textFg(0xFFFF), m_textBg(0xFFFF),
+      m_textSize(1), m_textWrap(true) {
+    memset(&m_frame, 0, sizeof(m_frame));
+    memset(&m_total, 0, sizeof(m_total));
+}
+
+void FbCanvas::begin() {
+    m_pixels.assign((size_t)m_width * m_height, 0);
+}
+
+void FbCanvas::setRotation(uint8_t r) {
+    m_rotation = r & 3;
+    if (m_rotation & 1) {
+        m_width = m_nativeHeight;
+        m_height = m_nativeWidth;
+    } else {
+        m_width = m_nativeWidth;
+        m_height = m_nativeHeight;
+    }
+    // GRAM content is not preserved meaningfully across MADCTL changes
+    m_pixels.assign((size_t)m_width * m_height, 0);
+}
+
+// ============================================================
+// Accounting
+// ============================================================
+
+__attribute__((weak)) void display_fb_on_transfer(uint32_t bytes) {
+    (void)bytes;
+}
+
+void FbCanvas::countWindow(uint32_t pixels) {
+    if (pixels == 0) return;
+    m_frame.primitives++;
+    m_frame.pixelsWritten += pixels;
+    if (m_format == FB_FORMAT_RGB565) {
+        m_frame.bytesTransferred += FB_WINDOW_OVERHEAD + pixels * 2;
+        display_fb_on_transfer(FB_WINDOW_OVERHEAD + pixels * 2);
+    }
+}
+
+void FbCanvas::beginFrame() {
+    memset(&m_frame, 0, sizeof(m_frame));
+}
+
+fb_frame_stats_t FbCanvas::endFrame() {
+    // Monochrome controllers (U8g2 full-buffer mode) resend the whole
+    // buffer whenever anything was drawn
+    if (m_format == FB_FORMAT_MONO && m_frame.pixelsWritten > 0) {
+        m_frame.bytesTransferred = ((uint32_t)m_width * m_height) / 8;
+        display_fb_on_transfer(m_frame.bytesTransferred);
+    }
+
+    m_total.primitives += m_frame.primitives;
+    m_total.pixelsWritten += m_frame.pixelsWritten;
+    m_total.pixelsChanged += m_frame.pixelsChanged;
+    m_total.bytesTransferred += m_frame.bytesTransferred;
+    return m_frame;
+}
+
+// ============================================================
+// Primitives
+// ============================================================
+
+void FbCanvas::putPixel(int32_t x, int32_t y, uint16_t color) {
+    if (m_format == FB_FORMAT_MONO) {
+        // Threshold on approximate luminance (R + 2G + B over 5/6/5 bits)
+        uint32_t r = (color >> 11) & 0x1F;
+        uint32_t g = (color >> 5) & 0x3F;
+        uint32_t b = color & 0x1F;
+        color = ((r * 2 + g + b * 2) >= 126) ? 0xFFFF : 0x0000;
+    }
+    uint16_t &p = m_pixels[(size_t)y * m_width + x];
+    if (p != color) {
+        p = color;
+        m_frame.pixelsChanged++;
+    }
+}
+
+void FbCanvas::drawPixel(int32_t x, int32_t y, uint32_t color) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return;
+    putPixel(x, y, (uint16_t)color);
+    countWindow(1);
+}
+
+void FbCanvas::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    // Clip to screen
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > m_width) w = m_width - x;
+    if (y + h > m_height) h = m_height - y;
+    if (w <= 0 || h <= 0) return;
+
+    for (int32_t j = y; j < y + h; j++) {
+        for (int32_t i = x; i < x + w; i++) {
+            putPixel(i, j, (uint16_t)color);
+        }
+    }
+    countWindow((uint32_t)w * h);
+}
+
+void FbCanvas::fillScreen(uint32_t color) {
+    fillRect(0, 0, m_width, m_height, color);
+}
+
+void FbCanvas::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    m_winX = x;
+    m_winY = y;
+    m_winW = w > 0 ? w : 0;
+    m_winH = h > 0 ? h : 0;
+    m_winPos = 0;
+
+    // Window commands only; pixel bytes are counted as they are pushed
+    m_frame.primitives++;
+    if (m_format == FB_FORMAT_RGB565) {
+        m_frame.bytesTransferred += FB_WINDOW_OVERHEAD;
+    }
+}
+
+void FbCanvas::pushColors(const uint16_t *data, uint32_t len, bool swap) {
+    (void)swap;  // Host pixels are native-endian
+    uint32_t area = (uint32_t)m_winW * m_winH;
+    for (uint32_t i = 0; i < len && m_winPos < area; i++, m_winPos++) {
+        int32_t x = m_winX + (int32_t)(m_winPos % m_winW);
+        int32_t y = m_winY + (int32_t)(m_winPos / m_winW);
+        if (x >= 0 && y >= 0 && x < m_width && y < m_height) {
+            putPixel(x, y, data[i]);
+        }
+    }
+    m_frame.pixelsWritten += len;
+    if (m_format == FB_FORMAT_RGB565) {
+        m_frame.bytesTransferred += len * 2;
+    }
+}
+
+void FbCanvas::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void FbCanvas::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void FbCanvas::hline(int32_t x, int32_t y, int32_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void FbCanvas::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y + 1, h - 2, color);
+    drawFastVLine(x + w - 1, y + 1, h - 2, color);
+}
+
+void FbCanvas::drawCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, uint16_t color) {
+    int32_t f = 1 - r;
+    int32_t ddF_x = 1;
+    int32_t ddF_y = -2 * r;
+    int32_t x = 0;
+    int32_t y = r;
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (corners & 0x4) { drawPixel(x0 + x, y0 + y, color); drawPixel(x0 + y, y0 + x, color); }
+        if (corners & 0x2) { drawPixel(x0 + x, y0 - y, color); drawPixel(x0 + y, y0 - x, color); }
+        if (corners & 0x8) { drawPixel(x0 - y, y0 + x, color); drawPixel(x0 - x, y0 + y, color); }
+        if (corners & 0x1) { drawPixel(x0 - y, y0 - x, color); drawPixel(x0 - x, y0 - y, color); }
+    }
+}
+
+void FbCanvas::fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint16_t color) {
+    int32_t f = 1 - r;
+    int32_t ddF_x = 1;
+    int32_t ddF_y = -r - r;
+    int32_t y = 0;
+
+    delta++;
+    while (y < r) {
+        if (f >= 0) {
+            if (corners & 0x1) hline(x0 - y, y0 + r, y + y + delta, color);
+            if (corners & 0x2) hline(x0 - y, y0 - r, y + y + delta, color);
+            r--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        y++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (corners & 0x1) hline(x0 - r, y0 + y, r + r + delta, color);
+        if (corners & 0x2) hline(x0 - r, y0 - y, r + r + delta, color);
+    }
+}
+
+void FbCanvas::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    drawFastHLine(x + r, y, w - r - r, color);
+    drawFastHLine(x + r, y + h - 1, w - r - r, color);
+    drawFastVLine(x, y + r, h - r - r, color);
+    drawFastVLine(x + w - 1, y + r, h - r - r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color);
+    drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+}
+
+void FbCanvas::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    // Same decomposition as TFT_eSPI: centre band + horizontal corner spans
+    fillRect(x, y + r, w, h - r - r, color);
+    fillCircleHelper(x + r, y + h - r - 1, r, 1, w - r - r - 1, color);
+    fillCircleHelper(x + r, y + r, r, 2, w - r - r - 1, color);
+}
+
+void FbCanvas::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+    hline(x0 - r, y0, r + r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+}
+
+// ============================================================
+// Text
+// ============================================================
+
+void FbCanvas::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t fg, uint32_t bg, uint8_t size) {
+    if (c < 0x20 || c > 0x7E) c = '?';
+    const uint8_t *glyph = s_glcdFont[c - 0x20];
+    bool fillbg = (fg != bg);
+
+    if (size == 1 && fillbg) {
+        // Whole 6x8 cell pushed through one window
+        if (x < 0 || y < 0 || x + 6 > m_width || y + 8 > m_height) return;
+        for (int8_t i = 0; i < 6; i++) {
+            uint8_t line = (i < 5) ? glyph[i] : 0;
+            for (int8_t j = 0; j < 8; j++, line >>= 1) {
+                putPixel(x + i, y + j, (line & 1) ? fg : bg);
+            }
+        }
+        countWindow(48);
+        return;
+    }
+
+    // Transparent background: one primitive per set font pixel
+    for (int8_t i = 0; i < 6; i++) {
+        uint8_t line = (i < 5) ? glyph[i] : 0;
+        for (int8_t j = 0; j < 8; j++, line >>= 1) {
+            if (line & 1) {
+                if (size == 1) drawPixel(x + i, y + j, fg);
+                else fillRect(x + i * size, y + j * size, size, size, fg);
+            } else if (fillbg) {
+                fillRect(x + i * size, y + j * size, size, size, bg);
+            }
+        }
+    }
+}
+
+size_t FbCanvas::print(char c) {
+    if (c == '\n') {
+        m_cursorY += m_textSize * 8;
+        m_cursorX = 0;
+        return 1;
+    }
+    if (c == '\r') return 1;
+
+    if (m_textWrap && (m_cursorX + m_textSize * 6 > m_width)) {
+        m_cursorY += m_textSize * 8;
+        m_cursorX = 0;
+    }
+    drawChar(m_cursorX, m_cursorY, (uint8_t)c, m_textFg, m_textBg, m_textSize);
+    m_cursorX += m_textSize * 6;
+    return 1;
+}
+
+size_t FbCanvas::print(const char *s) {
+    size_t n = 0;
+    if (!s) return 0;
+    while (*s) n += print(*s++);
+    return n;
+}
+
+size_t FbCanvas::print(int v) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", v);
+    return print(buf);
+}
+
+size_t FbCanvas::print(unsigned int v) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u", v);
+    return print(buf);
+}
+
+size_t FbCanvas::print(long v) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", v);
+    return print(buf);
+}
+
+size_t FbCanvas::print(unsigned long v) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%lu", v);
+    return print(buf);
+}
+
+size_t FbCanvas::print(double v, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return print(buf);
+}
+
+// ============================================================
+// Inspection / PNG Export
+// ============================================================
+
+uint16_t FbCanvas::getPixel(int32_t x, int32_t y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return 0;
+    return m_pixels[(size_t)y * m_width + x];
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t len) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+    crc ^= 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void putBE32(std::vector<uint8_t> &out, uint32_t v) {
+    out.push_back(v >> 24); out.push_back(v >> 16); out.push_back(v >> 8); out.push_back(v);
+}
+
+static void writeChunk(FILE *f, const char *type, const std::vector<uint8_t> &data) {
+    std::vector<uint8_t> buf;
+    putBE32(buf, (uint32_t)data.size());
+    buf.insert(buf.end(), type, type + 4);
+    buf.insert(buf.end(), data.begin(), data.end());
+    uint32_t crc = crc32Update(0, buf.data() + 4, buf.size() - 4);
+    putBE32(buf, crc);
+    fwrite(buf.data(), 1, buf.size(), f);
+}
+
+bool FbCanvas::writePng(const char *path) const {
+    if (m_pixels.empty()) return false;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        Serial.printf("[FB] Cannot open %s for writing\n", path);
+        return false;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), f);
+
+    std::vector<uint8_t> ihdr;
+    putBE32(ihdr, m_width);
+    putBE32(ihdr, m_height);
+    ihdr.push_back(8);  // Bit depth
+    ihdr.push_back(2);  // Colour type: truecolour
+    ihdr.push_back(0);  // Compression
+    ihdr.push_back(0);  // Filter
+    ihdr.push_back(0);  // Interlace
+    writeChunk(f, "IHDR", ihdr);
+
+    // Raw scanlines (filter byte 0 + RGB888), panel inversion applied
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)m_height * (1 + m_width * 3));
+    for (int32_t y = 0; y < m_height; y++) {
+        raw.push_back(0);
+        for (int32_t x = 0; x < m_width; x++) {
+            uint16_t c = m_pixels[(size_t)y * m_width + x];
+            if (m_inverted) c = ~c;
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            raw.push_back((r << 3) | (r >> 2));
+            raw.push_back((g << 2) | (g >> 4));
+            raw.push_back((b << 3) | (b >> 2));
+        }
+    }
+
+    // zlib stream with stored (uncompressed) deflate blocks
+    std::vector<uint8_t> idat;
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    size_t pos = 0;
+    do {
+        size_t len = std::min<size_t>(65535, raw.size() - pos);
+        bool last = (pos + len == raw.size());
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(len & 0xFF);
+        idat.push_back(len >> 8);
+        idat.push_back(~len & 0xFF);
+        idat.push_back((~len >> 8) & 0xFF);
+        idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBE32(idat, (b << 16) | a);
+    writeChunk(f, "IDAT", idat);
+    writeChunk(f, "IEND", std::vector<uint8_t>());
+
+    bool ok = (ferror(f) == 0);
+    fclose(f);
+    return ok;
+}
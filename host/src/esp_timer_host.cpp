@@ -0,0 +1,145 @@
+/*
+ * SparkMiner - Host esp_timer
+ * Deadline-ordered dispatch on one thread (see esp_timer.h)
+ *
+ * GPL v3 License
+ */
+
+#include <esp_timer.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct host_esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    std::string name;
+    bool armed;
+    int64_t due;            // esp_timer_get_time() of the next run
+    uint64_t periodUs;      // 0 = one-shot
+    uint32_t calls;
+    uint32_t maxRunUs;
+};
+
+static std::mutex s_lock;
+static std::condition_variable s_changed;
+static std::vector<host_esp_timer *> s_timers;
+static bool s_started = false;
+
+static const auto s_epoch = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time(void) {
+    auto d = std::chrono::steady_clock::now() - s_epoch;
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+// ============================================================
+// Dispatch
+// ============================================================
+
+static void dispatchMain() {
+    std::unique_lock<std::mutex> lk(s_lock);
+    while (true) {
+        host_esp_timer *next = NULL;
+        for (host_esp_timer *t : s_timers) {
+            if (t->armed && (!next || t->due < next->due)) next = t;
+        }
+        if (!next) {
+            s_changed.wait(lk);
+            continue;
+        }
+        int64_t now = esp_timer_get_time();
+        if (next->due > now) {
+            s_changed.wait_for(lk, std::chrono::microseconds(next->due - now));
+            continue;
+        }
+
+        // Re-arm before the callback, so it may stop or restart its own timer
+        if (next->periodUs) next->due += next->periodUs;
+        else next->armed = false;
+
+        lk.unlock();
+        int64_t start = esp_timer_get_time();
+        next->callback(next->arg);
+        uint32_t ran = (uint32_t)(esp_timer_get_time() - start);
+        lk.lock();
+
+        next->calls++;
+        if (ran > next->maxRunUs) next->maxRunUs = ran;
+    }
+}
+
+// ============================================================
+// API
+// ============================================================
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out) {
+    if (!args || !args->callback || !out) return ESP_FAIL;
+
+    host_esp_timer *t = new host_esp_timer();
+    t->callback = args->callback;
+    t->arg = args->arg;
+    t->name = args->name ? args->name : "";
+
+    std::lock_guard<std::mutex> lg(s_lock);
+    s_timers.push_back(t);
+    if (!s_started) {
+        std::thread(dispatchMain).detach();
+        s_started = true;
+    }
+    *out = t;
+    return ESP_OK;
+}
+
+static esp_err_t start(esp_timer_handle_t timer, uint64_t us, bool periodic) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = true;
+    timer->due = esp_timer_get_time() + (int64_t)us;
+    timer->periodUs = periodic ? us : 0;
+    s_changed.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    return start(timer, timeoutUs, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    return start(timer, periodUs, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    if (!timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    s_changed.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    for (size_t i = 0; i < s_timers.size(); i++) {
+        if (s_timers[i] == timer) {
+            s_timers.erase(s_timers.begin() + i);
+            break;
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+bool esp_timer_host_stats(const char *name, uint32_t *calls, uint32_t *maxRunUs) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    for (host_esp_timer *t : s_timers) {
+        if (t->name != name) continue;
+        if (calls) *calls = t->calls;
+        if (maxRunUs) *maxRunUs = t->maxRunUs;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,52 @@
+/*
+ * SparkMiner - Host FastLED
+ * Frame recorder behind the FastLED shim (see FastLED.h)
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+HostFastLED FastLED;
+
+static std::mutex s_lock;
+static std::vector<fastled_frame_t> s_frames;
+
+void HostFastLED::clear(bool write) {
+    for (int i = 0; i < m_count; i++) m_leds[i] = CRGB();
+    if (write) show();
+}
+
+void HostFastLED::show() {
+    fastled_frame_t frame;
+    frame.ms = millis();
+    frame.color = m_count > 0 ? m_leds[0] : CRGB();
+
+    uint32_t hold = m_holdMs;
+    m_holdMs = 0;
+    if (hold) std::this_thread::sleep_for(std::chrono::milliseconds(hold));
+
+    std::lock_guard<std::mutex> lg(s_lock);
+    s_frames.push_back(frame);
+}
+
+size_t HostFastLED::frames(fastled_frame_t *out, size_t max) const {
+    std::lock_guard<std::mutex> lg(s_lock);
+    size_t n = s_frames.size() < max ? s_frames.size() : max;
+    for (size_t i = 0; i < n; i++) out[i] = s_frames[i];
+    return n;
+}
+
+size_t HostFastLED::frameCount() const {
+    std::lock_guard<std::mutex> lg(s_lock);
+    return s_frames.size();
+}
+
+void HostFastLED::resetFrames() {
+    std::lock_guard<std::mutex> lg(s_lock);
+    s_frames.clear();
+}
@@ -0,0 +1,764 @@
+/*
+ * SparkMiner - Fleet Aggregator (host)
+ * Collects telemetry frames from many miners and serves fleet rollups
+ *
+ * Ingest, all optional and usable together:
+ * - UDP: devices with telemetry_url udp://<this host>:PORT
+ * - MQTT: a built-in publish-only broker endpoint (devices point their
+ *   mqtt:// URL here) and/or a subscriber on an existing broker
+ * - HTTP scrape: GET each URL of a list file every interval; the body is
+ *   a binary or JSON telemetry frame
+ *
+ * Frames go into the fleet store (fleet_store.h). The HTTP server has a
+ * dashboard at /, JSON at /api/fleet, /api/devices and /api/series, and
+ * Prometheus text at /metrics. A summary line is printed every --report
+ * seconds; the store is saved every minute and on exit when --store is
+ * given. --capture records every received frame for fleet_load --replay.
+ *
+ * One thread, one poll() loop: a thousand devices at the default 60 s
+ * interval are ~17 frames/s.
+ *
+ * Usage: fleet_agg [--udp PORT] [--mqtt PORT] [--mqtt-sub HOST[:PORT][/TOPIC]]
+ *                  [--scrape FILE] [--scrape-interval S] [--http PORT]
+ *                  [--store FILE] [--capture FILE] [--outlier PCT]
+ *                  [--window S] [--report S] [--seconds S]
+ *
+ * GPL v3 License
+ */
+
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fleet_net.h"
+#include "fleet_store.h"
+
+#define AGG_UDP_DEFAULT         9100
+#define AGG_HTTP_DEFAULT        8080
+#define AGG_MQTT_KEEPALIVE_S    60
+#define AGG_SAVE_MS             60000
+#define AGG_SUB_RETRY_MS        10000
+#define AGG_CONN_TIMEOUT_MS     30000   // HTTP and scrape exchanges
+#define AGG_IDLE_TIMEOUT_MS     180000  // Device sessions: 1.5 x the firmware keepalive
+#define AGG_HTTP_REQUEST_MAX    8192
+#define AGG_REPORT_OUTLIERS     10      // Listed per report line
+
+typedef enum {
+    CONN_HTTP,                  // Dashboard/API client
+    CONN_MQTT,                  // Device publishing to us
+    CONN_MQTT_SUB,              // Our session on an external broker
+    CONN_SCRAPE                 // Our GET to a device or exporter
+} conn_kind_t;
+
+typedef struct {
+    int fd;
+    conn_kind_t kind;
+    std::string in;
+    std::string out;
+    uint64_t lastMs;            // Last activity
+    bool connecting;            // Outgoing, connect not yet complete
+    bool closing;               // Close once `out` is flushed
+    size_t target;              // CONN_SCRAPE: index into s_scrape
+} conn_t;
+
+typedef struct {
+    std::string host;
+    uint16_t port;
+    std::string path;
+    bool busy;
+} scrape_target_t;
+
+static uint16_t s_udpPort = AGG_UDP_DEFAULT;
+static uint16_t s_mqttPort = 0;
+static uint16_t s_httpPort = AGG_HTTP_DEFAULT;
+static const char *s_subTarget = NULL;
+static const char *s_scrapeFile = NULL;
+static uint32_t s_scrapeIntervalS = 60;
+static const char *s_storePath = NULL;
+static const char *s_capturePath = NULL;
+static float s_outlierPct = 20;
+static uint32_t s_windowS = 900;
+static uint32_t s_reportS = 60;
+static uint32_t s_seconds = 0;
+
+static std::vector<std::unique_ptr<conn_t>> s_conns;
+static std::vector<scrape_target_t> s_scrape;
+static std::string s_subHost, s_subTopic;
+static uint16_t s_subPort = 1883;
+static FILE *s_capture = NULL;
+static volatile sig_atomic_t s_stop = 0;
+
+static uint64_t nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint32_t unixNow() {
+    return (uint32_t)time(NULL);
+}
+
+static void appendf(std::string *out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void appendf(std::string *out, const char *fmt, ...) {
+    char buf[1024];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n > 0) out->append(buf, n < (int)sizeof(buf) ? n : (int)sizeof(buf) - 1);
+}
+
+static void appendMac(std::string *out, const uint8_t *mac) {
+    appendf(out, "%02x%02x%02x%02x%02x%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+static bool parseMac(const char *text, uint8_t *mac) {
+    if (strlen(text) < 12) return false;
+    for (int i = 0; i < 6; i++) {
+        char byte[3] = { text[i * 2], text[i * 2 + 1], 0 };
+        char *end;
+        mac[i] = (uint8_t)strtoul(byte, &end, 16);
+        if (*end) return false;
+    }
+    return true;
+}
+
+// Names from devices end up in JSON and HTML; keep to a safe set
+static void appendName(std::string *out, const char *name) {
+    for (; *name; name++) {
+        char c = *name;
+        bool safe = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                    c == '-' || c == '_' || c == '.' || c == ' ';
+        out->push_back(safe ? c : '_');
+    }
+}
+
+static const char *sourceName(uint8_t source) {
+    static const char *names[FLEET_SRC_COUNT] = { "udp", "mqtt", "http" };
+    return source < FLEET_SRC_COUNT ? names[source] : "?";
+}
+
+// ============================================================
+// Frames
+// ============================================================
+
+typedef struct __attribute__((packed)) {
+    uint32_t time;              // Unix seconds received
+    uint16_t len;
+    uint8_t source;
+} capture_record_t;
+
+static void ingestFrame(const uint8_t *buf, size_t len, uint8_t source) {
+    telemetry_header_t header;
+    telemetry_sample_t samples[TELEMETRY_BATCH_MAX];
+    int n = -1;
+
+    if (len >= 2 && buf[0] == 'S' && buf[1] == 'T') {
+        n = telemetry_frame_parse_bin(buf, len, &header, samples, TELEMETRY_BATCH_MAX);
+    } else if (len && buf[0] == '{' && len <= TELEMETRY_FRAME_MAX * 4) {
+        std::string json((const char *)buf, len);
+        n = telemetry_frame_parse_json(json.c_str(), &header, samples, TELEMETRY_BATCH_MAX);
+    }
+
+    uint32_t now = unixNow();
+    if (n <= 0) {
+        fleet_store_bad_frame();
+        return;
+    }
+    fleet_store_ingest(&header, samples, n, source, now);
+
+    if (s_capture && len <= UINT16_MAX) {
+        capture_record_t rec = { now, (uint16_t)len, source };
+        fwrite(&rec, sizeof(rec), 1, s_capture);
+        fwrite(buf, 1, len, s_capture);
+    }
+}
+
+static void readUdp(int fd) {
+    uint8_t buf[2048];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) return;
+        ingestFrame(buf, n, FLEET_SRC_UDP);
+    }
+}
+
+// ============================================================
+// MQTT
+// ============================================================
+
+// Packets from a device (we are the broker) or from the broker we
+// subscribe to (we are the client)
+static bool handleMqtt(conn_t *c) {
+    mqtt_packet_t pkt;
+    int used;
+    while ((used = mqtt_parse(c->in, &pkt)) > 0) {
+        switch (pkt.type) {
+            case MQTT_CONNECT: {
+                static const uint8_t accepted[2] = { 0, 0 };
+                mqtt_simple(&c->out, MQTT_CONNACK, accepted, 2);
+                break;
+            }
+            case MQTT_CONNACK:
+                if (pkt.len < 2 || pkt.body[1] != 0) {
+                    fprintf(stderr, "[FLEET] Broker refused the connection (code %d)\n",
+                            pkt.len >= 2 ? pkt.body[1] : -1);
+                    return false;
+                }
+                mqtt_subscribe(&c->out, 1, s_subTopic + "/#");
+                printf("[FLEET] Subscribed to %s/# on %s:%u\n", s_subTopic.c_str(),
+                       s_subHost.c_str(), s_subPort);
+                break;
+            case MQTT_PUBLISH: {
+                if (pkt.len < 2) return false;
+                uint8_t qos = (pkt.flags >> 1) & 3;
+                size_t pos = 2 + ((pkt.body[0] << 8) | pkt.body[1]);
+                if (qos > 1 || pos + (qos ? 2 : 0) > pkt.len) return false;
+                if (qos) {
+                    mqtt_simple(&c->out, MQTT_PUBACK, pkt.body + pos, 2);
+                    pos += 2;
+                }
+                ingestFrame(pkt.body + pos, pkt.len - pos, FLEET_SRC_MQTT);
+                break;
+            }
+            case MQTT_SUBSCRIBE: {
+                // Grant QoS 0 to every filter; nothing is ever forwarded
+                if (pkt.len < 2) return false;
+                std::string ack((const char *)pkt.body, 2);
+                for (size_t pos = 2; pos + 2 <= pkt.len;) {
+                    pos += 2 + ((pkt.body[pos] << 8) | pkt.body[pos + 1]) + 1;
+                    ack.push_back(0);
+                }
+                mqtt_simple(&c->out, MQTT_SUBACK, (const uint8_t *)ack.data(), ack.size());
+                break;
+            }
+            case MQTT_PINGREQ:
+                mqtt_simple(&c->out, MQTT_PINGRESP, NULL, 0);
+                break;
+            case MQTT_DISCONNECT:
+                c->closing = true;
+                break;
+            default:
+                break;                  // SUBACK, PINGRESP, PUBACK
+        }
+        c->in.erase(0, used);
+    }
+    return used == 0;
+}
+
+static void startSubscriber() {
+    int fd = fleet_connect(s_subHost.c_str(), s_subPort);
+    if (fd < 0) return;
+
+    conn_t *c = new conn_t();
+    c->fd = fd;
+    c->kind = CONN_MQTT_SUB;
+    c->connecting = true;
+    c->lastMs = nowMs();
+
+    char clientId[32];
+    snprintf(clientId, sizeof(clientId), "fleet-agg-%d", (int)getpid());
+    mqtt_connect(&c->out, clientId, NULL, NULL, AGG_MQTT_KEEPALIVE_S);
+    s_conns.emplace_back(c);
+}
+
+static bool subscriberActive() {
+    for (auto &c : s_conns) {
+        if (c->kind == CONN_MQTT_SUB) return true;
+    }
+    return false;
+}
+
+// ============================================================
+// HTTP scrape
+// ============================================================
+
+static bool loadScrapeList(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[FLEET] Cannot open %s\n", path);
+        return false;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!line[0] || line[0] == '#') continue;
+        scrape_target_t t;
+        if (!fleet_parse_target(line, &t.host, &t.port, &t.path, 80)) {
+            fprintf(stderr, "[FLEET] Bad scrape URL: %s\n", line);
+            continue;
+        }
+        t.busy = false;
+        s_scrape.push_back(t);
+    }
+    fclose(f);
+    printf("[FLEET] Scraping %zu URLs every %u s\n", s_scrape.size(), s_scrapeIntervalS);
+    return true;
+}
+
+static void startScrapes() {
+    for (size_t i = 0; i < s_scrape.size(); i++) {
+        scrape_target_t *t = &s_scrape[i];
+        if (t->busy) continue;
+        int fd = fleet_connect(t->host.c_str(), t->port);
+        if (fd < 0) continue;
+
+        conn_t *c = new conn_t();
+        c->fd = fd;
+        c->kind = CONN_SCRAPE;
+        c->connecting = true;
+        c->lastMs = nowMs();
+        c->target = i;
+        appendf(&c->out, "GET %s HTTP/1.0\r\nHost: %s\r\n\r\n", t->path.c_str(), t->host.c_str());
+        t->busy = true;
+        s_conns.emplace_back(c);
+    }
+}
+
+// Whole response is in: HTTP/1.0 with the peer closing
+static void finishScrape(conn_t *c) {
+    s_scrape[c->target].busy = false;
+    size_t body = c->in.find("\r\n\r\n");
+    if (body == std::string::npos || c->in.compare(0, 5, "HTTP/") != 0) {
+        fleet_store_bad_frame();
+        return;
+    }
+    if (c->in.compare(9, 3, "200") != 0) return;
+    ingestFrame((const uint8_t *)c->in.data() + body + 4, c->in.size() - body - 4, FLEET_SRC_HTTP);
+}
+
+// ============================================================
+// HTTP API and dashboard
+// ============================================================
+
+static const char DASHBOARD_HTML[] = R"HTML(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><title>SparkMiner Fleet</title>
+<style>
+body{font:14px sans-serif;background:#111;color:#ddd;margin:20px}
+.cards{display:flex;gap:12px;flex-wrap:wrap}.card{background:#222;padding:10px 16px;border-radius:6px}
+.card b{display:block;font-size:20px;color:#fb0}table{border-collapse:collapse;margin-top:16px;width:100%}
+td,th{padding:3px 8px;text-align:right;border-bottom:1px solid #333}td:nth-child(-n+3),th:nth-child(-n+3){text-align:left}
+tr.out{background:#411}tr.off{color:#666}svg{background:#1a1a1a;margin-top:16px}
+</style></head><body>
+<h2>SparkMiner Fleet</h2><div class="cards" id="cards"></div>
+<svg id="chart" width="900" height="140"></svg>
+<table><thead><tr><th>Worker</th><th>Board</th><th>MAC</th><th>Hashrate</th><th>15 min</th>
+<th>Board median</th><th>Shares</th><th>Reject</th><th>Latency</th><th>Temp</th><th>Heap</th><th>Seen</th></tr></thead>
+<tbody id="rows"></tbody></table>
+<script>
+const H=h=>h>=1e9?(h/1e9).toFixed(2)+' GH/s':h>=1e6?(h/1e6).toFixed(2)+' MH/s':(h/1e3).toFixed(1)+' KH/s';
+const P=x=>(x*100).toFixed(2)+'%';
+async function load(){
+ const f=await (await fetch('/api/fleet')).json();
+ const c=[['Hashrate',H(f.hashrate)],['Devices',f.online+' / '+f.devices],['Outliers',f.outliers],
+  ['Reject',P(f.reject_rate)],['Stale',P(f.stale_rate)],['Latency p50/p90/p99',f.latency.join(' / ')+' ms']];
+ document.getElementById('cards').innerHTML=c.map(x=>`<div class="card">${x[0]}<b>${x[1]}</b></div>`).join('');
+ const s=(await (await fetch('/api/series')).json()).points;
+ const max=Math.max(1,...s.map(p=>p.hr)),w=900/Math.max(1,s.length);
+ document.getElementById('chart').innerHTML=s.map((p,i)=>
+  `<rect x="${i*w}" y="${140-p.hr/max*130}" width="${Math.max(1,w-1)}" height="${p.hr/max*130}" fill="#fb0"/>`).join('');
+ const d=await (await fetch('/api/devices')).json(),now=Date.now()/1000;
+ document.getElementById('rows').innerHTML=d.map(x=>`<tr class="${x.outlier?'out':x.online?'':'off'}">
+  <td>${x.worker}</td><td>${x.board}</td><td>${x.mac}</td><td>${H(x.hashrate)}</td><td>${H(x.hashrate_15m)}</td>
+  <td>${x.board_median?H(x.board_median):'-'}</td><td>${x.accepted}/${x.rejected}</td>
+  <td>${P(x.rejected/Math.max(1,x.accepted+x.rejected))}</td><td>${x.latency} ms</td><td>${x.temp}&deg;C</td>
+  <td>${(x.heap/1024).toFixed(0)}K</td><td>${Math.round(now-x.last_seen)} s</td></tr>`).join('');
+}
+load();setInterval(load,10000);
+</script></body></html>
+)HTML";
+
+// Value of `key` in the query string, or def
+static std::string queryParam(const std::string &query, const char *key, const char *def) {
+    std::string k = std::string(key) + "=";
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos) end = query.size();
+        if (query.compare(pos, k.size(), k) == 0) return query.substr(pos + k.size(), end - pos - k.size());
+        pos = end + 1;
+    }
+    return def;
+}
+
+static void apiFleet(std::string *body, uint32_t window) {
+    fleet_summary_t sum;
+    fleet_store_summary(unixNow(), window, &sum);
+    appendf(body, "{\"time\":%u,\"window\":%u,\"devices\":%u,\"online\":%u,\"outliers\":%u,"
+            "\"hashrate\":%.1f,\"hashrate_mean\":%.1f,\"accepted\":%u,\"rejected\":%u,\"stale\":%u,"
+            "\"reject_rate\":%.5f,\"stale_rate\":%.5f,\"latency\":[%u,%u,%u],"
+            "\"frames\":{\"udp\":%u,\"mqtt\":%u,\"http\":%u,\"bad\":%u},\"boards\":[",
+            sum.now, sum.window, sum.devices, sum.online, sum.outliers, sum.hashRate,
+            sum.hashRateMean, sum.accepted, sum.rejected, sum.stale, sum.rejectRate, sum.staleRate,
+            sum.latencyP50, sum.latencyP90, sum.latencyP99, sum.frames[FLEET_SRC_UDP],
+            sum.frames[FLEET_SRC_MQTT], sum.frames[FLEET_SRC_HTTP], sum.badFrames);
+
+    // Per-board rollup from the device list (sorted by board)
+    std::vector<fleet_device_t> devices;
+    fleet_store_devices(&devices);
+    for (size_t i = 0; i < devices.size();) {
+        size_t j = i;
+        uint32_t online = 0, outliers = 0;
+        float hashRate = 0, boardMedian = 0;
+        for (; j < devices.size() && !strcmp(devices[j].board, devices[i].board); j++) {
+            if (!devices[j].online) continue;
+            online++;
+            hashRate += devices[j].hashRate;
+            if (devices[j].outlier) outliers++;
+            if (devices[j].boardMedian > 0) boardMedian = devices[j].boardMedian;
+        }
+        body->append(i ? ",{\"board\":\"" : "{\"board\":\"");
+        appendName(body, devices[i].board);
+        appendf(body, "\",\"devices\":%zu,\"online\":%u,\"outliers\":%u,\"hashrate\":%.1f,\"median\":%.1f}",
+                j - i, online, outliers, hashRate, boardMedian);
+        i = j;
+    }
+    body->append("]}");
+}
+
+static void apiDevices(std::string *body, bool outliersOnly) {
+    std::vector<fleet_device_t> devices;
+    fleet_store_devices(&devices);
+    body->push_back('[');
+    bool first = true;
+    for (const fleet_device_t &d : devices) {
+        if (outliersOnly && !d.outlier) continue;
+        body->append(first ? "{\"mac\":\"" : ",{\"mac\":\"");
+        first = false;
+        appendMac(body, d.mac);
+        body->append("\",\"board\":\"");
+        appendName(body, d.board);
+        body->append("\",\"worker\":\"");
+        appendName(body, d.worker);
+        appendf(body, "\",\"source\":\"%s\",\"online\":%s,\"outlier\":%s,\"last_seen\":%u,\"uptime\":%u,"
+                "\"hashrate\":%.1f,\"hashrate_15m\":%.1f,\"board_median\":%.1f,\"accepted\":%u,"
+                "\"rejected\":%u,\"stale\":%u,\"latency\":%u,\"temp\":%d,\"pool\":%u,\"heap\":%u,"
+                "\"heap_largest\":%u,\"frames\":%u,\"dropped\":%u,\"reboots\":%u}",
+                sourceName(d.source), d.online ? "true" : "false", d.outlier ? "true" : "false",
+                d.lastSeen, d.uptime, d.hashRate, d.hashRate15m, d.boardMedian, d.accepted,
+                d.rejected, d.stale, d.latencyAvg, d.tempC, d.poolConnected, d.heapFree,
+                d.heapLargest, d.frames, d.dropped, d.reboots);
+    }
+    body->push_back(']');
+}
+
+static bool apiSeries(std::string *body, const std::string &query) {
+    std::string mac = queryParam(query, "mac", "");
+    bool rollup = queryParam(query, "tier", "raw") == "5m";
+    uint32_t since = unixNow() - (uint32_t)atoi(queryParam(query, "window", rollup ? "86400" : "3600").c_str());
+
+    uint8_t macBytes[6];
+    if (!mac.empty() && !parseMac(mac.c_str(), macBytes)) return false;
+    std::vector<fleet_point_t> points;
+    if (!fleet_store_series(mac.empty() ? NULL : macBytes, rollup, since, &points)) return false;
+
+    body->append("{\"points\":[");
+    for (size_t i = 0; i < points.size(); i++) {
+        const fleet_point_t &p = points[i];
+        appendf(body, "%s{\"t\":%u,\"hr\":%.1f,\"n\":%u,\"sh\":[%u,%u,%u],\"p90\":%u,\"temp\":%d,\"heap\":%u}",
+                i ? "," : "", p.time, p.hashRate, p.devices, p.accepted, p.rejected, p.stale,
+                fleet_latency_percentile(p.latencyHist, 0.9f), p.tempC, p.heapFree);
+    }
+    body->append("]}");
+    return true;
+}
+
+static void apiMetrics(std::string *body) {
+    fleet_summary_t sum;
+    fleet_store_summary(unixNow(), s_windowS, &sum);
+    appendf(body, "sparkminer_fleet_devices %u\nsparkminer_fleet_online %u\nsparkminer_fleet_outliers %u\n"
+            "sparkminer_fleet_hashrate %.1f\nsparkminer_fleet_reject_ratio %.5f\n"
+            "sparkminer_fleet_stale_ratio %.5f\n",
+            sum.devices, sum.online, sum.outliers, sum.hashRate, sum.rejectRate, sum.staleRate);
+    appendf(body, "sparkminer_fleet_latency_ms{quantile=\"0.5\"} %u\n"
+            "sparkminer_fleet_latency_ms{quantile=\"0.9\"} %u\n"
+            "sparkminer_fleet_latency_ms{quantile=\"0.99\"} %u\n",
+            sum.latencyP50, sum.latencyP90, sum.latencyP99);
+
+    std::vector<fleet_device_t> devices;
+    fleet_store_devices(&devices);
+    for (const fleet_device_t &d : devices) {
+        std::string labels = "{mac=\"";
+        appendMac(&labels, d.mac);
+        labels.append("\",board=\"");
+        appendName(&labels, d.board);
+        labels.append("\",worker=\"");
+        appendName(&labels, d.worker);
+        labels.append("\"}");
+        appendf(body, "sparkminer_hashrate%s %.1f\nsparkminer_shares_accepted%s %u\n"
+                "sparkminer_shares_rejected%s %u\nsparkminer_online%s %d\nsparkminer_outlier%s %d\n",
+                labels.c_str(), d.hashRate, labels.c_str(), d.accepted, labels.c_str(), d.rejected,
+                labels.c_str(), d.online ? 1 : 0, labels.c_str(), d.outlier ? 1 : 0);
+    }
+}
+
+static void respond(conn_t *c, int status, const char *type, const std::string &body) {
+    const char *reason = status == 200 ? "OK" : status == 404 ? "Not Found" : "Bad Request";
+    appendf(&c->out, "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+            "Cache-Control: no-store\r\nConnection: close\r\n\r\n", status, reason, type, body.size());
+    c->out.append(body);
+    c->closing = true;
+}
+
+static void handleHttp(conn_t *c) {
+    if (c->closing || c->in.find("\r\n\r\n") == std::string::npos) {
+        if (c->in.size() > AGG_HTTP_REQUEST_MAX) respond(c, 400, "text/plain", "request too large\n");
+        return;
+    }
+    if (c->in.compare(0, 4, "GET ") != 0) {
+        respond(c, 400, "text/plain", "GET only\n");
+        return;
+    }
+    std::string target = c->in.substr(4, c->in.find(' ', 4) - 4);
+    size_t q = target.find('?');
+    std::string path = target.substr(0, q);
+    std::string query = q == std::string::npos ? "" : target.substr(q + 1);
+
+    std::string body;
+    if (path == "/") {
+        respond(c, 200, "text/html; charset=utf-8", DASHBOARD_HTML);
+    } else if (path == "/api/fleet") {
+        apiFleet(&body, (uint32_t)atoi(queryParam(query, "window", std::to_string(s_windowS).c_str()).c_str()));
+        respond(c, 200, "application/json", body);
+    } else if (path == "/api/devices") {
+        apiDevices(&body, queryParam(query, "outliers", "0") == "1");
+        respond(c, 200, "application/json", body);
+    } else if (path == "/api/series") {
+        if (apiSeries(&body, query)) respond(c, 200, "application/json", body);
+        else respond(c, 404, "text/plain", "unknown device\n");
+    } else if (path == "/metrics") {
+        apiMetrics(&body);
+        respond(c, 200, "text/plain; version=0.0.4", body);
+    } else {
+        respond(c, 404, "text/plain", "not found\n");
+    }
+}
+
+// ============================================================
+// Event loop
+// ============================================================
+
+static void acceptAll(int listenFd, conn_kind_t kind) {
+    for (;;) {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        conn_t *c = new conn_t();
+        c->fd = fd;
+        c->kind = kind;
+        c->lastMs = nowMs();
+        s_conns.emplace_back(c);
+    }
+}
+
+// Service one connection after poll(); false = close it
+static bool service(conn_t *c, short revents, uint64_t now) {
+    if (c->connecting) {
+        if (!(revents & (POLLOUT | POLLERR | POLLHUP))) return true;
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err) return false;
+        c->connecting = false;
+    }
+
+    bool open = true;
+    if (revents & (POLLIN | POLLHUP | POLLERR)) {
+        open = fleet_fill(c->fd, &c->in);
+        c->lastMs = now;
+        switch (c->kind) {
+            case CONN_HTTP:
+                handleHttp(c);
+                break;
+            case CONN_MQTT:
+            case CONN_MQTT_SUB:
+                if (!handleMqtt(c)) return false;
+                break;
+            case CONN_SCRAPE:
+                if (!open) finishScrape(c);
+                break;
+        }
+    }
+    if (!fleet_flush(c->fd, &c->out)) return false;
+    if (c->closing && c->out.empty()) return false;
+
+    uint64_t timeout = c->kind == CONN_MQTT ? AGG_IDLE_TIMEOUT_MS :
+                       c->kind == CONN_MQTT_SUB ? UINT64_MAX : AGG_CONN_TIMEOUT_MS;
+    if (now - c->lastMs > timeout) return false;
+    return open;
+}
+
+static void closeConn(conn_t *c) {
+    if (c->kind == CONN_SCRAPE) s_scrape[c->target].busy = false;
+    if (c->kind == CONN_MQTT_SUB) printf("[FLEET] Broker connection closed\n");
+    close(c->fd);
+}
+
+static void printReport() {
+    fleet_summary_t sum;
+    fleet_store_summary(unixNow(), s_windowS, &sum);
+    printf("[FLEET] %u devices (%u online, %u outliers)  %.2f MH/s  reject %.2f%%  stale %.2f%%  "
+           "latency p50/p90/p99 %u/%u/%u ms  frames udp/mqtt/http %u/%u/%u (%u bad)\n",
+           sum.devices, sum.online, sum.outliers, sum.hashRate / 1e6, sum.rejectRate * 100,
+           sum.staleRate * 100, sum.latencyP50, sum.latencyP90, sum.latencyP99,
+           sum.frames[FLEET_SRC_UDP], sum.frames[FLEET_SRC_MQTT], sum.frames[FLEET_SRC_HTTP],
+           sum.badFrames);
+
+    std::vector<fleet_device_t> devices;
+    fleet_store_devices(&devices);
+    uint32_t shown = 0;
+    for (const fleet_device_t &d : devices) {
+        if (!d.outlier || ++shown > AGG_REPORT_OUTLIERS) continue;
+        printf("[FLEET]   outlier %-16s %-16s %.1f KH/s (board median %.1f KH/s, %.0f%% below)\n",
+               d.worker, d.board, (d.hashRate15m > 0 ? d.hashRate15m : d.hashRate) / 1e3,
+               d.boardMedian / 1e3,
+               100.0 * (1.0 - (d.hashRate15m > 0 ? d.hashRate15m : d.hashRate) / d.boardMedian));
+    }
+    if (shown > AGG_REPORT_OUTLIERS) printf("[FLEET]   ... %u more, see /api/devices?outliers=1\n", shown - AGG_REPORT_OUTLIERS);
+    fflush(stdout);
+}
+
+static void onSignal(int) {
+    s_stop = 1;
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s [--udp PORT] [--mqtt PORT] [--mqtt-sub HOST[:PORT][/TOPIC]]\n"
+            "          [--scrape FILE] [--scrape-interval S] [--http PORT]\n"
+            "          [--store FILE] [--capture FILE] [--outlier PCT]\n"
+            "          [--window S] [--report S] [--seconds S]\n"
+            "Ports default to udp %d, http %d, mqtt off; 0 turns a listener off.\n",
+            argv0, AGG_UDP_DEFAULT, AGG_HTTP_DEFAULT);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!val) return usage(argv[0]);
+        if (!strcmp(arg, "--udp")) s_udpPort = (uint16_t)atoi(val);
+        else if (!strcmp(arg, "--mqtt")) s_mqttPort = (uint16_t)atoi(val);
+        else if (!strcmp(arg, "--http")) s_httpPort = (uint16_t)atoi(val);
+        else if (!strcmp(arg, "--mqtt-sub")) s_subTarget = val;
+        else if (!strcmp(arg, "--scrape")) s_scrapeFile = val;
+        else if (!strcmp(arg, "--scrape-interval")) s_scrapeIntervalS = (uint32_t)atoi(val);
+        else if (!strcmp(arg, "--store")) s_storePath = val;
+        else if (!strcmp(arg, "--capture")) s_capturePath = val;
+        else if (!strcmp(arg, "--outlier")) s_outlierPct = (float)atof(val);
+        else if (!strcmp(arg, "--window")) s_windowS = (uint32_t)atoi(val);
+        else if (!strcmp(arg, "--report")) s_reportS = (uint32_t)atoi(val);
+        else if (!strcmp(arg, "--seconds")) s_seconds = (uint32_t)atoi(val);
+        else return usage(argv[0]);
+        i++;
+    }
+    if (s_scrapeIntervalS == 0 || s_windowS == 0 || s_outlierPct <= 0 || s_outlierPct >= 100) {
+        return usage(argv[0]);
+    }
+
+    fleet_raise_fd_limit();
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    fleet_store_init(s_outlierPct / 100.0f);
+    if (s_storePath && fleet_store_load(s_storePath)) {
+        printf("[FLEET] Restored %s\n", s_storePath);
+    }
+    if (s_capturePath && !(s_capture = fopen(s_capturePath, "ab"))) {
+        fprintf(stderr, "[FLEET] Cannot open %s\n", s_capturePath);
+        return 1;
+    }
+    if (s_scrapeFile && !loadScrapeList(s_scrapeFile)) return 1;
+    if (s_subTarget && !fleet_parse_target(s_subTarget, &s_subHost, &s_subPort, &s_subTopic, 1883)) {
+        return usage(argv[0]);
+    }
+    s_subTopic = s_subTopic.size() > 1 ? s_subTopic.substr(1) : "sparkminer";
+
+    int udpFd = s_udpPort ? fleet_bind_udp(s_udpPort) : -1;
+    int mqttFd = s_mqttPort ? fleet_listen_tcp(s_mqttPort) : -1;
+    int httpFd = s_httpPort ? fleet_listen_tcp(s_httpPort) : -1;
+    if ((s_udpPort && udpFd < 0) || (s_mqttPort && mqttFd < 0) || (s_httpPort && httpFd < 0)) return 1;
+    printf("[FLEET] Listening: udp %u, mqtt %u, http %u (0 = off)\n", s_udpPort, s_mqttPort, s_httpPort);
+
+    uint64_t start = nowMs();
+    uint64_t nextReport = start + s_reportS * 1000ULL;
+    uint64_t nextSave = start + AGG_SAVE_MS;
+    uint64_t nextScrape = start;
+    uint64_t nextSub = start;
+    std::vector<struct pollfd> fds;
+
+    while (!s_stop) {
+        uint64_t now = nowMs();
+        if (s_seconds && now - start >= s_seconds * 1000ULL) break;
+
+        if (!s_scrape.empty() && now >= nextScrape) {
+            startScrapes();
+            nextScrape = now + s_scrapeIntervalS * 1000ULL;
+        }
+        if (s_subTarget && now >= nextSub) {
+            if (!subscriberActive()) startSubscriber();
+            nextSub = now + AGG_SUB_RETRY_MS;
+        }
+        for (auto &c : s_conns) {
+            // Keep our broker session alive
+            if (c->kind == CONN_MQTT_SUB && !c->connecting && now - c->lastMs > AGG_MQTT_KEEPALIVE_S * 500ULL) {
+                mqtt_simple(&c->out, MQTT_PINGREQ, NULL, 0);
+                c->lastMs = now;
+            }
+        }
+
+        fds.clear();
+        int listeners[3] = { udpFd, mqttFd, httpFd };
+        for (int fd : listeners) fds.push_back({ fd, POLLIN, 0 });
+        for (auto &c : s_conns) {
+            short events = c->connecting || !c->out.empty() ? POLLOUT : 0;
+            if (!c->connecting) events |= POLLIN;
+            fds.push_back({ c->fd, events, 0 });
+        }
+        poll(fds.data(), fds.size(), 200);
+
+        now = nowMs();
+        if (fds[0].revents & POLLIN) readUdp(udpFd);
+        if (fds[1].revents & POLLIN) acceptAll(mqttFd, CONN_MQTT);
+
+        // Services the existing connections (new ones join next round)
+        size_t polled = fds.size() - 3;
+        for (size_t i = 0, k = 0; k < polled; k++) {
+            conn_t *c = s_conns[i].get();
+            if (service(c, fds[k + 3].revents, now)) {
+                i++;
+                continue;
+            }
+            closeConn(c);
+            s_conns.erase(s_conns.begin() + i);
+        }
+        if (fds[2].revents & POLLIN) acceptAll(httpFd, CONN_HTTP);
+
+        fleet_store_tick(unixNow());
+
+        if (s_reportS && now >= nextReport) {
+            printReport();
+            nextReport = now + s_reportS * 1000ULL;
+        }
+        if (now >= nextSave) {
+            if (s_storePath && !fleet_store_save(s_storePath)) {
+                fprintf(stderr, "[FLEET] Cannot save %s\n", s_storePath);
+            }
+            if (s_capture) fflush(s_capture);
+            nextSave = now + AGG_SAVE_MS;
+        }
+    }
+
+    printReport();
+    if (s_storePath && !fleet_store_save(s_storePath)) fprintf(stderr, "[FLEET] Cannot save %s\n", s_storePath);
+    if (s_capture) fclose(s_capture);
+    return 0;
+}
@@ -0,0 +1,588 @@
+/*
+ * SparkMiner - Fleet Load Generator (host)
+ * Simulates many miners publishing telemetry, for testing fleet_agg
+ *
+ * Each simulated device samples every 10 s of device time and sends its
+ * queue every --interval seconds, in the firmware's frame format
+ * (stats/telemetry_frame.h), with send phases spread over the interval.
+ * Devices get a board from a mix of the supported chips and a hashrate
+ * near that board's nominal rate; --slow percent of them run 30% slow so
+ * the aggregator's outlier detection has something to find. Shares are
+ * drawn per sample from the hashrate and --diff, with rejects, stale
+ * shares and a log-normal response latency per device.
+ *
+ * --replay plays a fleet_agg --capture file instead: the first device in
+ * it becomes the template every simulated device repeats (with its own
+ * MAC, worker name and hashrate factor), looping with counters carried on.
+ *
+ * Transports: --udp HOST[:PORT], --mqtt HOST[:PORT][/TOPIC] (one session
+ * per device), or --serve PORT, which answers GET /device/<n> with the
+ * device's latest samples and writes the URL list for fleet_agg --scrape.
+ * --speed runs device time faster than the wall clock.
+ *
+ * Usage: fleet_load --devices N (--udp T | --mqtt T | --serve PORT --list FILE)
+ *                   [--interval S] [--speed X] [--seconds S] [--slow PCT]
+ *                   [--diff D] [--json] [--replay CAPTURE] [--seed N]
+ *
+ * GPL v3 License
+ */
+
+#include <math.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "fleet_net.h"
+#include "stats/telemetry_frame.h"
+
+#define LOAD_SAMPLE_S           10      // Firmware STATS_UPDATE_MS
+#define LOAD_QUEUE_MAX          32      // Firmware telemetry queue
+#define LOAD_REJECT_P           0.01    // Share reject probability
+#define LOAD_STALE_OF_REJECT    0.4     // Share of rejects that are stale
+#define LOAD_SLOW_FACTOR        0.7f
+
+typedef struct {
+    const char *name;
+    float hashRate;             // Nominal H/s (README table)
+    float weight;
+} board_mix_t;
+
+static const board_mix_t BOARDS[] = {
+    { "ESP32-2432S028", 720e3f, 0.40f },
+    { "ESP32-Headless", 750e3f, 0.25f },
+    { "ESP32-S3-CYD",   300e3f, 0.20f },
+    { "ESP32-C3-OLED",  250e3f, 0.15f },
+};
+
+typedef struct {
+    telemetry_header_t header;
+    float rate;                 // This unit's steady H/s
+    bool slow;
+    uint32_t bootOffset;        // Uptime at the start of the run
+    float latencyMs;            // Median share response time
+    float hashRate1m, hashRate15m;
+    uint32_t accepted, rejected, stale;
+    uint32_t latencyHist[LATENCY_HIST_BUCKETS];
+    std::vector<telemetry_sample_t> queue;
+    double nextSample;          // Device time, seconds from start
+    double nextSend;
+    size_t replayPos;
+    uint32_t replayLoop;
+    // MQTT session
+    int fd;
+    bool connecting;
+    std::string in, out;
+    std::string topic;
+} sim_device_t;
+
+typedef enum { MODE_NONE, MODE_UDP, MODE_MQTT, MODE_SERVE } load_mode_t;
+
+static int s_deviceCount = 0;
+static load_mode_t s_mode = MODE_NONE;
+static const char *s_target = NULL;
+static uint16_t s_servePort = 0;
+static const char *s_listPath = NULL;
+static uint32_t s_intervalS = 60;
+static double s_speed = 1.0;
+static uint32_t s_seconds = 0;
+static float s_slowPct = 2;
+static double s_diff = 0.001;
+static bool s_json = false;
+static const char *s_replayPath = NULL;
+static uint64_t s_rng = 0x5eed5eedULL;
+
+static std::vector<sim_device_t> s_devices;
+static std::vector<telemetry_sample_t> s_template;
+static std::string s_templateBoard;
+static uint32_t s_framesSent = 0, s_samplesSent = 0, s_sendErrors = 0, s_served = 0;
+static volatile sig_atomic_t s_stop = 0;
+
+static uint64_t nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// xorshift64*: reproducible runs for a given --seed
+static double randUnit() {
+    s_rng ^= s_rng >> 12;
+    s_rng ^= s_rng << 25;
+    s_rng ^= s_rng >> 27;
+    return (double)((s_rng * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+static double randNormal() {
+    double u = randUnit(), v = randUnit();
+    return sqrt(-2.0 * log(u > 0 ? u : 1e-12)) * cos(2 * M_PI * v);
+}
+
+static uint32_t randPoisson(double lambda) {
+    double limit = exp(-lambda), p = 1;
+    uint32_t k = 0;
+    while ((p *= randUnit()) > limit) k++;
+    return k;
+}
+
+// Same bucketing as the stratum client
+static int latencyBucket(uint32_t ms) {
+    int bucket = 0;
+    while (bucket < LATENCY_HIST_BUCKETS - 1 && ms >= ((uint32_t)LATENCY_HIST_BASE_MS << bucket)) bucket++;
+    return bucket;
+}
+
+static void copyPadded(char *dst, size_t size, const char *src) {
+    memset(dst, 0, size);
+    memcpy(dst, src, strnlen(src, size));
+}
+
+// ============================================================
+// Devices
+// ============================================================
+
+static void initDevice(sim_device_t *d, int index) {
+    memset(&d->header, 0, sizeof(d->header));
+    uint8_t mac[6] = { 0x02, 0x4c, 0x00, (uint8_t)(index >> 16), (uint8_t)(index >> 8), (uint8_t)index };
+    memcpy(d->header.mac, mac, 6);
+
+    char worker[16];
+    snprintf(worker, sizeof(worker), "load-%04d", index);
+    copyPadded(d->header.worker, sizeof(d->header.worker), worker);
+
+    const board_mix_t *board = &BOARDS[0];
+    double pick = randUnit(), acc = 0;
+    for (const board_mix_t &b : BOARDS) {
+        acc += b.weight;
+        board = &b;
+        if (pick < acc) break;
+    }
+    copyPadded(d->header.board, sizeof(d->header.board),
+               s_replayPath ? s_templateBoard.c_str() : board->name);
+
+    d->slow = randUnit() * 100 < s_slowPct;
+    d->rate = (float)((s_replayPath ? 1.0 : board->hashRate) * (1 + 0.02 * randNormal()) *
+                      (d->slow ? LOAD_SLOW_FACTOR : 1.0f));
+    d->bootOffset = (uint32_t)(randUnit() * 3600);
+    d->latencyMs = (float)(60 + 60 * randUnit());
+    if (randUnit() < 0.05) d->latencyMs *= 5;     // A few on a poor link
+    d->hashRate1m = d->hashRate15m = d->rate;
+    d->accepted = d->rejected = d->stale = 0;
+    memset(d->latencyHist, 0, sizeof(d->latencyHist));
+
+    // Spread sampling and sending over their periods
+    d->nextSample = randUnit() * LOAD_SAMPLE_S;
+    d->nextSend = randUnit() * s_intervalS;
+    d->replayPos = (size_t)(randUnit() * s_template.size());
+    d->replayLoop = 0;
+    d->fd = -1;
+    d->connecting = false;
+}
+
+static void syntheticSample(sim_device_t *d, telemetry_sample_t *s) {
+    float hashRate = d->rate * (float)(1 + 0.01 * randNormal());
+    d->hashRate1m += (hashRate - d->hashRate1m) * 10.0f / 60.0f;
+    d->hashRate15m += (hashRate - d->hashRate15m) * 10.0f / 900.0f;
+
+    uint32_t shares = randPoisson(hashRate * LOAD_SAMPLE_S / (s_diff * 4294967296.0));
+    for (uint32_t i = 0; i < shares; i++) {
+        uint32_t ms = (uint32_t)(d->latencyMs * exp(0.35 * randNormal()));
+        d->latencyHist[latencyBucket(ms)]++;
+        if (randUnit() >= LOAD_REJECT_P) {
+            d->accepted++;
+            continue;
+        }
+        d->rejected++;
+        if (randUnit() < LOAD_STALE_OF_REJECT) d->stale++;
+    }
+
+    s->hashRate = hashRate;
+    s->hashRate1m = d->hashRate1m;
+    s->hashRate15m = d->hashRate15m;
+    s->accepted = d->accepted;
+    s->rejected = d->rejected;
+    s->stale = d->stale;
+    memcpy(s->latencyHist, d->latencyHist, sizeof(s->latencyHist));
+    s->latencyAvg = (uint16_t)d->latencyMs;
+    s->tempC = (int8_t)(48 + 4 * randNormal());
+    s->poolConnected = 1;
+    s->heapFree = 150000 + (uint32_t)(randUnit() * 20000);
+    s->heapMin = 120000;
+    s->heapLargest = 90000;
+}
+
+// Next template sample, with counters carried over from earlier loops
+static void replaySample(sim_device_t *d, telemetry_sample_t *s) {
+    const telemetry_sample_t *first = &s_template.front();
+    const telemetry_sample_t *last = &s_template.back();
+    *s = s_template[d->replayPos];
+
+    uint32_t loop = d->replayLoop;
+    s->accepted = loop * (last->accepted - first->accepted) + s->accepted - first->accepted;
+    s->rejected = loop * (last->rejected - first->rejected) + s->rejected - first->rejected;
+    s->stale = loop * (last->stale - first->stale) + s->stale - first->stale;
+    for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+        s->latencyHist[b] = loop * (last->latencyHist[b] - first->latencyHist[b]) +
+                            s->latencyHist[b] - first->latencyHist[b];
+    }
+    s->hashRate *= d->rate;
+    s->hashRate1m *= d->rate;
+    s->hashRate15m *= d->rate;
+
+    if (++d->replayPos == s_template.size()) {
+        d->replayPos = 0;
+        d->replayLoop++;
+    }
+}
+
+static void takeSample(sim_device_t *d, double deviceTime) {
+    telemetry_sample_t s;
+    memset(&s, 0, sizeof(s));
+    if (s_replayPath) replaySample(d, &s);
+    else syntheticSample(d, &s);
+    s.uptime = d->bootOffset + (uint32_t)deviceTime;
+
+    // Served devices expose their newest batch; the others queue like the firmware
+    size_t cap = s_mode == MODE_SERVE ? TELEMETRY_BATCH_MAX : LOAD_QUEUE_MAX;
+    if (d->queue.size() >= cap) {
+        d->queue.erase(d->queue.begin());
+        if (s_mode != MODE_SERVE) d->header.dropped++;
+    }
+    d->queue.push_back(s);
+}
+
+static size_t encodeFrame(sim_device_t *d, uint8_t *buf, int *used) {
+    if (s_json) {
+        return telemetry_frame_json(&d->header, d->queue.data(), (int)d->queue.size(),
+                                    (char *)buf, TELEMETRY_FRAME_MAX, used);
+    }
+    return telemetry_frame_bin(&d->header, d->queue.data(), (int)d->queue.size(),
+                               buf, TELEMETRY_FRAME_MAX, used);
+}
+
+// ============================================================
+// Transports
+// ============================================================
+
+static int s_udpFd = -1;
+static struct sockaddr_storage s_udpAddr;
+static socklen_t s_udpAddrLen = 0;
+static std::string s_host, s_topic;
+static uint16_t s_port = 0;
+
+static bool openUdp() {
+    std::string path;
+    if (!fleet_parse_target(s_target, &s_host, &s_port, &path, 9100)) return false;
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", s_port);
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(s_host.c_str(), service, &hints, &res) != 0 || !res) {
+        fprintf(stderr, "[LOAD] Cannot resolve %s\n", s_host.c_str());
+        return false;
+    }
+    memcpy(&s_udpAddr, res->ai_addr, res->ai_addrlen);
+    s_udpAddrLen = res->ai_addrlen;
+    s_udpFd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    freeaddrinfo(res);
+    return s_udpFd >= 0;
+}
+
+static void mqttOpen(sim_device_t *d, int index) {
+    d->fd = fleet_connect(s_host.c_str(), s_port);
+    if (d->fd < 0) {
+        s_sendErrors++;
+        return;
+    }
+    d->connecting = true;
+    d->in.clear();
+    d->out.clear();
+
+    char clientId[32];
+    snprintf(clientId, sizeof(clientId), "fleet-load-%d", index);
+    mqtt_connect(&d->out, clientId, NULL, NULL, 0);
+}
+
+static void mqttClose(sim_device_t *d) {
+    close(d->fd);
+    d->fd = -1;
+    s_sendErrors++;
+}
+
+static void sendQueue(sim_device_t *d) {
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    // A lost session reconnects; publishes queue behind the CONNECT
+    if (s_mode == MODE_MQTT && d->fd < 0) mqttOpen(d, (int)(d - s_devices.data()));
+
+    while (!d->queue.empty()) {
+        if (s_mode == MODE_MQTT && (d->fd < 0 || d->out.size() > 64 * 1024)) return;
+
+        int used = 0;
+        size_t len = encodeFrame(d, frame, &used);
+        if (!len) return;
+
+        if (s_mode == MODE_UDP) {
+            if (sendto(s_udpFd, frame, len, 0, (struct sockaddr *)&s_udpAddr, s_udpAddrLen) < 0) {
+                s_sendErrors++;
+                return;
+            }
+        } else {
+            mqtt_publish(&d->out, d->topic, frame, len);
+        }
+        d->queue.erase(d->queue.begin(), d->queue.begin() + used);
+        d->header.seq++;
+        s_framesSent++;
+        s_samplesSent += used;
+    }
+}
+
+// Serve mode: GET /device/<n> returns device n's newest samples
+typedef struct {
+    int fd;
+    bool answered;
+    std::string in, out;
+} serve_conn_t;
+
+static std::vector<serve_conn_t> s_serveConns;
+
+static void serveRequest(serve_conn_t *c) {
+    int index = -1;
+    if (c->in.compare(0, 12, "GET /device/") == 0) index = atoi(c->in.c_str() + 12);
+
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t len = 0;
+    if (index >= 0 && index < s_deviceCount && !s_devices[index].queue.empty()) {
+        int used;
+        len = encodeFrame(&s_devices[index], frame, &used);
+    }
+
+    char head[160];
+    snprintf(head, sizeof(head), "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n\r\n",
+             len ? "200 OK" : "404 Not Found", s_json ? "application/json" : "application/octet-stream", len);
+    c->out.append(head);
+    c->out.append((const char *)frame, len);
+    c->answered = true;
+    s_served++;
+}
+
+static bool writeList(int port) {
+    FILE *f = fopen(s_listPath, "w");
+    if (!f) return false;
+    for (int i = 0; i < s_deviceCount; i++) fprintf(f, "http://127.0.0.1:%d/device/%d\n", port, i);
+    return fclose(f) == 0;
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+static bool loadTemplate(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    struct __attribute__((packed)) {
+        uint32_t time;
+        uint16_t len;
+        uint8_t source;
+    } rec;
+    uint8_t mac[6] = { 0 };
+    std::vector<char> buf;
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        buf.resize(rec.len + 1);
+        if (fread(buf.data(), 1, rec.len, f) != rec.len) break;
+        buf[rec.len] = '\0';
+
+        telemetry_header_t header;
+        telemetry_sample_t samples[TELEMETRY_BATCH_MAX];
+        int n = buf[0] == '{'
+            ? telemetry_frame_parse_json(buf.data(), &header, samples, TELEMETRY_BATCH_MAX)
+            : telemetry_frame_parse_bin((const uint8_t *)buf.data(), rec.len, &header, samples, TELEMETRY_BATCH_MAX);
+        if (n <= 0) continue;
+        if (s_template.empty()) {
+            memcpy(mac, header.mac, 6);
+            s_templateBoard.assign(header.board, strnlen(header.board, sizeof(header.board)));
+        }
+        if (memcmp(mac, header.mac, 6) != 0) continue;
+        for (int i = 0; i < n; i++) {
+            if (s_template.empty() || samples[i].uptime > s_template.back().uptime) s_template.push_back(samples[i]);
+        }
+    }
+    fclose(f);
+    return s_template.size() >= 2;
+}
+
+static void onSignal(int) {
+    s_stop = 1;
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s --devices N (--udp HOST[:PORT] | --mqtt HOST[:PORT][/TOPIC] |\n"
+            "          --serve PORT --list FILE) [--interval S] [--speed X] [--seconds S]\n"
+            "          [--slow PCT] [--diff D] [--json] [--replay CAPTURE] [--seed N]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "--json")) {
+            s_json = true;
+            continue;
+        }
+        const char *val = i + 1 < argc ? argv[++i] : NULL;
+        if (!val) return usage(argv[0]);
+        if (!strcmp(arg, "--devices")) s_deviceCount = atoi(val);
+        else if (!strcmp(arg, "--udp")) { s_mode = MODE_UDP; s_target = val; }
+        else if (!strcmp(arg, "--mqtt")) { s_mode = MODE_MQTT; s_target = val; }
+        else if (!strcmp(arg, "--serve")) { s_mode = MODE_SERVE; s_servePort = (uint16_t)atoi(val); }
+        else if (!strcmp(arg, "--list")) s_listPath = val;
+        else if (!strcmp(arg, "--interval")) s_intervalS = (uint32_t)atoi(val);
+        else if (!strcmp(arg, "--speed")) s_speed = atof(val);
+        else if (!strcmp(arg, "--seconds")) s_seconds = (uint32_t)atoi(val);
+        else if (!strcmp(arg, "--slow")) s_slowPct = (float)atof(val);
+        else if (!strcmp(arg, "--diff")) s_diff = atof(val);
+        else if (!strcmp(arg, "--replay")) s_replayPath = val;
+        else if (!strcmp(arg, "--seed")) s_rng = strtoull(val, NULL, 0) | 1;
+        else return usage(argv[0]);
+    }
+    if (s_deviceCount <= 0 || s_mode == MODE_NONE || s_intervalS == 0 || s_speed <= 0 || s_diff <= 0 ||
+        (s_mode == MODE_SERVE && !s_listPath)) {
+        return usage(argv[0]);
+    }
+    if (s_replayPath && !loadTemplate(s_replayPath)) {
+        fprintf(stderr, "[LOAD] No usable frames in %s\n", s_replayPath);
+        return 1;
+    }
+
+    fleet_raise_fd_limit();
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    int listenFd = -1;
+    if (s_mode == MODE_UDP && !openUdp()) return usage(argv[0]);
+    if (s_mode == MODE_MQTT) {
+        std::string path;
+        if (!fleet_parse_target(s_target, &s_host, &s_port, &path, 1883)) return usage(argv[0]);
+        s_topic = path.size() > 1 ? path.substr(1) : "sparkminer";
+    }
+    if (s_mode == MODE_SERVE) {
+        listenFd = fleet_listen_tcp(s_servePort);
+        if (listenFd < 0 || !writeList(s_servePort)) return 1;
+    }
+
+    s_devices.resize(s_deviceCount);
+    int slow = 0;
+    for (int i = 0; i < s_deviceCount; i++) {
+        sim_device_t *d = &s_devices[i];
+        initDevice(d, i);
+        slow += d->slow;
+        char mac[13];
+        snprintf(mac, sizeof(mac), "%02x%02x%02x%02x%02x%02x", d->header.mac[0], d->header.mac[1],
+                 d->header.mac[2], d->header.mac[3], d->header.mac[4], d->header.mac[5]);
+        d->topic = s_topic + "/" + mac;
+        if (s_mode == MODE_MQTT) mqttOpen(d, i);
+    }
+    printf("[LOAD] %d devices (%d slow) %s, batch every %u s, speed %.1fx%s\n",
+           s_deviceCount, slow, s_replayPath ? "replaying a capture" : "synthetic",
+           s_intervalS, s_speed, s_json ? ", JSON" : "");
+    for (int i = 0, shown = 0; i < s_deviceCount && shown < 20; i++) {
+        if (!s_devices[i].slow) continue;
+        printf("[LOAD]   slow: %.16s (%.16s)\n", s_devices[i].header.worker, s_devices[i].header.board);
+        shown++;
+    }
+    fflush(stdout);
+
+    uint64_t start = nowMs();
+    std::vector<struct pollfd> fds;
+    while (!s_stop) {
+        uint64_t elapsed = nowMs() - start;
+        if (s_seconds && elapsed >= s_seconds * 1000ULL) break;
+        double deviceTime = elapsed / 1000.0 * s_speed;
+
+        for (sim_device_t &d : s_devices) {
+            while (d.nextSample <= deviceTime) {
+                takeSample(&d, d.nextSample);
+                d.nextSample += LOAD_SAMPLE_S;
+            }
+            if (s_mode != MODE_SERVE && d.nextSend <= deviceTime) {
+                sendQueue(&d);
+                d.nextSend += s_intervalS;
+            }
+        }
+
+        // Sockets: MQTT sessions (one per device) or the scrape server
+        fds.clear();
+        if (s_mode == MODE_MQTT) {
+            for (sim_device_t &d : s_devices) {
+                short events = d.fd < 0 ? 0 : (d.connecting || !d.out.empty() ? POLLOUT : 0) | POLLIN;
+                fds.push_back({ d.fd, events, 0 });
+            }
+        } else if (s_mode == MODE_SERVE) {
+            fds.push_back({ listenFd, POLLIN, 0 });
+            for (serve_conn_t &c : s_serveConns) fds.push_back({ c.fd, (short)(c.out.empty() ? POLLIN : POLLOUT), 0 });
+        }
+        if (fds.empty()) {
+            usleep(20000);
+            continue;
+        }
+        poll(fds.data(), fds.size(), 20);
+
+        if (s_mode == MODE_MQTT) {
+            for (int i = 0; i < s_deviceCount; i++) {
+                sim_device_t *d = &s_devices[i];
+                short rev = fds[i].revents;
+                if (d->fd < 0 || !rev) continue;
+                if (d->connecting) {
+                    int err = 0;
+                    socklen_t len = sizeof(err);
+                    if (getsockopt(d->fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err) {
+                        mqttClose(d);
+                        continue;
+                    }
+                    d->connecting = false;
+                }
+                // Broker replies (CONNACK) need no action
+                if ((rev & POLLIN) && !fleet_fill(d->fd, &d->in)) {
+                    mqttClose(d);
+                    continue;
+                }
+                d->in.clear();
+                if (!fleet_flush(d->fd, &d->out)) mqttClose(d);
+            }
+        } else {
+            for (size_t i = 0; i < s_serveConns.size();) {
+                serve_conn_t *c = &s_serveConns[i];
+                bool open = fleet_fill(c->fd, &c->in);
+                if (!c->answered && c->in.find("\r\n\r\n") != std::string::npos) serveRequest(c);
+                if (!fleet_flush(c->fd, &c->out)) open = false;
+                // HTTP/1.0: close once the response is out
+                if (!open || (c->answered && c->out.empty())) {
+                    close(c->fd);
+                    s_serveConns.erase(s_serveConns.begin() + i);
+                    continue;
+                }
+                i++;
+            }
+            if (fds[0].revents & POLLIN) {
+                int fd;
+                while ((fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    s_serveConns.push_back({ fd, false, "", "" });
+                }
+            }
+        }
+    }
+
+    printf("[LOAD] Sent %u frames, %u samples, %u errors\n", s_framesSent, s_samplesSent, s_sendErrors);
+    if (s_mode == MODE_SERVE) printf("[LOAD] Served %u scrapes\n", s_served);
+    return 0;
+}
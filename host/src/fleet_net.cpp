@@ -0,0 +1,200 @@
+/*
+ * SparkMiner - Fleet Tool Networking (host)
+ *
+ * GPL v3 License
+ */
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "fleet_net.h"
+
+bool fleet_parse_target(const char *text, std::string *host, uint16_t *port,
+                        std::string *path, uint16_t defaultPort) {
+    const char *p = strstr(text, "://");
+    p = p ? p + 3 : text;
+
+    const char *slash = strchr(p, '/');
+    const char *end = slash ? slash : p + strlen(p);
+    const char *colon = (const char *)memchr(p, ':', end - p);
+
+    host->assign(p, (colon ? colon : end) - p);
+    if (path) path->assign(slash ? slash : "/");
+
+    long value = defaultPort;
+    if (colon) {
+        char *stop;
+        value = strtol(colon + 1, &stop, 10);
+        if (stop != end) return false;
+    }
+    if (value <= 0 || value > 65535 || host->empty()) return false;
+    *port = (uint16_t)value;
+    return true;
+}
+
+static int bindSocket(int type, uint16_t port) {
+    int fd = socket(AF_INET6, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        fprintf(stderr, "[FLEET] socket: %s\n", strerror(errno));
+        return -1;
+    }
+    int one = 1, zero = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+
+    struct sockaddr_in6 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_any;
+    addr.sin6_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        (type == SOCK_STREAM && listen(fd, 1024) != 0)) {
+        fprintf(stderr, "[FLEET] Cannot bind port %u: %s\n", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int fleet_listen_tcp(uint16_t port) {
+    return bindSocket(SOCK_STREAM, port);
+}
+
+int fleet_bind_udp(uint16_t port) {
+    int fd = bindSocket(SOCK_DGRAM, port);
+    // Bursts from a thousand devices arrive together
+    int size = 4 << 20;
+    if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    return fd;
+}
+
+int fleet_connect(const char *host, uint16_t port) {
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, service, &hints, &res) != 0 || !res) return -1;
+
+    int fd = socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0 && errno != EINPROGRESS) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+void fleet_raise_fd_limit() {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+bool fleet_flush(int fd, std::string *out) {
+    while (!out->empty()) {
+        ssize_t n = send(fd, out->data(), out->size(), MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        out->erase(0, n);
+    }
+    return true;
+}
+
+bool fleet_fill(int fd, std::string *in) {
+    char buf[4096];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            in->append(buf, n);
+            continue;
+        }
+        if (n == 0) return false;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+// ============================================================
+// MQTT
+// ============================================================
+
+static void putLength(std::string *out, size_t len) {
+    do {
+        uint8_t byte = len % 128;
+        len /= 128;
+        out->push_back((char)(len ? byte | 0x80 : byte));
+    } while (len);
+}
+
+static void putString(std::string *out, const char *s, size_t len) {
+    out->push_back((char)(len >> 8));
+    out->push_back((char)(len & 0xFF));
+    out->append(s, len);
+}
+
+int mqtt_parse(const std::string &in, mqtt_packet_t *packet) {
+    const uint8_t *p = (const uint8_t *)in.data();
+    size_t len = 0, pos = 1;
+    for (int shift = 0;; shift += 7) {
+        if (pos >= in.size()) return 0;
+        if (shift > 21) return -1;
+        uint8_t byte = p[pos++];
+        len |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    if (len > MQTT_PACKET_MAX) return -1;
+    if (in.size() < pos + len) return 0;
+
+    packet->type = p[0] >> 4;
+    packet->flags = p[0] & 0x0F;
+    packet->body = p + pos;
+    packet->len = len;
+    return (int)(pos + len);
+}
+
+void mqtt_connect(std::string *out, const char *clientId, const char *user, const char *pass,
+                  uint16_t keepAliveSec) {
+    std::string body;
+    putString(&body, "MQTT", 4);
+    body.push_back(4);                                  // Protocol level 3.1.1
+    uint8_t flags = 0x02;                               // Clean session
+    if (user && *user) flags |= 0x80 | (pass && *pass ? 0x40 : 0);
+    body.push_back((char)flags);
+    body.push_back((char)(keepAliveSec >> 8));
+    body.push_back((char)(keepAliveSec & 0xFF));
+    putString(&body, clientId, strlen(clientId));
+    if (flags & 0x80) putString(&body, user, strlen(user));
+    if (flags & 0x40) putString(&body, pass, strlen(pass));
+    mqtt_simple(out, MQTT_CONNECT, (const uint8_t *)body.data(), body.size());
+}
+
+void mqtt_publish(std::string *out, const std::string &topic, const uint8_t *payload, size_t len) {
+    out->push_back((char)(MQTT_PUBLISH << 4));
+    putLength(out, 2 + topic.size() + len);
+    putString(out, topic.data(), topic.size());
+    out->append((const char *)payload, len);
+}
+
+void mqtt_subscribe(std::string *out, uint16_t packetId, const std::string &filter) {
+    out->push_back((char)(MQTT_SUBSCRIBE << 4 | 0x02));
+    putLength(out, 2 + 2 + filter.size() + 1);
+    out->push_back((char)(packetId >> 8));
+    out->push_back((char)(packetId & 0xFF));
+    putString(out, filter.data(), filter.size());
+    out->push_back(0);                                  // QoS 0
+}
+
+void mqtt_simple(std::string *out, uint8_t type, const uint8_t *body, size_t len) {
+    out->push_back((char)(type << 4));
+    putLength(out, len);
+    if (len) out->append((const char *)body, len);
+}
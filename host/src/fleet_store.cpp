@@ -0,0 +1,453 @@
+/*
+ * SparkMiner - Fleet Telemetry Store (host)
+ *
+ * Not thread-safe: the aggregator drives it from its one event loop.
+ *
+ * GPL v3 License
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include "fleet_store.h"
+
+#define STORE_MAGIC             0x53465053  // "SPFS"
+#define STORE_VERSION           1
+#define REORDER_FRAMES          4           // Older seq within this many frames = late datagram
+
+template <typename T, int N>
+struct Ring {
+    T items[N];
+    uint32_t head;              // Next write
+    uint32_t count;
+
+    void push(const T &item) {
+        items[head] = item;
+        head = (head + 1) % N;
+        if (count < N) count++;
+    }
+    // 0 = oldest
+    const T &at(uint32_t i) const { return items[(head + N - count + i) % N]; }
+};
+
+typedef Ring<fleet_point_t, FLEET_RAW_POINTS> raw_ring_t;
+typedef Ring<fleet_point_t, FLEET_ROLLUP_POINTS> rollup_ring_t;
+
+// A 5 minute bucket being filled
+typedef struct {
+    fleet_point_t point;
+    double hashRateSum;
+    uint32_t merged;
+} rollup_acc_t;
+
+typedef struct {
+    fleet_device_t info;
+    uint32_t seq;
+    bool baselined;             // Counters below are valid
+    uint32_t accepted;          // Last sample's totals, for deltas
+    uint32_t rejected;
+    uint32_t stale;
+    uint32_t latencyHist[LATENCY_HIST_BUCKETS];
+    fleet_point_t pending;      // Deltas not yet in a fleet tick
+    rollup_acc_t rollup;
+    raw_ring_t raw;
+    rollup_ring_t rollups;
+} device_rec_t;
+
+typedef struct {
+    uint32_t nextTick;
+    rollup_acc_t rollup;
+    raw_ring_t raw;
+    rollup_ring_t rollups;
+} fleet_rec_t;
+
+static std::map<uint64_t, std::unique_ptr<device_rec_t>> s_devices;
+static std::unique_ptr<fleet_rec_t> s_fleet;
+static float s_outlierFraction = 0.2f;
+static uint32_t s_frames[FLEET_SRC_COUNT];
+static uint32_t s_badFrames = 0;
+
+static uint64_t macKey(const uint8_t *mac) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+    return key;
+}
+
+// Counter delta that treats a decrease as a restart from zero
+static uint32_t counterDelta(uint32_t now, uint32_t before) {
+    return now >= before ? now - before : now;
+}
+
+static void addDeltas(fleet_point_t *to, const fleet_point_t *from) {
+    to->accepted += from->accepted;
+    to->rejected += from->rejected;
+    to->stale += from->stale;
+    for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) to->latencyHist[b] += from->latencyHist[b];
+}
+
+// Fold a point into a 5 minute bucket, closing the previous bucket when
+// the point starts a new one (late points join the open bucket)
+static void rollupAdd(rollup_acc_t *acc, rollup_ring_t *ring, const fleet_point_t *p, bool sumDevices) {
+    uint32_t bucket = p->time - p->time % FLEET_ROLLUP_S;
+    if (acc->merged && bucket > acc->point.time) {
+        acc->point.hashRate = (float)(acc->hashRateSum / acc->merged);
+        if (sumDevices) acc->point.devices = (uint16_t)((acc->point.devices + acc->merged / 2) / acc->merged);
+        ring->push(acc->point);
+        acc->merged = 0;
+    }
+    if (!acc->merged) {
+        memset(acc, 0, sizeof(*acc));
+        acc->point.time = bucket;
+        acc->point.heapFree = p->heapFree;
+        acc->point.tempC = p->tempC;
+    }
+    acc->hashRateSum += p->hashRate;
+    acc->merged++;
+    addDeltas(&acc->point, p);
+    // Fleet: mean devices online; device: samples merged
+    acc->point.devices = (uint16_t)(acc->point.devices + (sumDevices ? p->devices : 1));
+    acc->point.tempC = std::max(acc->point.tempC, p->tempC);
+    acc->point.heapFree = std::min(acc->point.heapFree, p->heapFree);
+}
+
+static void copyName(char *dst, size_t size, const char *src, size_t srcSize) {
+    size_t n = strnlen(src, srcSize);
+    if (n >= size) n = size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// ============================================================
+// Ingest
+// ============================================================
+
+void fleet_store_init(float outlierFraction) {
+    s_devices.clear();
+    s_fleet.reset(new fleet_rec_t());
+    s_outlierFraction = outlierFraction;
+    memset(s_frames, 0, sizeof(s_frames));
+    s_badFrames = 0;
+}
+
+void fleet_store_bad_frame() {
+    s_badFrames++;
+}
+
+void fleet_store_ingest(const telemetry_header_t *header, const telemetry_sample_t *samples,
+                        int count, uint8_t source, uint32_t now) {
+    if (count <= 0 || source >= FLEET_SRC_COUNT) return;
+
+    std::unique_ptr<device_rec_t> &slot = s_devices[macKey(header->mac)];
+    if (!slot) {
+        slot.reset(new device_rec_t());
+        memcpy(slot->info.mac, header->mac, 6);
+    }
+    device_rec_t *dev = slot.get();
+    fleet_device_t *info = &dev->info;
+
+    uint32_t newest = samples[count - 1].uptime;
+    if (dev->baselined && newest < info->uptime) {
+        // A datagram overtaken by a newer one is dropped; anything else
+        // going back in time is the device starting over
+        if (header->seq < dev->seq && dev->seq - header->seq <= REORDER_FRAMES) return;
+        info->reboots++;
+        info->uptime = 0;
+        dev->accepted = dev->rejected = dev->stale = 0;
+        memset(dev->latencyHist, 0, sizeof(dev->latencyHist));
+    }
+
+    s_frames[source]++;
+    copyName(info->board, sizeof(info->board), header->board, sizeof(header->board));
+    copyName(info->worker, sizeof(info->worker), header->worker, sizeof(header->worker));
+    info->source = source;
+    info->lastSeen = now;
+    info->frames++;
+    info->dropped = header->dropped;
+    dev->seq = header->seq;
+
+    for (int i = 0; i < count; i++) {
+        const telemetry_sample_t *s = &samples[i];
+        if (dev->baselined && s->uptime <= info->uptime) continue;     // Retried frame
+
+        fleet_point_t p;
+        memset(&p, 0, sizeof(p));
+        p.time = now - (newest - s->uptime);
+        p.hashRate = s->hashRate;
+        p.devices = 1;
+        p.tempC = s->tempC;
+        p.heapFree = s->heapFree;
+        // The first frame only sets the baseline: totals from before the
+        // collector saw the device are not attributed to this window
+        if (dev->baselined) {
+            p.accepted = counterDelta(s->accepted, dev->accepted);
+            p.rejected = counterDelta(s->rejected, dev->rejected);
+            p.stale = counterDelta(s->stale, dev->stale);
+            for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+                p.latencyHist[b] = counterDelta(s->latencyHist[b], dev->latencyHist[b]);
+            }
+        }
+        dev->baselined = true;
+        dev->accepted = s->accepted;
+        dev->rejected = s->rejected;
+        dev->stale = s->stale;
+        memcpy(dev->latencyHist, s->latencyHist, sizeof(dev->latencyHist));
+
+        dev->raw.push(p);
+        rollupAdd(&dev->rollup, &dev->rollups, &p, false);
+        addDeltas(&dev->pending, &p);
+
+        info->uptime = s->uptime;
+        info->samples++;
+        info->hashRate = s->hashRate;
+        info->hashRate15m = s->hashRate15m;
+        info->accepted = s->accepted;
+        info->rejected = s->rejected;
+        info->stale = s->stale;
+        info->latencyAvg = s->latencyAvg;
+        info->tempC = s->tempC;
+        info->poolConnected = s->poolConnected;
+        info->heapFree = s->heapFree;
+        info->heapLargest = s->heapLargest;
+    }
+}
+
+// ============================================================
+// Fleet tick
+// ============================================================
+
+static float median(std::vector<float> *values) {
+    size_t n = values->size();
+    std::sort(values->begin(), values->end());
+    return n % 2 ? (*values)[n / 2] : ((*values)[n / 2 - 1] + (*values)[n / 2]) / 2;
+}
+
+// Device hashrate used for comparisons: the 15 minute mean once the
+// device has one, else its smoothed rate
+static float steadyRate(const fleet_device_t *info) {
+    return info->hashRate15m > 0 ? info->hashRate15m : info->hashRate;
+}
+
+static void updateOutliers() {
+    std::map<std::string, std::vector<float>> byBoard;
+    for (auto &it : s_devices) {
+        const fleet_device_t *info = &it.second->info;
+        if (info->online) byBoard[info->board].push_back(steadyRate(info));
+    }
+
+    std::map<std::string, float> medians;
+    for (auto &it : byBoard) {
+        medians[it.first] = it.second.size() >= FLEET_OUTLIER_MIN_PEERS ? median(&it.second) : 0;
+    }
+
+    for (auto &it : s_devices) {
+        fleet_device_t *info = &it.second->info;
+        info->boardMedian = info->online ? medians[info->board] : 0;
+        info->outlier = info->boardMedian > 0 &&
+                        steadyRate(info) < info->boardMedian * (1.0f - s_outlierFraction);
+    }
+}
+
+void fleet_store_tick(uint32_t now) {
+    if (!s_fleet) return;
+    fleet_rec_t *fleet = s_fleet.get();
+    if (!fleet->nextTick) fleet->nextTick = now - now % FLEET_TICK_S + FLEET_TICK_S;
+    if (now < fleet->nextTick) return;
+
+    fleet_point_t p;
+    memset(&p, 0, sizeof(p));
+    p.time = fleet->nextTick - FLEET_TICK_S;
+    p.heapFree = UINT32_MAX;
+    p.tempC = INT8_MIN;
+
+    for (auto &it : s_devices) {
+        device_rec_t *dev = it.second.get();
+        fleet_device_t *info = &dev->info;
+        info->online = now - info->lastSeen <= FLEET_OFFLINE_S;
+        addDeltas(&p, &dev->pending);
+        memset(&dev->pending, 0, sizeof(dev->pending));
+        if (!info->online) continue;
+
+        p.hashRate += info->hashRate;
+        p.devices++;
+        p.tempC = std::max(p.tempC, info->tempC);
+        p.heapFree = std::min(p.heapFree, info->heapFree);
+    }
+    if (!p.devices) {
+        p.heapFree = 0;
+        p.tempC = 0;
+    }
+
+    fleet->raw.push(p);
+    rollupAdd(&fleet->rollup, &fleet->rollups, &p, true);
+    fleet->nextTick = now - now % FLEET_TICK_S + FLEET_TICK_S;
+
+    updateOutliers();
+}
+
+// ============================================================
+// Queries
+// ============================================================
+
+uint32_t fleet_latency_percentile(const uint32_t *hist, float q) {
+    uint64_t total = 0;
+    for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) total += hist[b];
+    if (!total) return 0;
+
+    double rank = q * total;
+    uint64_t below = 0;
+    for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+        if (below + hist[b] >= rank && hist[b]) {
+            uint32_t lo = b ? (uint32_t)LATENCY_HIST_BASE_MS << (b - 1) : 0;
+            uint32_t hi = (uint32_t)LATENCY_HIST_BASE_MS << b;
+            if (b == LATENCY_HIST_BUCKETS - 1) return lo;   // Open-ended: report its floor
+            return lo + (uint32_t)((hi - lo) * (rank - below) / hist[b]);
+        }
+        below += hist[b];
+    }
+    return (uint32_t)LATENCY_HIST_BASE_MS << (LATENCY_HIST_BUCKETS - 2);
+}
+
+void fleet_store_summary(uint32_t now, uint32_t window, fleet_summary_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->now = now;
+    out->window = window;
+    memcpy(out->frames, s_frames, sizeof(s_frames));
+    out->badFrames = s_badFrames;
+
+    for (auto &it : s_devices) {
+        const fleet_device_t *info = &it.second->info;
+        out->devices++;
+        if (!info->online) continue;
+        out->online++;
+        if (info->outlier) out->outliers++;
+        out->hashRate += info->hashRate;
+    }
+
+    std::vector<fleet_point_t> points;
+    fleet_store_series(NULL, window > FLEET_RAW_POINTS * FLEET_TICK_S, now - window, &points);
+
+    fleet_point_t sum;
+    memset(&sum, 0, sizeof(sum));
+    double hashRateSum = 0;
+    for (const fleet_point_t &p : points) {
+        addDeltas(&sum, &p);
+        hashRateSum += p.hashRate;
+    }
+    out->hashRateMean = points.empty() ? 0 : (float)(hashRateSum / points.size());
+    out->accepted = sum.accepted;
+    out->rejected = sum.rejected;
+    out->stale = sum.stale;
+
+    uint32_t submitted = sum.accepted + sum.rejected;
+    out->rejectRate = submitted ? (float)sum.rejected / submitted : 0;
+    out->staleRate = submitted ? (float)sum.stale / submitted : 0;
+    out->latencyP50 = fleet_latency_percentile(sum.latencyHist, 0.50f);
+    out->latencyP90 = fleet_latency_percentile(sum.latencyHist, 0.90f);
+    out->latencyP99 = fleet_latency_percentile(sum.latencyHist, 0.99f);
+}
+
+void fleet_store_devices(std::vector<fleet_device_t> *out) {
+    out->clear();
+    for (auto &it : s_devices) out->push_back(it.second->info);
+    std::sort(out->begin(), out->end(), [](const fleet_device_t &a, const fleet_device_t &b) {
+        int c = strcmp(a.board, b.board);
+        return c ? c < 0 : strcmp(a.worker, b.worker) < 0;
+    });
+}
+
+template <typename R>
+static void collect(const R &ring, uint32_t since, std::vector<fleet_point_t> *out) {
+    for (uint32_t i = 0; i < ring.count; i++) {
+        if (ring.at(i).time >= since) out->push_back(ring.at(i));
+    }
+}
+
+bool fleet_store_series(const uint8_t *mac, bool rollup, uint32_t since,
+                        std::vector<fleet_point_t> *out) {
+    out->clear();
+    if (!s_fleet) return false;
+
+    const raw_ring_t *raw = &s_fleet->raw;
+    const rollup_ring_t *rollups = &s_fleet->rollups;
+    if (mac) {
+        auto it = s_devices.find(macKey(mac));
+        if (it == s_devices.end()) return false;
+        raw = &it->second->raw;
+        rollups = &it->second->rollups;
+    }
+    if (rollup) collect(*rollups, since, out);
+    else collect(*raw, since, out);
+    return true;
+}
+
+// ============================================================
+// Persistence
+// ============================================================
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t deviceSize;        // Layout check: records are written raw
+    uint32_t fleetSize;
+    uint32_t devices;
+    uint32_t frames[FLEET_SRC_COUNT];
+    uint32_t badFrames;
+} store_file_t;
+
+bool fleet_store_save(const char *path) {
+    if (!s_fleet) return false;
+
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return false;
+
+    store_file_t hdr = { STORE_MAGIC, STORE_VERSION, sizeof(device_rec_t), sizeof(fleet_rec_t),
+                         (uint32_t)s_devices.size(), {}, s_badFrames };
+    memcpy(hdr.frames, s_frames, sizeof(s_frames));
+
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              fwrite(s_fleet.get(), sizeof(fleet_rec_t), 1, f) == 1;
+    for (auto &it : s_devices) {
+        if (!ok) break;
+        ok = fwrite(it.second.get(), sizeof(device_rec_t), 1, f) == 1;
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        return false;
+    }
+    return true;
+}
+
+bool fleet_store_load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    store_file_t hdr;
+    bool ok = fread(&hdr, sizeof(hdr), 1, f) == 1 && hdr.magic == STORE_MAGIC &&
+              hdr.version == STORE_VERSION && hdr.deviceSize == sizeof(device_rec_t) &&
+              hdr.fleetSize == sizeof(fleet_rec_t);
+
+    std::unique_ptr<fleet_rec_t> fleet(new fleet_rec_t());
+    ok = ok && fread(fleet.get(), sizeof(fleet_rec_t), 1, f) == 1;
+
+    std::map<uint64_t, std::unique_ptr<device_rec_t>> devices;
+    for (uint32_t i = 0; ok && i < hdr.devices; i++) {
+        std::unique_ptr<device_rec_t> dev(new device_rec_t());
+        ok = fread(dev.get(), sizeof(device_rec_t), 1, f) == 1;
+        if (ok) devices[macKey(dev->info.mac)] = std::move(dev);
+    }
+    fclose(f);
+    if (!ok) return false;
+
+    s_fleet = std::move(fleet);
+    s_devices = std::move(devices);
+    memcpy(s_frames, hdr.frames, sizeof(s_frames));
+    s_badFrames = hdr.badFrames;
+    return true;
+}
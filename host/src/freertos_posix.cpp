@@ -0,0 +1,306 @@
+/*
+ * SparkMiner - FreeRTOS API on POSIX Threads
+ * Task, queue and semaphore API for the sparkminer-linux daemon
+ *
+ * Every task is a detached pthread and time is the host's monotonic
+ * clock. Core and priority are recorded for the firmware's log lines but
+ * not applied: the kernel schedules and preempts the miner threads, and
+ * the I/O tasks spend their time blocked in recv() or a queue. Queues and
+ * semaphores share one lock with a condition variable per queue, with the
+ * same item semantics as the scheduler simulation.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <esp_task_wdt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <deque>
+#include <vector>
+
+struct sim_task {
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t fn;
+    void *param;
+    UBaseType_t priority;
+    int core;
+    pthread_t thread;
+};
+
+struct sim_queue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    pthread_cond_t changed;
+};
+
+static pthread_mutex_t s_queueLock = PTHREAD_MUTEX_INITIALIZER;
+static thread_local sim_task *t_self = NULL;
+
+// ============================================================
+// Time
+// ============================================================
+
+static void sleepMs(uint32_t ms) {
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0) {
+    }
+}
+
+// Replaces arduino_host's no-op delay(): here time is real
+void delay(uint32_t ms) {
+    sleepMs(ms);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)millis();
+}
+
+// Absolute CLOCK_MONOTONIC deadline for a wait in ticks
+static struct timespec deadlineFor(TickType_t wait) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_nsec + (uint64_t)wait * portTICK_PERIOD_MS * 1000000ULL;
+    ts.tv_sec += (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    return ts;
+}
+
+// No task watchdog on the host; a stuck task shows up in the [STATS] lines
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic) {
+    (void)timeoutSeconds;
+    (void)panic;
+    return ESP_OK;
+}
+
+// ============================================================
+// Tasks
+// ============================================================
+
+static void *taskEntry(void *arg) {
+    sim_task *t = (sim_task *)arg;
+    t_self = t;
+    pthread_setname_np(pthread_self(), t->name);
+
+    t->fn(t->param);
+
+    // FreeRTOS task functions must never return
+    Serial.printf("[RTOS] ERROR: Task %s returned\n", t->name);
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+    sim_task *t = new sim_task();
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+    t->fn = fn;
+    t->param = param;
+    t->priority = priority < configMAX_PRIORITIES ? priority : configMAX_PRIORITIES - 1;
+    t->core = core == tskNO_AFFINITY ? 0 : (int)core;
+
+    // Stack depth is in bytes on ESP-IDF; host code paths (printf, getaddrinfo)
+    // need more, so never go below the default thread stack
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    size_t stack = 0;
+    pthread_attr_getstacksize(&attr, &stack);
+    if (stackDepth > stack) pthread_attr_setstacksize(&attr, stackDepth);
+
+    int err = pthread_create(&t->thread, &attr, taskEntry, t);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        Serial.printf("[RTOS] ERROR: Failed to create task %s (%d)\n", t->name, err);
+        delete t;
+        return pdFAIL;
+    }
+
+    if (handle) *handle = t;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == t_self) {
+        if (!t_self) return;
+        // The TCB stays allocated: other tasks may still hold the handle
+        pthread_exit(NULL);
+    }
+    pthread_cancel(task->thread);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    sleepMs((uint32_t)ticks * portTICK_PERIOD_MS);
+}
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t increment) {
+    *previousWake += increment;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(*previousWake - now) > 0) vTaskDelay(*previousWake - now);
+}
+
+void vTaskYield(void) {
+    sched_yield();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return t_self;
+}
+
+const char *pcTaskGetName(TaskHandle_t task) {
+    if (!task) task = t_self;
+    return task ? task->name : "main";
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    if (!task) task = t_self;
+    return task ? task->priority : 1;
+}
+
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority) {
+    if (!task) task = t_self;
+    if (!task) return;
+    task->priority = priority < configMAX_PRIORITIES ? priority : configMAX_PRIORITIES - 1;
+}
+
+// Core the task was created for; setup() runs on core 1 as on the chip
+BaseType_t xPortGetCoreID(void) {
+    return t_self ? t_self->core : 1;
+}
+
+// ============================================================
+// Queues
+// ============================================================
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    sim_queue *q = new sim_queue();
+    q->length = length;
+    q->itemSize = itemSize;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&q->changed, &attr);
+    pthread_condattr_destroy(&attr);
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (!queue) return;
+    pthread_cond_destroy(&queue->changed);
+    delete queue;
+}
+
+// Wait for the queue to change; false once the deadline has passed
+static bool waitChanged(sim_queue *q, TickType_t wait, const struct timespec *deadline) {
+    if (wait == 0) return false;
+    if (wait == portMAX_DELAY) {
+        pthread_cond_wait(&q->changed, &s_queueLock);
+        return true;
+    }
+    return pthread_cond_timedwait(&q->changed, &s_queueLock, deadline) == 0;
+}
+
+static BaseType_t queueSend(sim_queue *q, const void *item, TickType_t wait, bool overwrite) {
+    if (!q) return pdFALSE;
+    struct timespec deadline = deadlineFor(wait);
+    pthread_mutex_lock(&s_queueLock);
+
+    if (overwrite) {
+        q->items.clear();
+    } else {
+        while (q->items.size() >= q->length) {
+            if (!waitChanged(q, wait, &deadline) && q->items.size() >= q->length) {
+                pthread_mutex_unlock(&s_queueLock);
+                return pdFALSE;
+            }
+        }
+    }
+
+    const uint8_t *bytes = (const uint8_t *)item;
+    q->items.emplace_back(bytes, bytes + (bytes ? q->itemSize : 0));
+
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&s_queueLock);
+    return pdTRUE;
+}
+
+static BaseType_t queueReceive(sim_queue *q, void *item, TickType_t wait, bool peek) {
+    if (!q) return pdFALSE;
+    struct timespec deadline = deadlineFor(wait);
+    pthread_mutex_lock(&s_queueLock);
+
+    while (q->items.empty()) {
+        if (!waitChanged(q, wait, &deadline) && q->items.empty()) {
+            pthread_mutex_unlock(&s_queueLock);
+            return pdFALSE;
+        }
+    }
+
+    if (item && q->itemSize) memcpy(item, q->items.front().data(), q->itemSize);
+    if (!peek) {
+        q->items.pop_front();
+        pthread_cond_broadcast(&q->changed);
+    }
+    pthread_mutex_unlock(&s_queueLock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+    return queueSend(queue, item, wait, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) {
+    return queueSend(queue, item, 0, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+    return queueReceive(queue, item, wait, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait) {
+    return queueReceive(queue, item, wait, true);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    if (!queue) return 0;
+    pthread_mutex_lock(&s_queueLock);
+    UBaseType_t n = (UBaseType_t)queue->items.size();
+    pthread_mutex_unlock(&s_queueLock);
+    return n;
+}
+
+// ============================================================
+// Semaphores
+// ============================================================
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    sim_queue *q = xQueueCreate(1, 0);
+    q->items.emplace_back();
+    return q;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    sim_queue *q = xQueueCreate(maxCount, 0);
+    for (UBaseType_t i = 0; i < initialCount && i < maxCount; i++) q->items.emplace_back();
+    return q;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) {
+    return queueReceive(sem, NULL, wait, false);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    return queueSend(sem, NULL, 0, false);
+}
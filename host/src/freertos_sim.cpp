@@ -0,0 +1,649 @@
+/*
+ * SparkMiner - Host Scheduler Simulation Implementation
+ * FreeRTOS task, queue and semaphore API on host threads
+ *
+ * One mutex guards all scheduler state. A task thread only executes while
+ * it is the current task of its core; every other task thread waits on its
+ * own condition variable until dispatch() hands it the core.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <esp_task_wdt.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sim_sched.h"
+
+#define TICK_US     (1000000ULL / configTICK_RATE_HZ)
+#define NEVER_US    UINT64_MAX
+
+typedef enum {
+    SIM_READY = 0,
+    SIM_RUNNING,
+    SIM_BLOCKED,
+    SIM_DELETED
+} sim_state_t;
+
+struct sim_task {
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t fn;
+    void *param;
+    UBaseType_t priority;
+    UBaseType_t basePriority;   // Priority without mutex inheritance
+    int core;
+    sim_state_t state;
+    const void *waitObj;        // Queue blocked on (NULL = delay)
+    uint64_t wakeUs;            // Leave BLOCKED at this virtual time
+    uint64_t readySinceUs;
+    uint64_t runStartUs;
+    uint64_t sliceStartUs;
+    std::condition_variable cv;
+
+    // Statistics
+    uint64_t runUs;
+    uint32_t dispatches;
+    uint32_t preemptions;
+    uint64_t waitMaxUs;
+    uint64_t waitTotalUs;
+};
+
+struct sim_queue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::vector<uint8_t> storage;   // length * itemSize, allocated at create like the kernel
+    UBaseType_t head;
+    UBaseType_t count;
+    bool isMutex;
+    sim_task *holder;           // Mutex owner
+};
+
+typedef struct {
+    sim_task *current;          // NULL = idle task running
+    bool preemptPending;        // Current task must yield at its next kernel call
+    bool idle;
+    uint64_t idleSinceUs;
+    uint64_t busySinceUs;
+    uint64_t idleUs;
+    uint64_t maxBusyUs;
+} sim_core_t;
+
+static std::mutex s_lock;
+static std::vector<sim_task *> s_tasks;
+static sim_core_t s_cores[SIM_CORES];
+static thread_local sim_task *t_self = NULL;
+
+static double s_speed = 1.0;
+static const auto s_epoch = std::chrono::steady_clock::now();
+static bool s_started = false;
+static uint32_t s_wdtTimeout = 0;
+
+// ============================================================
+// Virtual Time
+// ============================================================
+
+uint64_t sim_sched_now_us() {
+    auto d = std::chrono::steady_clock::now() - s_epoch;
+    double us = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / 1000.0;
+    return (uint64_t)(us * s_speed);
+}
+
+static void sleepVirtual(uint64_t us) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds((int64_t)(us * 1000.0 / s_speed)));
+}
+
+uint32_t millis() {
+    return (uint32_t)(sim_sched_now_us() / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t)sim_sched_now_us();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(sim_sched_now_us() / TICK_US);
+}
+
+static uint64_t deadlineFor(TickType_t wait) {
+    if (wait == portMAX_DELAY) return NEVER_US;
+    return sim_sched_now_us() + (uint64_t)wait * TICK_US;
+}
+
+// ============================================================
+// Scheduling (s_lock held)
+// ============================================================
+
+// Give the core to its highest-priority ready task, FIFO within a priority
+static void dispatch(int c, uint64_t now) {
+    sim_core_t &core = s_cores[c];
+    sim_task *next = NULL;
+    for (sim_task *t : s_tasks) {
+        if (t->core != c || t->state != SIM_READY) continue;
+        if (!next || t->priority > next->priority ||
+            (t->priority == next->priority && t->readySinceUs < next->readySinceUs)) {
+            next = t;
+        }
+    }
+
+    core.current = next;
+    core.preemptPending = false;
+
+    if (!next) {
+        if (!core.idle) {
+            core.idle = true;
+            core.idleSinceUs = now;
+            if (now - core.busySinceUs > core.maxBusyUs) core.maxBusyUs = now - core.busySinceUs;
+        }
+        return;
+    }
+
+    if (core.idle) {
+        core.idle = false;
+        core.idleUs += now - core.idleSinceUs;
+        core.busySinceUs = now;
+    }
+
+    uint64_t wait = now > next->readySinceUs ? now - next->readySinceUs : 0;
+    next->waitTotalUs += wait;
+    if (wait > next->waitMaxUs) next->waitMaxUs = wait;
+    next->dispatches++;
+    next->state = SIM_RUNNING;
+    next->runStartUs = now;
+    next->sliceStartUs = now;
+    next->cv.notify_one();
+}
+
+// Request preemption of a core's current task if t outranks it
+static void checkPreempt(sim_task *t, uint64_t now) {
+    sim_core_t &core = s_cores[t->core];
+    if (!core.current) {
+        dispatch(t->core, now);
+    } else if (t->priority > core.current->priority) {
+        core.preemptPending = true;
+    }
+}
+
+static void makeReady(sim_task *t, uint64_t now) {
+    t->state = SIM_READY;
+    t->readySinceUs = now;
+    t->waitObj = NULL;
+    checkPreempt(t, now);
+}
+
+static void wakeWaiters(const void *obj, uint64_t now) {
+    for (sim_task *t : s_tasks) {
+        if (t->state == SIM_BLOCKED && t->waitObj == obj) makeReady(t, now);
+    }
+}
+
+// Give up the core and wait until dispatched again (never returns for DELETED)
+static void leave(std::unique_lock<std::mutex> &lk, sim_task *self, sim_state_t state) {
+    uint64_t now = sim_sched_now_us();
+    self->runUs += now - self->runStartUs;
+    self->state = state;
+    if (state == SIM_READY) self->readySinceUs = now;
+
+    dispatch(self->core, now);
+    if (state == SIM_DELETED) return;
+    self->cv.wait(lk, [self] { return self->state == SIM_RUNNING; });
+}
+
+static void checkpointLocked(std::unique_lock<std::mutex> &lk, sim_task *self) {
+    if (!self) return;
+    sim_core_t &core = s_cores[self->core];
+    if (core.preemptPending && core.current == self) {
+        self->preemptions++;
+        leave(lk, self, SIM_READY);
+    }
+}
+
+// Block on obj until woken or the deadline passes; outside a task, poll
+static void waitOn(std::unique_lock<std::mutex> &lk, sim_task *self, const void *obj, uint64_t deadline) {
+    if (!self) {
+        lk.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        lk.lock();
+        return;
+    }
+    self->waitObj = obj;
+    self->wakeUs = deadline;
+    leave(lk, self, SIM_BLOCKED);
+}
+
+// ============================================================
+// Tick Thread
+// ============================================================
+
+static void tickThread() {
+    while (true) {
+        sleepVirtual(TICK_US);
+
+        std::lock_guard<std::mutex> lg(s_lock);
+        uint64_t now = sim_sched_now_us();
+
+        for (sim_task *t : s_tasks) {
+            if (t->state == SIM_BLOCKED && t->wakeUs <= now) makeReady(t, now);
+        }
+
+        // Preempt for higher priority, time-slice equal priority
+        for (int c = 0; c < SIM_CORES; c++) {
+            sim_core_t &core = s_cores[c];
+            if (!core.current) {
+                dispatch(c, now);
+                continue;
+            }
+            for (sim_task *t : s_tasks) {
+                if (t->core != c || t->state != SIM_READY) continue;
+                if (t->priority > core.current->priority ||
+                    (t->priority == core.current->priority &&
+                     now - core.current->sliceStartUs >= TICK_US)) {
+                    core.preemptPending = true;
+                }
+            }
+        }
+    }
+}
+
+// ============================================================
+// Simulation API
+// ============================================================
+
+void sim_sched_set_speed(double speed) {
+    if (speed > 0) s_speed = speed;
+}
+
+double sim_sched_speed() {
+    return s_speed;
+}
+
+void sim_sched_start() {
+    std::lock_guard<std::mutex> lg(s_lock);
+    if (s_started) return;
+    s_started = true;
+    for (int c = 0; c < SIM_CORES; c++) {
+        s_cores[c].idle = true;
+        s_cores[c].idleSinceUs = sim_sched_now_us();
+    }
+    std::thread(tickThread).detach();
+}
+
+void sim_sched_checkpoint() {
+    sim_task *self = t_self;
+    if (!self || port_critical_nesting) return;
+
+    // Unlocked fast path: nothing pending for this core
+    if (!__atomic_load_n(&s_cores[self->core].preemptPending, __ATOMIC_RELAXED)) return;
+
+    std::unique_lock<std::mutex> lk(s_lock);
+    checkpointLocked(lk, self);
+}
+
+// Firmware built with -finstrument-functions (env:native-sim) reaches a
+// preemption point on every function entry. This stands in for the tick
+// interrupt that takes the core from a busy loop on the chip.
+static thread_local bool t_inHook = false;
+
+extern "C" __attribute__((no_instrument_function))
+void __cyg_profile_func_enter(void *fn, void *site) {
+    (void)fn;
+    (void)site;
+    if (t_inHook) return;
+    t_inHook = true;
+    sim_sched_checkpoint();
+    t_inHook = false;
+}
+
+extern "C" __attribute__((no_instrument_function))
+void __cyg_profile_func_exit(void *fn, void *site) {
+    (void)fn;
+    (void)site;
+}
+
+void sim_sched_busy(uint32_t us) {
+    sim_task *self = t_self;
+    if (!self) {
+        uint64_t end = sim_sched_now_us() + us;
+        while (sim_sched_now_us() < end) {
+        }
+        return;
+    }
+
+    // Count only time spent holding the core
+    uint64_t consumed = 0;
+    uint64_t mark = sim_sched_now_us();
+    while (consumed < us) {
+        uint64_t now = sim_sched_now_us();
+        consumed += now - mark;
+        sim_sched_checkpoint();
+        mark = sim_sched_now_us();
+    }
+}
+
+TaskHandle_t sim_sched_find(const char *name) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    for (sim_task *t : s_tasks) {
+        if (t->state != SIM_DELETED && strcmp(t->name, name) == 0) return t;
+    }
+    return NULL;
+}
+
+size_t sim_sched_get_stats(sim_task_stats_t *tasks, size_t maxTasks, sim_core_stats_t *cores) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    uint64_t now = sim_sched_now_us();
+
+    size_t n = 0;
+    for (sim_task *t : s_tasks) {
+        if (tasks && n < maxTasks) {
+            sim_task_stats_t &st = tasks[n];
+            st.name = t->name;
+            st.core = t->core;
+            st.priority = t->basePriority;
+            st.runUs = t->runUs + (t->state == SIM_RUNNING ? now - t->runStartUs : 0);
+            st.dispatches = t->dispatches;
+            st.preemptions = t->preemptions;
+            st.waitMaxUs = t->waitMaxUs;
+            st.waitTotalUs = t->waitTotalUs;
+        }
+        n++;
+    }
+
+    if (cores) {
+        for (int c = 0; c < SIM_CORES; c++) {
+            const sim_core_t &core = s_cores[c];
+            cores[c].idleUs = core.idleUs + (core.idle ? now - core.idleSinceUs : 0);
+            cores[c].maxBusyUs = core.maxBusyUs;
+            if (!core.idle && now - core.busySinceUs > cores[c].maxBusyUs) {
+                cores[c].maxBusyUs = now - core.busySinceUs;
+            }
+        }
+    }
+    return n;
+}
+
+uint32_t sim_sched_wdt_timeout() {
+    return s_wdtTimeout;
+}
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic) {
+    (void)panic;
+    s_wdtTimeout = timeoutSeconds;
+    return ESP_OK;
+}
+
+// ============================================================
+// Tasks
+// ============================================================
+
+static void taskEntry(sim_task *t) {
+    t_self = t;
+    {
+        std::unique_lock<std::mutex> lk(s_lock);
+        t->cv.wait(lk, [t] { return t->state == SIM_RUNNING; });
+    }
+
+    t->fn(t->param);
+
+    // FreeRTOS task functions must never return
+    Serial.printf("[SIM] ERROR: Task %s returned\n", t->name);
+    vTaskDelete(NULL);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+    (void)stackDepth;
+    sim_sched_start();
+
+    sim_task *t = new sim_task();
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+    t->fn = fn;
+    t->param = param;
+    t->priority = priority < configMAX_PRIORITIES ? priority : configMAX_PRIORITIES - 1;
+    t->basePriority = t->priority;
+    t->core = (core >= 0 && core < SIM_CORES) ? (int)core : SIM_DEFAULT_CORE;
+    t->state = SIM_BLOCKED;
+    t->wakeUs = NEVER_US;
+    t->waitObj = t;     // Parked until added below
+
+    std::thread(taskEntry, t).detach();
+
+    {
+        std::unique_lock<std::mutex> lk(s_lock);
+        s_tasks.push_back(t);
+        makeReady(t, sim_sched_now_us());
+        checkpointLocked(lk, t_self);
+    }
+
+    if (handle) *handle = t;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    std::unique_lock<std::mutex> lk(s_lock);
+    if (!task || task == t_self) {
+        sim_task *self = t_self;
+        if (!self) return;
+        leave(lk, self, SIM_DELETED);
+        lk.unlock();
+        // Park the thread for good; its stack stays valid like a zombie TCB
+        for (;;) std::this_thread::sleep_for(std::chrono::hours(1));
+    }
+
+    if (task->state == SIM_RUNNING) {
+        Serial.printf("[SIM] WARNING: vTaskDelete(%s) while it runs on the other core ignored\n", task->name);
+        return;
+    }
+    task->state = SIM_DELETED;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    sim_task *self = t_self;
+    if (!self) {
+        sleepVirtual((uint64_t)ticks * TICK_US);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lk(s_lock);
+    if (ticks == 0) {
+        leave(lk, self, SIM_READY);
+        return;
+    }
+
+    // Wake on a tick boundary: vTaskDelay(1) sleeps up to one tick
+    self->waitObj = NULL;
+    self->wakeUs = (sim_sched_now_us() / TICK_US + ticks) * TICK_US;
+    leave(lk, self, SIM_BLOCKED);
+}
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t increment) {
+    *previousWake += increment;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(*previousWake - now) > 0) vTaskDelay(*previousWake - now);
+}
+
+void vTaskYield(void) {
+    sim_task *self = t_self;
+    if (!self) return;
+    std::unique_lock<std::mutex> lk(s_lock);
+    leave(lk, self, SIM_READY);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return t_self;
+}
+
+const char *pcTaskGetName(TaskHandle_t task) {
+    if (!task) task = t_self;
+    return task ? task->name : "main";
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    if (!task) task = t_self;
+    return task ? task->priority : 1;
+}
+
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority) {
+    std::unique_lock<std::mutex> lk(s_lock);
+    if (!task) task = t_self;
+    if (!task) return;
+
+    if (priority >= configMAX_PRIORITIES) priority = configMAX_PRIORITIES - 1;
+    task->priority = priority;
+    task->basePriority = priority;
+
+    uint64_t now = sim_sched_now_us();
+    if (task->state == SIM_READY) {
+        checkPreempt(task, now);
+    } else if (task->state == SIM_RUNNING) {
+        // Lowered below a ready task: let it take over at the next kernel call
+        for (sim_task *t : s_tasks) {
+            if (t->core == task->core && t->state == SIM_READY && t->priority > priority) {
+                s_cores[task->core].preemptPending = true;
+            }
+        }
+    }
+    checkpointLocked(lk, t_self);
+}
+
+// setup() runs in the Arduino loopTask, which is pinned to core 1
+BaseType_t xPortGetCoreID(void) {
+    return t_self ? t_self->core : 1;
+}
+
+// ============================================================
+// Queues
+// ============================================================
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    sim_queue *q = new sim_queue();
+    q->length = length;
+    q->itemSize = itemSize;
+    q->storage.resize((size_t)length * itemSize);
+    q->head = 0;
+    q->count = 0;
+    q->isMutex = false;
+    q->holder = NULL;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+static BaseType_t queueSend(sim_queue *q, const void *item, TickType_t wait, bool overwrite) {
+    if (!q) return pdFALSE;
+    std::unique_lock<std::mutex> lk(s_lock);
+    sim_task *self = t_self;
+    uint64_t deadline = deadlineFor(wait);
+
+    if (overwrite) {
+        q->count = 0;
+    } else {
+        while (q->count >= q->length) {
+            if (wait == 0 || sim_sched_now_us() >= deadline) return pdFALSE;
+            waitOn(lk, self, q, deadline);
+        }
+    }
+
+    if (item && q->itemSize) {
+        UBaseType_t tail = (q->head + q->count) % q->length;
+        memcpy(&q->storage[(size_t)tail * q->itemSize], item, q->itemSize);
+    }
+    q->count++;
+
+    // Giving a mutex ends priority inheritance
+    if (q->isMutex && q->holder) {
+        q->holder->priority = q->holder->basePriority;
+        q->holder = NULL;
+    }
+
+    wakeWaiters(q, sim_sched_now_us());
+    checkpointLocked(lk, self);
+    return pdTRUE;
+}
+
+static BaseType_t queueReceive(sim_queue *q, void *item, TickType_t wait, bool peek) {
+    if (!q) return pdFALSE;
+    std::unique_lock<std::mutex> lk(s_lock);
+    sim_task *self = t_self;
+    uint64_t deadline = deadlineFor(wait);
+
+    while (q->count == 0) {
+        if (wait == 0 || sim_sched_now_us() >= deadline) return pdFALSE;
+
+        // Priority inheritance: lift the holder to the waiter's priority
+        if (q->isMutex && q->holder && self && q->holder->priority < self->priority) {
+            q->holder->priority = self->priority;
+            if (q->holder->state == SIM_READY) checkPreempt(q->holder, sim_sched_now_us());
+        }
+        waitOn(lk, self, q, deadline);
+    }
+
+    if (item && q->itemSize) memcpy(item, &q->storage[(size_t)q->head * q->itemSize], q->itemSize);
+    if (peek) return pdTRUE;
+
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    if (q->isMutex) q->holder = self;
+
+    wakeWaiters(q, sim_sched_now_us());
+    checkpointLocked(lk, self);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+    return queueSend(queue, item, wait, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) {
+    return queueSend(queue, item, 0, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+    return queueReceive(queue, item, wait, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait) {
+    return queueReceive(queue, item, wait, true);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    return queue ? queue->count : 0;
+}
+
+// ============================================================
+// Semaphores
+// ============================================================
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    sim_queue *q = xQueueCreate(1, 0);
+    q->isMutex = true;
+    q->count = 1;
+    return q;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    sim_queue *q = xQueueCreate(maxCount, 0);
+    q->count = initialCount < maxCount ? initialCount : maxCount;
+    return q;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) {
+    return queueReceive(sem, NULL, wait, false);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    return queueSend(sem, NULL, 0, false);
+}
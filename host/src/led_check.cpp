@@ -0,0 +1,224 @@
+/*
+ * SparkMiner - LED Status Check (host)
+ * Runs the status LED driver on a recording FastLED and the host esp_timer
+ *
+ * led_status.cpp and led_anim.cpp are compiled unmodified; every show()
+ * lands in the FastLED shim with a timestamp, and the esp_timer shim
+ * times each callback. Checks, in real time:
+ *   pulse          a pulsing status (connecting) plays its precomputed
+ *                  frames, no faster than LED_ANIM_MIN_FRAME_MS
+ *   mining         mining is a steady colour: no playback timer, no frames
+ *                  once it is shown
+ *   share flash    the overlay ends after LED_FLASH_MS and the mining
+ *                  colour returns, without restarting playback
+ *   busy expiry    the overlay timer finds the LED lock held by a slow
+ *                  show(): it must not wait on the shared timer task, and
+ *                  the overlay must still end
+ *   block          the rainbow runs LED_RAINBOW_MS; a share flash during it
+ *                  does not cut it short
+ *
+ * Usage: led_check
+ * Exit status is the number of failed checks.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <esp_timer.h>
+#include <board_config.h>
+#include <thread>
+#include "display/led_status.h"
+#include "display/led_anim.h"
+
+#define CHECK_SLACK_MS      40      // Timer and thread wakeup jitter on a loaded host
+#define CHECK_PULSE_MS      2000    // Playback observed per pulse check
+#define CHECK_HOLD_MS       300     // Slow show() holding the LED lock
+#define CHECK_MAX_FRAMES    1024
+
+static fastled_frame_t s_frames[CHECK_MAX_FRAMES];
+
+static void sleepMs(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static bool sameColor(const CRGB &a, const led_rgb_t &b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static bool inProgram(const CRGB &c, const led_program_t *prog) {
+    for (uint8_t i = 0; i < prog->count; i++) {
+        if (sameColor(c, prog->frames[i])) return true;
+    }
+    return false;
+}
+
+static int report(const char *name, bool ok, const char *detail) {
+    Serial.printf("[LED-CHECK] %-12s %s  %s\n", name, ok ? "OK" : "FAILED", detail);
+    return ok ? 0 : 1;
+}
+
+// ============================================================
+// Checks
+// ============================================================
+
+static int checkPulse() {
+    led_program_t prog;
+    led_anim_build(LED_STATUS_CONNECTING, RGB_LED_BRIGHTNESS, &prog);
+
+    led_status_set(LED_STATUS_CONNECTING);
+    sleepMs(CHECK_SLACK_MS);
+    FastLED.resetFrames();
+    sleepMs(CHECK_PULSE_MS);
+    size_t n = FastLED.frames(s_frames, CHECK_MAX_FRAMES);
+
+    uint32_t minGap = UINT32_MAX;
+    size_t foreign = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!inProgram(s_frames[i].color, &prog)) foreign++;
+        if (i > 0 && s_frames[i].ms - s_frames[i - 1].ms < minGap) minGap = s_frames[i].ms - s_frames[i - 1].ms;
+    }
+
+    size_t expected = CHECK_PULSE_MS / prog.frameMs;
+    size_t ceiling = CHECK_PULSE_MS / LED_ANIM_MIN_FRAME_MS + 1;
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%zu frames in %u ms (program: %u x %u ms), closest %lu ms apart",
+             n, (unsigned)CHECK_PULSE_MS, prog.count, prog.frameMs, (unsigned long)minGap);
+    return report("pulse", foreign == 0 && n >= expected / 2 && n <= ceiling && prog.frameMs >= LED_ANIM_MIN_FRAME_MS,
+                  detail);
+}
+
+static int checkMining() {
+    led_program_t prog;
+    led_anim_build(LED_STATUS_MINING, RGB_LED_BRIGHTNESS, &prog);
+
+    // From a pulse, so a running playback timer has to be stopped
+    led_status_set(LED_STATUS_CONNECTING);
+    sleepMs(CHECK_SLACK_MS);
+    FastLED.resetFrames();
+    led_status_set(LED_STATUS_MINING);
+    sleepMs(CHECK_SLACK_MS);
+    size_t n = FastLED.frames(s_frames, CHECK_MAX_FRAMES);
+    bool shown = n > 0 && sameColor(s_frames[n - 1].color, prog.frames[0]);
+
+    uint32_t callsBefore = 0, calls = 0;
+    esp_timer_host_stats("led_play", &callsBefore, NULL);
+    FastLED.resetFrames();
+    sleepMs(CHECK_PULSE_MS);
+    size_t after = FastLED.frameCount();
+    esp_timer_host_stats("led_play", &calls, NULL);
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%zu frames, %lu playback wakeups in %u ms of mining",
+             after, (unsigned long)(calls - callsBefore), (unsigned)CHECK_PULSE_MS);
+    return report("mining", prog.count == 1 && shown && after == 0 && calls == callsBefore, detail);
+}
+
+static int checkShareFlash() {
+    led_program_t white;
+    led_anim_build(LED_STATUS_SHARE_FOUND, RGB_LED_BRIGHTNESS, &white);
+    led_program_t mining;
+    led_anim_build(LED_STATUS_MINING, RGB_LED_BRIGHTNESS, &mining);
+
+    led_status_set(LED_STATUS_MINING);
+    sleepMs(CHECK_SLACK_MS);
+    FastLED.resetFrames();
+    uint32_t start = millis();
+    led_status_share_found();
+    bool during = led_status_get() == LED_STATUS_SHARE_FOUND;
+    sleepMs(LED_FLASH_MS + CHECK_SLACK_MS);
+    bool after = led_status_get() == LED_STATUS_MINING;
+
+    // White, then green once: exactly two frames
+    size_t n = FastLED.frames(s_frames, CHECK_MAX_FRAMES);
+    uint32_t endMs = 0;
+    if (n == 2 && sameColor(s_frames[1].color, mining.frames[0])) {
+        endMs = s_frames[1].ms - start;
+    }
+    bool flashed = n > 0 && sameColor(s_frames[0].color, white.frames[0]);
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "white for %lu ms (LED_FLASH_MS %u)", (unsigned long)endMs, (unsigned)LED_FLASH_MS);
+    return report("share flash", during && after && flashed && endMs >= LED_FLASH_MS &&
+                  endMs <= LED_FLASH_MS + CHECK_SLACK_MS, detail);
+}
+
+static int checkBusyExpiry() {
+    led_status_set(LED_STATUS_MINING);
+    sleepMs(CHECK_SLACK_MS);
+
+    uint32_t callsBefore = 0;
+    esp_timer_host_stats("led_overlay", &callsBefore, NULL);
+
+    // The toggle's show() holds the LED lock across the moment the flash expires
+    led_status_share_found();
+    sleepMs(LED_FLASH_MS / 2);
+    FastLED.holdNextShow(CHECK_HOLD_MS);
+    std::thread holder(led_status_toggle);
+    sleepMs(CHECK_HOLD_MS + CHECK_SLACK_MS);
+    holder.join();
+    bool ended = led_status_get() == LED_STATUS_MINING;
+    led_status_toggle();
+
+    uint32_t calls = 0, maxRunUs = 0;
+    esp_timer_host_stats("led_overlay", &calls, &maxRunUs);
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%lu expiry callbacks, longest %lu us, lock held %u ms",
+             (unsigned long)(calls - callsBefore), (unsigned long)maxRunUs, (unsigned)CHECK_HOLD_MS);
+    return report("busy expiry", ended && calls - callsBefore > 1 && maxRunUs < CHECK_HOLD_MS * 1000 / 4, detail);
+}
+
+static int checkBlock() {
+    led_program_t rainbow;
+    led_anim_build(LED_STATUS_BLOCK_FOUND, RGB_LED_BRIGHTNESS, &rainbow);
+
+    led_status_set(LED_STATUS_MINING);
+    sleepMs(CHECK_SLACK_MS);
+    FastLED.resetFrames();
+    led_status_block_found();
+    sleepMs(LED_RAINBOW_MS / 2);
+    led_status_share_found();
+    bool held = led_status_get() == LED_STATUS_BLOCK_FOUND;
+    sleepMs(LED_RAINBOW_MS / 2 - CHECK_SLACK_MS);
+    bool still = led_status_get() == LED_STATUS_BLOCK_FOUND;
+    sleepMs(2 * CHECK_SLACK_MS);
+    bool ended = led_status_get() == LED_STATUS_MINING;
+
+    size_t n = FastLED.frames(s_frames, CHECK_MAX_FRAMES);
+    size_t wheel = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (inProgram(s_frames[i].color, &rainbow)) wheel++;
+    }
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%zu rainbow frames (program: %u x %u ms)", wheel, rainbow.count, rainbow.frameMs);
+    return report("block", held && still && ended && rainbow.frameMs >= LED_ANIM_MIN_FRAME_MS &&
+                  wheel >= LED_RAINBOW_MS / rainbow.frameMs / 2, detail);
+}
+
+int main(int argc, char **argv) {
+    (void)argv;
+    if (argc > 1) {
+        fprintf(stderr, "Usage: led_check\n");
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    led_status_init();
+    if (!led_status_is_enabled()) {
+        Serial.println("[LED-CHECK] Driver did not start");
+        return 1;
+    }
+
+    int failed = 0;
+    failed += checkPulse();
+    failed += checkMining();
+    failed += checkShareFlash();
+    failed += checkBusyExpiry();
+    failed += checkBlock();
+
+    Serial.printf("[LED-CHECK] %d check(s) failed\n", failed);
+    fflush(stdout);
+    _Exit(failed);
+}
@@ -0,0 +1,345 @@
+/*
+ * SparkMiner - Linux Daemon (sparkminer-linux)
+ * The firmware's miner, stratum and monitor tasks as a host process
+ *
+ * Built from the same sources as the firmware: tasks_start() creates the
+ * stratum and monitor tasks on pthreads (freertos_posix.cpp) and the pool
+ * connection is a BSD socket (net_posix.cpp). Instead of the two miner
+ * tasks, one worker per hardware thread searches nonces through the
+ * work-stealing scheduler (nonce_sched.cpp) on the best SHA engine the
+ * host CPU offers (sha256_host.cpp); candidates go back through the
+ * miner's own share check and submit queue.
+ * Configuration is the SD card's config.json format, parsed by the same
+ * config_file.cpp on top of the same defaults; logs go to stdout.
+ * For telemetry the daemon's "MAC" is a hash of the hostname and the
+ * config file path, so several instances on one machine stay distinct.
+ * Live stats run the firmware fetcher; with no TLS client on the host,
+ * HTTPS APIs need stats_proxy_url. For LAN stats sharing the daemon
+ * outranks boards, so a host on the LAN becomes the publisher.
+ *
+ * Usage: sparkminer-linux [-c config.json] [--seconds S] [--threads N] [--pin]
+ *                         [--chunk-bits B] [--bench S]
+ *   --seconds 0 (default) runs until SIGINT/SIGTERM.
+ *   SIGHUP reloads the config file and applies changes without a restart.
+ *   --threads 0 (default) starts one worker per online CPU.
+ *   --bench S mines the golden synthetic job offline for S seconds at
+ *   1, 2, 4... threads and prints the scaling table.
+ * Exits with status 1 if the config cannot be loaded or has no wallet.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <esp_task_wdt.h>
+#include <board_config.h>
+#include <WiFi.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include "tasks.h"
+#include "mining/miner.h"
+#include "mining/core_vectors.h"
+#include "stratum/stratum.h"
+#include "stats/monitor.h"
+#include "config/config_file.h"
+#include "config/config_apply.h"
+#include "config/nvs_config.h"
+#include "config/wifi_manager.h"
+#include "stratum/stratum_msg.h"
+#include "nonce_sched.h"
+
+#define LINUX_CONFIG_MAX_BYTES  4096
+#define LINUX_REPORT_MS         60000   // Per-worker hashrate breakdown
+
+static miner_config_t s_config;
+static mining_persistence_t s_persist;
+static volatile sig_atomic_t s_stop = 0;
+static volatile sig_atomic_t s_reload = 0;
+
+// ============================================================
+// Configuration (replaces NVS)
+// ============================================================
+
+static bool loadConfig(const char *path, miner_config_t *config) {
+    config_file_defaults(config);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        Serial.printf("[CONFIG] Cannot open %s\n", path);
+        return false;
+    }
+    static char text[LINUX_CONFIG_MAX_BYTES + 1];
+    size_t len = fread(text, 1, LINUX_CONFIG_MAX_BYTES + 1, f);
+    fclose(f);
+    if (len > LINUX_CONFIG_MAX_BYTES) {
+        Serial.printf("[CONFIG] %s is larger than %d bytes\n", path, LINUX_CONFIG_MAX_BYTES);
+        return false;
+    }
+    text[len] = '\0';
+
+    StaticJsonDocument<1024> doc;
+    DeserializationError err = deserializeJson(doc, (const char *)text);
+    if (err) {
+        Serial.printf("[CONFIG] JSON parse error in %s: %s\n", path, err.c_str());
+        return false;
+    }
+
+    if (!config_file_apply(doc, config)) {
+        Serial.printf("[CONFIG] No wallet set in %s\n", path);
+        return false;
+    }
+    if (config->enableHttpsStats) {
+        Serial.println("[CONFIG] enable_https_stats ignored: no TLS on host, use stats_proxy_url");
+        config->enableHttpsStats = false;
+    }
+    Serial.printf("[CONFIG] Configuration loaded from %s\n", path);
+    return true;
+}
+
+// Locally administered address, stable for this host and config file
+static void setDeviceMac(const char *configPath) {
+    char name[HOST_NAME_MAX + 1] = "";
+    char path[PATH_MAX] = "";
+    gethostname(name, sizeof(name) - 1);
+    if (!realpath(configPath, path)) strncpy(path, configPath, sizeof(path) - 1);
+
+    uint32_t hash = 2166136261u;                // FNV-1a
+    for (const char *s : { (const char *)name, "/", (const char *)path }) {
+        for (; *s; s++) hash = (hash ^ (uint8_t)*s) * 16777619u;
+    }
+    uint8_t mac[6] = { 0x02, 0x53, (uint8_t)(hash >> 24), (uint8_t)(hash >> 16),
+                       (uint8_t)(hash >> 8), (uint8_t)hash };
+    WiFi.setMacAddress(mac);
+}
+
+miner_config_t *nvs_config_get() {
+    return &s_config;
+}
+
+bool nvs_config_is_valid() {
+    return s_config.wallet[0] != '\0';
+}
+
+// The config file is the only store; runtime changes are not written back
+bool nvs_config_save(const miner_config_t *config) {
+    if (config != &s_config) memcpy(&s_config, config, sizeof(s_config));
+    return true;
+}
+
+// Lifetime stats cover this process only
+mining_persistence_t *nvs_stats_get() {
+    return &s_persist;
+}
+
+void nvs_stats_update(uint64_t currentHashes, uint32_t currentShares,
+                      uint32_t currentAccepted, uint32_t currentRejected,
+                      uint32_t currentBlocks, uint32_t sessionSeconds,
+                      double bestDiff) {
+    s_persist.lifetimeHashes = currentHashes;
+    s_persist.lifetimeShares = currentShares;
+    s_persist.lifetimeAccepted = currentAccepted;
+    s_persist.lifetimeRejected = currentRejected;
+    s_persist.lifetimeBlocks = currentBlocks;
+    s_persist.totalUptimeSeconds = sessionSeconds;
+    if (bestDiff > s_persist.bestDifficultyEver) s_persist.bestDifficultyEver = bestDiff;
+}
+
+const char *wifi_manager_get_ip() {
+    return "host";
+}
+
+// ============================================================
+// Worker Pool
+// ============================================================
+
+static void onJob(const stratum_job_t *job, uint32_t extraNonce2, int extraNonce2Size) {
+    nonce_sched_set_job(job, extraNonce2, extraNonce2Size);
+}
+
+static bool minerActive() {
+    return miner_is_running();
+}
+
+static std::atomic<uint32_t> s_benchCandidates(0);
+
+static void onBenchShare(const char *jobId, uint32_t extraNonce2, sha256_hash_t *hash,
+                         uint32_t timestamp, uint32_t nonce) {
+    (void)jobId; (void)extraNonce2; (void)timestamp; (void)nonce;
+    if (hash->bytes[31] == 0 && hash->bytes[30] == 0) s_benchCandidates++;
+}
+
+// Offline scaling run on the golden synthetic job; no pool involved
+static int runBench(const nonce_sched_config_t *base, uint32_t seconds) {
+    size_t count;
+    const core_job_vector_t *vec = &core_vectors_jobs(&count)[count - 1];
+    stratum_job_t job;
+    DynamicJsonDocument doc(2048);
+    if (deserializeJson(doc, vec->notify) ||
+        !stratum_msg_parse_notify(doc.as<JsonVariantConst>(), vec->extraNonce1,
+                                  vec->extraNonce2Size, &job)) {
+        Serial.println("[BENCH] ERROR: Job vector did not parse");
+        return 1;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t maxThreads = base->threads ? base->threads : (uint32_t)cpus;
+    static nonce_worker_stats_t stats[NONCE_SCHED_MAX_WORKERS];
+    double single = 0;
+
+    Serial.printf("[BENCH] %lu s per step, up to %lu threads on %ld CPUs\n",
+                  (unsigned long)seconds, (unsigned long)maxThreads, cpus);
+    Serial.println("threads      MH/s  speedup  efficiency  candidates  rollovers  stolen");
+    for (uint32_t n = 1; !s_stop; n = (n * 2 < maxThreads) ? n * 2 : maxThreads) {
+        nonce_sched_config_t config = *base;
+        config.threads = n;
+        config.onShare = onBenchShare;
+        config.active = NULL;
+        config.hashCounter = NULL;
+        s_benchCandidates = 0;
+        if (!nonce_sched_start(&config)) return 1;
+
+        nonce_sched_set_job(&job, 0, vec->extraNonce2Size);
+        uint32_t start = millis();
+        delay(seconds * 1000);
+        uint32_t got = nonce_sched_get_stats(stats, NONCE_SCHED_MAX_WORKERS);
+        double secs = (millis() - start) / 1000.0;
+        nonce_sched_stop();
+
+        uint64_t hashes = 0;
+        uint32_t rollovers = 0, stolen = 0;
+        for (uint32_t i = 0; i < got; i++) {
+            hashes += stats[i].hashes;
+            rollovers += stats[i].rollovers;
+            stolen += stats[i].stolen;
+        }
+        double rate = hashes / secs / 1e6;
+        if (n == 1) single = rate;
+        double speedup = single > 0 ? rate / single : 0;
+        // ~1 candidate per 65536 hashes if the engine is right
+        Serial.printf("%7lu  %8.2f  %7.2f  %9.0f%%  %6lu/%-6.0f  %9lu  %6lu\n",
+                      (unsigned long)n, rate, speedup, 100.0 * speedup / n,
+                      (unsigned long)s_benchCandidates.load(), hashes / 65536.0,
+                      (unsigned long)rollovers, (unsigned long)stolen);
+        if (n == maxThreads) break;
+    }
+    return 0;
+}
+
+// ============================================================
+// Main (mirrors main.cpp setup())
+// ============================================================
+
+static void onSignal(int sig) {
+    if (sig == SIGHUP) s_reload = 1;
+    else s_stop = 1;
+}
+
+// SIGHUP: re-read the config file and apply the changes live
+static void reloadConfig(const char *path) {
+    static miner_config_t next;     // Off the main stack; only this thread reloads
+    Serial.printf("[CONFIG] Reloading %s\n", path);
+    if (!loadConfig(path, &next)) {
+        Serial.println("[CONFIG] Reload failed, keeping the running config");
+        return;
+    }
+    config_apply(&next);
+}
+
+static void printSummary(uint32_t elapsedMs) {
+    mining_stats_t *ms = miner_get_stats();
+    double secs = elapsedMs / 1000.0;
+    Serial.printf("\n=== SparkMiner v" AUTO_VERSION " (%s) ran %.0f s ===\n", BOARD_NAME, secs);
+    Serial.printf("hashrate:   %.1f KH/s\n", secs > 0 ? ms->hashes / secs / 1000.0 : 0.0);
+    Serial.printf("shares:     %lu submitted, %lu accepted, %lu rejected\n",
+                  (unsigned long)ms->shares, (unsigned long)ms->accepted, (unsigned long)ms->rejected);
+    Serial.printf("best diff:  %.4f, jobs %lu, avg latency %lu ms\n",
+                  ms->bestDifficulty, (unsigned long)ms->templates, (unsigned long)ms->avgLatency);
+}
+
+int main(int argc, char **argv) {
+    const char *configPath = "config.json";
+    uint32_t seconds = 0;
+    uint32_t benchSeconds = 0;
+    nonce_sched_config_t sched;
+    memset(&sched, 0, sizeof(sched));
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if ((!strcmp(argv[i], "-c") || !strcmp(argv[i], "--config")) && hasValue) configPath = argv[++i];
+        else if (!strcmp(argv[i], "--seconds") && hasValue) seconds = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--threads") && hasValue) sched.threads = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--pin")) sched.pin = true;
+        else if (!strcmp(argv[i], "--chunk-bits") && hasValue) sched.chunkBits = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--bench") && hasValue) benchSeconds = strtoul(argv[++i], NULL, 0);
+        else {
+            fprintf(stderr, "Usage: %s [-c config.json] [--seconds S] [--threads N] [--pin]\n"
+                            "       [--chunk-bits B] [--bench S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Log lines from several threads, and usually into a pipe or journal
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGHUP, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (benchSeconds) {
+        int rc = runBench(&sched, benchSeconds);
+        fflush(stdout);
+        _exit(rc);
+    }
+
+    Serial.println("[BOOT] Starting...");
+    if (!loadConfig(configPath, &s_config)) return 1;
+    setDeviceMac(configPath);
+
+    esp_task_wdt_init(30, true);
+    miner_init();
+    stratum_init();
+
+    miner_config_t *config = nvs_config_get();
+    stratum_set_pool(config->poolUrl, config->poolPort, config->wallet, config->poolPassword, config->workerName);
+    stratum_set_backup_pool(config->backupPoolUrl, config->backupPoolPort,
+                           config->backupWallet, config->backupPoolPassword, config->workerName);
+    stratum_set_difficulty(config->targetDifficulty);
+
+    monitor_init();
+
+    // Workers hash every job the miner accepts and hand candidates back to it
+    sched.onShare = miner_check_hash;
+    sched.active = minerActive;
+    sched.hashCounter = &miner_get_stats()->hashes;
+    if (!nonce_sched_start(&sched)) return 1;
+    miner_set_job_hook(onJob);
+    tasks_start();
+
+    Serial.println();
+    Serial.println("=== SparkMiner v" AUTO_VERSION " ===");
+    Serial.printf("Board: %s, %ld hardware threads\n", BOARD_NAME, sysconf(_SC_NPROCESSORS_ONLN));
+    Serial.printf("Pool: %s:%d\n", config->poolUrl, config->poolPort);
+
+    uint32_t start = millis();
+    uint32_t lastReport = start;
+    while (!s_stop && (seconds == 0 || millis() - start < seconds * 1000)) {
+        delay(100);
+        if (s_reload) {
+            s_reload = 0;
+            reloadConfig(configPath);
+        }
+        if (millis() - lastReport >= LINUX_REPORT_MS) {
+            nonce_sched_report();
+            lastReport = millis();
+        }
+    }
+
+    printSummary(millis() - start);
+    nonce_sched_report();
+    // Task threads never return; leave without running static destructors under them
+    fflush(stdout);
+    _exit(0);
+}
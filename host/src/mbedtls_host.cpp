@@ -0,0 +1,85 @@
+/*
+ * SparkMiner - Host mbedTLS Shim
+ * The SHA-256 and public key calls of host/include/mbedtls over OpenSSL,
+ * so firmware code that verifies signed data runs unchanged on the host
+ *
+ * GPL v3 License
+ */
+
+#include <mbedtls/sha256.h>
+#include <mbedtls/pk.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <string.h>
+
+// ============================================================
+// SHA-256
+// ============================================================
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx) {
+    ctx->md = EVP_MD_CTX_new();
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx) {
+    EVP_MD_CTX_free((EVP_MD_CTX *)ctx->md);
+    ctx->md = NULL;
+}
+
+int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224) {
+    const EVP_MD *md = is224 ? EVP_sha224() : EVP_sha256();
+    return ctx->md && EVP_DigestInit_ex((EVP_MD_CTX *)ctx->md, md, NULL) == 1 ? 0 : -1;
+}
+
+int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen) {
+    return EVP_DigestUpdate((EVP_MD_CTX *)ctx->md, input, ilen) == 1 ? 0 : -1;
+}
+
+int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[32]) {
+    unsigned int len = 0;
+    return EVP_DigestFinal_ex((EVP_MD_CTX *)ctx->md, output, &len) == 1 ? 0 : -1;
+}
+
+// ============================================================
+// Public Key
+// ============================================================
+
+void mbedtls_pk_init(mbedtls_pk_context *ctx) {
+    ctx->key = NULL;
+}
+
+void mbedtls_pk_free(mbedtls_pk_context *ctx) {
+    EVP_PKEY_free((EVP_PKEY *)ctx->key);
+    ctx->key = NULL;
+}
+
+int mbedtls_pk_parse_public_key(mbedtls_pk_context *ctx, const unsigned char *key, size_t keylen) {
+    // Like mbedTLS, a PEM key is passed with its NUL and a DER key without
+    EVP_PKEY *pkey = NULL;
+    if (keylen && key[keylen - 1] == '\0') {
+        BIO *bio = BIO_new_mem_buf(key, (int)keylen - 1);
+        if (bio) pkey = PEM_read_bio_PUBKEY(bio, NULL, NULL, NULL);
+        BIO_free(bio);
+    } else {
+        const unsigned char *der = key;
+        pkey = d2i_PUBKEY(NULL, &der, (long)keylen);
+    }
+    if (!pkey) return MBEDTLS_ERR_PK_KEY_INVALID_FORMAT;
+
+    EVP_PKEY_free((EVP_PKEY *)ctx->key);
+    ctx->key = pkey;
+    return 0;
+}
+
+int mbedtls_pk_verify(mbedtls_pk_context *ctx, mbedtls_md_type_t md_alg,
+                      const unsigned char *hash, size_t hash_len,
+                      const unsigned char *sig, size_t sig_len) {
+    if (!ctx->key || md_alg != MBEDTLS_MD_SHA256 || hash_len != 32) return MBEDTLS_ERR_PK_BAD_INPUT_DATA;
+
+    EVP_PKEY_CTX *vctx = EVP_PKEY_CTX_new((EVP_PKEY *)ctx->key, NULL);
+    bool ok = vctx && EVP_PKEY_verify_init(vctx) == 1 &&
+              EVP_PKEY_CTX_set_signature_md(vctx, EVP_sha256()) == 1 &&
+              EVP_PKEY_verify(vctx, sig, sig_len, hash, hash_len) == 1;
+    EVP_PKEY_CTX_free(vctx);
+    return ok ? 0 : MBEDTLS_ERR_ECP_VERIFY_FAILED;
+}
@@ -0,0 +1,235 @@
+/*
+ * SparkMiner - Mock Stats APIs Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_net.h"
+#include "mock_http.h"
+#include "sim_sched.h"
+
+#define HTTP_POLL_US        500     // Wall-clock poll interval of the server thread
+#define HTTP_MAX_REQUEST    2048
+#define HTTP_BLOCK_MS       600000  // Virtual time per block
+
+typedef struct {
+    HostLinkPtr link;
+    bool proxy;                 // Reached through the proxy port
+    std::string rx;
+    uint32_t closeAtMs;         // Set once answered: when the response has arrived
+    bool answered;
+} http_session_t;
+
+static mock_http_config_t s_config;
+static std::string s_proxyAuth;         // Expected Proxy-Authorization value
+static std::mutex s_lock;
+static std::vector<http_session_t *> s_sessions;
+static mock_http_stats_t s_stats;
+
+// ============================================================
+// Responses
+// ============================================================
+
+static std::string base64(const std::string &in) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < in.size(); i += 3) {
+        uint32_t n = (uint8_t)in[i] << 16;
+        if (i + 1 < in.size()) n |= (uint8_t)in[i + 1] << 8;
+        if (i + 2 < in.size()) n |= (uint8_t)in[i + 2];
+        out += table[(n >> 18) & 63];
+        out += table[(n >> 12) & 63];
+        out += i + 1 < in.size() ? table[(n >> 6) & 63] : '=';
+        out += i + 2 < in.size() ? table[n & 63] : '=';
+    }
+    return out;
+}
+
+static std::string response(int status, const char *reason, const std::string &body, bool chunked) {
+    char head[160];
+    if (chunked) {
+        snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n"
+                 "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n", status, reason);
+        // Two chunks, so the decoder has to join them
+        size_t half = body.size() / 2;
+        char size[16];
+        std::string out = head;
+        snprintf(size, sizeof(size), "%zx\r\n", half);
+        out += size + body.substr(0, half) + "\r\n";
+        snprintf(size, sizeof(size), "%zx\r\n", body.size() - half);
+        out += size + body.substr(half) + "\r\n0\r\n\r\n";
+        return out;
+    }
+    snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n"
+             "Content-Length: %zu\r\nConnection: close\r\n\r\n", status, reason, body.size());
+    return head + body;
+}
+
+static std::string hashrateHistory(uint32_t now) {
+    // Enough history that only the filtered parse fits the stats document
+    std::string out = "{\"hashrates\":[";
+    char entry[80];
+    for (int i = 0; i < 48; i++) {
+        snprintf(entry, sizeof(entry), "%s{\"timestamp\":%lu,\"avgHashrate\":%.6e}", i ? "," : "",
+                 (unsigned long)(1700000000UL + i * 1800), 6.2e20 + i * 1e18);
+        out += entry;
+    }
+    snprintf(entry, sizeof(entry), "],\"currentHashrate\":%.6e,\"currentDifficulty\":%.6e}",
+             6.5e20 + (now / HTTP_BLOCK_MS) * 1e17, 9.2e13);
+    return out + entry;
+}
+
+static std::string answer(const std::string &path) {
+    uint32_t now = millis();
+    char body[160];
+
+    if (path == "/api/blocks/tip/height") {
+        snprintf(body, sizeof(body), "%lu", (unsigned long)(900000 + now / HTTP_BLOCK_MS));
+        return response(200, "OK", body, false);
+    }
+    if (path == "/api/v1/fees/recommended") {
+        snprintf(body, sizeof(body), "{\"fastestFee\":%lu,\"halfHourFee\":8,\"hourFee\":5,"
+                 "\"economyFee\":3,\"minimumFee\":1}", (unsigned long)(10 + now / HTTP_BLOCK_MS % 5));
+        return response(200, "OK", body, true);
+    }
+    if (path == "/api/v1/mining/hashrate/1d") {
+        return response(200, "OK", hashrateHistory(now), false);
+    }
+    if (path == "/api/v1/difficulty-adjustment") {
+        snprintf(body, sizeof(body), "{\"progressPercent\":%.2f,\"difficultyChange\":1.84,"
+                 "\"remainingBlocks\":%lu}", (now / HTTP_BLOCK_MS % 2016) * 100.0 / 2016,
+                 (unsigned long)(2016 - now / HTTP_BLOCK_MS % 2016));
+        return response(200, "OK", body, false);
+    }
+    if (path.compare(0, 20, "/api/v3/simple/price") == 0) {
+        snprintf(body, sizeof(body), "{\"bitcoin\":{\"usd\":%lu}}",
+                 (unsigned long)(97000 + now / 60000 % 100 * 10));
+        return response(200, "OK", body, false);
+    }
+    if (path == "/api/v3/ping") {
+        return response(200, "OK", "{\"gecko_says\":\"(V3) To the Moon!\"}", false);
+    }
+    if (path.compare(0, 12, "/api/client/") == 0) {
+        return response(200, "OK", "{\"bestDifficulty\":\"1.23k\",\"workersCount\":1,"
+                        "\"hashrate\":\"412000\",\"workers\":[]}", false);
+    }
+
+    s_stats.notFound++;
+    return response(404, "Not Found", "{\"error\":\"not found\"}", false);
+}
+
+// Answer one complete request head (lock held)
+static std::string handleRequest(http_session_t *session) {
+    s_stats.requests++;
+
+    // GET <target> HTTP/1.1
+    const std::string &rx = session->rx;
+    size_t sp1 = rx.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? sp1 : rx.find(' ', sp1 + 1);
+    if (rx.compare(0, 4, "GET ") != 0 || sp2 == std::string::npos) {
+        return response(400, "Bad Request", "", false);
+    }
+    std::string target = rx.substr(sp1 + 1, sp2 - sp1 - 1);
+
+    if (session->proxy) {
+        s_stats.viaProxy++;
+        if (!s_proxyAuth.empty() && rx.find("\r\nProxy-Authorization: Basic " + s_proxyAuth + "\r\n") == std::string::npos) {
+            s_stats.authFailed++;
+            return response(407, "Proxy Authentication Required", "", false);
+        }
+        // The proxy gets the full URL: keep the path
+        size_t scheme = target.find("://");
+        if (scheme == std::string::npos) return response(400, "Bad Request", "", false);
+        size_t path = target.find('/', scheme + 3);
+        target = path == std::string::npos ? "/" : target.substr(path);
+    }
+    return answer(target);
+}
+
+// ============================================================
+// Server Thread
+// ============================================================
+
+static HostLinkPtr acceptConnection(const char *host, uint16_t port) {
+    (void)host;
+    bool proxy = s_config.proxyPort && port == s_config.proxyPort;
+    if (!proxy && port != 80 && port != 443 && port != 40557) return NULL;
+
+    // Handshake, TLS and the JSON parse that follows, on the connecting task
+    if (s_config.cpuPerRequestUs) sim_sched_busy(s_config.cpuPerRequestUs);
+
+    std::lock_guard<std::mutex> lg(s_lock);
+    http_session_t *session = new http_session_t();
+    session->link = std::make_shared<HostLink>(s_config.latencyMs);
+    session->proxy = proxy;
+    session->closeAtMs = 0;
+    session->answered = false;
+    s_sessions.push_back(session);
+    return session->link;
+}
+
+static void serverThread() {
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::microseconds(HTTP_POLL_US));
+
+        std::lock_guard<std::mutex> lg(s_lock);
+        uint32_t now = millis();
+
+        for (size_t i = 0; i < s_sessions.size();) {
+            http_session_t *session = s_sessions[i];
+
+            // Closed by the client, or our response has been delivered
+            bool done = session->link->closed() ||
+                        (session->answered && (int32_t)(now - session->closeAtMs) >= 0);
+            if (done) {
+                session->link->close();
+                s_sessions.erase(s_sessions.begin() + i);
+                delete session;
+                continue;
+            }
+
+            int c;
+            while (!session->answered && (c = session->link->read(true, now)) >= 0) {
+                if (session->rx.size() < HTTP_MAX_REQUEST) session->rx += (char)c;
+                if (session->rx.size() >= 4 && session->rx.compare(session->rx.size() - 4, 4, "\r\n\r\n") == 0) {
+                    std::string reply = handleRequest(session);
+                    session->link->write(false, reply.data(), reply.size(), now);
+                    session->closeAtMs = now + s_config.latencyMs + 1;
+                    session->answered = true;
+                }
+            }
+            i++;
+        }
+    }
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void mock_http_start(const mock_http_config_t *config) {
+    s_config = *config;
+    s_proxyAuth = config->proxyAuth ? base64(config->proxyAuth) : "";
+    memset(&s_stats, 0, sizeof(s_stats));
+
+    host_net_add_server(acceptConnection);
+    std::thread(serverThread).detach();
+
+    if (s_config.proxyPort) {
+        Serial.printf("[HTTP] Mock stats APIs, proxy on port %u%s, latency %lu ms\n",
+                      s_config.proxyPort, s_proxyAuth.empty() ? "" : " (authenticated)",
+                      (unsigned long)s_config.latencyMs);
+    } else {
+        Serial.printf("[HTTP] Mock stats APIs, latency %lu ms\n", (unsigned long)s_config.latencyMs);
+    }
+}
+
+void mock_http_get_stats(mock_http_stats_t *stats) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    *stats = s_stats;
+}
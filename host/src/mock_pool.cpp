@@ -0,0 +1,271 @@
+/*
+ * SparkMiner - Mock Stratum Pool Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_net.h"
+#include "mock_pool.h"
+#include "mining/mining_core.h"
+#include "mining/core_vectors.h"
+#include "stratum/stratum_msg.h"
+
+#define POOL_POLL_US        200     // Wall-clock poll interval of the pool thread
+#define POOL_MAX_LINE       4096
+
+typedef struct {
+    HostLinkPtr link;
+    std::string rx;
+    char extraNonce1[STRATUM_EXTRANONCE_LEN];
+    bool authorized;
+} pool_session_t;
+
+static mock_pool_config_t s_config;
+static std::mutex s_lock;
+static std::vector<pool_session_t *> s_sessions;
+static uint32_t s_sessionSeq = 0;
+
+static stratum_job_t s_template;
+static stratum_job_t s_job;             // Current job (extraNonce1 filled per session)
+static uint32_t s_jobSeq = 0;
+static uint32_t s_lastJobMs = 0;
+static uint8_t s_shareTarget[32];
+
+static mock_pool_stats_t s_stats;
+
+// ============================================================
+// Messages
+// ============================================================
+
+static void sendLine(pool_session_t *session, const std::string &line) {
+    std::string msg = line + "\n";
+    session->link->write(false, msg.data(), msg.size(), millis());
+}
+
+static void sendResult(pool_session_t *session, uint32_t id, bool ok, int code, const char *reason) {
+    char msg[160];
+    if (ok) {
+        snprintf(msg, sizeof(msg), "{\"id\":%lu,\"result\":true,\"error\":null}", (unsigned long)id);
+    } else {
+        snprintf(msg, sizeof(msg), "{\"id\":%lu,\"result\":null,\"error\":[%d,\"%s\",null]}",
+                 (unsigned long)id, code, reason);
+    }
+    sendLine(session, msg);
+}
+
+static void sendDifficulty(pool_session_t *session) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[%.10g]}",
+             s_config.difficulty);
+    sendLine(session, msg);
+}
+
+static void sendNotify(pool_session_t *session) {
+    const stratum_job_t &j = s_job;
+    std::string msg = "{\"id\":null,\"method\":\"mining.notify\",\"params\":[\"";
+    msg += j.jobId;
+    msg += "\",\"";
+    msg += j.prevHash;
+    msg += "\",\"";
+    msg += j.coinBase1;
+    msg += "\",\"";
+    msg += j.coinBase2;
+    msg += "\",[";
+    for (int i = 0; i < j.merkleBranchCount; i++) {
+        msg += i ? ",\"" : "\"";
+        msg += j.merkleBranches[i];
+        msg += "\"";
+    }
+    msg += "],\"";
+    msg += j.version;
+    msg += "\",\"";
+    msg += j.nbits;
+    msg += "\",\"";
+    msg += j.ntime;
+    msg += "\",true]}";
+    sendLine(session, msg);
+    s_stats.jobs++;
+}
+
+// ============================================================
+// Jobs & Shares
+// ============================================================
+
+// Same coinbase and branches each time; a new id and ntime make new work
+static void newJob(uint32_t now) {
+    s_job = s_template;
+    s_jobSeq++;
+    snprintf(s_job.jobId, sizeof(s_job.jobId), "%lx", (unsigned long)s_jobSeq);
+    uint32_t ntime = strtoul(s_template.ntime, NULL, 16) + s_jobSeq;
+    snprintf(s_job.ntime, sizeof(s_job.ntime), "%08lx", (unsigned long)ntime);
+    s_lastJobMs = now;
+}
+
+static void handleSubmit(pool_session_t *session, uint32_t id, JsonVariantConst params) {
+    s_stats.submits++;
+
+    const char *jobId = params[1] | "";
+    const char *en2Hex = params[2] | "";
+    const char *ntimeHex = params[3] | "";
+    const char *nonceHex = params[4] | "";
+
+    if (strcmp(jobId, s_job.jobId) != 0) {
+        s_stats.stale++;
+        sendResult(session, id, false, 21, "Job not found");
+        return;
+    }
+
+    unsigned long long en2 = strtoull(en2Hex, NULL, 16);
+    stratum_job_t job = s_job;
+    memcpy(job.extraNonce1, session->extraNonce1, sizeof(job.extraNonce1));
+
+    block_header_t hb;
+    if ((int)strlen(en2Hex) != job.extraNonce2Size * 2 || en2 > UINT32_MAX ||
+        !core_build_header(&hb, &job, (uint32_t)en2, job.extraNonce2Size)) {
+        s_stats.rejected++;
+        sendResult(session, id, false, 20, "Malformed share");
+        return;
+    }
+    hb.timestamp = strtoul(ntimeHex, NULL, 16);
+    hb.nonce = strtoul(nonceHex, NULL, 16);
+
+    sha256_hash_t hash;
+    core_sha256d(&hash, (const uint8_t *)&hb, sizeof(hb));
+    if (!core_check_target(hash.bytes, s_shareTarget)) {
+        s_stats.rejected++;
+        sendResult(session, id, false, 23, "Low difficulty share");
+        return;
+    }
+
+    s_stats.accepted++;
+    s_stats.acceptedWork += s_config.difficulty;
+    sendResult(session, id, true, 0, NULL);
+}
+
+static void handleLine(pool_session_t *session, const std::string &line) {
+    DynamicJsonDocument doc(POOL_MAX_LINE);
+    if (deserializeJson(doc, line.c_str())) return;
+
+    uint32_t id = doc["id"] | 0;
+    const char *method = doc["method"] | "";
+
+    if (strcmp(method, "mining.subscribe") == 0) {
+        char msg[192];
+        snprintf(msg, sizeof(msg),
+                 "{\"id\":%lu,\"result\":[[[\"mining.notify\",\"%s\"]],\"%s\",%d],\"error\":null}",
+                 (unsigned long)id, session->extraNonce1, session->extraNonce1,
+                 s_template.extraNonce2Size);
+        sendLine(session, msg);
+    } else if (strcmp(method, "mining.authorize") == 0) {
+        sendResult(session, id, true, 0, NULL);
+        session->authorized = true;
+        sendDifficulty(session);
+        sendNotify(session);
+    } else if (strcmp(method, "mining.submit") == 0) {
+        handleSubmit(session, id, doc["params"]);
+    } else if (strcmp(method, "mining.suggest_difficulty") == 0) {
+        // Ignored, like most public pools
+    } else {
+        sendResult(session, id, false, 20, "Unknown method");
+    }
+}
+
+// ============================================================
+// Pool Thread
+// ============================================================
+
+static HostLinkPtr acceptConnection(const char *host, uint16_t port) {
+    (void)host;
+    (void)port;
+    std::lock_guard<std::mutex> lg(s_lock);
+
+    pool_session_t *session = new pool_session_t();
+    session->link = std::make_shared<HostLink>(s_config.latencyMs);
+    snprintf(session->extraNonce1, sizeof(session->extraNonce1), "%08lx",
+             (unsigned long)(0xf0000000UL | ++s_sessionSeq));
+    session->authorized = false;
+    s_sessions.push_back(session);
+    s_stats.connections++;
+    return session->link;
+}
+
+static void poolThread() {
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::microseconds(POOL_POLL_US));
+
+        std::lock_guard<std::mutex> lg(s_lock);
+        uint32_t now = millis();
+
+        bool broadcast = false;
+        if (s_config.jobIntervalMs && now - s_lastJobMs >= s_config.jobIntervalMs) {
+            newJob(now);
+            broadcast = true;
+        }
+
+        for (size_t i = 0; i < s_sessions.size();) {
+            pool_session_t *session = s_sessions[i];
+            if (session->link->closed()) {
+                s_sessions.erase(s_sessions.begin() + i);
+                delete session;
+                continue;
+            }
+
+            int c;
+            while ((c = session->link->read(true, now)) >= 0) {
+                if (c == '\n') {
+                    handleLine(session, session->rx);
+                    session->rx.clear();
+                } else if (session->rx.size() < POOL_MAX_LINE) {
+                    session->rx += (char)c;
+                }
+            }
+
+            if (broadcast && session->authorized) sendNotify(session);
+            i++;
+        }
+    }
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+bool mock_pool_start(const mock_pool_config_t *config) {
+    s_config = *config;
+    memset(&s_stats, 0, sizeof(s_stats));
+
+    // Job template: the synthetic multi-branch job from the golden corpus
+    size_t count;
+    const core_job_vector_t *vectors = core_vectors_jobs(&count);
+    const core_job_vector_t *vec = &vectors[count - 1];
+
+    DynamicJsonDocument doc(POOL_MAX_LINE);
+    if (deserializeJson(doc, vec->notify) ||
+        !stratum_msg_parse_notify(doc.as<JsonVariantConst>(), vec->extraNonce1,
+                                  vec->extraNonce2Size, &s_template)) {
+        Serial.println("[POOL] ERROR: Job template did not parse");
+        return false;
+    }
+
+    core_difficulty_to_target(s_shareTarget, s_config.difficulty);
+    newJob(millis());
+
+    host_net_add_server(acceptConnection);
+    std::thread(poolThread).detach();
+
+    Serial.printf("[POOL] Mock pool: difficulty %.6g, job every %lu ms, latency %lu ms\n",
+                  s_config.difficulty, (unsigned long)s_config.jobIntervalMs,
+                  (unsigned long)s_config.latencyMs);
+    return true;
+}
+
+void mock_pool_get_stats(mock_pool_stats_t *stats) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    *stats = s_stats;
+}
@@ -0,0 +1,256 @@
+/*
+ * SparkMiner - WiFiClient on BSD Sockets
+ * Network backend of the sparkminer-linux daemon
+ *
+ * The host is always "associated"; WiFiClient is a non-blocking TCP
+ * socket. read()/available() serve a small receive buffer refilled with
+ * MSG_DONTWAIT, so the stratum task's byte-at-a-time polling costs one
+ * recv() per buffer rather than per byte, and connected() notices the
+ * peer closing the same way lwIP does (buffered data stays readable).
+ * WiFiUDP sends one datagram per beginPacket()/endPacket() pair and
+ * receives multicast on a second socket, so sending never drops the
+ * group membership.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+HostWiFi WiFi;
+
+#define NET_WRITE_TIMEOUT_MS    5000
+
+// Non-blocking connect to one resolved address, bounded by timeoutMs
+static int connectAddr(const struct addrinfo *ai, int32_t timeoutMs) {
+    int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+    if (fd < 0) return -1;
+
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+        if (errno != EINPROGRESS) {
+            close(fd);
+            return -1;
+        }
+        struct pollfd pfd = { fd, POLLOUT, 0 };
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (poll(&pfd, 1, timeoutMs) != 1 ||
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    // Shares are small and latency matters more than segment count
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// ============================================================
+// WiFiClient
+// ============================================================
+
+int WiFiClient::connect(const char *host, uint16_t port, int32_t timeoutMs) {
+    stop();
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo *res = NULL;
+    int err = getaddrinfo(host, service, &hints, &res);
+    if (err != 0) {
+        Serial.printf("[NET] Cannot resolve %s: %s\n", host, gai_strerror(err));
+        return 0;
+    }
+
+    for (struct addrinfo *ai = res; ai && m_fd < 0; ai = ai->ai_next) {
+        m_fd = connectAddr(ai, timeoutMs);
+    }
+    freeaddrinfo(res);
+    return m_fd >= 0 ? 1 : 0;
+}
+
+// Pull whatever the kernel has buffered; false once the peer has closed
+bool WiFiClient::fill() {
+    if (m_fd < 0) return false;
+    if (m_rxPos < m_rxLen) return true;
+
+    ssize_t n = recv(m_fd, m_rx, sizeof(m_rx), MSG_DONTWAIT);
+    if (n > 0) {
+        m_rxPos = 0;
+        m_rxLen = (size_t)n;
+        return true;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return true;
+
+    // EOF or reset
+    close(m_fd);
+    m_fd = -1;
+    return false;
+}
+
+uint8_t WiFiClient::connected() {
+    if (m_rxPos < m_rxLen) return 1;
+    return fill() ? 1 : 0;
+}
+
+int WiFiClient::available() {
+    fill();
+    return (int)(m_rxLen - m_rxPos);
+}
+
+int WiFiClient::read() {
+    if (m_rxPos >= m_rxLen && m_timeoutMs && fill() && m_rxPos >= m_rxLen) {
+        struct pollfd pfd = { m_fd, POLLIN, 0 };
+        poll(&pfd, 1, (int)m_timeoutMs);
+    }
+    if (m_rxPos >= m_rxLen && (!fill() || m_rxPos >= m_rxLen)) return -1;
+    return m_rx[m_rxPos++];
+}
+
+int WiFiClient::read(uint8_t *buf, size_t len) {
+    if (m_rxPos >= m_rxLen && (!fill() || m_rxPos >= m_rxLen)) return -1;
+    size_t n = m_rxLen - m_rxPos;
+    if (n > len) n = len;
+    memcpy(buf, m_rx + m_rxPos, n);
+    m_rxPos += n;
+    return (int)n;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t len) {
+    size_t sent = 0;
+    while (m_fd >= 0 && sent < len) {
+        ssize_t n = send(m_fd, buf + sent, len - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = { m_fd, POLLOUT, 0 };
+            if (poll(&pfd, 1, NET_WRITE_TIMEOUT_MS) != 1) break;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    return sent;
+}
+
+void WiFiClient::stop() {
+    if (m_fd >= 0) close(m_fd);
+    m_fd = -1;
+    m_rxPos = 0;
+    m_rxLen = 0;
+}
+
+// ============================================================
+// WiFiUDP
+// ============================================================
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port) {
+    m_txLen = 0;
+    m_addrLen = 0;
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host, service, &hints, &res) != 0 || !res) return 0;
+
+    if (m_fd >= 0) close(m_fd);
+    m_fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_fd >= 0 && res->ai_addrlen <= sizeof(m_addr)) {
+        memcpy(m_addr, res->ai_addr, res->ai_addrlen);
+        m_addrLen = res->ai_addrlen;
+    }
+    freeaddrinfo(res);
+    return m_addrLen ? 1 : 0;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t len) {
+    if (len > sizeof(m_tx) - m_txLen) len = sizeof(m_tx) - m_txLen;
+    memcpy(m_tx + m_txLen, buf, len);
+    m_txLen += len;
+    return len;
+}
+
+int WiFiUDP::endPacket() {
+    if (m_fd < 0 || !m_addrLen) return 0;
+    ssize_t n = sendto(m_fd, m_tx, m_txLen, 0, (const struct sockaddr *)m_addr, m_addrLen);
+    m_txLen = 0;
+    return n >= 0 ? 1 : 0;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress group, uint16_t port) {
+    if (m_rxFd >= 0) close(m_rxFd);
+    m_rxPos = m_rxLen = 0;
+    m_rxFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_rxFd < 0) return 0;
+
+    int one = 1;
+    setsockopt(m_rxFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    struct ip_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr.s_addr = htonl((uint32_t)group[0] << 24 | group[1] << 16 | group[2] << 8 | group[3]);
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+    if (bind(m_rxFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        setsockopt(m_rxFd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+        Serial.printf("[NET] Cannot join %u.%u.%u.%u:%u: %s\n",
+                      group[0], group[1], group[2], group[3], port, strerror(errno));
+        close(m_rxFd);
+        m_rxFd = -1;
+        return 0;
+    }
+    return 1;
+}
+
+int WiFiUDP::parsePacket() {
+    m_rxPos = m_rxLen = 0;
+    if (m_rxFd < 0) return 0;
+    ssize_t n = recv(m_rxFd, m_rx, sizeof(m_rx), MSG_DONTWAIT);
+    if (n <= 0) return 0;
+    m_rxLen = (size_t)n;
+    return (int)n;
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t len) {
+    if (len > m_rxLen - m_rxPos) len = m_rxLen - m_rxPos;
+    memcpy(buf, m_rx + m_rxPos, len);
+    m_rxPos += len;
+    return (int)len;
+}
+
+void WiFiUDP::stop() {
+    if (m_fd >= 0) close(m_fd);
+    if (m_rxFd >= 0) close(m_rxFd);
+    m_fd = -1;
+    m_rxFd = -1;
+    m_addrLen = 0;
+    m_rxPos = m_rxLen = 0;
+}
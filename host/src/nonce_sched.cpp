@@ -0,0 +1,439 @@
+/*
+ * SparkMiner - Work-Stealing Nonce Scheduler Implementation (host)
+ *
+ * Deque word layout: generation (32) | lo (16) | hi (16). lo only grows
+ * (owner pops) and hi only shrinks (thieves) within a generation, and a
+ * refill always moves to a newer generation, so a CAS never sees the same
+ * word twice.
+ *
+ * State word: generation (32) | chunks of it not yet hashed (32). Taking
+ * a chunk does not count; finishing one does. An empty set of deques is
+ * not enough to roll over: a thief may still be carrying a stolen run to
+ * its own deque, or a worker may be hashing the last chunks. Only the
+ * worker whose finished run brings the count to zero moves the state to
+ * the next generation, so no chunk of the current extranonce2 is dropped.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "nonce_sched.h"
+#include "mining/mining_core.h"
+#include "mining/sha256_ll.h"
+
+#define NONCE_BATCH             (1u << 14)  // Nonces between job/stop checks
+#define NONCE_IDLE_MS           10
+#define NONCE_TAIL_WAIT_US      200         // Deques empty, last chunks still being hashed
+#define NONCE_DEFAULT_CHUNK     20          // 1M nonces: ~50 ms per chunk on one SHA-NI thread
+#define NONCE_MIN_CHUNK         17          // At most 32768 chunks fit the 16-bit deque bounds
+#define NONCE_MAX_CHUNK         30
+
+typedef struct {
+    uint32_t gen;
+    uint32_t idx;               // First chunk
+    uint32_t count;             // Chunks in this run
+    uint64_t next;              // Next nonce to hash (resumes a run paused by active())
+} chunk_t;
+
+// Header state for one generation of the current job
+typedef struct {
+    uint32_t gen;
+    uint32_t jobSeq;
+    uint32_t extraNonce2;
+    uint32_t timestamp;
+    char jobId[MAX_JOB_ID_LEN];
+    uint32_t swapped[20];       // Header words pre-swapped for the LL API
+    uint32_t midstate[8];
+} work_t;
+
+struct sched_worker {
+    alignas(64) std::atomic<uint64_t> deque;    // Read by thieves: own cache line
+    alignas(64) std::atomic<uint64_t> hashes;   // Written by the owner only
+    std::atomic<uint32_t> chunks;
+    std::atomic<uint32_t> stolen;
+    std::atomic<uint32_t> rollovers;
+    uint32_t index;
+    int cpu;
+    pthread_t thread;
+};
+
+static nonce_sched_config_t s_config;
+static sched_worker *s_workers = NULL;
+static uint32_t s_count = 0;
+static uint32_t s_chunks = 0;               // Chunks per generation
+static std::atomic<bool> s_quit(false);
+
+// Current job; s_state and s_jobSeq are read lock-free on the hot path
+static std::mutex s_jobLock;
+static stratum_job_t s_job;
+static uint32_t s_extraNonce2 = 0;
+static int s_extraNonce2Size = 4;
+static uint32_t s_firstGen = 0;             // Generation of the job's first extranonce2
+static std::atomic<uint64_t> s_state(0);    // Generation | unfinished chunks (see above)
+static std::atomic<uint32_t> s_jobSeq(0);
+static std::atomic<bool> s_hasJob(false);
+
+// Report snapshot
+static uint64_t s_lastHashes[NONCE_SCHED_MAX_WORKERS];
+static uint32_t s_lastReportMs = 0;
+
+// ============================================================
+// Deques
+// ============================================================
+
+static inline uint64_t pack(uint32_t gen, uint32_t lo, uint32_t hi) {
+    return ((uint64_t)gen << 32) | ((uint64_t)lo << 16) | hi;
+}
+
+static inline uint32_t genOf(uint64_t st) { return (uint32_t)(st >> 32); }
+static inline uint32_t loOf(uint64_t st)  { return (uint32_t)(st >> 16) & 0xffff; }
+static inline uint32_t hiOf(uint64_t st)  { return (uint32_t)st & 0xffff; }
+
+static inline uint64_t packState(uint32_t gen, uint32_t left) { return ((uint64_t)gen << 32) | left; }
+static inline uint32_t leftOf(uint64_t st) { return (uint32_t)st; }
+
+// A worker's static slice of every generation
+static inline void shareOf(uint32_t index, uint32_t *lo, uint32_t *hi) {
+    *lo = (uint32_t)((uint64_t)index * s_chunks / s_count);
+    *hi = (uint32_t)((uint64_t)(index + 1) * s_chunks / s_count);
+}
+
+// Take the bottom chunk of the own deque, refilling it first if it is
+// still tagged with an older generation
+static bool popOwn(sched_worker *w, uint32_t g, chunk_t *c) {
+    uint64_t st = w->deque.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t sg = genOf(st);
+        if (sg > g) return false;
+
+        uint32_t lo, hi;
+        if (sg < g) {
+            shareOf(w->index, &lo, &hi);
+        } else {
+            lo = loOf(st);
+            hi = hiOf(st);
+        }
+        if (lo >= hi) {
+            if (sg < g) w->deque.compare_exchange_strong(st, pack(g, lo, hi));
+            return false;
+        }
+        if (w->deque.compare_exchange_weak(st, pack(g, lo + 1, hi), std::memory_order_acq_rel)) {
+            c->gen = g;
+            c->idx = lo;
+            c->count = 1;
+            c->next = (uint64_t)lo << s_config.chunkBits;
+            return true;
+        }
+    }
+}
+
+// Take the top half of a victim's run. The first stolen chunk is hashed
+// now; the rest goes into the own (empty) deque where it can be stolen
+// again, or stays private if that deque changed meanwhile.
+static bool steal(sched_worker *self, sched_worker *v, uint32_t g, chunk_t *c) {
+    uint64_t st = v->deque.load(std::memory_order_acquire);
+    uint32_t lo, hi, take;
+    for (;;) {
+        uint32_t sg = genOf(st);
+        if (sg > g) return false;
+
+        if (sg < g) {
+            shareOf(v->index, &lo, &hi);
+        } else {
+            lo = loOf(st);
+            hi = hiOf(st);
+        }
+        if (lo >= hi) {
+            if (sg < g) v->deque.compare_exchange_strong(st, pack(g, lo, hi));
+            return false;
+        }
+        take = (hi - lo + 1) / 2;
+        if (v->deque.compare_exchange_weak(st, pack(g, lo, hi - take), std::memory_order_acq_rel)) break;
+    }
+
+    c->gen = g;
+    c->idx = hi - take;
+    c->count = 1;
+    c->next = (uint64_t)c->idx << s_config.chunkBits;
+    if (take > 1) {
+        uint64_t mine = self->deque.load(std::memory_order_acquire);
+        if (genOf(mine) != g || loOf(mine) < hiOf(mine) ||
+            !self->deque.compare_exchange_strong(mine, pack(g, hi - take + 1, hi))) {
+            c->count = take;
+        }
+    }
+    self->stolen.fetch_add(take, std::memory_order_relaxed);
+    return true;
+}
+
+static bool takeChunk(sched_worker *self, chunk_t *c) {
+    uint32_t g = genOf(s_state.load(std::memory_order_acquire));
+    if (popOwn(self, g, c)) return true;
+
+    for (uint32_t k = 1; k < s_count; k++) {
+        if (steal(self, &s_workers[(self->index + k) % s_count], g, c)) return true;
+    }
+    return false;
+}
+
+// Count a hashed run; the run that completes its generation rolls extranonce2
+static void finishRun(sched_worker *self, const chunk_t *c) {
+    uint64_t st = s_state.load(std::memory_order_acquire);
+    for (;;) {
+        // A new job already replaced the generation
+        if (genOf(st) != c->gen) return;
+
+        uint32_t left = leftOf(st) - c->count;
+        uint64_t next = left ? packState(c->gen, left) : packState(c->gen + 1, s_chunks);
+        if (s_state.compare_exchange_weak(st, next, std::memory_order_acq_rel)) {
+            if (!left) self->rollovers.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// ============================================================
+// Workers
+// ============================================================
+
+// Header for a generation; false if it belongs to a replaced job
+static bool prepare(uint32_t gen, work_t *work) {
+    block_header_t hb;
+    {
+        std::lock_guard<std::mutex> lg(s_jobLock);
+        if (!s_hasJob || gen < s_firstGen) return false;
+
+        uint32_t en2 = s_extraNonce2 + (gen - s_firstGen);
+        if (s_extraNonce2Size < 4) en2 &= (1u << (8 * s_extraNonce2Size)) - 1;
+        if (!core_build_header(&hb, &s_job, en2, s_extraNonce2Size)) return false;
+
+        work->gen = gen;
+        work->jobSeq = s_jobSeq.load(std::memory_order_relaxed);
+        work->extraNonce2 = en2;
+        strncpy(work->jobId, s_job.jobId, sizeof(work->jobId) - 1);
+        work->jobId[sizeof(work->jobId) - 1] = '\0';
+    }
+
+    const uint32_t *words = (const uint32_t *)&hb;
+    for (int i = 0; i < 20; i++) work->swapped[i] = __builtin_bswap32(words[i]);
+    work->timestamp = hb.timestamp;
+    sha256_ll_midstate(work->midstate, (const uint8_t *)work->swapped);
+    return true;
+}
+
+static inline bool keepMining(const work_t *work) {
+    return !s_quit.load(std::memory_order_relaxed) &&
+           s_jobSeq.load(std::memory_order_relaxed) == work->jobSeq &&
+           (!s_config.active || s_config.active());
+}
+
+// Hash (the rest of) a run of chunks; false if interrupted by a new job,
+// a pause or a stop, with c->next marking where to resume
+static bool hashRun(sched_worker *w, chunk_t *c, const work_t *work) {
+    const uint8_t *tail = (const uint8_t *)&work->swapped[16];
+    uint64_t end = ((uint64_t)c->idx + c->count) << s_config.chunkBits;
+    sha256_hash_t hash;
+
+    while (c->next < end) {
+        uint64_t base = c->next;
+        for (uint32_t k = 0; k < NONCE_BATCH; k++) {
+            uint32_t nonce = (uint32_t)base + k;
+            if (sha256_ll_double_hash(work->midstate, tail, nonce, hash.bytes)) {
+                s_config.onShare(work->jobId, work->extraNonce2, &hash, work->timestamp, nonce);
+            }
+        }
+        w->hashes.fetch_add(NONCE_BATCH, std::memory_order_relaxed);
+        if (s_config.hashCounter) {
+            __atomic_fetch_add(s_config.hashCounter, (uint64_t)NONCE_BATCH, __ATOMIC_RELAXED);
+        }
+        c->next = base + NONCE_BATCH;
+        if (!keepMining(work)) return false;
+    }
+    return true;
+}
+
+static void *workerMain(void *arg) {
+    sched_worker *w = (sched_worker *)arg;
+    char name[16];
+    snprintf(name, sizeof(name), "Miner%u", (unsigned)w->index);
+    pthread_setname_np(pthread_self(), name);
+
+    work_t work;
+    work.gen = 0;
+    work.jobSeq = 0;
+    chunk_t c;
+    bool holding = false;       // A taken run is not finished yet
+
+    while (!s_quit.load(std::memory_order_relaxed)) {
+        if (s_config.active && !s_config.active()) {
+            delay(NONCE_IDLE_MS);
+            continue;
+        }
+        if (!s_hasJob.load(std::memory_order_acquire)) {
+            delay(NONCE_IDLE_MS);
+            continue;
+        }
+
+        // A run held over a pause is resumed, unless its job was replaced
+        if (holding && work.jobSeq != s_jobSeq.load(std::memory_order_relaxed)) holding = false;
+        if (!holding) {
+            if (!takeChunk(w, &c)) {
+                // Nothing left to take: the generation is rolling, or its
+                // last runs are still being hashed elsewhere
+                std::this_thread::sleep_for(std::chrono::microseconds(NONCE_TAIL_WAIT_US));
+                continue;
+            }
+            if (c.gen != work.gen && !prepare(c.gen, &work)) {
+                // Replaced job or unusable header: count it so the generation can still roll
+                finishRun(w, &c);
+                continue;
+            }
+            holding = true;
+        }
+
+        if (hashRun(w, &c, &work)) {
+            holding = false;
+            w->chunks.fetch_add(c.count, std::memory_order_relaxed);
+            finishRun(w, &c);
+        }
+    }
+    return NULL;
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+bool nonce_sched_start(const nonce_sched_config_t *config) {
+    if (s_workers) return false;
+
+    s_config = *config;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    if (s_config.threads == 0) s_config.threads = (uint32_t)cpus;
+    if (s_config.threads > NONCE_SCHED_MAX_WORKERS) s_config.threads = NONCE_SCHED_MAX_WORKERS;
+    if (s_config.chunkBits == 0) s_config.chunkBits = NONCE_DEFAULT_CHUNK;
+    s_config.chunkBits = constrain(s_config.chunkBits, NONCE_MIN_CHUNK, NONCE_MAX_CHUNK);
+
+    s_chunks = 1u << (32 - s_config.chunkBits);
+    s_count = s_config.threads;
+    s_workers = new sched_worker[s_count];
+    s_quit = false;
+
+    // Open a fresh generation sized for this chunk count; every deque is
+    // tagged with the previous one, so it is refilled on first use
+    uint32_t g = genOf(s_state.load());
+    s_state = packState(g + 1, s_chunks);
+    for (uint32_t i = 0; i < s_count; i++) {
+        sched_worker *w = &s_workers[i];
+        w->deque = pack(g, 0, 0);
+        w->hashes = 0;
+        w->chunks = 0;
+        w->stolen = 0;
+        w->rollovers = 0;
+        w->index = i;
+        w->cpu = s_config.pin ? (int)(i % cpus) : -1;
+        s_lastHashes[i] = 0;
+    }
+
+    uint32_t started = 0;
+    for (uint32_t i = 0; i < s_count; i++) {
+        sched_worker *w = &s_workers[i];
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (w->cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(w->cpu, &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        int err = pthread_create(&w->thread, &attr, workerMain, w);
+        pthread_attr_destroy(&attr);
+        if (err != 0) {
+            Serial.printf("[SCHED] ERROR: Worker %u not started (%d)\n", (unsigned)i, err);
+            break;
+        }
+        started++;
+    }
+
+    if (started < s_count) {
+        // Workers index the array by s_count; stop the ones that run
+        s_quit = true;
+        for (uint32_t i = 0; i < started; i++) pthread_join(s_workers[i].thread, NULL);
+        delete[] s_workers;
+        s_workers = NULL;
+        return false;
+    }
+
+    s_lastReportMs = millis();
+    Serial.printf("[SCHED] %u workers%s, %u chunks of 2^%u nonces per extranonce2\n",
+                  (unsigned)s_count, s_config.pin ? " (pinned)" : "",
+                  (unsigned)s_chunks, (unsigned)s_config.chunkBits);
+    return true;
+}
+
+void nonce_sched_stop(void) {
+    if (!s_workers) return;
+    s_quit = true;
+    for (uint32_t i = 0; i < s_count; i++) pthread_join(s_workers[i].thread, NULL);
+    delete[] s_workers;
+    s_workers = NULL;
+    s_count = 0;
+    s_hasJob = false;
+}
+
+void nonce_sched_set_job(const stratum_job_t *job, uint32_t extraNonce2, int extraNonce2Size) {
+    std::lock_guard<std::mutex> lg(s_jobLock);
+    memcpy(&s_job, job, sizeof(s_job));
+    s_extraNonce2 = extraNonce2;
+    s_extraNonce2Size = extraNonce2Size;
+    s_jobSeq.fetch_add(1, std::memory_order_relaxed);
+    // Every deque is now stale and gets refilled for the new job
+    uint64_t st = s_state.load(std::memory_order_acquire);
+    while (!s_state.compare_exchange_weak(st, packState(genOf(st) + 1, s_chunks), std::memory_order_acq_rel)) {
+    }
+    s_firstGen = genOf(st) + 1;
+    s_hasJob.store(true, std::memory_order_release);
+}
+
+uint32_t nonce_sched_get_stats(nonce_worker_stats_t *workers, uint32_t maxWorkers) {
+    for (uint32_t i = 0; i < s_count && i < maxWorkers; i++) {
+        const sched_worker *w = &s_workers[i];
+        workers[i].cpu = w->cpu;
+        workers[i].hashes = w->hashes.load(std::memory_order_relaxed);
+        workers[i].chunks = w->chunks.load(std::memory_order_relaxed);
+        workers[i].stolen = w->stolen.load(std::memory_order_relaxed);
+        workers[i].rollovers = w->rollovers.load(std::memory_order_relaxed);
+    }
+    return s_count;
+}
+
+void nonce_sched_report(void) {
+    static nonce_worker_stats_t stats[NONCE_SCHED_MAX_WORKERS];
+    uint32_t n = nonce_sched_get_stats(stats, NONCE_SCHED_MAX_WORKERS);
+    uint32_t now = millis();
+    double secs = (now - s_lastReportMs) / 1000.0;
+    if (n == 0 || secs <= 0) return;
+
+    double total = 0;
+    uint32_t rollovers = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        total += (stats[i].hashes - s_lastHashes[i]) / secs;
+        rollovers += stats[i].rollovers;
+    }
+    Serial.printf("[SCHED] %u workers: %.2f MH/s, %lu extranonce2 rollovers\n",
+                  (unsigned)n, total / 1e6, (unsigned long)rollovers);
+    for (uint32_t i = 0; i < n; i++) {
+        Serial.printf("[SCHED]   Miner%-3u cpu %3d  %7.2f MH/s  chunks %6lu  stolen %5lu\n",
+                      (unsigned)i, stats[i].cpu, (stats[i].hashes - s_lastHashes[i]) / secs / 1e6,
+                      (unsigned long)stats[i].chunks, (unsigned long)stats[i].stolen);
+        s_lastHashes[i] = stats[i].hashes;
+    }
+    s_lastReportMs = now;
+}
@@ -0,0 +1,118 @@
+/*
+ * SparkMiner - OTA Fetch (host)
+ * Runs the firmware's OTA download and verifier against an HTTP server
+ *
+ * The manifest and image go through src/ota/ota_image.cpp unchanged, over
+ * BSD sockets (net_posix.cpp) with the mbedTLS calls served by OpenSSL
+ * (mbedtls_host.cpp). The image is streamed into FILE.part, which stands
+ * in for the inactive app partition, and renamed to FILE only once the
+ * manifest signature, size and SHA-256 check out, as the board only
+ * switches its boot partition then. --running applies the board's
+ * version rule: only a strictly newer version is fetched.
+ *
+ * Usage: ota_fetch MANIFEST_URL --key PUBLIC_KEY.pem [--out FILE] [--running VERSION]
+ *   e.g. python3 -m http.server 8000 in the directory holding the
+ *   manifest written by scripts/ota_sign.py, then
+ *   ota_fetch http://127.0.0.1:8000/ota.json --key ota_public.pem --out fw.bin
+ * Exits with status 1 if the update does not verify.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "ota/ota_image.h"
+
+#define FETCH_KEY_MAX   4096
+
+typedef struct {
+    FILE *file;
+    uint32_t written;
+} file_sink_t;
+
+static bool writeFile(const uint8_t *data, size_t len, void *ctx) {
+    file_sink_t *sink = (file_sink_t *)ctx;
+    if (sink->file && fwrite(data, 1, len, sink->file) != len) {
+        Serial.println("[FETCH] Write failed");
+        return false;
+    }
+    sink->written += len;
+    return true;
+}
+
+static bool readKey(const char *path, char *out, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        Serial.printf("[FETCH] Cannot open %s\n", path);
+        return false;
+    }
+    size_t len = fread(out, 1, size - 1, f);
+    fclose(f);
+    out[len] = '\0';
+    return len > 0;
+}
+
+int main(int argc, char **argv) {
+    const char *manifestUrl = NULL;
+    const char *keyPath = NULL;
+    const char *outPath = NULL;
+    const char *running = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--key") && hasValue) keyPath = argv[++i];
+        else if (!strcmp(argv[i], "--out") && hasValue) outPath = argv[++i];
+        else if (!strcmp(argv[i], "--running") && hasValue) running = argv[++i];
+        else if (argv[i][0] != '-' && !manifestUrl) manifestUrl = argv[i];
+        else manifestUrl = NULL, i = argc;
+    }
+    if (!manifestUrl || !keyPath) {
+        fprintf(stderr, "Usage: %s MANIFEST_URL --key PUBLIC_KEY.pem [--out FILE] [--running VERSION]\n",
+                argv[0]);
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    static char key[FETCH_KEY_MAX];
+    if (!readKey(keyPath, key, sizeof(key))) return 1;
+
+    static ota_manifest_t manifest;
+    if (!ota_fetch_manifest(manifestUrl, key, &manifest)) return 1;
+    Serial.printf("[FETCH] %s for %s, %lu bytes from %s\n", manifest.version, manifest.board,
+                  (unsigned long)manifest.size, manifest.url);
+    if (running && !ota_version_newer(manifest.version, running)) {
+        Serial.printf("[FETCH] %s is not newer than %s, REJECTED\n", manifest.version, running);
+        return 1;
+    }
+
+    char partPath[512] = "";
+    file_sink_t sink = { NULL, 0 };
+    if (outPath) {
+        snprintf(partPath, sizeof(partPath), "%s.part", outPath);
+        sink.file = fopen(partPath, "wb");
+        if (!sink.file) {
+            Serial.printf("[FETCH] Cannot create %s\n", partPath);
+            return 1;
+        }
+    }
+
+    uint32_t start = millis();
+    bool ok = ota_fetch_image(&manifest, writeFile, &sink);
+    uint32_t elapsed = millis() - start;
+    if (sink.file) fclose(sink.file);
+
+    if (!ok) {
+        if (outPath) remove(partPath);
+        Serial.println("[FETCH] REJECTED");
+        return 1;
+    }
+    if (outPath && rename(partPath, outPath) != 0) {
+        Serial.printf("[FETCH] Cannot rename %s\n", partPath);
+        return 1;
+    }
+    Serial.printf("[FETCH] VERIFIED %lu bytes in %lu ms (%.0f KB/s)%s%s\n",
+                  (unsigned long)sink.written, (unsigned long)elapsed,
+                  elapsed ? sink.written / 1.024 / elapsed : 0.0,
+                  outPath ? " -> " : "", outPath ? outPath : "");
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * SparkMiner - Host SHA-256 Engine
+ * sha256_ll_* API for the sparkminer-linux daemon
+ *
+ * Miner1 drives the "hardware" LL API exactly as on the C3/S2: one
+ * midstate per job from pre-swapped header words, then one double hash
+ * per nonce. Here the hardware is the x86-64 SHA extensions when the CPU
+ * has them (detected once, at the first midstate); otherwise the software
+ * path that Miner0 uses. Both produce the miner_sha256_header() output
+ * layout and apply the same 16-bit early reject.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include "mining/miner_sha256.h"
+#include "mining/sha256_hw.h"
+#include "mining/sha256_ll.h"
+#include "mining/sha256_s3_dma.h"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define HOST_SHA_NI 1
+#else
+#define HOST_SHA_NI 0
+#endif
+
+// Message words as values (the LL API's pre-swapped layout)
+static const uint32_t s_tailPad[12] = {
+    0x80000000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x00000280    // 640 bits
+};
+
+// ============================================================
+// SHA Extensions
+// ============================================================
+
+#if HOST_SHA_NI
+
+static bool cpuHasShaNi() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1)) return false;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx & bit_SHA) != 0;
+}
+
+#define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+
+// Next four schedule words from the previous sixteen
+SHANI_TARGET static inline __m128i shaniSchedule(__m128i w0, __m128i w1, __m128i w2, __m128i w3) {
+    __m128i t = _mm_sha256msg1_epu32(w0, w1);
+    t = _mm_add_epi32(t, _mm_alignr_epi8(w3, w2, 4));
+    return _mm_sha256msg2_epu32(t, w3);
+}
+
+// One compression of sixteen message words (values) into state[8]
+SHANI_TARGET static void shaniCompress(uint32_t *state, const uint32_t *words) {
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);  // CDAB
+    __m128i s1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);   // EFGH
+    __m128i s0 = _mm_alignr_epi8(tmp, s1, 8);       // ABEF
+    s1 = _mm_blend_epi16(s1, tmp, 0xF0);            // CDGH
+    __m128i save0 = s0, save1 = s1;
+
+    __m128i w[4];
+    for (int i = 0; i < 4; i++) w[i] = _mm_loadu_si128((const __m128i *)&words[i * 4]);
+
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; i++) {
+        if (i >= 4) w[i & 3] = shaniSchedule(w[i & 3], w[(i + 1) & 3], w[(i + 2) & 3], w[(i + 3) & 3]);
+        __m128i msg = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i *)&SHA256_K[i * 4]));
+        s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+        s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0E));
+    }
+
+    s0 = _mm_add_epi32(s0, save0);
+    s1 = _mm_add_epi32(s1, save1);
+
+    tmp = _mm_shuffle_epi32(s0, 0x1B);              // FEBA
+    s1 = _mm_shuffle_epi32(s1, 0xB1);               // DCHG
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, s1, 0xF0));  // DCBA
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(s1, tmp, 8));     // HGFE
+}
+
+static void shaniMidstate(uint32_t *midstate, const uint8_t *header) {
+    uint32_t words[16];
+    memcpy(words, header, sizeof(words));
+    memcpy(midstate, SHA256_H0, 32);
+    shaniCompress(midstate, words);
+}
+
+static bool shaniDoubleHash(const uint32_t *midstate, const uint8_t *tail,
+                            uint32_t nonce, uint8_t *hash_out) {
+    uint32_t words[16];
+    uint32_t state[8];
+
+    // First hash: header tail + nonce on the midstate
+    memcpy(words, tail, 12);
+    words[3] = __builtin_bswap32(nonce);
+    memcpy(&words[4], s_tailPad, sizeof(s_tailPad));
+    memcpy(state, midstate, 32);
+    shaniCompress(state, words);
+
+    // Second hash: the 32-byte digest, padded
+    memcpy(words, state, 32);
+    words[8] = 0x80000000;
+    memset(&words[9], 0, 6 * sizeof(uint32_t));
+    words[15] = 0x00000100;     // 256 bits
+    memcpy(state, SHA256_H0, 32);
+    shaniCompress(state, words);
+
+    if (state[7] & 0xffff) return false;
+
+    for (int i = 0; i < 8; i++) state[i] = __builtin_bswap32(state[i]);
+    memcpy(hash_out, state, 32);
+    return true;
+}
+
+#endif // HOST_SHA_NI
+
+// ============================================================
+// Software Fallback (Miner0's BitsyMiner path)
+// ============================================================
+
+static void softMidstate(uint32_t *midstate, const uint8_t *header) {
+    block_header_t hb;
+    const uint32_t *words = (const uint32_t *)header;
+    uint32_t *out = (uint32_t *)&hb;
+    memset(&hb, 0, sizeof(hb));
+    for (int i = 0; i < 16; i++) out[i] = __builtin_bswap32(words[i]);
+
+    sha256_hash_t ms;
+    miner_sha256_midstate(&ms, &hb);
+    memcpy(midstate, ms.hash, sizeof(ms.hash));
+}
+
+static bool softDoubleHash(const uint32_t *midstate, const uint8_t *tail,
+                           uint32_t nonce, uint8_t *hash_out) {
+    block_header_t hb;
+    const uint32_t *words = (const uint32_t *)tail;
+    uint32_t *out = (uint32_t *)&hb;
+    for (int i = 0; i < 3; i++) out[16 + i] = __builtin_bswap32(words[i]);
+    hb.nonce = nonce;
+
+    sha256_hash_t ms, ctx;
+    memcpy(ms.hash, midstate, sizeof(ms.hash));
+    if (!miner_sha256_header(&ms, &ctx, &hb)) return false;
+    memcpy(hash_out, ctx.bytes, sizeof(ctx.bytes));
+    return true;
+}
+
+// ============================================================
+// Engine Selection
+// ============================================================
+
+typedef void (*midstate_fn)(uint32_t *midstate, const uint8_t *header);
+typedef bool (*double_hash_fn)(const uint32_t *midstate, const uint8_t *tail,
+                               uint32_t nonce, uint8_t *hash_out);
+
+static midstate_fn s_midstate = softMidstate;
+static double_hash_fn s_doubleHash = softDoubleHash;
+
+static bool selectEngine() {
+#if HOST_SHA_NI
+    if (cpuHasShaNi()) {
+        s_midstate = shaniMidstate;
+        s_doubleHash = shaniDoubleHash;
+        Serial.println("[SHA] Host engine: x86 SHA extensions");
+        return true;
+    }
+#endif
+    Serial.println("[SHA] Host engine: software (no SHA extensions)");
+    return true;
+}
+
+static void ensureEngine() {
+    static const bool selected = selectEngine();
+    (void)selected;
+}
+
+// ============================================================
+// LL API
+// ============================================================
+
+void sha256_ll_init(void) {
+    ensureEngine();
+}
+
+void sha256_ll_acquire(void) {
+}
+
+void sha256_ll_release(void) {
+}
+
+void sha256_ll_wait_idle(void) {
+}
+
+void sha256_ll_midstate(uint32_t *midstate, const uint8_t *header) {
+    ensureEngine();
+    s_midstate(midstate, header);
+}
+
+bool sha256_ll_double_hash(const uint32_t *midstate, const uint8_t *tail,
+                           uint32_t nonce, uint8_t *hash_out) {
+    return s_doubleHash(midstate, tail, nonce, hash_out);
+}
+
+bool sha256_ll_double_hash_full(const uint8_t *header, uint32_t nonce, uint8_t *hash_out) {
+    uint32_t midstate[8];
+    sha256_ll_midstate(midstate, header);
+    return s_doubleHash(midstate, header + 64, nonce, hash_out);
+}
+
+// No peripheral to bring up or DMA path to probe on the host
+void sha256_hw_init(void) {
+}
+
+void sha256_s3_dma_test(void) {
+}
@@ -0,0 +1,325 @@
+/*
+ * SparkMiner - SHA Register Path Check (host)
+ * Runs the firmware's register-level SHA code on the emulated peripheral
+ *
+ * sha256_ll.cpp (and on ESP32-S3 sha256_s3.cpp) are compiled unmodified
+ * against the host IDF shims; every register access lands in
+ * sha_periph. The golden header corpus is pushed through each path the
+ * way the miner tasks drive it:
+ *   IDF hal       reference: ESP-IDF's sha_hal sequence (hal/sha_hal.h)
+ *                 and mbedtls' digest byte order, no firmware code
+ *   IDF resume    reference (ESP32-S3): first block, another hash, then
+ *                 sha_hal_write_digest and CONTINUE, as mbedtls resumes
+ *   LL golden     fresh midstate per header, one double hash
+ *   LL nonce run  one midstate, then consecutive nonces up to the golden
+ *                 one (the Core 1 loop), so state left by earlier nonces
+ *                 must not leak into later ones
+ *   S3 verify     sha256_s3_midstate + sha256_s3_verify
+ *   S3 mine       sha256_s3_mine from a few nonces early; the golden nonce
+ *                 must be the one flagged
+ * Raising --busy makes operations take longer, exposing reads that do
+ * not wait for SHA_BUSY.
+ *
+ * The reference checks calibrate the emulator: IDF's own driver sequence
+ * has to produce the golden hashes under the chip's word order before a
+ * firmware failure means anything. Firmware defects the emulator has
+ * pinned down are listed in s_knownDefects and reported as KNOWN; a
+ * listed check that passes is an error, so the table stays current.
+ *
+ * Usage: sha_check [--busy N]
+ * Exit status is the number of unexpected results: failures not in
+ * s_knownDefects, and known defects that no longer fail.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <thread>
+#include "sha_periph.h"
+#include "hal/sha_hal.h"
+#include "sha/sha_dma.h"
+#include "mining/core_vectors.h"
+#include "mining/mining_core.h"
+#include "mining/sha256_ll.h"
+#include "mining/sha256_s3.h"
+
+#define CHECK_NONCE_LEAD    3       // Nonces run before the golden one
+#define CHECK_MAX_BLOCKS    2       // Padded 80-byte header
+
+/**
+ * A firmware defect the emulator reproduces
+ */
+typedef struct {
+    const char *check;
+    bool busyOnly;              // Only shows once operations take time (--busy > 0)
+    const char *defect;
+} known_defect_t;
+
+static const known_defect_t s_knownDefects[] = {
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    { "LL golden",    false, "sha256_ll.cpp's S3 branch writes header words and padding as "
+                             "values; the S3 engine takes message bytes" },
+    { "LL nonce run", false, "sha256_ll.cpp's S3 branch writes header words and padding as "
+                             "values; the S3 engine takes message bytes" },
+    { "S3 verify",    false, "sha256_s3_verify returns SHA_H in reverse word order; SHA_H[0] "
+                             "holds the first digest bytes" },
+    { "S3 mine",      false, "sha256_s3_mine tests the leading zeros in SHA_H[0]; they are "
+                             "the last digest bytes, in SHA_H[7]" },
+#endif
+    { NULL, false, NULL }
+};
+
+static uint32_t s_hashes = 0;       // Double hashes issued by the current check
+static uint32_t s_busy = 0;         // --busy
+
+static void swapHeaderWords(uint32_t *swapped, const block_header_t *hb) {
+    const uint32_t *words = (const uint32_t *)hb;
+    for (int i = 0; i < 20; i++) {
+        swapped[i] = __builtin_bswap32(words[i]);
+    }
+}
+
+// ============================================================
+// Reference Engines (IDF driver sequence)
+// ============================================================
+
+// SHA-256 padding into whole 64-byte blocks; returns the block count
+static size_t padMessage(uint32_t *blocks, const uint8_t *msg, size_t len) {
+    uint8_t *bytes = (uint8_t *)blocks;
+    size_t count = (len + 8) / 64 + 1;
+    uint64_t bits = (uint64_t)len * 8;
+
+    memset(bytes, 0, count * 64);
+    memcpy(bytes, msg, len);
+    bytes[len] = 0x80;
+    for (int i = 0; i < 8; i++) {
+        bytes[count * 64 - 1 - i] = (uint8_t)(bits >> (i * 8));
+    }
+    return count;
+}
+
+// Digest bytes from sha_hal_read_digest() state, as mbedtls stores them:
+// big-endian per word on ESP32, memcpy on ESP32-S3
+static void stateToDigest(uint8_t *digest, const uint32_t *state) {
+#if defined(CONFIG_IDF_TARGET_ESP32)
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4 + 0] = (uint8_t)(state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)state[i];
+    }
+#else
+    memcpy(digest, state, 32);
+#endif
+}
+
+static void idfSha256(uint8_t *digest, const uint8_t *msg, size_t len) {
+    uint32_t blocks[CHECK_MAX_BLOCKS * 16];
+    uint32_t state[SHA_HAL_SHA256_STATE_WORDS];
+    size_t count = padMessage(blocks, msg, len);
+
+    for (size_t b = 0; b < count; b++) {
+        sha_hal_hash_block(SHA2_256, &blocks[b * 16], 16, b == 0);
+    }
+    // esp_sha_read_digest_state() lets the last block finish before LOAD
+    sha_hal_wait_idle();
+    sha_hal_read_digest(SHA2_256, state);
+    stateToDigest(digest, state);
+}
+
+static bool engineIdfHal(const block_header_t *hb, sha256_hash_t *out) {
+    uint8_t first[32];
+    esp_sha_acquire_hardware();
+    idfSha256(first, (const uint8_t *)hb, sizeof(block_header_t));
+    idfSha256(out->bytes, first, sizeof(first));
+    esp_sha_release_hardware();
+    s_hashes++;
+    return true;
+}
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+// Another context takes the engine between the two header blocks; the
+// state read back and written again must carry on where it left off
+static bool engineIdfResume(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t blocks[CHECK_MAX_BLOCKS * 16];
+    uint32_t state[SHA_HAL_SHA256_STATE_WORDS];
+    uint8_t first[32];
+    size_t count = padMessage(blocks, (const uint8_t *)hb, sizeof(block_header_t));
+
+    esp_sha_acquire_hardware();
+    sha_hal_hash_block(SHA2_256, &blocks[0], 16, true);
+    sha_hal_wait_idle();
+    sha_hal_read_digest(SHA2_256, state);
+
+    // Unrelated hash leaves its own state in SHA_H
+    idfSha256(first, (const uint8_t *)"abc", 3);
+
+    sha_hal_wait_idle();
+    sha_hal_write_digest(SHA2_256, state);
+    for (size_t b = 1; b < count; b++) {
+        sha_hal_hash_block(SHA2_256, &blocks[b * 16], 16, false);
+    }
+    sha_hal_wait_idle();
+    sha_hal_read_digest(SHA2_256, state);
+    stateToDigest(first, state);
+
+    idfSha256(out->bytes, first, sizeof(first));
+    esp_sha_release_hardware();
+    s_hashes++;
+    return true;
+}
+#endif
+
+// ============================================================
+// Engines (same inputs as the miner passes)
+// ============================================================
+
+static bool engineLL(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t swapped[20];
+    uint32_t midstate[8];
+    swapHeaderWords(swapped, hb);
+
+    sha256_ll_acquire();
+    sha256_ll_midstate(midstate, (const uint8_t *)swapped);
+    bool passed = sha256_ll_double_hash(midstate, (const uint8_t *)&swapped[16], hb->nonce, out->bytes);
+    sha256_ll_release();
+    s_hashes++;
+    return passed;
+}
+
+static bool engineLLNonceRun(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t swapped[20];
+    uint32_t midstate[8];
+    swapHeaderWords(swapped, hb);
+
+    sha256_ll_acquire();
+    sha256_ll_midstate(midstate, (const uint8_t *)swapped);
+    bool passed = false;
+    for (uint32_t n = hb->nonce - CHECK_NONCE_LEAD; ; n++) {
+        passed = sha256_ll_double_hash(midstate, (const uint8_t *)&swapped[16], n, out->bytes);
+        s_hashes++;
+        if (n == hb->nonce) break;
+    }
+    sha256_ll_release();
+    return passed;
+}
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+// sha256_s3.cpp writes header bytes in message order (no word swap)
+static bool engineS3Verify(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t midstate[8];
+    esp_sha_acquire_hardware();
+    sha256_s3_midstate(midstate, (const uint8_t *)hb);
+    bool ok = sha256_s3_verify(midstate, (const uint8_t *)hb + 64, hb->nonce, out->bytes);
+    esp_sha_release_hardware();
+    s_hashes++;
+    return ok;
+}
+
+// The kernel only flags candidates; the hash comes from the software path,
+// as the mining task verifies them
+static bool engineS3Mine(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t midstate[8];
+    uint32_t nonce = hb->nonce - CHECK_NONCE_LEAD;
+    volatile uint64_t hashes = 0;
+    volatile bool mining = true;
+
+    // A missed golden nonce would run on for 64k hashes; stop shortly after it
+    std::atomic<bool> done(false);
+    std::thread stopper([&]() {
+        while (!done.load() && hashes <= CHECK_NONCE_LEAD + 1) std::this_thread::yield();
+        mining = false;
+    });
+
+    esp_sha_acquire_hardware();
+    sha256_s3_midstate(midstate, (const uint8_t *)hb);
+    bool candidate = sha256_s3_mine(midstate, (const uint8_t *)hb + 64, &nonce, &hashes, &mining);
+    esp_sha_release_hardware();
+
+    done = true;
+    stopper.join();
+    s_hashes += (uint32_t)hashes;
+
+    if (!candidate || nonce != hb->nonce) return false;
+    return core_engine_midstate(hb, out);
+}
+#endif
+
+// ============================================================
+// Report
+// ============================================================
+
+static const known_defect_t *findKnownDefect(const char *name) {
+    for (const known_defect_t *kd = s_knownDefects; kd->check; kd++) {
+        if (!strcmp(kd->check, name) && (!kd->busyOnly || s_busy > 0)) return kd;
+    }
+    return NULL;
+}
+
+static int runCheck(const char *name, core_engine_fn engine) {
+    sha_periph_reset_stats();
+    s_hashes = 0;
+    core_vectors_result_t res = core_vectors_check_engine(engine);
+
+    sha_periph_stats_t st;
+    sha_periph_get_stats(&st);
+    uint32_t hashes = s_hashes ? s_hashes : 1;
+
+    const known_defect_t *known = findKnownDefect(name);
+    if (res.failed == 0) {
+        Serial.printf("[SHA-EMU] %-14s %u/%u OK%s", name, res.run, res.run,
+                      known ? " (listed as a known defect)" : "");
+    } else {
+        Serial.printf("[SHA-EMU] %-14s %s %u/%u (first: %s)", name, known ? "KNOWN" : "FAILED",
+                      res.failed, res.run, res.firstFailure);
+    }
+    Serial.printf("  %.0f regs/hash, %.1f polls/hash\n",
+                  (double)st.accesses / hashes, (double)st.busyPolls / hashes);
+    if (st.textWritesBusy || st.resultReadsBusy || st.triggersBusy || st.unsupported) {
+        Serial.printf("[SHA-EMU] %-14s hazards: %lu data writes, %lu result reads, "
+                      "%lu triggers while busy; %lu unsupported\n", "",
+                      (unsigned long)st.textWritesBusy, (unsigned long)st.resultReadsBusy,
+                      (unsigned long)st.triggersBusy, (unsigned long)st.unsupported);
+    }
+    if (known) {
+        Serial.printf("[SHA-EMU] %-14s %s: %s\n", "",
+                      res.failed ? "known defect" : "fixed, remove from s_knownDefects", known->defect);
+    }
+    return (res.failed != 0) != (known != NULL) ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    sha_periph_config_t config = { 4 };
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--busy") && i + 1 < argc) {
+            config.busyAccesses = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--busy N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!sha_periph_init(&config)) return 2;
+    s_busy = config.busyAccesses;
+
+    // The reference first: if IDF's own sequence fails, the model is wrong
+    int failed = 0;
+    failed += runCheck("IDF hal", engineIdfHal);
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    failed += runCheck("IDF resume", engineIdfResume);
+#endif
+
+    sha256_ll_init();
+    failed += runCheck("LL golden", engineLL);
+    failed += runCheck("LL nonce run", engineLLNonceRun);
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    sha256_s3_init();
+    failed += runCheck("S3 verify", engineS3Verify);
+    failed += runCheck("S3 mine", engineS3Mine);
+#endif
+
+    Serial.printf("[SHA-EMU] %d unexpected result(s)\n", failed);
+    return failed;
+}
@@ -0,0 +1,384 @@
+/*
+ * SparkMiner - Emulated SHA Peripheral Implementation
+ *
+ * Every access to the register page takes two signals: SIGSEGV opens the
+ * page and sets the trap flag, the single-step SIGTRAP after the
+ * instruction closes it again. Trigger registers read back as 0, so a
+ * start is seen as a non-zero value after the step; wide stores the
+ * compiler emits for the non-volatile SHA_TEXT fills land in the page
+ * like any other write. Accesses are serialized by the SHA locks, as on
+ * the chip, so the emulator state is global.
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <mutex>
+#include "sha_periph.h"
+#include "soc/hwcrypto_reg.h"
+#include "sha/sha_dma.h"
+#if defined(CONFIG_IDF_TARGET_ESP32)
+#include "sha/sha_parallel_engine.h"
+#endif
+
+#if defined(__linux__) && defined(__x86_64__)
+#include <signal.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#endif
+
+#define PERIPH_PAGE_SIZE    4096
+#define PERIPH_SPAN_WORDS   64          // Registers live in the first 0x100 bytes
+
+// ============================================================
+// Register Layout
+// ============================================================
+
+#define REG_OFFSET(_r)      ((uint32_t)((_r) - DR_REG_SHA_BASE))
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+#define OFF_START           REG_OFFSET(SHA_256_START_REG)
+#define OFF_CONTINUE        REG_OFFSET(SHA_256_CONTINUE_REG)
+#define OFF_LOAD            REG_OFFSET(SHA_256_LOAD_REG)
+#define OFF_BUSY            REG_OFFSET(SHA_256_BUSY_REG)
+#define OFF_TEXT            REG_OFFSET(SHA_TEXT_BASE)
+
+// SHA_TEXT is both input and (after LOAD) output
+static inline bool isDataReg(uint32_t off) { return off < 0x80; }
+// SHA-1/384/512 trigger registers
+static inline bool isOtherTrigger(uint32_t off) {
+    return off >= 0x80 && off < 0xC0 && (off & 0x0F) != 0x0C &&
+           (off < OFF_START || off > OFF_LOAD);
+}
+#else
+#define OFF_MODE            REG_OFFSET(SHA_MODE_REG)
+#define OFF_START           REG_OFFSET(SHA_START_REG)
+#define OFF_CONTINUE        REG_OFFSET(SHA_CONTINUE_REG)
+#define OFF_BUSY            REG_OFFSET(SHA_BUSY_REG)
+#define OFF_H               REG_OFFSET(SHA_H_BASE)
+#define OFF_TEXT            REG_OFFSET(SHA_TEXT_BASE)
+
+static inline bool isDataReg(uint32_t off) { return off >= OFF_H; }
+static inline bool isOtherTrigger(uint32_t off) {
+    return off == REG_OFFSET(SHA_DMA_START_REG) || off == REG_OFFSET(SHA_DMA_CONTINUE_REG);
+}
+#endif
+
+typedef enum {
+    OP_NONE = 0,
+    OP_START,
+    OP_CONTINUE,
+    OP_LOAD
+} sha_op_t;
+
+static sha_periph_config_t s_config;
+static sha_periph_stats_t s_stats;
+static volatile uint32_t *s_regs = NULL;
+
+static sha_op_t s_op = OP_NONE;         // Operation in flight
+static uint32_t s_opResult[8];          // Its result, committed on completion
+static uint32_t s_opRemaining = 0;      // Accesses until it completes
+#if defined(CONFIG_IDF_TARGET_ESP32)
+static uint32_t s_state[8];             // Internal state, not software visible
+#endif
+
+// ============================================================
+// SHA-256 Compression
+// ============================================================
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static inline uint32_t ror(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+static void compress(uint32_t *state, const uint32_t *block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) w[i] = block[i];
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+// ============================================================
+// Operations
+// ============================================================
+
+static void completeOp() {
+#if defined(CONFIG_IDF_TARGET_ESP32)
+    if (s_op == OP_LOAD) {
+        for (int i = 0; i < 8; i++) s_regs[OFF_TEXT / 4 + i] = s_opResult[i];
+    } else {
+        memcpy(s_state, s_opResult, sizeof(s_state));
+    }
+#else
+    for (int i = 0; i < 8; i++) s_regs[OFF_H / 4 + i] = __builtin_bswap32(s_opResult[i]);
+#endif
+    s_op = OP_NONE;
+}
+
+static void trigger(sha_op_t op) {
+    if (s_op != OP_NONE) completeOp();
+
+    uint32_t block[16];
+#if defined(CONFIG_IDF_TARGET_ESP32)
+    // Message words are the register values
+    for (int i = 0; i < 16; i++) block[i] = s_regs[OFF_TEXT / 4 + i];
+
+    if (op == OP_START) {
+        memcpy(s_opResult, IV, sizeof(s_opResult));
+        compress(s_opResult, block);
+    } else if (op == OP_CONTINUE) {
+        memcpy(s_opResult, s_state, sizeof(s_opResult));
+        compress(s_opResult, block);
+    } else {
+        memcpy(s_opResult, s_state, sizeof(s_opResult));
+    }
+#else
+    if (s_regs[OFF_MODE / 4] != SHA2_256) {
+        s_stats.unsupported++;
+        return;
+    }
+
+    // Registers hold message bytes in order: read as LE words, then swap
+    for (int i = 0; i < 16; i++) block[i] = __builtin_bswap32(s_regs[OFF_TEXT / 4 + i]);
+
+    if (op == OP_START) {
+        memcpy(s_opResult, IV, sizeof(s_opResult));
+    } else {
+        for (int i = 0; i < 8; i++) s_opResult[i] = __builtin_bswap32(s_regs[OFF_H / 4 + i]);
+    }
+    compress(s_opResult, block);
+#endif
+
+    if (op == OP_START) s_stats.starts++;
+    else if (op == OP_CONTINUE) s_stats.continues++;
+    else s_stats.loads++;
+
+    s_op = op;
+    s_opRemaining = s_config.busyAccesses;
+    if (s_opRemaining == 0) completeOp();
+}
+
+// Page is open; runs before the faulting instruction executes
+static void beforeAccess(uint32_t off, bool write) {
+    s_stats.accesses++;
+
+    bool inFlight = false;
+    if (s_op != OP_NONE) {
+        if (s_opRemaining == 0) {
+            completeOp();
+        } else {
+            s_opRemaining--;
+            inFlight = true;
+        }
+    }
+    s_regs[OFF_BUSY / 4] = inFlight ? 1 : 0;
+
+    if (!inFlight) return;
+    if (!write && off == OFF_BUSY) s_stats.busyPolls++;
+    if (isDataReg(off)) {
+        if (write) s_stats.textWritesBusy++;
+        else s_stats.resultReadsBusy++;
+    }
+    if (write && (off == OFF_START || off == OFF_CONTINUE
+#if defined(CONFIG_IDF_TARGET_ESP32)
+                  || off == OFF_LOAD
+#endif
+                  )) {
+        s_stats.triggersBusy++;
+    }
+}
+
+// Page is open; runs after the instruction wrote its value(s)
+static void afterWrite() {
+    static const struct { uint32_t off; sha_op_t op; } triggers[] = {
+        { OFF_START, OP_START },
+        { OFF_CONTINUE, OP_CONTINUE },
+#if defined(CONFIG_IDF_TARGET_ESP32)
+        { OFF_LOAD, OP_LOAD },
+#endif
+    };
+    for (size_t i = 0; i < sizeof(triggers) / sizeof(triggers[0]); i++) {
+        uint32_t v = s_regs[triggers[i].off / 4];
+        if (v == 0) continue;
+        s_regs[triggers[i].off / 4] = 0;
+        if (v & 1) trigger(triggers[i].op);
+    }
+
+    for (uint32_t off = 0; off < PERIPH_SPAN_WORDS * 4; off += 4) {
+        if (isOtherTrigger(off) && s_regs[off / 4] != 0) {
+            s_regs[off / 4] = 0;
+            s_stats.unsupported++;
+        }
+    }
+}
+
+// ============================================================
+// Trap Handlers
+// ============================================================
+
+#if defined(__linux__) && defined(__x86_64__)
+
+#define X86_EFLAGS_TF       0x100
+#define X86_PF_WRITE        0x2
+
+static struct sigaction s_prevSegv;
+static struct sigaction s_prevTrap;
+static thread_local bool t_stepping = false;
+static thread_local bool t_stepWrite = false;
+
+static void chain(int sig, siginfo_t *info, void *ctx, const struct sigaction *prev) {
+    if (prev->sa_flags & SA_SIGINFO) {
+        prev->sa_sigaction(sig, info, ctx);
+    } else if (prev->sa_handler != SIG_DFL && prev->sa_handler != SIG_IGN) {
+        prev->sa_handler(sig);
+    } else {
+        // Default action: a fault re-executes and dies, a trap is re-raised
+        signal(sig, SIG_DFL);
+        if (sig == SIGTRAP) raise(sig);
+    }
+}
+
+static void onSegv(int sig, siginfo_t *info, void *ctx) {
+    uintptr_t addr = (uintptr_t)info->si_addr;
+    if (t_stepping || addr < DR_REG_SHA_BASE || addr >= DR_REG_SHA_BASE + PERIPH_PAGE_SIZE) {
+        chain(sig, info, ctx, &s_prevSegv);
+        return;
+    }
+
+    ucontext_t *uc = (ucontext_t *)ctx;
+    bool write = (uc->uc_mcontext.gregs[REG_ERR] & X86_PF_WRITE) != 0;
+
+    mprotect((void *)s_regs, PERIPH_PAGE_SIZE, PROT_READ | PROT_WRITE);
+    beforeAccess((uint32_t)(addr - DR_REG_SHA_BASE) & ~3u, write);
+
+    t_stepping = true;
+    t_stepWrite = write;
+    uc->uc_mcontext.gregs[REG_EFL] |= X86_EFLAGS_TF;
+}
+
+static void onTrap(int sig, siginfo_t *info, void *ctx) {
+    if (!t_stepping) {
+        chain(sig, info, ctx, &s_prevTrap);
+        return;
+    }
+
+    if (t_stepWrite) afterWrite();
+    mprotect((void *)s_regs, PERIPH_PAGE_SIZE, PROT_NONE);
+
+    t_stepping = false;
+    ucontext_t *uc = (ucontext_t *)ctx;
+    uc->uc_mcontext.gregs[REG_EFL] &= ~X86_EFLAGS_TF;
+}
+
+bool sha_periph_init(const sha_periph_config_t *config) {
+    s_config = *config;
+    memset(&s_stats, 0, sizeof(s_stats));
+
+    void *page = mmap((void *)(uintptr_t)DR_REG_SHA_BASE, PERIPH_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (page != (void *)(uintptr_t)DR_REG_SHA_BASE) {
+        Serial.printf("[SHA-EMU] ERROR: Cannot map registers at 0x%08x\n", (unsigned)DR_REG_SHA_BASE);
+        if (page != MAP_FAILED) munmap(page, PERIPH_PAGE_SIZE);
+        return false;
+    }
+    s_regs = (volatile uint32_t *)page;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_sigaction = onSegv;
+    sigaction(SIGSEGV, &sa, &s_prevSegv);
+    sa.sa_sigaction = onTrap;
+    sigaction(SIGTRAP, &sa, &s_prevTrap);
+
+    mprotect(page, PERIPH_PAGE_SIZE, PROT_NONE);
+
+    Serial.printf("[SHA-EMU] %s SHA registers at 0x%08x, busy for %lu accesses\n",
+#if defined(CONFIG_IDF_TARGET_ESP32)
+                  "ESP32",
+#else
+                  "ESP32-S3",
+#endif
+                  (unsigned)DR_REG_SHA_BASE, (unsigned long)s_config.busyAccesses);
+    return true;
+}
+
+#else
+
+bool sha_periph_init(const sha_periph_config_t *config) {
+    (void)config;
+    Serial.println("[SHA-EMU] ERROR: Register trapping needs Linux on x86-64");
+    return false;
+}
+
+#endif
+
+// ============================================================
+// Public API
+// ============================================================
+
+void sha_periph_get_stats(sha_periph_stats_t *stats) {
+    *stats = s_stats;
+}
+
+void sha_periph_reset_stats(void) {
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+// ============================================================
+// ESP-IDF Locks
+// ============================================================
+
+static std::mutex s_hwLock;
+
+void esp_sha_acquire_hardware(void) {
+    s_hwLock.lock();
+}
+
+void esp_sha_release_hardware(void) {
+    s_hwLock.unlock();
+}
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+void esp_sha_lock_engine(esp_sha_type sha_type) {
+    (void)sha_type;
+    s_hwLock.lock();
+}
+
+bool esp_sha_try_lock_engine(esp_sha_type sha_type) {
+    (void)sha_type;
+    return s_hwLock.try_lock();
+}
+
+void esp_sha_unlock_engine(esp_sha_type sha_type) {
+    (void)sha_type;
+    s_hwLock.unlock();
+}
+#endif
@@ -0,0 +1,711 @@
+/*
+ * SparkMiner - Stratum Session Replay (host)
+ * Drives the firmware's stratum client through a recorded pool session
+ *
+ * Input is a stratum_rec.h recording: an SD card /stratum.rec or a serial
+ * log with [REC] lines. The stratum task is the firmware source, running
+ * on the simulated cores (freertos_sim.cpp) against an in-process link
+ * (wifi_host.cpp). A replay task plays the pool:
+ *
+ * - received lines are fed at their recorded offsets (times --scale) from
+ *   the previous event, so causality is kept even when the client is
+ *   slower or faster than the original
+ * - sent lines are awaited in order; one stratum loop before a submit's
+ *   recorded send time the miner's share check is run on the header the
+ *   client would hash now (its current job and extranonce2, or one of the
+ *   next REPLAY_EN2_ROLLS extranonce2 values the scheduler rolls to) at the
+ *   recorded nonce, so only a hash that meets the share target the client
+ *   holds is queued, with job id, extranonce2 and ntime of its own making
+ * - connects are accepted or refused as recorded, closes close the link
+ * - the device's one random input that shows in its output, the starting
+ *   extranonce2 of a job, is repeated: as a notify is fed, the extranonce2
+ *   of the job's first recorded submit becomes the client's next
+ *   esp_random() draw (host_random_push)
+ * - response ids are remapped when the client numbers its requests
+ *   differently, so accept/reject accounting still lines up
+ *
+ * The run fails unless every recorded mining.submit is sent again with
+ * identical parameters and none of the recorded nonces misses the share
+ * target on the client's job. Other sent lines that differ (client version in
+ * mining.subscribe, keepalives moved by --scale) are warnings, or failures
+ * with --strict. Job-switch latency is measured from the notify reaching
+ * the link to miner_start_job(); a submit is stale when its job was
+ * cleared by a clean_jobs notify before it was sent. --json writes these
+ * in the core_bench layout for scripts/bench_compare.py (stale submits
+ * are reported in the time column so that increases are flagged).
+ *
+ * Usage: stratum_replay RECORDING [--session N] [--scale F] [--speed X]
+ *                       [--strict] [--verbose] [--json FILE]
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <esp_task_wdt.h>
+#include <board_config.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim_sched.h"
+#include "host_net.h"
+#include "mining/miner.h"
+#include "mining/mining_core.h"
+#include "stratum/stratum.h"
+#include "stratum/stratum_rec.h"
+
+#define REPLAY_SUBMIT_LEAD_MS   100     // One stratum loop: queued before the recorded send
+#define REPLAY_WAIT_MS          15000   // Extra wait for an awaited send or connect
+#define REPLAY_GRACE_MS         2000    // Wait after the last event
+#define REPLAY_TASK_PRIORITY    (STRATUM_PRIORITY + 1)
+#define REPLAY_CORE             CORE_1  // No miner tasks: the pool gets its own core
+#define REPLAY_MAX_LINE         4096
+#define REPLAY_EN2_ROLLS        64      // Extranonce2 values past the job's first a recorded share may use
+
+typedef struct {
+    uint32_t deltaMs;           // Since the previous record
+    char tag;
+    std::string payload;
+    size_t lineNo;              // In the recording
+} rec_event_t;
+
+typedef struct {
+    HostLinkPtr link;
+    std::string rx;
+} replay_conn_t;
+
+typedef struct {
+    std::string line;
+    uint32_t ms;
+} sent_line_t;
+
+static const char *s_path = NULL;
+static int s_session = 1;
+static double s_scale = 1.0;
+static double s_speed = 10.0;
+static bool s_strict = false;
+static bool s_verbose = false;
+static const char *s_jsonPath = NULL;
+
+static std::vector<rec_event_t> s_events;
+
+// Shared between the replay task, the stratum task (accept, job hook) and main
+static std::mutex s_lock;
+static std::vector<char> s_connectPlan;             // '@' accept / '?' refuse, in order
+static size_t s_connectCalls = 0;
+static std::vector<replay_conn_t> s_conns;          // Open links, newest last
+static std::vector<sent_line_t> s_sent;             // Lines the client sent
+static std::map<std::string, uint32_t> s_notifyMs;  // Job id -> time fed
+static std::set<std::string> s_validJobs;           // Jobs a submit may still reference
+static std::vector<uint32_t> s_switchMs;            // Job-switch latencies
+static stratum_job_t s_job;                         // Client's current job, as the miner got it
+static uint32_t s_jobExtraNonce2 = 0;
+static int s_jobExtraNonce2Size = 0;
+static bool s_hasJob = false;
+static volatile bool s_done = false;
+
+// Results
+static uint32_t s_linesFed = 0;
+static uint32_t s_linesDropped = 0;     // Received lines with no open link
+static uint32_t s_missing = 0;          // Awaited sends or connects that timed out
+static uint32_t s_notifies = 0;
+static uint32_t s_staleSubmits = 0;
+static uint32_t s_submitsInjected = 0;
+static uint32_t s_sharesMissed = 0;     // Recorded nonces that miss the target on the client's job
+
+// ============================================================
+// Recording
+// ============================================================
+
+static bool parseRecording(const char *path, int session) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+
+    static char line[REPLAY_MAX_LINE + 64];
+    int current = 0;
+    size_t lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        line[strcspn(line, "\r\n")] = '\0';
+
+        // Serial logs carry other output; recordings on SD are bare
+        const char *rec = strstr(line, STRATUM_REC_PREFIX);
+        rec = rec ? rec + strlen(STRATUM_REC_PREFIX) : line;
+
+        if (!strncmp(rec, STRATUM_REC_HEADER, strlen(STRATUM_REC_HEADER))) {
+            int format = atoi(rec + strlen(STRATUM_REC_HEADER));
+            if (format != STRATUM_REC_FORMAT) {
+                fprintf(stderr, "%s:%zu: unsupported format %d\n", path, lineNo, format);
+                fclose(f);
+                return false;
+            }
+            current++;
+            continue;
+        }
+        if (current != session || !isdigit((unsigned char)rec[0])) continue;
+
+        char *tag;
+        unsigned long delta = strtoul(rec, &tag, 10);
+        if (!strchr("<>@?!", *tag) || *tag == '\0') continue;
+        s_events.push_back({(uint32_t)delta, *tag, std::string(tag + 1), lineNo});
+    }
+    fclose(f);
+
+    if (s_events.empty()) {
+        fprintf(stderr, "%s: no records in session %d (%d sessions)\n", path, session, current);
+        return false;
+    }
+    return true;
+}
+
+static bool splitHostPort(const std::string &target, std::string *host, int *port) {
+    size_t colon = target.rfind(':');
+    if (colon == std::string::npos) return false;
+    *host = target.substr(0, colon);
+    *port = atoi(target.c_str() + colon + 1);
+    return *port > 0;
+}
+
+static bool isSubmit(const std::string &line) {
+    return line.find("\"mining.submit\"") != std::string::npos;
+}
+
+// Extranonce2 of the first submit for a job recorded after event 'from'
+static bool recordedExtraNonce2(size_t from, const char *jobId, uint32_t *out) {
+    DynamicJsonDocument doc(1024);
+    for (size_t i = from; i < s_events.size(); i++) {
+        const rec_event_t &e = s_events[i];
+        if (e.tag != STRATUM_REC_TX || !isSubmit(e.payload) || deserializeJson(doc, e.payload)) continue;
+        if (strcmp(doc["params"][1] | "", jobId) != 0) continue;
+        *out = strtoul(doc["params"][2] | "0", NULL, 16);
+        return true;
+    }
+    return false;
+}
+
+
+// Pools and credentials as the device had them configured
+static bool configurePools() {
+    std::string primary, backup;
+    for (const rec_event_t &e : s_events) {
+        if (e.tag != STRATUM_REC_CONNECT && e.tag != STRATUM_REC_CONNECT_FAIL) continue;
+        if (primary.empty()) primary = e.payload;
+        else if (e.payload != primary) {
+            backup = e.payload;
+            break;
+        }
+    }
+    if (primary.empty()) {
+        fprintf(stderr, "Recording has no connect record\n");
+        return false;
+    }
+
+    // Submits carry the bare wallet, authorize carries wallet.worker
+    std::string wallet, worker, password = DEFAULT_POOL_PASS;
+    DynamicJsonDocument doc(REPLAY_MAX_LINE);
+    for (const rec_event_t &e : s_events) {
+        if (e.tag != STRATUM_REC_TX || deserializeJson(doc, e.payload)) continue;
+        const char *method = doc["method"] | "";
+        if (!strcmp(method, "mining.authorize") && worker.empty()) {
+            std::string user = doc["params"][0] | "";
+            size_t dot = user.find('.');
+            if (wallet.empty()) wallet = user.substr(0, dot);
+            if (dot != std::string::npos) worker = user.substr(dot + 1);
+            password = doc["params"][1] | DEFAULT_POOL_PASS;
+        } else if (!strcmp(method, "mining.submit")) {
+            wallet = doc["params"][0] | "";
+            break;
+        }
+    }
+    if (wallet.empty()) wallet = "replay";
+
+    std::string host;
+    int port;
+    if (!splitHostPort(primary, &host, &port)) return false;
+    stratum_set_pool(host.c_str(), port, wallet.c_str(), password.c_str(), worker.c_str());
+    printf("[REPLAY] Pool %s, wallet %s, worker %s\n", primary.c_str(), wallet.c_str(),
+           worker.empty() ? "(none)" : worker.c_str());
+
+    if (!backup.empty() && splitHostPort(backup, &host, &port)) {
+        stratum_set_backup_pool(host.c_str(), port, wallet.c_str(), password.c_str(), worker.c_str());
+        printf("[REPLAY] Backup pool %s\n", backup.c_str());
+    }
+    return true;
+}
+
+// ============================================================
+// Client Hooks
+// ============================================================
+
+static HostLinkPtr acceptConnection(const char *host, uint16_t port) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    size_t call = s_connectCalls++;
+    if (call >= s_connectPlan.size() || s_connectPlan[call] != STRATUM_REC_CONNECT) {
+        if (s_verbose) printf("[REPLAY] %6lu ms  refuse %s:%u\n", (unsigned long)millis(), host, port);
+        return NULL;
+    }
+    replay_conn_t conn;
+    conn.link = std::make_shared<HostLink>(0);
+    s_conns.push_back(conn);
+    if (s_verbose) printf("[REPLAY] %6lu ms  accept %s:%u\n", (unsigned long)millis(), host, port);
+    return conn.link;
+}
+
+static void onJob(const stratum_job_t *job, uint32_t extraNonce2, int extraNonce2Size) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    s_job = *job;
+    s_jobExtraNonce2 = extraNonce2;
+    s_jobExtraNonce2Size = extraNonce2Size;
+    s_hasJob = true;
+    auto fed = s_notifyMs.find(job->jobId);
+    if (fed != s_notifyMs.end()) {
+        s_switchMs.push_back(millis() - fed->second);
+        s_notifyMs.erase(fed);
+    }
+    if (job->cleanJobs) s_validJobs.clear();
+    s_validJobs.insert(job->jobId);
+}
+
+// ============================================================
+// Pool Side
+// ============================================================
+
+// Move client output into s_sent; drop links the client has closed
+static void pumpClient() {
+    std::lock_guard<std::mutex> lg(s_lock);
+    uint32_t now = millis();
+    for (size_t i = 0; i < s_conns.size();) {
+        replay_conn_t &conn = s_conns[i];
+        int c;
+        while ((c = conn.link->read(true, now)) >= 0) {
+            if (c != '\n') {
+                conn.rx += (char)c;
+                continue;
+            }
+            if (isSubmit(conn.rx)) {
+                // Stale if a clean_jobs notify reached the miner after its job
+                DynamicJsonDocument doc(1024);
+                if (!deserializeJson(doc, conn.rx) && !s_validJobs.count(doc["params"][1] | "")) {
+                    s_staleSubmits++;
+                }
+            }
+            s_sent.push_back({conn.rx, now});
+            if (s_verbose) printf("[REPLAY] %6lu ms  > %s\n", (unsigned long)now, conn.rx.c_str());
+            conn.rx.clear();
+        }
+        if (conn.link->closed()) s_conns.erase(s_conns.begin() + i);
+        else i++;
+    }
+}
+
+static bool writeToClient(const std::string &line) {
+    std::lock_guard<std::mutex> lg(s_lock);
+    if (s_conns.empty()) return false;
+    std::string msg = line + "\n";
+    s_conns.back().link->write(false, msg.data(), msg.size(), millis());
+    return true;
+}
+
+static void closeNewest() {
+    std::lock_guard<std::mutex> lg(s_lock);
+    if (s_conns.empty()) return;
+    s_conns.back().link->close();
+    s_conns.pop_back();
+}
+
+// Request id of a line, 0 if it has none
+static uint32_t jsonId(const std::string &line) {
+    size_t pos = line.find("\"id\"");
+    if (pos == std::string::npos) return 0;
+    pos = line.find_first_not_of(" \t:", pos + 4);
+    return pos == std::string::npos ? 0 : strtoul(line.c_str() + pos, NULL, 10);
+}
+
+// Responses follow the ids the client used this time; the rest of the
+// line is fed byte for byte
+static std::string remapResponse(const std::string &line, const std::map<uint32_t, uint32_t> &ids) {
+    if (ids.empty() || line.find("\"method\"") != std::string::npos) return line;
+    uint32_t id = jsonId(line);
+    auto mapped = ids.find(id);
+    if (id == 0 || mapped == ids.end() || mapped->second == id) return line;
+
+    size_t start = line.find_first_not_of(" \t:", line.find("\"id\"") + 4);
+    size_t end = line.find_first_not_of("0123456789", start);
+    return line.substr(0, start) + std::to_string(mapped->second) + line.substr(end);
+}
+
+// Notifies fed that have not reached miner_start_job() yet
+static bool notifiesPending() {
+    std::lock_guard<std::mutex> lg(s_lock);
+    return !s_notifyMs.empty();
+}
+
+// Queue the share the client finds at a recorded nonce: the header is built
+// from the client's own job state, and the miner's check against its pool
+// target decides whether anything is submitted
+static void injectSubmit(const rec_event_t &e) {
+    DynamicJsonDocument doc(1024);
+    if (deserializeJson(doc, e.payload)) return;
+    uint32_t nonce = strtoul(doc["params"][4] | "0", NULL, 16);
+
+    static stratum_job_t job;
+    uint32_t firstEn2;
+    int en2Size;
+    {
+        std::lock_guard<std::mutex> lg(s_lock);
+        if (!s_hasJob) {
+            printf("[REPLAY] FAIL: line %zu submits before the client has a job\n", e.lineNo);
+            s_sharesMissed++;
+            return;
+        }
+        job = s_job;
+        firstEn2 = s_jobExtraNonce2;
+        en2Size = s_jobExtraNonce2Size;
+    }
+
+    // The scheduler may have rolled extranonce2 before the share was found
+    uint32_t shares = miner_get_stats()->shares;
+    for (uint32_t roll = 0; roll < REPLAY_EN2_ROLLS; roll++) {
+        uint32_t en2 = firstEn2 + roll;
+        if (en2Size < 4) en2 &= (1u << (8 * en2Size)) - 1;
+
+        block_header_t hb;
+        if (!core_build_header(&hb, &job, en2, en2Size)) break;
+        hb.nonce = nonce;
+        sha256_hash_t hash;
+        core_sha256d(&hash, (const uint8_t *)&hb, sizeof(hb));
+
+        // Same 16-bit early reject as the mining kernels before the pool target check
+        if (hash.bytes[31] || hash.bytes[30]) continue;
+        miner_check_hash(job.jobId, en2, &hash, hb.timestamp, nonce);
+        if (miner_get_stats()->shares != shares) {
+            s_submitsInjected++;
+            return;
+        }
+    }
+    printf("[REPLAY] FAIL: line %zu nonce %08lx misses the share target on job %s\n",
+           e.lineNo, (unsigned long)nonce, job.jobId);
+    s_sharesMissed++;
+}
+
+static void replayTask(void *param) {
+    (void)param;
+    std::map<uint32_t, uint32_t> ids;       // Recorded request id -> id sent this time
+    size_t txExpected = 0, connectsExpected = 0;
+    size_t ev = 0;
+    bool injected = false;
+    uint32_t anchor = millis();
+
+    while (ev < s_events.size()) {
+        pumpClient();
+        const rec_event_t &e = s_events[ev];
+        uint32_t now = millis();
+        uint32_t due = anchor + (uint32_t)(e.deltaMs * s_scale);
+        bool next = false;
+
+        switch (e.tag) {
+        case STRATUM_REC_RX:
+            if ((int32_t)(now - due) < 0) break;
+            if (e.payload.find("\"mining.notify\"") != std::string::npos) {
+                // Subscribe results name mining.notify too; only count the method
+                static DynamicJsonDocument doc(REPLAY_MAX_LINE * 2);
+                if (!deserializeJson(doc, e.payload) && !strcmp(doc["method"] | "", "mining.notify")) {
+                    const char *jobId = doc["params"][0] | "";
+                    uint32_t en2;
+                    if (recordedExtraNonce2(ev + 1, jobId, &en2)) host_random_push(en2);
+                    std::lock_guard<std::mutex> lg(s_lock);
+                    s_notifyMs[jobId] = now;
+                    s_notifies++;
+                }
+            }
+            if (writeToClient(remapResponse(e.payload, ids))) s_linesFed++;
+            else s_linesDropped++;
+            next = true;
+            break;
+
+        case STRATUM_REC_TX: {
+            // The share is looked for on the job the client holds once it has taken every notify fed
+            if (isSubmit(e.payload) && !injected &&
+                (int32_t)(now - (due - REPLAY_SUBMIT_LEAD_MS)) >= 0 &&
+                (!notifiesPending() || (int32_t)(now - (due + REPLAY_WAIT_MS)) >= 0)) {
+                injectSubmit(e);
+                injected = true;
+            }
+            size_t sent;
+            std::string got;
+            {
+                std::lock_guard<std::mutex> lg(s_lock);
+                sent = s_sent.size();
+                if (sent > txExpected) got = s_sent[txExpected].line;
+            }
+            if (sent > txExpected) {
+                uint32_t recId = jsonId(e.payload), gotId = jsonId(got);
+                if (recId && gotId) ids[recId] = gotId;
+                txExpected++;
+                next = true;
+            } else if ((int32_t)(now - (due + REPLAY_WAIT_MS)) >= 0) {
+                printf("[REPLAY] WARNING: line %zu never sent: %.80s\n", e.lineNo, e.payload.c_str());
+                s_missing++;
+                txExpected++;
+                next = true;
+            }
+            break;
+        }
+
+        case STRATUM_REC_CONNECT:
+        case STRATUM_REC_CONNECT_FAIL: {
+            size_t calls;
+            {
+                std::lock_guard<std::mutex> lg(s_lock);
+                calls = s_connectCalls;
+            }
+            if (calls > connectsExpected) {
+                connectsExpected++;
+                next = true;
+            } else if ((int32_t)(now - (due + REPLAY_WAIT_MS)) >= 0) {
+                printf("[REPLAY] WARNING: line %zu connect to %s never attempted\n",
+                       e.lineNo, e.payload.c_str());
+                s_missing++;
+                connectsExpected++;
+                next = true;
+            }
+            break;
+        }
+
+        case STRATUM_REC_CLOSE:
+            if ((int32_t)(now - due) < 0) break;
+            closeNewest();
+            next = true;
+            break;
+        }
+
+        if (next) {
+            anchor = now;
+            injected = false;
+            ev++;
+        } else {
+            vTaskDelay(1);
+        }
+    }
+
+    // Let the client finish what the last records started
+    while (millis() - anchor < REPLAY_GRACE_MS) {
+        pumpClient();
+        vTaskDelay(1);
+    }
+    s_done = true;
+    vTaskDelete(NULL);
+}
+
+// ============================================================
+// Report
+// ============================================================
+
+typedef struct {
+    uint32_t submits;
+    uint32_t submitsMatched;
+    uint32_t submitsIdShifted;  // Same parameters, different request id
+    uint32_t others;
+    uint32_t othersDiffer;
+    uint32_t accepted;
+    uint32_t rejected;
+} compare_t;
+
+static std::string paramsOf(const std::string &line) {
+    size_t p = line.find("\"params\"");
+    return p == std::string::npos ? line : line.substr(p);
+}
+
+static compare_t compareSends() {
+    compare_t c;
+    memset(&c, 0, sizeof(c));
+
+    std::vector<std::string> recSubmits, gotSubmits, recOthers, gotOthers;
+    std::set<uint32_t> submitIds;
+    for (const rec_event_t &e : s_events) {
+        if (e.tag != STRATUM_REC_TX) continue;
+        if (isSubmit(e.payload)) {
+            recSubmits.push_back(e.payload);
+            submitIds.insert(jsonId(e.payload));
+        } else {
+            recOthers.push_back(e.payload);
+        }
+    }
+    for (const sent_line_t &s : s_sent) {
+        (isSubmit(s.line) ? gotSubmits : gotOthers).push_back(s.line);
+    }
+
+    // Pool verdicts in the recording
+    DynamicJsonDocument doc(1024);
+    for (const rec_event_t &e : s_events) {
+        if (e.tag != STRATUM_REC_RX || e.payload.find("\"method\"") != std::string::npos) continue;
+        if (!submitIds.count(jsonId(e.payload)) || deserializeJson(doc, e.payload)) continue;
+        if (doc["result"] | false) c.accepted++;
+        else c.rejected++;
+    }
+
+    c.submits = recSubmits.size();
+    for (size_t i = 0; i < recSubmits.size(); i++) {
+        if (i >= gotSubmits.size()) {
+            printf("[REPLAY] FAIL: submit %zu not sent: %s\n", i + 1, recSubmits[i].c_str());
+            continue;
+        }
+        if (recSubmits[i] == gotSubmits[i]) {
+            c.submitsMatched++;
+        } else if (paramsOf(recSubmits[i]) == paramsOf(gotSubmits[i])) {
+            c.submitsMatched++;
+            c.submitsIdShifted++;
+        } else {
+            printf("[REPLAY] FAIL: submit %zu differs\n  recorded: %s\n  replayed: %s\n",
+                   i + 1, recSubmits[i].c_str(), gotSubmits[i].c_str());
+        }
+    }
+    for (size_t i = recSubmits.size(); i < gotSubmits.size(); i++) {
+        printf("[REPLAY] FAIL: extra submit: %s\n", gotSubmits[i].c_str());
+    }
+
+    c.others = std::max(recOthers.size(), gotOthers.size());
+    for (size_t i = 0; i < c.others; i++) {
+        const char *rec = i < recOthers.size() ? recOthers[i].c_str() : "(none)";
+        const char *got = i < gotOthers.size() ? gotOthers[i].c_str() : "(none)";
+        if (strcmp(rec, got) == 0) continue;
+        c.othersDiffer++;
+        if (s_verbose || s_strict) {
+            printf("[REPLAY] %s: sent line %zu differs\n  recorded: %s\n  replayed: %s\n",
+                   s_strict ? "FAIL" : "WARNING", i + 1, rec, got);
+        }
+    }
+    return c;
+}
+
+static bool writeJson(const char *path, double switchMean, uint32_t switchMax, uint32_t switchP95) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+
+    struct { const char *name; double value; const char *unit; } rows[] = {
+        {"replay/job_switch_mean", switchMean, "ms"},
+        {"replay/job_switch_p95", (double)switchP95, "ms"},
+        {"replay/job_switch_max", (double)switchMax, "ms"},
+        {"replay/stale_submits", (double)s_staleSubmits, "ns"},
+    };
+    size_t n = sizeof(rows) / sizeof(rows[0]);
+
+    fprintf(f, "{\n  \"context\": {\n");
+    fprintf(f, "    \"executable\": \"stratum_replay\",\n");
+    fprintf(f, "    \"recording\": \"%s\",\n", s_path);
+    fprintf(f, "    \"session\": %d,\n", s_session);
+    fprintf(f, "    \"scale\": %.3f\n  },\n", s_scale);
+    fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < n; i++) {
+        fprintf(f, "    {\"name\": \"%s\", \"run_type\": \"aggregate\", \"aggregate_name\": \"median\", "
+                   "\"iterations\": 1, \"real_time\": %.3f, \"cpu_time\": %.3f, \"time_unit\": \"%s\"}%s\n",
+                rows[i].name, rows[i].value, rows[i].value, rows[i].unit, i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+static bool report() {
+    compare_t c = compareSends();
+    mining_stats_t *ms = miner_get_stats();
+
+    std::vector<uint32_t> sw;
+    {
+        std::lock_guard<std::mutex> lg(s_lock);
+        sw = s_switchMs;
+    }
+    std::sort(sw.begin(), sw.end());
+    double mean = 0;
+    for (uint32_t v : sw) mean += v;
+    if (!sw.empty()) mean /= sw.size();
+    uint32_t p95 = sw.empty() ? 0 : sw[std::min(sw.size() - 1, sw.size() * 95 / 100)];
+    uint32_t max = sw.empty() ? 0 : sw.back();
+
+    printf("\n=== Replay of %s (session %d, scale %.2f) ===\n", s_path, s_session, s_scale);
+    printf("records:      %zu, %lu lines fed, %lu with no connection, %lu never matched\n",
+           s_events.size(), (unsigned long)s_linesFed, (unsigned long)s_linesDropped,
+           (unsigned long)s_missing);
+    printf("submits:      %lu/%lu identical (%lu with a different request id), %lu injected\n",
+           (unsigned long)c.submitsMatched, (unsigned long)c.submits,
+           (unsigned long)c.submitsIdShifted, (unsigned long)s_submitsInjected);
+    printf("other sends:  %lu, %lu differ\n", (unsigned long)c.others, (unsigned long)c.othersDiffer);
+    printf("pool verdict: recorded %lu accepted / %lu rejected, replayed %lu / %lu\n",
+           (unsigned long)c.accepted, (unsigned long)c.rejected,
+           (unsigned long)ms->accepted, (unsigned long)ms->rejected);
+    printf("job switch:   %zu of %lu notifies, mean %.1f ms, p95 %lu ms, max %lu ms\n",
+           sw.size(), (unsigned long)s_notifies, mean, (unsigned long)p95, (unsigned long)max);
+    printf("stale:        %lu of %lu submits\n", (unsigned long)s_staleSubmits, (unsigned long)c.submits);
+    printf("share check:  %lu of %lu recorded nonces miss the target on the client's job\n",
+           (unsigned long)s_sharesMissed, (unsigned long)c.submits);
+
+    if (s_jsonPath && !writeJson(s_jsonPath, mean, max, p95)) return false;
+
+    bool ok = c.submitsMatched == c.submits && s_sent.size() >= c.submits && s_sharesMissed == 0 &&
+              (!s_strict || (c.othersDiffer == 0 && s_missing == 0));
+    printf("result:       %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--session") && hasValue) s_session = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--scale") && hasValue) s_scale = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--speed") && hasValue) s_speed = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--strict")) s_strict = true;
+        else if (!strcmp(argv[i], "--verbose")) s_verbose = true;
+        else if (!strcmp(argv[i], "--json") && hasValue) s_jsonPath = argv[++i];
+        else if (argv[i][0] != '-' && !s_path) s_path = argv[i];
+        else {
+            s_path = NULL;
+            break;
+        }
+    }
+    if (!s_path || s_scale < 0 || s_speed <= 0) {
+        fprintf(stderr, "Usage: %s RECORDING [--session N] [--scale F] [--speed X]\n"
+                        "       [--strict] [--verbose] [--json FILE]\n", argv[0]);
+        return 2;
+    }
+
+    if (!parseRecording(s_path, s_session)) return 2;
+    for (const rec_event_t &e : s_events) {
+        if (e.tag == STRATUM_REC_CONNECT || e.tag == STRATUM_REC_CONNECT_FAIL) s_connectPlan.push_back(e.tag);
+    }
+
+    host_random_seed(1);
+    sim_sched_set_speed(s_speed);
+    host_net_add_server(acceptConnection);
+
+    esp_task_wdt_init(30, true);
+    sim_sched_start();
+    miner_init();
+    stratum_init();
+    if (!configurePools()) return 2;
+    miner_set_job_hook(onJob);
+
+    xTaskCreatePinnedToCore(replayTask, "Replay", 8192, NULL, REPLAY_TASK_PRIORITY, NULL, REPLAY_CORE);
+    xTaskCreatePinnedToCore(stratum_task, "Stratum", STRATUM_STACK, NULL, STRATUM_PRIORITY, NULL, STRATUM_CORE);
+
+    while (!s_done) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    bool ok = report();
+    fflush(stdout);
+    // Task threads never return; leave without unwinding them
+    _Exit(ok ? 0 : 1);
+}
@@ -0,0 +1,457 @@
+/*
+ * SparkMiner - Task Scheduler Simulation (host)
+ * Runs the firmware's real FreeRTOS tasks on two simulated cores
+ *
+ * The miner, stratum, monitor and display tasks are the firmware sources,
+ * created by tasks_start() exactly as setup() does. Peripherals are stubbed:
+ * WiFi is an always-associated station talking to the in-process mock pool,
+ * the TFT is the host framebuffer with SPI time charged to the drawing task,
+ * the SHA peripheral is computed in software. The live stats task is the
+ * firmware's too, polling an in-process mock of its web APIs through an
+ * authenticating proxy; each request costs it --stats-burst-ms of CPU.
+ * The WiFi driver is modelled as a high-priority Core 0 task that wakes
+ * every beacon interval.
+ *
+ * At the end of the run it prints per-task CPU share, dispatch/preemption
+ * counts and ready-to-run latency, per-core idle time with a task watchdog
+ * verdict, and pool-side share accounting. Layout changes are compared by
+ * rebuilding with different board_config.h overrides (cores, priorities,
+ * MINER_0_YIELD_COUNT) or by --prio at run time. Built with ALLOC_GUARD
+ * (env native-sim-alloc) it also prints the allocation tripwire table and
+ * exits non-zero if any firmware task allocated after warm-up; with
+ * HEAP_TRACK (env native-sim-heap) it ends with the heap tracker table.
+ *
+ * Usage: task_sim [--seconds S] [--speed X | --device-khs K] [--seed N]
+ *                 [--pool-diff D] [--job-interval MS] [--latency MS]
+ *                 [--spi-mhz M] [--wifi-us US] [--stats-burst-ms MS]
+ *                 [--prio TASK=P ...]
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_task_wdt.h>
+#include <board_config.h>
+#include <chrono>
+#include <thread>
+#include "sim_sched.h"
+#include "mock_pool.h"
+#include "mock_http.h"
+#include "display_fb.h"
+#include "tasks.h"
+#include "mining/miner.h"
+#include "mining/miner_sha256.h"
+#include "mining/sha256_ll.h"
+#include "mining/sha256_hw.h"
+#include "mining/sha256_s3_dma.h"
+#include "stratum/stratum.h"
+#include "stats/monitor.h"
+#include "stats/live_stats.h"
+#include "stats/alloc_guard.h"
+#include "stats/heap_track.h"
+#include "stats/telemetry.h"
+#include "config/nvs_config.h"
+#include "config/wifi_manager.h"
+#include "display/display.h"
+
+#define SIM_MAX_TASKS           24
+#define SIM_MAX_PRIO_OVERRIDES  8
+#define SIM_REPORT_INTERVAL_MS  10000
+#define SIM_CALIBRATE_MS        200     // Wall-clock hashing to measure the host
+
+#define WIFI_TASK_PRIORITY      23      // ESP-IDF wifi task (ESP_TASK_PRIO_MAX - 2)
+#define WIFI_BEACON_MS          102     // 100 TU beacon interval
+#define SIM_PROXY_PORT          8080
+#define SIM_PROXY_AUTH          "sim:sparkminer"
+
+typedef struct {
+    const char *task;
+    UBaseType_t priority;
+} prio_override_t;
+
+static uint32_t s_seconds = 60;
+static double s_speed = 0;              // 0 = derive from --device-khs
+static double s_deviceKhs = 200;        // Per-core software hashrate of the target
+static uint64_t s_seed = 1;
+static uint32_t s_spiMhz = 40;          // Effective TFT SPI throughput
+static uint32_t s_wifiUs = 300;         // Driver CPU per beacon interval
+static uint32_t s_statsBurstMs = 40;    // CPU per live stats request (HTTP + JSON)
+static mock_pool_config_t s_pool = { 0.0001, 30000, 20 };
+static prio_override_t s_prio[SIM_MAX_PRIO_OVERRIDES];
+static int s_prioCount = 0;
+
+// ============================================================
+// Configuration Stubs (NVS, WiFi manager)
+// ============================================================
+
+static miner_config_t s_config;
+static mining_persistence_t s_persist;
+
+static void initConfig() {
+    memset(&s_config, 0, sizeof(s_config));
+    strcpy(s_config.poolUrl, "mock-pool");
+    s_config.poolPort = 3333;
+    strcpy(s_config.wallet, "bc1qsimulatedminerwallet0000000000000000");
+    strcpy(s_config.poolPassword, DEFAULT_POOL_PASS);
+    strcpy(s_config.workerName, "sim");
+    snprintf(s_config.statsProxyUrl, sizeof(s_config.statsProxyUrl), "http://%s@stats-proxy:%d",
+             SIM_PROXY_AUTH, SIM_PROXY_PORT);
+    s_config.brightness = 100;
+    s_config.rotation = 1;
+    s_config.displayEnabled = true;
+
+    memset(&s_persist, 0, sizeof(s_persist));
+    s_persist.magic = STATS_MAGIC;
+}
+
+miner_config_t *nvs_config_get() {
+    return &s_config;
+}
+
+bool nvs_config_is_valid() {
+    return s_config.wallet[0] != '\0';
+}
+
+bool nvs_config_save(const miner_config_t *config) {
+    (void)config;
+    return true;
+}
+
+mining_persistence_t *nvs_stats_get() {
+    return &s_persist;
+}
+
+void nvs_stats_update(uint64_t currentHashes, uint32_t currentShares,
+                      uint32_t currentAccepted, uint32_t currentRejected,
+                      uint32_t currentBlocks, uint32_t sessionSeconds,
+                      double bestDiff) {
+    (void)currentHashes;
+    (void)currentShares;
+    (void)currentAccepted;
+    (void)currentRejected;
+    (void)currentBlocks;
+    (void)sessionSeconds;
+    (void)bestDiff;
+}
+
+const char *wifi_manager_get_ip() {
+    return "10.0.0.2";
+}
+
+// ============================================================
+// Telemetry Stub (nothing to push to in the simulation)
+// ============================================================
+
+void telemetry_init() {
+}
+
+bool telemetry_configure(const char *url, uint16_t intervalSec) {
+    (void)url;
+    (void)intervalSec;
+    return true;
+}
+
+void telemetry_sample(uint32_t now, float hashRate) {
+    (void)now;
+    (void)hashRate;
+}
+
+void telemetry_get_stats(telemetry_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+// ============================================================
+// Peripheral Stubs (button, WiFi driver, SPI, SHA)
+// ============================================================
+
+void button_task(void *param) {
+    (void)param;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+static void wifiDriverTask(void *param) {
+    (void)param;
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        sim_sched_busy(s_wifiUs);
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(WIFI_BEACON_MS));
+    }
+}
+
+// TFT SPI is polled by the CPU, so transfers cost the drawing task time
+void display_fb_on_transfer(uint32_t bytes) {
+    static uint64_t carryBits = 0;
+    carryBits += (uint64_t)bytes * 8;
+    uint32_t us = (uint32_t)(carryBits / s_spiMhz);
+    carryBits -= (uint64_t)us * s_spiMhz;
+    if (us) sim_sched_busy(us);
+}
+
+void sha256_hw_init(void) {
+}
+
+void sha256_s3_dma_test(void) {
+}
+
+void sha256_ll_acquire(void) {
+}
+
+void sha256_ll_release(void) {
+}
+
+// The LL API takes header words pre-swapped to big-endian; undo that and
+// run the software midstate path, which has the same output layout
+void sha256_ll_midstate(uint32_t *midstate, const uint8_t *header) {
+    block_header_t hb;
+    const uint32_t *words = (const uint32_t *)header;
+    uint32_t *out = (uint32_t *)&hb;
+    memset(&hb, 0, sizeof(hb));
+    for (int i = 0; i < 16; i++) out[i] = __builtin_bswap32(words[i]);
+
+    sha256_hash_t ms;
+    miner_sha256_midstate(&ms, &hb);
+    memcpy(midstate, ms.hash, sizeof(ms.hash));
+}
+
+bool sha256_ll_double_hash(const uint32_t *midstate, const uint8_t *tail,
+                           uint32_t nonce, uint8_t *hash_out) {
+    block_header_t hb;
+    const uint32_t *words = (const uint32_t *)tail;
+    uint32_t *out = (uint32_t *)&hb;
+    for (int i = 0; i < 3; i++) out[16 + i] = __builtin_bswap32(words[i]);
+    hb.nonce = nonce;
+
+    sha256_hash_t ms;
+    memcpy(ms.hash, midstate, sizeof(ms.hash));
+    return miner_sha256_header(&ms, (sha256_hash_t *)hash_out, &hb);
+}
+
+// ============================================================
+// Setup (mirrors main.cpp setup())
+// ============================================================
+
+static double calibrateHostKhs() {
+    block_header_t hb;
+    sha256_hash_t midstate, ctx;
+    memset(&hb, 0x5a, sizeof(hb));
+    miner_sha256_midstate(&midstate, &hb);
+
+    uint64_t hashes = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::milliseconds(SIM_CALIBRATE_MS);
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 4096; i++) {
+            miner_sha256_header(&midstate, &ctx, &hb);
+            hb.nonce++;
+        }
+        hashes += 4096;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return hashes / secs / 1000.0;
+}
+
+static void simSetup() {
+    esp_task_wdt_init(30, true);
+    sim_sched_start();
+
+    initConfig();
+    miner_init();
+    stratum_init();
+
+    miner_config_t *config = nvs_config_get();
+    stratum_set_pool(config->poolUrl, config->poolPort, config->wallet,
+                     config->poolPassword, config->workerName);
+
+    display_init(config->rotation, config->brightness);
+    display_set_inverted(config->invertColors);
+
+    xTaskCreatePinnedToCore(wifiDriverTask, "wifi", 4096, NULL,
+                            WIFI_TASK_PRIORITY, NULL, CORE_0);
+
+    monitor_init();
+    tasks_start();
+
+    for (int i = 0; i < s_prioCount; i++) {
+        TaskHandle_t task = sim_sched_find(s_prio[i].task);
+        if (!task) {
+            Serial.printf("[SIM] WARNING: No task named %s\n", s_prio[i].task);
+            continue;
+        }
+        vTaskPrioritySet(task, s_prio[i].priority);
+        Serial.printf("[SIM] %s priority -> %u\n", s_prio[i].task, (unsigned)s_prio[i].priority);
+    }
+}
+
+// ============================================================
+// Report
+// ============================================================
+
+static void printProgress(uint32_t elapsedMs) {
+    mining_stats_t *ms = miner_get_stats();
+    mock_pool_stats_t ps;
+    mock_pool_get_stats(&ps);
+    Serial.printf("[SIM] t=%5lus  %8.1f KH/s  submits %lu  accepted %lu  jobs %lu\n",
+                  (unsigned long)(elapsedMs / 1000),
+                  elapsedMs ? ms->hashes / (double)elapsedMs : 0.0,
+                  (unsigned long)ps.submits, (unsigned long)ps.accepted, (unsigned long)ps.jobs);
+}
+
+static void printReport(uint64_t elapsedUs) {
+    static sim_task_stats_t tasks[SIM_MAX_TASKS];
+    sim_core_stats_t cores[SIM_CORES];
+    size_t n = sim_sched_get_stats(tasks, SIM_MAX_TASKS, cores);
+    if (n > SIM_MAX_TASKS) n = SIM_MAX_TASKS;
+    double total = (double)elapsedUs;
+
+    printf("\n=== Tasks (%.1f s virtual) ===\n", total / 1e6);
+    printf("%-12s %4s %4s %7s %10s %10s %11s %11s\n",
+           "task", "core", "prio", "cpu%", "dispatch", "preempt", "wait avg", "wait max");
+    for (size_t i = 0; i < n; i++) {
+        const sim_task_stats_t &t = tasks[i];
+        double avgUs = t.dispatches ? (double)t.waitTotalUs / t.dispatches : 0;
+        printf("%-12s %4d %4u %6.2f%% %10lu %10lu %8.0f us %8.2f ms\n",
+               t.name, t.core, (unsigned)t.priority, 100.0 * t.runUs / total,
+               (unsigned long)t.dispatches, (unsigned long)t.preemptions,
+               avgUs, t.waitMaxUs / 1000.0);
+    }
+
+    uint32_t wdtSec = sim_sched_wdt_timeout();
+    printf("\n=== Cores ===\n");
+    for (int c = 0; c < SIM_CORES; c++) {
+        printf("core %d: idle %6.2f%%, longest IDLE starvation %.3f s", c,
+               100.0 * cores[c].idleUs / total, cores[c].maxBusyUs / 1e6);
+        if (wdtSec && cores[c].maxBusyUs >= (uint64_t)wdtSec * 1000000ULL) {
+            printf("  <-- task WDT (%lu s) would fire", (unsigned long)wdtSec);
+        }
+        printf("\n");
+    }
+
+    mining_stats_t *ms = miner_get_stats();
+    mock_pool_stats_t ps;
+    mock_pool_get_stats(&ps);
+    printf("\n=== Mining ===\n");
+    printf("hashrate:   %.1f KH/s (virtual)\n", ms->hashes / (total / 1e6) / 1000.0);
+    printf("pool:       %lu connections, %lu jobs, %lu submits\n",
+           (unsigned long)ps.connections, (unsigned long)ps.jobs, (unsigned long)ps.submits);
+    printf("shares:     %lu accepted, %lu rejected, %lu stale\n",
+           (unsigned long)ps.accepted, (unsigned long)ps.rejected, (unsigned long)ps.stale);
+    printf("miner view: %lu accepted, %lu rejected, avg latency %lu ms\n",
+           (unsigned long)ms->accepted, (unsigned long)ms->rejected, (unsigned long)ms->avgLatency);
+    if (ps.acceptedWork > 0) {
+        // Each difficulty-1 share represents 2^32 hashes of expected work
+        printf("pool-side:  %.1f KH/s from accepted work\n",
+               ps.acceptedWork * 4294967296.0 / (total / 1e6) / 1000.0);
+    }
+
+    const live_stats_t *ls = live_stats_get();
+    mock_http_stats_t hs;
+    mock_http_get_stats(&hs);
+    printf("\n=== Live stats ===\n");
+    printf("requests:   %lu (%lu via proxy), %lu not found, %lu refused by the proxy\n",
+           (unsigned long)hs.requests, (unsigned long)hs.viaProxy,
+           (unsigned long)hs.notFound, (unsigned long)hs.authFailed);
+    const char *never = " (never fetched)";
+    printf("block:      %lu%s\n", (unsigned long)ls->blockHeight, ls->blockValid ? "" : never);
+    printf("price:      $%.0f%s\n", ls->btcPriceUsd, ls->priceValid ? "" : never);
+    printf("fees:       %d/%d/%d sat/vB%s\n", ls->fastestFee, ls->halfHourFee, ls->hourFee,
+           ls->feesValid ? "" : never);
+    printf("network:    %s, difficulty %s%s\n", ls->networkHashrate, ls->networkDifficulty,
+           ls->networkValid ? "" : never);
+    printf("pool:       %d workers%s\n", ls->poolWorkersCount, ls->poolValid ? "" : never);
+
+    #if ALLOC_GUARD
+        printf("\n=== Heap (allocation tripwire) ===\n");
+        alloc_guard_report();
+    #endif
+
+    #if HEAP_TRACK
+        printf("\n=== Heap (tracker) ===\n");
+        heap_track_sample(millis());
+        heap_track_report();
+    #endif
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+static bool parsePrio(const char *arg) {
+    const char *eq = strchr(arg, '=');
+    if (!eq || s_prioCount >= SIM_MAX_PRIO_OVERRIDES) return false;
+    static char names[SIM_MAX_PRIO_OVERRIDES][configMAX_TASK_NAME_LEN];
+    size_t len = eq - arg;
+    if (len == 0 || len >= configMAX_TASK_NAME_LEN) return false;
+    memcpy(names[s_prioCount], arg, len);
+    names[s_prioCount][len] = '\0';
+    s_prio[s_prioCount].task = names[s_prioCount];
+    s_prio[s_prioCount].priority = (UBaseType_t)constrain(atoi(eq + 1), 0, configMAX_PRIORITIES - 1);
+    s_prioCount++;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--seconds") && hasValue) s_seconds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--speed") && hasValue) s_speed = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--device-khs") && hasValue) s_deviceKhs = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && hasValue) s_seed = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--pool-diff") && hasValue) s_pool.difficulty = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--job-interval") && hasValue) s_pool.jobIntervalMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--latency") && hasValue) s_pool.latencyMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--spi-mhz") && hasValue) s_spiMhz = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--wifi-us") && hasValue) s_wifiUs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--stats-burst-ms") && hasValue) s_statsBurstMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--prio") && hasValue && parsePrio(argv[i + 1])) i++;
+        else {
+            fprintf(stderr,
+                    "Usage: %s [--seconds S] [--speed X | --device-khs K] [--seed N]\n"
+                    "       [--pool-diff D] [--job-interval MS] [--latency MS]\n"
+                    "       [--spi-mhz M] [--wifi-us US] [--stats-burst-ms MS]\n"
+                    "       [--prio TASK=P ...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (s_seconds == 0) s_seconds = 1;
+    if (s_spiMhz == 0) s_spiMhz = 1;
+    if (s_pool.difficulty <= 0) s_pool.difficulty = 0.0001;
+
+    host_random_seed(s_seed);
+
+    // Scale virtual time so a software hash costs what it does on the chip
+    double hostKhs = calibrateHostKhs();
+    if (s_speed <= 0) s_speed = s_deviceKhs > 0 ? hostKhs / s_deviceKhs : 1.0;
+    sim_sched_set_speed(s_speed);
+    printf("[SIM] Host %.0f KH/s per thread, speed %.2fx (%lu s virtual, ~%.1f s wall)\n",
+           hostKhs, s_speed, (unsigned long)s_seconds, s_seconds / s_speed);
+
+    // The stats APIs first: the pool takes every connection it is offered
+    mock_http_config_t http = { s_pool.latencyMs, s_statsBurstMs * 1000, SIM_PROXY_PORT, SIM_PROXY_AUTH };
+    mock_http_start(&http);
+    if (!mock_pool_start(&s_pool)) return 1;
+
+    // Scheduler statistics start with sim_sched_start() in simSetup()
+    uint32_t start = millis();
+    uint64_t startUs = sim_sched_now_us();
+    uint32_t nextReport = SIM_REPORT_INTERVAL_MS;
+    simSetup();
+
+    while (millis() - start < s_seconds * 1000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= nextReport) {
+            printProgress(elapsed);
+            nextReport += SIM_REPORT_INTERVAL_MS;
+        }
+    }
+
+    printReport(sim_sched_now_us() - startUs);
+
+    // Task threads never return; leave without unwinding them.
+    // With ALLOC_GUARD, any steady-state allocation fails the run.
+    fflush(stdout);
+    _Exit(alloc_guard_count() ? 1 : 0);
+}
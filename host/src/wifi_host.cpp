@@ -0,0 +1,169 @@
+/*
+ * SparkMiner - Host WiFi / Network Link Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "host_net.h"
+#include "sim_sched.h"
+#include "stats/alloc_guard.h"
+
+#define HOST_NET_MAX_SERVERS    4
+
+HostWiFi WiFi;
+
+static host_net_accept_fn s_servers[HOST_NET_MAX_SERVERS];
+static int s_serverCount = 0;
+
+// ============================================================
+// HostLink
+// ============================================================
+
+void HostLink::write(bool toServer, const char *data, size_t len, uint32_t nowMs) {
+    if (len == 0) return;
+    std::lock_guard<std::mutex> lg(m_lock);
+    if (m_closed) return;
+    Segment seg = {nowMs + m_latencyMs, std::string(data, len), 0};
+    (toServer ? m_toServer : m_toClient).push_back(seg);
+}
+
+size_t HostLink::available(bool forServer, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lg(m_lock);
+    size_t n = 0;
+    for (const Segment &seg : forServer ? m_toServer : m_toClient) {
+        if ((int32_t)(nowMs - seg.arriveMs) < 0) break;
+        n += seg.data.size() - seg.pos;
+    }
+    return n;
+}
+
+int HostLink::read(bool forServer, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lg(m_lock);
+    std::deque<Segment> &queue = forServer ? m_toServer : m_toClient;
+    if (queue.empty() || (int32_t)(nowMs - queue.front().arriveMs) < 0) return -1;
+
+    Segment &seg = queue.front();
+    int c = (uint8_t)seg.data[seg.pos++];
+    if (seg.pos >= seg.data.size()) queue.pop_front();
+    return c;
+}
+
+void HostLink::close() {
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_closed = true;
+}
+
+bool HostLink::closed() {
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_closed;
+}
+
+void host_net_add_server(host_net_accept_fn accept) {
+    if (s_serverCount < HOST_NET_MAX_SERVERS) s_servers[s_serverCount++] = accept;
+}
+
+HostLinkPtr host_net_connect(const char *host, uint16_t port) {
+    for (int i = 0; i < s_serverCount; i++) {
+        HostLinkPtr link = s_servers[i](host, port);
+        if (link) return link;
+    }
+    return NULL;
+}
+
+// ============================================================
+// WiFiClient
+// ============================================================
+
+int WiFiClient::connect(const char *host, uint16_t port, int32_t timeoutMs) {
+    stop();
+    if (WiFi.status() != WL_CONNECTED) return 0;
+
+    HostLinkPtr link = host_net_connect(host, port);
+    if (!link) {
+        // Refused connections time out rather than fail fast, as over WiFi
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        return 0;
+    }
+
+    // TCP handshake: one round trip
+    vTaskDelay(pdMS_TO_TICKS(2 * link->latencyMs()));
+    m_link = link;
+    return 1;
+}
+
+uint8_t WiFiClient::connected() {
+    sim_sched_checkpoint();
+    if (!m_link) return 0;
+    // Data that arrived before the peer closed can still be read
+    return !m_link->closed() || m_link->available(false, millis()) > 0;
+}
+
+int WiFiClient::available() {
+    sim_sched_checkpoint();
+    if (!m_link || WiFi.status() != WL_CONNECTED) return 0;
+    return (int)m_link->available(false, millis());
+}
+
+int WiFiClient::read() {
+    sim_sched_checkpoint();
+    if (!m_link) return -1;
+    return m_link->read(false, millis());
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t len) {
+    sim_sched_checkpoint();
+    if (!m_link || m_link->closed() || WiFi.status() != WL_CONNECTED) return 0;
+    // Segments stand in for lwIP pbufs, which the tcpip task allocates on
+    // the device, so they are not charged to the calling task
+    alloc_guard_exempt_begin();
+    m_link->write(true, (const char *)buf, len, millis());
+    alloc_guard_exempt_end();
+    return len;
+}
+
+void WiFiClient::stop() {
+    if (m_link) m_link->close();
+    m_link.reset();
+}
+
+// ============================================================
+// WiFiUDP (no LAN in the simulation)
+// ============================================================
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port) {
+    (void)host;
+    (void)port;
+    return 0;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t len) {
+    (void)buf;
+    (void)len;
+    return 0;
+}
+
+int WiFiUDP::endPacket() {
+    return 0;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress group, uint16_t port) {
+    (void)group;
+    (void)port;
+    return 0;
+}
+
+int WiFiUDP::parsePacket() {
+    return 0;
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t len) {
+    (void)buf;
+    (void)len;
+    return 0;
+}
+
+void WiFiUDP::stop() {
+}
@@ -32,6 +32,27 @@
     #define dbg(...) (void)0
 #endif
 
+// Allocation tripwire (stats/alloc_guard.h): 0 = off, 1 = count, 2 = abort.
+// Also needs -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc
+#ifndef ALLOC_GUARD
+    #define ALLOC_GUARD 0
+#endif
+#ifndef ALLOC_GUARD_WARMUP_MS
+    #define ALLOC_GUARD_WARMUP_MS 120000    // Armed this long after the first job
+#endif
+
+// Heap tracker (stats/heap_track.h): live bytes per subsystem and fragmentation.
+// Also needs the ALLOC_GUARD linker flags plus -Wl,--wrap=free
+#ifndef HEAP_TRACK
+    #define HEAP_TRACK 0
+#endif
+#ifndef HEAP_TRACK_SLOTS
+    #define HEAP_TRACK_SLOTS 1024           // Live blocks tracked, power of two
+#endif
+#ifndef HEAP_TRACK_REPORT_MS
+    #define HEAP_TRACK_REPORT_MS 60000      // Serial table interval
+#endif
+
 // ============================================================
 // ESP32-2432S028R - Cheap Yellow Display 2.8"
 // ============================================================
@@ -77,6 +98,9 @@
     #endif
     #define BUTTON_ACTIVE_LOW 1
 
+    // Touch: XPT2046 resistive panel, wakes the display (pins in display.cpp)
+    #define TOUCH_TYPE_XPT2046 1
+
     // SHA Implementation: Defined in platformio.ini (USE_HARDWARE_SHA=1)
 
 // ============================================================
@@ -348,6 +372,20 @@
 
     // SHA Implementation: Defined in platformio.ini (USE_HARDWARE_SHA=1)
 
+// ============================================================
+// Linux daemon (sparkminer-linux) - same tasks on pthreads
+// Headless; the kernel preempts miner threads, so Core 0's
+// cooperative yield only needs to come rarely
+// ============================================================
+#elif defined(SPARKMINER_LINUX)
+    #define BOARD_NAME "Linux"
+    #define USE_DISPLAY 0
+    #define MINER_WORKER_POOL 1     // One miner per hardware thread (host/src/nonce_sched.cpp)
+
+    #ifndef MINER_0_YIELD_COUNT
+        #define MINER_0_YIELD_COUNT (1 << 20)
+    #endif
+
 // ============================================================
 // Default - Generic ESP32
 // ============================================================
@@ -364,6 +402,8 @@
 
 // ============================================================
 // FreeRTOS Task Configuration (from BitsyMiner)
+// Cores, priorities and the Core 0 yield interval can be overridden
+// via build_flags (e.g. to compare layouts in the host scheduler sim)
 // ============================================================
 
 // Core 0 - Shared tasks (WiFi, Stratum, Display, etc.)
@@ -373,33 +413,121 @@
 #define CORE_1 1
 
 // Miner on Core 0 (lower priority, yields to other tasks)
+#ifndef MINER_0_CORE
 #define MINER_0_CORE        CORE_0
+#endif
+#ifndef MINER_0_PRIORITY
 #define MINER_0_PRIORITY    1
+#endif
 #define MINER_0_STACK       8000    // Increased for SHA stack usage
+#ifndef MINER_0_YIELD_COUNT
 #define MINER_0_YIELD_COUNT 256     // Yield every N hashes
+#endif
 
 // Miner on Core 1 (highest priority, dedicated)
+#ifndef MINER_1_CORE
 #define MINER_1_CORE        CORE_1
+#endif
+#ifndef MINER_1_PRIORITY
 #define MINER_1_PRIORITY    19      // Near-max priority (FreeRTOS max is 24)
+#endif
 #define MINER_1_STACK       8000    // Increased for SHA stack usage
 
 // Stratum task
+#ifndef STRATUM_CORE
 #define STRATUM_CORE        CORE_0
+#endif
+#ifndef STRATUM_PRIORITY
 #define STRATUM_PRIORITY    2
+#endif
 #define STRATUM_STACK       12288
 
-// Monitor/Display task
-// NOTE: Needs large stack for HTTPClient + JSON parsing + TFT rendering
+// Monitor task (snapshots, LED, persistence)
+// NOTE: Stack sized for NVS persistence writes and Serial formatting
+#ifndef MONITOR_CORE
 #define MONITOR_CORE        CORE_0
+#endif
+#ifndef MONITOR_PRIORITY
 #define MONITOR_PRIORITY    1
+#endif
 #define MONITOR_STACK       10000
 
+// Display render task
+// Consumes display snapshots from the monitor via a single-slot mailbox
+// NOTE: TFT_eSPI text rendering and snprintf formatting need ~6KB
+#ifndef DISPLAY_CORE
+#define DISPLAY_CORE        CORE_0
+#endif
+#ifndef DISPLAY_PRIORITY
+#define DISPLAY_PRIORITY    1
+#endif
+#define DISPLAY_STACK       8192
+
+// Frame interval and per-frame CPU budget (override via build_flags)
+// A frame that overruns the budget causes following frames to be skipped
+// so that average render cost stays within budget per frame interval
+#ifndef DISPLAY_FRAME_MS
+#define DISPLAY_FRAME_MS        1000    // 1 frame per second
+#endif
+#ifndef DISPLAY_FRAME_BUDGET_US
+#define DISPLAY_FRAME_BUDGET_US 150000  // 150ms (15% of a 1s frame)
+#endif
+
 // Stats API task
 // NOTE: Needs large stack for WiFiClientSecure SSL context (~10-15KB)
+#ifndef STATS_CORE
 #define STATS_CORE          CORE_0
+#endif
+#ifndef STATS_PRIORITY
 #define STATS_PRIORITY      1
+#endif
 #define STATS_STACK         12000
 
+// Telemetry publisher (stats/telemetry.h); only started when a target is set
+#ifndef TELEMETRY_CORE
+#define TELEMETRY_CORE      CORE_0
+#endif
+#ifndef TELEMETRY_PRIORITY
+#define TELEMETRY_PRIORITY  1
+#endif
+#define TELEMETRY_STACK     4096
+#ifndef TELEMETRY_INTERVAL_DEFAULT
+#define TELEMETRY_INTERVAL_DEFAULT 60   // Seconds between pushes
+#endif
+
+// Firmware update checker (ota/ota_update.h); only started with a public key built in
+// NOTE: Shares Core 0 round-robin with Miner0 instead of preempting it; Miner1 is untouched
+#ifndef OTA_CORE
+#define OTA_CORE            CORE_0
+#endif
+#ifndef OTA_PRIORITY
+#define OTA_PRIORITY        1
+#endif
+#define OTA_STACK           8192    // ECDSA verify and the manifest JSON document
+
+// Button task (OneButton polling, 10ms)
+// NOTE: 4KB stack for NVS writes (rotation save) in click handlers
+#ifndef BUTTON_CORE
+#define BUTTON_CORE         CORE_0
+#endif
+#ifndef BUTTON_PRIORITY
+#define BUTTON_PRIORITY     5       // Above miner0 (1), below miner1 (19)
+#endif
+#define BUTTON_STACK        4096
+
+// ============================================================
+// Memory Placement (stats/mem_place.h)
+// Large, rarely touched buffers go to PSRAM when the board has it,
+// leaving internal DRAM to WiFi/lwIP; hot mining data stays internal
+// ============================================================
+#ifndef MEM_PSRAM_BUFFERS
+    #if defined(BOARD_HAS_PSRAM)
+        #define MEM_PSRAM_BUFFERS 1
+    #else
+        #define MEM_PSRAM_BUFFERS 0
+    #endif
+#endif
+
 // ============================================================
 // Network Configuration
 // ============================================================
@@ -423,6 +551,11 @@
 #define POOL_KEEPALIVE_MS   30000   // 30s keepalive
 #define POOL_FAILOVER_MS    30000   // 30s before failover
 
+// Stratum session recorder (stratum_rec.h): 0 = off, 1 = serial, 2 = SD card
+#ifndef STRATUM_RECORD
+#define STRATUM_RECORD      0
+#endif
+
 // ============================================================
 // String Limits
 // ============================================================
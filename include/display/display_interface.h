@@ -120,6 +120,12 @@ typedef struct {
      */
     void (*set_screen)(uint8_t screen);
 
+    /**
+     * Enter or leave display sleep (backlight/panel power off)
+     * @param sleep true to sleep, false to wake and redraw
+     */
+    void (*set_sleep)(bool sleep);
+
     /**
      * Driver name for debugging
      */
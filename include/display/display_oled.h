@@ -79,6 +79,11 @@ uint8_t oled_display_flip_rotation();
  */
 void oled_display_set_inverted(bool inverted);
 
+/**
+ * Enter/leave OLED power save (panel off, buffer retained)
+ */
+void oled_display_set_sleep(bool sleep);
+
 /**
  * Get display dimensions
  */
@@ -90,6 +95,12 @@ uint16_t oled_display_get_height();
  */
 bool oled_display_is_portrait();
 
+/**
+ * Get total bytes pushed over I2C since boot
+ * (tile data + addressing overhead, partial updates included)
+ */
+uint32_t oled_display_get_i2c_bytes();
+
 /**
  * Screen management
  */
@@ -0,0 +1,237 @@
+/*
+ * SparkMiner - Fixed-Capacity Strings
+ * Heap-free replacements for Arduino String
+ *
+ * FixedString<N> holds up to N characters inline (plus the terminator)
+ * and never allocates. Appends that do not fit are cut at the capacity
+ * and set a sticky truncated() flag, so callers can check once after
+ * building a whole message instead of after every append.
+ *
+ * StringView is a non-owning (pointer, length) slice used for parsing:
+ * find, substr and trim return new views without copying.
+ *
+ *   FixedString<64> line;
+ *   line.append("job=").append(jobId).appendf(" nonce=%08lx", nonce);
+ *   if (line.truncated()) ...
+ *
+ * GPL v3 License
+ */
+
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================
+// StringView
+// ============================================================
+
+class StringView {
+public:
+    static const size_t npos = (size_t)-1;
+
+    StringView() : m_data(""), m_len(0) {}
+    StringView(const char *s) : m_data(s ? s : ""), m_len(s ? strlen(s) : 0) {}
+    StringView(const char *s, size_t len) : m_data(s ? s : ""), m_len(s ? len : 0) {}
+
+    const char *data() const { return m_data; }
+    size_t length() const { return m_len; }
+    bool empty() const { return m_len == 0; }
+    char operator[](size_t i) const { return m_data[i]; }
+
+    size_t find(char c, size_t from = 0) const {
+        for (size_t i = from; i < m_len; i++) {
+            if (m_data[i] == c) return i;
+        }
+        return npos;
+    }
+
+    size_t find(StringView needle, size_t from = 0) const {
+        if (needle.m_len == 0) return from <= m_len ? from : npos;
+        for (size_t i = from; i + needle.m_len <= m_len; i++) {
+            if (memcmp(m_data + i, needle.m_data, needle.m_len) == 0) return i;
+        }
+        return npos;
+    }
+
+    /** Up to len characters from pos; empty when pos is past the end */
+    StringView substr(size_t pos, size_t len = npos) const {
+        if (pos >= m_len) return StringView(m_data + m_len, 0);
+        if (len > m_len - pos) len = m_len - pos;
+        return StringView(m_data + pos, len);
+    }
+
+    /** Without leading/trailing spaces, tabs, CR and LF */
+    StringView trim() const {
+        size_t start = 0, end = m_len;
+        while (start < end && isSpace(m_data[start])) start++;
+        while (end > start && isSpace(m_data[end - 1])) end--;
+        return StringView(m_data + start, end - start);
+    }
+
+    bool startsWith(StringView prefix) const {
+        return prefix.m_len <= m_len && memcmp(m_data, prefix.m_data, prefix.m_len) == 0;
+    }
+
+    bool endsWith(StringView suffix) const {
+        return suffix.m_len <= m_len &&
+               memcmp(m_data + m_len - suffix.m_len, suffix.m_data, suffix.m_len) == 0;
+    }
+
+    bool operator==(StringView other) const {
+        return m_len == other.m_len && memcmp(m_data, other.m_data, m_len) == 0;
+    }
+    bool operator!=(StringView other) const { return !(*this == other); }
+
+    /** Copy into a C buffer; returns false (and still terminates) if cut */
+    bool copyTo(char *dest, size_t size) const {
+        if (size == 0) return m_len == 0;
+        size_t n = m_len < size - 1 ? m_len : size - 1;
+        memcpy(dest, m_data, n);
+        dest[n] = '\0';
+        return n == m_len;
+    }
+
+private:
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    const char *m_data;
+    size_t m_len;
+};
+
+// ============================================================
+// FixedString<N>
+// ============================================================
+
+template <size_t N>
+class FixedString {
+public:
+    FixedString() { clear(); }
+    FixedString(StringView s) { clear(); append(s); }
+    FixedString(const char *s) { clear(); append(s); }
+
+    const char *c_str() const { return m_buf; }
+    size_t length() const { return m_len; }
+    bool empty() const { return m_len == 0; }
+    static size_t capacity() { return N; }
+    size_t remaining() const { return N - m_len; }
+    char operator[](size_t i) const { return m_buf[i]; }
+
+    /** True if any append since the last clear() did not fit */
+    bool truncated() const { return m_truncated; }
+
+    StringView view() const { return StringView(m_buf, m_len); }
+    operator StringView() const { return view(); }
+
+    void clear() {
+        m_len = 0;
+        m_buf[0] = '\0';
+        m_truncated = false;
+    }
+
+    FixedString &append(const char *s, size_t len) {
+        if (len > N - m_len) {
+            len = N - m_len;
+            m_truncated = true;
+        }
+        memcpy(m_buf + m_len, s, len);
+        m_len += len;
+        m_buf[m_len] = '\0';
+        return *this;
+    }
+
+    FixedString &append(StringView s) { return append(s.data(), s.length()); }
+    FixedString &append(const char *s) { return append(StringView(s)); }
+
+    FixedString &append(char c) {
+        if (m_len < N) {
+            m_buf[m_len++] = c;
+            m_buf[m_len] = '\0';
+        } else {
+            m_truncated = true;
+        }
+        return *this;
+    }
+
+    FixedString &operator+=(StringView s) { return append(s); }
+    FixedString &operator+=(const char *s) { return append(s); }
+    FixedString &operator+=(char c) { return append(c); }
+
+    FixedString &operator=(StringView s) {
+        clear();
+        return append(s);
+    }
+    FixedString &operator=(const char *s) {
+        clear();
+        return append(s);
+    }
+
+    /** Append formatted text (vsnprintf rules) */
+    FixedString &appendf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, fmt);
+        vappendf(fmt, args);
+        va_end(args);
+        return *this;
+    }
+
+    /** Replace the contents with formatted text */
+    FixedString &printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        clear();
+        va_list args;
+        va_start(args, fmt);
+        vappendf(fmt, args);
+        va_end(args);
+        return *this;
+    }
+
+    FixedString &vappendf(const char *fmt, va_list args) {
+        int n = vsnprintf(m_buf + m_len, N - m_len + 1, fmt, args);
+        if (n < 0) {
+            m_buf[m_len] = '\0';
+            m_truncated = true;
+        } else if ((size_t)n > N - m_len) {
+            m_len = N;
+            m_truncated = true;
+        } else {
+            m_len += n;
+        }
+        return *this;
+    }
+
+    /** Strip leading/trailing whitespace in place */
+    FixedString &trim() {
+        StringView t = view().trim();
+        memmove(m_buf, t.data(), t.length());
+        m_len = t.length();
+        m_buf[m_len] = '\0';
+        return *this;
+    }
+
+    /** Drop everything from pos on */
+    void truncate(size_t pos) {
+        if (pos < m_len) {
+            m_len = pos;
+            m_buf[m_len] = '\0';
+        }
+    }
+
+    size_t find(char c, size_t from = 0) const { return view().find(c, from); }
+    size_t find(StringView s, size_t from = 0) const { return view().find(s, from); }
+    StringView substr(size_t pos, size_t len = StringView::npos) const { return view().substr(pos, len); }
+    bool startsWith(StringView prefix) const { return view().startsWith(prefix); }
+    bool operator==(StringView other) const { return view() == other; }
+    bool operator!=(StringView other) const { return view() != other; }
+
+private:
+    char m_buf[N + 1];
+    size_t m_len;
+    bool m_truncated;
+};
+
+#endif // FIXED_STRING_H
@@ -0,0 +1,21 @@
+/*
+ * SparkMiner - OTA Public Key
+ * Firmware updates (ota/ota_update.h) must be signed with the private
+ * half of this key
+ *
+ * Create a key pair with `python3 scripts/ota_sign.py keygen` and paste
+ * the string it prints here, or pass it with -D OTA_PUBLIC_KEY=... in
+ * build_flags. Keep ota_private.pem off the devices and out of git.
+ * Empty disables update checks.
+ *
+ * GPL v3 License
+ */
+
+#ifndef OTA_KEY_H
+#define OTA_KEY_H
+
+#ifndef OTA_PUBLIC_KEY
+#define OTA_PUBLIC_KEY ""
+#endif
+
+#endif // OTA_KEY_H
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""
+Benchmark comparison for SparkMiner
+Diffs two core_bench or stratum_replay --json results (Google Benchmark
+JSON layout) and exits non-zero if any benchmark slowed down by more than
+the threshold
+
+Usage: bench_compare.py baseline.json current.json [--threshold PCT]
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_times(path):
+    """Map benchmark name -> time per iteration (ns)"""
+    scale = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    with open(path) as f:
+        data = json.load(f)
+
+    times = {}
+    for bench in data.get('benchmarks', []):
+        # Google Benchmark emits per-repetition rows plus aggregates; keep the median
+        if bench.get('run_type') == 'aggregate' and bench.get('aggregate_name') != 'median':
+            continue
+        name = bench.get('run_name', bench['name'])
+        times[name] = bench['real_time'] * scale.get(bench.get('time_unit', 'ns'), 1.0)
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two benchmark JSON files')
+    parser.add_argument('baseline', help='Reference results')
+    parser.add_argument('current', help='Results to check')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='Allowed slowdown in percent (default: 5)')
+    args = parser.parse_args()
+
+    base = load_times(args.baseline)
+    cur = load_times(args.current)
+
+    regressions = []
+    print(f"{'benchmark':<32} {'baseline ns':>12} {'current ns':>12} {'delta':>8}")
+    for name in sorted(set(base) | set(cur)):
+        if name not in base or name not in cur:
+            where = 'baseline' if name not in base else 'current'
+            print(f"{name:<32} {'missing from ' + where:>34}")
+            continue
+
+        if base[name] > 0:
+            delta = (cur[name] - base[name]) / base[name] * 100.0
+        else:
+            # Zero baselines (e.g. stale submits): any increase is a regression
+            delta = float('inf') if cur[name] > 0 else 0.0
+        flag = ''
+        if delta > args.threshold:
+            flag = '  REGRESSION'
+            regressions.append(name)
+        elif delta < -args.threshold:
+            flag = '  faster'
+        print(f"{name:<32} {base[name]:>12.1f} {cur[name]:>12.1f} {delta:>+7.1f}%{flag}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than {args.threshold:.1f}%: "
+              + ', '.join(regressions))
+        return 1
+
+    print(f"\nNo regressions beyond {args.threshold:.1f}%")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+"""
+Per-file optimization level for the hot mining code
+
+For envs that lower the whole build's optimization to fit in IRAM (the
+CYD and T-Display V1 boards build at -O1 for TFT_eSPI) but want the
+nonce loop, SHA and job builder faster. Opt in per env:
+
+    custom_hot_opt = -O2            ; level for the hot sources
+    custom_hot_src = src/mining/*   ; fnmatch patterns (optional)
+
+Matching sources get their -O flag replaced; everything else keeps the
+env's level. Without custom_hot_opt this script does nothing.
+esp32-2432s028 enables it for the Core 0 kernel; check a board's
+mem_budget.py report before enabling it there, since -O2 can grow the
+IRAM_ATTR SHA code the display libraries already crowd.
+"""
+
+import fnmatch
+
+Import("env")
+
+HOT_SRC_DEFAULT = "src/mining/*"
+
+hot_opt = env.GetProjectOption("custom_hot_opt", "").strip()
+hot_src = env.GetProjectOption("custom_hot_src", HOT_SRC_DEFAULT).split()
+
+def is_opt_flag(flag):
+    return isinstance(flag, str) and flag.startswith("-O")
+
+def hot_middleware(env, node):
+    path = node.get_path().replace("\\", "/")
+    if not any(fnmatch.fnmatch(path, "*" + pattern) for pattern in hot_src):
+        return node
+
+    flags = [f for f in env["CCFLAGS"] if not is_opt_flag(f)]
+    return env.Object(node, CCFLAGS=flags + [hot_opt])
+
+if hot_opt:
+    print(f"Hot sources ({' '.join(hot_src)}) built with {hot_opt}")
+    env.AddBuildMiddleware(hot_middleware)
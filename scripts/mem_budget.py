@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Post-build IRAM/DRAM budget report
+
+Links with a map file, then attributes every allocated ELF section to
+the linker memory region that contains it and prints used/free per
+region, plus the largest IRAM symbols. Run on every firmware build, so
+a change that moves code into IRAM (IRAM_ATTR, per-file -O levels from
+hot_opt.py) shows its cost next to the remaining headroom.
+
+On the S3 and C3, IRAM and DRAM are two views of the same SRAM, so
+their percentages overlap rather than add up.
+"""
+
+import re
+import subprocess
+from pathlib import Path
+
+Import("env")
+
+IRAM_TOP_SYMBOLS = 10
+WARN_PERCENT = 95
+
+map_file = Path(env.subst("$BUILD_DIR")) / "firmware.map"
+env.Append(LINKFLAGS=["-Wl,-Map," + str(map_file)])
+
+def tool(name):
+    """Toolchain binary next to the compiler (xtensa-esp32-elf-gcc -> -nm)"""
+    cc = env.subst("$CC")
+    return re.sub(r"gcc$", name, cc)
+
+def read_regions(path):
+    """Memory Configuration table of the map: name -> (origin, length)"""
+    regions = {}
+    in_table = False
+    for line in path.read_text(errors="replace").splitlines():
+        if line.startswith("Memory Configuration"):
+            in_table = True
+            continue
+        if in_table and line.startswith("Linker script and memory map"):
+            break
+        fields = line.split()
+        if in_table and len(fields) >= 3 and fields[1].startswith("0x"):
+            if fields[0] != "*default*":
+                regions[fields[0]] = (int(fields[1], 16), int(fields[2], 16))
+    return regions
+
+def read_sections(elf):
+    """(name, size, addr) of allocated sections via size -A"""
+    out = subprocess.run([env.subst("$SIZETOOL"), "-A", "-d", str(elf)],
+                         stdout=subprocess.PIPE, text=True, check=True).stdout
+    sections = []
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[0].startswith(".") and fields[1].isdigit():
+            size, addr = int(fields[1]), int(fields[2])
+            if size and addr:
+                sections.append((fields[0], size, addr))
+    return sections
+
+def region_of(addr, regions):
+    for name, (origin, length) in regions.items():
+        if origin <= addr < origin + length:
+            return name
+    return None
+
+def top_symbols(elf, origin, length):
+    out = subprocess.run([tool("nm"), "-S", "-C", "--size-sort", str(elf)],
+                         stdout=subprocess.PIPE, text=True).stdout
+    symbols = []
+    for line in out.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) < 4:
+            continue
+        addr, size = int(fields[0], 16), int(fields[1], 16)
+        if origin <= addr < origin + length:
+            symbols.append((size, fields[3]))
+    return sorted(symbols, reverse=True)[:IRAM_TOP_SYMBOLS]
+
+def report_budget(source, target, env):
+    elf = Path(env.subst("$BUILD_DIR")) / "firmware.elf"
+    if not map_file.exists() or not elf.exists():
+        print("Memory budget: map or ELF missing, skipped")
+        return
+
+    regions = read_regions(map_file)
+    used = {name: 0 for name in regions}
+    for name, size, addr in read_sections(elf):
+        region = region_of(addr, regions)
+        if region:
+            used[region] += size
+
+    print(f"\n Memory budget ({env.subst('$PIOENV')}):")
+    for name, (origin, length) in sorted(regions.items(), key=lambda r: r[1][0]):
+        if not used[name]:
+            continue
+        percent = 100.0 * used[name] / length
+        flag = "  <-- nearly full" if percent >= WARN_PERCENT else ""
+        print(f"   {name:<16} {used[name]:>9,} / {length:>9,} B  {percent:5.1f}%  "
+              f"{length - used[name]:>9,} B free{flag}")
+
+    iram = regions.get("iram0_0_seg")
+    if iram:
+        print("   Largest IRAM symbols:")
+        for size, name in top_symbols(elf, *iram):
+            print(f"     {size:>7,} B  {name}")
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report_budget)
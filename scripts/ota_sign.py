@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+OTA signing for SparkMiner
+Creates the update key pair and signs firmware images, writing the
+manifest the board polls (src/ota/ota_image.h). Uses the openssl CLI.
+
+Usage: ota_sign.py keygen [--dir DIR]
+       ota_sign.py sign firmware.bin --key ota_private.pem --version V
+                   --board NAME [--url URL] [--out ota.json]
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import re
+import subprocess
+import sys
+
+# What the board accepts in version and board (isToken in src/ota/ota_image.cpp)
+TOKEN = re.compile(r'^[A-Za-z0-9._+-]{1,31}$')
+SEMVER = re.compile(r'^[vV]?\d+\.\d+\.\d+(-[0-9A-Za-z-]+(\.[0-9A-Za-z-]+)*)?(\+.*)?$')
+
+
+def openssl(*args, data=None):
+    try:
+        return subprocess.run(['openssl', *args], input=data, check=True,
+                              capture_output=True).stdout
+    except FileNotFoundError:
+        sys.exit('openssl not found on PATH')
+    except subprocess.CalledProcessError as e:
+        sys.exit(f"openssl {args[0]} failed: {e.stderr.decode().strip()}")
+
+
+def keygen(args):
+    private = os.path.join(args.dir, 'ota_private.pem')
+    public = os.path.join(args.dir, 'ota_public.pem')
+    if os.path.exists(private):
+        sys.exit(f"{private} exists; not overwriting a signing key")
+
+    openssl('ecparam', '-name', 'prime256v1', '-genkey', '-noout', '-out', private)
+    os.chmod(private, 0o600)
+    openssl('ec', '-in', private, '-pubout', '-out', public)
+
+    with open(public) as f:
+        lines = f.read().strip().splitlines()
+    print(f"Wrote {private} (keep it secret) and {public}")
+    print("Put this in include/ota_key.h:\n")
+    print('#define OTA_PUBLIC_KEY \\')
+    print(' \\\n'.join(f'    "{line}\\n"' for line in lines))
+
+
+def sign(args):
+    with open(args.image, 'rb') as f:
+        image = f.read()
+    if not image:
+        sys.exit(f"{args.image} is empty")
+
+    if not TOKEN.match(args.version) or not SEMVER.match(args.version):
+        sys.exit(f"--version {args.version!r} is not a semantic version like v2.9.2")
+    if not TOKEN.match(args.board):
+        sys.exit(f"--board {args.board!r} must be a BOARD_NAME such as ESP32-2432S028")
+
+    # ECDSA P-256, DER encoded, over SHA-256 of the statement the board rebuilds
+    # from the manifest: version and board are signed along with the image digest
+    digest = hashlib.sha256(image).hexdigest()
+    statement = f"sparkminer-ota-1\n{args.version}\n{args.board}\n{len(image)}\n{digest}\n"
+    sig = openssl('dgst', '-sha256', '-sign', args.key, data=statement.encode())
+
+    manifest = {
+        'version': args.version,
+        'board': args.board,
+        'size': len(image),
+        'sha256': digest,
+        'sig': sig.hex(),
+        'url': args.url or os.path.basename(args.image),
+    }
+
+    out = args.out or os.path.join(os.path.dirname(os.path.abspath(args.image)), 'ota.json')
+    with open(out, 'w') as f:
+        json.dump(manifest, f, indent=2)
+        f.write('\n')
+    print(f"Signed {args.image}: {args.version}, {len(image)} bytes -> {out}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Sign SparkMiner firmware for OTA updates')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('keygen', help='Create an ECDSA P-256 key pair')
+    p.add_argument('--dir', default='.', help='Where to write the keys (default: .)')
+    p.set_defaults(func=keygen)
+
+    p = sub.add_parser('sign', help='Write a signed manifest for an image')
+    p.add_argument('image', help='Application image (firmware.bin, not the merged factory image)')
+    p.add_argument('--key', required=True, help='Private key from keygen')
+    p.add_argument('--version', required=True,
+                   help='Version the image reports (AUTO_VERSION); boards only take newer versions')
+    p.add_argument('--board', required=True, help='BOARD_NAME it is built for')
+    p.add_argument('--url', help='Image URL, absolute or relative to the manifest (default: file name)')
+    p.add_argument('--out', help='Manifest path (default: ota.json next to the image)')
+    p.set_defaults(func=sign)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
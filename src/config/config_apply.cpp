@@ -0,0 +1,169 @@
+/*
+ * SparkMiner - Live Config Apply
+ * Applies only what changed (see config_apply.h)
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "config_apply.h"
+#include "../stratum/stratum.h"
+#include "../stats/live_stats.h"
+#include "../stats/telemetry.h"
+
+#if USE_DISPLAY || USE_OLED_DISPLAY
+    #include "../display/display_task.h"
+#endif
+
+#if !defined(HOST_BUILD)
+    #include "../ota/ota_update.h"
+#endif
+
+// ============================================================
+// Diff
+// ============================================================
+
+static bool differs(const char *a, const char *b) {
+    return strcmp(a, b) != 0;
+}
+
+uint32_t config_diff(const miner_config_t *from, const miner_config_t *to) {
+    uint32_t changed = 0;
+
+    if (differs(from->ssid, to->ssid) || differs(from->wifiPassword, to->wifiPassword)) {
+        changed |= CONFIG_CHANGED_WIFI;
+    }
+
+    // The worker name is appended to both pools' usernames
+    bool worker = differs(from->workerName, to->workerName);
+    if (worker || differs(from->poolUrl, to->poolUrl) || from->poolPort != to->poolPort ||
+        differs(from->wallet, to->wallet) || differs(from->poolPassword, to->poolPassword)) {
+        changed |= CONFIG_CHANGED_POOL;
+    }
+    if (worker || differs(from->backupPoolUrl, to->backupPoolUrl) ||
+        from->backupPoolPort != to->backupPoolPort ||
+        differs(from->backupWallet, to->backupWallet) ||
+        differs(from->backupPoolPassword, to->backupPoolPassword)) {
+        changed |= CONFIG_CHANGED_BACKUP;
+    }
+    if (from->targetDifficulty != to->targetDifficulty) {
+        changed |= CONFIG_CHANGED_DIFFICULTY;
+    }
+
+    if (from->brightness != to->brightness || from->rotation != to->rotation ||
+        from->invertColors != to->invertColors) {
+        changed |= CONFIG_CHANGED_DISPLAY;
+    }
+    if (from->timezoneOffset != to->timezoneOffset) {
+        changed |= CONFIG_CHANGED_TIMEZONE;
+    }
+
+    // Pool stats are looked up by wallet
+    if (differs(from->statsProxyUrl, to->statsProxyUrl) ||
+        from->enableHttpsStats != to->enableHttpsStats || from->lanStats != to->lanStats ||
+        differs(from->wallet, to->wallet)) {
+        changed |= CONFIG_CHANGED_STATS;
+    }
+    if (differs(from->telemetryUrl, to->telemetryUrl) ||
+        from->telemetryInterval != to->telemetryInterval) {
+        changed |= CONFIG_CHANGED_TELEMETRY;
+    }
+    if (differs(from->otaUrl, to->otaUrl)) {
+        changed |= CONFIG_CHANGED_OTA;
+    }
+
+    // screenTimeout is read by the display task each pass and needs nothing here
+    return changed;
+}
+
+// ============================================================
+// Apply
+// ============================================================
+
+uint32_t config_apply(const miner_config_t *next) {
+    uint32_t start = millis();
+    const miner_config_t *running = nvs_config_get();
+    uint32_t changed = config_diff(running, next);
+
+    // Which display settings moved (the running config is replaced by the save)
+    bool brightness = running->brightness != next->brightness;
+    bool rotation = running->rotation != next->rotation;
+    bool inverted = running->invertColors != next->invertColors;
+
+    // Saving replaces nvs_config_get(), which is what the tasks re-read
+    if (!nvs_config_save(next)) {
+        Serial.println("[CONFIG] Save failed, running config unchanged");
+        return 0;
+    }
+    if (!changed) {
+        Serial.println("[CONFIG] Saved, nothing to apply");
+        return 0;
+    }
+    const miner_config_t *config = nvs_config_get();
+
+    if (changed & CONFIG_CHANGED_WIFI) {
+    #if !defined(HOST_BUILD)
+        Serial.println("[CONFIG] WiFi credentials changed, restarting...");
+        delay(1000);
+        ESP.restart();
+    #else
+        Serial.println("[CONFIG] WiFi credentials ignored on host");
+        changed &= ~CONFIG_CHANGED_WIFI;
+    #endif
+    }
+
+    if (changed & CONFIG_CHANGED_BACKUP) {
+        stratum_set_backup_pool(config->backupPoolUrl, config->backupPoolPort,
+                               config->backupWallet, config->backupPoolPassword, config->workerName);
+    }
+    if (changed & CONFIG_CHANGED_DIFFICULTY) {
+        stratum_set_difficulty(config->targetDifficulty);
+    }
+    if (changed & CONFIG_CHANGED_POOL) {
+        // Reconnect also returns from the backup pool; the new difficulty goes out in the subscribe
+        stratum_set_pool(config->poolUrl, config->poolPort,
+                        config->wallet, config->poolPassword, config->workerName);
+        stratum_reconnect();
+    }
+
+    #if USE_DISPLAY || USE_OLED_DISPLAY
+        // Taken by the display task between frames
+        if (brightness) display_task_set_brightness(config->brightness);
+        if (rotation) display_task_set_rotation(config->rotation);
+        if (inverted) display_task_set_inverted(config->invertColors);
+    #endif
+
+    #if !defined(HOST_BUILD)
+        if (changed & CONFIG_CHANGED_TIMEZONE) {
+            configTime(config->timezoneOffset * 3600L, 0, "pool.ntp.org", "time.nist.gov");
+        }
+    #endif
+
+    if (changed & CONFIG_CHANGED_STATS) {
+        live_stats_reload();
+    }
+    if (changed & CONFIG_CHANGED_TELEMETRY) {
+        telemetry_configure(config->telemetryUrl, config->telemetryInterval);
+    }
+
+    #if !defined(HOST_BUILD)
+        if (changed & CONFIG_CHANGED_OTA) {
+            ota_check_now();
+        }
+    #else
+        changed &= ~CONFIG_CHANGED_OTA;
+    #endif
+
+    Serial.printf("[CONFIG] Applied live in %lu ms:%s%s%s%s%s%s%s%s\n",
+                  (unsigned long)(millis() - start),
+                  (changed & CONFIG_CHANGED_POOL) ? " pool" : "",
+                  (changed & CONFIG_CHANGED_BACKUP) ? " backup" : "",
+                  (changed & CONFIG_CHANGED_DIFFICULTY) ? " difficulty" : "",
+                  (changed & CONFIG_CHANGED_DISPLAY) ? " display" : "",
+                  (changed & CONFIG_CHANGED_TIMEZONE) ? " timezone" : "",
+                  (changed & CONFIG_CHANGED_STATS) ? " stats" : "",
+                  (changed & CONFIG_CHANGED_TELEMETRY) ? " telemetry" : "",
+                  (changed & CONFIG_CHANGED_OTA) ? " updates" : "");
+    return changed;
+}
@@ -0,0 +1,45 @@
+/*
+ * SparkMiner - Live Config Apply
+ * Diff a new miner_config_t against the running one and apply the
+ * changes without a reboot
+ *
+ * A pool, wallet or worker change costs one stratum reconnect (the pool
+ * handshake); difficulty is re-suggested on the open connection; display,
+ * stats and telemetry settings take effect at once. Session counters and
+ * the WiFi link are kept. Only new WiFi credentials restart the board.
+ *
+ * GPL v3 License
+ */
+
+#ifndef CONFIG_APPLY_H
+#define CONFIG_APPLY_H
+
+#include <Arduino.h>
+#include "nvs_config.h"
+
+// What changed between two configs (config_diff)
+#define CONFIG_CHANGED_WIFI         0x0001  // SSID or password: needs a restart
+#define CONFIG_CHANGED_POOL         0x0002  // Primary pool, wallet or worker: reconnect
+#define CONFIG_CHANGED_BACKUP       0x0004  // Backup pool: used on the next failover
+#define CONFIG_CHANGED_DIFFICULTY   0x0008  // Re-sent as mining.suggest_difficulty
+#define CONFIG_CHANGED_DISPLAY      0x0010  // Brightness, rotation, inversion
+#define CONFIG_CHANGED_TIMEZONE     0x0020  // NTP offset
+#define CONFIG_CHANGED_STATS        0x0040  // Proxy, HTTPS, LAN sharing, pool stats wallet
+#define CONFIG_CHANGED_TELEMETRY    0x0080  // Push target or interval
+#define CONFIG_CHANGED_OTA          0x0100  // Update manifest URL: checked at once
+
+/**
+ * Compare two configs
+ * @return CONFIG_CHANGED_* bits, 0 if nothing that matters differs
+ */
+uint32_t config_diff(const miner_config_t *from, const miner_config_t *to);
+
+/**
+ * Save a new config and apply what changed to the running miner
+ * Call from a task other than stratum (portal callback, main loop).
+ * @param next The new config; nvs_config_get() still holds the old one
+ * @return CONFIG_CHANGED_* bits that were applied
+ */
+uint32_t config_apply(const miner_config_t *next);
+
+#endif // CONFIG_APPLY_H
@@ -0,0 +1,170 @@
+/*
+ * SparkMiner - Config File Implementation
+ * Defaults and the config.json key mapping for miner_config_t
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <board_config.h>
+#include "config_file.h"
+#include "../stratum/stratum_types.h"
+#include "../stats/lan_stats.h"
+
+static void safeStrCpy(char *dest, const char *src, size_t maxLen) {
+    if (src) {
+        strncpy(dest, src, maxLen - 1);
+        dest[maxLen - 1] = '\0';
+    } else {
+        dest[0] = '\0';
+    }
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void config_file_defaults(miner_config_t *config) {
+    memset(config, 0, sizeof(miner_config_t));
+
+    // WiFi defaults (empty - will use captive portal)
+    config->ssid[0] = '\0';
+    config->wifiPassword[0] = '\0';
+
+    // Primary pool defaults
+    safeStrCpy(config->poolUrl, DEFAULT_POOL_URL, sizeof(config->poolUrl));
+    config->poolPort = DEFAULT_POOL_PORT;
+    safeStrCpy(config->poolPassword, DEFAULT_POOL_PASS, sizeof(config->poolPassword));
+    config->wallet[0] = '\0';  // Must be set by user
+
+    // Backup pool defaults
+    safeStrCpy(config->backupPoolUrl, BACKUP_POOL_URL, sizeof(config->backupPoolUrl));
+    config->backupPoolPort = BACKUP_POOL_PORT;
+    safeStrCpy(config->backupPoolPassword, DEFAULT_POOL_PASS, sizeof(config->backupPoolPassword));
+    config->backupWallet[0] = '\0';
+
+    // Display defaults
+    config->brightness = 100;
+    config->screenTimeout = 0;  // Minutes until display sleep, 0 = never
+    config->rotation = 0;       // Portrait USB Top (default)
+    config->displayEnabled = true;
+    config->invertColors = true;   // Dark theme (default) - CYD panel is inverted, so invertDisplay(true) = dark
+    config->timezoneOffset = 0;    // UTC+0 default
+
+    // Miner defaults
+    safeStrCpy(config->workerName, "SparkMiner", sizeof(config->workerName));
+    config->targetDifficulty = DESIRED_DIFFICULTY;
+
+    // Stats API defaults - HTTPS disabled by default for stability
+    config->statsProxyUrl[0] = '\0';  // No proxy by default
+    config->enableHttpsStats = false; // Direct HTTPS disabled (causes WDT crashes)
+
+    // Telemetry off until a collector is configured
+    config->telemetryUrl[0] = '\0';
+    config->telemetryInterval = TELEMETRY_INTERVAL_DEFAULT;
+
+    // Share live stats with other miners on the LAN, publish if elected
+    // Frames from the LAN are unauthenticated: sharing is opt-in
+    config->lanStats = LAN_STATS_OFF;
+
+    // No update checks until a manifest URL is set
+    config->otaUrl[0] = '\0';
+
+    config->checksum = 0;  // Will be calculated on save
+}
+
+bool config_file_apply(const JsonDocument &doc, miner_config_t *config) {
+    // WiFi settings
+    if (doc.containsKey("ssid")) {
+        safeStrCpy(config->ssid, doc["ssid"], sizeof(config->ssid));
+    }
+    if (doc.containsKey("wifi_password")) {
+        safeStrCpy(config->wifiPassword, doc["wifi_password"], sizeof(config->wifiPassword));
+    }
+
+    // Pool settings
+    if (doc.containsKey("pool_url")) {
+        safeStrCpy(config->poolUrl, doc["pool_url"], sizeof(config->poolUrl));
+    }
+    if (doc.containsKey("pool_port")) {
+        config->poolPort = doc["pool_port"];
+    }
+    if (doc.containsKey("wallet")) {
+        safeStrCpy(config->wallet, doc["wallet"], sizeof(config->wallet));
+    }
+    if (doc.containsKey("pool_password")) {
+        safeStrCpy(config->poolPassword, doc["pool_password"], sizeof(config->poolPassword));
+    }
+    if (doc.containsKey("worker_name")) {
+        safeStrCpy(config->workerName, doc["worker_name"], sizeof(config->workerName));
+    }
+
+    // Backup pool (optional)
+    if (doc.containsKey("backup_pool_url")) {
+        safeStrCpy(config->backupPoolUrl, doc["backup_pool_url"], sizeof(config->backupPoolUrl));
+    }
+    if (doc.containsKey("backup_pool_port")) {
+        config->backupPoolPort = doc["backup_pool_port"];
+    }
+    if (doc.containsKey("backup_wallet")) {
+        safeStrCpy(config->backupWallet, doc["backup_wallet"], sizeof(config->backupWallet));
+    }
+    if (doc.containsKey("backup_pool_password")) {
+        safeStrCpy(config->backupPoolPassword, doc["backup_pool_password"], sizeof(config->backupPoolPassword));
+    }
+
+    // Display settings (optional)
+    if (doc.containsKey("brightness")) {
+        config->brightness = doc["brightness"];
+    }
+    if (doc.containsKey("invert_colors")) {
+        config->invertColors = doc["invert_colors"];
+    }
+    if (doc.containsKey("rotation")) {
+        config->rotation = doc["rotation"];
+        Serial.printf("[CONFIG] Loaded rotation=%d from config file\n", config->rotation);
+    }
+    if (doc.containsKey("screen_timeout")) {
+        config->screenTimeout = doc["screen_timeout"];  // Minutes, 0 = never
+    }
+    if (doc.containsKey("timezone_offset")) {
+        config->timezoneOffset = doc["timezone_offset"];
+    }
+
+    // Miner settings (optional)
+    if (doc.containsKey("target_difficulty")) {
+        config->targetDifficulty = doc["target_difficulty"];
+    }
+
+    // Stats API settings (optional)
+    if (doc.containsKey("stats_proxy_url")) {
+        safeStrCpy(config->statsProxyUrl, doc["stats_proxy_url"], sizeof(config->statsProxyUrl));
+    }
+    if (doc.containsKey("enable_https_stats")) {
+        config->enableHttpsStats = doc["enable_https_stats"];
+    }
+
+    // Telemetry (optional)
+    if (doc.containsKey("telemetry_url")) {
+        safeStrCpy(config->telemetryUrl, doc["telemetry_url"], sizeof(config->telemetryUrl));
+    }
+    if (doc.containsKey("telemetry_interval")) {
+        config->telemetryInterval = doc["telemetry_interval"];
+    }
+    if (doc.containsKey("lan_stats")) {
+        // "off", "auto", "publish" or "listen"; anything else stays off
+        const char *mode = doc["lan_stats"];
+        if (mode && strcmp(mode, "auto") == 0) config->lanStats = LAN_STATS_AUTO;
+        else if (mode && strcmp(mode, "publish") == 0) config->lanStats = LAN_STATS_PUBLISH;
+        else if (mode && strcmp(mode, "listen") == 0) config->lanStats = LAN_STATS_LISTEN;
+        else config->lanStats = LAN_STATS_OFF;
+    }
+
+    // Firmware updates (optional)
+    if (doc.containsKey("ota_url")) {
+        safeStrCpy(config->otaUrl, doc["ota_url"], sizeof(config->otaUrl));
+    }
+
+    return config->wallet[0] != '\0';  // Valid if wallet is set
+}
@@ -0,0 +1,29 @@
+/*
+ * SparkMiner - Config File
+ * Defaults and the config.json key mapping for miner_config_t
+ *
+ * Shared by the SD card loader (nvs_config.cpp) and the sparkminer-linux
+ * daemon, so both accept the same file with the same defaults.
+ *
+ * GPL v3 License
+ */
+
+#ifndef CONFIG_FILE_H
+#define CONFIG_FILE_H
+
+#include <ArduinoJson.h>
+#include "nvs_config.h"
+
+/**
+ * Fill a config with factory defaults (pool, display, miner settings)
+ */
+void config_file_defaults(miner_config_t *config);
+
+/**
+ * Apply the keys present in a parsed config.json on top of a config
+ * Keys that are absent leave the current value untouched.
+ * @return true if a wallet is set afterwards (config is usable)
+ */
+bool config_file_apply(const JsonDocument &doc, miner_config_t *config);
+
+#endif // CONFIG_FILE_H
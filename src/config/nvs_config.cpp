@@ -10,6 +10,7 @@
 #include <ArduinoJson.h>
 #include <board_config.h>
 #include "nvs_config.h"
+#include "config_file.h"
 #include "../stratum/stratum_types.h"
 
 // SD card support - use SD_MMC for ESP32-S3 CYD, SPI SD for others
@@ -39,6 +40,20 @@
 // Magic value for checksum validation
 #define CONFIG_MAGIC 0x5350524B  // "SPRK"
 
+// Earlier layouts are a prefix of this one with the checksum straight
+// after it: before the telemetry fields (V1), before lanStats (V2) and
+// before otaUrl (V3).
+// Migrated on load instead of cleared.
+#define CONFIG_CHECKSUM_AT(prefix)  (((prefix) + 3) & ~(size_t)3)
+#define CONFIG_LAYOUT_SIZE(prefix)  ((CONFIG_CHECKSUM_AT(prefix) + sizeof(uint32_t) + alignof(miner_config_t) - 1) & \
+                                     ~(alignof(miner_config_t) - 1))
+
+static const size_t s_oldLayouts[] = {
+    offsetof(miner_config_t, telemetryUrl),
+    offsetof(miner_config_t, lanStats),
+    offsetof(miner_config_t, otaUrl),
+};
+
 static Preferences s_prefs;
 static miner_config_t s_config;
 static bool s_initialized = false;
@@ -47,26 +62,36 @@ static bool s_initialized = false;
 // Utility Functions
 // ============================================================
 
-static uint32_t calculateChecksum(const miner_config_t *config) {
-    const uint8_t *data = (const uint8_t *)config;
+static uint32_t checksumBytes(const uint8_t *data, size_t len) {
     uint32_t sum = CONFIG_MAGIC;
-
-    // Calculate checksum over all fields except the checksum itself
-    size_t len = sizeof(miner_config_t) - sizeof(uint32_t);
     for (size_t i = 0; i < len; i++) {
         sum = sum * 31 + data[i];
     }
-
     return sum;
 }
 
-static void safeStrCpy(char *dest, const char *src, size_t maxLen) {
-    if (src) {
-        strncpy(dest, src, maxLen - 1);
-        dest[maxLen - 1] = '\0';
-    } else {
-        dest[0] = '\0';
+static uint32_t calculateChecksum(const miner_config_t *config) {
+    // Calculate checksum over all fields except the checksum itself
+    return checksumBytes((const uint8_t *)config, sizeof(miner_config_t) - sizeof(uint32_t));
+}
+
+// Read an older config blob of `len` bytes (s_prefs open); new fields keep their defaults
+static bool migrateConfig(miner_config_t *config, size_t len) {
+    for (size_t prefix : s_oldLayouts) {
+        if (len != CONFIG_LAYOUT_SIZE(prefix)) continue;
+
+        uint8_t old[sizeof(miner_config_t)];
+        if (s_prefs.getBytes(NVS_KEY_CONFIG, old, len) != len) return false;
+
+        uint32_t stored;
+        memcpy(&stored, old + CONFIG_CHECKSUM_AT(prefix), sizeof(stored));
+        if (stored != checksumBytes(old, CONFIG_CHECKSUM_AT(prefix))) return false;
+
+        config_file_defaults(config);
+        memcpy(config, old, prefix);
+        return true;
     }
+    return false;
 }
 
 /**
@@ -155,78 +180,13 @@ static bool loadConfigFromFile(miner_config_t *config) {
         return false;
     }
 
-    // WiFi settings
-    if (doc.containsKey("ssid")) {
-        safeStrCpy(config->ssid, doc["ssid"], sizeof(config->ssid));
-    }
-    if (doc.containsKey("wifi_password")) {
-        safeStrCpy(config->wifiPassword, doc["wifi_password"], sizeof(config->wifiPassword));
-    }
-
-    // Pool settings
-    if (doc.containsKey("pool_url")) {
-        safeStrCpy(config->poolUrl, doc["pool_url"], sizeof(config->poolUrl));
-    }
-    if (doc.containsKey("pool_port")) {
-        config->poolPort = doc["pool_port"];
-    }
-    if (doc.containsKey("wallet")) {
-        safeStrCpy(config->wallet, doc["wallet"], sizeof(config->wallet));
-    }
-    if (doc.containsKey("pool_password")) {
-        safeStrCpy(config->poolPassword, doc["pool_password"], sizeof(config->poolPassword));
-    }
-    if (doc.containsKey("worker_name")) {
-        safeStrCpy(config->workerName, doc["worker_name"], sizeof(config->workerName));
-    }
-
-    // Backup pool (optional)
-    if (doc.containsKey("backup_pool_url")) {
-        safeStrCpy(config->backupPoolUrl, doc["backup_pool_url"], sizeof(config->backupPoolUrl));
-    }
-    if (doc.containsKey("backup_pool_port")) {
-        config->backupPoolPort = doc["backup_pool_port"];
-    }
-    if (doc.containsKey("backup_wallet")) {
-        safeStrCpy(config->backupWallet, doc["backup_wallet"], sizeof(config->backupWallet));
-    }
-    if (doc.containsKey("backup_pool_password")) {
-        safeStrCpy(config->backupPoolPassword, doc["backup_pool_password"], sizeof(config->backupPoolPassword));
-    }
-
-    // Display settings (optional)
-    if (doc.containsKey("brightness")) {
-        config->brightness = doc["brightness"];
-    }
-    if (doc.containsKey("invert_colors")) {
-        config->invertColors = doc["invert_colors"];
-    }
-    if (doc.containsKey("rotation")) {
-        config->rotation = doc["rotation"];
-        Serial.printf("[CONFIG] Loaded rotation=%d from SD\n", config->rotation);
-    }
-    if (doc.containsKey("timezone_offset")) {
-        config->timezoneOffset = doc["timezone_offset"];
-    }
-
-    // Miner settings (optional)
-    if (doc.containsKey("target_difficulty")) {
-        config->targetDifficulty = doc["target_difficulty"];
-    }
-
-    // Stats API settings (optional)
-    if (doc.containsKey("stats_proxy_url")) {
-        safeStrCpy(config->statsProxyUrl, doc["stats_proxy_url"], sizeof(config->statsProxyUrl));
-    }
-    if (doc.containsKey("enable_https_stats")) {
-        config->enableHttpsStats = doc["enable_https_stats"];
-    }
+    bool valid = config_file_apply(doc, config);
 
     // Config file stays on SD card - NOT deleted
     // It will only be read again if NVS is reset/cleared
 
     Serial.println("[CONFIG] Configuration loaded from SD card");
-    return config->wallet[0] != '\0';  // Valid if wallet is set
+    return valid;
 #endif  // HAS_SD_CARD
 }
 
@@ -424,6 +384,13 @@ bool nvs_config_load(miner_config_t *config) {
         return false;
     }
 
+    if (len != sizeof(miner_config_t) && migrateConfig(config, len)) {
+        s_prefs.end();
+        Serial.println("[NVS] Migrated config from the previous layout");
+        nvs_config_save(config);
+        return true;
+    }
+
     if (len != sizeof(miner_config_t)) {
         Serial.printf("[NVS] Config size mismatch: stored=%d, expected=%d\n", len, sizeof(miner_config_t));
         Serial.println("[NVS] Struct size changed - clearing old config");
@@ -492,41 +459,7 @@ bool nvs_config_save(const miner_config_t *config) {
 }
 
 void nvs_config_reset(miner_config_t *config) {
-    memset(config, 0, sizeof(miner_config_t));
-
-    // WiFi defaults (empty - will use captive portal)
-    config->ssid[0] = '\0';
-    config->wifiPassword[0] = '\0';
-
-    // Primary pool defaults
-    safeStrCpy(config->poolUrl, DEFAULT_POOL_URL, sizeof(config->poolUrl));
-    config->poolPort = DEFAULT_POOL_PORT;
-    safeStrCpy(config->poolPassword, DEFAULT_POOL_PASS, sizeof(config->poolPassword));
-    config->wallet[0] = '\0';  // Must be set by user
-
-    // Backup pool defaults
-    safeStrCpy(config->backupPoolUrl, BACKUP_POOL_URL, sizeof(config->backupPoolUrl));
-    config->backupPoolPort = BACKUP_POOL_PORT;
-    safeStrCpy(config->backupPoolPassword, DEFAULT_POOL_PASS, sizeof(config->backupPoolPassword));
-    config->backupWallet[0] = '\0';
-
-    // Display defaults
-    config->brightness = 100;
-    config->screenTimeout = 0;  // Never timeout
-    config->rotation = 0;       // Portrait USB Top (default)
-    config->displayEnabled = true;
-    config->invertColors = true;   // Dark theme (default) - CYD panel is inverted, so invertDisplay(true) = dark
-    config->timezoneOffset = 0;    // UTC+0 default
-
-    // Miner defaults
-    safeStrCpy(config->workerName, "SparkMiner", sizeof(config->workerName));
-    config->targetDifficulty = DESIRED_DIFFICULTY;
-
-    // Stats API defaults - HTTPS disabled by default for stability
-    config->statsProxyUrl[0] = '\0';  // No proxy by default
-    config->enableHttpsStats = false; // Direct HTTPS disabled (causes WDT crashes)
-
-    config->checksum = 0;  // Will be calculated on save
+    config_file_defaults(config);
 }
 
 miner_config_t* nvs_config_get() {
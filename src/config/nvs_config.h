@@ -34,7 +34,7 @@ typedef struct {
 
     // Display settings
     uint8_t brightness;
-    uint8_t screenTimeout;
+    uint8_t screenTimeout;  // Minutes of inactivity before display sleeps (0 = never)
     uint8_t rotation;       // Screen rotation (0-3)
     bool displayEnabled;
     bool invertColors;      // Invert display colors
@@ -51,6 +51,17 @@ typedef struct {
     char statsProxyUrl[128];    // HTTP proxy for stats APIs (supports auth)
     bool enableHttpsStats;      // Manual override for direct HTTPS (default: false)
 
+    // Telemetry push (stats/telemetry.h), e.g. udp://10.0.0.2:9100 or mqtt://host/topic
+    char telemetryUrl[96];      // Empty = off
+    uint16_t telemetryInterval; // Seconds between pushes
+
+    // Live stats shared over the LAN (stats/lan_stats.h): LAN_STATS_OFF/AUTO/PUBLISH/LISTEN
+    uint8_t lanStats;
+
+    // Firmware update manifest (ota/ota_update.h), e.g. http://10.0.0.2:8000/ota.json
+    char otaUrl[128];           // Empty = no update checks
+
+
     // Checksum for validation
     uint32_t checksum;
 } miner_config_t;
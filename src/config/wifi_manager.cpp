@@ -6,16 +6,23 @@
 #include <Arduino.h>
 #include <WiFiManager.h>
 #include <board_config.h>
+#include <fixed_string.h>
 #include "wifi_manager.h"
 #include "nvs_config.h"
-#include "../stratum/stratum.h"
+#include "config_apply.h"
 #include "../display/display.h"
+#include "../stats/mem_place.h"
+#include "../stats/heap_track.h"
+#include "../stats/telemetry.h"
+#include "../stats/lan_stats.h"
 
 // WiFiManager instance
 static WiFiManager s_wm;
 static bool s_initialized = false;
 static bool s_portalRunning = false;
-static char s_ipAddress[16] = "0.0.0.0";
+static bool s_settingsOpen = false;     // Settings page on the station IP, see wifi_manager_open_settings()
+static uint32_t s_settingsOpenedAt = 0;
+static FixedString<15> s_ipAddress("0.0.0.0");
 
 // Custom parameters
 static WiFiManagerParameter* s_paramWallet = NULL;
@@ -32,11 +39,17 @@ static WiFiManagerParameter* s_paramBackupPoolPassword = NULL;
 static WiFiManagerParameter* s_paramBrightness = NULL;
 static WiFiManagerParameter* s_paramDifficulty = NULL;
 
-// Custom HTML parameters buffers
-static char s_rotationHtml[1024];
-static char s_invertHtml[512];
-static char s_brightnessHtml[512];
-static char s_difficultyHtml[768];
+// Custom HTML parameter buffers; only read while the portal serves a page
+typedef struct {
+    FixedString<511> brightness;
+    FixedString<767> difficulty;
+    FixedString<1023> rotation;
+    FixedString<2047> tzOffset;
+    FixedString<511> invert;
+    FixedString<511> httpsStats;
+    FixedString<511> lanStats;
+} portal_html_t;
+static portal_html_t *s_html = NULL;    // Placed by wifi_manager_init
 static WiFiManagerParameter* s_paramRotation = NULL;
 static WiFiManagerParameter* s_paramTimezone = NULL;
 static WiFiManagerParameter* s_paramInvert = NULL;
@@ -45,11 +58,136 @@ static WiFiManagerParameter* s_paramInvert = NULL;
 static WiFiManagerParameter* s_paramStatsHeader = NULL;
 static WiFiManagerParameter* s_paramStatsProxy = NULL;
 static WiFiManagerParameter* s_paramHttpsStats = NULL;
-static char s_httpsStatsHtml[512];
+static WiFiManagerParameter* s_paramTelemetryUrl = NULL;
+static WiFiManagerParameter* s_paramTelemetryInterval = NULL;
+static WiFiManagerParameter* s_paramLanStats = NULL;
+static WiFiManagerParameter* s_paramOtaUrl = NULL;
 
 // Buffers for text inputs only
 static char s_bufPoolPort[8];
 static char s_bufBackupPort[8];
+static char s_bufTelemetryInterval[8];
+static char s_bufBrightness[8];
+static char s_bufDifficulty[16];
+static char s_bufRotation[4];
+static char s_bufTimezone[8];
+static char s_bufLanStats[4];
+
+// ============================================================ 
+// Helpers
+// ============================================================ 
+
+// Dotted quad without IPAddress::toString(), which builds a heap String
+static FixedString<15> formatIp(const IPAddress &ip) {
+    FixedString<15> text;
+    text.printf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return text;
+}
+
+// Form values and dropdown HTML from a config. Run again before the
+// settings page reopens so it shows what is running, not what booted.
+static void fillPortalValues(const miner_config_t *config) {
+    snprintf(s_bufPoolPort, sizeof(s_bufPoolPort), "%d", config->poolPort);
+    snprintf(s_bufBackupPort, sizeof(s_bufBackupPort), "%d", config->backupPoolPort);
+    snprintf(s_bufTelemetryInterval, sizeof(s_bufTelemetryInterval), "%u", config->telemetryInterval);
+
+    // Brightness dropdown
+    const int brightValues[] = {10, 25, 50, 75, 100};
+    s_html->brightness = "<br><select name='bright'>";
+    for(int i=0; i<5; i++) {
+        s_html->brightness.appendf("<option value='%d'%s>%d%%</option>",
+            brightValues[i],
+            (config->brightness == brightValues[i]) ? " selected" : "",
+            brightValues[i]);
+    }
+    s_html->brightness += "</select>";
+    // Use config value as default for hidden input (not hardcoded)
+    snprintf(s_bufBrightness, sizeof(s_bufBrightness), "%d", config->brightness);
+
+    // Difficulty dropdown (common solo mining values)
+    const double diffValues[] = {0.00001, 0.0001, 0.001, 0.0014, 0.01, 0.1, 1.0};
+    const char* diffLabels[] = {"0.00001 (Easiest)", "0.0001", "0.001", "0.0014 (Default)", "0.01", "0.1", "1.0 (Hardest)"};
+    s_html->difficulty = "<br><select name='diff'>";
+    for(int i=0; i<7; i++) {
+        // Check if current difficulty matches (within small epsilon)
+        bool selected = (config->targetDifficulty > diffValues[i] * 0.99 &&
+                        config->targetDifficulty < diffValues[i] * 1.01);
+        s_html->difficulty.appendf("<option value='%.6f'%s>%s</option>",
+            diffValues[i],
+            selected ? " selected" : "",
+            diffLabels[i]);
+    }
+    s_html->difficulty += "</select>";
+    // Use config value as default for hidden input
+    snprintf(s_bufDifficulty, sizeof(s_bufDifficulty), "%.6f", config->targetDifficulty);
+
+    // Custom HTML for Rotation
+    // TFT rotation: 0,2=Portrait, 1,3=Landscape (ILI9341 standard)
+    // USB position based on CYD board physical layout
+    const char* rotLabels[] = {
+        "Portrait - USB Bottom",
+        "Landscape - USB Right",
+        "Portrait - USB Top",
+        "Landscape - USB Left"
+    };
+    
+    s_html->rotation = "<br><select name='rotation'>";
+    for(int i=0; i<4; i++) {
+        s_html->rotation.appendf("<option value='%d'%s>%s</option>",
+            i,
+            (config->rotation == i) ? " selected" : "",
+            rotLabels[i]);
+    }
+    s_html->rotation += "</select>";
+    // Use config value as default for hidden input
+    snprintf(s_bufRotation, sizeof(s_bufRotation), "%d", config->rotation);
+
+    // Timezone dropdown
+    // Common timezones from UTC-12 to UTC+14
+    s_html->tzOffset = "<br><select name='tz'>";
+    for (int i = -12; i <= 14; i++) {
+        s_html->tzOffset.appendf("<option value='%d'%s>UTC%s%d</option>",
+            i,
+            (config->timezoneOffset == i) ? " selected" : "",
+            (i >= 0) ? "+" : "",
+            i);
+    }
+    s_html->tzOffset += "</select>";
+    // Use config value as default for hidden input
+    snprintf(s_bufTimezone, sizeof(s_bufTimezone), "%d", config->timezoneOffset);
+
+    // Custom HTML for Color Theme
+    // invert_colors=true means light mode (white bg), false means dark mode (black bg)
+    s_html->invert.printf("<br><select name='invert'>"
+        "<option value='0'%s>Dark (Default)</option>"
+        "<option value='1'%s>Light</option></select>",
+        !config->invertColors ? " selected" : "",
+        config->invertColors ? " selected" : "");
+
+    s_html->httpsStats.printf("<br><select name='https_stats'>"
+        "<option value='0'%s>Direct HTTPS: Disabled (Stable)</option>"
+        "<option value='1'%s>Direct HTTPS: Enabled (Unstable)</option></select>",
+        !config->enableHttpsStats ? " selected" : "",
+        config->enableHttpsStats ? " selected" : "");
+
+    uint8_t lanMode = config->lanStats <= LAN_STATS_LISTEN ? config->lanStats : LAN_STATS_OFF;
+    s_html->lanStats.printf("<br><select name='lan_stats'>"
+        "<option value='0'%s>LAN Stats: Off (Default)</option>"
+        "<option value='1'%s>LAN Stats: Share</option>"
+        "<option value='2'%s>LAN Stats: Prefer to Publish</option>"
+        "<option value='3'%s>LAN Stats: Listen Only</option></select>",
+        lanMode == LAN_STATS_OFF ? " selected" : "",
+        lanMode == LAN_STATS_AUTO ? " selected" : "",
+        lanMode == LAN_STATS_PUBLISH ? " selected" : "",
+        lanMode == LAN_STATS_LISTEN ? " selected" : "");
+    snprintf(s_bufLanStats, sizeof(s_bufLanStats), "%u", lanMode);
+
+    if (s_html->brightness.truncated() || s_html->difficulty.truncated() || s_html->rotation.truncated() ||
+        s_html->tzOffset.truncated() || s_html->invert.truncated() || s_html->httpsStats.truncated() ||
+        s_html->lanStats.truncated()) {
+        Serial.println("[WIFI] WARNING: Portal option list truncated");
+    }
+}
 
 // ============================================================ 
 // Callbacks
@@ -58,7 +196,9 @@ static char s_bufBackupPort[8];
 static void saveParamsCallback() {
     Serial.println("[WIFI] Saving configuration...");
 
-    miner_config_t *config = nvs_config_get();
+    // Edit a copy; config_apply() compares it with the running config
+    miner_config_t next = *nvs_config_get();
+    miner_config_t *config = &next;
 
     // Primary Pool
     if (s_paramWallet && strlen(s_paramWallet->getValue()) > 0) {
@@ -121,37 +261,40 @@ static void saveParamsCallback() {
         config->enableHttpsStats = (atoi(s_paramHttpsStats->getValue()) == 1);
     }
 
-    // Save to NVS
-    if (nvs_config_save(config)) {
-        Serial.println("[WIFI] Configuration saved successfully");
-
-        // Apply display settings immediately
-        #if USE_DISPLAY || USE_OLED_DISPLAY
-            display_set_brightness(config->brightness);
-            display_set_rotation(config->rotation);
-            display_set_inverted(config->invertColors);
-        #endif
-
-        // Update stratum
-        stratum_set_pool(config->poolUrl, config->poolPort,
-                        config->wallet, config->poolPassword, config->workerName);
-        stratum_reconnect();
-    } else {
-        Serial.println("[WIFI] Failed to save configuration");
+    // Telemetry
+    if (s_paramTelemetryUrl) {
+        strncpy(config->telemetryUrl, s_paramTelemetryUrl->getValue(), sizeof(config->telemetryUrl) - 1);
+        config->telemetryUrl[sizeof(config->telemetryUrl) - 1] = '\0';
+    }
+    if (s_paramTelemetryInterval) {
+        int interval = atoi(s_paramTelemetryInterval->getValue());
+        config->telemetryInterval = interval > 0 ? interval : TELEMETRY_INTERVAL_DEFAULT;
+    }
+    if (s_paramLanStats) {
+        int mode = atoi(s_paramLanStats->getValue());
+        config->lanStats = (mode >= LAN_STATS_OFF && mode <= LAN_STATS_LISTEN) ? mode : LAN_STATS_OFF;
     }
+    if (s_paramOtaUrl) {
+        strncpy(config->otaUrl, s_paramOtaUrl->getValue(), sizeof(config->otaUrl) - 1);
+        config->otaUrl[sizeof(config->otaUrl) - 1] = '\0';
+    }
+
+    // Save to NVS and apply what changed, without a restart
+    config_apply(config);
 }
 
 static void configModeCallback(WiFiManager *wm) {
     Serial.println("[WIFI] Entered config mode");
     Serial.printf("[WIFI] AP: %s\n", wm->getConfigPortalSSID().c_str());
-    Serial.printf("[WIFI] IP: %s\n", WiFi.softAPIP().toString().c_str());
+    FixedString<15> apIp = formatIp(WiFi.softAPIP());
+    Serial.printf("[WIFI] IP: %s\n", apIp.c_str());
     s_portalRunning = true;
 
     #if USE_DISPLAY
         display_show_ap_config(
             wm->getConfigPortalSSID().c_str(),
             AP_PASSWORD,
-            WiFi.softAPIP().toString().c_str()
+            apIp.c_str()
         );
     #endif
 }
@@ -163,6 +306,9 @@ static void configModeCallback(WiFiManager *wm) {
 void wifi_manager_init() {
     if (s_initialized) return;
 
+    // Parameters, WiFiManager and its web server count as the portal (stats/heap_track.h)
+    heap_track_scope_begin(HEAP_TAG_PORTAL);
+
     miner_config_t *config = nvs_config_get();
 
     // Create AP SSID
@@ -172,8 +318,8 @@ void wifi_manager_init() {
     snprintf(apSSID, sizeof(apSSID), "%s%02X%02X", AP_SSID_PREFIX, mac[4], mac[5]);
 
     // Prepare Buffers
-    snprintf(s_bufPoolPort, sizeof(s_bufPoolPort), "%d", config->poolPort);
-    snprintf(s_bufBackupPort, sizeof(s_bufBackupPort), "%d", config->backupPoolPort);
+    s_html = mem_place_new<portal_html_t>("portal html");
+    fillPortalValues(config);
 
     // Create Parameters
     // We use 'new' to allocate persistent objects as WiFiManager stores pointers
@@ -189,116 +335,26 @@ void wifi_manager_init() {
     s_paramBackupWallet = new WiFiManagerParameter("bk_wallet", "Backup Wallet (optional)", config->backupWallet, MAX_WALLET_LEN);
     s_paramBackupPoolPassword = new WiFiManagerParameter("bk_pool_pass", "Backup Password", config->backupPoolPassword, MAX_PASSWORD_LEN);
 
-    // Brightness dropdown
-    const int brightValues[] = {10, 25, 50, 75, 100};
-    strcpy(s_brightnessHtml, "<br><select name='bright'>");
-    for(int i=0; i<5; i++) {
-        char opt[64];
-        sprintf(opt, "<option value='%d'%s>%d%%</option>",
-            brightValues[i],
-            (config->brightness == brightValues[i]) ? " selected" : "",
-            brightValues[i]);
-        strcat(s_brightnessHtml, opt);
-    }
-    strcat(s_brightnessHtml, "</select>");
-    // Use config value as default for hidden input (not hardcoded)
-    static char s_bufBrightness[8];
-    snprintf(s_bufBrightness, sizeof(s_bufBrightness), "%d", config->brightness);
-    s_paramBrightness = new WiFiManagerParameter("bright", "Brightness", s_bufBrightness, 4, s_brightnessHtml);
-    // Difficulty dropdown (common solo mining values)
-    const double diffValues[] = {0.00001, 0.0001, 0.001, 0.0014, 0.01, 0.1, 1.0};
-    const char* diffLabels[] = {"0.00001 (Easiest)", "0.0001", "0.001", "0.0014 (Default)", "0.01", "0.1", "1.0 (Hardest)"};
-    strcpy(s_difficultyHtml, "<br><select name='diff'>");
-    for(int i=0; i<7; i++) {
-        char opt[96];
-        // Check if current difficulty matches (within small epsilon)
-        bool selected = (config->targetDifficulty > diffValues[i] * 0.99 &&
-                        config->targetDifficulty < diffValues[i] * 1.01);
-        sprintf(opt, "<option value='%.6f'%s>%s</option>",
-            diffValues[i],
-            selected ? " selected" : "",
-            diffLabels[i]);
-        strcat(s_difficultyHtml, opt);
-    }
-    strcat(s_difficultyHtml, "</select>");
-    // Use config value as default for hidden input
-    static char s_bufDifficulty[16];
-    snprintf(s_bufDifficulty, sizeof(s_bufDifficulty), "%.6f", config->targetDifficulty);
-    s_paramDifficulty = new WiFiManagerParameter("diff", "Target Difficulty", s_bufDifficulty, 10, s_difficultyHtml);
-
-    // Custom HTML for Rotation
-    // TFT rotation: 0,2=Portrait, 1,3=Landscape (ILI9341 standard)
-    // USB position based on CYD board physical layout
-    const char* rotLabels[] = {
-        "Portrait - USB Bottom",
-        "Landscape - USB Right",
-        "Portrait - USB Top",
-        "Landscape - USB Left"
-    };
-    
-    strcpy(s_rotationHtml, "<br><select name='rotation'>");
-    for(int i=0; i<4; i++) {
-        strcat(s_rotationHtml, "<option value='");
-        char val[2]; sprintf(val, "%d", i);
-        strcat(s_rotationHtml, val);
-        strcat(s_rotationHtml, "'");
-        if(config->rotation == i) strcat(s_rotationHtml, " selected");
-        strcat(s_rotationHtml, ">");
-        strcat(s_rotationHtml, rotLabels[i]);
-        strcat(s_rotationHtml, "</option>");
-    }
-    strcat(s_rotationHtml, "</select>");
-    // Use config value as default for hidden input
-    static char s_bufRotation[4];
-    snprintf(s_bufRotation, sizeof(s_bufRotation), "%d", config->rotation);
-    s_paramRotation = new WiFiManagerParameter("rotation", "Screen Rotation", s_bufRotation, 2, s_rotationHtml);
-
-    // Timezone dropdown
-    // Common timezones from UTC-12 to UTC+14
-    static char s_timezoneHtml[2048];
-    strcpy(s_timezoneHtml, "<br><select name='tz'>");
-    for (int i = -12; i <= 14; i++) {
-        char opt[128];
-        sprintf(opt, "<option value='%d'%s>UTC%s%d</option>",
-            i,
-            (config->timezoneOffset == i) ? " selected" : "",
-            (i >= 0) ? "+" : "",
-            i);
-        strcat(s_timezoneHtml, opt);
-    }
-    strcat(s_timezoneHtml, "</select>");
-    // Use config value as default for hidden input
-    static char s_bufTimezone[8];
-    snprintf(s_bufTimezone, sizeof(s_bufTimezone), "%d", config->timezoneOffset);
-    s_paramTimezone = new WiFiManagerParameter("tz", "Timezone Offset", s_bufTimezone, 4, s_timezoneHtml);
-
-    // Custom HTML for Color Theme
-    // invert_colors=true means light mode (white bg), false means dark mode (black bg)
-    strcpy(s_invertHtml, "<br><select name='invert'>");
-    strcat(s_invertHtml, "<option value='0'");
-    if(!config->invertColors) strcat(s_invertHtml, " selected");
-    strcat(s_invertHtml, ">Dark (Default)</option>");
-    strcat(s_invertHtml, "<option value='1'");
-    if(config->invertColors) strcat(s_invertHtml, " selected");
-    strcat(s_invertHtml, ">Light</option></select>");
-    // Use config value as default for hidden input
-    s_paramInvert = new WiFiManagerParameter("invert", "Color Theme", config->invertColors ? "1" : "0", 2, s_invertHtml);
+    // Dropdowns: the select is the custom HTML, the hidden input carries the value
+    s_paramBrightness = new WiFiManagerParameter("bright", "Brightness", s_bufBrightness, 4, s_html->brightness.c_str());
+    s_paramDifficulty = new WiFiManagerParameter("diff", "Target Difficulty", s_bufDifficulty, 10, s_html->difficulty.c_str());
+    s_paramRotation = new WiFiManagerParameter("rotation", "Screen Rotation", s_bufRotation, 2, s_html->rotation.c_str());
+    s_paramTimezone = new WiFiManagerParameter("tz", "Timezone Offset", s_bufTimezone, 4, s_html->tzOffset.c_str());
+    s_paramInvert = new WiFiManagerParameter("invert", "Color Theme", config->invertColors ? "1" : "0", 2, s_html->invert.c_str());
 
     // Stats API Settings
     const char* statsHeader = "<br><h3>Stats API Settings</h3><div style='font-size:80%;color:#aaa'>Proxy offloads SSL from ESP32. Recommended for HTTPS.</div>";
     s_paramStatsHeader = new WiFiManagerParameter(statsHeader);
 
     s_paramStatsProxy = new WiFiManagerParameter("stats_proxy", "Proxy URL (http://host:port)", config->statsProxyUrl, 128);
+    s_paramHttpsStats = new WiFiManagerParameter("https_stats", "Direct HTTPS", config->enableHttpsStats ? "1" : "0", 2, s_html->httpsStats.c_str());
 
-    strcpy(s_httpsStatsHtml, "<br><select name='https_stats'>");
-    strcat(s_httpsStatsHtml, "<option value='0'");
-    if(!config->enableHttpsStats) strcat(s_httpsStatsHtml, " selected");
-    strcat(s_httpsStatsHtml, ">Direct HTTPS: Disabled (Stable)</option>");
-    strcat(s_httpsStatsHtml, "<option value='1'");
-    if(config->enableHttpsStats) strcat(s_httpsStatsHtml, " selected");
-    strcat(s_httpsStatsHtml, ">Direct HTTPS: Enabled (Unstable)</option></select>");
-    // Use config value as default for hidden input
-    s_paramHttpsStats = new WiFiManagerParameter("https_stats", "Direct HTTPS", config->enableHttpsStats ? "1" : "0", 2, s_httpsStatsHtml);
+    s_paramTelemetryUrl = new WiFiManagerParameter("tele_url", "Telemetry (udp://host:port or mqtt://host/topic)",
+                                                   config->telemetryUrl, sizeof(config->telemetryUrl) - 1);
+    s_paramTelemetryInterval = new WiFiManagerParameter("tele_int", "Telemetry Interval (s)", s_bufTelemetryInterval, 5);
+    s_paramLanStats = new WiFiManagerParameter("lan_stats", "LAN Stats", s_bufLanStats, 2, s_html->lanStats.c_str());
+    s_paramOtaUrl = new WiFiManagerParameter("ota_url", "Firmware Updates (http://host/ota.json)",
+                                             config->otaUrl, sizeof(config->otaUrl) - 1);
 
     // Configure WiFiManager
     s_wm.setDebugOutput(false);
@@ -393,6 +449,12 @@ void wifi_manager_init() {
     s_wm.addParameter(s_paramStatsHeader);
     s_wm.addParameter(s_paramStatsProxy);
     s_wm.addParameter(s_paramHttpsStats);
+    s_wm.addParameter(s_paramTelemetryUrl);
+    s_wm.addParameter(s_paramTelemetryInterval);
+    s_wm.addParameter(s_paramLanStats);
+    s_wm.addParameter(s_paramOtaUrl);
+
+    heap_track_scope_end();
 
     s_initialized = true;
     Serial.println("[WIFI] Manager initialized");
@@ -422,12 +484,14 @@ void wifi_manager_blocking() {
     Serial.printf("[WIFI] Connect to AP '%s' to configure\n", apSSID);
 
     // Try to connect, fall back to AP if needed
+    heap_track_scope_begin(HEAP_TAG_PORTAL);
     bool connected = s_wm.autoConnect(apSSID, AP_PASSWORD);
+    heap_track_scope_end();
 
     if (connected) {
         Serial.println("[WIFI] Connected!");
-        Serial.printf("[WIFI] IP: %s\n", WiFi.localIP().toString().c_str());
-        strncpy(s_ipAddress, WiFi.localIP().toString().c_str(), sizeof(s_ipAddress));
+        s_ipAddress = formatIp(WiFi.localIP());
+        Serial.printf("[WIFI] IP: %s\n", s_ipAddress.c_str());
 
         // Save WiFi credentials to our config
         strncpy(config->ssid, WiFi.SSID().c_str(), MAX_SSID_LENGTH);
@@ -494,8 +558,8 @@ void wifi_manager_start() {
         Serial.println();
 
         if (WiFi.status() == WL_CONNECTED) {
-            Serial.printf("[WIFI] Connected! IP: %s\n", WiFi.localIP().toString().c_str());
-            strncpy(s_ipAddress, WiFi.localIP().toString().c_str(), sizeof(s_ipAddress));
+            s_ipAddress = formatIp(WiFi.localIP());
+            Serial.printf("[WIFI] Connected! IP: %s\n", s_ipAddress.c_str());
             
             // Configure NTP
             long gmtOffset = config->timezoneOffset * 3600L;
@@ -512,10 +576,59 @@ void wifi_manager_start() {
 
 void wifi_manager_process() {
     if (s_portalRunning) {
+        heap_track_scope_begin(HEAP_TAG_PORTAL);
         s_wm.process();
+        heap_track_scope_end();
+    }
+
+    if (s_settingsOpen && millis() - s_settingsOpenedAt > WIFI_SETTINGS_OPEN_MS) {
+        s_wm.stopWebPortal();
+        s_settingsOpen = false;
+        s_portalRunning = false;
+        Serial.println("[WIFI] Settings page closed");
     }
 }
 
+bool wifi_manager_open_settings() {
+    if (s_portalRunning || WiFi.status() != WL_CONNECTED) return false;
+    if (!s_initialized) wifi_manager_init();
+
+    // The form shows the running config, including changes made since boot
+    const miner_config_t *config = nvs_config_get();
+    fillPortalValues(config);
+    s_paramWallet->setValue(config->wallet, MAX_WALLET_LEN);
+    s_paramWorkerName->setValue(config->workerName, 31);
+    s_paramPoolUrl->setValue(config->poolUrl, MAX_POOL_URL_LEN);
+    s_paramPoolPort->setValue(s_bufPoolPort, 6);
+    s_paramPoolPassword->setValue(config->poolPassword, MAX_PASSWORD_LEN);
+    s_paramBackupPoolUrl->setValue(config->backupPoolUrl, MAX_POOL_URL_LEN);
+    s_paramBackupPoolPort->setValue(s_bufBackupPort, 6);
+    s_paramBackupWallet->setValue(config->backupWallet, MAX_WALLET_LEN);
+    s_paramBackupPoolPassword->setValue(config->backupPoolPassword, MAX_PASSWORD_LEN);
+    s_paramBrightness->setValue(s_bufBrightness, 4);
+    s_paramDifficulty->setValue(s_bufDifficulty, 10);
+    s_paramRotation->setValue(s_bufRotation, 2);
+    s_paramTimezone->setValue(s_bufTimezone, 4);
+    s_paramInvert->setValue(config->invertColors ? "1" : "0", 2);
+    s_paramStatsProxy->setValue(config->statsProxyUrl, 128);
+    s_paramHttpsStats->setValue(config->enableHttpsStats ? "1" : "0", 2);
+    s_paramTelemetryUrl->setValue(config->telemetryUrl, sizeof(config->telemetryUrl) - 1);
+    s_paramTelemetryInterval->setValue(s_bufTelemetryInterval, 5);
+    s_paramLanStats->setValue(s_bufLanStats, 2);
+    s_paramOtaUrl->setValue(config->otaUrl, sizeof(config->otaUrl) - 1);
+
+    heap_track_scope_begin(HEAP_TAG_PORTAL);
+    s_wm.startWebPortal();
+    heap_track_scope_end();
+
+    s_portalRunning = true;
+    s_settingsOpen = true;
+    s_settingsOpenedAt = millis();
+    Serial.printf("[WIFI] Settings page open for %d min at http://%s/param\n",
+                  WIFI_SETTINGS_OPEN_MS / 60000, s_ipAddress.c_str());
+    return true;
+}
+
 bool wifi_manager_is_connected() {
     return WiFi.status() == WL_CONNECTED;
 }
@@ -535,5 +648,5 @@ void wifi_manager_reset() {
 }
 
 const char* wifi_manager_get_ip() {
-    return s_ipAddress;
+    return s_ipAddress.c_str();
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 
 #include <Arduino.h>
 
+#define WIFI_SETTINGS_OPEN_MS   600000  // Settings page stays up 10 minutes
+
 /**
  * Initialize WiFi manager
  * - Tries to connect to stored WiFi
@@ -36,6 +38,14 @@ void wifi_manager_start();
  */
 void wifi_manager_process();
 
+/**
+ * Serve the settings form on the station IP while mining (no AP)
+ * Saved changes go through config_apply(), so most take effect without a
+ * restart. Closes after WIFI_SETTINGS_OPEN_MS; needs wifi_manager_process().
+ * @return true if opened, false if not connected or a portal already runs
+ */
+bool wifi_manager_open_settings();
+
 /**
  * Check if WiFi is connected
  */
@@ -15,6 +15,9 @@
 
 #include <SPI.h>
 #include <TFT_eSPI.h>
+#include "glyph_cache.h"
+#include "display_format.h"
+#include "../stats/history.h"
 
 // ============================================================
 // Configuration
@@ -23,11 +26,16 @@
 // CYD 2.8" specific pins
 #if defined(ESP32_2432S028)
     #define LCD_BL_PIN      21
+#endif
+
+// CYD XPT2046 touch controller, on its own SPI pins
+#if defined(TOUCH_TYPE_XPT2046)
     #define TOUCH_CS_PIN    33
     #define TOUCH_IRQ_PIN   36
     #define TOUCH_MOSI_PIN  32
     #define TOUCH_MISO_PIN  39
     #define TOUCH_CLK_PIN   25
+    #define TOUCH_DEBOUNCE_MS 50    // PENIRQ changes sooner than this after the last are bounce
 #endif
 
 // S3 CYD / Waveshare ESP32-S3-Touch-LCD-2.8 specific pins
@@ -94,6 +102,13 @@ static uint8_t s_rotation = 1;  // Current rotation (0-3)
 static bool s_needsRedraw = true;
 static display_data_t s_lastData;
 
+#ifdef HOST_BUILD
+// Host framebuffer backend: expose the canvas for benchmarks and PNG dumps
+TFT_eSPI *display_fb_canvas() {
+    return &s_tft;
+}
+#endif
+
 // ============================================================
 // Helper Functions
 // ============================================================
@@ -115,61 +130,13 @@ static void setBacklight(uint8_t percent) {
     ledcWrite(LEDC_CHANNEL, duty);
 }
 
-static String formatHashrate(double hashrate) {
-    if (hashrate >= 1e9) {
-        return String(hashrate / 1e9, 2) + " GH/s";
-    } else if (hashrate >= 1e6) {
-        return String(hashrate / 1e6, 2) + " MH/s";
-    } else if (hashrate >= 1e3) {
-        return String(hashrate / 1e3, 2) + " KH/s";
-    } else {
-        return String(hashrate, 1) + " H/s";
-    }
-}
-
-static String formatNumber(uint64_t num) {
-    if (num >= 1e12) {
-        return String((double)num / 1e12, 2) + "T";
-    } else if (num >= 1e9) {
-        return String((double)num / 1e9, 2) + "G";
-    } else if (num >= 1e6) {
-        return String((double)num / 1e6, 2) + "M";
-    } else if (num >= 1e3) {
-        return String((double)num / 1e3, 2) + "K";
-    } else {
-        return String((uint32_t)num);
-    }
-}
-
-static String formatUptime(uint32_t seconds) {
-    uint32_t days = seconds / 86400;
-    uint32_t hours = (seconds % 86400) / 3600;
-    uint32_t mins = (seconds % 3600) / 60;
-    uint32_t secs = seconds % 60;
-
-    if (days > 0) {
-        return String(days) + "d " + String(hours) + "h";
-    } else if (hours > 0) {
-        return String(hours) + "h " + String(mins) + "m";
-    } else {
-        return String(mins) + "m " + String(secs) + "s";
-    }
-}
-
-static String formatDifficulty(double diff) {
-    if (diff >= 1e15) {
-        return String(diff / 1e15, 2) + "P";
-    } else if (diff >= 1e12) {
-        return String(diff / 1e12, 2) + "T";
-    } else if (diff >= 1e9) {
-        return String(diff / 1e9, 2) + "G";
-    } else if (diff >= 1e6) {
-        return String(diff / 1e6, 2) + "M";
-    } else if (diff >= 1e3) {
-        return String(diff / 1e3, 2) + "K";
-    } else {
-        return String(diff, 4);
-    }
+// Numeric fields are blitted from the glyph cache (one window per string,
+// opaque on bg); anything the cache cannot draw takes the normal GLCD path
+static void printField(const char *text, uint8_t size, uint16_t fg, uint16_t bg = COLOR_PANEL) {
+    if (glyph_cache_draw(&s_tft, text, size, fg, bg)) return;
+    s_tft.setTextSize(size);
+    s_tft.setTextColor(fg);
+    s_tft.print(text);
 }
 
 // Color coding helpers for status indicators
@@ -397,8 +364,8 @@ static void drawMiningScreen(const display_data_t *data) {
 
     s_tft.setTextSize(2);
     s_tft.setCursor(MARGIN + 4, y + 6);
-    s_tft.setTextColor(COLOR_ACCENT);
-    s_tft.print(formatHashrate(data->hashRate));
+    char value[DISPLAY_FORMAT_LEN];
+    printField(display_format_hashrate(value, sizeof(value), data->hashRate), 2, COLOR_ACCENT);
 
     // Shares on right side of hashrate panel
     // Portrait: shift toward center to fit 5+ digit share counts (e.g., "12345/12345")
@@ -407,10 +374,10 @@ static void drawMiningScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(sharesX, y + 4);
     s_tft.print("Shares");
-    s_tft.setTextColor(COLOR_FG);
     s_tft.setCursor(sharesX, y + 16);
-    String shares = String(data->sharesAccepted) + "/" + String(data->sharesAccepted + data->sharesRejected);
-    s_tft.print(shares);
+    snprintf(value, sizeof(value), "%lu/%lu", (unsigned long)data->sharesAccepted,
+             (unsigned long)(data->sharesAccepted + data->sharesRejected));
+    printField(value, 1, COLOR_FG);
 
     y += 44;
 
@@ -422,14 +389,20 @@ static void drawMiningScreen(const display_data_t *data) {
     int cols = isPortrait ? 2 : 3;
     int boxW = (w - (cols + 1) * MARGIN) / cols;
 
-    struct { const char *label; String value; uint16_t color; } stats[] = {
-        {"Best",     formatDifficulty(data->bestDifficulty), COLOR_SPARK1},
-        {"Hashes",   formatNumber(data->totalHashes), COLOR_FG},
-        {"Uptime",   formatUptime(data->uptimeSeconds), COLOR_FG},
-        {"Jobs",     String(data->templates), COLOR_FG},
-        {"32-bit",   String(data->blocks32), COLOR_SPARK2},
-        {"Blocks",   String(data->blocksFound), COLOR_SUCCESS},
+    struct { const char *label; char value[DISPLAY_FORMAT_LEN]; uint16_t color; } stats[] = {
+        {"Best",     "", COLOR_SPARK1},
+        {"Hashes",   "", COLOR_FG},
+        {"Uptime",   "", COLOR_FG},
+        {"Jobs",     "", COLOR_FG},
+        {"32-bit",   "", COLOR_SPARK2},
+        {"Blocks",   "", COLOR_SUCCESS},
     };
+    display_format_difficulty(stats[0].value, DISPLAY_FORMAT_LEN, data->bestDifficulty);
+    display_format_number(stats[1].value, DISPLAY_FORMAT_LEN, data->totalHashes);
+    display_format_uptime(stats[2].value, DISPLAY_FORMAT_LEN, data->uptimeSeconds);
+    snprintf(stats[3].value, DISPLAY_FORMAT_LEN, "%lu", (unsigned long)data->templates);
+    snprintf(stats[4].value, DISPLAY_FORMAT_LEN, "%lu", (unsigned long)data->blocks32);
+    snprintf(stats[5].value, DISPLAY_FORMAT_LEN, "%lu", (unsigned long)data->blocksFound);
 
     for (int i = 0; i < 6; i++) {
         int col = i % cols;
@@ -444,9 +417,8 @@ static void drawMiningScreen(const display_data_t *data) {
         s_tft.setCursor(x + 2, ly);
         s_tft.print(stats[i].label);
 
-        s_tft.setTextColor(stats[i].color);
         s_tft.setCursor(x + 2, ly + 11);
-        s_tft.print(stats[i].value);
+        printField(stats[i].value, 1, stats[i].color);
     }
 
     int gridRows = isPortrait ? 3 : 2;
@@ -465,15 +437,19 @@ static void drawMiningScreen(const display_data_t *data) {
     s_tft.setTextColor(data->poolConnected ? COLOR_SUCCESS : COLOR_ERROR);
     
     // Truncate pool name if needed
-    String poolName = data->poolName ? data->poolName : "Disconnected";
-    if (isPortrait && poolName.length() > 12) poolName = poolName.substring(0, 10) + "..";
+    const char *poolName = data->poolName ? data->poolName : "Disconnected";
+    if (isPortrait && strlen(poolName) > 12) {
+        snprintf(value, sizeof(value), "%.10s..", poolName);
+        poolName = value;
+    }
     s_tft.print(poolName);
 
     // Pool workers on right
     if (data->poolWorkersTotal > 0) {
         s_tft.setTextColor(COLOR_SPARK1);
         s_tft.setCursor(w - 90, y);
-        s_tft.print(String(data->poolWorkersTotal) + " miners");
+        snprintf(value, sizeof(value), "%d miners", data->poolWorkersTotal);
+        s_tft.print(value);
     }
 
     y += 14;
@@ -482,16 +458,15 @@ static void drawMiningScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Diff: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(formatDifficulty(data->poolDifficulty));
+    printField(display_format_difficulty(value, sizeof(value), data->poolDifficulty), 1, COLOR_FG);
 
     // Your workers on address
     if (data->poolWorkersAddress > 0) {
         s_tft.setTextColor(COLOR_DIM);
         s_tft.setCursor(w - 90, y);
         s_tft.print("You: ");
-        s_tft.setTextColor(COLOR_ACCENT);
-        s_tft.print(String(data->poolWorkersAddress));
+        snprintf(value, sizeof(value), "%d", data->poolWorkersAddress);
+        printField(value, 1, COLOR_ACCENT);
     }
 
     y += 14;
@@ -500,12 +475,85 @@ static void drawMiningScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("IP: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(data->ipAddress ? data->ipAddress : "---");
+    printField(data->ipAddress ? data->ipAddress : "---", 1, COLOR_FG);
 
     drawBottomStatusBar(data);
 }
 
+// ============================================================
+// History Sparkline
+// Sweeps left to right like an oscilloscope: each new history sample
+// redraws one column and moves the cursor column after it. The panel
+// cannot be read back cheaply, so scrolling would resend the whole chart;
+// only a screen switch or rescale redraws it in full.
+// ============================================================
+
+#define SPARK_TEMP_MIN  20      // Temperature trace range (C)
+#define SPARK_TEMP_MAX  100
+
+static uint32_t s_sparkSeq = 0;     // Next sample to draw
+static float s_sparkScale = 1.0f;   // Hashrate at the top of the chart
+static int16_t s_sparkX = 0, s_sparkY = 0, s_sparkW = 0, s_sparkH = 0;
+
+static void drawSparkColumn(uint32_t seq) {
+    int x = s_sparkX + seq % s_sparkW;
+    int bar = 0;
+    int tempY = -1;
+
+    history_sample_t sample;
+    if (history_get(seq, &sample)) {
+        bar = (int)(sample.hashRate / s_sparkScale * s_sparkH + 0.5f);
+        if (bar > s_sparkH) bar = s_sparkH;
+        int t = constrain(sample.tempC, SPARK_TEMP_MIN, SPARK_TEMP_MAX);
+        tempY = s_sparkY + (s_sparkH - 1) - (t - SPARK_TEMP_MIN) * (s_sparkH - 1) / (SPARK_TEMP_MAX - SPARK_TEMP_MIN);
+    }
+
+    if (bar < s_sparkH) s_tft.drawFastVLine(x, s_sparkY, s_sparkH - bar, COLOR_BG);
+    if (bar > 0) s_tft.drawFastVLine(x, s_sparkY + s_sparkH - bar, bar, COLOR_SPARK2);
+    if (tempY >= 0) s_tft.drawPixel(x, tempY, COLOR_SUCCESS);
+}
+
+static void drawSparkline(int x, int y, int w, int h, uint32_t seqEnd, bool full) {
+    if (w > HISTORY_SAMPLES) w = HISTORY_SAMPLES;
+    if (w < 16 || h < 12) return;
+
+    if (x != s_sparkX || y != s_sparkY || w != s_sparkW || h != s_sparkH) {
+        s_sparkX = x;
+        s_sparkY = y;
+        s_sparkW = w;
+        s_sparkH = h;
+        full = true;
+    }
+
+    // Rescale when a sample tops the chart or the peak drops below half of it
+    float peak = history_peak(w - 1);
+    float target = peak > 0 ? peak * 1.25f : 1.0f;
+    if (peak > s_sparkScale || target < s_sparkScale * 0.5f) {
+        s_sparkScale = target;
+        full = true;
+    }
+
+    // Too far behind (e.g. screen was off) - nothing on screen is reusable
+    if (seqEnd - s_sparkSeq >= (uint32_t)w) full = true;
+
+    uint32_t first = s_sparkSeq;
+    if (full) {
+        s_tft.fillRect(x, y, w, h, COLOR_BG);
+        s_tft.drawRect(x - 1, y - 1, w + 2, h + 2, COLOR_PANEL);
+        first = seqEnd > (uint32_t)(w - 1) ? seqEnd - (w - 1) : 0;
+    }
+
+    for (uint32_t seq = first; seq < seqEnd; seq++) {
+        drawSparkColumn(seq);
+    }
+
+    // Cursor marks where the next sample lands (and hides the oldest one)
+    if (full || seqEnd != s_sparkSeq) {
+        s_tft.drawFastVLine(x + seqEnd % w, y, h, COLOR_DIM);
+    }
+    s_sparkSeq = seqEnd;
+}
+
 static void drawStatsScreen(const display_data_t *data) {
     int w = display_get_width();
     int y = HEADER_HEIGHT + 8;
@@ -517,9 +565,10 @@ static void drawStatsScreen(const display_data_t *data) {
     s_tft.setTextSize(2);
     s_tft.setCursor(MARGIN + 4, y + 6);
     s_tft.setTextColor(COLOR_SPARK1);
+    char value[DISPLAY_FORMAT_LEN];
     if (data->btcPrice > 0) {
-        s_tft.print("$");
-        s_tft.print(String(data->btcPrice, 0));
+        snprintf(value, sizeof(value), "$%.0f", data->btcPrice);
+        printField(value, 2, COLOR_SPARK1);
     } else {
         s_tft.setTextColor(COLOR_DIM);
         s_tft.print("Loading...");
@@ -530,9 +579,9 @@ static void drawStatsScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(w - 100, y + 4);
     s_tft.print("Block");
-    s_tft.setTextColor(COLOR_FG);
     s_tft.setCursor(w - 100, y + 16);
-    s_tft.print(data->blockHeight > 0 ? String(data->blockHeight) : "---");
+    snprintf(value, sizeof(value), "%lu", (unsigned long)data->blockHeight);
+    printField(data->blockHeight > 0 ? value : "---", 1, COLOR_FG);
 
     y += 44;
 
@@ -546,15 +595,14 @@ static void drawStatsScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Network: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(strlen(data->networkHashrate) > 0 ? data->networkHashrate : "---");
+    printField(strlen(data->networkHashrate) > 0 ? data->networkHashrate : "---", 1, COLOR_FG);
 
     // Fee on right
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(w - 90, y);
     s_tft.print("Fee: ");
-    s_tft.setTextColor(COLOR_SPARK2);
-    s_tft.print(data->halfHourFee > 0 ? String(data->halfHourFee) + " sat" : "---");
+    snprintf(value, sizeof(value), "%d sat", data->halfHourFee);
+    printField(data->halfHourFee > 0 ? value : "---", 1, COLOR_SPARK2);
 
     y += 16;
 
@@ -562,14 +610,14 @@ static void drawStatsScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Difficulty: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(strlen(data->networkDifficulty) > 0 ? data->networkDifficulty : "---");
+    printField(strlen(data->networkDifficulty) > 0 ? data->networkDifficulty : "---", 1, COLOR_FG);
 
     y += 32;
 
     // Your mining panel
     s_tft.fillRoundRect(MARGIN - 4, y, w - 2*MARGIN + 8, 55, 4, COLOR_PANEL);
     s_tft.drawRoundRect(MARGIN - 4, y, w - 2*MARGIN + 8, 55, 4, COLOR_ACCENT);
+    int sparkTop = y + 55 + 6;
 
     y += 6;
 
@@ -581,7 +629,8 @@ static void drawStatsScreen(const display_data_t *data) {
     if (data->poolWorkersTotal > 0) {
         s_tft.setTextColor(COLOR_SPARK1);
         s_tft.setCursor(w - 90, y);
-        s_tft.print(String(data->poolWorkersTotal) + " on pool");
+        snprintf(value, sizeof(value), "%d on pool", data->poolWorkersTotal);
+        s_tft.print(value);
     }
 
     y += 14;
@@ -589,23 +638,25 @@ static void drawStatsScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Rate: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(formatHashrate(data->hashRate));
+    printField(display_format_hashrate(value, sizeof(value), data->hashRate), 1, COLOR_FG);
 
     y += 14;
 
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Best: ");
-    s_tft.setTextColor(COLOR_SPARK1);
-    s_tft.print(formatDifficulty(data->bestDifficulty));
+    printField(display_format_difficulty(value, sizeof(value), data->bestDifficulty), 1, COLOR_SPARK1);
 
     // Shares on right
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(w - 90, y);
     s_tft.print("Shares: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(String(data->sharesAccepted));
+    snprintf(value, sizeof(value), "%lu", (unsigned long)data->sharesAccepted);
+    printField(value, 1, COLOR_FG);
+
+    // Hashrate (bars) and temperature (dots) history in the remaining space
+    int sparkBottom = display_get_height() - (display_is_portrait() ? 32 : 0) - 4;
+    drawSparkline(MARGIN, sparkTop, w - 2 * MARGIN, sparkBottom - sparkTop, data->historySeq, s_needsRedraw);
 
     drawBottomStatusBar(data);
 }
@@ -633,11 +684,10 @@ static void drawClockScreen(const display_data_t *data) {
     char timeStr[16];
     strftime(timeStr, sizeof(timeStr), "%H:%M:%S", &timeinfo);
 
-    s_tft.setTextColor(COLOR_ACCENT);
     s_tft.setTextSize(4);
     // Center text approximation (4 chars * 6px * 4 scale = 96px for "HH:MM")
     s_tft.setCursor(w / 2 - 96, y + 10);
-    s_tft.print(timeStr);
+    printField(timeStr, 4, COLOR_ACCENT);
 
     y += 70;
 
@@ -661,15 +711,14 @@ static void drawClockScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Hash: ");
-    s_tft.setTextColor(COLOR_ACCENT);
-    s_tft.print(formatHashrate(data->hashRate));
+    char value[DISPLAY_FORMAT_LEN];
+    printField(display_format_hashrate(value, sizeof(value), data->hashRate), 1, COLOR_ACCENT);
 
     // BTC price on right
     if (data->btcPrice > 0) {
-        s_tft.setTextColor(COLOR_SPARK1);
         s_tft.setCursor(w - 85, y);
-        s_tft.print("$");
-        s_tft.print(String(data->btcPrice, 0));
+        snprintf(value, sizeof(value), "$%.0f", data->btcPrice);
+        printField(value, 1, COLOR_SPARK1);
     }
 
     y += 16;
@@ -678,21 +727,65 @@ static void drawClockScreen(const display_data_t *data) {
     s_tft.setTextColor(COLOR_DIM);
     s_tft.setCursor(MARGIN + 2, y);
     s_tft.print("Shares: ");
-    s_tft.setTextColor(COLOR_FG);
-    s_tft.print(String(data->sharesAccepted));
+    snprintf(value, sizeof(value), "%lu", (unsigned long)data->sharesAccepted);
+    printField(value, 1, COLOR_FG);
 
     // Block height on right
     if (data->blockHeight > 0) {
         s_tft.setTextColor(COLOR_DIM);
         s_tft.setCursor(w - 85, y);
         s_tft.print("Blk ");
-        s_tft.setTextColor(COLOR_FG);
-        s_tft.print(String(data->blockHeight));
+        snprintf(value, sizeof(value), "%lu", (unsigned long)data->blockHeight);
+        printField(value, 1, COLOR_FG);
     }
 
     drawBottomStatusBar(data);
 }
 
+// ============================================================
+// Touch (XPT2046)
+// The controller pulls PENIRQ low while the panel is pressed, as long as
+// its power-down mode keeps the pen interrupt enabled. Presses are read
+// from that pin alone: no coordinates, no SPI traffic while running.
+// ============================================================
+
+#ifdef TOUCH_IRQ_PIN
+static bool s_touchDown = false;
+static uint32_t s_touchChangeMs = 0;
+
+// Bit-banged, once: the touch bus is separate from the TFT's SPI
+static uint8_t touchTransfer(uint8_t out) {
+    uint8_t in = 0;
+    for (int bit = 7; bit >= 0; bit--) {
+        digitalWrite(TOUCH_MOSI_PIN, (out >> bit) & 1);
+        digitalWrite(TOUCH_CLK_PIN, HIGH);
+        in = (in << 1) | (digitalRead(TOUCH_MISO_PIN) & 1);
+        digitalWrite(TOUCH_CLK_PIN, LOW);
+    }
+    return in;
+}
+
+static void touchInit() {
+    pinMode(TOUCH_CS_PIN, OUTPUT);
+    pinMode(TOUCH_CLK_PIN, OUTPUT);
+    pinMode(TOUCH_MOSI_PIN, OUTPUT);
+    pinMode(TOUCH_MISO_PIN, INPUT);
+    pinMode(TOUCH_IRQ_PIN, INPUT);
+    digitalWrite(TOUCH_CS_PIN, HIGH);
+    digitalWrite(TOUCH_CLK_PIN, LOW);
+
+    // One conversion with PD1:PD0 = 00 leaves the ADC powered down between
+    // conversions with PENIRQ enabled, whatever state it came up in
+    digitalWrite(TOUCH_CS_PIN, LOW);
+    touchTransfer(0x80);    // Start, X position, 12-bit, differential, PD = 00
+    touchTransfer(0x00);
+    touchTransfer(0x00);
+    digitalWrite(TOUCH_CS_PIN, HIGH);
+
+    Serial.printf("[DISPLAY] Touch wake on PENIRQ (GPIO %d)\n", TOUCH_IRQ_PIN);
+}
+#endif
+
 // ============================================================
 // Public API
 // ============================================================
@@ -709,10 +802,16 @@ void display_init(uint8_t rotation, uint8_t brightness) {
 
     // Initialize TFT
     s_tft.init();
+    #ifdef TOUCH_IRQ_PIN
+        touchInit();
+    #endif
     s_rotation = rotation;
     s_tft.setRotation(rotation);
     s_tft.fillScreen(COLOR_BG);
 
+    // Pre-render numeric glyphs (falls back to print() if this fails)
+    glyph_cache_init(&s_tft);
+
     // Initialize backlight PWM
     #ifdef LCD_BL_PIN
         ledcSetup(LEDC_CHANNEL, LEDC_FREQ, LEDC_RESOLUTION);
@@ -809,7 +908,8 @@ void display_update(const display_data_t *data) {
     // Check if anything changed
     bool dataChanged = (data->totalHashes != s_lastData.totalHashes) ||
         (abs(data->hashRate - s_lastData.hashRate) > 100) ||
-        (data->sharesAccepted != s_lastData.sharesAccepted);
+        (data->sharesAccepted != s_lastData.sharesAccepted) ||
+        (data->historySeq != s_lastData.historySeq);
 
     bool statusChanged = (data->poolConnected != s_lastData.poolConnected) ||
         (data->wifiConnected != s_lastData.wifiConnected);
@@ -932,14 +1032,34 @@ void display_show_reset_complete() {
     s_tft.print("Resetting...");
 }
 
+void display_set_sleep(bool sleep) {
+    if (sleep) {
+        setBacklight(0);
+        s_tft.writecommand(TFT_DISPOFF);
+    } else {
+        s_tft.writecommand(TFT_DISPON);
+        setBacklight(s_brightness);
+        s_needsRedraw = true;
+    }
+    Serial.printf("[DISPLAY] %s\n", sleep ? "Sleeping (backlight off)" : "Awake");
+}
+
 bool display_touched() {
-    // TODO: Implement touch detection with XPT2046
-    return false;
+    #ifdef TOUCH_IRQ_PIN
+        // Report each press once, on its falling edge
+        bool down = digitalRead(TOUCH_IRQ_PIN) == LOW;
+        uint32_t now = millis();
+        if (down == s_touchDown || now - s_touchChangeMs < TOUCH_DEBOUNCE_MS) return false;
+        s_touchDown = down;
+        s_touchChangeMs = now;
+        return down;
+    #else
+        return false;
+    #endif
 }
 
 void display_handle_touch() {
-    // TODO: Implement touch handling
-    // For now, just cycle screens
+    // A tap anywhere cycles screens, like a button click
     display_next_screen();
 }
 
@@ -58,6 +58,9 @@ struct display_data_s {
     char networkHashrate[24];
     char networkDifficulty[24];
     int halfHourFee;
+
+    // Sample history (stats/history.h) - samples recorded so far
+    uint32_t historySeq;
 };
 
 #if USE_DISPLAY
@@ -161,6 +164,13 @@ void display_show_reset_countdown(int seconds);
  */
 void display_show_reset_complete();
 
+/**
+ * Put the display to sleep (backlight + panel off) or wake it
+ * Waking forces a full redraw on the next update
+ * @param sleep true to sleep, false to wake
+ */
+void display_set_sleep(bool sleep);
+
 #else
 
 // Declarations for non-TFT builds
@@ -185,6 +195,7 @@ void display_show_ap_config(const char *ssid, const char *password, const char *
 void display_set_inverted(bool inverted);
 void display_show_reset_countdown(int seconds);
 void display_show_reset_complete();
+void display_set_sleep(bool sleep);
 
 #endif // USE_DISPLAY
 
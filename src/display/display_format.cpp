@@ -0,0 +1,69 @@
+/*
+ * SparkMiner - Display Value Formatting Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include "display_format.h"
+
+const char *display_format_hashrate(char *buf, size_t size, double hashrate) {
+    if (hashrate >= 1e9) {
+        snprintf(buf, size, "%.2f GH/s", hashrate / 1e9);
+    } else if (hashrate >= 1e6) {
+        snprintf(buf, size, "%.2f MH/s", hashrate / 1e6);
+    } else if (hashrate >= 1e3) {
+        snprintf(buf, size, "%.2f KH/s", hashrate / 1e3);
+    } else {
+        snprintf(buf, size, "%.1f H/s", hashrate);
+    }
+    return buf;
+}
+
+const char *display_format_number(char *buf, size_t size, uint64_t num) {
+    if (num >= 1e12) {
+        snprintf(buf, size, "%.2fT", (double)num / 1e12);
+    } else if (num >= 1e9) {
+        snprintf(buf, size, "%.2fG", (double)num / 1e9);
+    } else if (num >= 1e6) {
+        snprintf(buf, size, "%.2fM", (double)num / 1e6);
+    } else if (num >= 1e3) {
+        snprintf(buf, size, "%.2fK", (double)num / 1e3);
+    } else {
+        snprintf(buf, size, "%lu", (unsigned long)num);
+    }
+    return buf;
+}
+
+const char *display_format_uptime(char *buf, size_t size, uint32_t seconds) {
+    uint32_t days = seconds / 86400;
+    uint32_t hours = (seconds % 86400) / 3600;
+    uint32_t mins = (seconds % 3600) / 60;
+    uint32_t secs = seconds % 60;
+
+    if (days > 0) {
+        snprintf(buf, size, "%lud %luh", (unsigned long)days, (unsigned long)hours);
+    } else if (hours > 0) {
+        snprintf(buf, size, "%luh %lum", (unsigned long)hours, (unsigned long)mins);
+    } else {
+        snprintf(buf, size, "%lum %lus", (unsigned long)mins, (unsigned long)secs);
+    }
+    return buf;
+}
+
+const char *display_format_difficulty(char *buf, size_t size, double diff) {
+    if (diff >= 1e15) {
+        snprintf(buf, size, "%.2fP", diff / 1e15);
+    } else if (diff >= 1e12) {
+        snprintf(buf, size, "%.2fT", diff / 1e12);
+    } else if (diff >= 1e9) {
+        snprintf(buf, size, "%.2fG", diff / 1e9);
+    } else if (diff >= 1e6) {
+        snprintf(buf, size, "%.2fM", diff / 1e6);
+    } else if (diff >= 1e3) {
+        snprintf(buf, size, "%.2fK", diff / 1e3);
+    } else {
+        snprintf(buf, size, "%.4f", diff);
+    }
+    return buf;
+}
@@ -0,0 +1,41 @@
+/*
+ * SparkMiner - Display Value Formatting
+ * Human-readable hashrate, counts, uptime and difficulty strings
+ *
+ * Shared by the TFT screens and the host benchmarks; independent of any
+ * display driver. Every formatter writes into a caller buffer (normally
+ * DISPLAY_FORMAT_LEN bytes on the stack) and returns it, so a frame is
+ * rendered without touching the heap.
+ *
+ * GPL v3 License
+ */
+
+#ifndef DISPLAY_FORMAT_H
+#define DISPLAY_FORMAT_H
+
+#include <Arduino.h>
+
+// Fits the longest value any formatter produces, e.g. "999999.99 GH/s"
+#define DISPLAY_FORMAT_LEN  24
+
+/**
+ * Format a hashrate with unit, e.g. "715.23 KH/s"
+ */
+const char *display_format_hashrate(char *buf, size_t size, double hashrate);
+
+/**
+ * Format a count with K/M/G/T suffix, e.g. "123.46G"
+ */
+const char *display_format_number(char *buf, size_t size, uint64_t num);
+
+/**
+ * Format an uptime as its two largest units, e.g. "1d 2h" or "3m 4s"
+ */
+const char *display_format_uptime(char *buf, size_t size, uint32_t seconds);
+
+/**
+ * Format a difficulty with K/M/G/T/P suffix, e.g. "4.56M"
+ */
+const char *display_format_difficulty(char *buf, size_t size, double diff);
+
+#endif // DISPLAY_FORMAT_H
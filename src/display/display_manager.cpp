@@ -57,7 +57,7 @@ void display_init(uint8_t rotation, uint8_t brightness) {
 }
 
 void display_update(const display_data_t *data) {
-    // LED status updated via led_status_update() in monitor task
+    // LED status is set by the monitor task; the LED driver plays any animation
 }
 
 void display_set_brightness(uint8_t brightness) {
@@ -124,6 +124,10 @@ void display_show_reset_complete() {
     Serial.println("[RESET] Complete");
 }
 
+void display_set_sleep(bool sleep) {
+    // LED status stays active - nothing to power down
+}
+
 #else
 
 // Headless builds (no display, no LED): Serial output only
@@ -168,4 +172,6 @@ void display_show_reset_complete() {
     Serial.println("[RESET] Factory reset complete, restarting...");
 }
 
+void display_set_sleep(bool sleep) {}
+
 #endif
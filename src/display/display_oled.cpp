@@ -7,12 +7,14 @@
 
 #include <Arduino.h>
 #include <board_config.h>
+#include <fixed_string.h>
 #include "display/display_oled.h"
 
 #if USE_OLED_DISPLAY
 
 #include <U8g2lib.h>
 #include <Wire.h>
+#include "../stats/history.h"
 
 // ============================================================
 // Configuration
@@ -71,48 +73,139 @@ static uint8_t s_rotation = 0;
 static bool s_needsRedraw = true;
 static bool s_inverted = false;
 
+// ============================================================
+// Partial Update State
+// Mirror of what the panel currently shows, compared tile by tile
+// (8x8 px = 8 bytes in the SSD1306 page layout) so only changed
+// tiles are pushed over I2C via updateDisplayArea()
+// ============================================================
+
+#define OLED_TILE_COLS      (OLED_WIDTH / 8)
+#define OLED_TILE_ROWS      (OLED_HEIGHT / 8)
+#define OLED_BUFFER_SIZE    (OLED_WIDTH * OLED_HEIGHT / 8)
+#define OLED_AREA_OVERHEAD  4       // Control byte + page/column address per area
+#define OLED_I2C_REPORT_MS  60000   // Log I2C throughput every minute
+
+static uint8_t s_shadow[OLED_BUFFER_SIZE];
+static bool s_shadowValid = false;
+
+static uint32_t s_i2cBytes = 0;         // Bytes sent since last report
+static uint32_t s_i2cTiles = 0;         // Tiles sent since last report
+static uint32_t s_i2cBytesTotal = 0;    // Bytes sent since boot
+static uint32_t s_lastI2cReport = 0;
+
 // ============================================================
 // Helper Functions
 // ============================================================
 
-static String formatHashrateCompact(double hashrate) {
+// Compact formatters write into a caller buffer so frames stay off the heap
+#define OLED_FIELD_LEN  16
+
+static const char *formatHashrateCompact(char *buf, size_t size, double hashrate) {
     if (hashrate >= 1e9) {
-        return String(hashrate / 1e9, 1) + "G";
+        snprintf(buf, size, "%.1fG", hashrate / 1e9);
     } else if (hashrate >= 1e6) {
-        return String(hashrate / 1e6, 1) + "M";
+        snprintf(buf, size, "%.1fM", hashrate / 1e6);
     } else if (hashrate >= 1e3) {
-        return String(hashrate / 1e3, 1) + "K";
+        snprintf(buf, size, "%.1fK", hashrate / 1e3);
     } else {
-        return String((int)hashrate);
+        snprintf(buf, size, "%d", (int)hashrate);
     }
+    return buf;
 }
 
-static String formatUptimeCompact(uint32_t seconds) {
+static const char *formatUptimeCompact(char *buf, size_t size, uint32_t seconds) {
     uint32_t days = seconds / 86400;
     uint32_t hours = (seconds % 86400) / 3600;
     uint32_t mins = (seconds % 3600) / 60;
 
     if (days > 0) {
-        return String(days) + "d" + String(hours) + "h";
+        snprintf(buf, size, "%lud%luh", (unsigned long)days, (unsigned long)hours);
     } else if (hours > 0) {
-        return String(hours) + "h" + String(mins) + "m";
+        snprintf(buf, size, "%luh%lum", (unsigned long)hours, (unsigned long)mins);
     } else {
-        return String(mins) + "m";
+        snprintf(buf, size, "%lum", (unsigned long)mins);
     }
+    return buf;
 }
 
-static String formatDiffCompact(double diff) {
+static const char *formatDiffCompact(char *buf, size_t size, double diff) {
     if (diff >= 1e12) {
-        return String(diff / 1e12, 1) + "T";
+        snprintf(buf, size, "%.1fT", diff / 1e12);
     } else if (diff >= 1e9) {
-        return String(diff / 1e9, 1) + "G";
+        snprintf(buf, size, "%.1fG", diff / 1e9);
     } else if (diff >= 1e6) {
-        return String(diff / 1e6, 1) + "M";
+        snprintf(buf, size, "%.1fM", diff / 1e6);
     } else if (diff >= 1e3) {
-        return String(diff / 1e3, 1) + "K";
+        snprintf(buf, size, "%.1fK", diff / 1e3);
     } else {
-        return String((int)diff);
+        snprintf(buf, size, "%d", (int)diff);
+    }
+    return buf;
+}
+
+static void countI2c(uint32_t bytes, uint32_t tiles) {
+    s_i2cBytes += bytes;
+    s_i2cBytesTotal += bytes;
+    s_i2cTiles += tiles;
+}
+
+// Push the whole buffer and resync the shadow copy
+static void sendFullBuffer() {
+    s_u8g2.sendBuffer();
+    memcpy(s_shadow, s_u8g2.getBufferPtr(), OLED_BUFFER_SIZE);
+    s_shadowValid = true;
+    countI2c(OLED_BUFFER_SIZE + OLED_TILE_ROWS * OLED_AREA_OVERHEAD, OLED_TILE_COLS * OLED_TILE_ROWS);
+}
+
+// Push only tiles that differ from the shadow copy.
+// Consecutive dirty tiles in a tile row are merged into one area.
+static void sendDirtyTiles() {
+    if (!s_shadowValid || s_needsRedraw) {
+        sendFullBuffer();
+        return;
     }
+
+    uint8_t *buf = s_u8g2.getBufferPtr();
+
+    for (uint8_t ty = 0; ty < OLED_TILE_ROWS; ty++) {
+        uint8_t tx = 0;
+        while (tx < OLED_TILE_COLS) {
+            uint16_t offset = ty * OLED_WIDTH + tx * 8;
+            if (memcmp(buf + offset, s_shadow + offset, 8) == 0) {
+                tx++;
+                continue;
+            }
+
+            // Extend the run over following dirty tiles
+            uint8_t start = tx;
+            while (tx < OLED_TILE_COLS) {
+                offset = ty * OLED_WIDTH + tx * 8;
+                if (memcmp(buf + offset, s_shadow + offset, 8) == 0) break;
+                memcpy(s_shadow + offset, buf + offset, 8);
+                tx++;
+            }
+
+            uint8_t run = tx - start;
+            s_u8g2.updateDisplayArea(start, ty, run, 1);
+            countI2c(run * 8 + OLED_AREA_OVERHEAD, run);
+        }
+    }
+}
+
+static void reportI2cThroughput() {
+    uint32_t now = millis();
+    uint32_t elapsed = now - s_lastI2cReport;
+    if (elapsed < OLED_I2C_REPORT_MS) return;
+
+    Serial.printf("[OLED] I2C: %lu B/s, %lu tiles/s (full refresh would be %lu B/frame)\n",
+        (unsigned long)((uint64_t)s_i2cBytes * 1000 / elapsed),
+        (unsigned long)((uint64_t)s_i2cTiles * 1000 / elapsed),
+        (unsigned long)OLED_BUFFER_SIZE);
+
+    s_i2cBytes = 0;
+    s_i2cTiles = 0;
+    s_lastI2cReport = now;
 }
 
 // ============================================================
@@ -140,18 +233,19 @@ static void drawMainScreen(const display_data_t *data) {
     }
 
     // Uptime (right aligned)
-    String uptime = formatUptimeCompact(data->uptimeSeconds);
-    int uptimeWidth = s_u8g2.getStrWidth(uptime.c_str());
-    s_u8g2.drawStr(OLED_WIDTH - uptimeWidth, 8, uptime.c_str());
+    char field[OLED_FIELD_LEN];
+    formatUptimeCompact(field, sizeof(field), data->uptimeSeconds);
+    int uptimeWidth = s_u8g2.getStrWidth(field);
+    s_u8g2.drawStr(OLED_WIDTH - uptimeWidth, 8, field);
 
     // Separator line
     s_u8g2.drawHLine(0, 10, OLED_WIDTH);
 
     // Large hashrate display
     s_u8g2.setFont(u8g2_font_logisoso16_tn);  // Large numeric font
-    String hashrate = formatHashrateCompact(data->hashRate);
-    int hrWidth = s_u8g2.getStrWidth(hashrate.c_str());
-    s_u8g2.drawStr((OLED_WIDTH - hrWidth) / 2, 32, hashrate.c_str());
+    formatHashrateCompact(field, sizeof(field), data->hashRate);
+    int hrWidth = s_u8g2.getStrWidth(field);
+    s_u8g2.drawStr((OLED_WIDTH - hrWidth) / 2, 32, field);
 
     // "H/s" label below
     s_u8g2.setFont(u8g2_font_6x10_tf);
@@ -162,16 +256,40 @@ static void drawMainScreen(const display_data_t *data) {
         s_u8g2.drawHLine(0, 48, OLED_WIDTH);
 
         // Shares
-        String shares = "S:" + String(data->sharesAccepted);
-        s_u8g2.drawStr(0, 60, shares.c_str());
+        char line[OLED_FIELD_LEN + 8];
+        snprintf(line, sizeof(line), "S:%lu", (unsigned long)data->sharesAccepted);
+        s_u8g2.drawStr(0, 60, line);
 
         // Best diff (right)
-        String best = "B:" + formatDiffCompact(data->bestDifficulty);
-        int bestWidth = s_u8g2.getStrWidth(best.c_str());
-        s_u8g2.drawStr(OLED_WIDTH - bestWidth, 60, best.c_str());
+        snprintf(line, sizeof(line), "B:%s", formatDiffCompact(field, sizeof(field), data->bestDifficulty));
+        int bestWidth = s_u8g2.getStrWidth(line);
+        s_u8g2.drawStr(OLED_WIDTH - bestWidth, 60, line);
     #endif
 
-    s_u8g2.sendBuffer();
+    sendDirtyTiles();
+}
+
+// Mini hashrate history: one column per sample, newest at the right edge.
+// Drawn into the RAM buffer; sendDirtyTiles() only ships the tiles it changed.
+#define OLED_SPARK_X    80
+#define OLED_SPARK_Y    14
+
+static void drawSparkline(uint32_t seqEnd, int x, int y, int w, int h) {
+    float peak = history_peak(w);
+    if (peak <= 0 || h < 4) return;
+
+    float scale = peak * 1.25f;
+    s_u8g2.drawFrame(x - 1, y - 1, w + 2, h + 2);
+
+    for (int i = 0; i < w; i++) {
+        uint32_t back = w - i;
+        history_sample_t sample;
+        if (seqEnd < back || !history_get(seqEnd - back, &sample)) continue;
+
+        int bar = (int)(sample.hashRate / scale * h + 0.5f);
+        if (bar > h) bar = h;
+        if (bar > 0) s_u8g2.drawVLine(x + i, y + h - bar, bar);
+    }
 }
 
 static void drawStatsScreen(const display_data_t *data) {
@@ -183,30 +301,34 @@ static void drawStatsScreen(const display_data_t *data) {
     s_u8g2.drawHLine(0, 10, OLED_WIDTH);
 
     // Pool info
-    String poolLine = "Pool: ";
-    poolLine += data->poolConnected ? "OK" : "---";
-    s_u8g2.drawStr(0, 22, poolLine.c_str());
+    char field[OLED_FIELD_LEN];
+    char line[OLED_FIELD_LEN + 8];
+    snprintf(line, sizeof(line), "Pool: %s", data->poolConnected ? "OK" : "---");
+    s_u8g2.drawStr(0, 22, line);
 
     // Difficulty
-    String diffLine = "Diff: " + formatDiffCompact(data->poolDifficulty);
-    s_u8g2.drawStr(0, 34, diffLine.c_str());
+    snprintf(line, sizeof(line), "Diff: %s", formatDiffCompact(field, sizeof(field), data->poolDifficulty));
+    s_u8g2.drawStr(0, 34, line);
 
     // Templates
-    String templLine = "Tmpl: " + String(data->templates);
-    s_u8g2.drawStr(0, 46, templLine.c_str());
+    snprintf(line, sizeof(line), "Tmpl: %lu", (unsigned long)data->templates);
+    s_u8g2.drawStr(0, 46, line);
 
     #if (OLED_HEIGHT == 64)
         // WiFi signal
-        String rssiLine = "RSSI: ";
         if (data->wifiConnected) {
-            rssiLine += String(data->wifiRssi) + "dBm";
+            snprintf(line, sizeof(line), "RSSI: %ddBm", data->wifiRssi);
         } else {
-            rssiLine += "---";
+            snprintf(line, sizeof(line), "RSSI: ---");
         }
-        s_u8g2.drawStr(0, 58, rssiLine.c_str());
+        s_u8g2.drawStr(0, 58, line);
     #endif
 
-    s_u8g2.sendBuffer();
+    // History chart right of the text column
+    drawSparkline(data->historySeq, OLED_SPARK_X, OLED_SPARK_Y,
+                  OLED_WIDTH - OLED_SPARK_X - 1, OLED_HEIGHT - OLED_SPARK_Y - 1);
+
+    sendDirtyTiles();
 }
 
 // ============================================================
@@ -234,6 +356,8 @@ void oled_display_init(uint8_t rotation, uint8_t brightness) {
     s_brightness = (brightness * 255) / 100;
     s_u8g2.setContrast(s_brightness);
 
+    s_lastI2cReport = millis();
+
     // Show boot screen
     oled_display_show_boot();
 
@@ -253,6 +377,7 @@ void oled_display_update(const display_data_t *data) {
             break;
     }
     s_needsRedraw = false;
+    reportI2cThroughput();
 }
 
 void oled_display_set_brightness(uint8_t brightness) {
@@ -283,7 +408,7 @@ void oled_display_show_ap_config(const char *ssid, const char *password, const c
         s_u8g2.drawStr(0, 64, ip);
     #endif
 
-    s_u8g2.sendBuffer();
+    sendFullBuffer();
 }
 
 void oled_display_show_boot() {
@@ -305,7 +430,7 @@ void oled_display_show_boot() {
         s_u8g2.drawStr((OLED_WIDTH - 60) / 2, 58, "Initializing...");
     #endif
 
-    s_u8g2.sendBuffer();
+    sendFullBuffer();
 }
 
 void oled_display_show_reset_countdown(int seconds) {
@@ -316,11 +441,12 @@ void oled_display_show_reset_countdown(int seconds) {
     s_u8g2.drawStr(28, 36, "RESET");
 
     s_u8g2.setFont(u8g2_font_logisoso16_tn);
-    String countdown = String(seconds);
+    FixedString<11> countdown;
+    countdown.printf("%d", seconds);
     int w = s_u8g2.getStrWidth(countdown.c_str());
     s_u8g2.drawStr((OLED_WIDTH - w) / 2, 58, countdown.c_str());
 
-    s_u8g2.sendBuffer();
+    sendFullBuffer();
 }
 
 void oled_display_show_reset_complete() {
@@ -330,7 +456,7 @@ void oled_display_show_reset_complete() {
     s_u8g2.drawStr(28, 28, "RESET");
     s_u8g2.drawStr(16, 46, "COMPLETE");
 
-    s_u8g2.sendBuffer();
+    sendFullBuffer();
 }
 
 void oled_display_redraw() {
@@ -370,6 +496,14 @@ void oled_display_set_inverted(bool inverted) {
     s_needsRedraw = true;
 }
 
+void oled_display_set_sleep(bool sleep) {
+    s_u8g2.setPowerSave(sleep ? 1 : 0);
+    if (!sleep) {
+        s_needsRedraw = true;  // Full buffer send on wake
+    }
+    Serial.printf("[OLED] %s\n", sleep ? "Power save on" : "Power save off");
+}
+
 uint16_t oled_display_get_width() {
     return OLED_WIDTH;
 }
@@ -382,6 +516,10 @@ bool oled_display_is_portrait() {
     return false;  // OLEDs are typically landscape
 }
 
+uint32_t oled_display_get_i2c_bytes() {
+    return s_i2cBytesTotal;
+}
+
 uint8_t oled_display_get_screen() {
     return s_currentScreen;
 }
@@ -414,6 +552,7 @@ static DisplayDriver s_oledDriver = {
     .is_portrait = oled_display_is_portrait,
     .get_screen = oled_display_get_screen,
     .set_screen = oled_display_set_screen,
+    .set_sleep = oled_display_set_sleep,
     .name = "U8g2 OLED"
 };
 
@@ -497,4 +636,8 @@ void display_show_reset_complete() {
     oled_display_show_reset_complete();
 }
 
+void display_set_sleep(bool sleep) {
+    oled_display_set_sleep(sleep);
+}
+
 #endif // USE_OLED_DISPLAY
@@ -0,0 +1,294 @@
+/*
+ * SparkMiner - Display Task Implementation
+ * Dedicated render task fed by a single-slot snapshot mailbox
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "display_task.h"
+#include "../config/nvs_config.h"
+
+#define RENDER_REPORT_MS    60000   // Log render percentiles every minute
+#define SLEEP_MINUTE_MS     60000   // screenTimeout is configured in minutes
+#define REQUEST_POLL_MS     50      // Wake and settings requests wait at most this long
+
+static QueueHandle_t s_mailbox = NULL;
+static portMUX_TYPE s_statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Render time ring buffer (microseconds)
+static uint32_t s_renderSamples[DISPLAY_RENDER_SAMPLES];
+static uint8_t s_renderIndex = 0;
+static uint8_t s_renderCount = 0;
+
+static uint32_t s_framesRendered = 0;
+static uint32_t s_framesSkipped = 0;
+static uint32_t s_framesOverBudget = 0;
+static uint32_t s_renderMaxUs = 0;
+
+// Sleep state - wake requested from the button task, both edges taken by the display task
+static volatile bool s_asleep = false;
+static volatile bool s_wakeRequested = false;
+static volatile uint32_t s_lastActivity = 0;
+
+// Settings queued by other tasks, applied by the display task between frames
+#define PENDING_BRIGHTNESS  0x01
+#define PENDING_ROTATION    0x02
+#define PENDING_INVERTED    0x04
+
+static portMUX_TYPE s_settingsMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t s_settingsPending = 0;
+static uint8_t s_nextBrightness = 0;
+static uint8_t s_nextRotation = 0;
+static bool s_nextInverted = false;
+
+// Hashrate while awake vs asleep (sum of per-frame EMA hashrate)
+static double s_hashSumAwake = 0.0;
+static uint32_t s_hashSamplesAwake = 0;
+static double s_hashSumAsleep = 0.0;
+static uint32_t s_hashSamplesAsleep = 0;
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+static void recordRenderTime(uint32_t us) {
+    portENTER_CRITICAL(&s_statsMux);
+    s_renderSamples[s_renderIndex] = us;
+    s_renderIndex = (s_renderIndex + 1) % DISPLAY_RENDER_SAMPLES;
+    if (s_renderCount < DISPLAY_RENDER_SAMPLES) s_renderCount++;
+    if (us > s_renderMaxUs) s_renderMaxUs = us;
+    s_framesRendered++;
+    if (us > DISPLAY_FRAME_BUDGET_US) s_framesOverBudget++;
+    portEXIT_CRITICAL(&s_statsMux);
+}
+
+static void recordHashrate(const display_data_t *frame, bool asleep) {
+    if (frame->hashRate <= 0) return;
+    portENTER_CRITICAL(&s_statsMux);
+    if (asleep) {
+        s_hashSumAsleep += frame->hashRate;
+        s_hashSamplesAsleep++;
+    } else {
+        s_hashSumAwake += frame->hashRate;
+        s_hashSamplesAwake++;
+    }
+    portEXIT_CRITICAL(&s_statsMux);
+}
+
+// Sleep once the configured idle timeout has elapsed (0 = never)
+static void checkSleepTimeout(uint32_t now) {
+    // Needs a wake source: the button task, or touch (CYD boards)
+    #if !defined(BUTTON_PIN) && !defined(TOUCH_TYPE_XPT2046)
+        return;
+    #endif
+    if (s_asleep) return;
+
+    uint8_t timeoutMin = nvs_config_get()->screenTimeout;
+    if (timeoutMin == 0) return;
+
+    if (now - s_lastActivity >= (uint32_t)timeoutMin * SLEEP_MINUTE_MS) {
+        s_asleep = true;
+        display_set_sleep(true);
+        Serial.printf("[DISPLAY] Idle for %u min - rendering paused\n", timeoutMin);
+    }
+}
+
+// Wake and settings changes from other tasks; the panel bus is only driven from here
+static void applyPendingSettings() {
+    if (s_wakeRequested) {
+        s_wakeRequested = false;
+        if (s_asleep) {
+            display_set_sleep(false);
+            s_asleep = false;
+        }
+    }
+    if (!s_settingsPending) return;
+
+    portENTER_CRITICAL(&s_settingsMux);
+    uint8_t pending = s_settingsPending;
+    uint8_t brightness = s_nextBrightness;
+    uint8_t rotation = s_nextRotation;
+    bool inverted = s_nextInverted;
+    // The backlight stays off while asleep; brightness waits for the wake
+    s_settingsPending = s_asleep ? (pending & PENDING_BRIGHTNESS) : 0;
+    portEXIT_CRITICAL(&s_settingsMux);
+
+    if (pending & PENDING_ROTATION) display_set_rotation(rotation);
+    if (pending & PENDING_INVERTED) display_set_inverted(inverted);
+    if ((pending & PENDING_BRIGHTNESS) && !s_asleep) display_set_brightness(brightness);
+}
+
+// Nearest-rank percentile over a sorted array
+static uint32_t percentile(const uint32_t *sorted, uint8_t count, uint8_t pct) {
+    if (count == 0) return 0;
+    uint32_t rank = ((uint32_t)pct * count + 99) / 100;
+    if (rank == 0) rank = 1;
+    return sorted[rank - 1];
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void display_task_init() {
+    if (s_mailbox) return;
+
+    // Length-1 queue + xQueueOverwrite = latest-value mailbox
+    s_mailbox = xQueueCreate(1, sizeof(display_data_t));
+    if (!s_mailbox) {
+        Serial.println("[DISPLAY] ERROR: Failed to create snapshot mailbox");
+    }
+}
+
+void display_task_publish(const display_data_t *data) {
+    if (!s_mailbox || !data) return;
+    xQueueOverwrite(s_mailbox, data);
+}
+
+bool display_task_wake() {
+    s_lastActivity = millis();
+    if (!s_asleep || s_wakeRequested) return s_asleep;
+
+    s_wakeRequested = true;
+    return true;
+}
+
+void display_task_set_brightness(uint8_t brightness) {
+    portENTER_CRITICAL(&s_settingsMux);
+    s_nextBrightness = brightness;
+    s_settingsPending |= PENDING_BRIGHTNESS;
+    portEXIT_CRITICAL(&s_settingsMux);
+}
+
+void display_task_set_rotation(uint8_t rotation) {
+    portENTER_CRITICAL(&s_settingsMux);
+    s_nextRotation = rotation;
+    s_settingsPending |= PENDING_ROTATION;
+    portEXIT_CRITICAL(&s_settingsMux);
+}
+
+void display_task_set_inverted(bool inverted) {
+    portENTER_CRITICAL(&s_settingsMux);
+    s_nextInverted = inverted;
+    s_settingsPending |= PENDING_INVERTED;
+    portEXIT_CRITICAL(&s_settingsMux);
+}
+
+bool display_task_is_asleep() {
+    return s_asleep;
+}
+
+void display_task_get_stats(display_task_stats_t *stats) {
+    if (!stats) return;
+
+    uint32_t sorted[DISPLAY_RENDER_SAMPLES];
+    uint8_t count;
+
+    portENTER_CRITICAL(&s_statsMux);
+    count = s_renderCount;
+    memcpy(sorted, s_renderSamples, count * sizeof(uint32_t));
+    stats->framesRendered = s_framesRendered;
+    stats->framesSkipped = s_framesSkipped;
+    stats->framesOverBudget = s_framesOverBudget;
+    stats->renderMaxUs = s_renderMaxUs;
+    stats->asleep = s_asleep;
+    stats->hashrateAwake = s_hashSamplesAwake ? s_hashSumAwake / s_hashSamplesAwake : 0.0;
+    stats->hashrateAsleep = s_hashSamplesAsleep ? s_hashSumAsleep / s_hashSamplesAsleep : 0.0;
+    portEXIT_CRITICAL(&s_statsMux);
+
+    // Insertion sort - at most 64 samples
+    for (uint8_t i = 1; i < count; i++) {
+        uint32_t v = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    stats->renderP50Us = percentile(sorted, count, 50);
+    stats->renderP95Us = percentile(sorted, count, 95);
+    stats->renderP99Us = percentile(sorted, count, 99);
+    stats->budgetUs = DISPLAY_FRAME_BUDGET_US;
+}
+
+void display_task(void *param) {
+    Serial.printf("[DISPLAY] Render task started on core %d (budget %u us/frame)\n",
+                  xPortGetCoreID(), (unsigned)DISPLAY_FRAME_BUDGET_US);
+
+    if (!s_mailbox) {
+        display_task_init();
+    }
+
+    display_data_t frame;
+    uint32_t skipFrames = 0;
+    uint32_t lastReport = millis();
+    s_lastActivity = millis();
+
+    while (true) {
+        // Wait for the monitor's next snapshot, looking at requests in between
+        bool received = xQueueReceive(s_mailbox, &frame, pdMS_TO_TICKS(REQUEST_POLL_MS)) == pdTRUE;
+        applyPendingSettings();
+
+        if (received) {
+            bool asleep = s_asleep;
+            recordHashrate(&frame, asleep);
+
+            if (asleep) {
+                // Sleeping: no layout, no bus traffic - snapshot is dropped
+            } else if (skipFrames > 0) {
+                // Pay off the previous overrun instead of rendering
+                skipFrames--;
+                portENTER_CRITICAL(&s_statsMux);
+                s_framesSkipped++;
+                portEXIT_CRITICAL(&s_statsMux);
+            } else {
+                uint32_t start = micros();
+                display_update(&frame);
+                uint32_t elapsed = micros() - start;
+                recordRenderTime(elapsed);
+
+                // Skip enough following frames to bring the average back under budget
+                if (elapsed > DISPLAY_FRAME_BUDGET_US) {
+                    skipFrames = (elapsed - 1) / DISPLAY_FRAME_BUDGET_US;
+                }
+            }
+        }
+
+        // Check for touch input (a touch while asleep only wakes the screen)
+        if (display_touched()) {
+            if (!display_task_wake()) {
+                display_handle_touch();
+            }
+        }
+
+        uint32_t now = millis();
+        checkSleepTimeout(now);
+
+        // Periodic render cost report
+        if (now - lastReport >= RENDER_REPORT_MS) {
+            display_task_stats_t stats;
+            display_task_get_stats(&stats);
+            // Stack line buffer (Serial.printf allocates long lines)
+            char line[128];
+            snprintf(line, sizeof(line), "[DISPLAY] Render p50: %lu us | p95: %lu us | p99: %lu us | Max: %lu us\n",
+                stats.renderP50Us, stats.renderP95Us, stats.renderP99Us, stats.renderMaxUs);
+            Serial.print(line);
+            snprintf(line, sizeof(line), "[DISPLAY] Frames: %lu rendered, %lu skipped, %lu over %lu us budget\n",
+                stats.framesRendered, stats.framesSkipped, stats.framesOverBudget, stats.budgetUs);
+            Serial.print(line);
+            if (stats.hashrateAwake > 0 && stats.hashrateAsleep > 0) {
+                snprintf(line, sizeof(line), "[DISPLAY] Hashrate awake: %.0f H/s | asleep: %.0f H/s | delta: %+.2f%%\n",
+                    stats.hashrateAwake, stats.hashrateAsleep,
+                    (stats.hashrateAsleep - stats.hashrateAwake) * 100.0 / stats.hashrateAwake);
+                Serial.print(line);
+            }
+            lastReport = now;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * SparkMiner - Display Task
+ * Dedicated render task fed by a single-slot snapshot mailbox
+ *
+ * The monitor task publishes display_data_t snapshots; this task renders
+ * the most recent one within a per-frame CPU budget. Stale snapshots are
+ * overwritten rather than queued, so a slow frame never causes lag.
+ *
+ * GPL v3 License
+ */
+
+#ifndef DISPLAY_TASK_H
+#define DISPLAY_TASK_H
+
+#include <Arduino.h>
+#include "display.h"
+
+// Number of render times kept for percentile calculation
+#define DISPLAY_RENDER_SAMPLES  64
+
+/**
+ * Render timing statistics
+ */
+typedef struct {
+    uint32_t framesRendered;    // Frames passed to display_update()
+    uint32_t framesSkipped;     // Frames dropped to stay within budget
+    uint32_t framesOverBudget;  // Rendered frames that exceeded the budget
+    uint32_t renderP50Us;       // Median render time (microseconds)
+    uint32_t renderP95Us;       // 95th percentile render time
+    uint32_t renderP99Us;       // 99th percentile render time
+    uint32_t renderMaxUs;       // Worst render time since boot
+    uint32_t budgetUs;          // Configured per-frame budget
+    bool asleep;                // Display currently sleeping
+    double hashrateAwake;       // Mean hashrate while display awake (H/s)
+    double hashrateAsleep;      // Mean hashrate while display asleep (H/s)
+} display_task_stats_t;
+
+/**
+ * Initialize the snapshot mailbox
+ * Must be called before display_task_publish() or starting the task
+ */
+void display_task_init();
+
+/**
+ * Publish a new display snapshot (non-blocking)
+ * Overwrites any snapshot the display task has not consumed yet
+ * @param data Snapshot to copy into the mailbox
+ */
+void display_task_publish(const display_data_t *data);
+
+/**
+ * Register user activity and wake the display if it is sleeping
+ * Call from button/touch handlers; the display task turns the panel back
+ * on before its next frame
+ * @return true if the display was asleep (input should be consumed)
+ */
+bool display_task_wake();
+
+/**
+ * Queue a brightness, rotation or color inversion change (any task)
+ * The display task applies it between frames, so the panel is only ever
+ * driven from one task. Brightness set while the display sleeps takes
+ * effect when it wakes.
+ */
+void display_task_set_brightness(uint8_t brightness);
+void display_task_set_rotation(uint8_t rotation);
+void display_task_set_inverted(bool inverted);
+
+/**
+ * Check whether the display is sleeping (screenTimeout elapsed)
+ */
+bool display_task_is_asleep();
+
+/**
+ * Get render timing statistics
+ * @param stats Output structure (percentiles computed on call)
+ */
+void display_task_get_stats(display_task_stats_t *stats);
+
+/**
+ * Display task (runs on Core 0)
+ * Waits for snapshots and renders them within DISPLAY_FRAME_BUDGET_US.
+ * After screenTimeout minutes without input the display sleeps and
+ * snapshots are dropped without rendering until display_task_wake()
+ */
+void display_task(void *param);
+
+#endif // DISPLAY_TASK_H
@@ -0,0 +1,203 @@
+/*
+ * SparkMiner - Glyph Cache Implementation
+ * Pre-rasterized GLCD glyphs drawn by bitmap blit or merged rectangles
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "glyph_cache.h"
+
+#if USE_DISPLAY
+
+// GLCD cell is 6x8 (5x7 glyph + 1px spacing)
+#define GLYPH_W         6
+#define GLYPH_H         8
+#define GLYPH_RECTS_MAX 16
+
+typedef struct {
+    uint8_t x, y, w, h;     // Font pixels (unscaled)
+} glyph_rect_t;
+
+typedef struct {
+    uint8_t rows[GLYPH_H];  // 1bpp, bit 7 = leftmost column
+    uint8_t pixels;         // Set pixels
+    uint8_t rectCount;      // 0 = decomposition did not fit, blit only
+    glyph_rect_t rects[GLYPH_RECTS_MAX];
+} glyph_t;
+
+static const char s_charset[] = GLYPH_CACHE_CHARSET;
+#define CHARSET_LEN (sizeof(s_charset) - 1)
+
+static glyph_t s_glyphs[CHARSET_LEN];
+static bool s_ready = false;
+
+// Row buffer for the blit (RGB565)
+static uint16_t s_line[GLYPH_CACHE_LINE_MAX];
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+static inline bool bitSet(const uint8_t *rows, uint8_t x, uint8_t y) {
+    return rows[y] & (0x80 >> x);
+}
+
+// Greedy cover: horizontal runs, extended down while the next row repeats them
+static void decompose(glyph_t *g) {
+    uint8_t covered[GLYPH_H] = {0};
+    g->rectCount = 0;
+
+    for (uint8_t y = 0; y < GLYPH_H; y++) {
+        uint8_t x = 0;
+        while (x < GLYPH_W) {
+            if (!bitSet(g->rows, x, y) || bitSet(covered, x, y)) {
+                x++;
+                continue;
+            }
+
+            uint8_t x1 = x;
+            while (x1 < GLYPH_W && bitSet(g->rows, x1, y) && !bitSet(covered, x1, y)) x1++;
+            uint8_t runMask = (uint8_t)((0xFF >> x) & ~(0xFF >> x1));
+
+            uint8_t y1 = y + 1;
+            while (y1 < GLYPH_H && (g->rows[y1] & runMask) == runMask && !(covered[y1] & runMask)) y1++;
+
+            if (g->rectCount == GLYPH_RECTS_MAX) {
+                g->rectCount = 0;
+                return;
+            }
+            g->rects[g->rectCount++] = {x, y, (uint8_t)(x1 - x), (uint8_t)(y1 - y)};
+            for (uint8_t r = y; r < y1; r++) covered[r] |= runMask;
+            x = x1;
+        }
+    }
+}
+
+static int charIndex(char c) {
+    const char *p = strchr(s_charset, c);
+    return (p && c) ? (int)(p - s_charset) : -1;
+}
+
+static void drawBitmap(TFT_eSPI *tft, const glyph_t **glyphs, size_t len,
+                       int32_t x, int32_t y, uint8_t size, uint16_t fg, uint16_t bg) {
+    int32_t cw = GLYPH_W * size;
+    int32_t w = (int32_t)len * cw;
+
+    tft->setAddrWindow(x, y, w, GLYPH_H * size);
+    for (uint8_t fy = 0; fy < GLYPH_H; fy++) {
+        // Expand one font row, then repeat it for each scaled line
+        uint16_t *out = s_line;
+        for (size_t i = 0; i < len; i++) {
+            uint8_t bits = glyphs[i]->rows[fy];
+            for (uint8_t fx = 0; fx < GLYPH_W; fx++, bits <<= 1) {
+                uint16_t color = (bits & 0x80) ? fg : bg;
+                for (uint8_t s = 0; s < size; s++) *out++ = color;
+            }
+        }
+        for (uint8_t s = 0; s < size; s++) {
+            tft->pushColors(s_line, w, true);
+        }
+    }
+}
+
+static void drawRects(TFT_eSPI *tft, const glyph_t **glyphs, size_t len,
+                      int32_t x, int32_t y, uint8_t size, uint16_t fg) {
+    int32_t cw = GLYPH_W * size;
+    for (size_t i = 0; i < len; i++) {
+        const glyph_t *g = glyphs[i];
+        for (uint8_t r = 0; r < g->rectCount; r++) {
+            const glyph_rect_t *rc = &g->rects[r];
+            tft->fillRect(x + i * cw + rc->x * size, y + rc->y * size,
+                          rc->w * size, rc->h * size, fg);
+        }
+    }
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+bool glyph_cache_init(TFT_eSPI *tft) {
+    if (s_ready) return true;
+    if (!tft) return false;
+
+    uint32_t start = micros();
+    TFT_eSprite spr = TFT_eSprite(tft);
+    spr.setColorDepth(1);
+    if (!spr.createSprite(GLYPH_W, GLYPH_H)) {
+        Serial.println("[DISPLAY] ERROR: Glyph cache sprite allocation failed");
+        return false;
+    }
+
+    spr.setTextSize(1);
+    spr.setTextColor(1);
+    uint32_t rects = 0;
+    for (uint8_t c = 0; c < CHARSET_LEN; c++) {
+        glyph_t *g = &s_glyphs[c];
+        memset(g, 0, sizeof(*g));
+
+        spr.fillSprite(0);
+        spr.setCursor(0, 0);
+        spr.print(s_charset[c]);
+
+        for (uint8_t y = 0; y < GLYPH_H; y++) {
+            for (uint8_t x = 0; x < GLYPH_W; x++) {
+                if (spr.readPixel(x, y)) {
+                    g->rows[y] |= 0x80 >> x;
+                    g->pixels++;
+                }
+            }
+        }
+        decompose(g);
+        rects += g->rectCount;
+    }
+    spr.deleteSprite();
+
+    s_ready = true;
+    Serial.printf("[DISPLAY] Glyph cache: %u glyphs, %lu rects, %u bytes, %lu us\n",
+                  (unsigned)CHARSET_LEN, (unsigned long)rects, (unsigned)sizeof(s_glyphs),
+                  (unsigned long)(micros() - start));
+    return true;
+}
+
+bool glyph_cache_draw(TFT_eSPI *tft, const char *text, uint8_t size, uint16_t fg, uint16_t bg) {
+    if (!s_ready || !tft || !text || size == 0) return false;
+
+    size_t len = strlen(text);
+    int32_t w = (int32_t)len * GLYPH_W * size;
+    int32_t h = GLYPH_H * size;
+    if (len == 0 || w > GLYPH_CACHE_LINE_MAX) return false;
+
+    int32_t x = tft->getCursorX();
+    int32_t y = tft->getCursorY();
+    if (x < 0 || y < 0 || x + w > tft->width() || y + h > tft->height()) return false;
+
+    // Resolve every glyph first so a miss draws nothing, and price both paths
+    const glyph_t *glyphs[GLYPH_CACHE_LINE_MAX / GLYPH_W];
+    bool rectsOk = true;
+    uint32_t rectCost = 0;
+    for (size_t i = 0; i < len; i++) {
+        int ci = charIndex(text[i]);
+        if (ci < 0) return false;
+        const glyph_t *g = &s_glyphs[ci];
+        glyphs[i] = g;
+        if (g->pixels > 0 && g->rectCount == 0) rectsOk = false;
+        rectCost += g->rectCount * GLYPH_WINDOW_COST + g->pixels * size * size * 2;
+    }
+    uint32_t blitCost = GLYPH_WINDOW_COST + (uint32_t)w * h * 2;
+
+    tft->startWrite();
+    if (rectsOk && rectCost < blitCost) {
+        drawRects(tft, glyphs, len, x, y, size, fg);
+    } else {
+        drawBitmap(tft, glyphs, len, x, y, size, fg, bg);
+    }
+    tft->endWrite();
+
+    tft->setCursor(x + w, y);
+    return true;
+}
+
+#endif // USE_DISPLAY
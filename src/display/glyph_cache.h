@@ -0,0 +1,55 @@
+/*
+ * SparkMiner - Glyph Cache
+ * Pre-rasterized GLCD glyphs for fast numeric field drawing
+ *
+ * TFT_eSPI draws transparent and scaled GLCD text one drawPixel/fillRect
+ * per font pixel, i.e. one address window each. The cache rasterizes the
+ * characters used by numeric fields once at boot and keeps two forms:
+ *   - a 1bpp bitmap, blitted opaque through a single address window
+ *   - a rectangle decomposition, drawn transparent with few fillRects
+ * Each string is drawn with whichever form moves fewer bytes over the bus.
+ *
+ * GPL v3 License
+ */
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <Arduino.h>
+#include <board_config.h>
+
+#if USE_DISPLAY
+
+#include <TFT_eSPI.h>
+
+// Characters cached: digits, punctuation and unit suffixes
+#define GLYPH_CACHE_CHARSET     "0123456789 .,:/$%-KMGTPEHsdhm"
+
+// Longest line that can be blitted in one window (pixels)
+#define GLYPH_CACHE_LINE_MAX    320
+
+// Bus cost of opening an address window (CASET + RASET + RAMWR bytes)
+#define GLYPH_WINDOW_COST       11
+
+/**
+ * Rasterize the cached charset
+ * Uses a 1-bit sprite so glyphs match TFT_eSPI's own renderer exactly;
+ * larger text sizes are exact integer scales of the same raster
+ * @param tft Display the sprite is created against
+ * @return true if the cache is ready
+ */
+bool glyph_cache_init(TFT_eSPI *tft);
+
+/**
+ * Draw text at the current cursor using cached glyphs
+ * Advances the cursor like print() on success.
+ * @param bg Colour under the text; the bitmap path writes it, the
+ *           rectangle path leaves the background untouched
+ * @return false (nothing drawn) if a character is not cached or the text
+ *         would not fit on screen - caller should fall back to print()
+ */
+bool glyph_cache_draw(TFT_eSPI *tft, const char *text, uint8_t size, uint16_t fg, uint16_t bg);
+
+#endif // USE_DISPLAY
+
+#endif // GLYPH_CACHE_H
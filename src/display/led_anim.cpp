@@ -0,0 +1,166 @@
+/*
+ * SparkMiner - LED Animation State Machine Implementation
+ * Platform-independent status -> animation program logic
+ *
+ * GPL v3 License
+ */
+
+#include <string.h>
+#include "led_anim.h"
+
+// ============================================================
+// Colors
+// ============================================================
+
+static const led_rgb_t COLOR_YELLOW = {255, 200, 0};
+static const led_rgb_t COLOR_BLUE   = {0, 100, 255};
+static const led_rgb_t COLOR_GREEN  = {0, 255, 50};
+static const led_rgb_t COLOR_WHITE  = {255, 255, 255};
+static const led_rgb_t COLOR_RED    = {255, 0, 0};
+static const led_rgb_t COLOR_OFF    = {0, 0, 0};
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+// Same rounding as FastLED nscale8 (fixed scale8)
+static inline uint8_t scale8(uint8_t v, uint8_t scale) {
+    return (uint8_t)(((uint16_t)v * (1 + (uint16_t)scale)) >> 8);
+}
+
+static led_rgb_t scaleColor(led_rgb_t c, uint8_t brightness) {
+    led_rgb_t out = {scale8(c.r, brightness), scale8(c.g, brightness), scale8(c.b, brightness)};
+    return out;
+}
+
+static void buildSteady(led_program_t *prog, led_rgb_t color, uint8_t brightness) {
+    prog->frames[0] = scaleColor(color, brightness);
+    prog->count = 1;
+    prog->frameMs = 0;
+}
+
+// Triangle wave floor -> peak -> floor over one period
+static void buildPulse(led_program_t *prog, led_rgb_t color, uint16_t periodMs, uint8_t maxBrightness) {
+    uint16_t frameMs = periodMs / LED_ANIM_MAX_FRAMES;
+    if (frameMs < LED_ANIM_MIN_FRAME_MS) frameMs = LED_ANIM_MIN_FRAME_MS;
+
+    uint8_t count = (uint8_t)(periodMs / frameMs) & ~1;  // Even: symmetric ramps
+    if (count > LED_ANIM_MAX_FRAMES) count = LED_ANIM_MAX_FRAMES;
+    uint8_t half = count / 2;
+
+    uint8_t floor = maxBrightness < LED_PULSE_MIN ? maxBrightness : LED_PULSE_MIN;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t pos = (i <= half) ? i : (uint8_t)(count - i);
+        uint8_t b = floor + (uint8_t)((uint16_t)(maxBrightness - floor) * pos / half);
+        prog->frames[i] = scaleColor(color, b);
+    }
+    prog->count = count;
+    prog->frameMs = frameMs;
+}
+
+// Full-saturation colour wheel; RGB is piecewise linear between the six
+// primaries/secondaries, so each sixth is a single linear ramp
+static void buildRainbow(led_program_t *prog, uint8_t maxBrightness) {
+    const uint8_t segments = 6;
+    uint8_t perSegment = LED_RAINBOW_CYCLE_MS / (segments * LED_ANIM_MIN_FRAME_MS);
+    if (perSegment > LED_ANIM_MAX_FRAMES / segments) perSegment = LED_ANIM_MAX_FRAMES / segments;
+    if (perSegment < 1) perSegment = 1;
+    uint8_t count = segments * perSegment;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t seg = i / perSegment;
+        uint8_t f = (uint8_t)((i % perSegment) * 255 / perSegment);
+        led_rgb_t c;
+        switch (seg) {
+            case 0:  c = {255, f, 0}; break;
+            case 1:  c = {(uint8_t)(255 - f), 255, 0}; break;
+            case 2:  c = {0, 255, f}; break;
+            case 3:  c = {0, (uint8_t)(255 - f), 255}; break;
+            case 4:  c = {f, 0, 255}; break;
+            default: c = {255, 0, (uint8_t)(255 - f)}; break;
+        }
+        prog->frames[i] = scaleColor(c, maxBrightness);
+    }
+    prog->count = count;
+    prog->frameMs = LED_RAINBOW_CYCLE_MS / count;
+}
+
+// ============================================================
+// State Machine
+// ============================================================
+
+void led_anim_init(led_anim_t *anim) {
+    anim->base = LED_STATUS_OFF;
+    anim->overlay = LED_STATUS_OFF;
+    anim->overlayEnd = 0;
+}
+
+led_status_t led_anim_visible(const led_anim_t *anim) {
+    return (anim->overlay != LED_STATUS_OFF) ? anim->overlay : anim->base;
+}
+
+bool led_anim_set(led_anim_t *anim, led_status_t status) {
+    if (status == anim->base) return false;
+
+    led_status_t before = led_anim_visible(anim);
+    anim->base = status;
+    return led_anim_visible(anim) != before;
+}
+
+bool led_anim_trigger(led_anim_t *anim, led_status_t overlay, uint32_t now) {
+    if (overlay != LED_STATUS_SHARE_FOUND && overlay != LED_STATUS_BLOCK_FOUND) return false;
+    if (anim->overlay == LED_STATUS_BLOCK_FOUND && overlay == LED_STATUS_SHARE_FOUND) return false;
+
+    bool changed = (anim->overlay != overlay);
+    anim->overlay = overlay;
+    anim->overlayEnd = now + (overlay == LED_STATUS_BLOCK_FOUND ? LED_RAINBOW_MS : LED_FLASH_MS);
+    return changed;
+}
+
+bool led_anim_expire(led_anim_t *anim, uint32_t now) {
+    if (anim->overlay == LED_STATUS_OFF) return false;
+    if ((int32_t)(now - anim->overlayEnd) < 0) return false;
+
+    led_status_t before = led_anim_visible(anim);
+    anim->overlay = LED_STATUS_OFF;
+    return led_anim_visible(anim) != before;
+}
+
+uint32_t led_anim_overlay_remaining(const led_anim_t *anim, uint32_t now) {
+    if (anim->overlay == LED_STATUS_OFF) return 0;
+    int32_t left = (int32_t)(anim->overlayEnd - now);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+void led_anim_build(led_status_t status, uint8_t maxBrightness, led_program_t *prog) {
+    memset(prog, 0, sizeof(*prog));
+
+    switch (status) {
+        case LED_STATUS_BOOT:
+            buildSteady(prog, COLOR_YELLOW, maxBrightness);
+            break;
+        case LED_STATUS_AP_MODE:
+            buildPulse(prog, COLOR_YELLOW, LED_SLOW_PULSE_MS, maxBrightness);
+            break;
+        case LED_STATUS_CONNECTING:
+            buildPulse(prog, COLOR_BLUE, LED_SLOW_PULSE_MS, maxBrightness);
+            break;
+        case LED_STATUS_MINING:
+            // Steady: the state the LED spends its life in costs no wakeups
+            buildSteady(prog, COLOR_GREEN, maxBrightness);
+            break;
+        case LED_STATUS_SHARE_FOUND:
+            buildSteady(prog, COLOR_WHITE, maxBrightness);
+            break;
+        case LED_STATUS_BLOCK_FOUND:
+            buildRainbow(prog, maxBrightness);
+            break;
+        case LED_STATUS_ERROR:
+            buildSteady(prog, COLOR_RED, maxBrightness);
+            break;
+        case LED_STATUS_OFF:
+        default:
+            buildSteady(prog, COLOR_OFF, 0);
+            break;
+    }
+}
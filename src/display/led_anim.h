@@ -0,0 +1,95 @@
+/*
+ * SparkMiner - LED Animation State Machine
+ * Platform-independent status -> animation program logic
+ *
+ * Decides what the status LED shows and precomputes every frame of it once
+ * per state change. Lasting states (boot, mining, error) are one steady
+ * colour, written once. Only the transient ones (AP mode, connecting, the
+ * share flash and block rainbow) have frames, which led_status.cpp plays
+ * back in software from an esp_timer.
+ * No Arduino or FreeRTOS dependencies: time is passed in by the caller,
+ * which keeps this file buildable on the host.
+ *
+ * GPL v3 License
+ */
+
+#ifndef LED_ANIM_H
+#define LED_ANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "led_status.h"
+
+// Animation timing
+#define LED_SLOW_PULSE_MS       1500    // Connecting / AP mode pulse period
+#define LED_FLASH_MS            200     // Share found flash
+#define LED_RAINBOW_MS          3000    // Block found celebration
+#define LED_RAINBOW_CYCLE_MS    1500    // One trip round the colour wheel
+#define LED_PULSE_MIN           10      // Pulse floor brightness
+
+#define LED_ANIM_MAX_FRAMES     64
+#define LED_ANIM_MIN_FRAME_MS   50      // 20 fps ceiling: each frame is a timer wakeup and a bus write
+
+typedef struct {
+    uint8_t r, g, b;
+} led_rgb_t;
+
+/**
+ * Precomputed animation, brightness already applied
+ */
+typedef struct {
+    led_rgb_t frames[LED_ANIM_MAX_FRAMES];
+    uint8_t count;          // 1 = steady colour, nothing to play back
+    uint16_t frameMs;       // Frame period when count > 1 (program loops)
+} led_program_t;
+
+/**
+ * Status state machine: a base status plus a temporary overlay
+ */
+typedef struct {
+    led_status_t base;      // Status set by the monitor
+    led_status_t overlay;   // SHARE_FOUND / BLOCK_FOUND while active, else OFF
+    uint32_t overlayEnd;    // millis() when the overlay expires
+} led_anim_t;
+
+/**
+ * Reset to LED_STATUS_OFF with no overlay
+ */
+void led_anim_init(led_anim_t *anim);
+
+/**
+ * Status currently visible (overlay wins over base)
+ */
+led_status_t led_anim_visible(const led_anim_t *anim);
+
+/**
+ * Set the base status
+ * @return true if the visible animation changed
+ */
+bool led_anim_set(led_anim_t *anim, led_status_t status);
+
+/**
+ * Start a temporary overlay (LED_STATUS_SHARE_FOUND or LED_STATUS_BLOCK_FOUND)
+ * A share flash does not cut a block celebration short.
+ * @return true if the visible animation changed
+ */
+bool led_anim_trigger(led_anim_t *anim, led_status_t overlay, uint32_t now);
+
+/**
+ * Drop the overlay once it has run its course
+ * @return true if the visible animation changed
+ */
+bool led_anim_expire(led_anim_t *anim, uint32_t now);
+
+/**
+ * Milliseconds until the overlay expires (0 if none is active)
+ */
+uint32_t led_anim_overlay_remaining(const led_anim_t *anim, uint32_t now);
+
+/**
+ * Precompute the animation for a status
+ * @param maxBrightness Peak brightness (0-255, FastLED nscale8 semantics)
+ */
+void led_anim_build(led_status_t status, uint8_t maxBrightness, led_program_t *prog);
+
+#endif // LED_ANIM_H
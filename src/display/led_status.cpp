@@ -2,15 +2,26 @@
  * SparkMiner - LED Status Driver Implementation
  * Visual feedback via RGB LED for headless builds
  *
+ * Animations are precomputed by led_anim on state changes and played back
+ * in software from an esp_timer callback that pushes each frame through
+ * FastLED's RMT driver, at most every LED_ANIM_MIN_FRAME_MS. Steady
+ * colours, mining included, stop the timer: the LED holds the last frame
+ * and the CPU only runs on state changes and share/block overlays.
+ *
  * GPL v3 License
  */
 
 #include <Arduino.h>
 #include <board_config.h>
 #include "led_status.h"
+#include "led_anim.h"
 
 #if USE_LED_STATUS
 
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
 #include <FastLED.h>
 
 // ============================================================
@@ -25,81 +36,36 @@
 #define RGB_LED_BRIGHTNESS 32  // 0-255, keep low to reduce power/heat
 #endif
 
-// Animation timing
-#define SLOW_PULSE_MS   1500   // Connecting pulse period
-#define FAST_PULSE_MS   500    // Mining pulse period
-#define FLASH_DURATION  200    // Share found flash
-#define RAINBOW_DURATION 3000  // Block found celebration
+#define LED_OVERLAY_RETRY_MS    5   // Overlay expiry found the LED busy: look again this soon
 
 // ============================================================
 // State
 // ============================================================
 
 static CRGB s_leds[RGB_LED_COUNT];
-static led_status_t s_currentStatus = LED_STATUS_OFF;
-static led_status_t s_previousStatus = LED_STATUS_OFF;  // For returning after flash
-static bool s_enabled = true;
-static uint32_t s_lastUpdate = 0;
-static uint32_t s_flashStart = 0;
-static uint8_t s_brightness = 0;
-static int8_t s_fadeDirection = 1;
 
-// ============================================================
-// Color Definitions (GRB format for most NeoPixels)
-// ============================================================
+static led_anim_t s_anim;
+static led_program_t s_program;
+static uint8_t s_frame = 0;
+static bool s_enabled = true;
+static bool s_ready = false;
 
-static const CRGB COLOR_YELLOW = CRGB(255, 200, 0);
-static const CRGB COLOR_BLUE   = CRGB(0, 100, 255);
-static const CRGB COLOR_GREEN  = CRGB(0, 255, 50);
-static const CRGB COLOR_WHITE  = CRGB(255, 255, 255);
-static const CRGB COLOR_RED    = CRGB(255, 0, 0);
-static const CRGB COLOR_OFF    = CRGB(0, 0, 0);
+static SemaphoreHandle_t s_ledMutex = NULL;
+static esp_timer_handle_t s_playTimer = NULL;       // Frame / keyframe playback
+static esp_timer_handle_t s_overlayTimer = NULL;    // Ends share flash / rainbow
 
 // ============================================================
-// Helper Functions
+// Hardware Layer
 // ============================================================
 
-static void setColor(CRGB color, uint8_t brightness) {
-    s_leds[0] = color;
-    s_leds[0].nscale8(brightness);
-    FastLED.show();
-}
-
-static void updatePulse(CRGB color, uint16_t periodMs) {
-    uint32_t now = millis();
-    uint32_t elapsed = now - s_lastUpdate;
-
-    // Calculate fade step based on period
-    // Full cycle = 0->255->0 = 510 steps
-    // At 10ms update rate: steps per update = (510 * 10) / periodMs
-    uint8_t fadeStep = max(1, (510 * 10) / periodMs);
-
-    s_brightness += s_fadeDirection * fadeStep;
-
-    // Bounce at limits
-    if (s_brightness >= RGB_LED_BRIGHTNESS) {
-        s_brightness = RGB_LED_BRIGHTNESS;
-        s_fadeDirection = -1;
-    } else if (s_brightness <= 10) {
-        s_brightness = 10;
-        s_fadeDirection = 1;
+static void hwShow(led_rgb_t c) {
+    for (uint8_t i = 0; i < RGB_LED_COUNT; i++) {
+        s_leds[i] = CRGB(c.r, c.g, c.b);
     }
-
-    setColor(color, s_brightness);
-    s_lastUpdate = now;
-}
-
-static void updateRainbow() {
-    static uint8_t hue = 0;
-    s_leds[0] = CHSV(hue++, 255, RGB_LED_BRIGHTNESS);
     FastLED.show();
 }
 
-// ============================================================
-// Public API
-// ============================================================
-
-void led_status_init() {
+static bool hwInit() {
     #if defined(RGB_LED_PIN)
         // Configure FastLED based on LED type
         #if defined(RGB_LED_TYPE_WS2812)
@@ -118,110 +84,149 @@ void led_status_init() {
         FastLED.setBrightness(RGB_LED_BRIGHTNESS);
         FastLED.clear(true);
 
-        s_currentStatus = LED_STATUS_BOOT;
-        s_enabled = true;
-
         Serial.printf("[LED] Status driver initialized (pin %d)\n", RGB_LED_PIN);
+        return true;
     #else
         Serial.println("[LED] No RGB_LED_PIN defined, LED status disabled");
-        s_enabled = false;
+        return false;
     #endif
 }
 
-void led_status_set(led_status_t status) {
-    if (status != s_currentStatus) {
-        s_previousStatus = s_currentStatus;
-        s_currentStatus = status;
-        s_brightness = RGB_LED_BRIGHTNESS / 2;  // Reset brightness for new state
-        s_fadeDirection = 1;
+// ============================================================
+// Playback
+// ============================================================
 
-        #ifdef DEBUG_LED
-        const char* statusNames[] = {
-            "OFF", "BOOT", "AP_MODE", "CONNECTING",
-            "MINING", "SHARE", "BLOCK", "ERROR"
-        };
-        Serial.printf("[LED] Status: %s\n", statusNames[status]);
-        #endif
+// Caller holds s_ledMutex
+static void applyProgram() {
+    esp_timer_stop(s_playTimer);
+    if (!s_enabled) {
+        hwShow({0, 0, 0});
+        return;
     }
+
+    led_anim_build(led_anim_visible(&s_anim), RGB_LED_BRIGHTNESS, &s_program);
+    s_frame = 0;
+    hwShow(s_program.frames[0]);
+    if (s_program.count <= 1) return;  // Steady colour: the LED holds it
+
+    esp_timer_start_periodic(s_playTimer, (uint32_t)s_program.frameMs * 1000);
 }
 
-led_status_t led_status_get() {
-    return s_currentStatus;
+// Caller holds s_ledMutex; (re)arm the expiry for the overlay now showing
+static void armOverlayTimer(uint32_t now) {
+    uint32_t remaining = led_anim_overlay_remaining(&s_anim, now);
+    if (remaining == 0) return;
+    esp_timer_stop(s_overlayTimer);
+    esp_timer_start_once(s_overlayTimer, (uint64_t)remaining * 1000);
 }
 
-void led_status_share_found() {
-    s_previousStatus = s_currentStatus;
-    s_currentStatus = LED_STATUS_SHARE_FOUND;
-    s_flashStart = millis();
-    setColor(COLOR_WHITE, RGB_LED_BRIGHTNESS);
+static void onPlayTimer(void *arg) {
+    (void)arg;
+    // Skip a frame rather than block while a state change is being applied
+    if (xSemaphoreTake(s_ledMutex, 0) != pdTRUE) return;
+
+    s_frame = (s_frame + 1) % s_program.count;
+    hwShow(s_program.frames[s_frame]);
+
+    xSemaphoreGive(s_ledMutex);
 }
 
-void led_status_block_found() {
-    s_previousStatus = s_currentStatus;
-    s_currentStatus = LED_STATUS_BLOCK_FOUND;
-    s_flashStart = millis();
-    Serial.println("[LED] BLOCK FOUND! Rainbow celebration!");
+static void onOverlayTimer(void *arg) {
+    (void)arg;
+    // Runs on the shared esp_timer task: never wait for the lock, come back shortly
+    if (xSemaphoreTake(s_ledMutex, 0) != pdTRUE) {
+        esp_timer_start_once(s_overlayTimer, LED_OVERLAY_RETRY_MS * 1000);
+        return;
+    }
+    uint32_t now = millis();
+    if (led_anim_expire(&s_anim, now)) {
+        applyProgram();
+    }
+    armOverlayTimer(now);   // Extended by a trigger while this was pending
+    xSemaphoreGive(s_ledMutex);
 }
 
-void led_status_update() {
-    if (!s_enabled) return;
+static void triggerOverlay(led_status_t overlay) {
+    if (!s_ready) return;
 
+    xSemaphoreTake(s_ledMutex, portMAX_DELAY);
     uint32_t now = millis();
-
-    // Handle temporary states (flash/celebration)
-    if (s_currentStatus == LED_STATUS_SHARE_FOUND) {
-        if (now - s_flashStart >= FLASH_DURATION) {
-            s_currentStatus = s_previousStatus;
-        } else {
-            return;  // Keep showing white flash
-        }
+    if (led_anim_trigger(&s_anim, overlay, now)) {
+        applyProgram();
     }
+    armOverlayTimer(now);
+    xSemaphoreGive(s_ledMutex);
+}
 
-    if (s_currentStatus == LED_STATUS_BLOCK_FOUND) {
-        if (now - s_flashStart >= RAINBOW_DURATION) {
-            s_currentStatus = s_previousStatus;
-        } else {
-            updateRainbow();
-            return;
-        }
-    }
+// ============================================================
+// Public API
+// ============================================================
 
-    // Update based on current status
-    switch (s_currentStatus) {
-        case LED_STATUS_OFF:
-            setColor(COLOR_OFF, 0);
-            break;
+void led_status_init() {
+    if (s_ready) return;
+
+    led_anim_init(&s_anim);
+    s_enabled = hwInit();
+    if (!s_enabled) return;
 
-        case LED_STATUS_BOOT:
-            setColor(COLOR_YELLOW, RGB_LED_BRIGHTNESS);
-            break;
+    s_ledMutex = xSemaphoreCreateMutex();
 
-        case LED_STATUS_AP_MODE:
-            updatePulse(COLOR_YELLOW, SLOW_PULSE_MS);
-            break;
+    esp_timer_create_args_t playArgs = {};
+    playArgs.callback = onPlayTimer;
+    playArgs.name = "led_play";
+    esp_timer_create_args_t overlayArgs = {};
+    overlayArgs.callback = onOverlayTimer;
+    overlayArgs.name = "led_overlay";
+
+    if (!s_ledMutex || esp_timer_create(&playArgs, &s_playTimer) != ESP_OK ||
+        esp_timer_create(&overlayArgs, &s_overlayTimer) != ESP_OK) {
+        Serial.println("[LED] ERROR: Failed to create playback timers");
+        s_enabled = false;
+        return;
+    }
 
-        case LED_STATUS_CONNECTING:
-            updatePulse(COLOR_BLUE, SLOW_PULSE_MS);
-            break;
+    s_ready = true;
+    led_status_set(LED_STATUS_BOOT);
+}
 
-        case LED_STATUS_MINING:
-            updatePulse(COLOR_GREEN, FAST_PULSE_MS);
-            break;
+void led_status_set(led_status_t status) {
+    if (!s_ready) return;
 
-        case LED_STATUS_ERROR:
-            setColor(COLOR_RED, RGB_LED_BRIGHTNESS);
-            break;
+    xSemaphoreTake(s_ledMutex, portMAX_DELAY);
+    if (led_anim_set(&s_anim, status)) {
+        applyProgram();
 
-        default:
-            break;
+        #ifdef DEBUG_LED
+        const char* statusNames[] = {
+            "OFF", "BOOT", "AP_MODE", "CONNECTING",
+            "MINING", "SHARE", "BLOCK", "ERROR"
+        };
+        Serial.printf("[LED] Status: %s\n", statusNames[status]);
+        #endif
     }
+    xSemaphoreGive(s_ledMutex);
+}
+
+led_status_t led_status_get() {
+    return led_anim_visible(&s_anim);
+}
+
+void led_status_share_found() {
+    triggerOverlay(LED_STATUS_SHARE_FOUND);
+}
+
+void led_status_block_found() {
+    Serial.println("[LED] BLOCK FOUND! Rainbow celebration!");
+    triggerOverlay(LED_STATUS_BLOCK_FOUND);
 }
 
 void led_status_toggle() {
+    if (!s_ready) return;
+
+    xSemaphoreTake(s_ledMutex, portMAX_DELAY);
     s_enabled = !s_enabled;
-    if (!s_enabled) {
-        FastLED.clear(true);
-    }
+    applyProgram();
+    xSemaphoreGive(s_ledMutex);
     Serial.printf("[LED] Status feedback %s\n", s_enabled ? "enabled" : "disabled");
 }
 
@@ -237,7 +242,6 @@ void led_status_set(led_status_t status) { (void)status; }
 led_status_t led_status_get() { return LED_STATUS_OFF; }
 void led_status_share_found() {}
 void led_status_block_found() {}
-void led_status_update() {}
 void led_status_toggle() {}
 bool led_status_is_enabled() { return false; }
 
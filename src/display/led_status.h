@@ -6,10 +6,15 @@
  * - Yellow solid: Waiting for WiFi config
  * - Yellow pulse: AP mode active
  * - Blue slow pulse: Connecting to WiFi/pool
- * - Green fast pulse: Mining active
+ * - Green solid: Mining active
  * - White flash: Share accepted
  * - Red solid: Error state
  *
+ * Pulses and overlays play from an esp_timer; callers only report state
+ * changes.
+ * LED type (board_config.h / build flags): RGB_LED_PIN plus
+ * RGB_LED_TYPE_WS2812B etc., an addressable LED driven by FastLED
+ *
  * GPL v3 License
  */
 
@@ -24,7 +29,7 @@ typedef enum {
     LED_STATUS_BOOT,          // Yellow solid - booting
     LED_STATUS_AP_MODE,       // Yellow pulse - AP config mode
     LED_STATUS_CONNECTING,    // Blue slow pulse - connecting
-    LED_STATUS_MINING,        // Green fast pulse - actively mining
+    LED_STATUS_MINING,        // Green solid - actively mining
     LED_STATUS_SHARE_FOUND,   // White flash - share accepted (temporary)
     LED_STATUS_BLOCK_FOUND,   // Rainbow - block found! (temporary)
     LED_STATUS_ERROR          // Red solid - error state
@@ -38,6 +43,7 @@ void led_status_init();
 
 /**
  * Set current LED status
+ * Only a change of visible status touches the hardware
  * @param status The status to display
  */
 void led_status_set(led_status_t status);
@@ -60,12 +66,6 @@ void led_status_share_found();
  */
 void led_status_block_found();
 
-/**
- * Update LED animation
- * Call this from monitor task loop (~10-100ms interval)
- */
-void led_status_update();
-
 /**
  * Toggle LED on/off (for user button control)
  */
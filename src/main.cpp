@@ -14,7 +14,6 @@
 #include <esp_pm.h>
 #include <Preferences.h>
 #include <OneButton.h>
-#include <soc/soc_caps.h>  // For SOC_CPU_CORES_NUM
 
 #include <board_config.h>
 #include "mining/miner.h"
@@ -23,54 +22,65 @@
 #include "config/nvs_config.h"
 #include "config/wifi_manager.h"
 #include "stats/monitor.h"
+#include "stats/mem_place.h"
 #include "display/display.h"
-
-// Task handles
-TaskHandle_t miner0Task = NULL;
-TaskHandle_t miner1Task = NULL;
-TaskHandle_t stratumTask = NULL;
-TaskHandle_t monitorTask = NULL;
-TaskHandle_t buttonTask = NULL;
+#include "display/display_task.h"
+#include "ota/ota_update.h"
+#include "tasks.h"
 
 // Global state
 volatile bool systemReady = false;
 
 // Button handling (OneButton)
-#if defined(BUTTON_PIN) && USE_DISPLAY
+#if defined(BUTTON_PIN) && (USE_DISPLAY || USE_OLED_DISPLAY)
 OneButton button(BUTTON_PIN, true, true);  // active low, enable pullup
 
 // Single click: cycle screens
 void onButtonClick() {
+    if (display_task_wake()) return;  // First press only wakes a sleeping screen
     display_next_screen();
 }
 
-// Double click: cycle screen rotation (0->1->2->3->0)
+// Double click: cycle screen rotation (0->1->2->3->0, OLED 0->2->0)
 void onButtonDoubleClick() {
+    if (display_task_wake()) return;
     Serial.println("[BUTTON] Double-click detected - cycling rotation");
-    uint8_t newRotation = display_flip_rotation();
-    // Save to NVS
     miner_config_t *config = nvs_config_get();
+    #if USE_OLED_DISPLAY
+        uint8_t newRotation = config->rotation >= 2 ? 0 : 2;
+    #else
+        uint8_t newRotation = (config->rotation + 1) % 4;
+    #endif
+    display_task_set_rotation(newRotation);
+    // Save to NVS
     config->rotation = newRotation;
     nvs_config_save(config);
     Serial.printf("[BUTTON] New rotation saved: %d\n", newRotation);
 }
 
-// Triple click: toggle color inversion
+// Triple click: toggle color inversion; quad click: settings page
 void onButtonMultiClick() {
+    if (display_task_wake()) return;
     int clicks = button.getNumberClicks();
     if (clicks == 3) {
         Serial.println("[BUTTON] Triple-click detected - toggling color theme");
         miner_config_t *config = nvs_config_get();
         config->invertColors = !config->invertColors;
-        display_set_inverted(config->invertColors);
+        display_task_set_inverted(config->invertColors);
         nvs_config_save(config);
         Serial.printf("[BUTTON] Theme switched to %s mode\n", config->invertColors ? "Dark" : "Light");
+    } else if (clicks == 4) {
+        Serial.println("[BUTTON] Quad-click detected - opening settings page");
+        if (!wifi_manager_open_settings()) {
+            Serial.println("[BUTTON] Settings page unavailable (no WiFi or portal already open)");
+        }
     }
 }
 
 // Long press: factory reset with 3-second visual countdown
 void onButtonLongPressStart() {
     Serial.println("[RESET] Long press detected - starting countdown...");
+    display_task_wake();  // Countdown must be visible
 
     // Visual countdown on display
     for (int i = 3; i > 0; i--) {
@@ -109,7 +119,7 @@ void onButtonLongPressStart() {
 }
 #endif
 
-#if defined(BUTTON_PIN) && USE_DISPLAY
+#if defined(BUTTON_PIN) && (USE_DISPLAY || USE_OLED_DISPLAY)
 /**
  * Dedicated button handling task
  * Runs at higher priority than mining to ensure responsive UI
@@ -125,7 +135,6 @@ void button_task(void *param) {
 
 // Forward declarations
 void setupPowerManagement();
-void setupTasks();
 void printBanner();
 void checkFactoryReset();
 
@@ -228,21 +237,22 @@ void setup() {
     stratum_set_pool(config->poolUrl, config->poolPort, config->wallet, config->poolPassword, config->workerName);
     stratum_set_backup_pool(config->backupPoolUrl, config->backupPoolPort,
                            config->backupWallet, config->backupPoolPassword, config->workerName);
+    stratum_set_difficulty(config->targetDifficulty);
 
     // Initialize display early (needed for WiFi setup screen)
-    #if USE_DISPLAY
+    #if USE_DISPLAY || USE_OLED_DISPLAY
         display_init(config->rotation, config->brightness);
         display_set_inverted(config->invertColors);
     #endif
 
     // Setup button handlers (OneButton)
-    #if defined(BUTTON_PIN) && USE_DISPLAY
+    #if defined(BUTTON_PIN) && (USE_DISPLAY || USE_OLED_DISPLAY)
         button.setClickMs(400);          // Time window for single click (ms)
         button.setPressMs(1500);         // Time for long press to start (1.5s)
         button.setDebounceMs(50);        // Debounce time (ms)
         button.attachClick(onButtonClick);
         button.attachDoubleClick(onButtonDoubleClick);
-        button.attachMultiClick(onButtonMultiClick);          // Triple-click for inversion
+        button.attachMultiClick(onButtonMultiClick);          // Triple-click inversion, quad-click settings
         button.attachLongPressStart(onButtonLongPressStart);  // Factory reset handler
         Serial.println("[INIT] Button handlers registered (click/double/triple/long-press)");
     #endif
@@ -263,7 +273,13 @@ void setup() {
     }
 
     // Start FreeRTOS tasks
-    setupTasks();
+    tasks_start();
+
+    // Background firmware update checks (needs a built-in key and config ota_url)
+    ota_init();
+
+    // Boot memory map (buffers placed during init, heap headroom after task stacks)
+    mem_place_report();
 
     // Print configuration summary
     Serial.println();
@@ -292,6 +308,9 @@ void setup() {
  */
 void loop() {
     // Button handling moved to dedicated FreeRTOS task for responsiveness during mining
+    // Serve the settings page while it is open (quad-click)
+    wifi_manager_process();
+
     // Yield to FreeRTOS tasks
     vTaskDelay(pdMS_TO_TICKS(100));  // Main loop can sleep longer now
 }
@@ -315,100 +334,6 @@ void setupPowerManagement() {
     #endif
 }
 
-/**
- * Create FreeRTOS tasks for mining and pool communication
- * Miner tasks are only created if wallet is configured
- */
-void setupTasks() {
-    Serial.println("[INIT] Creating FreeRTOS tasks...");
-
-    bool hasValidConfig = nvs_config_is_valid();
-
-    // Stratum task (pool communication) - only if configured
-    if (hasValidConfig) {
-        xTaskCreatePinnedToCore(
-            stratum_task,
-            "Stratum",
-            STRATUM_STACK,
-            NULL,
-            STRATUM_PRIORITY,
-            &stratumTask,
-            STRATUM_CORE
-        );
-    }
-
-    // Monitor task (display + stats) - always runs for UI
-    xTaskCreatePinnedToCore(
-        monitor_task,
-        "Monitor",
-        MONITOR_STACK,
-        NULL,
-        MONITOR_PRIORITY,
-        &monitorTask,
-        MONITOR_CORE
-    );
-
-    // Button task (responsive UI during mining)
-    // Needs 4KB+ stack for NVS writes (rotation save) and display updates
-    #if defined(BUTTON_PIN) && USE_DISPLAY
-        xTaskCreatePinnedToCore(
-            button_task,
-            "Button",
-            4096,           // 4KB stack for NVS/flash operations in handlers
-            NULL,
-            5,              // Priority 5: above miner0 (1), below miner1 (19)
-            &buttonTask,
-            0               // Core 0 with other UI tasks
-        );
-    #endif
-
-    // Only create miner tasks if wallet is configured
-    if (hasValidConfig) {
-        #if (SOC_CPU_CORES_NUM >= 2)
-            // Dual-core: Run miners on both cores
-            // Miner on Core 1 (high priority, dedicated core)
-            xTaskCreatePinnedToCore(
-                miner_task_core1,
-                "Miner1",
-                MINER_1_STACK,
-                NULL,
-                MINER_1_PRIORITY,
-                &miner1Task,
-                MINER_1_CORE
-            );
-
-            // Miner on Core 0 (lower priority, yields to WiFi/Stratum/Display)
-            xTaskCreatePinnedToCore(
-                miner_task_core0,
-                "Miner0",
-                MINER_0_STACK,
-                NULL,
-                MINER_0_PRIORITY,
-                &miner0Task,
-                MINER_0_CORE
-            );
-
-            Serial.println("[INIT] All tasks created (dual-core mining)");
-        #else
-            // Single-core (C3, S2): Run only one miner task, not pinned
-            // Must yield frequently to let WiFi/Stratum work
-            xTaskCreate(
-                miner_task_core0,
-                "Miner",
-                MINER_0_STACK,
-                NULL,
-                MINER_0_PRIORITY,
-                &miner0Task
-            );
-
-            Serial.println("[INIT] All tasks created (single-core mining)");
-        #endif
-    } else {
-        Serial.println("[INIT] Monitor task created (mining disabled - no wallet)");
-        Serial.println("[INIT] Configure via captive portal or SD card config.json");
-    }
-}
-
 /**
  * Print startup banner
  */
@@ -0,0 +1,36 @@
+/*
+ * SparkMiner - Core Platform Layer
+ * The only platform-specific pieces the portable mining core needs
+ *
+ * The mining core (software SHA, header/merkle build, target math and
+ * stratum message handling) must build both in the firmware and in the
+ * PlatformIO native environment. It may use standard C headers and this
+ * file, nothing from Arduino or ESP-IDF.
+ *
+ * GPL v3 License
+ */
+
+#ifndef CORE_PLATFORM_H
+#define CORE_PLATFORM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(ESP_PLATFORM)
+    // IRAM_ATTR / DRAM_ATTR placement attributes
+    #include <esp_attr.h>
+#else
+    #define IRAM_ATTR
+    #define DRAM_ATTR
+#endif
+
+// Core 0 software SHA kernel placement: IRAM on boards that set
+// MINING_KERNEL_IRAM and have the room (check scripts/mem_budget.py),
+// flash otherwise
+#if defined(MINING_KERNEL_IRAM) && MINING_KERNEL_IRAM
+    #define MINING_KERNEL_ATTR IRAM_ATTR
+#else
+    #define MINING_KERNEL_ATTR
+#endif
+
+#endif // CORE_PLATFORM_H
@@ -0,0 +1,185 @@
+/*
+ * SparkMiner - Golden Test Vectors Implementation
+ * Header hashes verified against block explorers; synthetic vectors and
+ * job pipeline results generated with an independent (hashlib) reference
+ *
+ * GPL v3 License
+ */
+
+#include <string.h>
+#include <ArduinoJson.h>
+#include "core_vectors.h"
+#include "mining_core.h"
+#include "miner_sha256.h"
+#include "../stratum/stratum_msg.h"
+
+// JSON pool for the notify vectors (largest line is ~650 bytes)
+#define VECTOR_JSON_SIZE    2048
+
+// ============================================================
+// Corpus
+// ============================================================
+
+static const core_header_vector_t s_headerVectors[] = {
+    {"mainnet-0",
+     "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd"
+     "7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c",
+     "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f"},
+    {"mainnet-1",
+     "010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982051fd"
+     "1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e61bc6649ffff001d01e36299",
+     "00000000839a8e6886ab5951d76f411475428afc90947ee320161bbf18eb6048"},
+    {"testnet3-0",
+     "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd"
+     "7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4adae5494dffff001d1aa4ae18",
+     "000000000933ea01ad0ee984209779baaec3ced90fa3f408719526f8d77f4943"},
+    {"mainnet-125552",
+     "0100000081cd02ab7e569e8bcd9317e2fe99f2de44d49ab2b8851ba4a308000000000000e320b6c2"
+     "fffc8d750423db8b1eb942ae710e951ed797f7affc8892b0f1fc122bc7f5d74df2b9441a42a14695",
+     "00000000000000001e8d6829a8a21adc5d38d0a473b144b6765798e61f98bd1d"},
+    {"nonce-max",
+     "010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982051fd"
+     "1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e61bc6649ffff001dffffffff",
+     "044c75a8a7add62566aed0c21bb2156db8fa8757b87380f0e6ba49b115c5ce05"},
+    {"nonce-wrap",
+     "010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982051fd"
+     "1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e61bc6649ffff001d00000000",
+     "1bf57b5ab9dae8a580144e1be32dc767c4aa2b8ab752e6a04f5044dc9310cd9d"},
+    {"zero-header",
+     "00000000000000000000000000000000000000000000000000000000000000000000000000000000"
+     "00000000000000000000000000000000000000000000000000000000000000000000000000000000",
+     "14508459b221041eab257d2baaa7459775ba748246c8403609eb708f0e57e74b"},
+    {"early-16bit",
+     "010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982051fd"
+     "1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e00f15365ffff001dac380000",
+     "000002af47bd635ec56d7863a4e9ea99d3671f56425c30d7f9ac0fc7375a1002"},
+};
+
+static const core_job_vector_t s_jobVectors[] = {
+    {"mainnet-0",
+     "{\"id\":null,\"method\":\"mining.notify\",\"params\":[\"mainnet-0\",\"000000000000000000"
+     "0000000000000000000000000000000000000000000000\",\"0100000001000000000000000000000000000"
+     "0000000000000000000000000000000000000ffffffff4d04ffff001d0104455468652054696d65732030332"
+     "f4a616e2f32303039204368616e63656c6c6f72206f6e206272696e6b206f66207365636f6e64206261696c6"
+     "f757420666f722062616e6b73ffffffff0100f2052a01000000434104678afdb0fe\",\"30b7105cd6a828e0"
+     "3909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5fac"
+     "00000000\",[],\"00000001\",\"1d00ffff\",\"495fab29\",true]}",
+     "55482719", 4, 0x67F1A671, 0x7c2bac1d,
+     "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f"},
+    {"mainnet-1",
+     "{\"id\":null,\"method\":\"mining.notify\",\"params\":[\"mainnet-1\",\"0a8ce26f72b3f1b646"
+     "a2a6c14ff763ae65831e939c085ae10019d66800000000\",\"0100000001000000000000000000000000000"
+     "0000000000000000000000000000000000000ffffffff0704\",\"ffff0100f2052a0100000043410496b538"
+     "e853519c726a2c91e61ec11600ae1390813a627c66fb8be7947be63c52da7589379515d4e0a604f8141781e6"
+     "2294721166bf621e73a82cbf2342c858eeac00000000\",[],\"00000001\",\"1d00ffff\",\"4966bc61\""
+     ",true]}",
+     "ffff001d", 4, 0x0104FFFF, 0x9962e301,
+     "00000000839a8e6886ab5951d76f411475428afc90947ee320161bbf18eb6048"},
+    {"synthetic-3br",
+     "{\"id\":null,\"method\":\"mining.notify\",\"params\":[\"synthetic-3br\",\"0a8ce26f72b3f1"
+     "b646a2a6c14ff763ae65831e939c085ae10019d66800000000\",\"010000000100000000000000000000000"
+     "00000000000000000000000000000000000000000ffffffff\",\"0704ffff001d0104ffffffff0100f2052a"
+     "0100000043410496b538e853519c726a2c91e61ec11600ae1390813a627c66fb8be7947be63c52da75893795"
+     "15d4e0a604f8141781e62294721166bf621e73a82cbf2342c858eeac00000000\",[\"bb48e9c6097d0185fe"
+     "a951d532757fda8dc1bd5d9b268bf2c1b742867766e4e5\",\"b9549a3820a9f0790b83cf0b260b7f87af4a8"
+     "91b033d33e76c224ab41c451ee8\",\"bb1a8b12778d0725c3c6fdc8bab57b06b69aa1a622e18c989dec3028"
+     "432f51e1\"],\"20000000\",\"1703a30c\",\"6553f100\",true]}",
+     "f000000d", 8, 0x1234ABCD, 0xdeadbeef,
+     "375ca2a5086f2141038eaec19f3aa70dde6cde053619890b30f88d0cfe613fe4"},
+};
+
+#define HEADER_VECTOR_COUNT (sizeof(s_headerVectors) / sizeof(s_headerVectors[0]))
+#define JOB_VECTOR_COUNT    (sizeof(s_jobVectors) / sizeof(s_jobVectors[0]))
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+// Explorer order is the reverse of sha256_hash_t byte order
+static void decodeHash(sha256_hash_t *out, const char *hex) {
+    uint8_t be[32];
+    core_hex_decode(be, hex, 64);
+    for (int i = 0; i < 32; i++) out->bytes[i] = be[31 - i];
+}
+
+// Early reject is only allowed for hashes whose top 16 bits are non-zero
+static bool checkHash(core_engine_fn engine, const block_header_t *hb, const char *expectedHex) {
+    sha256_hash_t expected, got;
+    decodeHash(&expected, expectedHex);
+
+    memset(&got, 0, sizeof(got));
+    if (!engine(hb, &got)) {
+        return expected.bytes[31] != 0 || expected.bytes[30] != 0;
+    }
+    return memcmp(got.bytes, expected.bytes, 32) == 0;
+}
+
+static void record(core_vectors_result_t *res, const char *name, bool ok) {
+    res->run++;
+    if (!ok) {
+        if (!res->firstFailure) res->firstFailure = name;
+        res->failed++;
+    }
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+const core_header_vector_t *core_vectors_headers(size_t *count) {
+    *count = HEADER_VECTOR_COUNT;
+    return s_headerVectors;
+}
+
+const core_job_vector_t *core_vectors_jobs(size_t *count) {
+    *count = JOB_VECTOR_COUNT;
+    return s_jobVectors;
+}
+
+core_vectors_result_t core_vectors_check_engine(core_engine_fn engine) {
+    core_vectors_result_t res = {0, 0, NULL};
+
+    for (size_t i = 0; i < HEADER_VECTOR_COUNT; i++) {
+        const core_header_vector_t *v = &s_headerVectors[i];
+        block_header_t hb;
+        core_hex_decode((uint8_t *)&hb, v->header, sizeof(hb) * 2);
+        record(&res, v->name, checkHash(engine, &hb, v->hash));
+    }
+    return res;
+}
+
+core_vectors_result_t core_vectors_check_jobs(core_engine_fn engine) {
+    core_vectors_result_t res = {0, 0, NULL};
+    DynamicJsonDocument doc(VECTOR_JSON_SIZE);
+    stratum_job_t *job = new stratum_job_t;
+
+    for (size_t i = 0; i < JOB_VECTOR_COUNT; i++) {
+        const core_job_vector_t *v = &s_jobVectors[i];
+        block_header_t hb;
+        bool ok = !deserializeJson(doc, v->notify) &&
+                  stratum_msg_classify(doc.as<JsonVariantConst>()) == STRATUM_MSG_NOTIFY &&
+                  stratum_msg_parse_notify(doc.as<JsonVariantConst>(), v->extraNonce1,
+                                           v->extraNonce2Size, job) &&
+                  core_build_header(&hb, job, v->extraNonce2, v->extraNonce2Size);
+        if (ok) {
+            hb.nonce = v->nonce;
+            ok = checkHash(engine, &hb, v->hash);
+        }
+        record(&res, v->name, ok);
+    }
+
+    delete job;
+    return res;
+}
+
+bool core_engine_sha256d(const block_header_t *hb, sha256_hash_t *out) {
+    core_sha256d(out, (const uint8_t *)hb, sizeof(*hb));
+    return true;
+}
+
+bool core_engine_midstate(const block_header_t *hb, sha256_hash_t *out) {
+    block_header_t copy = *hb;
+    sha256_hash_t midstate;
+    miner_sha256_midstate(&midstate, &copy);
+    return miner_sha256_header(&midstate, out, &copy);
+}
@@ -0,0 +1,100 @@
+/*
+ * SparkMiner - Golden Test Vectors
+ * Known-answer headers and stratum jobs for every hashing engine
+ *
+ * Header vectors are real mainnet/testnet blocks plus synthetic edge cases
+ * (nonce 0xFFFFFFFF and its wrap to 0, an all-zero header, a hash that
+ * passes the 16-bit early reject but not the 32-bit one). Job vectors are
+ * mining.notify lines with the solving extraNonce2/nonce; they run the
+ * whole notify -> header -> hash pipeline.
+ *
+ * Engines are checked through a single adapter signature, so the firmware
+ * boot self-test and the host tools run the same corpus.
+ *
+ * GPL v3 License
+ */
+
+#ifndef CORE_VECTORS_H
+#define CORE_VECTORS_H
+
+#include "core_platform.h"
+#include "sha256_types.h"
+
+/**
+ * Known-answer block header
+ */
+typedef struct {
+    const char *name;
+    const char *header;         // 80 bytes as hex, serialized order (nonce included)
+    const char *hash;           // Double SHA-256, block explorer order (big-endian)
+} core_header_vector_t;
+
+/**
+ * Known-answer stratum job and its solution
+ */
+typedef struct {
+    const char *name;
+    const char *notify;         // mining.notify line as received from the pool
+    const char *extraNonce1;    // From mining.subscribe
+    int extraNonce2Size;
+    uint32_t extraNonce2;       // Solving extraNonce2
+    uint32_t nonce;             // Solving nonce
+    const char *hash;           // Expected header hash, block explorer order
+} core_job_vector_t;
+
+/**
+ * Hash engine adapter
+ * Computes the double SHA-256 of an 80-byte header (nonce included)
+ * @param hb Header to hash
+ * @param out Hash in sha256_hash_t byte order (bytes[31] most significant)
+ * @return false if the engine rejected the header early (out not valid);
+ *         engines with a 16-bit early reject may only do so when the top
+ *         16 bits of the hash are non-zero
+ */
+typedef bool (*core_engine_fn)(const block_header_t *hb, sha256_hash_t *out);
+
+/**
+ * Result of a vector run
+ */
+typedef struct {
+    uint16_t run;               // Vectors checked
+    uint16_t failed;            // Vectors with a wrong result
+    const char *firstFailure;   // Name of the first failing vector, NULL if none
+} core_vectors_result_t;
+
+/**
+ * Access the header corpus
+ * @param count Output, number of vectors
+ */
+const core_header_vector_t *core_vectors_headers(size_t *count);
+
+/**
+ * Access the job corpus
+ * @param count Output, number of vectors
+ */
+const core_job_vector_t *core_vectors_jobs(size_t *count);
+
+/**
+ * Check an engine against every header vector
+ */
+core_vectors_result_t core_vectors_check_engine(core_engine_fn engine);
+
+/**
+ * Check the full pipeline against every job vector:
+ * stratum_msg_parse_notify -> core_build_header -> engine
+ * @param engine Engine used for the final hash
+ */
+core_vectors_result_t core_vectors_check_jobs(core_engine_fn engine);
+
+/**
+ * Reference engine: plain double SHA-256 (never rejects early)
+ */
+bool core_engine_sha256d(const block_header_t *hb, sha256_hash_t *out);
+
+/**
+ * Software mining engine: midstate + tail with 16-bit early reject
+ * (miner_sha256_midstate / miner_sha256_header, used by Core 0)
+ */
+bool core_engine_midstate(const block_header_t *hb, sha256_hash_t *out);
+
+#endif // CORE_VECTORS_H
@@ -26,14 +26,15 @@
 #include "sha256_asm.h"  // Pipelined assembly mining (Core 1) - ESP32
 #include "sha256_pipelined_s3.h"  // Pipelined assembly mining (Core 1) - ESP32-S3
 #include "miner_sha256.h"  // BitsyMiner software SHA-256 (verification + Core 0)
+#include "mining_core.h"   // Portable header build, target and difficulty math
+#include "core_vectors.h"  // Golden vectors for the boot self-test
 #include "../stratum/stratum.h"
 #include "board_config.h"
 
 // ============================================================
 // Constants
 // ============================================================
-#define MAX_DIFFICULTY 0x1d00ffff
-#define CORE_0_YIELD_COUNT 256
+#define SELFTEST_NONCE_LEAD 3       // Nonces a pipelined kernel runs before the golden one
 
 // ============================================================
 // Globals
@@ -52,7 +53,7 @@ static SemaphoreHandle_t s_jobMutex = NULL;
 // Extra nonce
 static char s_extraNonce1[32] = {0};
 static int s_extraNonce2Size = 4;
-static unsigned long s_extraNonce2 = 1;
+static uint32_t s_extraNonce2 = 1;
 
 // Targets
 static uint8_t s_blockTarget[32];
@@ -65,207 +66,19 @@ static mining_stats_t s_stats = {0};
 // Nonce ranges for dual-core
 static unsigned long s_startNonce[2] = {0, 0x80000000};
 
-// ============================================================
-// Utility Functions
-// ============================================================
-
-static uint8_t decodeHexChar(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    return 0;
-}
-
-static void hexToBytes(uint8_t *out, const char *in, size_t len) {
-    for (size_t i = 0; i < len; i += 2) {
-        out[i/2] = (decodeHexChar(in[i]) << 4) | decodeHexChar(in[i + 1]);
-    }
-}
-
-static void encodeExtraNonce(char *dest, size_t len, unsigned long en) {
-    static const char *tbl = "0123456789ABCDEF";
-    dest += len * 2;
-    *dest-- = '\0';
-    while (len--) {
-        *dest-- = tbl[en & 0x0f];
-        *dest-- = tbl[(en >> 4) & 0x0f];
-        en >>= 8;
-    }
-}
-
-static void swapBytesInWords(uint8_t *buf, size_t len) {
-    for (size_t i = 0; i < len; i += 4) {
-        uint8_t temp = buf[i];
-        buf[i] = buf[i + 3];
-        buf[i + 3] = temp;
-        temp = buf[i + 1];
-        buf[i + 1] = buf[i + 2];
-        buf[i + 2] = temp;
-    }
-}
+// External nonce scheduler (host worker pool), NULL on the chip
+static miner_job_hook_t s_jobHook = NULL;
 
 // ============================================================
-// Target Functions
+// Difficulty Tracking
 // ============================================================
 
-static void bits_to_target(uint32_t nBits, uint8_t *target) {
-    uint32_t exponent = nBits >> 24;
-    uint32_t mantissa = nBits & 0x007fffff;
-    if (nBits & 0x00800000) {
-        mantissa |= 0x00800000;
-    }
-    memset(target, 0, 32);
-    if (exponent <= 3) {
-        mantissa >>= 8 * (3 - exponent);
-        memcpy(target, &mantissa, 4);
-    } else {
-        int shift = (exponent - 3);
-        uint32_t *target_ptr = (uint32_t *)(target + shift);
-        *target_ptr = mantissa;
-    }
-}
-
-static void divide_256bit_by_double(uint64_t *target, double divisor) {
-    uint64_t result[4] = {0};
-    double remainder = 0.0;
-    
-    // Iterate from MSB (target[3]) to LSB (target[0])
-    for (int i = 3; i >= 0; i--) {
-        // Add carried remainder from upper word (scaled by 2^64)
-        double val = (double)target[i] + remainder * 18446744073709551616.0;
-        
-        double res = val / divisor;
-        
-        // Clamp to prevent overflow (shouldn't happen with diff >= 1)
-        if (res >= 18446744073709551615.0) {
-            result[i] = 0xFFFFFFFFFFFFFFFFULL;
-        } else {
-            result[i] = (uint64_t)res;
-        }
-        
-        remainder = val - ((double)result[i] * divisor);
-    }
-    
-    memcpy(target, result, sizeof(result));
-}
-
-static void adjust_target_for_difficulty(uint8_t *pt, uint8_t *bt, double difficulty) {
-    uint64_t target_parts[4];
-    for (int i = 0; i < 4; i++) {
-        target_parts[i] = ((uint64_t)bt[i * 8 + 0]) |
-                          ((uint64_t)bt[i * 8 + 1] << 8) |
-                          ((uint64_t)bt[i * 8 + 2] << 16) |
-                          ((uint64_t)bt[i * 8 + 3] << 24) |
-                          ((uint64_t)bt[i * 8 + 4] << 32) |
-                          ((uint64_t)bt[i * 8 + 5] << 40) |
-                          ((uint64_t)bt[i * 8 + 6] << 48) |
-                          ((uint64_t)bt[i * 8 + 7] << 56);
-    }
-    divide_256bit_by_double(target_parts, difficulty);
-    for (int i = 0; i < 4; i++) {
-        pt[i * 8 + 0] = target_parts[i] & 0xff;
-        pt[i * 8 + 1] = (target_parts[i] >> 8) & 0xff;
-        pt[i * 8 + 2] = (target_parts[i] >> 16) & 0xff;
-        pt[i * 8 + 3] = (target_parts[i] >> 24) & 0xff;
-        pt[i * 8 + 4] = (target_parts[i] >> 32) & 0xff;
-        pt[i * 8 + 5] = (target_parts[i] >> 40) & 0xff;
-        pt[i * 8 + 6] = (target_parts[i] >> 48) & 0xff;
-        pt[i * 8 + 7] = (target_parts[i] >> 56) & 0xff;
-    }
-}
-
 static void setPoolTarget() {
-    uint8_t maxDifficulty[32];
-    bits_to_target(MAX_DIFFICULTY, maxDifficulty);
-    adjust_target_for_difficulty(s_poolTarget, maxDifficulty, s_poolDifficulty);
-}
-
-// Check if hash meets target (little-endian comparison from high bytes)
-static int check_target(const uint8_t *hash, const uint8_t *target) {
-    for (int i = 31; i >= 0; i--) {
-        if (hash[i] < target[i]) return 1;  // Valid
-        if (hash[i] > target[i]) return 0;  // Invalid
-    }
-    return 1;  // Equal is valid
-}
-
-// ============================================================
-// Merkle Root Calculation
-// ============================================================
-
-static void double_sha256_merkle(uint8_t *dest, uint8_t *buf64) {
-    sha256_hash_t ctx, ctx1;
-    sha256(&ctx, buf64, 64);
-    sha256(&ctx1, ctx.bytes, 32);
-    memcpy(dest, ctx1.bytes, 32);
-}
-
-static void calculateMerkleRoot(uint8_t *root, uint8_t *coinbaseHash, const stratum_job_t *job) {
-    uint8_t merklePair[64];
-    memcpy(merklePair, coinbaseHash, 32);
-
-    for (int i = 0; i < job->merkleBranchCount; i++) {
-        hexToBytes(&merklePair[32], job->merkleBranches[i], 64);
-        // NerdMiner does NOT reverse merkle branches
-
-        double_sha256_merkle(merklePair, merklePair);
-        // NerdMiner does NOT reverse intermediate merkle results
-    }
-    memcpy(root, merklePair, 32);
-}
-
-static void createCoinbaseHash(uint8_t *hash, const stratum_job_t *job) {
-    uint8_t coinbase[512];
-    size_t cbLen = 0;
-
-    // Coinbase1 (now char array)
-    size_t cb1Len = strlen(job->coinBase1);
-    hexToBytes(coinbase, job->coinBase1, cb1Len);
-    cbLen += cb1Len / 2;
-
-    // ExtraNonce1 (from job struct now)
-    size_t en1Len = strlen(job->extraNonce1);
-    hexToBytes(&coinbase[cbLen], job->extraNonce1, en1Len);
-    cbLen += en1Len / 2;
-
-    // ExtraNonce2
-    char en2Hex[17];
-    encodeExtraNonce(en2Hex, s_extraNonce2Size, s_extraNonce2);
-    hexToBytes(&coinbase[cbLen], en2Hex, s_extraNonce2Size * 2);
-    cbLen += s_extraNonce2Size;
-
-    // Coinbase2 (now char array)
-    size_t cb2Len = strlen(job->coinBase2);
-    hexToBytes(&coinbase[cbLen], job->coinBase2, cb2Len);
-    cbLen += cb2Len / 2;
-
-    // Double SHA256
-    sha256_hash_t ctx, ctx1;
-    sha256(&ctx, coinbase, cbLen);
-    sha256(&ctx1, ctx.bytes, 32);
-    memcpy(hash, ctx1.bytes, 32);
-    // NerdMiner does NOT reverse coinbase hash
-}
-
-// ============================================================
-// Difficulty Calculation
-// ============================================================
-
-static double getDifficulty(sha256_hash_t *ctx) {
-    static const double maxTarget = 26959535291011309493156476344723991336010898738574164086137773096960.0;
-    double hashValue = 0.0;
-    for (int i = 0, j = 31; i < 32; i++, j--) {
-        hashValue = hashValue * 256 + ctx->bytes[j];
-    }
-    double difficulty = maxTarget / hashValue;
-    if (isnan(difficulty) || isinf(difficulty)) {
-        difficulty = 0.0;
-    }
-    return difficulty;
+    core_difficulty_to_target(s_poolTarget, s_poolDifficulty);
 }
 
 static void compareBestDifficulty(sha256_hash_t *ctx) {
-    double difficulty = getDifficulty(ctx);
+    double difficulty = core_hash_difficulty(ctx);
     if (!isnan(difficulty) && !isinf(difficulty) &&
         (isnan(s_stats.bestDifficulty) || isinf(s_stats.bestDifficulty) ||
          difficulty >= s_stats.bestDifficulty)) {
@@ -277,9 +90,9 @@ static void compareBestDifficulty(sha256_hash_t *ctx) {
 // Share Validation & Submission
 // ============================================================
 
-static void hashCheck(const char *jobId, sha256_hash_t *ctx, uint32_t timestamp, uint32_t nonce) {
+static void hashCheck(const char *jobId, uint32_t extraNonce2, sha256_hash_t *ctx, uint32_t timestamp, uint32_t nonce) {
     // Compare against pool target
-    if (check_target(ctx->bytes, s_poolTarget)) {
+    if (core_check_target(ctx->bytes, s_poolTarget)) {
         uint32_t flags = 0;
 
         // Check for 32-bit difficulty
@@ -290,20 +103,24 @@ static void hashCheck(const char *jobId, sha256_hash_t *ctx, uint32_t timestamp,
         }
 
         // Check against block target (lottery win!)
-        if (check_target(ctx->bytes, s_blockTarget)) {
+        if (core_check_target(ctx->bytes, s_blockTarget)) {
             Serial.println("[MINER] *** BLOCK SOLUTION FOUND! ***");
             flags |= SUBMIT_FLAG_BLOCK;
             s_stats.blocks++;
         }
 
-        double shareDiff = getDifficulty(ctx);
-        Serial.printf("[MINER] Share found! Diff: %.4f (pool: %.4f) Nonce: %08x\n", shareDiff, s_poolDifficulty, nonce);
+        double shareDiff = core_hash_difficulty(ctx);
+        // Print::printf heap-allocates anything past 64 bytes
+        char line[96];
+        snprintf(line, sizeof(line), "[MINER] Share found! Diff: %.4f (pool: %.4f) Nonce: %08x\n",
+                 shareDiff, s_poolDifficulty, nonce);
+        Serial.print(line);
 
         // Submit share
         submit_entry_t submission;
         memset(&submission, 0, sizeof(submission));
         strncpy(submission.jobId, jobId, MAX_JOB_ID_LEN - 1);
-        encodeExtraNonce(submission.extraNonce2, s_extraNonce2Size, s_extraNonce2);
+        core_encode_extranonce(submission.extraNonce2, s_extraNonce2Size, extraNonce2);
         submission.timestamp = timestamp;
         submission.nonce = nonce;
         submission.flags = flags;
@@ -317,6 +134,104 @@ static void hashCheck(const char *jobId, sha256_hash_t *ctx, uint32_t timestamp,
     compareBestDifficulty(ctx);
 }
 
+// ============================================================
+// Boot Self-Test (golden vectors through every engine)
+// ============================================================
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#include <sha/sha_dma.h>  // For esp_sha_acquire/release_hardware
+#endif
+
+static volatile bool s_selfTestRun = true;
+
+static void swapHeaderWords(uint32_t *swapped, const block_header_t *hb) {
+    const uint32_t *words = (const uint32_t *)hb;
+    for (int i = 0; i < 20; i++) {
+        swapped[i] = __builtin_bswap32(words[i]);
+    }
+}
+
+// LL hardware: midstate + tail on the SHA peripheral (Core 1 on C3/S2)
+static bool engineHardwareLL(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t swapped[20];
+    uint32_t midstate[8];
+    swapHeaderWords(swapped, hb);
+
+    sha256_ll_acquire();
+    sha256_ll_midstate(midstate, (const uint8_t *)swapped);
+    bool passed = sha256_ll_double_hash(midstate, (const uint8_t *)&swapped[16], hb->nonce, out->bytes);
+    sha256_ll_release();
+    return passed;
+}
+
+#if defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3)
+// Pipelined kernels only flag candidate nonces. Start a few nonces early and
+// require the golden nonce to be flagged; the hash itself comes from the
+// software path, exactly as the Core 1 task verifies candidates.
+// A header that fails the 16-bit check runs on to a random candidate and
+// counts as an early reject.
+static bool enginePipelined(const block_header_t *hb, sha256_hash_t *out) {
+    uint32_t swapped[20];
+    swapHeaderWords(swapped, hb);
+
+    uint32_t golden = __builtin_bswap32(hb->nonce);
+    uint32_t nonceSwapped = golden - SELFTEST_NONCE_LEAD;
+    volatile uint64_t hashes = 0;
+    bool candidate;
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+    DPORT_REG_SET_BIT(DPORT_PERI_CLK_EN_REG, DPORT_PERI_EN_SHA);
+    DPORT_REG_CLR_BIT(DPORT_PERI_RST_EN_REG, DPORT_PERI_EN_SHA | DPORT_PERI_EN_SECUREBOOT);
+    do {
+        candidate = sha256_pipelined_mine_v2((volatile uint32_t *)0x3FF03000, swapped,
+                                             &nonceSwapped, &hashes, &s_selfTestRun);
+    } while (candidate && nonceSwapped - 1 != golden && hashes <= SELFTEST_NONCE_LEAD);
+#else
+    uint32_t midstate[8];
+    uint32_t block2[3] = {swapped[16], swapped[17], swapped[18]};
+    esp_sha_acquire_hardware();
+    sha256_s3_compute_midstate(swapped, midstate);
+    sha256_s3_init_zeros();
+    do {
+        candidate = sha256_pipelined_mine_s3_v3(midstate, block2, &nonceSwapped, &hashes, &s_selfTestRun);
+    } while (candidate && nonceSwapped - 1 != golden && hashes <= SELFTEST_NONCE_LEAD);
+    esp_sha_release_hardware();
+#endif
+
+    if (!candidate || nonceSwapped - 1 != golden) return false;
+    return core_engine_midstate(hb, out);
+}
+#endif
+
+static bool reportSelfTest(const char *engine, core_vectors_result_t res) {
+    if (res.failed == 0) {
+        Serial.printf("[MINER] Self-test %-18s %u/%u OK\n", engine, res.run, res.run);
+        return true;
+    }
+    Serial.printf("[MINER] ERROR: Self-test %s failed %u/%u (first: %s)\n",
+                  engine, res.failed, res.run, res.firstFailure);
+    return false;
+}
+
+static bool runSelfTest() {
+    uint32_t start = millis();
+    bool ok = true;
+
+    ok &= reportSelfTest("software", core_vectors_check_engine(core_engine_midstate));
+    ok &= reportSelfTest("job pipeline", core_vectors_check_jobs(core_engine_midstate));
+    ok &= reportSelfTest("hardware LL", core_vectors_check_engine(engineHardwareLL));
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    sha256_pipelined_s3_init();
+#endif
+#if defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3)
+    ok &= reportSelfTest("pipelined", core_vectors_check_engine(enginePipelined));
+#endif
+
+    Serial.printf("[MINER] Self-test %s in %lu ms\n", ok ? "passed" : "FAILED",
+                  (unsigned long)(millis() - start));
+    return ok;
+}
+
 // ============================================================
 // Public API
 // ============================================================
@@ -330,6 +245,9 @@ void miner_init() {
     
     // Run DMA-based SHA test at startup
     sha256_s3_dma_test();
+
+    // Golden vectors through every engine this target mines with
+    runSelfTest();
     
     Serial.println("[MINER] Initialized (Hardware SHA-256 via direct register access)");
 }
@@ -348,26 +266,18 @@ void miner_start_job(const stratum_job_t *job) {
     // Random ExtraNonce2
     s_extraNonce2 = esp_random();
 
-    // Build block header (using char arrays now - no heap allocation)
-    s_pendingBlock.version = strtoul(job->version, NULL, 16);
-    hexToBytes(s_pendingBlock.prev_hash, job->prevHash, 64);
-    swapBytesInWords(s_pendingBlock.prev_hash, 32); // Swap bytes within each 4-byte word (NerdMiner does this)
-
-    // Create coinbase hash and merkle root
-    uint8_t coinbaseHash[32];
-    createCoinbaseHash(coinbaseHash, job);
-
-    calculateMerkleRoot(s_pendingBlock.merkle_root, coinbaseHash, job);
-
-    s_pendingBlock.timestamp = strtoul(job->ntime, NULL, 16);
-    s_pendingBlock.difficulty = strtoul(job->nbits, NULL, 16);
-    s_pendingBlock.nonce = 0;
+    // Build block header: coinbase, merkle root, prevhash word swap (no heap allocation)
+    if (!core_build_header(&s_pendingBlock, job, s_extraNonce2, s_extraNonce2Size)) {
+        xSemaphoreGive(s_jobMutex);
+        Serial.printf("[MINER] ERROR: Job %s rejected (malformed coinbase or prevhash)\n", job->jobId);
+        return;
+    }
 
     strncpy(s_currentJobId, job->jobId, MAX_JOB_ID_LEN - 1);
 
     // Debug: print header bytes
     char en2Hex[17];
-    encodeExtraNonce(en2Hex, s_extraNonce2Size, s_extraNonce2);
+    core_encode_extranonce(en2Hex, s_extraNonce2Size, s_extraNonce2);
     Serial.printf("[MINER] New job: %s, diff=%08x\n", s_currentJobId, s_pendingBlock.difficulty);
     Serial.printf("[MINER] en2=%s, ntime=%s, version=%s\n", en2Hex, job->ntime, job->version);
     Serial.printf("[MINER] Header bytes 0-7: %02x%02x%02x%02x %02x%02x%02x%02x\n",
@@ -377,7 +287,7 @@ void miner_start_job(const stratum_job_t *job) {
         ((uint8_t*)&s_pendingBlock)[6], ((uint8_t*)&s_pendingBlock)[7]);
 
     // Set block target
-    bits_to_target(s_pendingBlock.difficulty, s_blockTarget);
+    core_bits_to_target(s_pendingBlock.difficulty, s_blockTarget);
     setPoolTarget();
 
     // Random nonce start points for each core
@@ -388,6 +298,8 @@ void miner_start_job(const stratum_job_t *job) {
 
     xSemaphoreGive(s_jobMutex);
 
+    if (s_jobHook) s_jobHook(job, s_extraNonce2, s_extraNonce2Size);
+
     s_miningActive = true;
 }
 
@@ -416,6 +328,15 @@ void miner_set_extranonce(const char *extraNonce1, int extraNonce2Size) {
     s_extraNonce2Size = extraNonce2Size > 8 ? 8 : extraNonce2Size;
 }
 
+void miner_set_job_hook(miner_job_hook_t hook) {
+    s_jobHook = hook;
+}
+
+void miner_check_hash(const char *jobId, uint32_t extraNonce2, sha256_hash_t *hash,
+                      uint32_t timestamp, uint32_t nonce) {
+    hashCheck(jobId, extraNonce2, hash, timestamp, nonce);
+}
+
 // ============================================================
 // Mining Task - Core 0 (BitsyMiner Software SHA-256 with Midstate)
 // ============================================================
@@ -462,15 +383,16 @@ void miner_task_core0(void *param) {
             // Early 16-bit reject is built into miner_sha256_header()
             if (miner_sha256_header(&midstate, &ctx, &hb)) {
                 // 16-bit check passed - potential share
-                hashCheck(jobId, &ctx, hb.timestamp, hb.nonce);
+                hashCheck(jobId, s_extraNonce2, &ctx, hb.timestamp, hb.nonce);
             }
 
             hb.nonce++;
             s_stats.hashes++;
+            s_stats.hashesCore0++;
             yieldCounter++;
 
-            // Yield every 256 hashes to let monitor/WiFi tasks run
-            if (yieldCounter >= CORE_0_YIELD_COUNT) {
+            // Yield every MINER_0_YIELD_COUNT hashes to let monitor/WiFi tasks run
+            if (yieldCounter >= MINER_0_YIELD_COUNT) {
                 yieldCounter = 0;
                 vTaskDelay(1);  // Must use vTaskDelay(1), not taskYIELD()
             }
@@ -603,7 +525,7 @@ void miner_task_core1(void *param) {
                 hbVerify.nonce = candidate_nonce_native;
                 if (miner_sha256_header(&midstate, &ctx, &hbVerify)) {
                     // SOFTWARE verified share - submit it
-                    hashCheck(jobId, &ctx, hbVerify.timestamp, candidate_nonce_native);
+                    hashCheck(jobId, s_extraNonce2, &ctx, hbVerify.timestamp, candidate_nonce_native);
                 }
 
                 // Re-init pipelined SHA hardware
@@ -743,7 +665,7 @@ void miner_task_core1(void *param) {
                 // BitsyMiner CRITICAL: Verify with SOFTWARE SHA on UNSWAPPED header
                 hbVerify.nonce = candidate_nonce_native;
                 if (miner_sha256_header(&sw_midstate, &ctx, &hbVerify)) {
-                    hashCheck(jobId, &ctx, hbVerify.timestamp, candidate_nonce_native);
+                    hashCheck(jobId, s_extraNonce2, &ctx, hbVerify.timestamp, candidate_nonce_native);
                 }
             }
 
@@ -822,7 +744,7 @@ void miner_task_core1(void *param) {
             // Uses pre-computed midstate and only hashes the tail (last 16 bytes + padding)
             // header_bytes[64] is the start of the 2nd chunk (tail)
             if (sha256_ll_double_hash(midstate, &header_bytes[64], hb.nonce, ctx.bytes)) {
-                hashCheck(jobId, &ctx, hb.timestamp, hb.nonce);
+                hashCheck(jobId, s_extraNonce2, &ctx, hb.timestamp, hb.nonce);
             }
 
             hb.nonce++;
@@ -72,4 +72,22 @@ void miner_set_difficulty(double poolDifficulty);
  */
 void miner_set_extranonce(const char *extraNonce1, int extraNonce2Size);
 
+/**
+ * Called by miner_start_job() with each accepted job and its starting
+ * extranonce2, for schedulers that run their own miner threads
+ */
+typedef void (*miner_job_hook_t)(const stratum_job_t *job, uint32_t extraNonce2, int extraNonce2Size);
+
+/**
+ * Hand new jobs to an external nonce scheduler (host worker pool)
+ */
+void miner_set_job_hook(miner_job_hook_t hook);
+
+/**
+ * Check a hash that passed the 16-bit early reject; submits it if it
+ * meets the pool target. For schedulers that roll extranonce2 themselves.
+ */
+void miner_check_hash(const char *jobId, uint32_t extraNonce2, sha256_hash_t *hash,
+                      uint32_t timestamp, uint32_t nonce);
+
 #endif // MINER_H
@@ -7,7 +7,6 @@
  * the Free Software Foundation, either version 3 of the License, or
  * (at your option) any later version.
  */
-#include <Arduino.h>
 #include <string.h>
 #include "miner_sha256.h"
 
@@ -39,17 +38,17 @@
 #define GET_DATA(v,i) (((uint32_t)(v[i]) << 24) | ((uint32_t)(v[i + 1]) << 16) | ((uint32_t)(v[i + 2]) << 8) | ((uint32_t)(v[i + 3])))
 
 // SHA-256 initial hash values
-static WORD h0 = 0x6a09e667;
-static WORD h1 = 0xbb67ae85;
-static WORD h2 = 0x3c6ef372;
-static WORD h3 = 0xa54ff53a;
-static WORD h4 = 0x510e527f;
-static WORD h5 = 0x9b05688c;
-static WORD h6 = 0x1f83d9ab;
-static WORD h7 = 0x5be0cd19;
-
-// SHA-256 round constants
-static uint32_t k[] = {
+static const WORD h0 = 0x6a09e667;
+static const WORD h1 = 0xbb67ae85;
+static const WORD h2 = 0x3c6ef372;
+static const WORD h3 = 0xa54ff53a;
+static const WORD h4 = 0x510e527f;
+static const WORD h5 = 0x9b05688c;
+static const WORD h6 = 0x1f83d9ab;
+static const WORD h7 = 0x5be0cd19;
+
+// SHA-256 round constants (DRAM: read every round, never from flash cache)
+static const uint32_t DRAM_ATTR k[64] = {
    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
@@ -268,7 +267,7 @@ void miner_sha256_midstate(sha256_hash_t *ctx, block_header_t *hb) {
     ctx->hash[7] += h;
 }
 
-bool miner_sha256_header(sha256_hash_t *midpoint, sha256_hash_t *ctx, block_header_t *hb) {
+bool MINING_KERNEL_ATTR miner_sha256_header(sha256_hash_t *midpoint, sha256_hash_t *ctx, block_header_t *hb) {
     sha256_hash_t tmp;
     WORD temp1, temp2;
     uint8_t *data = (uint8_t *)hb;
@@ -0,0 +1,217 @@
+/*
+ * SparkMiner - Portable Mining Core Implementation
+ * Block header construction, target and difficulty math
+ *
+ * Based on BitsyMiner by Justin Williams (GPL v3)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mining_core.h"
+#include "miner_sha256.h"
+
+// ============================================================
+// Hex Helpers
+// ============================================================
+
+static uint8_t decodeHexChar(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 0;
+}
+
+void core_hex_decode(uint8_t *out, const char *in, size_t len) {
+    for (size_t i = 0; i < len; i += 2) {
+        out[i / 2] = (decodeHexChar(in[i]) << 4) | decodeHexChar(in[i + 1]);
+    }
+}
+
+void core_encode_extranonce(char *dest, size_t len, uint32_t extraNonce2) {
+    static const char *tbl = "0123456789ABCDEF";
+    dest += len * 2;
+    *dest-- = '\0';
+    while (len--) {
+        *dest-- = tbl[extraNonce2 & 0x0f];
+        *dest-- = tbl[(extraNonce2 >> 4) & 0x0f];
+        extraNonce2 >>= 8;
+    }
+}
+
+void core_swap_words(uint8_t *buf, size_t len) {
+    for (size_t i = 0; i + 3 < len; i += 4) {
+        uint8_t temp = buf[i];
+        buf[i] = buf[i + 3];
+        buf[i + 3] = temp;
+        temp = buf[i + 1];
+        buf[i + 1] = buf[i + 2];
+        buf[i + 2] = temp;
+    }
+}
+
+// ============================================================
+// Target & Difficulty
+// ============================================================
+
+void core_bits_to_target(uint32_t nBits, uint8_t *target) {
+    uint32_t exponent = nBits >> 24;
+    uint32_t mantissa = nBits & 0x007fffff;
+    if (nBits & 0x00800000) {
+        mantissa |= 0x00800000;
+    }
+    memset(target, 0, 32);
+    if (exponent <= 3) {
+        mantissa >>= 8 * (3 - exponent);
+        for (int i = 0; i < 4; i++) target[i] = (mantissa >> (8 * i)) & 0xff;
+    } else {
+        // Little-endian mantissa at byte (exponent - 3); bytes past 32 are dropped
+        for (uint32_t i = 0; i < 4 && exponent - 3 + i < 32; i++) {
+            target[exponent - 3 + i] = (mantissa >> (8 * i)) & 0xff;
+        }
+    }
+}
+
+static void divide_256bit_by_double(uint64_t *target, double divisor) {
+    uint64_t result[4] = {0};
+    double remainder = 0.0;
+
+    // Iterate from MSB (target[3]) to LSB (target[0])
+    for (int i = 3; i >= 0; i--) {
+        // Add carried remainder from upper word (scaled by 2^64)
+        double val = (double)target[i] + remainder * 18446744073709551616.0;
+
+        double res = val / divisor;
+
+        // Clamp to prevent overflow (shouldn't happen with diff >= 1)
+        if (res >= 18446744073709551615.0) {
+            result[i] = 0xFFFFFFFFFFFFFFFFULL;
+        } else {
+            result[i] = (uint64_t)res;
+        }
+
+        remainder = val - ((double)result[i] * divisor);
+    }
+
+    memcpy(target, result, sizeof(result));
+}
+
+void core_difficulty_to_target(uint8_t *target, double difficulty) {
+    uint8_t diff1[32];
+    core_bits_to_target(CORE_DIFF1_BITS, diff1);
+
+    uint64_t parts[4];
+    for (int i = 0; i < 4; i++) {
+        parts[i] = 0;
+        for (int b = 7; b >= 0; b--) {
+            parts[i] = (parts[i] << 8) | diff1[i * 8 + b];
+        }
+    }
+    divide_256bit_by_double(parts, difficulty);
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 8; b++) {
+            target[i * 8 + b] = (parts[i] >> (8 * b)) & 0xff;
+        }
+    }
+}
+
+// Little-endian comparison from the most significant byte
+bool core_check_target(const uint8_t *hash, const uint8_t *target) {
+    for (int i = 31; i >= 0; i--) {
+        if (hash[i] < target[i]) return true;
+        if (hash[i] > target[i]) return false;
+    }
+    return true;  // Equal is valid
+}
+
+double core_hash_difficulty(const sha256_hash_t *hash) {
+    static const double maxTarget = 26959535291011309493156476344723991336010898738574164086137773096960.0;
+    double hashValue = 0.0;
+    for (int j = 31; j >= 0; j--) {
+        hashValue = hashValue * 256 + hash->bytes[j];
+    }
+    double difficulty = maxTarget / hashValue;
+    if (isnan(difficulty) || isinf(difficulty)) {
+        difficulty = 0.0;
+    }
+    return difficulty;
+}
+
+// ============================================================
+// Block Header
+// ============================================================
+
+void core_sha256d(sha256_hash_t *out, const uint8_t *data, size_t len) {
+    sha256_hash_t first;
+    miner_sha256(&first, (uint8_t *)data, len);
+    miner_sha256(out, first.bytes, 32);
+}
+
+bool core_coinbase_hash(uint8_t *hash, const stratum_job_t *job,
+                        uint32_t extraNonce2, int extraNonce2Size) {
+    uint8_t coinbase[CORE_COINBASE_MAX];
+    size_t cb1Len = strlen(job->coinBase1);
+    size_t en1Len = strlen(job->extraNonce1);
+    size_t cb2Len = strlen(job->coinBase2);
+
+    if (extraNonce2Size < 1 || extraNonce2Size > CORE_EXTRANONCE2_MAX) return false;
+    if ((cb1Len | en1Len | cb2Len) & 1) return false;
+    if ((cb1Len + en1Len + cb2Len) / 2 + extraNonce2Size > sizeof(coinbase)) return false;
+
+    size_t cbLen = 0;
+    core_hex_decode(coinbase, job->coinBase1, cb1Len);
+    cbLen += cb1Len / 2;
+
+    core_hex_decode(&coinbase[cbLen], job->extraNonce1, en1Len);
+    cbLen += en1Len / 2;
+
+    char en2Hex[CORE_EXTRANONCE2_MAX * 2 + 1];
+    core_encode_extranonce(en2Hex, extraNonce2Size, extraNonce2);
+    core_hex_decode(&coinbase[cbLen], en2Hex, extraNonce2Size * 2);
+    cbLen += extraNonce2Size;
+
+    core_hex_decode(&coinbase[cbLen], job->coinBase2, cb2Len);
+    cbLen += cb2Len / 2;
+
+    // NerdMiner does NOT reverse the coinbase hash
+    sha256_hash_t ctx;
+    core_sha256d(&ctx, coinbase, cbLen);
+    memcpy(hash, ctx.bytes, 32);
+    return true;
+}
+
+void core_merkle_root(uint8_t *root, const uint8_t *coinbaseHash, const stratum_job_t *job) {
+    uint8_t merklePair[64];
+    sha256_hash_t ctx;
+    memcpy(merklePair, coinbaseHash, 32);
+
+    // Branches and intermediate results are used as sent (no reversal)
+    for (int i = 0; i < job->merkleBranchCount && i < STRATUM_MAX_MERKLE; i++) {
+        core_hex_decode(&merklePair[32], job->merkleBranches[i], 64);
+        core_sha256d(&ctx, merklePair, 64);
+        memcpy(merklePair, ctx.bytes, 32);
+    }
+    memcpy(root, merklePair, 32);
+}
+
+bool core_build_header(block_header_t *hb, const stratum_job_t *job,
+                       uint32_t extraNonce2, int extraNonce2Size) {
+    if (strlen(job->prevHash) != 64) return false;
+
+    uint8_t coinbaseHash[32];
+    if (!core_coinbase_hash(coinbaseHash, job, extraNonce2, extraNonce2Size)) return false;
+
+    memset(hb, 0, sizeof(*hb));
+    hb->version = strtoul(job->version, NULL, 16);
+
+    // Stratum sends prevhash as 8 big-endian words
+    core_hex_decode(hb->prev_hash, job->prevHash, 64);
+    core_swap_words(hb->prev_hash, 32);
+
+    core_merkle_root(hb->merkle_root, coinbaseHash, job);
+
+    hb->timestamp = strtoul(job->ntime, NULL, 16);
+    hb->difficulty = strtoul(job->nbits, NULL, 16);
+    hb->nonce = 0;
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+ * SparkMiner - Portable Mining Core
+ * Block header construction, target and difficulty math
+ *
+ * Everything here is pure computation over stratum jobs and hashes: no
+ * FreeRTOS, no Arduino, no peripherals. Hashing uses the software SHA-256
+ * in miner_sha256.cpp. The firmware miner and the host tools (PlatformIO
+ * native environments) share this code unchanged.
+ *
+ * Based on BitsyMiner by Justin Williams (GPL v3)
+ */
+
+#ifndef MINING_CORE_H
+#define MINING_CORE_H
+
+#include "core_platform.h"
+#include "sha256_types.h"
+#include "../stratum/stratum_types.h"
+
+// nBits of difficulty 1 (pool difficulty is relative to this target)
+#define CORE_DIFF1_BITS         0x1d00ffff
+
+// Largest extraNonce2 the header builder accepts (bytes)
+#define CORE_EXTRANONCE2_MAX    8
+
+// Coinbase transaction buffer (coinbase1 + extraNonce1/2 + coinbase2, bytes)
+#define CORE_COINBASE_MAX       512
+
+// ============================================================
+// Hex Helpers
+// ============================================================
+
+/**
+ * Decode a hex string into bytes
+ * Invalid digits decode as 0 (pool data is trusted to be hex)
+ * @param out Output buffer, at least len / 2 bytes
+ * @param in Hex characters (upper or lower case)
+ * @param len Number of hex characters to decode (even)
+ */
+void core_hex_decode(uint8_t *out, const char *in, size_t len);
+
+/**
+ * Encode extraNonce2 as big-endian, upper-case hex (stratum submit format)
+ * @param dest Output, at least len * 2 + 1 chars
+ * @param len extraNonce2 size in bytes
+ */
+void core_encode_extranonce(char *dest, size_t len, uint32_t extraNonce2);
+
+/**
+ * Reverse the byte order inside each 32-bit word
+ * @param len Buffer length in bytes (multiple of 4)
+ */
+void core_swap_words(uint8_t *buf, size_t len);
+
+// ============================================================
+// Target & Difficulty
+// ============================================================
+
+/**
+ * Expand compact nBits into a 256-bit little-endian target
+ * @param target Output, 32 bytes
+ */
+void core_bits_to_target(uint32_t nBits, uint8_t *target);
+
+/**
+ * Compute the share target for a pool difficulty
+ * target = diff1 target / difficulty
+ * @param target Output, 32 bytes little-endian
+ * @param difficulty Pool difficulty (> 0)
+ */
+void core_difficulty_to_target(uint8_t *target, double difficulty);
+
+/**
+ * Check a hash against a target (both 32 bytes little-endian)
+ * @return true if hash <= target
+ */
+bool core_check_target(const uint8_t *hash, const uint8_t *target);
+
+/**
+ * Difficulty of a hash relative to the diff1 target
+ * @return Difficulty, or 0.0 for an all-zero hash
+ */
+double core_hash_difficulty(const sha256_hash_t *hash);
+
+// ============================================================
+// Block Header
+// ============================================================
+
+/**
+ * Double SHA-256 of an arbitrary buffer
+ */
+void core_sha256d(sha256_hash_t *out, const uint8_t *data, size_t len);
+
+/**
+ * Build and hash the coinbase transaction
+ * coinbase1 + extraNonce1 + extraNonce2 + coinbase2
+ * @param hash Output, 32 bytes
+ * @return false if the job's coinbase does not fit CORE_COINBASE_MAX
+ */
+bool core_coinbase_hash(uint8_t *hash, const stratum_job_t *job,
+                        uint32_t extraNonce2, int extraNonce2Size);
+
+/**
+ * Fold the job's merkle branches onto the coinbase hash
+ * @param root Output, 32 bytes (may alias coinbaseHash)
+ */
+void core_merkle_root(uint8_t *root, const uint8_t *coinbaseHash, const stratum_job_t *job);
+
+/**
+ * Build the 80-byte block header for a job (nonce = 0)
+ * @param hb Output header
+ * @param job Stratum job from mining.notify
+ * @param extraNonce2 ExtraNonce2 value rolled into the coinbase
+ * @param extraNonce2Size ExtraNonce2 size from mining.subscribe (1-8)
+ * @return false if the job is malformed
+ */
+bool core_build_header(block_header_t *hb, const stratum_job_t *job,
+                       uint32_t extraNonce2, int extraNonce2Size);
+
+#endif // MINING_CORE_H
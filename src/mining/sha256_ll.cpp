@@ -85,9 +85,14 @@ void IRAM_ATTR sha256_ll_wait_idle(void) {
 #if defined(CONFIG_IDF_TARGET_ESP32)
 // Standard ESP32 implementation
 
+// First header block of the last sha256_ll_midstate() call. The ESP32
+// engine's internal state cannot be written (LOAD only copies it out to
+// SHA_TEXT), so every double hash starts over from this block.
+static uint32_t s_firstBlock[16];
+
 static inline void IRAM_ATTR ll_fill_text_block(const uint8_t *data) {
     uint32_t *data_words = (uint32_t *)data;
-    uint32_t *reg = (uint32_t *)(SHA_TEXT_BASE);
+    volatile uint32_t *reg = (volatile uint32_t *)(SHA_TEXT_BASE);
 
     reg[0]  = data_words[0];
     reg[1]  = data_words[1];
@@ -109,7 +114,7 @@ static inline void IRAM_ATTR ll_fill_text_block(const uint8_t *data) {
 
 static inline void IRAM_ATTR ll_fill_second_block(const uint8_t *tail, uint32_t nonce) {
     uint32_t *data_words = (uint32_t *)tail;
-    uint32_t *reg = (uint32_t *)(SHA_TEXT_BASE);
+    volatile uint32_t *reg = (volatile uint32_t *)(SHA_TEXT_BASE);
 
     // First 12 bytes from tail (timestamp, nbits, nonce high bits)
     reg[0]  = data_words[0];
@@ -135,7 +140,7 @@ static inline void IRAM_ATTR ll_fill_second_block(const uint8_t *tail, uint32_t
 static inline void IRAM_ATTR ll_fill_double_block(void) {
     // Prepare for second SHA (hash of first hash)
     // First 8 words already contain hash output, just add padding
-    uint32_t *reg = (uint32_t *)(SHA_TEXT_BASE);
+    volatile uint32_t *reg = (volatile uint32_t *)(SHA_TEXT_BASE);
 
     reg[8]  = 0x80000000;
     reg[9]  = 0x00000000;
@@ -297,6 +302,7 @@ void IRAM_ATTR sha256_ll_midstate(uint32_t *midstate, const uint8_t *header) {
     // We use the HAL function for this since it's a one-time operation per job
 
 #if defined(CONFIG_IDF_TARGET_ESP32)
+    memcpy(s_firstBlock, header, sizeof(s_firstBlock));
     ll_fill_text_block(header);
     sha_ll_start_block(SHA2_256);
     sha256_ll_wait_idle();
@@ -367,6 +373,7 @@ bool IRAM_ATTR sha256_ll_double_hash_full(const uint8_t *header, uint32_t nonce,
     sha_ll_start_block(SHA2_256);
     sha256_ll_wait_idle();
     sha_ll_load(SHA2_256);
+    sha256_ll_wait_idle();
 
     return ll_read_digest_if(hash_out);
 #else
@@ -379,19 +386,11 @@ bool IRAM_ATTR sha256_ll_double_hash(const uint32_t *midstate, const uint8_t *ta
                                       uint32_t nonce, uint8_t *hash_out) {
 #if defined(CONFIG_IDF_TARGET_ESP32)
     // === First SHA-256: Complete header hash ===
-    // 1. Restore midstate (hash of first 64 bytes) into SHA hardware
-    // On ESP32, we write the state to the text buffer and use sha_ll_load()
-    uint32_t *reg = (uint32_t *)(SHA_TEXT_BASE);
-    reg[0] = midstate[0];
-    reg[1] = midstate[1];
-    reg[2] = midstate[2];
-    reg[3] = midstate[3];
-    reg[4] = midstate[4];
-    reg[5] = midstate[5];
-    reg[6] = midstate[6];
-    reg[7] = midstate[7];
-
-    sha_ll_load(SHA2_256);
+    // 1. Re-hash the first block: the midstate cannot be written back
+    // into the engine, whatever ran on it since
+    (void)midstate;
+    ll_fill_text_block((const uint8_t *)s_firstBlock);
+    sha_ll_start_block(SHA2_256);
     sha256_ll_wait_idle();
 
     // 2. Process second block (tail + nonce + padding)
@@ -406,6 +405,7 @@ bool IRAM_ATTR sha256_ll_double_hash(const uint32_t *midstate, const uint8_t *ta
     sha_ll_start_block(SHA2_256);
     sha256_ll_wait_idle();
     sha_ll_load(SHA2_256);
+    sha256_ll_wait_idle();
 
     return ll_read_digest_if(hash_out);
 
@@ -58,6 +58,10 @@ void IRAM_ATTR sha256_ll_midstate(uint32_t *midstate, const uint8_t *header);
  * Perform double SHA-256 from midstate with early 16-bit reject.
  * This is the hot path - called once per nonce.
  *
+ * On ESP32 the engine state cannot be written, so the first block kept
+ * by the last sha256_ll_midstate() call is hashed again instead of
+ * restoring midstate: mine one header at a time.
+ *
  * @param midstate   Input: Pre-computed midstate from sha256_ll_midstate()
  * @param tail       Input: Last 16 bytes of block header (before nonce)
  * @param nonce      Input: 32-bit nonce to try
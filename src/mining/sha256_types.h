@@ -10,7 +10,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
-#include <Arduino.h>
+#include "core_platform.h"
 
 // SHA-256 hash result (256 bits = 32 bytes = 8 x 32-bit words)
 typedef union {
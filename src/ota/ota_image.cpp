@@ -0,0 +1,450 @@
+/*
+ * SparkMiner - OTA Image Fetch
+ * HTTP GET, manifest parsing and the streaming verifier (see ota_image.h)
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <fixed_string.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/pk.h>
+#include "ota_image.h"
+#include "../stats/alloc_guard.h"
+
+// ============================================================
+// Buffers
+// ============================================================
+
+// Only the OTA task (or the host tool) fetches, one transfer at a time
+static uint8_t s_block[OTA_BLOCK_SIZE];
+static char s_line[256];
+
+typedef struct {
+    FixedString<63> host;
+    uint16_t port;
+    FixedString<OTA_URL_MAX> path;
+} http_url_t;
+
+// ============================================================
+// HTTP
+// ============================================================
+
+// http://host[:port][/path]
+static bool parseUrl(const char *url, http_url_t *out) {
+    StringView spec(url);
+    if (!spec.startsWith("http://")) {
+        Serial.printf("[OTA] Only http:// URLs are supported: %s\n", url);
+        return false;
+    }
+    StringView rest = spec.substr(7);
+    size_t slash = rest.find('/');
+    StringView hostPort = rest.substr(0, slash);
+    size_t colon = hostPort.find(':');
+
+    out->host = hostPort.substr(0, colon);
+    out->port = colon == StringView::npos ? 80 : atoi(hostPort.data() + colon + 1);
+    out->path = slash == StringView::npos ? StringView("/") : rest.substr(slash);
+
+    if (out->host.empty() || out->port == 0 || out->host.truncated() || out->path.truncated()) {
+        Serial.printf("[OTA] Bad URL: %s\n", url);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read one header line into s_line (without CR/LF, truncated to fit)
+ * @return its length, or -1 on timeout or close
+ */
+static int readLine(WiFiClient &client) {
+    size_t len = 0;
+    uint32_t start = millis();
+
+    while (true) {
+        int c = client.read();
+        if (c < 0) {
+            if (!client.connected() || millis() - start > OTA_TIMEOUT_MS) return -1;
+            delay(1);
+            continue;
+        }
+        if (c == '\n') break;
+        if (c != '\r' && len < sizeof(s_line) - 1) s_line[len++] = (char)c;
+    }
+    s_line[len] = '\0';
+    return (int)len;
+}
+
+/**
+ * Send a GET and read the response head
+ * @param contentLength Set to the Content-Length, or -1 if none was sent
+ * @return true on a 200 with a body the caller can read as-is
+ */
+static bool httpGet(WiFiClient &client, const char *url, int32_t *contentLength) {
+    http_url_t target;
+    if (!parseUrl(url, &target)) return false;
+
+    // The socket and its receive buffer are the SDK's allocations
+    alloc_guard_exempt_begin();
+    bool connected = client.connect(target.host.c_str(), target.port, OTA_TIMEOUT_MS);
+    alloc_guard_exempt_end();
+    if (!connected) {
+        Serial.printf("[OTA] Cannot connect to %s:%u\n", target.host.c_str(), target.port);
+        return false;
+    }
+
+    FixedString<OTA_URL_MAX + 128> request;
+    request.printf("GET %s HTTP/1.1\r\nHost: %s\r\n"
+                   "User-Agent: SparkMiner/" AUTO_VERSION "\r\n"
+                   "Connection: close\r\n\r\n",
+                   target.path.c_str(), target.host.c_str());
+    client.write((const uint8_t *)request.c_str(), request.length());
+
+    int status = 0;
+    if (readLine(client) > 0 && strncmp(s_line, "HTTP/", 5) == 0) {
+        const char *space = strchr(s_line, ' ');
+        if (space) status = atoi(space + 1);
+    }
+    if (status != 200) {
+        Serial.printf("[OTA] HTTP %d for %s\n", status, url);
+        return false;
+    }
+
+    *contentLength = -1;
+    bool chunked = false;
+    while (readLine(client) > 0) {
+        if (strncasecmp(s_line, "Content-Length:", 15) == 0) {
+            *contentLength = atol(s_line + 15);
+        } else if (strncasecmp(s_line, "Transfer-Encoding:", 18) == 0 && strstr(s_line, "chunked")) {
+            chunked = true;
+        }
+    }
+    if (chunked) {
+        // Static file servers send a length; keeping to that keeps the reader simple
+        Serial.println("[OTA] Chunked responses are not supported");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read up to `len` body bytes that have arrived
+ * @return bytes read, 0 if none yet, -1 once the connection is closed or idle too long
+ */
+static int readBody(WiFiClient &client, uint8_t *buf, size_t len, uint32_t *lastData) {
+    int avail = client.available();
+    if (avail <= 0) {
+        if (!client.connected()) return -1;
+        if (millis() - *lastData > OTA_TIMEOUT_MS) {
+            Serial.println("[OTA] Transfer stalled");
+            return -1;
+        }
+        delay(1);
+        return 0;
+    }
+    if ((size_t)avail < len) len = avail;
+    int n = client.read(buf, len);
+    if (n > 0) *lastData = millis();
+    return n > 0 ? n : 0;
+}
+
+// ============================================================
+// Manifest
+// ============================================================
+
+static int hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Decode hex into out; returns the byte count, or -1 if malformed or too long
+static int decodeHex(const char *hex, uint8_t *out, size_t outMax) {
+    if (!hex) return -1;
+    size_t len = strlen(hex);
+    if (len % 2 || len / 2 > outMax) return -1;
+    for (size_t i = 0; i < len / 2; i++) {
+        int hi = hexNibble(hex[2 * i]);
+        int lo = hexNibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return (int)(len / 2);
+}
+
+// Image URL: absolute as given, or relative to the manifest's directory
+static bool resolveUrl(const char *manifestUrl, const char *imageUrl, char *out, size_t size) {
+    FixedString<OTA_URL_MAX> url;
+    if (StringView(imageUrl).startsWith("http://")) {
+        url = imageUrl;
+    } else {
+        const char *dirEnd = strrchr(manifestUrl + 7, '/');
+        url = dirEnd ? StringView(manifestUrl, dirEnd - manifestUrl + 1) : StringView(manifestUrl);
+        if (!dirEnd) url += '/';
+        url += imageUrl;
+    }
+    if (url.truncated() || url.length() >= size) return false;
+    memcpy(out, url.c_str(), url.length() + 1);
+    return true;
+}
+
+// Version and board go into the signed statement one per line: keep them to safe characters
+static bool isToken(const char *s) {
+    if (!s || !s[0] || strlen(s) > OTA_VERSION_MAX) return false;
+    for (; *s; s++) {
+        if (!isalnum((unsigned char)*s) && !strchr(".-_+", *s)) return false;
+    }
+    return true;
+}
+
+static bool verifySignature(const uint8_t digest[32], const uint8_t *sig, size_t sigLen,
+                            const char *publicKeyPem) {
+    // mbedTLS keeps the key and its bignums on the heap
+    alloc_guard_exempt_begin();
+    mbedtls_pk_context pk;
+    mbedtls_pk_init(&pk);
+
+    // PEM keys are parsed including their NUL
+    int ret = mbedtls_pk_parse_public_key(&pk, (const unsigned char *)publicKeyPem, strlen(publicKeyPem) + 1);
+    if (ret == 0) {
+        ret = mbedtls_pk_verify(&pk, MBEDTLS_MD_SHA256, digest, 32, sig, sigLen);
+        if (ret != 0) Serial.printf("[OTA] Manifest signature check failed (-0x%04x)\n", -ret);
+    } else {
+        Serial.printf("[OTA] Bad public key (-0x%04x)\n", -ret);
+    }
+
+    mbedtls_pk_free(&pk);
+    alloc_guard_exempt_end();
+    return ret == 0;
+}
+
+// The statement "sig" covers (see ota_image.h)
+static bool verifyManifest(const ota_manifest_t *m, const char *publicKeyPem) {
+    FixedString<32 + 2 * OTA_VERSION_MAX + 10 + 64> statement;
+    statement.printf("sparkminer-ota-1\n%s\n%s\n%lu\n", m->version, m->board, (unsigned long)m->size);
+    for (size_t i = 0; i < sizeof(m->sha256); i++) statement.appendf("%02x", m->sha256[i]);
+    statement.append('\n');
+    if (statement.truncated()) return false;
+
+    uint8_t digest[32];
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts_ret(&sha, 0);
+    mbedtls_sha256_update_ret(&sha, (const uint8_t *)statement.c_str(), statement.length());
+    mbedtls_sha256_finish_ret(&sha, digest);
+    mbedtls_sha256_free(&sha);
+
+    return verifySignature(digest, m->sig, m->sigLen, publicKeyPem);
+}
+
+bool ota_fetch_manifest(const char *url, const char *publicKeyPem, ota_manifest_t *out) {
+    WiFiClient client;
+    int32_t contentLength;
+    if (!httpGet(client, url, &contentLength)) {
+        client.stop();
+        return false;
+    }
+
+    // The manifest is small; read it into the block buffer
+    static_assert(OTA_MANIFEST_MAX <= OTA_BLOCK_SIZE, "manifest is read into s_block");
+    size_t len = 0;
+    uint32_t lastData = millis();
+    while (len < OTA_MANIFEST_MAX && (contentLength < 0 || len < (size_t)contentLength)) {
+        int n = readBody(client, s_block + len, OTA_MANIFEST_MAX - len, &lastData);
+        if (n < 0) break;
+        len += n;
+    }
+    client.stop();
+    if (contentLength > OTA_MANIFEST_MAX || (contentLength >= 0 && len != (size_t)contentLength)) {
+        Serial.printf("[OTA] Manifest truncated (%u bytes)\n", (unsigned)len);
+        return false;
+    }
+
+    StaticJsonDocument<768> doc;
+    DeserializationError err = deserializeJson(doc, (const char *)s_block, len);
+    if (err) {
+        Serial.printf("[OTA] Manifest parse error: %s\n", err.c_str());
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    const char *version = doc["version"];
+    const char *board = doc["board"];
+    const char *image = doc["url"];
+    out->size = doc["size"].as<uint32_t>();
+    int sigLen = decodeHex(doc["sig"], out->sig, sizeof(out->sig));
+
+    if (!isToken(version) || !isToken(board) || !image || out->size == 0 ||
+        decodeHex(doc["sha256"], out->sha256, sizeof(out->sha256)) != 32 ||
+        sigLen <= 0 || !resolveUrl(url, image, out->url, sizeof(out->url))) {
+        Serial.println("[OTA] Manifest is missing or has bad fields");
+        return false;
+    }
+    strcpy(out->version, version);
+    strcpy(out->board, board);
+    out->sigLen = sigLen;
+
+    // Nothing in the manifest is trusted until this passes
+    return verifyManifest(out, publicKeyPem);
+}
+
+// ============================================================
+// Image
+// ============================================================
+
+bool ota_fetch_image(const ota_manifest_t *manifest, ota_sink_t sink, void *ctx) {
+    WiFiClient client;
+    int32_t contentLength;
+    if (!httpGet(client, manifest->url, &contentLength)) {
+        client.stop();
+        return false;
+    }
+    if (contentLength >= 0 && (uint32_t)contentLength != manifest->size) {
+        Serial.printf("[OTA] Server sends %ld bytes, manifest says %lu\n",
+                      (long)contentLength, (unsigned long)manifest->size);
+        client.stop();
+        return false;
+    }
+
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts_ret(&sha, 0);
+
+    uint32_t received = 0;
+    uint32_t nextReport = manifest->size / 10;
+    uint32_t start = millis();
+    uint32_t lastData = start;
+    bool aborted = false;
+
+    while (received < manifest->size) {
+        size_t want = manifest->size - received;
+        if (want > sizeof(s_block)) want = sizeof(s_block);
+        int n = readBody(client, s_block, want, &lastData);
+        if (n < 0) break;
+        if (n == 0) continue;
+
+        mbedtls_sha256_update_ret(&sha, s_block, n);
+        if (!sink(s_block, n, ctx)) {
+            aborted = true;
+            break;
+        }
+        received += n;
+
+        if (received >= nextReport && received < manifest->size) {
+            Serial.printf("[OTA] %lu%% (%lu KB)\n", (unsigned long)((uint64_t)received * 100 / manifest->size),
+                          (unsigned long)(received / 1024));
+            nextReport += manifest->size / 10;
+        }
+    }
+    client.stop();
+
+    uint8_t digest[32];
+    mbedtls_sha256_finish_ret(&sha, digest);
+    mbedtls_sha256_free(&sha);
+
+    if (aborted) {
+        Serial.println("[OTA] Aborted by the writer");
+        return false;
+    }
+    if (received != manifest->size) {
+        Serial.printf("[OTA] Got %lu of %lu bytes\n", (unsigned long)received, (unsigned long)manifest->size);
+        return false;
+    }
+    // The digest is part of the signed manifest, so a match authenticates the image
+    if (memcmp(digest, manifest->sha256, sizeof(digest)) != 0) {
+        Serial.println("[OTA] SHA-256 mismatch");
+        return false;
+    }
+
+    uint32_t elapsed = millis() - start;
+    Serial.printf("[OTA] %lu bytes verified in %lu ms\n", (unsigned long)received, (unsigned long)elapsed);
+    return true;
+}
+
+// ============================================================
+// Versions
+// ============================================================
+
+typedef struct {
+    uint32_t core[3];
+    StringView pre;         // Pre-release identifiers; empty for a release
+} version_t;
+
+static bool isNumeric(StringView s) {
+    for (size_t i = 0; i < s.length(); i++) {
+        if (s[i] < '0' || s[i] > '9') return false;
+    }
+    return !s.empty();
+}
+
+// [v]MAJOR.MINOR.PATCH[-pre.release][+build]
+static bool parseVersion(StringView s, version_t *out) {
+    if (s.startsWith("v") || s.startsWith("V")) s = s.substr(1);
+    s = s.substr(0, s.find('+'));   // Build metadata does not order
+
+    size_t dash = s.find('-');
+    StringView core = s.substr(0, dash);
+    out->pre = dash == StringView::npos ? StringView() : s.substr(dash + 1);
+
+    for (int i = 0; i < 3; i++) {
+        size_t dot = core.find('.');
+        if ((i < 2) != (dot != StringView::npos)) return false;
+        StringView part = core.substr(0, dot);
+        if (!isNumeric(part) || part.length() > 9) return false;
+        out->core[i] = atol(part.data());
+        core = core.substr(dot == StringView::npos ? core.length() : dot + 1);
+    }
+
+    if (dash == StringView::npos) return true;
+    StringView rest = out->pre;
+    while (true) {
+        size_t dot = rest.find('.');
+        StringView ident = rest.substr(0, dot);
+        if (ident.empty() || (isNumeric(ident) && ident.length() > 1 && ident[0] == '0')) return false;
+        for (size_t i = 0; i < ident.length(); i++) {
+            if (!isalnum((unsigned char)ident[i]) && ident[i] != '-') return false;
+        }
+        if (dot == StringView::npos) return true;
+        rest = rest.substr(dot + 1);
+    }
+}
+
+static int compareText(StringView a, StringView b) {
+    size_t n = a.length() < b.length() ? a.length() : b.length();
+    int c = memcmp(a.data(), b.data(), n);
+    if (c) return c;
+    return a.length() < b.length() ? -1 : a.length() > b.length();
+}
+
+// Semver rules: numeric identifiers by value and below alphanumeric ones,
+// a shorter list of otherwise equal identifiers first
+static int comparePre(StringView a, StringView b) {
+    while (true) {
+        if (a.empty() || b.empty()) return (int)!a.empty() - (int)!b.empty();
+        size_t da = a.find('.'), db = b.find('.');
+        StringView ia = a.substr(0, da), ib = b.substr(0, db);
+        bool na = isNumeric(ia), nb = isNumeric(ib);
+        int c;
+        if (na && nb) c = ia.length() != ib.length() ? (ia.length() < ib.length() ? -1 : 1) : compareText(ia, ib);
+        else if (na != nb) c = na ? -1 : 1;
+        else c = compareText(ia, ib);
+        if (c) return c;
+        a = a.substr(da == StringView::npos ? a.length() : da + 1);
+        b = b.substr(db == StringView::npos ? b.length() : db + 1);
+    }
+}
+
+bool ota_version_newer(const char *candidate, const char *running) {
+    version_t a, b;
+    if (!parseVersion(candidate, &a) || !parseVersion(running, &b)) return false;
+
+    for (int i = 0; i < 3; i++) {
+        if (a.core[i] != b.core[i]) return a.core[i] > b.core[i];
+    }
+    // A release is newer than its pre-releases
+    if (a.pre.empty() || b.pre.empty()) return a.pre.empty() && !b.pre.empty();
+    return comparePre(a.pre, b.pre) > 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * SparkMiner - OTA Image Fetch
+ * Streams a signed firmware image over HTTP and verifies it on the fly
+ *
+ * An update is described by a small JSON manifest next to the image:
+ *
+ *   {"version": "v2.9.2", "board": "ESP32-2432S028", "size": 1234567,
+ *    "sha256": "<64 hex>", "sig": "<DER ECDSA P-256 signature, hex>",
+ *    "url": "sparkminer-esp32-2432s028.bin"}
+ *
+ * "sig" is made with the update key over the SHA-256 of the statement
+ *
+ *   "sparkminer-ota-1\n<version>\n<board>\n<size>\n<sha256 hex>\n"
+ *
+ * (size in decimal, digest in lowercase hex), so version and board are
+ * as authentic as the image itself: a captured manifest cannot be
+ * relabelled to push an old image or another board's image. The manifest
+ * is only returned once that signature verifies.
+ *
+ * "url" is absolute (http://...) or relative to the manifest and is not
+ * signed. The image is read in OTA_BLOCK_SIZE pieces and handed to a sink
+ * (the inactive app partition on the board, a file on the host) while
+ * SHA-256 runs over the same bytes; nothing is buffered whole. It is
+ * accepted only if its size and digest match the signed manifest.
+ * scripts/ota_sign.py writes the manifest.
+ *
+ * Plain HTTP only: integrity comes from the signature, not the transport.
+ * Platform-neutral (WiFiClient and mbedTLS), so host/src/ota_fetch.cpp
+ * runs the same code against a local HTTP server.
+ *
+ * GPL v3 License
+ */
+
+#ifndef OTA_IMAGE_H
+#define OTA_IMAGE_H
+
+#include <Arduino.h>
+
+#define OTA_URL_MAX         160
+#define OTA_VERSION_MAX     31
+#define OTA_SIG_MAX         80      // DER ECDSA P-256 is at most 72 bytes
+#define OTA_BLOCK_SIZE      1024
+#define OTA_MANIFEST_MAX    1024
+#define OTA_TIMEOUT_MS      15000   // No data for this long aborts a transfer
+
+typedef struct {
+    char version[OTA_VERSION_MAX + 1];
+    char board[OTA_VERSION_MAX + 1];
+    uint32_t size;
+    uint8_t sha256[32];
+    uint8_t sig[OTA_SIG_MAX];
+    size_t sigLen;
+    char url[OTA_URL_MAX + 1];          // Image, resolved to an absolute URL
+} ota_manifest_t;
+
+/**
+ * Receives verified-so-far image data in order
+ * @return false to abort the transfer (e.g. flash write failed)
+ */
+typedef bool (*ota_sink_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * Download, parse and authenticate a manifest
+ * @param publicKeyPem PEM public key (P-256) the manifest must be signed with
+ * @return false on network, HTTP or format errors or a bad signature (logged)
+ */
+bool ota_fetch_manifest(const char *url, const char *publicKeyPem, ota_manifest_t *out);
+
+/**
+ * Stream the image to `sink`, hashing as it goes, then check its size
+ * and digest against the (verified) manifest
+ * @return true only if every byte was delivered and the image matches;
+ *         on false the sink's data must be discarded
+ */
+bool ota_fetch_image(const ota_manifest_t *manifest, ota_sink_t sink, void *ctx);
+
+/**
+ * Semantic version order: [v]MAJOR.MINOR.PATCH[-prerelease][+build]
+ * @return true only if both parse and `candidate` is strictly newer
+ */
+bool ota_version_newer(const char *candidate, const char *running);
+
+#endif // OTA_IMAGE_H
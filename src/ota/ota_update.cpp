@@ -0,0 +1,213 @@
+/*
+ * SparkMiner - OTA Updates
+ * Update check, partition writer and restart scheduling (see ota_update.h)
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_ota_ops.h>
+#include <board_config.h>
+#include <ota_key.h>
+#include "ota_update.h"
+#include "ota_image.h"
+#include "../mining/miner.h"
+#include "../stratum/stratum.h"
+#include "../config/nvs_config.h"
+#include "../stats/monitor.h"
+#include "../stats/alloc_guard.h"
+
+#define OTA_POLL_MS         1000
+#define OTA_SETTLE_MS       250     // After the job switch: lets an old-job share reach the pool
+
+static TaskHandle_t s_task = NULL;
+static volatile bool s_checkRequested = false;
+
+// ============================================================
+// Rollback
+// ============================================================
+
+// Arduino marks a trial image valid during init unless this returns true;
+// confirmRunningImage() decides instead (rollback-enabled bootloaders only)
+extern "C" bool verifyRollbackLater() {
+    return true;
+}
+
+static void confirmRunningImage() {
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+    if (esp_ota_get_state_partition(running, &state) != ESP_OK || state != ESP_OTA_IMG_PENDING_VERIFY) {
+        return;
+    }
+
+    // Without a wallet there is no pool to reach; keep the image
+    if (nvs_config_is_valid()) {
+        Serial.println("[OTA] New firmware on trial until it reaches a pool");
+        uint32_t start = millis();
+        while (!stratum_is_connected()) {
+            if (millis() - start > OTA_TRIAL_MS) {
+                Serial.println("[OTA] New firmware never reached a pool, rolling back");
+                delay(100);
+                esp_ota_mark_app_invalid_rollback_and_reboot();
+            }
+            vTaskDelay(pdMS_TO_TICKS(OTA_POLL_MS));
+        }
+    }
+    esp_ota_mark_app_valid_cancel_rollback();
+    Serial.println("[OTA] New firmware confirmed");
+}
+
+// ============================================================
+// Update
+// ============================================================
+
+static bool writePartition(const uint8_t *data, size_t len, void *ctx) {
+    esp_err_t err = esp_ota_write(*(esp_ota_handle_t *)ctx, data, len);
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] Flash write failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Fetch the manifest and install a newer image if there is one
+ * @return true once a verified image is set to boot
+ */
+static bool checkForUpdate(const char *manifestUrl) {
+    static ota_manifest_t manifest;
+    if (!ota_fetch_manifest(manifestUrl, OTA_PUBLIC_KEY, &manifest)) return false;
+
+    // Version and board are signed; anything not strictly newer (a replayed old release) is refused
+    if (!ota_version_newer(manifest.version, AUTO_VERSION)) {
+        Serial.printf("[OTA] Up to date (" AUTO_VERSION ", server has %s)\n", manifest.version);
+        return false;
+    }
+    if (strcmp(manifest.board, BOARD_NAME) != 0) {
+        Serial.printf("[OTA] %s is for %s, not " BOARD_NAME "\n", manifest.version, manifest.board);
+        return false;
+    }
+
+    const esp_partition_t *target = esp_ota_get_next_update_partition(NULL);
+    if (!target) {
+        Serial.println("[OTA] No OTA partition in this partition table");
+        return false;
+    }
+    if (manifest.size > target->size) {
+        Serial.printf("[OTA] %s is %lu bytes, partition %s holds %lu\n", manifest.version,
+                      (unsigned long)manifest.size, target->label, (unsigned long)target->size);
+        return false;
+    }
+
+    Serial.printf("[OTA] Updating " AUTO_VERSION " -> %s (%lu KB) into %s while mining\n",
+                  manifest.version, (unsigned long)(manifest.size / 1024), target->label);
+
+    // Sequential writes erase sector by sector as data arrives, not the whole partition up front
+    // The IDF allocates the handle here and maps the image to check it in esp_ota_end
+    esp_ota_handle_t handle;
+    alloc_guard_exempt_begin();
+    esp_err_t err = esp_ota_begin(target, OTA_WITH_SEQUENTIAL_WRITES, &handle);
+    alloc_guard_exempt_end();
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] Cannot open %s: %s\n", target->label, esp_err_to_name(err));
+        return false;
+    }
+
+    if (!ota_fetch_image(&manifest, writePartition, &handle)) {
+        esp_ota_abort(handle);
+        Serial.println("[OTA] Update discarded, running firmware unchanged");
+        return false;
+    }
+
+    // esp_ota_end also checks the app image structure before it can boot
+    alloc_guard_exempt_begin();
+    err = esp_ota_end(handle);
+    if (err == ESP_OK) err = esp_ota_set_boot_partition(target);
+    alloc_guard_exempt_end();
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] Cannot activate %s: %s\n", target->label, esp_err_to_name(err));
+        return false;
+    }
+
+    Serial.printf("[OTA] %s will boot from %s\n", manifest.version, target->label);
+    return true;
+}
+
+/**
+ * Restart into the new image at a cheap moment: right after a job switch,
+ * when the abandoned work is a fraction of a second old, with stats saved
+ */
+static void restartAfterJobSwitch() {
+    monitor_request_save();
+
+    uint32_t jobs = miner_get_stats()->templates;
+    uint32_t start = millis();
+    bool switched = false;
+    if (stratum_is_connected()) {
+        Serial.println("[OTA] Restarting after the next job switch");
+        while (millis() - start < OTA_RESTART_WAIT_MS) {
+            if (miner_get_stats()->templates != jobs) {
+                switched = true;
+                break;
+            }
+            vTaskDelay(pdMS_TO_TICKS(50));
+        }
+    }
+
+    // The save request goes out with the monitor's next pass
+    while (monitor_save_pending() && millis() - start < OTA_RESTART_WAIT_MS + 5000) {
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+    if (switched) vTaskDelay(pdMS_TO_TICKS(OTA_SETTLE_MS));
+
+    Serial.printf("[OTA] Restarting (%s)\n", switched ? "job switch" : "no job switch, timed out");
+    delay(100);
+    esp_restart();
+}
+
+// ============================================================
+// Task
+// ============================================================
+
+static void ota_task(void *param) {
+    confirmRunningImage();
+
+    char url[sizeof(nvs_config_get()->otaUrl)];
+    uint32_t lastCheck = millis() - (OTA_CHECK_MS - OTA_FIRST_CHECK_MS);
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(OTA_POLL_MS));
+
+        if (!s_checkRequested && millis() - lastCheck < OTA_CHECK_MS) continue;
+        if (WiFi.status() != WL_CONNECTED) continue;
+        s_checkRequested = false;
+        lastCheck = millis();
+
+        strncpy(url, nvs_config_get()->otaUrl, sizeof(url) - 1);
+        url[sizeof(url) - 1] = '\0';
+        if (!url[0]) continue;
+
+        if (checkForUpdate(url)) {
+            restartAfterJobSwitch();
+        }
+    }
+}
+
+void ota_init() {
+    if (!OTA_PUBLIC_KEY[0]) {
+        // A trial image that cannot update itself is kept as it is
+        esp_ota_mark_app_valid_cancel_rollback();
+        Serial.println("[OTA] No public key built in, updates disabled");
+        return;
+    }
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    Serial.printf("[OTA] Running from %s\n", running ? running->label : "?");
+    xTaskCreatePinnedToCore(ota_task, "OtaTask", OTA_STACK, NULL, OTA_PRIORITY, &s_task, OTA_CORE);
+    alloc_guard_watch(s_task);
+}
+
+void ota_check_now() {
+    if (!s_task) return;
+    s_checkRequested = true;
+}
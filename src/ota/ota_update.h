@@ -0,0 +1,44 @@
+/*
+ * SparkMiner - OTA Updates
+ * Pulls a signed firmware image into the spare app partition while
+ * mining continues, then restarts into it once
+ *
+ * The OtaTask reads the manifest at config "ota_url" OTA_FIRST_CHECK_MS
+ * after boot, every OTA_CHECK_MS after that, and at once when the URL is
+ * changed. A signed manifest for this board with a version strictly
+ * newer than the running one is streamed into the next OTA partition through
+ * ota_image.h, block by block, at Miner0's priority on Core 0; nothing
+ * stops hashing, though each 4 KB sector erase briefly holds both cores
+ * off flash. Only an image whose size, SHA-256 and signature check out
+ * is made the boot partition. The restart waits for the next job switch
+ * (little work is lost) after a stats save, or OTA_RESTART_WAIT_MS at most.
+ *
+ * The public key is built in (include/ota_key.h); without one the task
+ * is not started. With a rollback-enabled bootloader the new firmware
+ * boots on trial and is kept once it reaches a pool.
+ *
+ * GPL v3 License
+ */
+
+#ifndef OTA_UPDATE_H
+#define OTA_UPDATE_H
+
+#include <Arduino.h>
+
+#define OTA_FIRST_CHECK_MS  120000      // 2 minutes after boot
+#define OTA_CHECK_MS        21600000UL  // Then every 6 hours
+#define OTA_RESTART_WAIT_MS 600000      // Restart anyway if no new job arrives
+#define OTA_TRIAL_MS        600000      // Rollback: time the new firmware has to reach a pool
+
+/**
+ * Start the update task (after tasks_start, WiFi up or not)
+ */
+void ota_init();
+
+/**
+ * Check for an update now instead of at the next interval
+ * Safe from any task; does nothing when updates are disabled.
+ */
+void ota_check_now();
+
+#endif // OTA_UPDATE_H
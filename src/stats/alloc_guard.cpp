@@ -0,0 +1,223 @@
+/*
+ * SparkMiner - Allocation Tripwire Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "alloc_guard.h"
+
+#if ALLOC_GUARD
+
+#if defined(HOST_BUILD)
+    #include <execinfo.h>
+#elif defined(CONFIG_IDF_TARGET_ARCH_XTENSA) && CONFIG_IDF_TARGET_ARCH_XTENSA
+    #include <esp_cpu.h>
+    #include <esp_debug_helpers.h>
+    #define GUARD_XTENSA_BACKTRACE 1
+#endif
+
+#define GUARD_MAX_TASKS     12
+#define GUARD_MAX_SITES     32
+#define GUARD_DEPTH         6       // Frames kept per call site
+#define GUARD_SKIP          2       // alloc_guard_note() and the __wrap_ function
+
+typedef struct {
+    TaskHandle_t task;
+    uint16_t exemptDepth;
+    bool busy;              // In alloc_guard_note() or the report; what Serial or backtrace allocates is not counted
+} guard_task_t;
+
+typedef struct {
+    uintptr_t pc[GUARD_DEPTH];
+    uint32_t hits;
+    uint32_t bytes;
+    char task[configMAX_TASK_NAME_LEN];
+} guard_site_t;
+
+static portMUX_TYPE s_guardMux = portMUX_INITIALIZER_UNLOCKED;
+static guard_task_t s_tasks[GUARD_MAX_TASKS];
+static int s_taskCount = 0;
+static guard_site_t s_sites[GUARD_MAX_SITES];
+static int s_siteCount = 0;
+static volatile bool s_armed = false;
+static volatile uint32_t s_count = 0;
+static uint32_t s_dropped = 0;          // Hits from sites past the table size
+
+// ============================================================
+// Call Site Capture
+// ============================================================
+
+static int findTask(TaskHandle_t task) {
+    for (int i = 0; i < s_taskCount; i++) {
+        if (s_tasks[i].task == task) return i;
+    }
+    return -1;
+}
+
+static void captureSite(uintptr_t *pc) {
+    memset(pc, 0, sizeof(uintptr_t) * GUARD_DEPTH);
+
+    #if defined(HOST_BUILD)
+        void *frames[GUARD_DEPTH + GUARD_SKIP];
+        int n = backtrace(frames, GUARD_DEPTH + GUARD_SKIP);
+        for (int i = GUARD_SKIP; i < n; i++) pc[i - GUARD_SKIP] = (uintptr_t)frames[i];
+    #elif defined(GUARD_XTENSA_BACKTRACE)
+        esp_backtrace_frame_t frame;
+        esp_backtrace_get_start(&frame.pc, &frame.sp, &frame.next_pc);
+        for (int i = 0; i < GUARD_DEPTH + GUARD_SKIP; i++) {
+            if (i >= GUARD_SKIP) pc[i - GUARD_SKIP] = esp_cpu_process_stack_pc(frame.pc);
+            if (!frame.next_pc || !esp_backtrace_get_next_frame(&frame)) break;
+        }
+    #else
+        // RISC-V cores have no frame walker in the SDK; the caller is all we get
+        pc[0] = (uintptr_t)__builtin_return_address(0);
+    #endif
+}
+
+static void printSite(const guard_site_t *site) {
+    Serial.printf("[ALLOC] %5lu x %6lu B  %-12s", (unsigned long)site->hits,
+                  (unsigned long)site->bytes, site->task);
+    for (int i = 0; i < GUARD_DEPTH && site->pc[i]; i++) {
+        Serial.printf(" 0x%08lx", (unsigned long)site->pc[i]);
+    }
+    Serial.println();
+}
+
+__attribute__((noinline)) void alloc_guard_note(size_t size) {
+    if (!s_armed) return;
+
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (!self) return;
+
+    // Only the task itself touches its busy flag and exempt depth
+    int t = findTask(self);
+    if (t < 0 || s_tasks[t].exemptDepth || s_tasks[t].busy) return;
+    s_tasks[t].busy = true;
+
+    guard_site_t hit;
+    captureSite(hit.pc);
+
+    portENTER_CRITICAL(&s_guardMux);
+    s_count++;
+    guard_site_t *site = NULL;
+    for (int i = 0; i < s_siteCount && !site; i++) {
+        if (!memcmp(s_sites[i].pc, hit.pc, sizeof(hit.pc))) site = &s_sites[i];
+    }
+    if (!site && s_siteCount < GUARD_MAX_SITES) {
+        site = &s_sites[s_siteCount++];
+        memcpy(site->pc, hit.pc, sizeof(hit.pc));
+        site->hits = 0;
+        site->bytes = 0;
+        strncpy(site->task, pcTaskGetName(self), sizeof(site->task) - 1);
+        site->task[sizeof(site->task) - 1] = '\0';
+    }
+    if (site) {
+        site->hits++;
+        site->bytes += size;
+        hit = *site;
+    } else {
+        s_dropped++;
+    }
+    portEXIT_CRITICAL(&s_guardMux);
+
+    #if ALLOC_GUARD == ALLOC_GUARD_TRAP
+        Serial.printf("[ALLOC] TRAP: %u bytes allocated after mining started\n", (unsigned)size);
+        printSite(&hit);
+        Serial.flush();
+        abort();
+    #endif
+
+    s_tasks[t].busy = false;
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void alloc_guard_watch(TaskHandle_t task) {
+    if (!task) return;
+    portENTER_CRITICAL(&s_guardMux);
+    if (findTask(task) < 0 && s_taskCount < GUARD_MAX_TASKS) {
+        s_tasks[s_taskCount].task = task;
+        s_tasks[s_taskCount].exemptDepth = 0;
+        s_tasks[s_taskCount].busy = false;
+        s_taskCount++;
+    }
+    portEXIT_CRITICAL(&s_guardMux);
+}
+
+void alloc_guard_arm() {
+    if (s_armed) return;
+
+    // The first capture may load unwinder tables; do it before arming
+    uintptr_t pc[GUARD_DEPTH];
+    captureSite(pc);
+
+    s_armed = true;
+    Serial.printf("[ALLOC] Tripwire armed (%s), watching %d tasks\n",
+                  ALLOC_GUARD == ALLOC_GUARD_TRAP ? "trap" : "count", s_taskCount);
+}
+
+bool alloc_guard_armed() {
+    return s_armed;
+}
+
+uint32_t alloc_guard_count() {
+    return s_count;
+}
+
+void alloc_guard_exempt_begin() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL(&s_guardMux);
+    int t = findTask(self);
+    if (t >= 0) s_tasks[t].exemptDepth++;
+    portEXIT_CRITICAL(&s_guardMux);
+}
+
+void alloc_guard_exempt_end() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL(&s_guardMux);
+    int t = findTask(self);
+    if (t >= 0 && s_tasks[t].exemptDepth) s_tasks[t].exemptDepth--;
+    portEXIT_CRITICAL(&s_guardMux);
+}
+
+void alloc_guard_report() {
+    // Snapshot so printing (which may allocate) runs outside the lock
+    static guard_site_t sites[GUARD_MAX_SITES];
+    int self = findTask(xTaskGetCurrentTaskHandle());
+    if (self >= 0) s_tasks[self].busy = true;
+
+    portENTER_CRITICAL(&s_guardMux);
+    int count = s_siteCount;
+    memcpy(sites, s_sites, sizeof(guard_site_t) * count);
+    uint32_t total = s_count;
+    uint32_t dropped = s_dropped;
+    portEXIT_CRITICAL(&s_guardMux);
+
+    Serial.printf("[ALLOC] %lu allocations after mining started, %d call sites%s\n",
+                  (unsigned long)total, count, s_armed ? "" : " (not armed yet)");
+    for (int i = 0; i < count; i++) {
+        printSite(&sites[i]);
+        #if defined(HOST_BUILD)
+            void *frames[GUARD_DEPTH];
+            int n = 0;
+            while (n < GUARD_DEPTH && sites[i].pc[n]) {
+                frames[n] = (void *)sites[i].pc[n];
+                n++;
+            }
+            fflush(stdout);
+            backtrace_symbols_fd(frames, n, fileno(stdout));
+        #endif
+    }
+    if (dropped) {
+        Serial.printf("[ALLOC] %lu more from sites past the %d-entry table\n",
+                      (unsigned long)dropped, GUARD_MAX_SITES);
+    }
+
+    if (self >= 0) s_tasks[self].busy = false;
+}
+
+#endif // ALLOC_GUARD
@@ -0,0 +1,90 @@
+/*
+ * SparkMiner - Allocation Tripwire
+ * Counts (or traps) heap allocations made by the mining tasks once
+ * mining has settled into its steady state
+ *
+ * Enabled with -D ALLOC_GUARD=1 (count) or 2 (abort on the first hit),
+ * plus the linker flags that route the allocator through the guard
+ * (stats/heap_wrap.cpp):
+ *
+ *   -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc
+ *
+ * With the default 0 every call compiles away. The firmware's own tasks
+ * are registered where they are created (tasks.cpp, StatsTask, Telemetry,
+ * OtaTask); allocations from any other task (WiFi, lwIP) are ignored,
+ * since the SDK allocates there by design. The monitor arms the guard
+ * ALLOC_GUARD_WARMUP_MS after the first job.
+ *
+ * Each offending call site is kept as a short backtrace with a hit count,
+ * task name and bytes requested. Decode the addresses with addr2line
+ * (xtensa-esp32-elf-addr2line -pfiaC -e firmware.elf on the device).
+ * Calls the SDK makes regardless of our code (NVS commits, socket
+ * connects, TLS, UDP datagrams, mbedTLS key parsing, esp_ota_begin) are
+ * bracketed with alloc_guard_exempt_begin()/end().
+ *
+ * GPL v3 License
+ */
+
+#ifndef ALLOC_GUARD_H
+#define ALLOC_GUARD_H
+
+#include <Arduino.h>
+#include <board_config.h>
+
+#define ALLOC_GUARD_OFF         0
+#define ALLOC_GUARD_COUNT       1
+#define ALLOC_GUARD_TRAP        2
+
+#if ALLOC_GUARD
+
+/**
+ * Check allocations made by this task once armed
+ */
+void alloc_guard_watch(TaskHandle_t task);
+
+/**
+ * Check one allocation (called from the allocator wrappers)
+ */
+void alloc_guard_note(size_t size);
+
+/**
+ * Start checking (mining has reached its steady state)
+ */
+void alloc_guard_arm();
+
+/**
+ * True once alloc_guard_arm() has run
+ */
+bool alloc_guard_armed();
+
+/**
+ * Allocations by watched tasks since the guard was armed
+ */
+uint32_t alloc_guard_count();
+
+/**
+ * Ignore allocations by the calling task until the matching end()
+ * Nests; for SDK calls whose allocations are out of our hands
+ */
+void alloc_guard_exempt_begin();
+void alloc_guard_exempt_end();
+
+/**
+ * Print the per-call-site table
+ */
+void alloc_guard_report();
+
+#else
+
+static inline void alloc_guard_watch(TaskHandle_t task) { (void)task; }
+static inline void alloc_guard_note(size_t size) { (void)size; }
+static inline void alloc_guard_arm() {}
+static inline bool alloc_guard_armed() { return false; }
+static inline uint32_t alloc_guard_count() { return 0; }
+static inline void alloc_guard_exempt_begin() {}
+static inline void alloc_guard_exempt_end() {}
+static inline void alloc_guard_report() {}
+
+#endif // ALLOC_GUARD
+
+#endif // ALLOC_GUARD_H
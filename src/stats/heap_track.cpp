@@ -0,0 +1,303 @@
+/*
+ * SparkMiner - Heap Tracker Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "heap_track.h"
+
+#if HEAP_TRACK
+
+#if defined(HOST_BUILD)
+    #include <malloc.h>
+#else
+    #include <esp_heap_caps.h>
+#endif
+
+#define TRACK_MAX_TASKS     16
+#define TRACK_SCOPE_DEPTH   4
+#define TRACK_SLOT_MASK     (HEAP_TRACK_SLOTS - 1)
+
+static_assert((HEAP_TRACK_SLOTS & TRACK_SLOT_MASK) == 0, "HEAP_TRACK_SLOTS must be a power of two");
+
+// One live block; ptr == NULL marks a free slot
+typedef struct {
+    void *ptr;
+    uint32_t size;
+    uint8_t tag;
+} track_block_t;
+
+typedef struct {
+    TaskHandle_t task;
+    uint8_t nameTag;                    // From the task name, looked up once
+    uint8_t scopeDepth;
+    uint8_t scope[TRACK_SCOPE_DEPTH];
+} track_task_t;
+
+typedef struct {
+    uint32_t liveBytes;
+    uint32_t liveBlocks;
+    uint32_t peakBytes;
+    uint32_t allocs;
+    uint32_t allocBytes;                // Total requested, for the byte rate
+} track_counter_t;
+
+// Task names to tags; everything unlisted is HEAP_TAG_OTHER
+static const struct {
+    const char *name;
+    heap_tag_t tag;
+} s_taskTags[] = {
+    { "Stratum",    HEAP_TAG_STRATUM },
+    { "StatsTask",  HEAP_TAG_STATS },
+    { "Display",    HEAP_TAG_DISPLAY },
+    { "wifi",       HEAP_TAG_WIFI },
+    { "tiT",        HEAP_TAG_WIFI },    // lwIP
+    { "sys_evt",    HEAP_TAG_WIFI },    // Event loop
+    { "arduino_events", HEAP_TAG_WIFI },
+};
+
+static const char *const s_tagNames[HEAP_TAG_COUNT] = {
+    "other", "stratum", "stats", "display", "wifi", "portal"
+};
+
+static portMUX_TYPE s_trackMux = portMUX_INITIALIZER_UNLOCKED;
+static track_block_t s_blocks[HEAP_TRACK_SLOTS];
+static track_task_t s_tasks[TRACK_MAX_TASKS];
+static int s_taskCount = 0;
+static track_counter_t s_counters[HEAP_TAG_COUNT];
+static uint32_t s_used = 0;
+static uint32_t s_untracked = 0;
+
+// Owned by heap_track_sample()
+static heap_track_snapshot_t s_snapshot;
+static track_counter_t s_lastSample[HEAP_TAG_COUNT];
+static uint32_t s_lastSampleTime = 0;
+
+// ============================================================
+// Side Table (open addressing, linear probing)
+// ============================================================
+
+static inline uint32_t slotOf(const void *ptr) {
+    // Blocks are 8-byte aligned; the multiply spreads neighbours apart
+    return ((uint32_t)((uintptr_t)ptr >> 3) * 2654435761u) & TRACK_SLOT_MASK;
+}
+
+static int findBlock(const void *ptr) {
+    uint32_t i = slotOf(ptr);
+    for (uint32_t n = 0; n < HEAP_TRACK_SLOTS; n++) {
+        if (s_blocks[i].ptr == ptr) return (int)i;
+        if (!s_blocks[i].ptr) return -1;
+        i = (i + 1) & TRACK_SLOT_MASK;
+    }
+    return -1;
+}
+
+// Backward-shift delete keeps probe chains intact without tombstones
+static void removeSlot(uint32_t hole) {
+    uint32_t i = hole;
+    for (;;) {
+        i = (i + 1) & TRACK_SLOT_MASK;
+        if (!s_blocks[i].ptr) break;
+        uint32_t home = slotOf(s_blocks[i].ptr);
+        bool movable = (hole <= i) ? (home <= hole || home > i) : (home <= hole && home > i);
+        if (movable) {
+            s_blocks[hole] = s_blocks[i];
+            hole = i;
+        }
+    }
+    s_blocks[hole].ptr = NULL;
+}
+
+static void forget(int slot) {
+    track_block_t *b = &s_blocks[slot];
+    track_counter_t *c = &s_counters[b->tag];
+    c->liveBytes -= b->size;
+    c->liveBlocks--;
+    s_used--;
+    removeSlot((uint32_t)slot);
+}
+
+// ============================================================
+// Tag Resolution
+// ============================================================
+
+static heap_tag_t tagFromName(const char *name) {
+    if (!name) return HEAP_TAG_OTHER;
+    for (size_t i = 0; i < sizeof(s_taskTags) / sizeof(s_taskTags[0]); i++) {
+        if (!strcmp(name, s_taskTags[i].name)) return s_taskTags[i].tag;
+    }
+    return HEAP_TAG_OTHER;
+}
+
+// Caller holds s_trackMux
+static track_task_t *findTask(TaskHandle_t task) {
+    for (int i = 0; i < s_taskCount; i++) {
+        if (s_tasks[i].task == task) return &s_tasks[i];
+    }
+    return NULL;
+}
+
+// Caller holds s_trackMux; NULL once the task table is full
+static track_task_t *addTask(TaskHandle_t task) {
+    track_task_t *t = findTask(task);
+    if (t || s_taskCount >= TRACK_MAX_TASKS) return t;
+
+    t = &s_tasks[s_taskCount++];
+    t->task = task;
+    t->nameTag = tagFromName(pcTaskGetName(task));
+    t->scopeDepth = 0;
+    return t;
+}
+
+// Caller holds s_trackMux
+static heap_tag_t currentTag(TaskHandle_t self) {
+    if (!self) return HEAP_TAG_OTHER;
+    track_task_t *t = addTask(self);
+    if (!t) return tagFromName(pcTaskGetName(self));
+    if (t->scopeDepth) return (heap_tag_t)t->scope[t->scopeDepth - 1];
+    return (heap_tag_t)t->nameTag;
+}
+
+// ============================================================
+// Allocator Hooks
+// ============================================================
+
+void heap_track_alloc(void *ptr, size_t size) {
+    if (!ptr) return;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&s_trackMux);
+    heap_tag_t tag = currentTag(self);
+    track_counter_t *c = &s_counters[tag];
+    c->allocs++;
+    c->allocBytes += size;
+
+    // A pointer we still hold was freed behind our back (heap_caps_free)
+    int stale = findBlock(ptr);
+    if (stale >= 0) forget(stale);
+
+    // Keep a quarter of the table free so probe chains stay short
+    if (s_used < HEAP_TRACK_SLOTS - HEAP_TRACK_SLOTS / 4) {
+        uint32_t i = slotOf(ptr);
+        while (s_blocks[i].ptr) i = (i + 1) & TRACK_SLOT_MASK;
+        s_blocks[i].ptr = ptr;
+        s_blocks[i].size = (uint32_t)size;
+        s_blocks[i].tag = (uint8_t)tag;
+        s_used++;
+        c->liveBytes += size;
+        c->liveBlocks++;
+        if (c->liveBytes > c->peakBytes) c->peakBytes = c->liveBytes;
+    } else {
+        s_untracked++;
+    }
+    portEXIT_CRITICAL(&s_trackMux);
+}
+
+void heap_track_free(void *ptr) {
+    if (!ptr) return;
+    portENTER_CRITICAL(&s_trackMux);
+    int slot = findBlock(ptr);
+    if (slot >= 0) forget(slot);
+    portEXIT_CRITICAL(&s_trackMux);
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void heap_track_scope_begin(heap_tag_t tag) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (!self || tag >= HEAP_TAG_COUNT) return;
+
+    portENTER_CRITICAL(&s_trackMux);
+    track_task_t *t = addTask(self);
+    if (t && t->scopeDepth < TRACK_SCOPE_DEPTH) t->scope[t->scopeDepth++] = (uint8_t)tag;
+    portEXIT_CRITICAL(&s_trackMux);
+}
+
+void heap_track_scope_end() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL(&s_trackMux);
+    track_task_t *t = findTask(self);
+    if (t && t->scopeDepth) t->scopeDepth--;
+    portEXIT_CRITICAL(&s_trackMux);
+}
+
+static void readHeap(uint32_t *freeHeap, uint32_t *largest) {
+    #if defined(HOST_BUILD)
+        // glibc has no largest-free-block query; the releasable top chunk
+        // is the closest stand-in, so host figures are indicative only
+        struct mallinfo2 mi = mallinfo2();
+        *freeHeap = (uint32_t)mi.fordblks;
+        *largest = (uint32_t)mi.keepcost;
+    #else
+        *freeHeap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        *largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    #endif
+}
+
+void heap_track_sample(uint32_t now) {
+    uint32_t freeHeap, largest;
+    readHeap(&freeHeap, &largest);
+
+    track_counter_t counters[HEAP_TAG_COUNT];
+    portENTER_CRITICAL(&s_trackMux);
+    memcpy(counters, s_counters, sizeof(counters));
+    uint32_t untracked = s_untracked;
+    portEXIT_CRITICAL(&s_trackMux);
+
+    float seconds = s_lastSampleTime ? (now - s_lastSampleTime) / 1000.0f : 0.0f;
+    for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+        heap_tag_stats_t *out = &s_snapshot.tags[i];
+        out->liveBytes = counters[i].liveBytes;
+        out->liveBlocks = counters[i].liveBlocks;
+        out->peakBytes = counters[i].peakBytes;
+        out->allocs = counters[i].allocs;
+        if (seconds > 0) {
+            out->allocsPerSec = (counters[i].allocs - s_lastSample[i].allocs) / seconds;
+            out->bytesPerSec = (counters[i].allocBytes - s_lastSample[i].allocBytes) / seconds;
+        }
+    }
+    memcpy(s_lastSample, counters, sizeof(counters));
+    s_lastSampleTime = now;
+
+    s_snapshot.freeHeap = freeHeap;
+    s_snapshot.largestBlock = largest;
+    s_snapshot.fragmentation = freeHeap ? 1.0f - (float)largest / freeHeap : 0.0f;
+    if (s_snapshot.fragmentation > s_snapshot.maxFragmentation) {
+        s_snapshot.maxFragmentation = s_snapshot.fragmentation;
+    }
+    s_snapshot.untracked = untracked;
+}
+
+void heap_track_get(heap_track_snapshot_t *out) {
+    *out = s_snapshot;
+}
+
+const char *heap_track_tag_name(heap_tag_t tag) {
+    return tag < HEAP_TAG_COUNT ? s_tagNames[tag] : "?";
+}
+
+void heap_track_report() {
+    const heap_track_snapshot_t *s = &s_snapshot;
+
+    Serial.printf("[HEAP] Fragmentation %.1f%% (worst %.1f%%): largest block %lu of %lu B free\n",
+                  s->fragmentation * 100.0f, s->maxFragmentation * 100.0f,
+                  (unsigned long)s->largestBlock, (unsigned long)s->freeHeap);
+    Serial.println("[HEAP]   tag         live B  blocks   peak B   allocs  alloc/s      B/s");
+    for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+        const heap_tag_stats_t *t = &s->tags[i];
+        Serial.printf("[HEAP]   %-8s %9lu %7lu %8lu %8lu %8.1f %8.0f\n",
+                      s_tagNames[i], (unsigned long)t->liveBytes, (unsigned long)t->liveBlocks,
+                      (unsigned long)t->peakBytes, (unsigned long)t->allocs,
+                      t->allocsPerSec, t->bytesPerSec);
+    }
+    if (s->untracked) {
+        Serial.printf("[HEAP]   %lu allocations not tracked (raise HEAP_TRACK_SLOTS)\n",
+                      (unsigned long)s->untracked);
+    }
+}
+
+#endif // HEAP_TRACK
@@ -0,0 +1,110 @@
+/*
+ * SparkMiner - Heap Tracker
+ * Attributes live heap to subsystems and watches fragmentation over time
+ *
+ * Enabled with -D HEAP_TRACK=1 plus the linker flags that route the
+ * allocator through stats/heap_wrap.cpp:
+ *
+ *   -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc -Wl,--wrap=free
+ *
+ * Every block is recorded with its size and a tag in a fixed side table
+ * (no allocation of its own). The tag comes from the allocating task's
+ * name (Stratum, StatsTask, Display, the SDK WiFi/lwIP tasks) unless a
+ * heap_track_scope_begin() is open on that task, which is how the config
+ * portal, running on the Arduino loop task, gets its own line.
+ *
+ * The monitor calls heap_track_sample() every 10 s to turn the counters
+ * into rates and to compute the fragmentation index, and prints the table
+ * every HEAP_TRACK_REPORT_MS. heap_track_get() hands the same numbers to
+ * anything that wants to publish them.
+ *
+ * With the default 0 every call compiles away.
+ *
+ * GPL v3 License
+ */
+
+#ifndef HEAP_TRACK_H
+#define HEAP_TRACK_H
+
+#include <Arduino.h>
+#include <board_config.h>
+
+typedef enum {
+    HEAP_TAG_OTHER = 0,     // Main loop, monitor, miners, unknown SDK tasks
+    HEAP_TAG_STRATUM,
+    HEAP_TAG_STATS,         // Live stats fetcher (HTTPS, JSON)
+    HEAP_TAG_DISPLAY,
+    HEAP_TAG_WIFI,          // WiFi driver, lwIP, event loop
+    HEAP_TAG_PORTAL,        // WiFiManager config portal
+    HEAP_TAG_COUNT
+} heap_tag_t;
+
+typedef struct {
+    uint32_t liveBytes;     // Currently allocated
+    uint32_t liveBlocks;
+    uint32_t peakBytes;     // Highest liveBytes seen
+    uint32_t allocs;        // Total allocations since boot
+    float allocsPerSec;     // Over the last sample interval
+    float bytesPerSec;
+} heap_tag_stats_t;
+
+typedef struct {
+    heap_tag_stats_t tags[HEAP_TAG_COUNT];
+    uint32_t freeHeap;      // At the last sample
+    uint32_t largestBlock;
+    float fragmentation;    // 1 - largestBlock / freeHeap (0 = one free block)
+    float maxFragmentation; // Worst seen since boot
+    uint32_t untracked;     // Allocations the side table had no room for
+} heap_track_snapshot_t;
+
+#if HEAP_TRACK
+
+/**
+ * Tag allocations by the calling task until the matching end()
+ * Nests; the innermost tag wins
+ */
+void heap_track_scope_begin(heap_tag_t tag);
+void heap_track_scope_end();
+
+/**
+ * Record a block (called from the allocator wrappers)
+ */
+void heap_track_alloc(void *ptr, size_t size);
+
+/**
+ * Forget a block (called from the allocator wrappers)
+ */
+void heap_track_free(void *ptr);
+
+/**
+ * Update rates and the fragmentation index
+ * @param now  millis()
+ */
+void heap_track_sample(uint32_t now);
+
+/**
+ * Copy of the counters as of the last sample
+ */
+void heap_track_get(heap_track_snapshot_t *out);
+
+/**
+ * Print the per-tag table and fragmentation
+ */
+void heap_track_report();
+
+const char *heap_track_tag_name(heap_tag_t tag);
+
+#else
+
+static inline void heap_track_scope_begin(heap_tag_t tag) { (void)tag; }
+static inline void heap_track_scope_end() {}
+static inline void heap_track_alloc(void *ptr, size_t size) { (void)ptr; (void)size; }
+static inline void heap_track_free(void *ptr) { (void)ptr; }
+static inline void heap_track_sample(uint32_t now) { (void)now; }
+static inline void heap_track_get(heap_track_snapshot_t *out) { memset(out, 0, sizeof(*out)); }
+static inline void heap_track_report() {}
+static inline const char *heap_track_tag_name(heap_tag_t tag) { (void)tag; return ""; }
+
+#endif // HEAP_TRACK
+
+#endif // HEAP_TRACK_H
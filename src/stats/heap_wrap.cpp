@@ -0,0 +1,103 @@
+/*
+ * SparkMiner - Allocator Wrappers
+ * The -Wl,--wrap targets behind the allocation tripwire
+ * (stats/alloc_guard.h) and the heap tracker (stats/heap_track.h)
+ *
+ * Both can be on in one build. The tripwire needs malloc, calloc and
+ * realloc wrapped; the tracker also needs free, so __wrap_free only
+ * exists with HEAP_TRACK (it would reference an undefined __real_free
+ * otherwise).
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "alloc_guard.h"
+#include "heap_track.h"
+
+#if ALLOC_GUARD || HEAP_TRACK
+
+#if defined(HOST_BUILD)
+    #include <new>
+#endif
+
+extern "C" {
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+#if HEAP_TRACK
+    void __real_free(void *ptr);
+#endif
+}
+
+// ============================================================
+// Allocator Wrappers (-Wl,--wrap=...)
+// ============================================================
+
+extern "C" void *__wrap_malloc(size_t size) {
+    alloc_guard_note(size);
+    void *ptr = __real_malloc(size);
+    heap_track_alloc(ptr, size);
+    return ptr;
+}
+
+extern "C" void *__wrap_calloc(size_t count, size_t size) {
+    alloc_guard_note(count * size);
+    void *ptr = __real_calloc(count, size);
+    heap_track_alloc(ptr, count * size);
+    return ptr;
+}
+
+extern "C" void *__wrap_realloc(void *ptr, size_t size) {
+    if (size) alloc_guard_note(size);
+    void *moved = __real_realloc(ptr, size);
+
+    // On failure the old block is still live
+    if (moved || !size) {
+        heap_track_free(ptr);
+        heap_track_alloc(moved, size);
+    }
+    return moved;
+}
+
+#if HEAP_TRACK
+extern "C" void __wrap_free(void *ptr) {
+    heap_track_free(ptr);
+    __real_free(ptr);
+}
+#endif
+
+#if defined(HOST_BUILD)
+// The shared libstdc++ calls malloc internally, where --wrap cannot reach;
+// on the device the static library's operator new goes through __wrap_malloc
+void *operator new(size_t size) {
+    void *ptr = __wrap_malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return __wrap_malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return __wrap_malloc(size ? size : 1);
+}
+
+#if HEAP_TRACK
+// Same reason: libstdc++'s operator delete would free behind the tracker
+void operator delete(void *ptr) noexcept { __wrap_free(ptr); }
+void operator delete[](void *ptr) noexcept { __wrap_free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { __wrap_free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { __wrap_free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { __wrap_free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { __wrap_free(ptr); }
+#endif
+#endif // HOST_BUILD
+
+#endif // ALLOC_GUARD || HEAP_TRACK
@@ -0,0 +1,70 @@
+/*
+ * SparkMiner - Sample History Implementation
+ * Fixed ring of per-interval hashrate and temperature samples
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include "history.h"
+
+static history_sample_t s_samples[HISTORY_SAMPLES];
+static uint32_t s_seq = 0;
+static portMUX_TYPE s_historyMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================
+// Public API
+// ============================================================
+
+void history_push(float hashRate, float tempC) {
+    history_sample_t sample;
+    sample.hashRate = hashRate > 0 ? hashRate : 0;
+    sample.tempC = (int8_t)(tempC < -128 ? -128 : (tempC > 127 ? 127 : tempC));
+
+    portENTER_CRITICAL(&s_historyMux);
+    s_samples[s_seq % HISTORY_SAMPLES] = sample;
+    s_seq++;
+    portEXIT_CRITICAL(&s_historyMux);
+}
+
+uint32_t history_seq() {
+    return s_seq;
+}
+
+bool history_get(uint32_t seq, history_sample_t *out) {
+    if (!out) return false;
+
+    bool ok;
+    portENTER_CRITICAL(&s_historyMux);
+    ok = (seq < s_seq) && (s_seq - seq <= HISTORY_SAMPLES);
+    if (ok) *out = s_samples[seq % HISTORY_SAMPLES];
+    portEXIT_CRITICAL(&s_historyMux);
+    return ok;
+}
+
+float history_peak(uint16_t span) {
+    float peak = 0;
+
+    portENTER_CRITICAL(&s_historyMux);
+    uint32_t count = s_seq < HISTORY_SAMPLES ? s_seq : HISTORY_SAMPLES;
+    if (span < count) count = span;
+    for (uint32_t i = 1; i <= count; i++) {
+        float v = s_samples[(s_seq - i) % HISTORY_SAMPLES].hashRate;
+        if (v > peak) peak = v;
+    }
+    portEXIT_CRITICAL(&s_historyMux);
+    return peak;
+}
+
+float history_mean(uint16_t span) {
+    float sum = 0;
+
+    portENTER_CRITICAL(&s_historyMux);
+    uint32_t count = s_seq < HISTORY_SAMPLES ? s_seq : HISTORY_SAMPLES;
+    if (span < count) count = span;
+    for (uint32_t i = 1; i <= count; i++) {
+        sum += s_samples[(s_seq - i) % HISTORY_SAMPLES].hashRate;
+    }
+    portEXIT_CRITICAL(&s_historyMux);
+    return count ? sum / count : 0;
+}
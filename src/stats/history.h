@@ -0,0 +1,56 @@
+/*
+ * SparkMiner - Sample History
+ * Fixed ring of per-interval hashrate and temperature samples
+ *
+ * The monitor pushes one sample per HISTORY_INTERVAL_MS. Samples are
+ * addressed by a monotonically increasing sequence number so readers can
+ * fetch only what they have not seen yet (e.g. to draw a single new column).
+ *
+ * GPL v3 License
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+
+#define HISTORY_SAMPLES         256     // Ring length (power of two)
+#define HISTORY_INTERVAL_MS     5000    // 256 x 5 s = ~21 minutes
+
+/**
+ * One history interval
+ */
+typedef struct {
+    float hashRate;     // Mean H/s over the interval (unsmoothed, stalls show up)
+    int8_t tempC;       // Chip temperature at the end of the interval
+} history_sample_t;
+
+/**
+ * Append a sample (overwrites the oldest once the ring is full)
+ */
+void history_push(float hashRate, float tempC);
+
+/**
+ * Number of samples pushed since boot
+ * Sample sequence numbers run from history_seq() - HISTORY_SAMPLES
+ * (or 0) up to history_seq() - 1
+ */
+uint32_t history_seq();
+
+/**
+ * Fetch a sample by sequence number
+ * @return false if the sample has not been recorded or was overwritten
+ */
+bool history_get(uint32_t seq, history_sample_t *out);
+
+/**
+ * Highest hashrate among the newest `span` samples
+ */
+float history_peak(uint16_t span);
+
+/**
+ * Mean hashrate over the newest `span` samples (fewer if not recorded yet)
+ */
+float history_mean(uint16_t span);
+
+#endif // HISTORY_H
@@ -0,0 +1,175 @@
+/*
+ * SparkMiner - LAN Stats Sharing
+ * Multicast socket and publisher election (see lan_stats.h)
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "lan_stats.h"
+#include "alloc_guard.h"
+
+// ============================================================
+// Globals
+// ============================================================
+
+static WiFiUDP s_udp;
+static bool s_open = false;
+static uint8_t s_mode = LAN_STATS_OFF;
+static uint8_t s_rank = 0;
+static uint8_t s_mac[6] = {0};
+
+// Election
+static bool s_publisher = false;
+static uint32_t s_heardAt = 0;          // Last frame from a better publisher
+static uint32_t s_electDelay = 0;
+
+// Publishing
+static uint32_t s_lastSend = 0;
+static bool s_kick = false;
+static uint32_t s_seq = 0;
+
+// ============================================================
+// Election
+// ============================================================
+
+static uint8_t rankFor(uint8_t mode) {
+#if defined(SPARKMINER_LINUX)
+    (void)mode;
+    return LAN_STATS_RANK_HOST;
+#else
+    return mode == LAN_STATS_PUBLISH ? LAN_STATS_RANK_PREFER : LAN_STATS_RANK_BOARD;
+#endif
+}
+
+// Higher rank wins, then the lower MAC
+static bool beats(const lan_stats_frame_t *frame) {
+    if (frame->rank != s_rank) return frame->rank > s_rank;
+    return memcmp(frame->mac, s_mac, sizeof(s_mac)) < 0;
+}
+
+static bool validFrame(const lan_stats_frame_t *frame) {
+    return frame->magic[0] == 'S' && frame->magic[1] == 'L' &&
+           frame->version == LAN_STATS_VERSION;
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void lan_stats_begin(uint8_t mode, const uint8_t mac[6]) {
+    if (s_open) s_udp.stop();
+    s_open = false;
+    s_publisher = false;
+    s_mode = mode;
+    if (mode == LAN_STATS_OFF) return;
+
+    memcpy(s_mac, mac, sizeof(s_mac));
+    s_rank = rankFor(mode);
+
+    // A preferred publisher only waits to hear whether a better one is
+    // already running; the MAC spreads out boards that elect together
+    uint32_t wait = s_rank > LAN_STATS_RANK_BOARD ? LAN_STATS_PUBLISH_MS + 5000 : LAN_STATS_ELECT_MS;
+    s_electDelay = wait + ((uint32_t)mac[4] << 8 | mac[5]) % LAN_STATS_JITTER_MS;
+    s_heardAt = millis();
+
+    alloc_guard_exempt_begin();
+    s_open = s_udp.beginMulticast(IPAddress(LAN_STATS_GROUP), LAN_STATS_PORT);
+    alloc_guard_exempt_end();
+    if (!s_open) {
+        Serial.println("[LANSTATS] Cannot join group, fetching directly");
+        return;
+    }
+    Serial.printf("[LANSTATS] Listening on %s:%d (rank %u%s)\n", LAN_STATS_GROUP_STR, LAN_STATS_PORT,
+                  s_rank, mode == LAN_STATS_LISTEN ? ", never publishes" : "");
+}
+
+bool lan_stats_poll(uint32_t now, lan_stats_frame_t *frame) {
+    if (!s_open) return false;
+
+    bool got = false;
+    lan_stats_frame_t in;
+    while (true) {
+        // WiFiUDP copies each datagram into a fresh heap buffer
+        alloc_guard_exempt_begin();
+        int size = s_udp.parsePacket();
+        int len = size > 0 ? s_udp.read((uint8_t *)&in, sizeof(in)) : 0;
+        alloc_guard_exempt_end();
+
+        if (size <= 0) break;
+        if (len != (int)sizeof(in) || !validFrame(&in)) continue;
+        if (memcmp(in.mac, s_mac, sizeof(s_mac)) == 0) continue;   // Own frame looped back
+
+        if (beats(&in)) {
+            s_heardAt = now;
+            if (s_publisher) {
+                s_publisher = false;
+                Serial.printf("[LANSTATS] %02x%02x%02x%02x%02x%02x (rank %u) publishes, listening\n",
+                              in.mac[0], in.mac[1], in.mac[2], in.mac[3], in.mac[4], in.mac[5], in.rank);
+            }
+        } else if (s_publisher) {
+            continue;   // It steps down when it hears us
+        }
+        *frame = in;
+        got = true;
+    }
+
+    if (!s_publisher && s_mode != LAN_STATS_LISTEN && now - s_heardAt > s_electDelay) {
+        s_publisher = true;
+        s_kick = true;
+        Serial.println("[LANSTATS] No better publisher heard, publishing");
+    }
+    return got;
+}
+
+bool lan_stats_is_publisher() {
+    return s_publisher;
+}
+
+bool lan_stats_publish_due(uint32_t now) {
+    return s_publisher && (s_kick || now - s_lastSend >= LAN_STATS_PUBLISH_MS);
+}
+
+void lan_stats_kick() {
+    s_kick = true;
+}
+
+bool lan_stats_send(lan_stats_frame_t *frame, uint32_t now) {
+    frame->magic[0] = 'S';
+    frame->magic[1] = 'L';
+    frame->version = LAN_STATS_VERSION;
+    frame->rank = s_rank;
+    memcpy(frame->mac, s_mac, sizeof(s_mac));
+    frame->reserved = 0;
+    frame->seq = s_seq;
+
+    // Sent or not, wait an interval: a failing send is retried, not spun on
+    s_lastSend = now;
+    s_kick = false;
+
+    if (!s_open) return false;
+
+    // Resolving the group and the datagram buffer are the SDK's allocations
+    alloc_guard_exempt_begin();
+    bool sent = s_udp.beginPacket(LAN_STATS_GROUP_STR, LAN_STATS_PORT);
+    if (sent) {
+        s_udp.write((const uint8_t *)frame, sizeof(*frame));
+        sent = s_udp.endPacket();
+    }
+    alloc_guard_exempt_end();
+
+    if (!sent) return false;
+    s_seq++;
+    return true;
+}
+
+uint32_t lan_stats_wallet_hash(const char *wallet) {
+    uint32_t hash = 2166136261u;
+    while (*wallet) {
+        hash ^= (uint8_t)*wallet++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,125 @@
+/*
+ * SparkMiner - LAN Stats Sharing
+ * One miner on the LAN fetches the live stats APIs and multicasts the
+ * results; the others use its frames instead of fetching themselves
+ *
+ * Election: every miner listens on LAN_STATS_GROUP. A miner that may
+ * publish and has heard no better publisher for LAN_STATS_ELECT_MS (plus
+ * a MAC-derived jitter, so a LAN of identical boards does not elect all
+ * at once) starts publishing. "Better" is a higher rank, then the lower
+ * MAC, so two publishers that hear each other settle on one. A host
+ * daemon outranks boards, and a board set to "publish" outranks "auto".
+ *
+ * Freshness is per field group: each frame carries the age of every
+ * group, and live_stats treats a shared value like one it fetched that
+ * long ago. When frames stop, or the publisher stops refreshing a group,
+ * the values age past their update interval (plus LAN_STATS_GRACE_MS)
+ * and the miner fetches that group directly again.
+ *
+ * Frame: lan_stats_frame_t as one UDP datagram, packed little-endian.
+ *
+ * GPL v3 License
+ */
+
+#ifndef LAN_STATS_H
+#define LAN_STATS_H
+
+#include <Arduino.h>
+#include <board_config.h>
+
+// Administratively scoped group, never routed off the LAN
+#define LAN_STATS_GROUP         239, 83, 77, 1
+#define LAN_STATS_GROUP_STR     "239.83.77.1"
+#define LAN_STATS_PORT          9101
+#define LAN_STATS_VERSION       1
+
+#define LAN_STATS_PUBLISH_MS    30000   // Frame interval while publishing
+#define LAN_STATS_ELECT_MS      90000   // Silence before a listener takes over
+#define LAN_STATS_JITTER_MS     15000   // Spread of the takeover by MAC
+#define LAN_STATS_GRACE_MS      90000   // Shared values outlive their interval by this
+
+// Config "lan_stats" (frames are not authenticated, so sharing is opt-in)
+#define LAN_STATS_OFF           0       // Fetch directly, ignore the LAN (default)
+#define LAN_STATS_AUTO          1       // Listen, publish if elected
+#define LAN_STATS_PUBLISH       2       // Prefer to publish (rank above auto)
+#define LAN_STATS_LISTEN        3       // Never publish
+
+// Publisher rank, higher wins
+#define LAN_STATS_RANK_BOARD    1
+#define LAN_STATS_RANK_PREFER   2
+#define LAN_STATS_RANK_HOST     3
+
+// Field groups, bit and age index
+enum {
+    LAN_STATS_PRICE = 0,
+    LAN_STATS_BLOCK,
+    LAN_STATS_NETWORK,          // Hashrate, difficulty and adjustment
+    LAN_STATS_FEES,
+    LAN_STATS_POOL,             // Only for miners with the same wallet
+    LAN_STATS_GROUPS
+};
+
+typedef struct __attribute__((packed)) {
+    char magic[2];              // "SL"
+    uint8_t version;            // LAN_STATS_VERSION
+    uint8_t rank;               // LAN_STATS_RANK_*
+    uint8_t mac[6];             // Publisher
+    uint8_t valid;              // 1 << LAN_STATS_* for groups carried
+    uint8_t reserved;
+    uint32_t seq;
+    uint16_t age[LAN_STATS_GROUPS];     // Seconds since each group was fetched
+    uint32_t walletHash;        // lan_stats_wallet_hash() of the publisher's wallet
+    float btcPriceUsd;
+    uint32_t blockHeight;
+    double networkHashrate;     // H/s
+    double difficulty;
+    float difficultyProgress;
+    int32_t difficultyChange;
+    uint16_t fees[5];           // fastest, halfHour, hour, economy, minimum
+    int32_t poolWorkers;
+    char poolHashrate[24];
+    char poolBestDifficulty[24];
+} lan_stats_frame_t;
+
+static_assert(sizeof(lan_stats_frame_t) == 124, "LAN stats frame layout changed");
+
+/**
+ * Join the group (WiFi must be up); LAN_STATS_OFF closes the socket
+ * @param mac  This miner's identity in the election
+ */
+void lan_stats_begin(uint8_t mode, const uint8_t mac[6]);
+
+/**
+ * Drain received frames and run the election
+ * @param frame  Out: the newest frame from another publisher, if any
+ * @return true if `frame` was filled
+ */
+bool lan_stats_poll(uint32_t now, lan_stats_frame_t *frame);
+
+/**
+ * This miner is the elected publisher
+ */
+bool lan_stats_is_publisher();
+
+/**
+ * A publisher frame is due: the interval passed or lan_stats_kick() was called
+ */
+bool lan_stats_publish_due(uint32_t now);
+
+/**
+ * Publish as soon as possible (fresh data was fetched)
+ */
+void lan_stats_kick();
+
+/**
+ * Stamp (magic, rank, mac, seq) and multicast a frame
+ * @return false if the send failed
+ */
+bool lan_stats_send(lan_stats_frame_t *frame, uint32_t now);
+
+/**
+ * FNV-1a of a wallet address, so pool stats only go to the same wallet
+ */
+uint32_t lan_stats_wallet_hash(const char *wallet);
+
+#endif // LAN_STATS_H
@@ -6,17 +6,24 @@
  * - HTTP proxy for HTTPS APIs (avoids SSL on ESP32)
  * - Supports authenticated proxies (user:pass@host:port)
  * - Health monitoring with auto-disable/re-enable
+ *
+ * LAN sharing:
+ * - Frames from the elected publisher (lan_stats.h) fill the same fields
+ *   and timers as a fetch; a shared group gets LAN_STATS_GRACE_MS on top
+ *   of its interval before this miner fetches it itself
  */
 
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
-#include <base64.h>
 #include "live_stats.h"
+#include "lan_stats.h"
 #include "board_config.h"
+#include "fixed_string.h"
 #include "../config/nvs_config.h"
+#include "mem_place.h"
+#include "alloc_guard.h"
 
 // ============================================================
 // Globals
@@ -25,6 +32,7 @@
 static live_stats_t s_stats = {0};
 static char s_wallet[128] = {0};
 static SemaphoreHandle_t s_statsMutex = NULL;
+static TaskHandle_t s_task = NULL;
 
 // Update timers
 static uint32_t s_lastPriceUpdate = 0;
@@ -33,13 +41,20 @@ static uint32_t s_lastFeesUpdate = 0;
 static uint32_t s_lastPoolUpdate = 0;
 static uint32_t s_lastNetworkUpdate = 0;
 
+// LAN sharing (stats task only)
+static uint8_t s_lanMode = LAN_STATS_OFF;
+static bool s_lanStarted = false;
+static volatile bool s_reloadPending = false;   // live_stats_reload(), taken by the task
+static uint8_t s_shared = 0;            // 1 << LAN_STATS_* for groups last set by a frame
+static uint8_t s_sharedFrom[6] = {0};   // Publisher of the last applied frame
+
 // Proxy state
 static bool s_proxyHealthy = true;
 static uint32_t s_proxyFailCount = 0;
 static uint32_t s_lastProxyCheck = 0;
 
 // Parsed proxy config (cached to avoid repeated parsing)
-static char s_proxyHost[64] = {0};
+static FixedString<63> s_proxyHost;
 static uint16_t s_proxyPort = 0;
 static char s_proxyAuth[128] = {0};  // Base64 encoded user:pass
 static bool s_proxyConfigured = false;
@@ -53,6 +68,29 @@ static uint32_t s_errorCount = 0;
 // Proxy URL Parser
 // ============================================================
 
+/**
+ * Base64 encode a string for the Proxy-Authorization header
+ * Output is truncated to whole 4-character groups if it does not fit
+ */
+static void base64Encode(const char *in, char *out, size_t size) {
+    static const char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t len = strlen(in);
+    size_t o = 0;
+
+    for (size_t i = 0; i < len && o + 4 < size; i += 3) {
+        uint32_t v = (uint8_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint8_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= (uint8_t)in[i + 2];
+
+        out[o++] = table[(v >> 18) & 0x3f];
+        out[o++] = table[(v >> 12) & 0x3f];
+        out[o++] = (i + 1 < len) ? table[(v >> 6) & 0x3f] : '=';
+        out[o++] = (i + 2 < len) ? table[v & 0x3f] : '=';
+    }
+    out[o] = '\0';
+}
+
 /**
  * Parse proxy configuration in multiple formats:
  *   1. URL format: http://[user:pass@]host:port
@@ -61,98 +99,58 @@ static uint32_t s_errorCount = 0;
  * Returns true if valid proxy config
  */
 static bool parseProxyUrl(const char *url) {
-    s_proxyHost[0] = '\0';
+    s_proxyHost.clear();
     s_proxyPort = 0;
     s_proxyAuth[0] = '\0';
     s_proxyConfigured = false;
 
     if (!url || strlen(url) < 5) return false;
 
+    StringView spec(url);
+    FixedString<95> authPart;   // user:pass, base64 encoded for Proxy-Authorization
+
     // Check if it's URL format (starts with http://)
-    if (strncmp(url, "http://", 7) == 0) {
+    if (spec.startsWith("http://")) {
         // URL format: http://[user:pass@]host:port
-        const char *hostStart = url + 7;
-        const char *atSign = strchr(hostStart, '@');
-
-        if (atSign) {
-            // Has authentication: user:pass@host:port
-            char authPart[96];
-            size_t authLen = atSign - hostStart;
-            if (authLen >= sizeof(authPart)) authLen = sizeof(authPart) - 1;
-            strncpy(authPart, hostStart, authLen);
-            authPart[authLen] = '\0';
-
-            // Base64 encode for Proxy-Authorization header
-            String encoded = base64::encode((uint8_t*)authPart, strlen(authPart));
-            strncpy(s_proxyAuth, encoded.c_str(), sizeof(s_proxyAuth) - 1);
-            s_proxyAuth[sizeof(s_proxyAuth) - 1] = '\0';
-
-            hostStart = atSign + 1;
+        StringView rest = spec.substr(7);
+        size_t atSign = rest.find('@');
+
+        if (atSign != StringView::npos) {
+            authPart = rest.substr(0, atSign);
+            rest = rest.substr(atSign + 1);
         }
 
-        // Find port separator
-        const char *colonPort = strchr(hostStart, ':');
-        if (!colonPort) {
+        size_t colonPort = rest.find(':');
+        if (colonPort == StringView::npos) {
             Serial.println("[STATS] Proxy URL must include port");
             return false;
         }
 
-        // Extract host
-        size_t hostLen = colonPort - hostStart;
-        if (hostLen >= sizeof(s_proxyHost)) hostLen = sizeof(s_proxyHost) - 1;
-        strncpy(s_proxyHost, hostStart, hostLen);
-        s_proxyHost[hostLen] = '\0';
-
-        // Extract port (stop at any trailing characters)
-        s_proxyPort = atoi(colonPort + 1);
+        s_proxyHost = rest.substr(0, colonPort);
+        // atoi stops at any trailing characters
+        s_proxyPort = atoi(rest.data() + colonPort + 1);
     } else {
         // Simple format: host:port[:user:pass]
-        // Count colons to determine format
-        int colonCount = 0;
-        const char *colons[4] = {NULL};
-        const char *p = url;
-        while (*p && colonCount < 4) {
-            if (*p == ':') {
-                colons[colonCount++] = p;
-            }
-            p++;
-        }
-
-        if (colonCount < 1) {
+        size_t colonPort = spec.find(':');
+        if (colonPort == StringView::npos) {
             Serial.println("[STATS] Proxy must include port (host:port)");
             return false;
         }
 
-        // Extract host (everything before first colon)
-        size_t hostLen = colons[0] - url;
-        if (hostLen >= sizeof(s_proxyHost)) hostLen = sizeof(s_proxyHost) - 1;
-        strncpy(s_proxyHost, url, hostLen);
-        s_proxyHost[hostLen] = '\0';
-
-        // Extract port
-        s_proxyPort = atoi(colons[0] + 1);
-
-        // Check for auth (host:port:user:pass format)
-        if (colonCount >= 3) {
-            // Extract user (between 2nd and 3rd colon)
-            char user[64] = {0};
-            size_t userLen = colons[2] - (colons[1] + 1);
-            if (userLen >= sizeof(user)) userLen = sizeof(user) - 1;
-            strncpy(user, colons[1] + 1, userLen);
-            user[userLen] = '\0';
-
-            // Extract pass (after 3rd colon)
-            const char *pass = colons[2] + 1;
-
-            // Build auth string "user:pass" and base64 encode
-            char authPart[96];
-            snprintf(authPart, sizeof(authPart), "%s:%s", user, pass);
-            String encoded = base64::encode((uint8_t*)authPart, strlen(authPart));
-            strncpy(s_proxyAuth, encoded.c_str(), sizeof(s_proxyAuth) - 1);
-            s_proxyAuth[sizeof(s_proxyAuth) - 1] = '\0';
+        s_proxyHost = spec.substr(0, colonPort);
+        s_proxyPort = atoi(spec.data() + colonPort + 1);
+
+        // Auth is everything after the second colon, kept as user:pass
+        size_t colonUser = spec.find(':', colonPort + 1);
+        if (colonUser != StringView::npos && spec.find(':', colonUser + 1) != StringView::npos) {
+            authPart = spec.substr(colonUser + 1);
         }
     }
 
+    if (!authPart.empty()) {
+        base64Encode(authPart.c_str(), s_proxyAuth, sizeof(s_proxyAuth));
+    }
+
     if (s_proxyPort == 0) {
         Serial.println("[STATS] Invalid proxy port");
         return false;
@@ -160,7 +158,7 @@ static bool parseProxyUrl(const char *url) {
 
     s_proxyConfigured = true;
     Serial.printf("[STATS] Proxy configured: %s:%d %s\n",
-                  s_proxyHost, s_proxyPort,
+                  s_proxyHost.c_str(), s_proxyPort,
                   s_proxyAuth[0] ? "(authenticated)" : "");
     return true;
 }
@@ -169,7 +167,8 @@ static bool parseProxyUrl(const char *url) {
 // HTTP Fetch Functions
 // ============================================================
 
-static StaticJsonDocument<2048> s_jsonDoc;
+typedef StaticJsonDocument<2048> stats_doc_t;
+static stats_doc_t *s_jsonDoc = NULL;       // Placed by live_stats_init
 
 static void logError(const char *context, int code) {
     s_errorCount++;
@@ -184,9 +183,10 @@ static void logError(const char *context, int code) {
 /**
  * Extract hostname from URL (e.g., "https://api.coingecko.com/path" -> "api.coingecko.com")
  */
-static String extractHostFromUrl(const char *url) {
+static const char *extractHostFromUrl(const char *url, char *host, size_t size) {
+    host[0] = '\0';
     const char *start = strstr(url, "://");
-    if (!start) return "";
+    if (!start) return host;
     start += 3;  // Skip "://"
 
     const char *end = strchr(start, '/');
@@ -196,60 +196,115 @@ static String extractHostFromUrl(const char *url) {
     const char *colon = strchr(start, ':');
     if (colon && colon < end) end = colon;
 
-    return String(start).substring(0, end - start);
+    size_t len = end - start;
+    if (len >= size) len = size - 1;
+    memcpy(host, start, len);
+    host[len] = '\0';
+    return host;
 }
 
 /**
  * Extract path from URL (e.g., "https://api.coingecko.com/api/v3/..." -> "/api/v3/...")
  */
-static String extractPathFromUrl(const char *url) {
+static const char *extractPathFromUrl(const char *url) {
     const char *start = strstr(url, "://");
     if (!start) return "/";
     start += 3;  // Skip "://"
 
     const char *path = strchr(start, '/');
-    if (!path) return "/";
+    return path ? path : "/";
+}
+
+/**
+ * Extract port from URL, or the scheme default
+ */
+static uint16_t extractPortFromUrl(const char *url) {
+    const char *start = strstr(url, "://");
+    uint16_t port = (strncmp(url, "https://", 8) == 0) ? 443 : 80;
+    if (!start) return port;
+    start += 3;
 
-    return String(path);
+    const char *colon = strchr(start, ':');
+    const char *path = strchr(start, '/');
+    if (colon && (!path || colon < path)) port = atoi(colon + 1);
+    return port;
 }
 
 // Proxy method preference: 0=auto, 1=GET (SSL bump), 2=CONNECT (tunnel)
 static uint8_t s_proxyMethod = 0;
 
-/**
- * Fetch URL via HTTP proxy using GET method (SSL bumping mode)
- * Request format: GET https://target.com/path HTTP/1.1
- * Requires proxy with SSL bumping (decrypts/re-encrypts HTTPS)
- */
-static bool fetchViaProxyGet(const char *targetUrl, JsonDocument &doc) {
-    WiFiClient client;
-    client.setTimeout(8000);
+// ============================================================
+// HTTP Arena
+// ============================================================
+// All fetches run on the stats task, one at a time, so the request,
+// header and body buffers are shared statics rather than String.
+// The body is the big one and is only touched per fetch: it goes
+// through mem_place like the JSON document.
 
-    if (!client.connect(s_proxyHost, s_proxyPort)) {
-        return false;
-    }
+#define STATS_REQUEST_MAX   512
+#define STATS_HEADER_MAX    256
+#define STATS_BODY_MAX      4096    // Body size limit to prevent OOM
 
-    String targetHost = extractHostFromUrl(targetUrl);
+static FixedString<STATS_REQUEST_MAX> s_request;
+static char s_header[STATS_HEADER_MAX];
+static char *s_body = NULL;                 // STATS_BODY_MAX + 1, placed by live_stats_init
 
-    // Build HTTP request - full URL in request line for SSL bumping proxy
-    String request = "GET ";
-    request += targetUrl;
-    request += " HTTP/1.1\r\n";
-    request += "Host: ";
-    request += targetHost;
-    request += "\r\n";
+/**
+ * Connect a client; the socket and its receive buffer are the SDK's
+ * allocations (a TLS client also handshakes here)
+ */
+static bool connectClient(WiFiClient &client, const char *host, uint16_t port) {
+    alloc_guard_exempt_begin();
+    bool ok = client.connect(host, port);
+    alloc_guard_exempt_end();
+    return ok;
+}
 
+static void appendProxyAuth() {
     if (s_proxyAuth[0]) {
-        request += "Proxy-Authorization: Basic ";
-        request += s_proxyAuth;
-        request += "\r\n";
+        s_request.append("Proxy-Authorization: Basic ").append(s_proxyAuth).append("\r\n");
     }
+}
 
-    request += "User-Agent: SparkMiner/1.0 ESP32\r\n";
-    request += "Accept: application/json\r\n";
-    request += "Connection: close\r\n\r\n";
+/**
+ * Read one header line into s_header (trimmed, truncated to fit)
+ * Returns its length, or -1 on timeout or close
+ */
+static int readHeaderLine(WiFiClient &client, uint32_t timeoutMs) {
+    size_t len = 0;
+    uint32_t start = millis();
 
-    client.print(request);
+    while (client.connected() || client.available()) {
+        if (!client.available()) {
+            if (millis() - start > timeoutMs) return -1;
+            vTaskDelay(10 / portTICK_PERIOD_MS);
+            continue;
+        }
+        char c = client.read();
+        if (c == '\n') break;
+        if (c != '\r' && len < sizeof(s_header) - 1) s_header[len++] = c;
+    }
+    while (len && s_header[len - 1] == ' ') len--;
+    s_header[len] = '\0';
+    return (int)len;
+}
+
+/**
+ * Send a GET on a connected client and read the body into s_body
+ * requestTarget is the path, or the full URL when talking to a proxy.
+ * Returns the body length (0 if empty), or -1 on a non-200 status.
+ */
+static int httpGet(WiFiClient &client, const char *requestTarget, const char *host, bool proxyAuth) {
+    s_request.printf("GET %s HTTP/1.1\r\nHost: %s\r\n", requestTarget, host);
+    if (proxyAuth) appendProxyAuth();
+    s_request.append("User-Agent: SparkMiner/1.0 ESP32\r\n"
+                     "Accept: application/json\r\n"
+                     "Connection: close\r\n\r\n");
+    if (s_request.truncated()) {
+        Serial.println("[STATS] Request too long");
+        return -1;
+    }
+    client.write((const uint8_t *)s_request.c_str(), s_request.length());
 
     // Wait for response
     uint32_t timeout = millis() + 8000;
@@ -258,93 +313,96 @@ static bool fetchViaProxyGet(const char *targetUrl, JsonDocument &doc) {
     }
 
     if (!client.available()) {
-        client.stop();
-        return false;
+        return -1;
     }
 
     // Read status line
-    String statusLine = client.readStringUntil('\n');
-    statusLine.trim();
-
     int statusCode = 0;
-    if (statusLine.startsWith("HTTP/")) {
-        int spaceIdx = statusLine.indexOf(' ');
-        if (spaceIdx > 0) {
-            statusCode = statusLine.substring(spaceIdx + 1).toInt();
-        }
+    if (readHeaderLine(client, 5000) > 0 && strncmp(s_header, "HTTP/", 5) == 0) {
+        const char *space = strchr(s_header, ' ');
+        if (space) statusCode = atoi(space + 1);
     }
 
     if (statusCode != 200) {
-        Serial.printf("[STATS] Proxy error: %d\n", statusCode);
-        client.stop();
-        return false;
+        Serial.printf("[STATS] HTTP error: %d\n", statusCode);
+        return -1;
     }
 
-    // Skip headers, look for Content-Length and Transfer-Encoding
-    int contentLength = -1;
+    // Skip headers, look for Transfer-Encoding
     bool chunked = false;
-    while (client.connected() || client.available()) {
-        if (!client.available()) {
-            vTaskDelay(10 / portTICK_PERIOD_MS);
-            continue;
-        }
-        String line = client.readStringUntil('\n');
-        line.trim();
-        if (line.startsWith("Content-Length:")) {
-            contentLength = line.substring(15).toInt();
-        }
-        if (line.indexOf("chunked") >= 0) {
+    while (readHeaderLine(client, 5000) > 0) {
+        if (strstr(s_header, "chunked")) {
             chunked = true;
         }
-        if (line.length() == 0) break;
     }
 
-    // Read body with size limit to prevent OOM
-    const int MAX_BODY = 4096;
-    String body;
-    body.reserve(MAX_BODY);
-
     // Read body - continue while connected OR data available in buffer
+    int len = 0;
     uint32_t readTimeout = millis() + 5000;
-    while ((client.connected() || client.available()) && (int)body.length() < MAX_BODY && millis() < readTimeout) {
+    while ((client.connected() || client.available()) && len < STATS_BODY_MAX && millis() < readTimeout) {
         if (client.available()) {
-            char c = client.read();
-            body += c;
+            s_body[len++] = client.read();
         } else {
             vTaskDelay(1);
         }
     }
-    client.stop();
+    s_body[len] = '\0';
 
-    // Handle chunked transfer encoding
-    if (chunked && body.length() > 0) {
-        String decoded;
-        decoded.reserve(body.length());
+    // Handle chunked transfer encoding; decoded data never overtakes
+    // the read position, so it is compacted in place
+    if (chunked && len > 0) {
         int pos = 0;
-        while (pos < (int)body.length()) {
+        int out = 0;
+        while (pos < len) {
             // Read chunk size (hex)
-            int lineEnd = body.indexOf('\n', pos);
-            if (lineEnd < 0) break;
-            String sizeLine = body.substring(pos, lineEnd);
-            sizeLine.trim();
-            int chunkSize = strtol(sizeLine.c_str(), NULL, 16);
-            if (chunkSize == 0) break;  // End of chunks
-            pos = lineEnd + 1;
-            // Read chunk data
-            if (pos + chunkSize <= (int)body.length()) {
-                decoded += body.substring(pos, pos + chunkSize);
+            const char *lineEnd = strchr(s_body + pos, '\n');
+            if (!lineEnd) break;
+            int chunkSize = strtol(s_body + pos, NULL, 16);
+            if (chunkSize <= 0) break;  // End of chunks
+            pos = lineEnd - s_body + 1;
+            // Copy chunk data
+            if (pos + chunkSize <= len) {
+                memmove(s_body + out, s_body + pos, chunkSize);
+                out += chunkSize;
             }
             pos += chunkSize + 2;  // Skip data + \r\n
         }
-        body = decoded;
+        len = out;
+        s_body[len] = '\0';
+    }
+
+    return len;
+}
+
+/**
+ * Fetch URL via HTTP proxy using GET method (SSL bumping mode)
+ * Request format: GET https://target.com/path HTTP/1.1
+ * Requires proxy with SSL bumping (decrypts/re-encrypts HTTPS)
+ */
+static bool fetchViaProxyGet(const char *targetUrl, JsonDocument &doc) {
+    WiFiClient client;
+    client.setTimeout(8000);
+
+    if (!connectClient(client, s_proxyHost.c_str(), s_proxyPort)) {
+        return false;
     }
 
-    if (body.length() == 0) {
+    // Full URL in request line for SSL bumping proxy
+    char targetHost[64];
+    extractHostFromUrl(targetUrl, targetHost, sizeof(targetHost));
+    int len = httpGet(client, targetUrl, targetHost, true);
+    client.stop();
+
+    if (len < 0) {
+        return false;
+    }
+
+    if (len == 0) {
         Serial.println("[STATS] Proxy: empty response");
         return false;
     }
 
-    DeserializationError err = deserializeJson(doc, body);
+    DeserializationError err = deserializeJson(doc, (const char *)s_body, len);
     if (err) {
         logError("Proxy JSON", err.code());
         return false;
@@ -407,36 +465,45 @@ static bool fetchViaProxy(const char *targetUrl, JsonDocument &doc) {
 }
 
 /**
- * Fetch URL directly via HTTPS (CPU intensive, may cause issues)
+ * GET a URL directly into s_body on the given client
+ * Returns the body length, or -1 on failure
  */
-static bool fetchHttpsDirect(const char *url, JsonDocument &doc) {
-    WiFiClientSecure secureClient;
-    secureClient.setInsecure();
-    secureClient.setTimeout(5000);
-
-    HTTPClient http;
-    http.setUserAgent("SparkMiner/1.0 ESP32");
-    http.setTimeout(5000);
+static int fetchDirect(WiFiClient &client, const char *url) {
+    char host[64];
+    extractHostFromUrl(url, host, sizeof(host));
 
-    vTaskDelay(1);  // Yield before SSL handshake
+    vTaskDelay(1);  // Yield before connect (and SSL handshake)
 
-    if (!http.begin(secureClient, url)) {
-        logError("HTTPS connect", -1);
-        return false;
+    if (!connectClient(client, host, extractPortFromUrl(url))) {
+        return -1;
     }
+    int len = httpGet(client, extractPathFromUrl(url), host, false);
+    client.stop();
+    return len;
+}
 
-    int httpCode = http.GET();
+/**
+ * Fetch URL directly via HTTPS (CPU intensive, may cause issues)
+ */
+static bool fetchHttpsDirect(const char *url, JsonDocument &doc) {
+    // mbedTLS allocates its context and record buffers for the whole session
+    int len;
+    alloc_guard_exempt_begin();
+    {
+        WiFiClientSecure secureClient;
+        secureClient.setInsecure();
+        secureClient.setTimeout(5000);
+        len = fetchDirect(secureClient, url);
+    }
+    alloc_guard_exempt_end();
 
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        http.end();
-        DeserializationError err = deserializeJson(doc, payload);
-        return !err;
+    if (len <= 0) {
+        logError("HTTPS request", len);
+        return false;
     }
 
-    logError("HTTPS request", httpCode);
-    http.end();
-    return false;
+    DeserializationError err = deserializeJson(doc, (const char *)s_body, len);
+    return !err;
 }
 
 /**
@@ -446,25 +513,13 @@ static bool fetchHttp(const char *url, JsonDocument &doc) {
     WiFiClient client;
     client.setTimeout(5000);
 
-    HTTPClient http;
-    http.setUserAgent("SparkMiner/1.0 ESP32");
-    http.setTimeout(5000);
-
-    if (!http.begin(client, url)) {
+    int len = fetchDirect(client, url);
+    if (len <= 0) {
         return false;
     }
 
-    int httpCode = http.GET();
-
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        http.end();
-        DeserializationError err = deserializeJson(doc, payload);
-        return !err;
-    }
-
-    http.end();
-    return false;
+    DeserializationError err = deserializeJson(doc, (const char *)s_body, len);
+    return !err;
 }
 
 /**
@@ -516,10 +571,10 @@ static void checkProxyHealth() {
 
             // Try a simple request to test proxy
             s_proxyHealthy = true;  // Temporarily enable for test
-            s_jsonDoc.clear();
+            s_jsonDoc->clear();
 
             // Use CoinGecko ping endpoint - lightweight HTTPS test
-            if (fetchViaProxy("https://api.coingecko.com/api/v3/ping", s_jsonDoc)) {
+            if (fetchViaProxy("https://api.coingecko.com/api/v3/ping", *s_jsonDoc)) {
                 Serial.println("[STATS] Proxy health check passed");
                 s_proxyFailCount = 0;
             } else {
@@ -530,6 +585,168 @@ static void checkProxyHealth() {
     }
 }
 
+// ============================================================
+// LAN Sharing
+// ============================================================
+
+static const char *const s_groupNames[LAN_STATS_GROUPS] = { "price", "block", "network", "fees", "pool" };
+
+// Format the network strings from the raw values (mutex held)
+static void formatNetworkStats() {
+    double hashrate = s_stats.networkHashrateRaw;
+    if (hashrate > 1e18) {
+        snprintf(s_stats.networkHashrate, sizeof(s_stats.networkHashrate), "%.2f EH/s", hashrate / 1e18);
+    } else if (hashrate > 1e15) {
+        snprintf(s_stats.networkHashrate, sizeof(s_stats.networkHashrate), "%.2f PH/s", hashrate / 1e15);
+    } else if (hashrate > 0) {
+        snprintf(s_stats.networkHashrate, sizeof(s_stats.networkHashrate), "%.2f TH/s", hashrate / 1e12);
+    }
+    if (s_stats.difficultyRaw > 0) {
+        snprintf(s_stats.networkDifficulty, sizeof(s_stats.networkDifficulty), "%.2f T", s_stats.difficultyRaw / 1e12);
+    }
+}
+
+// A group this miner fetched itself is no longer shared, and worth publishing
+static void fetched(int group) {
+    s_shared &= ~(1 << group);
+    lan_stats_kick();
+}
+
+/**
+ * Update timer check. A shared group gets the grace period on top, so a
+ * live publisher always refreshes it first; past that it is stale and
+ * this miner fetches it directly.
+ */
+static bool due(uint32_t now, uint32_t last, uint32_t interval, int group) {
+    bool shared = s_shared & (1 << group);
+    bool publisher = lan_stats_is_publisher();
+    if (shared && !publisher) interval += LAN_STATS_GRACE_MS;
+    if (now - last <= interval) return false;
+
+    // A new publisher refreshing its predecessor's values is not news
+    if (shared && !publisher) {
+        Serial.printf("[STATS] Shared %s stats stale, fetching directly\n", s_groupNames[group]);
+    }
+    s_shared &= ~(1 << group);
+    return true;
+}
+
+// Frame data for a group is newer than what we have
+static bool takeGroup(uint8_t groups, int group, bool valid, uint32_t stamp, uint32_t at) {
+    return (groups & (1 << group)) && (!valid || (int32_t)(at - stamp) > 0);
+}
+
+static void applyFrame(const lan_stats_frame_t *frame, uint32_t now) {
+    uint8_t groups = frame->valid;
+    if (!s_wallet[0] || frame->walletHash != lan_stats_wallet_hash(s_wallet)) {
+        groups &= ~(1 << LAN_STATS_POOL);
+    }
+
+    uint32_t at[LAN_STATS_GROUPS];
+    for (int g = 0; g < LAN_STATS_GROUPS; g++) at[g] = now - frame->age[g] * 1000UL;
+
+    uint8_t applied = 0;
+    xSemaphoreTake(s_statsMutex, portMAX_DELAY);
+
+    if (takeGroup(groups, LAN_STATS_PRICE, s_stats.priceValid, s_stats.priceTimestamp, at[LAN_STATS_PRICE])) {
+        s_stats.btcPriceUsd = frame->btcPriceUsd;
+        s_stats.priceTimestamp = s_lastPriceUpdate = at[LAN_STATS_PRICE];
+        s_stats.priceValid = true;
+        applied |= 1 << LAN_STATS_PRICE;
+    }
+
+    if (takeGroup(groups, LAN_STATS_BLOCK, s_stats.blockValid, s_stats.blockTimestamp, at[LAN_STATS_BLOCK])) {
+        s_stats.blockHeight = frame->blockHeight;
+        s_stats.blockTimestamp = s_lastBlockUpdate = at[LAN_STATS_BLOCK];
+        s_stats.blockValid = true;
+        applied |= 1 << LAN_STATS_BLOCK;
+    }
+
+    if (takeGroup(groups, LAN_STATS_NETWORK, s_stats.networkValid, s_stats.networkTimestamp, at[LAN_STATS_NETWORK])) {
+        s_stats.networkHashrateRaw = frame->networkHashrate;
+        s_stats.difficultyRaw = frame->difficulty;
+        s_stats.difficultyProgress = frame->difficultyProgress;
+        s_stats.difficultyChange = frame->difficultyChange;
+        formatNetworkStats();
+        s_stats.networkTimestamp = s_lastNetworkUpdate = at[LAN_STATS_NETWORK];
+        s_stats.networkValid = true;
+        applied |= 1 << LAN_STATS_NETWORK;
+    }
+
+    if (takeGroup(groups, LAN_STATS_FEES, s_stats.feesValid, s_stats.feesTimestamp, at[LAN_STATS_FEES])) {
+        s_stats.fastestFee = frame->fees[0];
+        s_stats.halfHourFee = frame->fees[1];
+        s_stats.hourFee = frame->fees[2];
+        s_stats.economyFee = frame->fees[3];
+        s_stats.minimumFee = frame->fees[4];
+        s_stats.feesTimestamp = s_lastFeesUpdate = at[LAN_STATS_FEES];
+        s_stats.feesValid = true;
+        applied |= 1 << LAN_STATS_FEES;
+    }
+
+    if (takeGroup(groups, LAN_STATS_POOL, s_stats.poolValid, s_stats.poolTimestamp, at[LAN_STATS_POOL])) {
+        s_stats.poolWorkersCount = frame->poolWorkers;
+        memcpy(s_stats.poolTotalHashrate, frame->poolHashrate, sizeof(s_stats.poolTotalHashrate) - 1);
+        s_stats.poolTotalHashrate[sizeof(s_stats.poolTotalHashrate) - 1] = '\0';
+        memcpy(s_stats.poolBestDifficulty, frame->poolBestDifficulty, sizeof(s_stats.poolBestDifficulty) - 1);
+        s_stats.poolBestDifficulty[sizeof(s_stats.poolBestDifficulty) - 1] = '\0';
+        s_stats.poolTimestamp = s_lastPoolUpdate = at[LAN_STATS_POOL];
+        s_stats.poolValid = true;
+        applied |= 1 << LAN_STATS_POOL;
+    }
+
+    xSemaphoreGive(s_statsMutex);
+
+    s_shared |= applied;
+    if (applied && memcmp(s_sharedFrom, frame->mac, sizeof(s_sharedFrom)) != 0) {
+        memcpy(s_sharedFrom, frame->mac, sizeof(s_sharedFrom));
+        Serial.printf("[STATS] Using shared stats from %02x%02x%02x%02x%02x%02x\n",
+                      frame->mac[0], frame->mac[1], frame->mac[2], frame->mac[3], frame->mac[4], frame->mac[5]);
+    }
+}
+
+static void stampGroup(lan_stats_frame_t *frame, int group, bool valid, uint32_t stamp, uint32_t now) {
+    if (!valid) return;
+    uint32_t age = (now - stamp) / 1000;
+    frame->valid |= 1 << group;
+    frame->age[group] = age > 0xFFFF ? 0xFFFF : age;
+}
+
+static uint16_t feeField(int fee) {
+    return fee < 0 ? 0 : fee > 0xFFFF ? 0xFFFF : fee;
+}
+
+static void publishFrame(uint32_t now) {
+    lan_stats_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+
+    xSemaphoreTake(s_statsMutex, portMAX_DELAY);
+    stampGroup(&frame, LAN_STATS_PRICE, s_stats.priceValid, s_stats.priceTimestamp, now);
+    stampGroup(&frame, LAN_STATS_BLOCK, s_stats.blockValid, s_stats.blockTimestamp, now);
+    stampGroup(&frame, LAN_STATS_NETWORK, s_stats.networkValid, s_stats.networkTimestamp, now);
+    stampGroup(&frame, LAN_STATS_FEES, s_stats.feesValid, s_stats.feesTimestamp, now);
+    stampGroup(&frame, LAN_STATS_POOL, s_stats.poolValid && s_wallet[0], s_stats.poolTimestamp, now);
+
+    frame.walletHash = lan_stats_wallet_hash(s_wallet);
+    frame.btcPriceUsd = s_stats.btcPriceUsd;
+    frame.blockHeight = s_stats.blockHeight;
+    frame.networkHashrate = s_stats.networkHashrateRaw;
+    frame.difficulty = s_stats.difficultyRaw;
+    frame.difficultyProgress = s_stats.difficultyProgress;
+    frame.difficultyChange = s_stats.difficultyChange;
+    frame.fees[0] = feeField(s_stats.fastestFee);
+    frame.fees[1] = feeField(s_stats.halfHourFee);
+    frame.fees[2] = feeField(s_stats.hourFee);
+    frame.fees[3] = feeField(s_stats.economyFee);
+    frame.fees[4] = feeField(s_stats.minimumFee);
+    frame.poolWorkers = s_stats.poolWorkersCount;
+    memcpy(frame.poolHashrate, s_stats.poolTotalHashrate, sizeof(frame.poolHashrate));
+    memcpy(frame.poolBestDifficulty, s_stats.poolBestDifficulty, sizeof(frame.poolBestDifficulty));
+    xSemaphoreGive(s_statsMutex);
+
+    if (!lan_stats_send(&frame, now)) logError("LAN publish", 0);
+}
+
 // ============================================================
 // API Updaters
 // ============================================================
@@ -539,14 +756,15 @@ static void updatePrice() {
     if (!s_proxyConfigured && !s_httpsEnabled) return;
     if (s_proxyConfigured && !s_proxyHealthy) return;
 
-    s_jsonDoc.clear();
-    if (fetchJson(API_BTC_PRICE, s_jsonDoc)) {
-        if (s_jsonDoc.containsKey("bitcoin")) {
+    s_jsonDoc->clear();
+    if (fetchJson(API_BTC_PRICE, *s_jsonDoc)) {
+        if (s_jsonDoc->containsKey("bitcoin")) {
             xSemaphoreTake(s_statsMutex, portMAX_DELAY);
-            s_stats.btcPriceUsd = s_jsonDoc["bitcoin"]["usd"];
+            s_stats.btcPriceUsd = (*s_jsonDoc)["bitcoin"]["usd"];
             s_stats.priceTimestamp = millis();
             s_stats.priceValid = true;
             xSemaphoreGive(s_statsMutex);
+            fetched(LAN_STATS_PRICE);
             Serial.printf("[STATS] BTC price updated: $%.0f\n", s_stats.btcPriceUsd);
         }
     }
@@ -557,40 +775,32 @@ static void updateBlockHeight() {
     WiFiClient client;
     client.setTimeout(5000);
 
-    HTTPClient http;
-    http.setUserAgent("SparkMiner/1.0");
-    http.setTimeout(5000);
+    if (fetchDirect(client, API_BLOCK_HEIGHT) > 0) {
+        uint32_t height = strtoul(s_body, NULL, 10);
 
-    if (http.begin(client, API_BLOCK_HEIGHT)) {
-        int httpCode = http.GET();
-
-        if (httpCode == HTTP_CODE_OK) {
-            String payload = http.getString();
-            uint32_t height = payload.toInt();
-
-            if (height > 0) {
-                xSemaphoreTake(s_statsMutex, portMAX_DELAY);
-                s_stats.blockHeight = height;
-                s_stats.blockTimestamp = millis();
-                s_stats.blockValid = true;
-                xSemaphoreGive(s_statsMutex);
-            }
+        if (height > 0) {
+            xSemaphoreTake(s_statsMutex, portMAX_DELAY);
+            s_stats.blockHeight = height;
+            s_stats.blockTimestamp = millis();
+            s_stats.blockValid = true;
+            xSemaphoreGive(s_statsMutex);
+            fetched(LAN_STATS_BLOCK);
         }
-        http.end();
     }
 }
 
 static void updateFees() {
     // HTTP API - always works
-    s_jsonDoc.clear();
-    if (fetchHttp(API_FEES, s_jsonDoc)) {
+    s_jsonDoc->clear();
+    if (fetchHttp(API_FEES, *s_jsonDoc)) {
         xSemaphoreTake(s_statsMutex, portMAX_DELAY);
-        s_stats.fastestFee = s_jsonDoc["fastestFee"];
-        s_stats.halfHourFee = s_jsonDoc["halfHourFee"];
-        s_stats.hourFee = s_jsonDoc["hourFee"];
+        s_stats.fastestFee = (*s_jsonDoc)["fastestFee"];
+        s_stats.halfHourFee = (*s_jsonDoc)["halfHourFee"];
+        s_stats.hourFee = (*s_jsonDoc)["hourFee"];
         s_stats.feesTimestamp = millis();
         s_stats.feesValid = true;
         xSemaphoreGive(s_statsMutex);
+        fetched(LAN_STATS_FEES);
     }
 }
 
@@ -606,12 +816,12 @@ static void updatePoolStats() {
     char url[256];
     snprintf(url, sizeof(url), "%s%s", API_PUBLIC_POOL, s_wallet);
 
-    s_jsonDoc.clear();
-    if (fetchJson(url, s_jsonDoc)) {
+    s_jsonDoc->clear();
+    if (fetchJson(url, *s_jsonDoc)) {
         xSemaphoreTake(s_statsMutex, portMAX_DELAY);
-        s_stats.poolWorkersCount = s_jsonDoc["workersCount"];
-        const char *hashrate = s_jsonDoc["hashrate"];
-        const char *bestDiff = s_jsonDoc["bestDifficulty"];
+        s_stats.poolWorkersCount = (*s_jsonDoc)["workersCount"];
+        const char *hashrate = (*s_jsonDoc)["hashrate"];
+        const char *bestDiff = (*s_jsonDoc)["bestDifficulty"];
         if (hashrate) {
             strncpy(s_stats.poolTotalHashrate, hashrate, sizeof(s_stats.poolTotalHashrate) - 1);
             s_stats.poolTotalHashrate[sizeof(s_stats.poolTotalHashrate) - 1] = '\0';
@@ -620,8 +830,10 @@ static void updatePoolStats() {
             strncpy(s_stats.poolBestDifficulty, bestDiff, sizeof(s_stats.poolBestDifficulty) - 1);
             s_stats.poolBestDifficulty[sizeof(s_stats.poolBestDifficulty) - 1] = '\0';
         }
+        s_stats.poolTimestamp = millis();
         s_stats.poolValid = true;
         xSemaphoreGive(s_statsMutex);
+        fetched(LAN_STATS_POOL);
         Serial.printf("[STATS] Pool stats updated: %d workers\n", s_stats.poolWorkersCount);
     }
 }
@@ -640,25 +852,22 @@ static void updateNetworkHashrate() {
     WiFiClient client;
     client.setTimeout(8000);
 
-    if (!client.connect(s_proxyHost, s_proxyPort)) {
+    if (!connectClient(client, s_proxyHost.c_str(), s_proxyPort)) {
         return;
     }
 
-    String targetHost = extractHostFromUrl(API_HASHRATE);
+    char targetHost[64];
+    extractHostFromUrl(API_HASHRATE, targetHost, sizeof(targetHost));
 
     // Build request
-    String request = "GET ";
-    request += API_HASHRATE;
-    request += " HTTP/1.1\r\nHost: ";
-    request += targetHost;
-    request += "\r\n";
-    if (s_proxyAuth[0]) {
-        request += "Proxy-Authorization: Basic ";
-        request += s_proxyAuth;
-        request += "\r\n";
+    s_request.printf("GET %s HTTP/1.1\r\nHost: %s\r\n", API_HASHRATE, targetHost);
+    appendProxyAuth();
+    s_request.append("Connection: close\r\n\r\n");
+    if (s_request.truncated()) {
+        client.stop();
+        return;
     }
-    request += "Connection: close\r\n\r\n";
-    client.print(request);
+    client.write((const uint8_t *)s_request.c_str(), s_request.length());
 
     // Wait for response
     uint32_t timeout = millis() + 10000;
@@ -672,15 +881,12 @@ static void updateNetworkHashrate() {
     }
 
     // Skip HTTP headers
-    while (client.connected() || client.available()) {
-        String line = client.readStringUntil('\n');
-        line.trim();
-        if (line.length() == 0) break;
+    while (readHeaderLine(client, 8000) > 0) {
     }
 
     // Parse JSON with filter (ignores hashrates array, saves memory)
-    s_jsonDoc.clear();
-    DeserializationError err = deserializeJson(s_jsonDoc, client, DeserializationOption::Filter(filter));
+    s_jsonDoc->clear();
+    DeserializationError err = deserializeJson(*s_jsonDoc, client, DeserializationOption::Filter(filter));
     client.stop();
 
     if (err) {
@@ -690,30 +896,17 @@ static void updateNetworkHashrate() {
 
     xSemaphoreTake(s_statsMutex, portMAX_DELAY);
 
-    // Parse hashrate (hashes/s)
-    double hashrate = s_jsonDoc["currentHashrate"] | 0.0;
-    if (hashrate > 0) {
-        s_stats.networkHashrateRaw = hashrate;
-
-        // Format hashrate string
-        if (hashrate > 1e18) {
-            snprintf(s_stats.networkHashrate, sizeof(s_stats.networkHashrate), "%.2f EH/s", hashrate / 1e18);
-        } else if (hashrate > 1e15) {
-            snprintf(s_stats.networkHashrate, sizeof(s_stats.networkHashrate), "%.2f PH/s", hashrate / 1e15);
-        } else {
-            snprintf(s_stats.networkHashrate, sizeof(s_stats.networkHashrate), "%.2f TH/s", hashrate / 1e12);
-        }
-    }
-
-    // Get difficulty if available
-    double diff = s_jsonDoc["currentDifficulty"] | 0.0;
-    if (diff > 0) {
-        s_stats.difficultyRaw = diff;
-        snprintf(s_stats.networkDifficulty, sizeof(s_stats.networkDifficulty), "%.2f T", diff / 1e12);
-    }
+    // Hashrate (hashes/s) and difficulty if available
+    double hashrate = (*s_jsonDoc)["currentHashrate"] | 0.0;
+    if (hashrate > 0) s_stats.networkHashrateRaw = hashrate;
+    double diff = (*s_jsonDoc)["currentDifficulty"] | 0.0;
+    if (diff > 0) s_stats.difficultyRaw = diff;
+    formatNetworkStats();
 
+    s_stats.networkTimestamp = millis();
     s_stats.networkValid = true;
     xSemaphoreGive(s_statsMutex);
+    fetched(LAN_STATS_NETWORK);
     Serial.printf("[STATS] Network: %s, Diff: %s\n", s_stats.networkHashrate, s_stats.networkDifficulty);
 }
 
@@ -722,11 +915,11 @@ static void updateNetworkDifficulty() {
     if (!s_proxyConfigured && !s_httpsEnabled) return;
     if (s_proxyConfigured && !s_proxyHealthy) return;
 
-    s_jsonDoc.clear();
-    if (fetchJson(API_DIFFICULTY, s_jsonDoc)) {
+    s_jsonDoc->clear();
+    if (fetchJson(API_DIFFICULTY, *s_jsonDoc)) {
         xSemaphoreTake(s_statsMutex, portMAX_DELAY);
-        s_stats.difficultyProgress = s_jsonDoc["progressPercent"];
-        double change = s_jsonDoc["difficultyChange"]; // API returns float
+        s_stats.difficultyProgress = (*s_jsonDoc)["progressPercent"];
+        double change = (*s_jsonDoc)["difficultyChange"]; // API returns float
         s_stats.difficultyChange = (int32_t)change;
         xSemaphoreGive(s_statsMutex);
         Serial.printf("[STATS] Difficulty adj: %.1f%% progress, %.1f%% change\n", 
@@ -741,12 +934,16 @@ static void updateNetworkDifficulty() {
 void live_stats_init() {
     s_statsMutex = xSemaphoreCreateMutex();
 
+    s_jsonDoc = mem_place_new<stats_doc_t>("stats json");
+    s_body = (char *)mem_place_cold(STATS_BODY_MAX + 1, "stats http body");
+
     // Load proxy config
     miner_config_t *config = nvs_config_get();
     if (config->statsProxyUrl[0]) {
         parseProxyUrl(config->statsProxyUrl);
     }
     s_httpsEnabled = config->enableHttpsStats;
+    s_lanMode = config->lanStats;
 
     // Log configuration
     if (s_proxyConfigured) {
@@ -764,9 +961,12 @@ void live_stats_init() {
         STATS_STACK,
         NULL,
         STATS_PRIORITY,
-        NULL,
+        &s_task,
         STATS_CORE
     );
+
+    // Steady-state fetches stay off the heap too (stats/alloc_guard.h)
+    alloc_guard_watch(s_task);
 }
 
 const live_stats_t *live_stats_get() {
@@ -783,7 +983,12 @@ void live_stats_update() {
     // Triggered manually - task handles autonomous updates
 }
 
+void live_stats_reload() {
+    s_reloadPending = true;
+}
+
 void live_stats_force_update() {
+    s_shared = 0;
     s_lastPriceUpdate = 0;
     s_lastBlockUpdate = 0;
     s_lastFeesUpdate = 0;
@@ -791,12 +996,40 @@ void live_stats_force_update() {
     s_lastNetworkUpdate = 0;
 }
 
+// Re-read the stats settings after a live config change (stats task)
+static void reloadConfig() {
+    s_reloadPending = false;
+    miner_config_t *config = nvs_config_get();
+
+    if (!config->statsProxyUrl[0] || !parseProxyUrl(config->statsProxyUrl)) {
+        s_proxyConfigured = false;
+    }
+    s_proxyHealthy = true;
+    s_proxyFailCount = 0;
+    s_proxyMethod = 0;
+    s_httpsEnabled = config->enableHttpsStats;
+    live_stats_set_wallet(config->wallet);
+
+    if (config->lanStats != s_lanMode) {
+        // Leave the group now; the loop joins again in the new mode
+        static const uint8_t noMac[6] = {0};
+        if (s_lanStarted) lan_stats_begin(LAN_STATS_OFF, noMac);
+        s_lanStarted = false;
+        s_lanMode = config->lanStats;
+    }
+
+    live_stats_force_update();
+    Serial.println("[STATS] Settings reloaded");
+}
+
 void live_stats_task(void *param) {
     // Initial delay to let WiFi settle
     vTaskDelay(5000 / portTICK_PERIOD_MS);
 
-    // Force immediate first update by backdating timers
+    // Force immediate first update by backdating timers. With LAN sharing
+    // the first fetches wait one publish interval for a running publisher.
     uint32_t bootTime = millis();
+    if (s_lanMode != LAN_STATS_OFF) bootTime += LAN_STATS_PUBLISH_MS + 5000;
     s_lastBlockUpdate = bootTime - UPDATE_BLOCK_MS - 1000;
     s_lastFeesUpdate = bootTime - UPDATE_FEES_MS - 2000;
     s_lastPriceUpdate = bootTime - UPDATE_PRICE_MS - 3000;
@@ -806,20 +1039,34 @@ void live_stats_task(void *param) {
     Serial.println("[STATS] Task started");
 
     while (true) {
+        if (s_reloadPending) reloadConfig();
+
         if (WiFi.status() == WL_CONNECTED) {
             uint32_t now = millis();
 
+            // Shared stats from the LAN publisher
+            if (s_lanMode != LAN_STATS_OFF) {
+                if (!s_lanStarted) {
+                    uint8_t mac[6];
+                    WiFi.macAddress(mac);
+                    lan_stats_begin(s_lanMode, mac);
+                    s_lanStarted = true;
+                }
+                lan_stats_frame_t frame;
+                if (lan_stats_poll(now, &frame)) applyFrame(&frame, now);
+            }
+
             // Check proxy health periodically
             checkProxyHealth();
 
             // Stagger updates with generous yields
-            if (now - s_lastBlockUpdate > UPDATE_BLOCK_MS) {
+            if (due(now, s_lastBlockUpdate, UPDATE_BLOCK_MS, LAN_STATS_BLOCK)) {
                 updateBlockHeight();
                 s_lastBlockUpdate = millis();
                 vTaskDelay(500 / portTICK_PERIOD_MS);
             }
 
-            if (now - s_lastFeesUpdate > UPDATE_FEES_MS) {
+            if (due(now, s_lastFeesUpdate, UPDATE_FEES_MS, LAN_STATS_FEES)) {
                 updateFees();
                 s_lastFeesUpdate = millis();
                 vTaskDelay(500 / portTICK_PERIOD_MS);
@@ -827,19 +1074,19 @@ void live_stats_task(void *param) {
 
             // HTTPS APIs (only if proxy or direct HTTPS enabled)
             if (s_proxyConfigured || s_httpsEnabled) {
-                if (now - s_lastPriceUpdate > UPDATE_PRICE_MS) {
+                if (due(now, s_lastPriceUpdate, UPDATE_PRICE_MS, LAN_STATS_PRICE)) {
                     updatePrice();
                     s_lastPriceUpdate = millis();
                     vTaskDelay(500 / portTICK_PERIOD_MS);
                 }
 
-                if (now - s_lastPoolUpdate > UPDATE_POOL_MS) {
+                if (due(now, s_lastPoolUpdate, UPDATE_POOL_MS, LAN_STATS_POOL)) {
                     updatePoolStats();
                     s_lastPoolUpdate = millis();
                     vTaskDelay(500 / portTICK_PERIOD_MS);
                 }
 
-                if (now - s_lastNetworkUpdate > UPDATE_NETWORK_MS) {
+                if (due(now, s_lastNetworkUpdate, UPDATE_NETWORK_MS, LAN_STATS_NETWORK)) {
                     updateNetworkHashrate();
                     vTaskDelay(500 / portTICK_PERIOD_MS);
                     updateNetworkDifficulty();
@@ -847,6 +1094,10 @@ void live_stats_task(void *param) {
                     vTaskDelay(500 / portTICK_PERIOD_MS);
                 }
             }
+
+            if (s_lanStarted && lan_stats_publish_due(millis())) {
+                publishFrame(millis());
+            }
         }
 
         // Yield to let other tasks run
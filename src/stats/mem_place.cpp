@@ -0,0 +1,106 @@
+/*
+ * SparkMiner - Buffer Placement Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "mem_place.h"
+
+#if !defined(HOST_BUILD)
+    #include <esp_heap_caps.h>
+
+    // DRAM segment bounds from the IDF linker script
+    extern int _data_start, _data_end, _bss_start, _bss_end;
+#endif
+
+#define MEM_PLACE_MAX   16
+
+typedef struct {
+    const char *name;
+    size_t size;
+    bool psram;
+} placement_t;
+
+static placement_t s_placed[MEM_PLACE_MAX];
+static int s_placedCount = 0;
+
+// ============================================================
+// Allocation
+// ============================================================
+
+static void *allocate(size_t size, bool *psram) {
+    *psram = false;
+
+    #if defined(HOST_BUILD)
+        return calloc(1, size);
+    #else
+        #if MEM_PSRAM_BUFFERS
+            if (psramFound()) {
+                void *ptr = heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+                if (ptr) {
+                    *psram = true;
+                    return ptr;
+                }
+            }
+        #endif
+        return heap_caps_calloc(1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    #endif
+}
+
+void *mem_place_cold(size_t size, const char *name) {
+    bool psram;
+    void *ptr = allocate(size, &psram);
+    if (!ptr) {
+        Serial.printf("[MEM] FATAL: No room for %s (%u bytes)\n", name, (unsigned)size);
+        Serial.flush();
+        abort();
+    }
+
+    if (s_placedCount < MEM_PLACE_MAX) {
+        s_placed[s_placedCount].name = name;
+        s_placed[s_placedCount].size = size;
+        s_placed[s_placedCount].psram = psram;
+        s_placedCount++;
+    }
+    return ptr;
+}
+
+// ============================================================
+// Boot Memory Map
+// ============================================================
+
+void mem_place_report() {
+    size_t inPsram = 0, internal = 0;
+
+    Serial.printf("[MEM] Cold buffers (%s):\n",
+                  MEM_PSRAM_BUFFERS ? "PSRAM when present" : "internal, MEM_PSRAM_BUFFERS=0");
+    for (int i = 0; i < s_placedCount; i++) {
+        const placement_t *p = &s_placed[i];
+        Serial.printf("[MEM]   %-16s %6u B  %s\n", p->name, (unsigned)p->size,
+                      p->psram ? "PSRAM" : "internal");
+        if (p->psram) inPsram += p->size;
+        else internal += p->size;
+    }
+
+    #if !defined(HOST_BUILD)
+        size_t dataSize = (size_t)((char *)&_data_end - (char *)&_data_start);
+        size_t bssSize = (size_t)((char *)&_bss_end - (char *)&_bss_start);
+        Serial.printf("[MEM] DRAM static: .data %u B, .bss %u B\n", (unsigned)dataSize, (unsigned)bssSize);
+        Serial.printf("[MEM] Internal heap: %u B free, %u B largest block, %u B min free\n",
+                      (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+                      (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+                      (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+        if (psramFound()) {
+            Serial.printf("[MEM] PSRAM: %u B free of %u B\n",
+                          (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+                          (unsigned)heap_caps_get_total_size(MALLOC_CAP_SPIRAM));
+        } else {
+            Serial.println("[MEM] PSRAM: not found");
+        }
+    #endif
+
+    Serial.printf("[MEM] Internal DRAM freed by PSRAM placement: %u B (%u B of cold buffers internal)\n",
+                  (unsigned)inPsram, (unsigned)internal);
+}
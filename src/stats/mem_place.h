@@ -0,0 +1,46 @@
+/*
+ * SparkMiner - Buffer Placement
+ * Puts large, rarely touched buffers in PSRAM on boards that have it
+ *
+ * Internal DRAM is what WiFi, lwIP and TLS draw from under load, so
+ * buffers that are big and touched a few times a minute (JSON documents,
+ * the stratum line buffer, the HTTP arena, portal HTML) are allocated
+ * once at init through mem_place_cold() instead of living in .bss.
+ * With MEM_PSRAM_BUFFERS=1 (default on BOARD_HAS_PSRAM boards) they go
+ * to PSRAM when it was found at boot, otherwise to internal RAM.
+ *
+ * Hot mining data (jobs, midstates, SHA buffers, the glyph cache) stays
+ * in .bss and is never routed through here.
+ *
+ * GPL v3 License
+ */
+
+#ifndef MEM_PLACE_H
+#define MEM_PLACE_H
+
+#include <Arduino.h>
+#include <new>
+#include <board_config.h>
+
+/**
+ * Allocate a zeroed cold buffer for the lifetime of the program
+ * Never returns NULL: failing to place a boot-time buffer is fatal.
+ * @param size  Bytes
+ * @param name  Label for the boot memory map
+ */
+void *mem_place_cold(size_t size, const char *name);
+
+/**
+ * Construct a T in a cold buffer (for JSON documents and other classes)
+ */
+template <typename T>
+T *mem_place_new(const char *name) {
+    return new (mem_place_cold(sizeof(T), name)) T();
+}
+
+/**
+ * Print the placed buffers and internal DRAM / PSRAM headroom
+ */
+void mem_place_report();
+
+#endif // MEM_PLACE_H
@@ -1,6 +1,6 @@
 /*
  * SparkMiner - Monitor Task Implementation
- * Coordinates display updates and live stats fetching
+ * Coordinates display snapshots, LED status and stats persistence
  */
 
 #include <Arduino.h>
@@ -8,7 +8,12 @@
 #include <board_config.h>
 #include "monitor.h"
 #include "live_stats.h"
+#include "history.h"
+#include "alloc_guard.h"
+#include "heap_track.h"
+#include "telemetry.h"
 #include "../display/display.h"
+#include "../display/display_task.h"
 #include "../display/led_status.h"
 #include "../mining/miner.h"
 #include "../stratum/stratum.h"
@@ -16,19 +21,21 @@
 #include "../config/wifi_manager.h"
 
 // Update intervals
-#define DISPLAY_UPDATE_MS   1000    // 1 second
+#define DISPLAY_UPDATE_MS   DISPLAY_FRAME_MS  // Snapshot rate = display frame rate
 #define STATS_UPDATE_MS     10000   // 10 seconds
 #define PERSIST_STATS_MS    3600000 // 1 hour - save to flash for persistence
 #define EARLY_SAVE_MS       300000  // 5 minutes - initial save interval before first hourly
-#define LED_UPDATE_MS       50      // 50ms for smooth LED animations
+#define MONITOR_MIN_SLEEP_MS 10     // Floor for the deadline-based sleep
 
 static bool s_initialized = false;
 static uint32_t s_lastDisplayUpdate = 0;
 static uint32_t s_lastStatsUpdate = 0;
 static uint32_t s_lastPersistSave = 0;
-static uint32_t s_lastLedUpdate = 0;
+static uint32_t s_lastHistorySample = 0;
+static uint64_t s_lastHistoryHashes = 0;
 static uint32_t s_startTime = 0;
 static bool s_earlySaveDone = false;      // Track if we've done the early save
+static volatile bool s_saveRequested = false;  // monitor_request_save(), e.g. before an OTA reboot
 static uint32_t s_lastAcceptedCount = 0;  // Track shares for first-share save
 static uint32_t s_lastLedShareCount = 0;  // Track shares for LED flash
 
@@ -39,10 +46,75 @@ static uint32_t s_sessionStartAccepted = 0;
 static uint32_t s_sessionStartRejected = 0;
 static uint32_t s_sessionStartBlocks = 0;
 
+#if ALLOC_GUARD
+static uint32_t s_firstJobTime = 0;       // When mining started (0 = no job yet)
+static uint32_t s_allocReported = 0;      // Tripwire hits already printed
+#endif
+
+#if HEAP_TRACK
+static uint32_t s_lastHeapReport = 0;
+#endif
+
 // ============================================================
 // Helper Functions
 // ============================================================
 
+// Time left until a periodic job is due (0 if overdue)
+static uint32_t msUntil(uint32_t now, uint32_t last, uint32_t interval) {
+    uint32_t elapsed = now - last;
+    return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+#if ALLOC_GUARD
+// Arm the allocation tripwire once mining has warmed up; print new hits
+static void checkAllocGuard(uint32_t now) {
+    if (!alloc_guard_armed()) {
+        if (miner_get_stats()->templates == 0) return;
+        if (s_firstJobTime == 0) s_firstJobTime = now;
+        if (now - s_firstJobTime >= ALLOC_GUARD_WARMUP_MS) alloc_guard_arm();
+        return;
+    }
+
+    uint32_t count = alloc_guard_count();
+    if (count != s_allocReported) {
+        alloc_guard_report();
+        s_allocReported = count;
+    }
+}
+#endif
+
+#ifdef USE_LED_STATUS
+// Map connection state to an LED status; only changes reach the hardware
+static void updateLedStatus(const display_data_t *data) {
+    if (!data->wifiConnected) {
+        // Check if in AP mode
+        if (WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA) {
+            led_status_set(LED_STATUS_AP_MODE);
+        } else {
+            led_status_set(LED_STATUS_CONNECTING);
+        }
+    } else if (!data->poolConnected) {
+        led_status_set(LED_STATUS_CONNECTING);
+    } else if (data->hashRate > 0) {
+        led_status_set(LED_STATUS_MINING);
+    }
+
+    // Check for new share accepted - flash LED
+    mining_stats_t *ledStats = miner_get_stats();
+    if (ledStats->accepted > s_lastLedShareCount) {
+        led_status_share_found();
+        s_lastLedShareCount = ledStats->accepted;
+    }
+
+    // Check for block found - celebration!
+    static uint32_t lastBlockCount = 0;
+    if (ledStats->blocks > lastBlockCount) {
+        led_status_block_found();
+        lastBlockCount = ledStats->blocks;
+    }
+}
+#endif
+
 static void updateDisplayData(display_data_t *data) {
     // Get mining stats (current session)
     mining_stats_t *mstats = miner_get_stats();
@@ -152,6 +224,9 @@ void monitor_init() {
     // Initialize live stats
     live_stats_init();
 
+    // Fleet telemetry push (no-op unless a target is configured)
+    telemetry_init();
+
     // Initialize LED status driver (for headless builds with RGB LED)
     #ifdef USE_LED_STATUS
         led_status_init();
@@ -171,6 +246,9 @@ void monitor_init() {
 
     // Note: display_init() is now called earlier in main.cpp
     // (before WiFi setup, so we can show AP config screen)
+    #if USE_DISPLAY || USE_OLED_DISPLAY
+        display_task_init();
+    #endif
 
     s_startTime = millis();
     s_lastPersistSave = millis();
@@ -195,37 +273,66 @@ void monitor_task(void *param) {
         // Update live stats periodically
         if (now - s_lastStatsUpdate >= STATS_UPDATE_MS) {
             live_stats_update();
+            telemetry_sample(now, displayData.hashRate);
             s_lastStatsUpdate = now;
         }
 
+        // Record a history sample (raw interval rate, not the display EMA)
+        if (now - s_lastHistorySample >= HISTORY_INTERVAL_MS) {
+            uint64_t hashes = miner_get_stats()->hashes;
+            if (s_lastHistorySample != 0) {
+                float rate = (float)(hashes - s_lastHistoryHashes) * 1000.0f / (now - s_lastHistorySample);
+                history_push(rate, temperatureRead());
+            }
+            s_lastHistoryHashes = hashes;
+            s_lastHistorySample = now;
+        }
+
         // Update display
         if (now - s_lastDisplayUpdate >= DISPLAY_UPDATE_MS) {
             updateDisplayData(&displayData);
+            displayData.historySeq = history_seq();
 
-            #if USE_DISPLAY
-                display_update(&displayData);
+            // Hand the snapshot to the display task (never blocks on rendering)
+            #if USE_DISPLAY || USE_OLED_DISPLAY
+                display_task_publish(&displayData);
+            #endif
 
-                // Check for touch input
-                if (display_touched()) {
-                    display_handle_touch();
-                }
+            // LED status follows the snapshot
+            #ifdef USE_LED_STATUS
+                updateLedStatus(&displayData);
             #endif
 
             // Also print to serial for headless/debug
             static uint32_t lastSerialPrint = 0;
             if (now - lastSerialPrint >= 10000) {
-                Serial.printf("[STATS] Hashrate: %.2f H/s | Shares: %u/%u | Ping: %u ms | Best: %.4f\n",
+                // Long lines go through a local buffer, not Serial.printf's heap copy
+                char line[128];
+                snprintf(line, sizeof(line), "[STATS] Hashrate: %.2f H/s | Shares: %u/%u | Ping: %u ms | Best: %.4f\n",
                     displayData.hashRate,
                     displayData.sharesAccepted,
                     displayData.sharesAccepted + displayData.sharesRejected,
                     displayData.avgLatency,
                     displayData.bestDifficulty);
+                Serial.print(line);
+
+                // Core 0 (software SHA) share over the print interval, to
+                // compare kernel builds (-O level, IRAM placement) on a board
+                static uint64_t lastCore0Hashes = 0;
+                uint64_t core0Hashes = miner_get_stats()->hashesCore0;
+                if (lastSerialPrint != 0 && core0Hashes != lastCore0Hashes) {
+                    snprintf(line, sizeof(line), "[STATS] Core 0: %.2f H/s\n",
+                        (double)(core0Hashes - lastCore0Hashes) * 1000.0 / (now - lastSerialPrint));
+                    Serial.print(line);
+                }
+                lastCore0Hashes = core0Hashes;
 
                 if (displayData.btcPrice > 0) {
-                    Serial.printf("[STATS] BTC: $%.0f | Block: %u | Fee: %d sat/vB\n",
+                    snprintf(line, sizeof(line), "[STATS] BTC: $%.0f | Block: %u | Fee: %d sat/vB\n",
                         displayData.btcPrice,
                         displayData.blockHeight,
                         displayData.halfHourFee);
+                    Serial.print(line);
                 }
 
                 // Heap monitoring - track memory usage over time
@@ -244,50 +351,23 @@ void monitor_task(void *param) {
                     Serial.println("[HEAP] WARNING: Memory getting low");
                 }
 
-                lastSerialPrint = now;
-            }
-
-            s_lastDisplayUpdate = now;
-        }
-
-        // Update LED status for headless builds
-        #ifdef USE_LED_STATUS
-        if (now - s_lastLedUpdate >= LED_UPDATE_MS) {
-            // Determine current status based on connection state
-            if (!displayData.wifiConnected) {
-                // Check if in AP mode
-                if (WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA) {
-                    led_status_set(LED_STATUS_AP_MODE);
-                } else {
-                    led_status_set(LED_STATUS_CONNECTING);
-                }
-            } else if (!displayData.poolConnected) {
-                led_status_set(LED_STATUS_CONNECTING);
-            } else if (displayData.hashRate > 0) {
-                led_status_set(LED_STATUS_MINING);
-            }
+                #if ALLOC_GUARD
+                    checkAllocGuard(now);
+                #endif
 
-            // Check for new share accepted - flash LED
-            mining_stats_t *ledStats = miner_get_stats();
-            if (ledStats->accepted > s_lastLedShareCount) {
-                led_status_share_found();
-                s_lastLedShareCount = ledStats->accepted;
-            }
+                #if HEAP_TRACK
+                    heap_track_sample(now);
+                    if (now - s_lastHeapReport >= HEAP_TRACK_REPORT_MS) {
+                        heap_track_report();
+                        s_lastHeapReport = now;
+                    }
+                #endif
 
-            // Check for block found - celebration!
-            if (ledStats->blocks > 0) {
-                static uint32_t lastBlockCount = 0;
-                if (ledStats->blocks > lastBlockCount) {
-                    led_status_block_found();
-                    lastBlockCount = ledStats->blocks;
-                }
+                lastSerialPrint = now;
             }
 
-            // Update LED animation
-            led_status_update();
-            s_lastLedUpdate = now;
+            s_lastDisplayUpdate = now;
         }
-        #endif
 
         // Persistence save logic with early save for new sessions
         // - Save on first accepted share (immediate feedback)
@@ -314,6 +394,12 @@ void monitor_task(void *param) {
             }
         }
 
+        bool requested = s_saveRequested;
+        if (requested) {
+            shouldSave = true;
+            saveReason = "requested";
+        }
+
         if (shouldSave) {
             uint32_t sessionSeconds = (now - s_startTime) / 1000;
 
@@ -324,10 +410,12 @@ void monitor_task(void *param) {
             uint32_t sessionRejected = mstats->rejected - s_sessionStartRejected;
             uint32_t sessionBlocks = mstats->blocks - s_sessionStartBlocks;
 
-            // Update persistent stats
+            // Update persistent stats (NVS allocates internally on commit)
+            alloc_guard_exempt_begin();
             nvs_stats_update(sessionHashes, sessionShares, sessionAccepted,
                             sessionRejected, sessionBlocks, sessionSeconds,
                             mstats->bestDifficulty);
+            alloc_guard_exempt_end();
 
             // Update session start values for next delta calculation
             s_sessionStartHashes = mstats->hashes;
@@ -338,8 +426,25 @@ void monitor_task(void *param) {
 
             Serial.printf("[MONITOR] Stats saved to NVS (%s)\n", saveReason);
             s_lastPersistSave = now;
+            if (requested) s_saveRequested = false;
         }
 
-        vTaskDelay(100 / portTICK_PERIOD_MS);
+        // Sleep until the next periodic job is due
+        now = millis();
+        uint32_t sleepMs = msUntil(now, s_lastDisplayUpdate, DISPLAY_UPDATE_MS);
+        uint32_t historyMs = msUntil(now, s_lastHistorySample, HISTORY_INTERVAL_MS);
+        uint32_t statsMs = msUntil(now, s_lastStatsUpdate, STATS_UPDATE_MS);
+        if (historyMs < sleepMs) sleepMs = historyMs;
+        if (statsMs < sleepMs) sleepMs = statsMs;
+        if (sleepMs < MONITOR_MIN_SLEEP_MS) sleepMs = MONITOR_MIN_SLEEP_MS;
+        vTaskDelay(pdMS_TO_TICKS(sleepMs));
     }
 }
+
+void monitor_request_save() {
+    s_saveRequested = true;
+}
+
+bool monitor_save_pending() {
+    return s_saveRequested;
+}
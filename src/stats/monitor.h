@@ -1,6 +1,6 @@
 /*
  * SparkMiner - Monitor Task
- * Coordinates display updates and live stats fetching
+ * Coordinates display snapshots, LED status and stats persistence
  */
 
 #ifndef MONITOR_H
@@ -19,4 +19,15 @@ void monitor_init();
  */
 void monitor_task(void *param);
 
+/**
+ * Save session stats to NVS on the monitor's next pass instead of waiting
+ * for the hourly save (used before a planned restart)
+ */
+void monitor_request_save();
+
+/**
+ * @return true until a requested save has been written
+ */
+bool monitor_save_pending();
+
 #endif // MONITOR_H
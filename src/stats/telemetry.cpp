@@ -0,0 +1,450 @@
+/*
+ * SparkMiner - Telemetry Publisher Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <board_config.h>
+#include <fixed_string.h>
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "history.h"
+#include "mem_place.h"
+#include "alloc_guard.h"
+#include "../mining/miner.h"
+#include "../stratum/stratum.h"
+#include "../config/nvs_config.h"
+
+#define TELEMETRY_QUEUE         32      // Samples kept while the collector is away (~5 min)
+#define TELEMETRY_POLL_MS       1000
+#define TELEMETRY_FRAMES_PER_WAKE 4     // Catch up a backlog without hogging the task
+#define TELEMETRY_UDP_PORT      9100
+#define TELEMETRY_MQTT_PORT     1883
+#define TELEMETRY_TOPIC_DEFAULT "sparkminer"
+#define TELEMETRY_CONNECT_MS    3000
+#define TELEMETRY_BACKOFF_MAX_MS 300000
+
+// Room before the payload for the MQTT fixed header, topic and MAC suffix
+#define MQTT_HEADROOM           (5 + 2 + 63 + 13)
+#define MQTT_KEEPALIVE_S        120
+
+typedef enum {
+    TRANSPORT_OFF = 0,
+    TRANSPORT_UDP,
+    TRANSPORT_MQTT
+} transport_t;
+
+typedef struct {
+    transport_t transport;
+    bool json;
+    char host[64];
+    uint16_t port;
+    char user[32];
+    char pass[32];
+    char topic[64];             // MQTT topic prefix
+    uint32_t intervalMs;
+} target_t;
+
+typedef struct {
+    telemetry_sample_t queue[TELEMETRY_QUEUE];
+    telemetry_sample_t batch[TELEMETRY_BATCH_MAX];
+    uint8_t frame[MQTT_HEADROOM + TELEMETRY_FRAME_MAX + 1];
+} telemetry_buffers_t;
+
+static portMUX_TYPE s_telemetryMux = portMUX_INITIALIZER_UNLOCKED;
+static telemetry_buffers_t *s_buf = NULL;       // Placed when first configured
+static target_t s_target;
+static volatile uint32_t s_targetGen = 0;       // Bumped on every configure
+static bool s_taskStarted = false;
+
+// Queue positions count samples since boot; queued = pushed - popped
+static uint32_t s_pushed = 0;
+static uint32_t s_popped = 0;
+static telemetry_stats_t s_stats;
+
+// Publisher task state
+static WiFiClient s_mqtt;
+static WiFiUDP s_udp;
+static telemetry_header_t s_header;
+static uint32_t s_lastMqttTx = 0;
+
+// ============================================================
+// Target URL
+// ============================================================
+
+static bool copyPart(StringView part, char *dest, size_t size) {
+    return part.copyTo(dest, size);
+}
+
+// Fixed-width header field: cut to size, NUL padded, not necessarily terminated
+static void copyPadded(char *dest, size_t size, const char *src) {
+    size_t len = strnlen(src, size);
+    memset(dest, 0, size);
+    memcpy(dest, src, len);
+}
+
+static bool parseUrl(const char *url, target_t *t) {
+    memset(t, 0, sizeof(*t));
+    StringView rest = StringView(url).trim();
+
+    if (rest.startsWith("udp://")) {
+        t->transport = TRANSPORT_UDP;
+        t->port = TELEMETRY_UDP_PORT;
+        rest = rest.substr(6);
+    } else if (rest.startsWith("mqtt://")) {
+        t->transport = TRANSPORT_MQTT;
+        t->port = TELEMETRY_MQTT_PORT;
+        rest = rest.substr(7);
+    } else {
+        return false;
+    }
+
+    size_t q = rest.find('?');
+    if (q != StringView::npos) {
+        StringView query = rest.substr(q + 1);
+        if (query == "format=json") t->json = true;
+        else if (query != "format=bin") return false;
+        rest = rest.substr(0, q);
+    }
+
+    size_t slash = rest.find('/');
+    StringView topic = slash != StringView::npos ? rest.substr(slash + 1) : StringView();
+    if (topic.empty()) topic = TELEMETRY_TOPIC_DEFAULT;
+    if (!copyPart(topic, t->topic, sizeof(t->topic))) return false;
+    rest = rest.substr(0, slash);
+
+    size_t at = rest.find('@');
+    if (at != StringView::npos) {
+        StringView creds = rest.substr(0, at);
+        size_t colon = creds.find(':');
+        if (!copyPart(creds.substr(0, colon), t->user, sizeof(t->user))) return false;
+        if (colon != StringView::npos && !copyPart(creds.substr(colon + 1), t->pass, sizeof(t->pass))) return false;
+        rest = rest.substr(at + 1);
+    }
+
+    size_t colon = rest.find(':');
+    if (colon != StringView::npos) {
+        char port[8];
+        if (!copyPart(rest.substr(colon + 1), port, sizeof(port))) return false;
+        int value = atoi(port);
+        if (value <= 0 || value > 65535) return false;
+        t->port = (uint16_t)value;
+    }
+    return copyPart(rest.substr(0, colon), t->host, sizeof(t->host)) && t->host[0];
+}
+
+// ============================================================
+// MQTT 3.1.1 (CONNECT, QoS 0 PUBLISH, PINGREQ - all the publisher needs)
+// ============================================================
+
+// Remaining Length varint; returns bytes written (max 4)
+static int mqttLength(uint8_t *out, uint32_t len) {
+    int n = 0;
+    do {
+        uint8_t b = len % 128;
+        len /= 128;
+        out[n++] = b | (len ? 0x80 : 0);
+    } while (len && n < 4);
+    return n;
+}
+
+static void mqttString(FixedString<200> &pkt, const char *s) {
+    size_t len = strlen(s);
+    pkt.append((char)(len >> 8)).append((char)(len & 0xFF)).append(s, len);
+}
+
+static bool mqttConnect(const target_t *t) {
+    // The socket and its receive buffer are the SDK's allocations
+    alloc_guard_exempt_begin();
+    bool connected = s_mqtt.connect(t->host, t->port, TELEMETRY_CONNECT_MS);
+    alloc_guard_exempt_end();
+    if (!connected) return false;
+
+    char clientId[24];
+    snprintf(clientId, sizeof(clientId), "sparkminer-%02x%02x%02x",
+             s_header.mac[3], s_header.mac[4], s_header.mac[5]);
+
+    // Variable header and payload; the fixed header goes in front below
+    FixedString<200> body;
+    uint8_t flags = 0x02;                       // Clean session
+    if (t->user[0]) flags |= 0x80;
+    if (t->pass[0]) flags |= 0x40;
+    mqttString(body, "MQTT");
+    body.append((char)4).append((char)flags);
+    body.append((char)(MQTT_KEEPALIVE_S >> 8)).append((char)(MQTT_KEEPALIVE_S & 0xFF));
+    mqttString(body, clientId);
+    if (t->user[0]) mqttString(body, t->user);
+    if (t->pass[0]) mqttString(body, t->pass);
+    if (body.truncated()) return false;
+
+    uint8_t head[5] = { 0x10 };
+    int headLen = 1 + mqttLength(head + 1, body.length());
+    if (s_mqtt.write(head, headLen) != (size_t)headLen ||
+        s_mqtt.write((const uint8_t *)body.c_str(), body.length()) != body.length()) {
+        s_mqtt.stop();
+        return false;
+    }
+
+    // CONNACK: 20 02 <session present> <return code>
+    uint8_t ack[4];
+    int got = 0;
+    uint32_t start = millis();
+    while (got < 4 && millis() - start < TELEMETRY_CONNECT_MS) {
+        int c = s_mqtt.read();
+        if (c >= 0) ack[got++] = (uint8_t)c;
+        else if (!s_mqtt.connected()) break;
+        else delay(10);
+    }
+    if (got < 4 || ack[0] != 0x20 || ack[3] != 0) {
+        Serial.printf("[TELEMETRY] MQTT broker refused connection (code %d)\n", got == 4 ? ack[3] : -1);
+        s_mqtt.stop();
+        return false;
+    }
+
+    s_lastMqttTx = millis();
+    s_stats.connects++;
+    Serial.printf("[TELEMETRY] MQTT connected to %s:%u\n", t->host, t->port);
+    return true;
+}
+
+// Payload sits at s_buf->frame + MQTT_HEADROOM; the header is written just before it
+static bool mqttPublish(const target_t *t, size_t payloadLen) {
+    char topic[sizeof(t->topic) + 13];
+    snprintf(topic, sizeof(topic), "%s/%02x%02x%02x%02x%02x%02x", t->topic,
+             s_header.mac[0], s_header.mac[1], s_header.mac[2],
+             s_header.mac[3], s_header.mac[4], s_header.mac[5]);
+    size_t topicLen = strlen(topic);
+
+    uint8_t *payload = s_buf->frame + MQTT_HEADROOM;
+    uint8_t *p = payload - topicLen - 2;
+    p[0] = (uint8_t)(topicLen >> 8);
+    p[1] = (uint8_t)(topicLen & 0xFF);
+    memcpy(p + 2, topic, topicLen);
+
+    uint8_t head[5] = { 0x30 };                 // PUBLISH, QoS 0
+    int headLen = 1 + mqttLength(head + 1, 2 + topicLen + payloadLen);
+    p -= headLen;
+    memcpy(p, head, headLen);
+
+    size_t total = (payload + payloadLen) - p;
+    if (s_mqtt.write(p, total) != total) {
+        s_mqtt.stop();
+        return false;
+    }
+    s_lastMqttTx = millis();
+    return true;
+}
+
+// Drop whatever the broker sends (PINGRESP) and keep the session alive
+static void mqttService() {
+    if (!s_mqtt.connected()) return;
+    while (s_mqtt.available() > 0) s_mqtt.read();
+
+    if (millis() - s_lastMqttTx >= MQTT_KEEPALIVE_S * 1000UL / 2) {
+        static const uint8_t ping[2] = { 0xC0, 0x00 };
+        if (s_mqtt.write(ping, 2) != 2) s_mqtt.stop();
+        s_lastMqttTx = millis();
+    }
+}
+
+// ============================================================
+// Sending
+// ============================================================
+
+// Encode the oldest queued samples into s_buf->frame; 0 when the queue is empty
+static size_t encodeFrame(const target_t *t, uint32_t *first, int *used) {
+    portENTER_CRITICAL(&s_telemetryMux);
+    int n = (int)(s_pushed - s_popped);
+    if (n > TELEMETRY_BATCH_MAX) n = TELEMETRY_BATCH_MAX;
+    *first = s_popped;
+    for (int i = 0; i < n; i++) {
+        s_buf->batch[i] = s_buf->queue[(s_popped + i) % TELEMETRY_QUEUE];
+    }
+    s_header.dropped = s_stats.samplesDropped;
+    portEXIT_CRITICAL(&s_telemetryMux);
+
+    *used = 0;
+    if (n == 0) return 0;
+
+    uint8_t *out = s_buf->frame + MQTT_HEADROOM;
+    if (t->json) {
+        return telemetry_frame_json(&s_header, s_buf->batch, n, (char *)out, TELEMETRY_FRAME_MAX + 1, used);
+    }
+    return telemetry_frame_bin(&s_header, s_buf->batch, n, out, TELEMETRY_FRAME_MAX, used);
+}
+
+static bool sendFrame(const target_t *t, size_t len) {
+    if (t->transport == TRANSPORT_UDP) {
+        // Resolving the host and the datagram buffer are the SDK's allocations
+        alloc_guard_exempt_begin();
+        bool sent = s_udp.beginPacket(t->host, t->port);
+        if (sent) {
+            s_udp.write(s_buf->frame + MQTT_HEADROOM, len);
+            sent = s_udp.endPacket() == 1;
+        }
+        alloc_guard_exempt_end();
+        return sent;
+    }
+
+    if (!s_mqtt.connected() && !mqttConnect(t)) return false;
+    return mqttPublish(t, len);
+}
+
+// Send up to a few frames; false on the first failure
+static bool flush(const target_t *t) {
+    for (int i = 0; i < TELEMETRY_FRAMES_PER_WAKE; i++) {
+        uint32_t first;
+        int used;
+        size_t len = encodeFrame(t, &first, &used);
+        if (len == 0) return true;
+
+        if (!sendFrame(t, len)) return false;
+
+        // Samples dropped while sending already moved s_popped past some of these
+        portENTER_CRITICAL(&s_telemetryMux);
+        if ((int32_t)(first + used - s_popped) > 0) s_popped = first + used;
+        s_stats.framesSent++;
+        s_stats.samplesSent += used;
+        portEXIT_CRITICAL(&s_telemetryMux);
+        s_header.seq++;
+    }
+    return true;
+}
+
+static void telemetry_task(void *param) {
+    uint32_t gen = 0;
+    uint32_t lastAttempt = 0;
+    uint32_t failures = 0;
+    target_t target;
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(TELEMETRY_POLL_MS));
+
+        if (gen != s_targetGen) {
+            portENTER_CRITICAL(&s_telemetryMux);
+            target = s_target;
+            gen = s_targetGen;
+            portEXIT_CRITICAL(&s_telemetryMux);
+            s_mqtt.stop();
+            failures = 0;
+        }
+        if (target.transport == TRANSPORT_OFF || WiFi.status() != WL_CONNECTED) continue;
+
+        if (target.transport == TRANSPORT_MQTT) mqttService();
+
+        // Back off 2x per failed attempt, capped
+        uint32_t wait = target.intervalMs;
+        for (uint32_t i = 0; i < failures && wait < TELEMETRY_BACKOFF_MAX_MS; i++) wait *= 2;
+        if (wait > TELEMETRY_BACKOFF_MAX_MS) wait = TELEMETRY_BACKOFF_MAX_MS;
+
+        uint32_t now = millis();
+        if (lastAttempt && now - lastAttempt < wait) continue;
+        lastAttempt = now;
+
+        if (flush(&target)) {
+            if (failures) Serial.println("[TELEMETRY] Collector reachable again");
+            failures = 0;
+        } else {
+            s_stats.sendErrors++;
+            if (failures++ == 0) {
+                Serial.printf("[TELEMETRY] Send to %s:%u failed, backing off\n", target.host, target.port);
+            }
+        }
+    }
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void telemetry_init() {
+    miner_config_t *config = nvs_config_get();
+
+    WiFi.macAddress(s_header.mac);
+    copyPadded(s_header.board, sizeof(s_header.board), BOARD_NAME);
+
+    if (config->telemetryUrl[0]) {
+        telemetry_configure(config->telemetryUrl, config->telemetryInterval);
+    }
+}
+
+bool telemetry_configure(const char *url, uint16_t intervalSec) {
+    target_t target;
+    bool ok = true;
+
+    if (!url || !url[0]) {
+        memset(&target, 0, sizeof(target));
+    } else if (!parseUrl(url, &target)) {
+        Serial.printf("[TELEMETRY] Invalid URL '%s' - telemetry off\n", url);
+        memset(&target, 0, sizeof(target));
+        ok = false;
+    }
+    target.intervalMs = (intervalSec ? intervalSec : TELEMETRY_INTERVAL_DEFAULT) * 1000UL;
+
+    if (target.transport != TRANSPORT_OFF && !s_buf) {
+        s_buf = mem_place_new<telemetry_buffers_t>("telemetry");
+    }
+
+    portENTER_CRITICAL(&s_telemetryMux);
+    copyPadded(s_header.worker, sizeof(s_header.worker), nvs_config_get()->workerName);
+    s_target = target;
+    s_targetGen++;
+    s_stats.active = target.transport != TRANSPORT_OFF;
+    portEXIT_CRITICAL(&s_telemetryMux);
+
+    if (s_stats.active) {
+        Serial.printf("[TELEMETRY] %s %s:%u every %lu s (%s)\n",
+                      target.transport == TRANSPORT_UDP ? "UDP" : "MQTT",
+                      target.host, target.port, (unsigned long)(target.intervalMs / 1000),
+                      target.json ? "JSON" : "binary");
+        if (!s_taskStarted) {
+            TaskHandle_t task = NULL;
+            xTaskCreatePinnedToCore(telemetry_task, "Telemetry", TELEMETRY_STACK, NULL,
+                                    TELEMETRY_PRIORITY, &task, TELEMETRY_CORE);
+            alloc_guard_watch(task);
+            s_taskStarted = true;
+        }
+    }
+    return ok;
+}
+
+void telemetry_sample(uint32_t now, float hashRate) {
+    if (!s_stats.active) return;
+
+    telemetry_sample_t s;
+    mining_stats_t *ms = miner_get_stats();
+    s.uptime = now / 1000;
+    s.hashRate = hashRate;
+    s.hashRate1m = history_mean(60000 / HISTORY_INTERVAL_MS);
+    s.hashRate15m = history_mean(900000 / HISTORY_INTERVAL_MS);
+    s.accepted = ms->accepted;
+    s.rejected = ms->rejected;
+    s.stale = ms->stale;
+    for (int i = 0; i < LATENCY_HIST_BUCKETS; i++) s.latencyHist[i] = ms->latencyHist[i];
+    s.latencyAvg = ms->avgLatency > 0xFFFF ? 0xFFFF : (uint16_t)ms->avgLatency;
+    float temp = temperatureRead();
+    s.tempC = (int8_t)(temp < -128 ? -128 : (temp > 127 ? 127 : temp));
+    s.poolConnected = stratum_is_connected() ? 1 : 0;
+    s.heapFree = ESP.getFreeHeap();
+    s.heapMin = ESP.getMinFreeHeap();
+    s.heapLargest = ESP.getMaxAllocHeap();
+
+    portENTER_CRITICAL(&s_telemetryMux);
+    if (s_pushed - s_popped >= TELEMETRY_QUEUE) {
+        s_popped++;                             // Oldest sample makes room
+        s_stats.samplesDropped++;
+    }
+    s_buf->queue[s_pushed % TELEMETRY_QUEUE] = s;
+    s_pushed++;
+    portEXIT_CRITICAL(&s_telemetryMux);
+}
+
+void telemetry_get_stats(telemetry_stats_t *out) {
+    portENTER_CRITICAL(&s_telemetryMux);
+    *out = s_stats;
+    out->queued = (uint16_t)(s_pushed - s_popped);
+    portEXIT_CRITICAL(&s_telemetryMux);
+}
@@ -0,0 +1,59 @@
+/*
+ * SparkMiner - Telemetry Publisher
+ * Pushes batched stats snapshots to a fleet collector over UDP or MQTT
+ *
+ * The monitor records a sample every 10 s into a bounded queue; a
+ * low-priority task sends the queue as frames (stats/telemetry_frame.h)
+ * every telemetry interval. If the collector is down or slow the queue
+ * keeps the newest samples, counting what it drops, and sends back off
+ * exponentially up to TELEMETRY_BACKOFF_MAX_MS. Mining never waits on it.
+ *
+ * Target URL (config "telemetry_url", empty = off):
+ *   udp://host[:port]                       (default port 9100)
+ *   mqtt://[user:pass@]host[:port][/topic]  (default 1883, topic "sparkminer")
+ * plus an optional "?format=json" (default: compact binary). MQTT frames
+ * are QoS 0 PUBLISHes to <topic>/<mac>.
+ *
+ * GPL v3 License
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <board_config.h>
+
+typedef struct {
+    bool active;                // A valid target is configured
+    uint16_t queued;            // Samples waiting to be sent
+    uint32_t framesSent;
+    uint32_t samplesSent;
+    uint32_t samplesDropped;    // Pushed out of a full queue
+    uint32_t sendErrors;        // Failed connects and sends
+    uint32_t connects;          // MQTT sessions opened
+} telemetry_stats_t;
+
+/**
+ * Apply the configured target and start the publisher task if set
+ */
+void telemetry_init();
+
+/**
+ * Switch target or interval at run time (empty url = off)
+ * Queued samples are kept and go to the new target.
+ * @return false if the URL does not parse (telemetry is then off)
+ */
+bool telemetry_configure(const char *url, uint16_t intervalSec);
+
+/**
+ * Record a sample (monitor task, every 10 s); never blocks
+ * @param hashRate  Smoothed hashrate in H/s
+ */
+void telemetry_sample(uint32_t now, float hashRate);
+
+/**
+ * Publisher counters
+ */
+void telemetry_get_stats(telemetry_stats_t *out);
+
+#endif // TELEMETRY_H
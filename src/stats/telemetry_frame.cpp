@@ -0,0 +1,169 @@
+/*
+ * SparkMiner - Telemetry Frame Encoding
+ *
+ * GPL v3 License
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#include <fixed_string.h>
+#include "telemetry_frame.h"
+
+#define JSON_SAMPLE_MAX     384     // One sample object, worst case
+#define JSON_DOC_SIZE       16384   // Parsed frame of TELEMETRY_BATCH_MAX samples
+
+// Board and worker names come from config; keep them valid JSON strings
+static void appendName(FixedString<40> &out, const char *name, size_t maxLen) {
+    out.append('"');
+    for (size_t i = 0; i < maxLen && name[i]; i++) {
+        char c = name[i];
+        out.append((c == '"' || c == '\\' || (unsigned char)c < 0x20) ? '_' : c);
+    }
+    out.append('"');
+}
+
+// ============================================================
+// Binary
+// ============================================================
+
+size_t telemetry_frame_bin(const telemetry_header_t *header, const telemetry_sample_t *samples,
+                           int count, uint8_t *out, size_t size, int *used) {
+    *used = 0;
+    if (size < sizeof(telemetry_header_t)) return 0;
+
+    int fit = (int)((size - sizeof(telemetry_header_t)) / sizeof(telemetry_sample_t));
+    if (fit > count) fit = count;
+    if (fit > TELEMETRY_BATCH_MAX) fit = TELEMETRY_BATCH_MAX;
+
+    telemetry_header_t h = *header;
+    memcpy(h.magic, "ST", 2);
+    h.version = TELEMETRY_FRAME_VERSION;
+    h.count = (uint8_t)fit;
+    memcpy(out, &h, sizeof(h));
+    memcpy(out + sizeof(h), samples, sizeof(telemetry_sample_t) * fit);
+
+    *used = fit;
+    return sizeof(h) + sizeof(telemetry_sample_t) * fit;
+}
+
+int telemetry_frame_parse_bin(const uint8_t *buf, size_t len, telemetry_header_t *header,
+                              telemetry_sample_t *samples, int max) {
+    if (len < sizeof(telemetry_header_t)) return -1;
+    memcpy(header, buf, sizeof(*header));
+    if (memcmp(header->magic, "ST", 2) != 0 || header->version != TELEMETRY_FRAME_VERSION) return -1;
+    if (len != sizeof(telemetry_header_t) + sizeof(telemetry_sample_t) * header->count) return -1;
+
+    int n = header->count < max ? header->count : max;
+    memcpy(samples, buf + sizeof(telemetry_header_t), sizeof(telemetry_sample_t) * n);
+    return n;
+}
+
+// ============================================================
+// JSON
+// ============================================================
+
+size_t telemetry_frame_json(const telemetry_header_t *header, const telemetry_sample_t *samples,
+                            int count, char *out, size_t size, int *used) {
+    static const char tail[] = "]}";
+    *used = 0;
+
+    FixedString<128> head;
+    FixedString<40> name;
+    head.printf("{\"v\":%d,\"mac\":\"%02x%02x%02x%02x%02x%02x\",\"board\":", TELEMETRY_FRAME_VERSION,
+                header->mac[0], header->mac[1], header->mac[2],
+                header->mac[3], header->mac[4], header->mac[5]);
+    appendName(name, header->board, sizeof(header->board));
+    head.append(name).append(",\"worker\":");
+    name.clear();
+    appendName(name, header->worker, sizeof(header->worker));
+    head.append(name).appendf(",\"seq\":%lu,\"drop\":%lu,\"s\":[",
+                              (unsigned long)header->seq, (unsigned long)header->dropped);
+    if (head.length() + sizeof(tail) > size) return 0;
+
+    memcpy(out, head.c_str(), head.length());
+    size_t len = head.length();
+
+    FixedString<JSON_SAMPLE_MAX> item;
+    int n = 0;
+    for (; n < count && n < TELEMETRY_BATCH_MAX; n++) {
+        const telemetry_sample_t *s = &samples[n];
+        item.clear();
+        if (n) item.append(',');
+        item.appendf("{\"t\":%lu,\"hr\":[%.1f,%.1f,%.1f],\"sh\":[%lu,%lu,%lu],\"lat\":%u,\"lh\":[",
+                     (unsigned long)s->uptime, s->hashRate, s->hashRate1m, s->hashRate15m,
+                     (unsigned long)s->accepted, (unsigned long)s->rejected,
+                     (unsigned long)s->stale, s->latencyAvg);
+        for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+            item.appendf(b ? ",%lu" : "%lu", (unsigned long)s->latencyHist[b]);
+        }
+        item.appendf("],\"heap\":[%lu,%lu,%lu],\"temp\":%d,\"pool\":%u}",
+                     (unsigned long)s->heapFree, (unsigned long)s->heapMin,
+                     (unsigned long)s->heapLargest, s->tempC, s->poolConnected);
+
+        if (len + item.length() + sizeof(tail) > size) break;
+        memcpy(out + len, item.c_str(), item.length());
+        len += item.length();
+    }
+    if (n == 0) return 0;
+
+    memcpy(out + len, tail, sizeof(tail));
+    *used = n;
+    return len + sizeof(tail) - 1;
+}
+
+// Inverse of appendName(): names are copied as sent, NUL padded
+static void copyName(char *dst, size_t size, const char *src) {
+    memset(dst, 0, size);
+    if (src) strncpy(dst, src, size - 1);
+}
+
+int telemetry_frame_parse_json(const char *json, telemetry_header_t *header,
+                               telemetry_sample_t *samples, int max) {
+    DynamicJsonDocument doc(JSON_DOC_SIZE);
+    if (deserializeJson(doc, json)) return -1;
+    if ((doc["v"] | 0) != TELEMETRY_FRAME_VERSION) return -1;
+
+    const char *mac = doc["mac"] | "";
+    if (strlen(mac) != 12) return -1;
+
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, "ST", 2);
+    header->version = TELEMETRY_FRAME_VERSION;
+    for (int i = 0; i < 6; i++) {
+        char byte[3] = { mac[i * 2], mac[i * 2 + 1], 0 };
+        header->mac[i] = (uint8_t)strtoul(byte, NULL, 16);
+    }
+    copyName(header->board, sizeof(header->board), doc["board"] | "");
+    copyName(header->worker, sizeof(header->worker), doc["worker"] | "");
+    header->seq = doc["seq"].as<uint32_t>();
+    header->dropped = doc["drop"].as<uint32_t>();
+
+    JsonArrayConst list = doc["s"].as<JsonArrayConst>();
+    if (list.isNull()) return -1;
+
+    int n = 0;
+    for (JsonVariantConst item : list) {
+        if (n >= max || n >= TELEMETRY_BATCH_MAX) break;
+        telemetry_sample_t *s = &samples[n++];
+        memset(s, 0, sizeof(*s));
+        s->uptime = item["t"].as<uint32_t>();
+        s->hashRate = item["hr"][0].as<float>();
+        s->hashRate1m = item["hr"][1].as<float>();
+        s->hashRate15m = item["hr"][2].as<float>();
+        s->accepted = item["sh"][0].as<uint32_t>();
+        s->rejected = item["sh"][1].as<uint32_t>();
+        s->stale = item["sh"][2].as<uint32_t>();
+        for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+            s->latencyHist[b] = item["lh"][b].as<uint32_t>();
+        }
+        s->latencyAvg = (uint16_t)item["lat"].as<uint32_t>();
+        s->heapFree = item["heap"][0].as<uint32_t>();
+        s->heapMin = item["heap"][1].as<uint32_t>();
+        s->heapLargest = item["heap"][2].as<uint32_t>();
+        s->tempC = (int8_t)item["temp"].as<int>();
+        s->poolConnected = (uint8_t)item["pool"].as<int>();
+    }
+    header->count = (uint8_t)n;
+    return n;
+}
@@ -0,0 +1,98 @@
+/*
+ * SparkMiner - Telemetry Frames
+ * Wire format shared by the firmware publisher and host-side collectors
+ *
+ * A frame carries one device header and a batch of samples, oldest
+ * first. Counters (shares, latency buckets) are totals since boot, so a
+ * collector derives rates from any two frames and a lost frame costs
+ * resolution, not totals. seq counts frames delivered since boot and is
+ * only advanced after a successful send: a retried frame keeps its seq,
+ * letting a collector drop duplicates.
+ *
+ * Binary: telemetry_header_t followed by `count` telemetry_sample_t,
+ * both packed little-endian (ESP32 and x86/ARM hosts alike).
+ *
+ * JSON, for brokers and humans:
+ *   {"v":1,"mac":"a0b1c2d3e4f5","board":"...","worker":"...","seq":7,"drop":0,
+ *    "s":[{"t":600,"hr":[h,h1m,h15m],"sh":[acc,rej,stale],"lat":avg,
+ *          "lh":[...],"heap":[free,min,largest],"temp":45,"pool":1}, ...]}
+ *
+ * GPL v3 License
+ */
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../stratum/stratum_types.h"
+
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_FRAME_MAX     1400    // Fits one Ethernet MTU as a UDP datagram
+#define TELEMETRY_BATCH_MAX     16      // Samples per frame (binary: 50 + 16 x 76 B)
+
+typedef struct __attribute__((packed)) {
+    char magic[2];              // "ST"
+    uint8_t version;            // TELEMETRY_FRAME_VERSION
+    uint8_t count;              // Samples that follow
+    uint8_t mac[6];             // Device identity
+    char board[16];             // BOARD_NAME, NUL padded
+    char worker[16];            // Worker name, NUL padded
+    uint32_t seq;               // Frames delivered before this one
+    uint32_t dropped;           // Samples lost to a full queue since boot
+} telemetry_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t uptime;            // Seconds since boot
+    float hashRate;             // H/s, smoothed
+    float hashRate1m;           // Mean of the last minute
+    float hashRate15m;          // Mean of the last 15 minutes
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t stale;             // Part of rejected
+    uint32_t latencyHist[LATENCY_HIST_BUCKETS];
+    uint16_t latencyAvg;        // ms
+    int8_t tempC;
+    uint8_t poolConnected;
+    uint32_t heapFree;
+    uint32_t heapMin;
+    uint32_t heapLargest;
+} telemetry_sample_t;
+
+static_assert(sizeof(telemetry_header_t) == 50, "telemetry header layout changed");
+static_assert(sizeof(telemetry_sample_t) == 76, "telemetry sample layout changed");
+
+/**
+ * Encode a binary frame
+ * @param header   Device fields, seq and dropped (magic, version, count are set here)
+ * @param samples  Oldest first
+ * @param count    Samples available
+ * @param used     Out: samples that went into the frame
+ * @return Frame length, 0 if not even the header fits
+ */
+size_t telemetry_frame_bin(const telemetry_header_t *header, const telemetry_sample_t *samples,
+                           int count, uint8_t *out, size_t size, int *used);
+
+/**
+ * Encode a JSON frame (same fields, NUL terminated)
+ * @return Frame length without the terminator, 0 if nothing fits
+ */
+size_t telemetry_frame_json(const telemetry_header_t *header, const telemetry_sample_t *samples,
+                            int count, char *out, size_t size, int *used);
+
+/**
+ * Decode a binary frame
+ * @param samples  Out: up to `max` samples
+ * @return Samples decoded, -1 if the frame is malformed
+ */
+int telemetry_frame_parse_bin(const uint8_t *buf, size_t len, telemetry_header_t *header,
+                              telemetry_sample_t *samples, int max);
+
+/**
+ * Decode a JSON frame (NUL terminated)
+ * @return Samples decoded, -1 if the frame is malformed
+ */
+int telemetry_frame_parse_json(const char *json, telemetry_header_t *header,
+                               telemetry_sample_t *samples, int max);
+
+#endif // TELEMETRY_FRAME_H
@@ -10,13 +10,18 @@
 #include <WiFi.h>
 #include <utility>  // For std::swap
 #include <board_config.h>
+#include <fixed_string.h>
 #include "stratum.h"
+#include "stratum_msg.h"
+#include "stratum_rec.h"
 #include "../mining/miner.h"
+#include "../stats/mem_place.h"
 
 // ============================================================
 // Constants
 // ============================================================
 #define STRATUM_MSG_BUFFER  512
+#define STRATUM_LINE_MAX    4096    // Longest line accepted from the pool
 #define RESPONSE_TIMEOUT_MS 3000
 #define KEEPALIVE_MS        120000
 #define INACTIVITY_MS       700000
@@ -31,6 +36,17 @@ static uint16_t s_pendingIndex = 0;
 static pool_config_t s_primaryPool;
 static pool_config_t s_backupPool;
 static bool s_hasBackupPool = false;
+static double s_suggestDifficulty = DESIRED_DIFFICULTY;
+
+// Settings from other tasks, taken by the stratum task between messages
+#define PENDING_PRIMARY     0x01
+#define PENDING_BACKUP      0x02
+#define PENDING_DIFFICULTY  0x04
+static SemaphoreHandle_t s_settingsMutex = NULL;
+static pool_config_t s_nextPrimary;
+static pool_config_t s_nextBackup;
+static double s_nextDifficulty = DESIRED_DIFFICULTY;
+static volatile uint8_t s_settingsPending = 0;
 
 static volatile bool s_isConnected = false;
 static volatile bool s_reconnectRequested = false;
@@ -40,17 +56,54 @@ static uint32_t s_messageId = 1;
 static uint32_t s_lastActivity = 0;
 static uint32_t s_lastSubmit = 0;
 
+// Last parsed notify; too large for the stack (placed by stratum_init)
+static stratum_job_t *s_job = NULL;
+
 // Extra nonce from subscription
 static char s_extraNonce1[32] = {0};
 static int s_extraNonce2Size = 4;
 
-// JSON document for parsing
-static StaticJsonDocument<4096> s_doc;
+// JSON document for parsing (placed by stratum_init)
+typedef StaticJsonDocument<4096> stratum_doc_t;
+static stratum_doc_t *s_doc = NULL;
+
+// Line buffers; only the stratum task touches them, so one of each suffices
+static char *s_rxLine = NULL;                       // STRATUM_LINE_MAX + 1, placed by stratum_init
+static FixedString<STRATUM_MSG_BUFFER> s_txLine;   // Message plus newline
 
 // ============================================================
 // Utility Functions
 // ============================================================
 
+static void lockSettings() {
+    if (s_settingsMutex) xSemaphoreTake(s_settingsMutex, portMAX_DELAY);
+}
+
+static void unlockSettings() {
+    if (s_settingsMutex) xSemaphoreGive(s_settingsMutex);
+}
+
+/**
+ * Take settings queued by stratum_set_pool() and friends (stratum task)
+ * @return true if the suggested difficulty changed
+ */
+static bool applyPendingSettings() {
+    if (!s_settingsPending) return false;
+
+    lockSettings();
+    uint8_t pending = s_settingsPending;
+    if (pending & PENDING_PRIMARY) s_primaryPool = s_nextPrimary;
+    if (pending & PENDING_BACKUP) {
+        s_backupPool = s_nextBackup;
+        s_hasBackupPool = (s_backupPool.url[0] && s_backupPool.port > 0 && s_backupPool.wallet[0]);
+    }
+    if (pending & PENDING_DIFFICULTY) s_suggestDifficulty = s_nextDifficulty;
+    s_settingsPending = 0;
+    unlockSettings();
+
+    return pending & PENDING_DIFFICULTY;
+}
+
 static uint32_t getNextId() {
     if (s_messageId == UINT32_MAX) {
         s_messageId = 1;
@@ -64,30 +117,37 @@ static void safeStrCpy(char *dest, const char *src, size_t maxLen) {
     dest[maxLen - 1] = '\0';
 }
 
-// Format hex string with zero padding (big-endian - value as hex)
-static void formatHex8(char *dest, uint32_t value) {
-    static const char *hex = "0123456789abcdef";
-    for (int i = 7; i >= 0; i--) {
-        dest[i] = hex[value & 0xF];
-        value >>= 4;
-    }
-    dest[8] = '\0';
+// Histogram slot for a share round trip (see LATENCY_HIST_BUCKETS)
+static int latencyBucket(uint32_t ms) {
+    int bucket = 0;
+    while (bucket < LATENCY_HIST_BUCKETS - 1 && ms >= ((uint32_t)LATENCY_HIST_BASE_MS << bucket)) bucket++;
+    return bucket;
 }
 
-// Bounded read to prevent stack overflow/OOM from malicious packets
-static String readBoundedLine(WiFiClient& client, size_t maxLen = 4096) {
-    String line;
-    line.reserve(256);  // Initial allocation
+// Strip surrounding whitespace in place
+static const char *trimLine(char *line) {
+    StringView trimmed = StringView(line).trim();
+    line[(trimmed.data() - line) + trimmed.length()] = '\0';
+    return trimmed.data();
+}
+
+// Bounded read into s_rxLine to prevent stack overflow/OOM from malicious packets.
+// Returns the trimmed line, empty on timeout or overflow; valid until the next read.
+static const char *readBoundedLine(WiFiClient& client) {
+    size_t len = 0;
     unsigned long start = millis();
-    
+    s_rxLine[0] = '\0';
+
     while (client.connected() && (millis() - start < 5000)) {
         if (client.available()) {
             char c = client.read();
             if (c == '\n') {
-                return line;
+                s_rxLine[len] = '\0';
+                stratum_rec_rx(s_rxLine);
+                return trimLine(s_rxLine);
             }
-            if (line.length() < maxLen) {
-                line += c;
+            if (len < STRATUM_LINE_MAX) {
+                s_rxLine[len++] = c;
             } else {
                 // Line too long - read until newline and discard
                 while (client.available()) {
@@ -95,13 +155,16 @@ static String readBoundedLine(WiFiClient& client, size_t maxLen = 4096) {
                      if (millis() - start > 5000) break;
                 }
                 Serial.println("[STRATUM] WARNING: Line exceeded max length, discarded");
-                return "";  // Return empty to signal error
+                s_rxLine[0] = '\0';
+                return s_rxLine;  // Empty signals error
             }
         } else {
             vTaskDelay(1 / portTICK_PERIOD_MS);
         }
     }
-    return line;
+    s_rxLine[len] = '\0';
+    if (len > 0) stratum_rec_rx(s_rxLine);
+    return trimLine(s_rxLine);
 }
 
 // ============================================================
@@ -110,16 +173,37 @@ static String readBoundedLine(WiFiClient& client, size_t maxLen = 4096) {
 
 static bool sendMessage(WiFiClient &client, const char *msg) {
     if (!client.connected()) return false;
+    stratum_rec_tx(msg);
 
     // Send message with newline as single write (like NerdMiner)
     // This avoids TCP packet fragmentation issues
-    String fullMsg = String(msg) + "\n";
-    client.print(fullMsg);
+    s_txLine = msg;
+    s_txLine += '\n';
+    if (s_txLine.truncated()) {
+        Serial.println("[STRATUM] ERROR: Message too long");
+        return false;
+    }
+    client.write((const uint8_t *)s_txLine.c_str(), s_txLine.length());
 
     dbg("[STRATUM] TX: %s\n", msg);
     return true;
 }
 
+static bool sendSuggestDifficulty(WiFiClient &client) {
+    char msg[STRATUM_MSG_BUFFER];
+    snprintf(msg, sizeof(msg),
+        "{\"id\":%lu,\"method\":\"mining.suggest_difficulty\",\"params\":[%.10g]}",
+        getNextId(), s_suggestDifficulty);
+    return sendMessage(client, msg);
+}
+
+// Connect with a 10s timeout (STABILITY FIX: prevents long blocks)
+static bool connectPool(WiFiClient &client, const pool_config_t *pool) {
+    bool ok = client.connect(pool->url, pool->port, 10000);
+    stratum_rec_connect(pool->url, pool->port, ok);
+    return ok;
+}
+
 static bool waitForResponse(WiFiClient &client, int timeoutMs) {
     int elapsed = 0;
     while (!client.available() && elapsed < timeoutMs) {
@@ -129,34 +213,27 @@ static bool waitForResponse(WiFiClient &client, int timeoutMs) {
     return client.available() > 0;
 }
 
-static bool parseSubscribeResponse(const String &line) {
-    s_doc.clear();
-    DeserializationError err = deserializeJson(s_doc, line);
+static bool parseSubscribeResponse(const char *line) {
+    s_doc->clear();
+    DeserializationError err = deserializeJson(*s_doc, line);
 
     if (err) {
-        Serial.printf("[STRATUM] JSON parse error: %s\nRAW: %s\n", err.c_str(), line.c_str());
+        Serial.printf("[STRATUM] JSON parse error: %s\nRAW: %s\n", err.c_str(), line);
         return false;
     }
 
-    if (s_doc.containsKey("error") && !s_doc["error"].isNull()) {
-        const char *errMsg = s_doc["error"][1];
-        Serial.printf("[STRATUM] Subscribe error: %s\n", errMsg ? errMsg : "unknown");
+    const char *errMsg = stratum_msg_error(s_doc->as<JsonVariantConst>());
+    if (errMsg) {
+        Serial.printf("[STRATUM] Subscribe error: %s\n", errMsg);
         return false;
     }
 
-    if (!s_doc.containsKey("result") || !s_doc["result"].is<JsonArray>()) {
+    if (!stratum_msg_parse_subscribe(s_doc->as<JsonVariantConst>(), s_extraNonce1,
+                                     sizeof(s_extraNonce1), &s_extraNonce2Size)) {
         Serial.println("[STRATUM] Invalid subscribe response (no result)");
         return false;
     }
 
-    // Extract extra nonce
-    const char *en1 = s_doc["result"][1];
-    if (en1) {
-        safeStrCpy(s_extraNonce1, en1, sizeof(s_extraNonce1));
-    }
-
-    s_extraNonce2Size = s_doc["result"][2] | 4;
-
     // Pass to miner
     miner_set_extranonce(s_extraNonce1, s_extraNonce2Size);
 
@@ -166,98 +243,59 @@ static bool parseSubscribeResponse(const String &line) {
     return true;
 }
 
-static bool parseAuthorizeResponse(const String &line) {
-    s_doc.clear();
-    DeserializationError err = deserializeJson(s_doc, line);
+static bool parseAuthorizeResponse(const char *line) {
+    s_doc->clear();
+    DeserializationError err = deserializeJson(*s_doc, line);
 
     if (err) return false;
 
-    if (s_doc.containsKey("error") && !s_doc["error"].isNull()) {
-        const char *errMsg = s_doc["error"][1];
-        Serial.printf("[STRATUM] Auth error: %s\n", errMsg ? errMsg : "unknown");
+    const char *errMsg = stratum_msg_error(s_doc->as<JsonVariantConst>());
+    if (errMsg) {
+        Serial.printf("[STRATUM] Auth error: %s\n", errMsg);
         return false;
     }
 
-    bool result = s_doc["result"] | false;
-    return result;
+    return stratum_msg_parse_authorize(s_doc->as<JsonVariantConst>());
 }
 
-static void parseMiningNotify(const String &line) {
-    if (!s_doc.containsKey("params")) return;
-
-    JsonArray params = s_doc["params"];
-
-    // Use static job to avoid stack allocation of large struct each time
-    static stratum_job_t job;
-    memset(&job, 0, sizeof(job));
-
-    // Copy strings to fixed char arrays (no heap allocation!)
-    const char *p0 = params[0];
-    const char *p1 = params[1];
-    const char *p2 = params[2];
-    const char *p3 = params[3];
-    const char *p5 = params[5];
-    const char *p6 = params[6];
-    const char *p7 = params[7];
-
-    if (p0) strncpy(job.jobId, p0, STRATUM_JOB_ID_LEN - 1);
-    if (p1) strncpy(job.prevHash, p1, STRATUM_PREVHASH_LEN - 1);
-    if (p2) strncpy(job.coinBase1, p2, STRATUM_COINBASE1_LEN - 1);
-    if (p3) strncpy(job.coinBase2, p3, STRATUM_COINBASE2_LEN - 1);
-    if (p5) strncpy(job.version, p5, STRATUM_FIELD_LEN - 1);
-    if (p6) strncpy(job.nbits, p6, STRATUM_FIELD_LEN - 1);
-    if (p7) strncpy(job.ntime, p7, STRATUM_FIELD_LEN - 1);
-
-    // Copy merkle branches to fixed array
-    JsonArray merkle = params[4];
-    job.merkleBranchCount = 0;
-    for (size_t i = 0; i < merkle.size() && i < STRATUM_MAX_MERKLE; i++) {
-        const char *branch = merkle[i];
-        if (branch) {
-            strncpy(job.merkleBranches[i], branch, 67);
-            job.merkleBranches[i][67] = '\0';
-            job.merkleBranchCount++;
-        }
+static void parseMiningNotify() {
+    if (!stratum_msg_parse_notify(s_doc->as<JsonVariantConst>(), s_extraNonce1, s_extraNonce2Size, s_job)) {
+        Serial.println("[STRATUM] WARNING: Malformed mining.notify ignored");
+        return;
     }
 
-    job.cleanJobs = params[8] | false;
-    strncpy(job.extraNonce1, s_extraNonce1, STRATUM_EXTRANONCE_LEN - 1);
-    job.extraNonce2Size = s_extraNonce2Size;
-
     s_lastActivity = millis();
-    miner_start_job(&job);
+    miner_start_job(s_job);
 }
 
-static void parseSetDifficulty(const String &line) {
-    if (!s_doc.containsKey("params")) return;
-
-    double diff = s_doc["params"][0] | 1.0;
-
-    if (!isnan(diff) && diff > 0) {
+static void parseSetDifficulty() {
+    double diff;
+    if (stratum_msg_parse_difficulty(s_doc->as<JsonVariantConst>(), &diff)) {
         miner_set_difficulty(diff);
         dbg("[STRATUM] Pool difficulty: %.4f\n", diff);
     }
 }
 
 static void handleServerMessage(WiFiClient &client) {
-    String line = readBoundedLine(client);
-    line.trim();
+    const char *line = readBoundedLine(client);
+    if (!line[0]) return;
 
-    if (line.length() == 0) return;
+    dbg("[STRATUM] RX: %s\n", line);
 
-    dbg("[STRATUM] RX: %s\n", line.c_str());
-
-    s_doc.clear();
-    DeserializationError err = deserializeJson(s_doc, line);
+    s_doc->clear();
+    DeserializationError err = deserializeJson(*s_doc, line);
     if (err) {
         dbg("[STRATUM] Parse error: %s\n", err.c_str());
         return;
     }
 
+    stratum_msg_type_t type = stratum_msg_classify(s_doc->as<JsonVariantConst>());
+
     // Check for submission responses
-    if (s_doc.containsKey("id") && s_doc.containsKey("result")) {
-        uint32_t msgId = s_doc["id"];
-        bool accepted = s_doc["result"] | false;
+    if (type == STRATUM_MSG_RESPONSE) {
+        uint32_t msgId = (*s_doc)["id"];
+        bool accepted = (*s_doc)["result"] | false;
+        const char *reason = stratum_msg_error(s_doc->as<JsonVariantConst>());
 
         // Find matching pending submission
         for (int i = 0; i < MAX_PENDING_SUBMISSIONS; i++) {
@@ -267,25 +305,26 @@ static void handleServerMessage(WiFiClient &client) {
                 uint32_t latency = millis() - s_pendingResponses[i].sentTime;
                 stats->lastLatency = latency;
                 stats->avgLatency = (stats->avgLatency == 0) ? latency : ((stats->avgLatency * 9 + latency) / 10);
+                stats->latencyHist[latencyBucket(latency)]++;
 
                 if (accepted) {
                     stats->accepted++;
                     dbg("[STRATUM] Share accepted!\n");
                 } else {
                     stats->rejected++;
-                    const char *reason = s_doc["error"][1] | "unknown";
+                    if (stratum_msg_is_stale(s_doc->as<JsonVariantConst>())) stats->stale++;
+                    if (!reason) reason = "unknown";
                     dbg("[STRATUM] Share rejected: %s\n", reason);
                     Serial.printf("[STRATUM] Share rejected: %s\n", reason);
                 }
 
                 // Call callback if set
                 if (s_pendingResponses[i].callback) {
-                    const char *reason = accepted ? NULL : (const char *)s_doc["error"][1];
                     s_pendingResponses[i].callback(
                         s_pendingResponses[i].sessionId,
                         s_pendingResponses[i].msgId,
                         accepted,
-                        reason
+                        accepted ? NULL : reason
                     );
                 }
 
@@ -296,67 +335,59 @@ static void handleServerMessage(WiFiClient &client) {
     }
 
     // Check for method calls
-    if (s_doc.containsKey("method")) {
-        const char *method = s_doc["method"];
-
-        if (strcmp(method, "mining.notify") == 0) {
-            parseMiningNotify(line);
-        } else if (strcmp(method, "mining.set_difficulty") == 0) {
-            parseSetDifficulty(line);
-        } else {
-            dbg("[STRATUM] Unknown method: %s\n", method);
-        }
+    if (type == STRATUM_MSG_NOTIFY) {
+        parseMiningNotify();
+    } else if (type == STRATUM_MSG_SET_DIFFICULTY) {
+        parseSetDifficulty();
+    } else if (type == STRATUM_MSG_UNKNOWN) {
+        dbg("[STRATUM] Unknown method: %s\n", (const char *)(*s_doc)["method"]);
     }
 }
 
 // Helper: Read lines until we get a response with matching ID (or timeout)
-// Handles method calls (set_difficulty, notify) that arrive before the response
-static bool waitForResponseById(WiFiClient &client, uint32_t expectedId, String &outResponse, int maxAttempts = 10) {
+// Handles method calls (set_difficulty, notify) that arrive before the response.
+// Returns the response line (in s_rxLine until the next read) or NULL.
+static const char *waitForResponseById(WiFiClient &client, uint32_t expectedId, int maxAttempts = 10) {
     for (int attempt = 0; attempt < maxAttempts; attempt++) {
-        String line = readBoundedLine(client);  // Use bounded read to prevent OOM
-        line.trim();
+        const char *line = readBoundedLine(client);  // Use bounded read to prevent OOM
 
-        if (line.length() == 0) {
+        if (!line[0]) {
             Serial.println("[STRATUM] Response timeout");
-            return false;
+            return NULL;
         }
 
         // Parse to check if this is our response or a method call
-        s_doc.clear();
-        DeserializationError err = deserializeJson(s_doc, line);
+        s_doc->clear();
+        DeserializationError err = deserializeJson(*s_doc, line);
         if (err) {
             Serial.printf("[STRATUM] JSON parse error: %s\n", err.c_str());
             continue;
         }
 
         // Check if this is a method call (id is null or missing, has "method" field)
-        if (s_doc.containsKey("method")) {
-            const char *method = s_doc["method"];
+        if (s_doc->containsKey("method")) {
+            const char *method = (*s_doc)["method"];
 
             // Handle set_difficulty immediately since it's important
             if (strcmp(method, "mining.set_difficulty") == 0) {
-                double diff = s_doc["params"][0] | 1.0;
-                if (!isnan(diff) && diff > 0) {
-                    miner_set_difficulty(diff);
-                }
+                parseSetDifficulty();
             }
             // Continue reading for our actual response
             continue;
         }
 
         // Check if this response matches our expected ID
-        if (s_doc.containsKey("id")) {
-            uint32_t respId = s_doc["id"] | 0;
+        if (s_doc->containsKey("id")) {
+            uint32_t respId = (*s_doc)["id"] | 0;
             if (respId == expectedId) {
-                outResponse = line;
-                return true;
+                return line;
             }
             Serial.printf("[STRATUM] Got response for different id: %lu (expected %lu)\n", respId, expectedId);
         }
     }
 
     Serial.println("[STRATUM] Max attempts reached waiting for response");
-    return false;
+    return NULL;
 }
 
 static bool subscribe(WiFiClient &client, const char *wallet, const char *password) {
@@ -378,8 +409,8 @@ static bool subscribe(WiFiClient &client, const char *wallet, const char *passwo
     vTaskDelay(200 / portTICK_PERIOD_MS);
 
     // Wait for subscribe response (handle any method calls that arrive first)
-    String resp;
-    if (!waitForResponseById(client, subId, resp)) {
+    const char *resp = waitForResponseById(client, subId);
+    if (!resp) {
         Serial.println("[STRATUM] No subscribe response");
         return false;
     }
@@ -396,24 +427,18 @@ static bool subscribe(WiFiClient &client, const char *wallet, const char *passwo
     }
 
     // Suggest difficulty
-    uint32_t diffId = getNextId();
-    snprintf(msg, sizeof(msg),
-        "{\"id\":%lu,\"method\":\"mining.suggest_difficulty\",\"params\":[%.10g]}",
-        diffId, DESIRED_DIFFICULTY);
-    sendMessage(client, msg);
+    sendSuggestDifficulty(client);
 
     // Mining.authorize - append worker name if set
-    char fullUsername[MAX_WALLET_LEN + 34];
+    FixedString<MAX_WALLET_LEN + 33> fullUsername(wallet);
     if (s_primaryPool.workerName[0]) {
-        snprintf(fullUsername, sizeof(fullUsername), "%s.%s", wallet, s_primaryPool.workerName);
-    } else {
-        safeStrCpy(fullUsername, wallet, sizeof(fullUsername));
+        fullUsername.append('.').append(s_primaryPool.workerName);
     }
 
     uint32_t authId = getNextId();
     snprintf(msg, sizeof(msg),
         "{\"id\":%lu,\"method\":\"mining.authorize\",\"params\":[\"%s\",\"%s\"]}",
-        authId, fullUsername, password);
+        authId, fullUsername.c_str(), password);
 
     uint32_t startAuth = millis();
     if (!sendMessage(client, msg)) return false;
@@ -422,7 +447,8 @@ static bool subscribe(WiFiClient &client, const char *wallet, const char *passwo
     vTaskDelay(200 / portTICK_PERIOD_MS);
 
     // Wait for authorize response (handle set_difficulty/notify that may arrive first)
-    if (!waitForResponseById(client, authId, resp)) {
+    resp = waitForResponseById(client, authId);
+    if (!resp) {
         Serial.println("[STRATUM] No authorize response");
         return false;
     }
@@ -443,26 +469,19 @@ static bool subscribe(WiFiClient &client, const char *wallet, const char *passwo
 
 static void submitShare(WiFiClient &client, const submit_entry_t *entry) {
     char msg[STRATUM_MSG_BUFFER];
-    char timestamp[9], nonce[9];
-
-    // Format as 8-char hex (value as hex, zero-padded)
-    formatHex8(timestamp, entry->timestamp);
-    formatHex8(nonce, entry->nonce);
-
     uint32_t msgId = getNextId();
 
     // Standard Stratum v1 submit (5 params, no version rolling)
-    snprintf(msg, sizeof(msg),
-        "{\"id\":%lu,\"method\":\"mining.submit\",\"params\":[\"%s\",\"%s\",\"%s\",\"%s\",\"%s\"]}",
-        msgId,
-        s_primaryPool.wallet,
-        entry->jobId,
-        entry->extraNonce2,
-        timestamp,
-        nonce);
+    if (!stratum_msg_format_submit(msg, sizeof(msg), msgId, s_primaryPool.wallet, entry)) {
+        Serial.println("[STRATUM] ERROR: Submit message too long");
+        return;
+    }
 
-    Serial.printf("[STRATUM] Submit: job=%s en2=%s time=%s nonce=%s\n",
-        entry->jobId, entry->extraNonce2, timestamp, nonce);
+    // Too long for Print::printf's stack buffer; it would malloc
+    FixedString<STRATUM_MSG_BUFFER / 2> line;
+    line.printf("[STRATUM] Submit: job=%s en2=%s time=%08lx nonce=%08lx\n",
+        entry->jobId, entry->extraNonce2, (unsigned long)entry->timestamp, (unsigned long)entry->nonce);
+    Serial.print(line.c_str());
 
     if (sendMessage(client, msg)) {
         // Store in pending responses for latency tracking
@@ -489,6 +508,13 @@ void stratum_init() {
     // Initialize pending responses
     memset(s_pendingResponses, 0, sizeof(s_pendingResponses));
 
+    // Parse buffers are touched a few times a minute; PSRAM is fine for them
+    s_doc = mem_place_new<stratum_doc_t>("stratum json");
+    s_rxLine = (char *)mem_place_cold(STRATUM_LINE_MAX + 1, "stratum rx line");
+    s_job = mem_place_new<stratum_job_t>("stratum job");
+
+    s_settingsMutex = xSemaphoreCreateMutex();
+
     // Set default pool
     safeStrCpy(s_primaryPool.url, DEFAULT_POOL_URL, MAX_POOL_URL_LEN);
     s_primaryPool.port = DEFAULT_POOL_PORT;
@@ -506,10 +532,17 @@ void stratum_task(void *param) {
     Serial.printf("[STRATUM] Task started on core %d\n", xPortGetCoreID());
 
     while (true) {
+        // New difficulty goes to the open connection; a new pool comes with stratum_reconnect()
+        if (applyPendingSettings() && s_isConnected && !s_reconnectRequested) {
+            Serial.printf("[STRATUM] Suggesting difficulty %.10g\n", s_suggestDifficulty);
+            sendSuggestDifficulty(client);
+        }
+
         // Wait for WiFi
         if (WiFi.status() != WL_CONNECTED) {
             if (s_isConnected) {
                 miner_stop();
+                stratum_rec_close();
                 client.stop();
                 s_isConnected = false;
             }
@@ -533,6 +566,7 @@ void stratum_task(void *param) {
         // Handle reconnect request
         if (s_reconnectRequested) {
             miner_stop();
+            if (s_isConnected) stratum_rec_close();
             client.stop();
             s_isConnected = false;
             s_reconnectRequested = false;
@@ -544,6 +578,7 @@ void stratum_task(void *param) {
         if (!client.connected()) {
             if (s_isConnected) {
                 miner_stop();
+                stratum_rec_close();
                 s_isConnected = false;
             }
 
@@ -552,14 +587,14 @@ void stratum_task(void *param) {
             Serial.printf("[STRATUM] Connecting to %s:%d...\n",
                 s_primaryPool.url, s_primaryPool.port);
 
-            // STABILITY FIX: Use connect timeout (10s) to prevent long blocks
-            if (client.connect(s_primaryPool.url, s_primaryPool.port, 10000)) {
+            if (connectPool(client, &s_primaryPool)) {
                 if (subscribe(client, s_primaryPool.wallet, s_primaryPool.password)) {
                     s_isConnected = true;
                     s_lastActivity = millis();
                     safeStrCpy(s_currentPoolUrl, s_primaryPool.url, MAX_POOL_URL_LEN);
                     Serial.println("[STRATUM] Connected to primary pool");
                 } else {
+                    stratum_rec_close();
                     client.stop();
                 }
             } else {
@@ -570,8 +605,7 @@ void stratum_task(void *param) {
                     Serial.printf("[STRATUM] Trying backup: %s:%d\n",
                         s_backupPool.url, s_backupPool.port);
 
-                    // STABILITY FIX: Use connect timeout (10s)
-                    if (client.connect(s_backupPool.url, s_backupPool.port, 10000)) {
+                    if (connectPool(client, &s_backupPool)) {
                         if (subscribe(client, s_backupPool.wallet, s_backupPool.password)) {
                             s_isConnected = true;
                             usingBackup = true;
@@ -580,6 +614,7 @@ void stratum_task(void *param) {
                             safeStrCpy(s_currentPoolUrl, s_backupPool.url, MAX_POOL_URL_LEN);
                             Serial.println("[STRATUM] Connected to backup pool");
                         } else {
+                            stratum_rec_close();
                             client.stop();
                         }
                     }
@@ -599,7 +634,7 @@ void stratum_task(void *param) {
             // STABILITY FIX: Use connect timeout and avoid shallow copy of WiFiClient
             // Test connection to primary pool first
             WiFiClient testClient;
-            if (testClient.connect(s_primaryPool.url, s_primaryPool.port, 10000)) {
+            if (connectPool(testClient, &s_primaryPool)) {
                 if (subscribe(testClient, s_primaryPool.wallet, s_primaryPool.password)) {
                     // Successfully connected to primary - switch over
                     miner_stop();
@@ -612,6 +647,7 @@ void stratum_task(void *param) {
                     Serial.println("[STRATUM] Switched back to primary pool");
                     continue;
                 } else {
+                    stratum_rec_close();
                     testClient.stop();
                 }
             }
@@ -631,12 +667,7 @@ void stratum_task(void *param) {
 
         // Send keepalive if idle
         if (millis() - s_lastSubmit > KEEPALIVE_MS) {
-            char msg[STRATUM_MSG_BUFFER];
-            uint32_t keepId = getNextId();
-            snprintf(msg, sizeof(msg),
-                "{\"id\":%lu,\"method\":\"mining.suggest_difficulty\",\"params\":[%.10g]}",
-                keepId, DESIRED_DIFFICULTY);
-            sendMessage(client, msg);
+            sendSuggestDifficulty(client);
             s_lastSubmit = millis();
         }
 
@@ -644,10 +675,12 @@ void stratum_task(void *param) {
         if (millis() - s_lastActivity > INACTIVITY_MS) {
             Serial.println("[STRATUM] Pool inactive, disconnecting");
             miner_stop();
+            stratum_rec_close();
             client.stop();
             s_isConnected = false;
         }
 
+        stratum_rec_flush();
         vTaskDelay(100 / portTICK_PERIOD_MS);
     }
 }
@@ -669,27 +702,36 @@ const char* stratum_get_pool() {
     return s_currentPoolUrl;
 }
 
-void stratum_set_pool(const char *url, int port, const char *wallet, const char *password, const char *workerName) {
-    safeStrCpy(s_primaryPool.url, url, MAX_POOL_URL_LEN);
-    s_primaryPool.port = port;
-    safeStrCpy(s_primaryPool.wallet, wallet, MAX_WALLET_LEN);
-    safeStrCpy(s_primaryPool.password, password, MAX_PASSWORD_LEN);
+static void setPoolConfig(pool_config_t *pool, const char *url, int port, const char *wallet,
+                          const char *password, const char *workerName) {
+    safeStrCpy(pool->url, url, MAX_POOL_URL_LEN);
+    pool->port = port;
+    safeStrCpy(pool->wallet, wallet, MAX_WALLET_LEN);
+    safeStrCpy(pool->password, password, MAX_PASSWORD_LEN);
     if (workerName) {
-        safeStrCpy(s_primaryPool.workerName, workerName, 32);
+        safeStrCpy(pool->workerName, workerName, 32);
     } else {
-        s_primaryPool.workerName[0] = '\0';
+        pool->workerName[0] = '\0';
     }
 }
 
+void stratum_set_pool(const char *url, int port, const char *wallet, const char *password, const char *workerName) {
+    lockSettings();
+    setPoolConfig(&s_nextPrimary, url, port, wallet, password, workerName);
+    s_settingsPending |= PENDING_PRIMARY;
+    unlockSettings();
+}
+
 void stratum_set_backup_pool(const char *url, int port, const char *wallet, const char *password, const char *workerName) {
-    safeStrCpy(s_backupPool.url, url, MAX_POOL_URL_LEN);
-    s_backupPool.port = port;
-    safeStrCpy(s_backupPool.wallet, wallet, MAX_WALLET_LEN);
-    safeStrCpy(s_backupPool.password, password, MAX_PASSWORD_LEN);
-    if (workerName) {
-        safeStrCpy(s_backupPool.workerName, workerName, 32);
-    } else {
-        s_backupPool.workerName[0] = '\0';
-    }
-    s_hasBackupPool = (url[0] && port > 0 && wallet[0]);
+    lockSettings();
+    setPoolConfig(&s_nextBackup, url, port, wallet, password, workerName);
+    s_settingsPending |= PENDING_BACKUP;
+    unlockSettings();
+}
+
+void stratum_set_difficulty(double difficulty) {
+    lockSettings();
+    s_nextDifficulty = difficulty;
+    s_settingsPending |= PENDING_DIFFICULTY;
+    unlockSettings();
 }
@@ -56,6 +56,8 @@ const char* stratum_get_pool();
 
 /**
  * Set pool configuration
+ * Safe from any task; the stratum task takes it before its next connect,
+ * so follow with stratum_reconnect() to leave the current pool now.
  * @param workerName Optional worker name (appended as wallet.worker)
  */
 void stratum_set_pool(const char *url, int port, const char *wallet, const char *password, const char *workerName = NULL);
@@ -65,4 +67,10 @@ void stratum_set_pool(const char *url, int port, const char *wallet, const char
  */
 void stratum_set_backup_pool(const char *url, int port, const char *wallet, const char *password, const char *workerName = NULL);
 
+/**
+ * Set the difficulty sent in mining.suggest_difficulty
+ * Re-suggested on the open connection without reconnecting.
+ */
+void stratum_set_difficulty(double difficulty);
+
 #endif // STRATUM_H
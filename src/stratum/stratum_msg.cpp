@@ -0,0 +1,142 @@
+/*
+ * SparkMiner - Stratum Message Handling Implementation
+ * Parse and format Stratum v1 JSON-RPC messages
+ *
+ * GPL v3 License
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "stratum_msg.h"
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+// Copy a JSON string into a fixed buffer; fails on missing or oversize values
+static bool copyField(char *dest, size_t maxLen, JsonVariantConst value) {
+    const char *src = value.as<const char *>();
+    if (!src) return false;
+    size_t len = strlen(src);
+    if (len >= maxLen) return false;
+    memcpy(dest, src, len + 1);
+    return true;
+}
+
+// Format hex string with zero padding (big-endian - value as hex)
+static void formatHex8(char *dest, uint32_t value) {
+    static const char *hex = "0123456789abcdef";
+    for (int i = 7; i >= 0; i--) {
+        dest[i] = hex[value & 0xF];
+        value >>= 4;
+    }
+    dest[8] = '\0';
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+stratum_msg_type_t stratum_msg_classify(JsonVariantConst msg) {
+    if (!msg.is<JsonObjectConst>()) return STRATUM_MSG_INVALID;
+
+    const char *method = msg["method"];
+    if (method) {
+        if (strcmp(method, "mining.notify") == 0) return STRATUM_MSG_NOTIFY;
+        if (strcmp(method, "mining.set_difficulty") == 0) return STRATUM_MSG_SET_DIFFICULTY;
+        return STRATUM_MSG_UNKNOWN;
+    }
+
+    if (!msg["id"].isNull() && msg.as<JsonObjectConst>().containsKey("result")) {
+        return STRATUM_MSG_RESPONSE;
+    }
+    return STRATUM_MSG_INVALID;
+}
+
+const char *stratum_msg_error(JsonVariantConst msg) {
+    JsonVariantConst err = msg["error"];
+    if (err.isNull()) return NULL;
+    return err[1] | "unknown";
+}
+
+bool stratum_msg_is_stale(JsonVariantConst msg) {
+    JsonVariantConst err = msg["error"];
+    if (err.isNull()) return false;
+    if ((err[0] | 0) == 21) return true;
+
+    const char *text = err[1] | "";
+    return strstr(text, "stale") || strstr(text, "Stale");
+}
+
+bool stratum_msg_parse_subscribe(JsonVariantConst msg, char *extraNonce1, size_t extraNonce1Len,
+                                 int *extraNonce2Size) {
+    if (stratum_msg_error(msg)) return false;
+
+    JsonVariantConst result = msg["result"];
+    if (!result.is<JsonArrayConst>()) return false;
+
+    // result: [[subscriptions...], extraNonce1, extraNonce2Size]
+    const char *en1 = result[1];
+    if (en1 && extraNonce1Len > 0) {
+        strncpy(extraNonce1, en1, extraNonce1Len - 1);
+        extraNonce1[extraNonce1Len - 1] = '\0';
+    }
+    *extraNonce2Size = result[2] | 4;
+    return true;
+}
+
+bool stratum_msg_parse_authorize(JsonVariantConst msg) {
+    if (stratum_msg_error(msg)) return false;
+    return msg["result"] | false;
+}
+
+bool stratum_msg_parse_notify(JsonVariantConst msg, const char *extraNonce1, int extraNonce2Size,
+                              stratum_job_t *job) {
+    // params: [jobId, prevHash, coinb1, coinb2, [merkle...], version, nbits, ntime, clean]
+    JsonVariantConst params = msg["params"];
+    if (!params.is<JsonArrayConst>()) return false;
+
+    memset(job, 0, sizeof(*job));
+    if (!copyField(job->jobId, sizeof(job->jobId), params[0])) return false;
+    if (!copyField(job->prevHash, sizeof(job->prevHash), params[1])) return false;
+    if (!copyField(job->coinBase1, sizeof(job->coinBase1), params[2])) return false;
+    if (!copyField(job->coinBase2, sizeof(job->coinBase2), params[3])) return false;
+    if (!copyField(job->version, sizeof(job->version), params[5])) return false;
+    if (!copyField(job->nbits, sizeof(job->nbits), params[6])) return false;
+    if (!copyField(job->ntime, sizeof(job->ntime), params[7])) return false;
+
+    JsonArrayConst merkle = params[4];
+    if (merkle.isNull() || merkle.size() > STRATUM_MAX_MERKLE) return false;
+    for (JsonVariantConst branch : merkle) {
+        if (!copyField(job->merkleBranches[job->merkleBranchCount],
+                       sizeof(job->merkleBranches[0]), branch)) return false;
+        job->merkleBranchCount++;
+    }
+
+    job->cleanJobs = params[8] | false;
+    strncpy(job->extraNonce1, extraNonce1, STRATUM_EXTRANONCE_LEN - 1);
+    job->extraNonce2Size = extraNonce2Size;
+    return true;
+}
+
+bool stratum_msg_parse_difficulty(JsonVariantConst msg, double *difficulty) {
+    double diff = msg["params"][0] | 1.0;
+    if (isnan(diff) || isinf(diff) || diff <= 0) return false;
+    *difficulty = diff;
+    return true;
+}
+
+size_t stratum_msg_format_submit(char *buf, size_t len, uint32_t id, const char *user,
+                                 const submit_entry_t *entry) {
+    char timestamp[9], nonce[9];
+
+    // Timestamp and nonce are sent as 8-char hex (value as hex, zero-padded)
+    formatHex8(timestamp, entry->timestamp);
+    formatHex8(nonce, entry->nonce);
+
+    int n = snprintf(buf, len,
+        "{\"id\":%lu,\"method\":\"mining.submit\",\"params\":[\"%s\",\"%s\",\"%s\",\"%s\",\"%s\"]}",
+        (unsigned long)id, user, entry->jobId, entry->extraNonce2, timestamp, nonce);
+    return (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+}
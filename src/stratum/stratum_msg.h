@@ -0,0 +1,87 @@
+/*
+ * SparkMiner - Stratum Message Handling
+ * Parse and format Stratum v1 JSON-RPC messages
+ *
+ * Pure message handling on top of ArduinoJson: no sockets, no tasks, no
+ * miner calls. stratum.cpp owns the connection and acts on the results;
+ * host tools use the same functions on recorded or synthetic traffic.
+ *
+ * GPL v3 License
+ */
+
+#ifndef STRATUM_MSG_H
+#define STRATUM_MSG_H
+
+#include <ArduinoJson.h>
+#include "stratum_types.h"
+
+/**
+ * Kind of a parsed server message
+ */
+typedef enum {
+    STRATUM_MSG_INVALID = 0,        // Not a JSON-RPC object
+    STRATUM_MSG_RESPONSE,           // Reply to one of our requests (has id + result)
+    STRATUM_MSG_NOTIFY,             // mining.notify
+    STRATUM_MSG_SET_DIFFICULTY,     // mining.set_difficulty
+    STRATUM_MSG_UNKNOWN             // Any other method call
+} stratum_msg_type_t;
+
+/**
+ * Classify a deserialized server message
+ */
+stratum_msg_type_t stratum_msg_classify(JsonVariantConst msg);
+
+/**
+ * Error text of a response ("error": [code, "text", ...])
+ * @return Error text, or NULL if the response carries no error
+ */
+const char *stratum_msg_error(JsonVariantConst msg);
+
+/**
+ * True if an error response rejects a share as stale
+ * (code 21 "Job not found", or a reason mentioning "stale")
+ */
+bool stratum_msg_is_stale(JsonVariantConst msg);
+
+/**
+ * Parse the mining.subscribe response
+ * @param extraNonce1 Output, hex string
+ * @param extraNonce1Len Size of the extraNonce1 buffer
+ * @param extraNonce2Size Output, extraNonce2 size in bytes (defaults to 4)
+ * @return false on error response or missing result
+ */
+bool stratum_msg_parse_subscribe(JsonVariantConst msg, char *extraNonce1, size_t extraNonce1Len,
+                                 int *extraNonce2Size);
+
+/**
+ * Parse the mining.authorize response
+ * @return true if the pool accepted the credentials
+ */
+bool stratum_msg_parse_authorize(JsonVariantConst msg);
+
+/**
+ * Parse mining.notify into a job
+ * @param extraNonce1 Session extraNonce1 from the subscribe response
+ * @param extraNonce2Size Session extraNonce2 size
+ * @param job Output job (fully overwritten)
+ * @return false if a field is missing or does not fit its fixed buffer
+ */
+bool stratum_msg_parse_notify(JsonVariantConst msg, const char *extraNonce1, int extraNonce2Size,
+                              stratum_job_t *job);
+
+/**
+ * Parse mining.set_difficulty
+ * @param difficulty Output, only written when valid (finite, > 0)
+ * @return true if a valid difficulty was found
+ */
+bool stratum_msg_parse_difficulty(JsonVariantConst msg, double *difficulty);
+
+/**
+ * Format a standard 5-parameter mining.submit request (no newline)
+ * @param user Worker username (wallet)
+ * @return Message length, or 0 if it did not fit
+ */
+size_t stratum_msg_format_submit(char *buf, size_t len, uint32_t id, const char *user,
+                                 const submit_entry_t *entry);
+
+#endif // STRATUM_MSG_H
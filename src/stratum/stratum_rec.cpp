@@ -0,0 +1,172 @@
+/*
+ * SparkMiner - Stratum Session Recorder Implementation
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <board_config.h>
+#include "stratum_rec.h"
+
+#if STRATUM_RECORD
+
+// Same card selection as nvs_config.cpp
+#if STRATUM_RECORD == STRATUM_REC_SD
+    #if defined(USE_SD_MMC)
+        #include <SD_MMC.h>
+        #define SD_FS SD_MMC
+        #define REC_TO_SD 1
+    #elif defined(SD_CS_PIN)
+        #include <SD.h>
+        #include <SPI.h>
+        #define SD_FS SD
+        #define REC_TO_SD 1
+    #else
+        #warning "STRATUM_RECORD=2 on a board without SD card: recording to serial"
+        #define REC_TO_SD 0
+    #endif
+#else
+    #define REC_TO_SD 0
+#endif
+
+#if REC_TO_SD
+    #define REC_LINE_PREFIX ""
+#else
+    #define REC_LINE_PREFIX STRATUM_REC_PREFIX
+#endif
+
+#define REC_LINE_MAX        4160    // 4096-byte stratum line + prefix, delta and tag
+#define REC_SD_BUFFER       4096    // Records buffered between card writes
+#define REC_SD_FLUSH_MS     10000
+
+static char s_line[REC_LINE_MAX];
+static uint32_t s_lastMs = 0;
+static bool s_started = false;
+
+#if REC_TO_SD
+static char s_sdBuffer[REC_SD_BUFFER];
+static size_t s_sdLen = 0;
+static uint32_t s_lastFlush = 0;
+static bool s_sdFailed = false;
+#endif
+
+// ============================================================
+// Sinks
+// ============================================================
+
+#if REC_TO_SD
+
+static bool mountSD() {
+    #ifdef USE_SD_MMC
+        SD_MMC.setPins(SD_MMC_CLK, SD_MMC_CMD, SD_MMC_D0);
+        if (!SD_MMC.begin("/sdcard", true, false, BOARD_MAX_SDMMC_FREQ, 5)) return false;
+        if (SD_MMC.cardType() == 0) {
+            SD_MMC.end();
+            return false;
+        }
+        return true;
+    #else
+        return SD.begin(SD_CS_PIN);
+    #endif
+}
+
+static void writeSD(const char *text, size_t len) {
+    if (s_sdFailed || len == 0) return;
+
+    // Mount per write like the stats backup, so the card is free in between
+    bool ok = false;
+    if (mountSD()) {
+        File file = SD_FS.open(STRATUM_REC_FILE, FILE_APPEND);
+        if (file) {
+            ok = file.write((const uint8_t *)text, len) == len;
+            file.close();
+        }
+        SD_FS.end();
+    }
+
+    if (!ok) {
+        s_sdFailed = true;
+        Serial.println("[REC] WARNING: Cannot write " STRATUM_REC_FILE ", recording stopped");
+    }
+}
+
+static void flushSD() {
+    writeSD(s_sdBuffer, s_sdLen);
+    s_sdLen = 0;
+    s_lastFlush = millis();
+}
+
+static void emit(const char *text, size_t len) {
+    if (s_sdLen + len > sizeof(s_sdBuffer)) flushSD();
+    if (len > sizeof(s_sdBuffer)) {
+        writeSD(text, len);
+        return;
+    }
+    memcpy(s_sdBuffer + s_sdLen, text, len);
+    s_sdLen += len;
+}
+
+#else
+
+static void emit(const char *text, size_t len) {
+    (void)len;
+    Serial.print(text);     // One write per record keeps lines whole in the log
+}
+
+#endif // REC_TO_SD
+
+static void record(char tag, const char *payload, size_t payloadLen) {
+    uint32_t now = millis();
+    int n;
+
+    if (!s_started) {
+        s_started = true;
+        s_lastMs = now;
+        n = snprintf(s_line, sizeof(s_line), REC_LINE_PREFIX STRATUM_REC_HEADER " %d %s\n",
+                     STRATUM_REC_FORMAT, AUTO_VERSION);
+        emit(s_line, n);
+    }
+
+    // Trailing CR is noise from CRLF pools; the client trims it anyway
+    while (payloadLen && payload[payloadLen - 1] == '\r') payloadLen--;
+
+    n = snprintf(s_line, sizeof(s_line), REC_LINE_PREFIX "%lu%c", (unsigned long)(now - s_lastMs), tag);
+    if (payloadLen > sizeof(s_line) - n - 2) payloadLen = sizeof(s_line) - n - 2;
+    memcpy(s_line + n, payload, payloadLen);
+    n += payloadLen;
+    s_line[n++] = '\n';
+    s_line[n] = '\0';
+
+    s_lastMs = now;
+    emit(s_line, n);
+}
+
+// ============================================================
+// Public API
+// ============================================================
+
+void stratum_rec_rx(const char *line) {
+    record(STRATUM_REC_RX, line, strlen(line));
+}
+
+void stratum_rec_tx(const char *line) {
+    record(STRATUM_REC_TX, line, strlen(line));
+}
+
+void stratum_rec_connect(const char *host, uint16_t port, bool ok) {
+    char target[MAX_POOL_URL_LEN + 8];
+    snprintf(target, sizeof(target), "%s:%u", host, (unsigned)port);
+    record(ok ? STRATUM_REC_CONNECT : STRATUM_REC_CONNECT_FAIL, target, strlen(target));
+}
+
+void stratum_rec_close() {
+    record(STRATUM_REC_CLOSE, "", 0);
+}
+
+void stratum_rec_flush() {
+#if REC_TO_SD
+    if (s_sdLen && millis() - s_lastFlush >= REC_SD_FLUSH_MS) flushSD();
+#endif
+}
+
+#endif // STRATUM_RECORD
@@ -0,0 +1,82 @@
+/*
+ * SparkMiner - Stratum Session Recorder
+ * Logs every stratum line and connection event for offline replay
+ *
+ * Enabled with -D STRATUM_RECORD=1 (serial) or 2 (SD card, /stratum.rec);
+ * with the default 0 every call compiles away. One record per line:
+ *
+ *   <delta ms><tag><payload>
+ *
+ * where delta is the millis() since the previous record and tag is one of
+ *   <  line received from the pool      >  line sent to the pool
+ *   @  connected, payload host:port     ?  connect failed, payload host:port
+ *   !  connection closed or lost
+ * Each boot starts with a "#sparkminer-rec <format> <version>" header.
+ * On serial every record is prefixed with "[REC] " so a captured monitor
+ * log can be replayed as is (host/src/stratum_replay.cpp).
+ *
+ * Only the stratum task records, so the recorder needs no locking.
+ *
+ * GPL v3 License
+ */
+
+#ifndef STRATUM_REC_H
+#define STRATUM_REC_H
+
+#include <stdint.h>
+#include <board_config.h>
+
+#define STRATUM_REC_OFF         0
+#define STRATUM_REC_SERIAL      1
+#define STRATUM_REC_SD          2
+
+#define STRATUM_REC_FORMAT      1
+#define STRATUM_REC_HEADER      "#sparkminer-rec"
+#define STRATUM_REC_PREFIX      "[REC] "
+#define STRATUM_REC_FILE        "/stratum.rec"
+
+// Record tags
+#define STRATUM_REC_RX          '<'
+#define STRATUM_REC_TX          '>'
+#define STRATUM_REC_CONNECT     '@'
+#define STRATUM_REC_CONNECT_FAIL '?'
+#define STRATUM_REC_CLOSE       '!'
+
+#if STRATUM_RECORD
+
+/**
+ * Record a line received from the pool (without its newline)
+ */
+void stratum_rec_rx(const char *line);
+
+/**
+ * Record a line sent to the pool (without its newline)
+ */
+void stratum_rec_tx(const char *line);
+
+/**
+ * Record a connection attempt and its outcome
+ */
+void stratum_rec_connect(const char *host, uint16_t port, bool ok);
+
+/**
+ * Record that the connection in use was closed or lost
+ */
+void stratum_rec_close();
+
+/**
+ * Write buffered records to the sink (SD sink only; called when idle)
+ */
+void stratum_rec_flush();
+
+#else
+
+static inline void stratum_rec_rx(const char *line) { (void)line; }
+static inline void stratum_rec_tx(const char *line) { (void)line; }
+static inline void stratum_rec_connect(const char *host, uint16_t port, bool ok) { (void)host; (void)port; (void)ok; }
+static inline void stratum_rec_close() {}
+static inline void stratum_rec_flush() {}
+
+#endif // STRATUM_RECORD
+
+#endif // STRATUM_REC_H
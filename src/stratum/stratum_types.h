@@ -8,8 +8,8 @@
 #ifndef STRATUM_TYPES_H
 #define STRATUM_TYPES_H
 
-#include <Arduino.h>
-#include <ArduinoJson.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <board_config.h>
 
 // Stratum protocol constants
@@ -17,6 +17,11 @@
 #define STRATUM_MSG_SIZE        512
 #define MAX_PENDING_SUBMISSIONS 30
 
+// Share latency histogram: bucket i counts responses under
+// LATENCY_HIST_BASE_MS << i, the last bucket everything slower
+#define LATENCY_HIST_BUCKETS    8
+#define LATENCY_HIST_BASE_MS    32
+
 // Submission flags
 #define SUBMIT_FLAG_32BIT       0x02    // 32-bit share (difficulty >= 2^32)
 #define SUBMIT_FLAG_BLOCK       0x04    // Full block solution
@@ -75,14 +80,17 @@ typedef struct {
  */
 typedef struct {
     volatile uint64_t hashes;       // Total hashes computed
+    volatile uint64_t hashesCore0;  // Of which Core 0 (software SHA)
     volatile uint32_t shares;       // Shares submitted
     volatile uint32_t accepted;     // Shares accepted by pool
     volatile uint32_t rejected;     // Shares rejected by pool
+    volatile uint32_t stale;        // Rejected as stale (job gone), included in rejected
     volatile uint32_t blocks;       // Full blocks found (lottery wins!)
     volatile uint32_t matches32;    // 32-bit difficulty matches
     volatile uint32_t matches16;    // 16-bit matches (for stats)
     volatile uint32_t lastLatency;  // Last round-trip latency in ms
     volatile uint32_t avgLatency;   // Moving average latency in ms (EMA)
+    volatile uint32_t latencyHist[LATENCY_HIST_BUCKETS];  // Share responses by latency
     double bestDifficulty;          // Best difficulty found
     uint32_t startTime;             // Mining start timestamp
     uint32_t templates;             // Jobs received from pool
@@ -0,0 +1,137 @@
+/*
+ * SparkMiner - FreeRTOS Task Graph
+ *
+ * GPL v3 License
+ */
+
+#include <Arduino.h>
+#include <soc/soc_caps.h>  // For SOC_CPU_CORES_NUM
+#include <board_config.h>
+#include "tasks.h"
+#include "mining/miner.h"
+#include "stratum/stratum.h"
+#include "config/nvs_config.h"
+#include "stats/monitor.h"
+#include "stats/alloc_guard.h"
+#include "display/display_task.h"
+
+// Task handles
+static TaskHandle_t s_miner0Task = NULL;
+static TaskHandle_t s_miner1Task = NULL;
+static TaskHandle_t s_stratumTask = NULL;
+static TaskHandle_t s_monitorTask = NULL;
+static TaskHandle_t s_displayTask = NULL;
+static TaskHandle_t s_buttonTask = NULL;
+
+void tasks_start() {
+    Serial.println("[INIT] Creating FreeRTOS tasks...");
+
+    bool hasValidConfig = nvs_config_is_valid();
+
+    // Stratum task (pool communication) - only if configured
+    if (hasValidConfig) {
+        xTaskCreatePinnedToCore(
+            stratum_task,
+            "Stratum",
+            STRATUM_STACK,
+            NULL,
+            STRATUM_PRIORITY,
+            &s_stratumTask,
+            STRATUM_CORE
+        );
+    }
+
+    // Monitor task (stats snapshots + persistence) - always runs for UI
+    xTaskCreatePinnedToCore(
+        monitor_task,
+        "Monitor",
+        MONITOR_STACK,
+        NULL,
+        MONITOR_PRIORITY,
+        &s_monitorTask,
+        MONITOR_CORE
+    );
+
+    // Display task (renders monitor snapshots within a per-frame budget)
+    #if USE_DISPLAY || USE_OLED_DISPLAY
+        xTaskCreatePinnedToCore(
+            display_task,
+            "Display",
+            DISPLAY_STACK,
+            NULL,
+            DISPLAY_PRIORITY,
+            &s_displayTask,
+            DISPLAY_CORE
+        );
+    #endif
+
+    // Button task (responsive UI during mining)
+    #if defined(BUTTON_PIN) && (USE_DISPLAY || USE_OLED_DISPLAY)
+        xTaskCreatePinnedToCore(
+            button_task,
+            "Button",
+            BUTTON_STACK,
+            NULL,
+            BUTTON_PRIORITY,
+            &s_buttonTask,
+            BUTTON_CORE
+        );
+    #endif
+
+    // Only create miner tasks if wallet is configured
+    if (hasValidConfig) {
+        #if defined(MINER_WORKER_POOL) && MINER_WORKER_POOL
+            // Host daemon: nonce search runs in its own worker pool (nonce_sched)
+            Serial.println("[INIT] All tasks created (miners run in the worker pool)");
+        #elif (SOC_CPU_CORES_NUM >= 2)
+            // Dual-core: Run miners on both cores
+            // Miner on Core 1 (high priority, dedicated core)
+            xTaskCreatePinnedToCore(
+                miner_task_core1,
+                "Miner1",
+                MINER_1_STACK,
+                NULL,
+                MINER_1_PRIORITY,
+                &s_miner1Task,
+                MINER_1_CORE
+            );
+
+            // Miner on Core 0 (lower priority, yields to WiFi/Stratum/Display)
+            xTaskCreatePinnedToCore(
+                miner_task_core0,
+                "Miner0",
+                MINER_0_STACK,
+                NULL,
+                MINER_0_PRIORITY,
+                &s_miner0Task,
+                MINER_0_CORE
+            );
+
+            Serial.println("[INIT] All tasks created (dual-core mining)");
+        #else
+            // Single-core (C3, S2): Run only one miner task, not pinned
+            // Must yield frequently to let WiFi/Stratum work
+            xTaskCreate(
+                miner_task_core0,
+                "Miner",
+                MINER_0_STACK,
+                NULL,
+                MINER_0_PRIORITY,
+                &s_miner0Task
+            );
+
+            Serial.println("[INIT] All tasks created (single-core mining)");
+        #endif
+    } else {
+        Serial.println("[INIT] Monitor task created (mining disabled - no wallet)");
+        Serial.println("[INIT] Configure via captive portal or SD card config.json");
+    }
+
+    // Our own tasks must not allocate once mining settles (stats/alloc_guard.h)
+    alloc_guard_watch(s_stratumTask);
+    alloc_guard_watch(s_monitorTask);
+    alloc_guard_watch(s_displayTask);
+    alloc_guard_watch(s_buttonTask);
+    alloc_guard_watch(s_miner0Task);
+    alloc_guard_watch(s_miner1Task);
+}
@@ -0,0 +1,32 @@
+/*
+ * SparkMiner - FreeRTOS Task Graph
+ * Creates the mining, pool, monitor and UI tasks with the cores and
+ * priorities from board_config.h
+ *
+ * Kept separate from main.cpp so the host scheduler simulation starts
+ * exactly the same task layout as the firmware.
+ *
+ * GPL v3 License
+ */
+
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <Arduino.h>
+#include <board_config.h>
+
+/**
+ * Create all FreeRTOS tasks
+ * Stratum and miner tasks are only created when a wallet is configured;
+ * monitor and UI tasks always run
+ */
+void tasks_start();
+
+#if defined(BUTTON_PIN) && (USE_DISPLAY || USE_OLED_DISPLAY)
+/**
+ * Button polling task (implemented in main.cpp)
+ */
+void button_task(void *param);
+#endif
+
+#endif // TASKS_H
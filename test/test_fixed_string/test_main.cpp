@@ -0,0 +1,276 @@
+/*
+ * SparkMiner - Fixed-Capacity String Tests
+ * Truncation flags, formatted appends and StringView slicing edge cases
+ *
+ * Run: pio test -e native-core
+ *
+ * GPL v3 License
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <fixed_string.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================
+// FixedString Appends
+// ============================================================
+
+static void test_append_fits_exactly(void) {
+    FixedString<8> s;
+    s.append("abcd").append("efgh");
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(8, s.length());
+    TEST_ASSERT_EQUAL_size_t(0, s.remaining());
+    TEST_ASSERT_FALSE(s.truncated());
+}
+
+static void test_append_truncates_and_sticks(void) {
+    FixedString<8> s;
+    s.append("hello").append(" world");
+    TEST_ASSERT_EQUAL_STRING("hello wo", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(8, s.length());
+    TEST_ASSERT_TRUE(s.truncated());
+
+    // Sticky until clear(), even when later appends are empty
+    s.truncate(2);
+    s.append("");
+    TEST_ASSERT_EQUAL_STRING("he", s.c_str());
+    TEST_ASSERT_TRUE(s.truncated());
+
+    s.clear();
+    TEST_ASSERT_FALSE(s.truncated());
+    TEST_ASSERT_TRUE(s.empty());
+    TEST_ASSERT_EQUAL_STRING("", s.c_str());
+}
+
+static void test_append_char_at_capacity(void) {
+    FixedString<3> s;
+    s += 'a';
+    s += 'b';
+    s += 'c';
+    TEST_ASSERT_FALSE(s.truncated());
+    s += 'd';
+    TEST_ASSERT_EQUAL_STRING("abc", s.c_str());
+    TEST_ASSERT_TRUE(s.truncated());
+}
+
+static void test_append_with_length(void) {
+    // Only len characters are taken, embedded text after them is ignored
+    FixedString<16> s;
+    s.append("abcdef", 3);
+    TEST_ASSERT_EQUAL_STRING("abc", s.c_str());
+    s.append(StringView("xyz", 0));
+    TEST_ASSERT_EQUAL_size_t(3, s.length());
+    TEST_ASSERT_FALSE(s.truncated());
+}
+
+static void test_construct_and_assign(void) {
+    FixedString<4> s("toolong");
+    TEST_ASSERT_EQUAL_STRING("tool", s.c_str());
+    TEST_ASSERT_TRUE(s.truncated());
+
+    // Assignment starts over, flag included
+    s = "ok";
+    TEST_ASSERT_EQUAL_STRING("ok", s.c_str());
+    TEST_ASSERT_FALSE(s.truncated());
+
+    s = StringView("abcdef", 5);
+    TEST_ASSERT_EQUAL_STRING("abcd", s.c_str());
+    TEST_ASSERT_TRUE(s.truncated());
+
+    FixedString<4> null(static_cast<const char *>(NULL));
+    TEST_ASSERT_TRUE(null.empty());
+    TEST_ASSERT_FALSE(null.truncated());
+}
+
+// ============================================================
+// Formatted Appends
+// ============================================================
+
+static void test_appendf_fits(void) {
+    FixedString<32> s("nonce=");
+    s.appendf("%08lx", 0xbeefUL).appendf(" diff=%d", 42);
+    TEST_ASSERT_EQUAL_STRING("nonce=0000beef diff=42", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(strlen("nonce=0000beef diff=42"), s.length());
+    TEST_ASSERT_FALSE(s.truncated());
+
+    // An empty expansion is not a truncation
+    s.appendf("%s", "");
+    TEST_ASSERT_FALSE(s.truncated());
+}
+
+static void test_appendf_overflow(void) {
+    FixedString<10> s("abc");
+    s.appendf("-%d-%s", 12345, "tail");
+    TEST_ASSERT_EQUAL_STRING("abc-12345-", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(10, s.length());
+    TEST_ASSERT_TRUE(s.truncated());
+    TEST_ASSERT_EQUAL_CHAR('\0', s.c_str()[10]);
+
+    // Further appends on a full string keep it intact
+    s.appendf("%d", 7);
+    TEST_ASSERT_EQUAL_STRING("abc-12345-", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(10, s.length());
+}
+
+static void test_appendf_exact_fit(void) {
+    FixedString<6> s("ab");
+    s.appendf("%04d", 7);
+    TEST_ASSERT_EQUAL_STRING("ab0007", s.c_str());
+    TEST_ASSERT_FALSE(s.truncated());
+}
+
+static void test_printf_replaces(void) {
+    FixedString<8> s("previous text");
+    TEST_ASSERT_TRUE(s.truncated());
+    s.printf("%u/%u", 3u, 4u);
+    TEST_ASSERT_EQUAL_STRING("3/4", s.c_str());
+    TEST_ASSERT_FALSE(s.truncated());
+}
+
+// ============================================================
+// Trim, Substr, Find
+// ============================================================
+
+static void test_trim(void) {
+    FixedString<32> s(" \t hi there \r\n");
+    s.trim();
+    TEST_ASSERT_EQUAL_STRING("hi there", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(8, s.length());
+
+    s = " \r\n\t ";
+    s.trim();
+    TEST_ASSERT_TRUE(s.empty());
+    TEST_ASSERT_EQUAL_STRING("", s.c_str());
+
+    s.clear();
+    s.trim();
+    TEST_ASSERT_TRUE(s.empty());
+
+    // Inner whitespace is kept; other control characters are not trimmed
+    TEST_ASSERT_TRUE(StringView("  a  b  ").trim() == StringView("a  b"));
+    TEST_ASSERT_TRUE(StringView("\va\v").trim() == StringView("\va\v"));
+}
+
+static void test_substr(void) {
+    StringView v("stratum+tcp://pool:3333");
+    TEST_ASSERT_TRUE(v.substr(0) == v);
+    TEST_ASSERT_TRUE(v.substr(14, 4) == StringView("pool"));
+    TEST_ASSERT_TRUE(v.substr(19) == StringView("3333"));
+    TEST_ASSERT_TRUE(v.substr(19, 100) == StringView("3333"));
+
+    // At or past the end: empty, never out of bounds
+    TEST_ASSERT_TRUE(v.substr(v.length()).empty());
+    TEST_ASSERT_TRUE(v.substr(v.length() + 5, 3).empty());
+    TEST_ASSERT_TRUE(v.substr(StringView::npos).empty());
+    TEST_ASSERT_TRUE(v.substr(3, 0).empty());
+
+    FixedString<16> s("key=value");
+    TEST_ASSERT_TRUE(s.substr(s.find('=') + 1) == StringView("value"));
+}
+
+static void test_find(void) {
+    StringView v("a=b;c=d");
+    TEST_ASSERT_EQUAL_size_t(1, v.find('='));
+    TEST_ASSERT_EQUAL_size_t(5, v.find('=', 2));
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, v.find('x'));
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, v.find('=', 6));
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, v.find('=', 100));
+
+    TEST_ASSERT_EQUAL_size_t(4, v.find(StringView("c=")));
+    TEST_ASSERT_EQUAL_size_t(6, v.find(StringView("d")));       // At the very end
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, v.find(StringView("d;")));
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, StringView("ab").find(StringView("abc")));
+
+    // Empty needle matches at from, up to and including the end
+    TEST_ASSERT_EQUAL_size_t(0, v.find(StringView("")));
+    TEST_ASSERT_EQUAL_size_t(7, v.find(StringView(""), 7));
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, v.find(StringView(""), 8));
+
+    // A slice only searches its own range
+    StringView slice = v.substr(0, 3);
+    TEST_ASSERT_EQUAL_size_t(StringView::npos, slice.find(';'));
+}
+
+static void test_starts_ends_with(void) {
+    StringView v("mining.notify");
+    TEST_ASSERT_TRUE(v.startsWith("mining."));
+    TEST_ASSERT_TRUE(v.startsWith(""));
+    TEST_ASSERT_FALSE(v.startsWith("mining.notify.extra"));
+    TEST_ASSERT_TRUE(v.endsWith(".notify"));
+    TEST_ASSERT_TRUE(v.endsWith(""));
+    TEST_ASSERT_FALSE(StringView("fy").endsWith("notify"));
+
+    TEST_ASSERT_TRUE(StringView(NULL).empty());
+    TEST_ASSERT_TRUE(StringView(NULL, 5).empty());
+    TEST_ASSERT_TRUE(StringView("ab") != StringView("abc"));
+}
+
+// ============================================================
+// copyTo
+// ============================================================
+
+static void test_copy_to(void) {
+    StringView v("abcdef");
+    char buf[8];
+
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_TRUE(v.copyTo(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("abcdef", buf);
+
+    // Exactly room for the terminator
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_TRUE(v.copyTo(buf, 7));
+    TEST_ASSERT_EQUAL_STRING("abcdef", buf);
+
+    // Cut, but still terminated and nothing written past size
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_FALSE(v.copyTo(buf, 4));
+    TEST_ASSERT_EQUAL_STRING("abc", buf);
+    TEST_ASSERT_EQUAL_CHAR('x', buf[4]);
+
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_FALSE(v.copyTo(buf, 1));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+    TEST_ASSERT_EQUAL_CHAR('x', buf[1]);
+
+    // Zero size writes nothing and only succeeds for an empty view
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_FALSE(v.copyTo(buf, 0));
+    TEST_ASSERT_EQUAL_CHAR('x', buf[0]);
+    TEST_ASSERT_TRUE(StringView("").copyTo(buf, 0));
+
+    // A slice copies only its own characters
+    TEST_ASSERT_TRUE(v.substr(2, 2).copyTo(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("cd", buf);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_append_fits_exactly);
+    RUN_TEST(test_append_truncates_and_sticks);
+    RUN_TEST(test_append_char_at_capacity);
+    RUN_TEST(test_append_with_length);
+    RUN_TEST(test_construct_and_assign);
+
+    RUN_TEST(test_appendf_fits);
+    RUN_TEST(test_appendf_overflow);
+    RUN_TEST(test_appendf_exact_fit);
+    RUN_TEST(test_printf_replaces);
+
+    RUN_TEST(test_trim);
+    RUN_TEST(test_substr);
+    RUN_TEST(test_find);
+    RUN_TEST(test_starts_ends_with);
+
+    RUN_TEST(test_copy_to);
+
+    return UNITY_END();
+}
@@ -0,0 +1,360 @@
+/*
+ * SparkMiner - Mining Core Tests
+ * Target and difficulty math, merkle folding and header construction
+ *
+ * Run: pio test -e native-core
+ *
+ * GPL v3 License
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#include "mining/mining_core.h"
+#include "mining/core_vectors.h"
+#include "stratum/stratum_msg.h"
+
+static stratum_job_t s_job;
+
+void setUp(void) {
+    memset(&s_job, 0, sizeof(s_job));
+}
+
+void tearDown(void) {}
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static const core_job_vector_t *jobVector(const char *name) {
+    size_t count;
+    const core_job_vector_t *v = core_vectors_jobs(&count);
+    for (size_t i = 0; i < count; i++) {
+        if (!strcmp(v[i].name, name)) return &v[i];
+    }
+    return NULL;
+}
+
+static const core_header_vector_t *headerVector(const char *name) {
+    size_t count;
+    const core_header_vector_t *v = core_vectors_headers(&count);
+    for (size_t i = 0; i < count; i++) {
+        if (!strcmp(v[i].name, name)) return &v[i];
+    }
+    return NULL;
+}
+
+// Parse a job vector's notify line into s_job
+static const core_job_vector_t *loadJob(const char *name) {
+    const core_job_vector_t *v = jobVector(name);
+    TEST_ASSERT_NOT_NULL(v);
+    DynamicJsonDocument doc(4096);
+    TEST_ASSERT_FALSE(deserializeJson(doc, v->notify));
+    TEST_ASSERT_TRUE(stratum_msg_parse_notify(doc.as<JsonVariantConst>(), v->extraNonce1,
+                                              v->extraNonce2Size, &s_job));
+    return v;
+}
+
+// Explorer-order hex (most significant byte first) to a little-endian hash
+static void hashFromExplorer(sha256_hash_t *out, const char *hex) {
+    core_hex_decode(out->bytes, hex, 64);
+    for (int i = 0; i < 16; i++) {
+        uint8_t t = out->bytes[i];
+        out->bytes[i] = out->bytes[31 - i];
+        out->bytes[31 - i] = t;
+    }
+}
+
+// ============================================================
+// Hex Helpers
+// ============================================================
+
+static void test_hex_decode_mixed_case(void) {
+    uint8_t out[4];
+    core_hex_decode(out, "0aFf1B9c", 8);
+    const uint8_t expected[4] = {0x0a, 0xff, 0x1b, 0x9c};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, out, 4);
+}
+
+static void test_encode_extranonce_big_endian(void) {
+    char en2[CORE_EXTRANONCE2_MAX * 2 + 1];
+    core_encode_extranonce(en2, 4, 0x67F1A671);
+    TEST_ASSERT_EQUAL_STRING("67F1A671", en2);
+    core_encode_extranonce(en2, 2, 0x1234ABCD);
+    TEST_ASSERT_EQUAL_STRING("ABCD", en2);
+    core_encode_extranonce(en2, 8, 0x1234ABCD);
+    TEST_ASSERT_EQUAL_STRING("000000001234ABCD", en2);
+}
+
+static void test_swap_words(void) {
+    uint8_t buf[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    core_swap_words(buf, sizeof(buf));
+    const uint8_t expected[8] = {4, 3, 2, 1, 8, 7, 6, 5};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, 8);
+}
+
+// ============================================================
+// Target & Difficulty
+// ============================================================
+
+static void test_bits_to_target_diff1(void) {
+    uint8_t target[32];
+    core_bits_to_target(CORE_DIFF1_BITS, target);
+    uint8_t expected[32] = {0};
+    expected[26] = 0xff;
+    expected[27] = 0xff;
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, target, 32);
+}
+
+static void test_bits_to_target_small_exponent(void) {
+    uint8_t target[32];
+    core_bits_to_target(0x03123456, target);
+    uint8_t expected[32] = {0x56, 0x34, 0x12};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, target, 32);
+
+    // Exponent 2 drops the mantissa's low byte
+    core_bits_to_target(0x02123456, target);
+    uint8_t shifted[32] = {0x34, 0x12};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(shifted, target, 32);
+}
+
+static void test_bits_to_target_mainnet(void) {
+    // 0x1703a30c: 0x03a30c at byte 20
+    uint8_t target[32];
+    core_bits_to_target(0x1703a30c, target);
+    uint8_t expected[32] = {0};
+    expected[20] = 0x0c;
+    expected[21] = 0xa3;
+    expected[22] = 0x03;
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, target, 32);
+}
+
+static void test_difficulty_one_is_diff1_target(void) {
+    uint8_t diff1[32], target[32];
+    core_bits_to_target(CORE_DIFF1_BITS, diff1);
+    core_difficulty_to_target(target, 1.0);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(diff1, target, 32);
+}
+
+static void test_difficulty_two_halves_target(void) {
+    uint8_t target[32];
+    core_difficulty_to_target(target, 2.0);
+    uint8_t expected[32] = {0};
+    expected[25] = 0x80;
+    expected[26] = 0xff;
+    expected[27] = 0x7f;
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, target, 32);
+}
+
+static void test_difficulty_fractional_raises_target(void) {
+    uint8_t diff1[32], target[32];
+    core_bits_to_target(CORE_DIFF1_BITS, diff1);
+    core_difficulty_to_target(target, 0.0014);
+    TEST_ASSERT_FALSE(core_check_target(target, diff1));
+    TEST_ASSERT_TRUE(core_check_target(diff1, target));
+}
+
+static void test_check_target_boundaries(void) {
+    uint8_t target[32], hash[32];
+    core_difficulty_to_target(target, 1.0);
+
+    memcpy(hash, target, 32);
+    TEST_ASSERT_TRUE(core_check_target(hash, target));      // Equal passes
+
+    hash[0] = 0x01;                                         // One above
+    TEST_ASSERT_FALSE(core_check_target(hash, target));
+
+    memcpy(hash, target, 32);
+    hash[27] = 0xfe;                                        // Below in a higher byte
+    hash[0] = 0xff;
+    TEST_ASSERT_TRUE(core_check_target(hash, target));
+
+    memcpy(hash, target, 32);
+    hash[31] = 0x01;                                        // Most significant byte decides
+    TEST_ASSERT_FALSE(core_check_target(hash, target));
+}
+
+static void test_hash_difficulty(void) {
+    sha256_hash_t hash;
+    core_difficulty_to_target(hash.bytes, 1.0);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 1.0, core_hash_difficulty(&hash));
+
+    core_difficulty_to_target(hash.bytes, 1024.0);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 1024.0, core_hash_difficulty(&hash));
+
+    // Genesis block hash: about 2536 times the diff1 target
+    hashFromExplorer(&hash, "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+    double diff = core_hash_difficulty(&hash);
+    TEST_ASSERT_TRUE(diff > 2536.0 && diff < 2537.0);
+
+    memset(&hash, 0, sizeof(hash));
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, core_hash_difficulty(&hash));
+}
+
+// ============================================================
+// Merkle & Header
+// ============================================================
+
+static void test_merkle_root_without_branches_is_coinbase(void) {
+    loadJob("mainnet-0");
+    TEST_ASSERT_EQUAL_INT(0, s_job.merkleBranchCount);
+
+    uint8_t coinbase[32], root[32];
+    TEST_ASSERT_TRUE(core_coinbase_hash(coinbase, &s_job, 0x67F1A671, 4));
+    core_merkle_root(root, coinbase, &s_job);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(coinbase, root, 32);
+
+    // The genesis coinbase hashes to the genesis merkle root
+    const core_header_vector_t *hv = headerVector("mainnet-0");
+    TEST_ASSERT_NOT_NULL(hv);
+    uint8_t expected[32];
+    core_hex_decode(expected, hv->header + 72, 64);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, root, 32);
+}
+
+static void test_merkle_root_folds_branches(void) {
+    loadJob("synthetic-3br");
+    TEST_ASSERT_EQUAL_INT(3, s_job.merkleBranchCount);
+
+    uint8_t coinbase[32], root[32];
+    TEST_ASSERT_TRUE(core_coinbase_hash(coinbase, &s_job, 0x1234ABCD, 8));
+
+    // Fold by hand: sha256d(acc || branch) per branch, as sent
+    uint8_t pair[64];
+    memcpy(pair, coinbase, 32);
+    for (int i = 0; i < s_job.merkleBranchCount; i++) {
+        sha256_hash_t h;
+        core_hex_decode(&pair[32], s_job.merkleBranches[i], 64);
+        core_sha256d(&h, pair, 64);
+        memcpy(pair, h.bytes, 32);
+    }
+    core_merkle_root(root, coinbase, &s_job);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pair, root, 32);
+
+    // In place (root aliases the coinbase hash)
+    core_merkle_root(coinbase, coinbase, &s_job);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(root, coinbase, 32);
+}
+
+static void test_build_header_genesis(void) {
+    const core_job_vector_t *v = loadJob("mainnet-0");
+    const core_header_vector_t *hv = headerVector("mainnet-0");
+    TEST_ASSERT_NOT_NULL(hv);
+
+    block_header_t hb;
+    TEST_ASSERT_TRUE(core_build_header(&hb, &s_job, v->extraNonce2, v->extraNonce2Size));
+    TEST_ASSERT_EQUAL_UINT32(0, hb.nonce);
+    TEST_ASSERT_EQUAL_HEX32(0x00000001, hb.version);
+    TEST_ASSERT_EQUAL_HEX32(0x1d00ffff, hb.difficulty);
+    TEST_ASSERT_EQUAL_HEX32(0x495fab29, hb.timestamp);
+
+    // Byte for byte the serialized genesis header once the nonce is in
+    hb.nonce = v->nonce;
+    block_header_t expected;
+    core_hex_decode((uint8_t *)&expected, hv->header, sizeof(expected) * 2);
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &hb, sizeof(hb));
+
+    sha256_hash_t hash, want;
+    core_sha256d(&hash, (const uint8_t *)&hb, sizeof(hb));
+    hashFromExplorer(&want, v->hash);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(want.bytes, hash.bytes, 32);
+}
+
+static void test_build_header_prevhash_word_order(void) {
+    loadJob("synthetic-3br");
+
+    block_header_t hb;
+    TEST_ASSERT_TRUE(core_build_header(&hb, &s_job, 0x1234ABCD, 8));
+
+    // Stratum "0a8ce26f..." is word-swapped: the header starts 6f e2 8c 0a
+    const uint8_t expected[4] = {0x6f, 0xe2, 0x8c, 0x0a};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, hb.prev_hash, 4);
+}
+
+static void test_build_header_rejects_malformed_jobs(void) {
+    const core_job_vector_t *v = loadJob("mainnet-0");
+    block_header_t hb;
+
+    TEST_ASSERT_FALSE(core_build_header(&hb, &s_job, 0, 0));
+    TEST_ASSERT_FALSE(core_build_header(&hb, &s_job, 0, CORE_EXTRANONCE2_MAX + 1));
+    TEST_ASSERT_TRUE(core_build_header(&hb, &s_job, 0, CORE_EXTRANONCE2_MAX));
+
+    // Short prevhash
+    stratum_job_t job = s_job;
+    job.prevHash[62] = '\0';
+    TEST_ASSERT_FALSE(core_build_header(&hb, &job, v->extraNonce2, v->extraNonce2Size));
+
+    // Odd-length coinbase hex
+    job = s_job;
+    job.coinBase2[strlen(job.coinBase2) - 1] = '\0';
+    TEST_ASSERT_FALSE(core_build_header(&hb, &job, v->extraNonce2, v->extraNonce2Size));
+
+    // Odd-length extraNonce1
+    job = s_job;
+    strcpy(job.extraNonce1, "554827");
+    TEST_ASSERT_TRUE(core_build_header(&hb, &job, v->extraNonce2, v->extraNonce2Size));
+    strcpy(job.extraNonce1, "5548271");
+    TEST_ASSERT_FALSE(core_build_header(&hb, &job, v->extraNonce2, v->extraNonce2Size));
+
+    // Largest coinbase the job fields hold still fits CORE_COINBASE_MAX
+    job = s_job;
+    memset(job.coinBase1, 'a', STRATUM_COINBASE1_LEN - 2);
+    job.coinBase1[STRATUM_COINBASE1_LEN - 2] = '\0';
+    memset(job.coinBase2, 'b', STRATUM_COINBASE2_LEN - 2);
+    job.coinBase2[STRATUM_COINBASE2_LEN - 2] = '\0';
+    TEST_ASSERT_TRUE(core_build_header(&hb, &job, v->extraNonce2, CORE_EXTRANONCE2_MAX));
+}
+
+// ============================================================
+// Golden Vectors
+// ============================================================
+
+static void test_vectors_engines(void) {
+    core_vectors_result_t res = core_vectors_check_engine(core_engine_sha256d);
+    TEST_ASSERT_TRUE(res.run > 0);
+    TEST_ASSERT_EQUAL_UINT(0, res.failed);
+
+    res = core_vectors_check_engine(core_engine_midstate);
+    TEST_ASSERT_TRUE(res.run > 0);
+    TEST_ASSERT_EQUAL_UINT(0, res.failed);
+}
+
+static void test_vectors_pipeline(void) {
+    core_vectors_result_t res = core_vectors_check_jobs(core_engine_sha256d);
+    TEST_ASSERT_TRUE(res.run > 0);
+    TEST_ASSERT_EQUAL_UINT(0, res.failed);
+
+    res = core_vectors_check_jobs(core_engine_midstate);
+    TEST_ASSERT_TRUE(res.run > 0);
+    TEST_ASSERT_EQUAL_UINT(0, res.failed);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_hex_decode_mixed_case);
+    RUN_TEST(test_encode_extranonce_big_endian);
+    RUN_TEST(test_swap_words);
+
+    RUN_TEST(test_bits_to_target_diff1);
+    RUN_TEST(test_bits_to_target_small_exponent);
+    RUN_TEST(test_bits_to_target_mainnet);
+    RUN_TEST(test_difficulty_one_is_diff1_target);
+    RUN_TEST(test_difficulty_two_halves_target);
+    RUN_TEST(test_difficulty_fractional_raises_target);
+    RUN_TEST(test_check_target_boundaries);
+    RUN_TEST(test_hash_difficulty);
+
+    RUN_TEST(test_merkle_root_without_branches_is_coinbase);
+    RUN_TEST(test_merkle_root_folds_branches);
+    RUN_TEST(test_build_header_genesis);
+    RUN_TEST(test_build_header_prevhash_word_order);
+    RUN_TEST(test_build_header_rejects_malformed_jobs);
+
+    RUN_TEST(test_vectors_engines);
+    RUN_TEST(test_vectors_pipeline);
+
+    return UNITY_END();
+}
@@ -0,0 +1,289 @@
+/*
+ * SparkMiner - Stratum Message Tests
+ * Classification, response parsing, mining.notify limits and the
+ * mining.submit wire format
+ *
+ * Run: pio test -e native-core
+ *
+ * GPL v3 License
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#include "stratum/stratum_msg.h"
+
+#define TEST_JSON_SIZE      8192
+
+static DynamicJsonDocument s_doc(TEST_JSON_SIZE);
+static stratum_job_t s_job;
+static char s_line[4096];
+
+static const char *BRANCH = "bb48e9c6097d0185fea951d532757fda8dc1bd5d9b268bf2c1b742867766e4e5";
+static const char *PREVHASH = "0a8ce26f72b3f1b646a2a6c14ff763ae65831e939c085ae10019d66800000000";
+
+void setUp(void) {
+    s_doc.clear();
+    memset(&s_job, 0, sizeof(s_job));
+}
+
+void tearDown(void) {}
+
+// ============================================================
+// Helpers
+// ============================================================
+
+static JsonVariantConst parse(const char *json) {
+    TEST_ASSERT_FALSE(deserializeJson(s_doc, json));
+    return s_doc.as<JsonVariantConst>();
+}
+
+// mining.notify with the given job id, branch count and version token
+// (version is spliced in raw so it can be a non-string)
+static const char *notifyLine(const char *jobId, int branches, const char *version) {
+    char merkle[STRATUM_MAX_MERKLE * 2 * 70];
+    size_t pos = 0;
+    for (int i = 0; i < branches && pos + 70 < sizeof(merkle); i++) {
+        pos += snprintf(merkle + pos, sizeof(merkle) - pos, "%s\"%s\"", i ? "," : "", BRANCH);
+    }
+    merkle[pos] = '\0';
+    snprintf(s_line, sizeof(s_line),
+             "{\"id\":null,\"method\":\"mining.notify\",\"params\":[\"%s\",\"%s\",\"01000000\","
+             "\"ffffffff\",[%s],%s,\"1703a30c\",\"6553f100\",true]}",
+             jobId, PREVHASH, merkle, version);
+    return s_line;
+}
+
+static bool parseNotify(const char *json) {
+    return stratum_msg_parse_notify(parse(json), "f000000d", 4, &s_job);
+}
+
+// ============================================================
+// Classification & Responses
+// ============================================================
+
+static void test_classify(void) {
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_NOTIFY, stratum_msg_classify(parse(notifyLine("1a", 0, "\"20000000\""))));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_SET_DIFFICULTY,
+                          stratum_msg_classify(parse("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[512]}")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_UNKNOWN,
+                          stratum_msg_classify(parse("{\"id\":null,\"method\":\"client.reconnect\",\"params\":[]}")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_RESPONSE,
+                          stratum_msg_classify(parse("{\"id\":4,\"result\":true,\"error\":null}")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_RESPONSE,
+                          stratum_msg_classify(parse("{\"id\":4,\"result\":null,\"error\":[23,\"Low difficulty\",null]}")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_INVALID, stratum_msg_classify(parse("{\"id\":4}")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_INVALID, stratum_msg_classify(parse("{\"id\":null,\"result\":true}")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MSG_INVALID, stratum_msg_classify(parse("[1,2,3]")));
+}
+
+static void test_error_and_stale(void) {
+    JsonVariantConst ok = parse("{\"id\":5,\"result\":true,\"error\":null}");
+    TEST_ASSERT_NULL(stratum_msg_error(ok));
+    TEST_ASSERT_FALSE(stratum_msg_is_stale(ok));
+
+    TEST_ASSERT_TRUE(stratum_msg_is_stale(parse("{\"id\":5,\"result\":null,\"error\":[21,\"Job not found\",null]}")));
+    TEST_ASSERT_EQUAL_STRING("Job not found", stratum_msg_error(s_doc.as<JsonVariantConst>()));
+    TEST_ASSERT_TRUE(stratum_msg_is_stale(parse("{\"id\":5,\"result\":null,\"error\":[20,\"Stale share\",null]}")));
+    TEST_ASSERT_TRUE(stratum_msg_is_stale(parse("{\"id\":5,\"result\":null,\"error\":[20,\"share is stale\",null]}")));
+    TEST_ASSERT_FALSE(stratum_msg_is_stale(parse("{\"id\":5,\"result\":null,\"error\":[23,\"Low difficulty share\",null]}")));
+
+    // An error without text still reads as an error
+    TEST_ASSERT_EQUAL_STRING("unknown", stratum_msg_error(parse("{\"id\":5,\"result\":null,\"error\":[20]}")));
+}
+
+static void test_parse_subscribe(void) {
+    char en1[STRATUM_EXTRANONCE_LEN];
+    int en2Size = 0;
+
+    TEST_ASSERT_TRUE(stratum_msg_parse_subscribe(
+        parse("{\"id\":1,\"result\":[[[\"mining.notify\",\"ae6812eb4cd7735a\"]],\"08000002\",8],\"error\":null}"),
+        en1, sizeof(en1), &en2Size));
+    TEST_ASSERT_EQUAL_STRING("08000002", en1);
+    TEST_ASSERT_EQUAL_INT(8, en2Size);
+
+    // extraNonce2 size defaults to 4
+    TEST_ASSERT_TRUE(stratum_msg_parse_subscribe(
+        parse("{\"id\":1,\"result\":[[],\"0a0b\"],\"error\":null}"), en1, sizeof(en1), &en2Size));
+    TEST_ASSERT_EQUAL_STRING("0a0b", en1);
+    TEST_ASSERT_EQUAL_INT(4, en2Size);
+
+    // Cut to the buffer
+    char small[5];
+    TEST_ASSERT_TRUE(stratum_msg_parse_subscribe(
+        parse("{\"id\":1,\"result\":[[],\"08000002\",4],\"error\":null}"), small, sizeof(small), &en2Size));
+    TEST_ASSERT_EQUAL_STRING("0800", small);
+
+    TEST_ASSERT_FALSE(stratum_msg_parse_subscribe(
+        parse("{\"id\":1,\"result\":null,\"error\":[20,\"Not subscribed\",null]}"), en1, sizeof(en1), &en2Size));
+    TEST_ASSERT_FALSE(stratum_msg_parse_subscribe(
+        parse("{\"id\":1,\"result\":true,\"error\":null}"), en1, sizeof(en1), &en2Size));
+}
+
+static void test_parse_authorize(void) {
+    TEST_ASSERT_TRUE(stratum_msg_parse_authorize(parse("{\"id\":2,\"result\":true,\"error\":null}")));
+    TEST_ASSERT_FALSE(stratum_msg_parse_authorize(parse("{\"id\":2,\"result\":false,\"error\":null}")));
+    TEST_ASSERT_FALSE(stratum_msg_parse_authorize(parse("{\"id\":2,\"result\":null,\"error\":[24,\"Unauthorized\",null]}")));
+}
+
+static void test_parse_difficulty(void) {
+    double diff = 7.0;
+    TEST_ASSERT_TRUE(stratum_msg_parse_difficulty(parse("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[512]}"), &diff));
+    TEST_ASSERT_EQUAL_DOUBLE(512.0, diff);
+    TEST_ASSERT_TRUE(stratum_msg_parse_difficulty(parse("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[0.0014]}"), &diff));
+    TEST_ASSERT_EQUAL_DOUBLE(0.0014, diff);
+
+    // Rejected values leave the output alone
+    diff = 7.0;
+    TEST_ASSERT_FALSE(stratum_msg_parse_difficulty(parse("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[0]}"), &diff));
+    TEST_ASSERT_FALSE(stratum_msg_parse_difficulty(parse("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[-1]}"), &diff));
+
+    s_doc.clear();
+    s_doc.createNestedArray("params").add(NAN);
+    TEST_ASSERT_FALSE(stratum_msg_parse_difficulty(s_doc.as<JsonVariantConst>(), &diff));
+    s_doc.clear();
+    s_doc.createNestedArray("params").add(INFINITY);
+    TEST_ASSERT_FALSE(stratum_msg_parse_difficulty(s_doc.as<JsonVariantConst>(), &diff));
+    TEST_ASSERT_EQUAL_DOUBLE(7.0, diff);
+}
+
+// ============================================================
+// mining.notify
+// ============================================================
+
+static void test_notify_fields(void) {
+    TEST_ASSERT_TRUE(parseNotify(notifyLine("4f2a", 3, "\"20000000\"")));
+    TEST_ASSERT_EQUAL_STRING("4f2a", s_job.jobId);
+    TEST_ASSERT_EQUAL_STRING(PREVHASH, s_job.prevHash);
+    TEST_ASSERT_EQUAL_STRING("01000000", s_job.coinBase1);
+    TEST_ASSERT_EQUAL_STRING("ffffffff", s_job.coinBase2);
+    TEST_ASSERT_EQUAL_INT(3, s_job.merkleBranchCount);
+    TEST_ASSERT_EQUAL_STRING(BRANCH, s_job.merkleBranches[2]);
+    TEST_ASSERT_EQUAL_STRING("20000000", s_job.version);
+    TEST_ASSERT_EQUAL_STRING("1703a30c", s_job.nbits);
+    TEST_ASSERT_EQUAL_STRING("6553f100", s_job.ntime);
+    TEST_ASSERT_TRUE(s_job.cleanJobs);
+    TEST_ASSERT_EQUAL_STRING("f000000d", s_job.extraNonce1);
+    TEST_ASSERT_EQUAL_INT(4, s_job.extraNonce2Size);
+}
+
+static void test_notify_rejects_non_array_params(void) {
+    TEST_ASSERT_FALSE(parseNotify("{\"id\":null,\"method\":\"mining.notify\",\"params\":{\"job\":\"1\"}}"));
+    TEST_ASSERT_FALSE(parseNotify("{\"id\":null,\"method\":\"mining.notify\"}"));
+}
+
+static void test_notify_rejects_missing_fields(void) {
+    // Eight params: no clean flag is fine, no ntime is not
+    TEST_ASSERT_TRUE(parseNotify("{\"method\":\"mining.notify\",\"params\":[\"1\",\"00\",\"01\",\"02\",[],"
+                                 "\"20000000\",\"1703a30c\",\"6553f100\"]}"));
+    TEST_ASSERT_FALSE(s_job.cleanJobs);
+    TEST_ASSERT_FALSE(parseNotify("{\"method\":\"mining.notify\",\"params\":[\"1\",\"00\",\"01\",\"02\",[],"
+                                  "\"20000000\",\"1703a30c\"]}"));
+    // Merkle list missing
+    TEST_ASSERT_FALSE(parseNotify("{\"method\":\"mining.notify\",\"params\":[\"1\",\"00\",\"01\",\"02\",null,"
+                                  "\"20000000\",\"1703a30c\",\"6553f100\",true]}"));
+}
+
+static void test_notify_rejects_non_string_field(void) {
+    TEST_ASSERT_FALSE(parseNotify(notifyLine("4f2a", 0, "536870912")));
+    TEST_ASSERT_FALSE(parseNotify(notifyLine("4f2a", 0, "null")));
+}
+
+static void test_notify_rejects_oversize_job_id(void) {
+    // STRATUM_JOB_ID_LEN includes the terminator
+    char id[STRATUM_JOB_ID_LEN + 1];
+    memset(id, 'a', sizeof(id));
+    id[STRATUM_JOB_ID_LEN - 1] = '\0';
+    TEST_ASSERT_TRUE(parseNotify(notifyLine(id, 0, "\"20000000\"")));
+    TEST_ASSERT_EQUAL_STRING(id, s_job.jobId);
+
+    id[STRATUM_JOB_ID_LEN - 1] = 'a';
+    id[STRATUM_JOB_ID_LEN] = '\0';
+    TEST_ASSERT_FALSE(parseNotify(notifyLine(id, 0, "\"20000000\"")));
+}
+
+static void test_notify_rejects_oversize_field(void) {
+    // STRATUM_FIELD_LEN holds 11 characters plus the terminator
+    TEST_ASSERT_TRUE(parseNotify(notifyLine("4f2a", 0, "\"20000000000\"")));
+    TEST_ASSERT_FALSE(parseNotify(notifyLine("4f2a", 0, "\"200000000000\"")));
+}
+
+static void test_notify_merkle_branch_limit(void) {
+    TEST_ASSERT_TRUE(parseNotify(notifyLine("4f2a", STRATUM_MAX_MERKLE, "\"20000000\"")));
+    TEST_ASSERT_EQUAL_INT(STRATUM_MAX_MERKLE, s_job.merkleBranchCount);
+    TEST_ASSERT_FALSE(parseNotify(notifyLine("4f2a", STRATUM_MAX_MERKLE + 1, "\"20000000\"")));
+}
+
+// ============================================================
+// mining.submit
+// ============================================================
+
+static void fillEntry(submit_entry_t *entry) {
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->jobId, "4f2a");
+    strcpy(entry->extraNonce2, "0000002A");
+    entry->timestamp = 0x6553f100;
+    entry->nonce = 0xdeadbeef;
+}
+
+static void test_submit_format(void) {
+    submit_entry_t entry;
+    fillEntry(&entry);
+    char buf[256];
+
+    size_t n = stratum_msg_format_submit(buf, sizeof(buf), 7, "bc1qtest.worker", &entry);
+    const char *expected =
+        "{\"id\":7,\"method\":\"mining.submit\",\"params\":"
+        "[\"bc1qtest.worker\",\"4f2a\",\"0000002A\",\"6553f100\",\"deadbeef\"]}";
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+    TEST_ASSERT_EQUAL_size_t(strlen(expected), n);
+
+    // Timestamp and nonce stay 8 lower-case hex digits
+    entry.timestamp = 0x1;
+    entry.nonce = 0xA;
+    n = stratum_msg_format_submit(buf, sizeof(buf), 4294967295UL, "u", &entry);
+    TEST_ASSERT_EQUAL_STRING("{\"id\":4294967295,\"method\":\"mining.submit\",\"params\":"
+                             "[\"u\",\"4f2a\",\"0000002A\",\"00000001\",\"0000000a\"]}", buf);
+    TEST_ASSERT_EQUAL_size_t(strlen(buf), n);
+}
+
+static void test_submit_buffer_too_small(void) {
+    submit_entry_t entry;
+    fillEntry(&entry);
+    char buf[256];
+
+    size_t full = stratum_msg_format_submit(buf, sizeof(buf), 7, "bc1qtest.worker", &entry);
+    TEST_ASSERT_TRUE(full > 0);
+
+    // Exactly enough room for the terminator fits; one less does not
+    TEST_ASSERT_EQUAL_size_t(full, stratum_msg_format_submit(buf, full + 1, 7, "bc1qtest.worker", &entry));
+    TEST_ASSERT_EQUAL_size_t(0, stratum_msg_format_submit(buf, full, 7, "bc1qtest.worker", &entry));
+    TEST_ASSERT_EQUAL_size_t(0, stratum_msg_format_submit(buf, 0, 7, "bc1qtest.worker", &entry));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_classify);
+    RUN_TEST(test_error_and_stale);
+    RUN_TEST(test_parse_subscribe);
+    RUN_TEST(test_parse_authorize);
+    RUN_TEST(test_parse_difficulty);
+
+    RUN_TEST(test_notify_fields);
+    RUN_TEST(test_notify_rejects_non_array_params);
+    RUN_TEST(test_notify_rejects_missing_fields);
+    RUN_TEST(test_notify_rejects_non_string_field);
+    RUN_TEST(test_notify_rejects_oversize_job_id);
+    RUN_TEST(test_notify_rejects_oversize_field);
+    RUN_TEST(test_notify_merkle_branch_limit);
+
+    RUN_TEST(test_submit_format);
+    RUN_TEST(test_submit_buffer_too_small);
+
+    return UNITY_END();
+}